@@ -0,0 +1,118 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "BBHBench.h"
+
+#include "SkBBHFactory.h"
+#include "SkPictureRecorder.h"
+
+namespace {
+
+// Collects the op bounds SkPictureRecorder would have put in a real hierarchy.
+class BoundsCapture : public SkBBoxHierarchy {
+public:
+    explicit BoundsCapture(SkTDArray<SkRect>* bounds) : fBounds(bounds) {}
+
+    void insert(const SkRect boundsArray[], int N) override { fBounds->append(N, boundsArray); }
+    void search(const SkRect&, SkTDArray<unsigned>*) const override {}
+    size_t bytesUsed() const override { return 0; }
+    SkRect getRootBound() const override { return SkRect::MakeEmpty(); }
+
+private:
+    SkTDArray<SkRect>* fBounds;
+};
+
+class BoundsCaptureFactory : public SkBBHFactory {
+public:
+    explicit BoundsCaptureFactory(SkTDArray<SkRect>* bounds) : fBounds(bounds) {}
+
+    SkBBoxHierarchy* operator()(const SkRect&) const override {
+        return SkNEW_ARGS(BoundsCapture, (fBounds));
+    }
+
+private:
+    SkTDArray<SkRect>* fBounds;
+};
+
+}  // namespace
+
+static const char* type_name(BBHBench::Type type) {
+    switch (type) {
+        case BBHBench::kRTree_Type:            return "rtree";
+        case BBHBench::kHilbertRTree_Type:     return "hilbert_rtree";
+        case BBHBench::kIncrementalRTree_Type: return "incremental_rtree";
+    }
+    SkFAIL("Unknown BBHBench::Type");
+    return NULL;
+}
+
+BBHBench::BBHBench(const char* name, const SkPicture* pic, Type type, Mode mode)
+    : fCullRect(pic->cullRect())
+    , fType(type)
+    , fMode(mode) {
+    fName.printf("%s_%s_%s", name, type_name(type), kBuild_Mode == mode ? "build" : "query");
+
+    BoundsCaptureFactory factory(&fBounds);
+    SkPictureRecorder recorder;
+    pic->playback(recorder.beginRecording(fCullRect, &factory));
+    SkAutoTUnref<SkPicture> unused(recorder.endRecording());
+
+    static const SkScalar kTile = 256;
+    for (SkScalar y = fCullRect.fTop; y < fCullRect.fBottom; y += kTile) {
+        for (SkScalar x = fCullRect.fLeft; x < fCullRect.fRight; x += kTile) {
+            fQueries.push(SkRect::MakeXYWH(x, y, kTile, kTile));
+        }
+    }
+
+    fBBH.reset(this->build());
+    fBytesUsed = fBBH->bytesUsed();
+    if (kQuery_Mode != fMode) {
+        fBBH.reset(NULL);
+    }
+}
+
+SkBBoxHierarchy* BBHBench::build() const {
+    SkAutoTDelete<SkBBHFactory> factory;
+    switch (fType) {
+        case kRTree_Type:            factory.reset(SkNEW(SkRTreeFactory));            break;
+        case kHilbertRTree_Type:     factory.reset(SkNEW(SkHilbertRTreeFactory));     break;
+        case kIncrementalRTree_Type: factory.reset(SkNEW(SkIncrementalRTreeFactory)); break;
+    }
+
+    SkBBoxHierarchy* bbh = (*factory)(fCullRect);
+    if (kIncrementalRTree_Type == fType) {
+        // Feed it ops one at a time, as a recorder appending as it goes would.
+        for (int i = 0; i < fBounds.count(); i++) {
+            bbh->insert(&fBounds[i], 1);
+        }
+    } else {
+        bbh->insert(fBounds.begin(), fBounds.count());
+    }
+    return bbh;
+}
+
+const char* BBHBench::onGetName() {
+    return fName.c_str();
+}
+
+bool BBHBench::isSuitableFor(Backend backend) {
+    return backend == kNonRendering_Backend;
+}
+
+void BBHBench::onDraw(const int loops, SkCanvas*) {
+    for (int i = 0; i < loops; i++) {
+        if (kBuild_Mode == fMode) {
+            SkAutoTUnref<SkBBoxHierarchy> bbh(this->build());
+        } else {
+            SkTDArray<unsigned> hits;
+            for (int j = 0; j < fQueries.count(); j++) {
+                hits.rewind();
+                fBBH->search(fQueries[j], &hits);
+            }
+        }
+    }
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef BBHBench_DEFINED
+#define BBHBench_DEFINED
+
+#include "Benchmark.h"
+#include "SkBBoxHierarchy.h"
+#include "SkPicture.h"
+#include "SkTDArray.h"
+
+/**
+ * Times building or querying a bounding box hierarchy over the op bounds of a real SkPicture.
+ * Queries are the 256x256 tiles covering the picture, as tiled playback would issue them.
+ */
+class BBHBench : public Benchmark {
+public:
+    enum Type {
+        kRTree_Type,             // SkRTreeFactory
+        kHilbertRTree_Type,      // SkHilbertRTreeFactory
+        kIncrementalRTree_Type,  // SkIncrementalRTreeFactory, built one op at a time.
+    };
+    static const int kTypeCount = kIncrementalRTree_Type + 1;
+
+    enum Mode {
+        kBuild_Mode,
+        kQuery_Mode,
+    };
+    static const int kModeCount = kQuery_Mode + 1;
+
+    BBHBench(const char* name, const SkPicture*, Type, Mode);
+
+    // Bytes used by a hierarchy of our type holding the picture's op bounds.
+    size_t bytesUsed() const { return fBytesUsed; }
+
+protected:
+    const char* onGetName() override;
+    bool isSuitableFor(Backend) override;
+    void onDraw(const int loops, SkCanvas*) override;
+
+private:
+    SkBBoxHierarchy* build() const;
+
+    SkString fName;
+    SkRect fCullRect;
+    const Type fType;
+    const Mode fMode;
+    SkTDArray<SkRect> fBounds;
+    SkTDArray<SkRect> fQueries;
+    SkAutoTUnref<SkBBoxHierarchy> fBBH;  // for kQuery_Mode
+    size_t fBytesUsed;
+
+    typedef Benchmark INHERITED;
+};
+
+#endif//BBHBench_DEFINED
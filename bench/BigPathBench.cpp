@@ -7,7 +7,9 @@
 
 #include "Benchmark.h"
 #include "SkCanvas.h"
+#include "SkCanvasPriv.h"
 #include "SkPath.h"
+#include "SkScan.h"
 #include "SkString.h"
 
 static void make_path(SkPath& path) {
@@ -28,13 +30,18 @@ class BigPathBench : public Benchmark {
     SkString    fName;
     Align       fAlign;
     bool        fRound;
+    bool        fAnalyticAA;
 
 public:
-    BigPathBench(Align align, bool round) : fAlign(align), fRound(round) {
+    BigPathBench(Align align, bool round, bool analyticAA = false)
+        : fAlign(align), fRound(round), fAnalyticAA(analyticAA) {
         fName.printf("bigpath_%s", gAlignName[fAlign]);
         if (round) {
             fName.append("_round");
         }
+        if (analyticAA) {
+            fName.append("_analytic");
+        }
     }
 
 protected:
@@ -72,9 +79,12 @@ protected:
                 break;
         }
 
+        const uint32_t scanFlags = SkCanvasPriv::SetScanFlags(canvas,
+                fAnalyticAA ? SkScan::kAnalyticAA_PathFlag : 0);
         for (int i = 0; i < loops; i++) {
             canvas->drawPath(fPath, paint);
         }
+        SkCanvasPriv::SetScanFlags(canvas, scanFlags);
     }
 
 private:
@@ -89,3 +99,11 @@ DEF_BENCH( return new BigPathBench(kLeft_Align,     true); )
 DEF_BENCH( return new BigPathBench(kMiddle_Align,   true); )
 DEF_BENCH( return new BigPathBench(kRight_Align,    true); )
 
+
+DEF_BENCH( return new BigPathBench(kLeft_Align,     false, true); )
+DEF_BENCH( return new BigPathBench(kMiddle_Align,   false, true); )
+DEF_BENCH( return new BigPathBench(kRight_Align,    false, true); )
+
+DEF_BENCH( return new BigPathBench(kLeft_Align,     true,  true); )
+DEF_BENCH( return new BigPathBench(kMiddle_Align,   true,  true); )
+DEF_BENCH( return new BigPathBench(kRight_Align,    true,  true); )
@@ -6,6 +6,7 @@
  */
 
 #include "Benchmark.h"
+#include "SkBitmapScaler.h"
 #include "SkBlurMask.h"
 #include "SkCanvas.h"
 #include "SkPaint.h"
@@ -101,6 +102,34 @@ private:
     typedef BitmapScaleBench INHERITED;
 };
 
+// Calls SkBitmapScaler directly, optionally splitting the work across threads.
+class BitmapResizeBench: public BitmapScaleBench {
+ public:
+    BitmapResizeBench( int is, int os, bool parallel)
+        : INHERITED(is, os), fParallel(parallel) {
+        setName( parallel ? "resize_parallel" : "resize" );
+    }
+protected:
+    void doScaleImage() override {
+        SkBitmap result;
+        if (fParallel) {
+            SkBitmapScaler::ResizeInParallel(&result, fInputBitmap,
+                                             SkBitmapScaler::RESIZE_BEST,
+                                             SkIntToScalar(outputSize()),
+                                             SkIntToScalar(outputSize()));
+        } else {
+            SkBitmapScaler::Resize(&result, fInputBitmap,
+                                   SkBitmapScaler::RESIZE_BEST,
+                                   SkIntToScalar(outputSize()),
+                                   SkIntToScalar(outputSize()));
+        }
+    }
+private:
+    bool fParallel;
+
+    typedef BitmapScaleBench INHERITED;
+};
+
 DEF_BENCH(return new BitmapFilterScaleBench(10, 90);)
 DEF_BENCH(return new BitmapFilterScaleBench(30, 90);)
 DEF_BENCH(return new BitmapFilterScaleBench(80, 90);)
@@ -110,3 +139,8 @@ DEF_BENCH(return new BitmapFilterScaleBench(90, 30);)
 DEF_BENCH(return new BitmapFilterScaleBench(90, 10);)
 DEF_BENCH(return new BitmapFilterScaleBench(256, 64);)
 DEF_BENCH(return new BitmapFilterScaleBench(64, 256);)
+
+DEF_BENCH(return new BitmapResizeBench(2048, 256, false);)
+DEF_BENCH(return new BitmapResizeBench(2048, 256, true);)
+DEF_BENCH(return new BitmapResizeBench(1024, 1536, false);)
+DEF_BENCH(return new BitmapResizeBench(1024, 1536, true);)
@@ -15,10 +15,12 @@
 #include "SkString.h"
 
 #define MINI   0.01f
+#define ONE     SkIntToScalar(1)
 #define SMALL   SkIntToScalar(2)
 #define REAL    1.5f
 #define BIG     SkIntToScalar(10)
 #define REALBIG 100.5f
+#define GIANT   SkIntToScalar(150)
 
 static const char* gStyleName[] = {
     "normal",
@@ -84,6 +86,8 @@ DEF_BENCH(return new BlurBench(MINI, kSolid_SkBlurStyle);)
 DEF_BENCH(return new BlurBench(MINI, kOuter_SkBlurStyle);)
 DEF_BENCH(return new BlurBench(MINI, kInner_SkBlurStyle);)
 
+DEF_BENCH(return new BlurBench(ONE, kNormal_SkBlurStyle);)
+
 DEF_BENCH(return new BlurBench(SMALL, kNormal_SkBlurStyle);)
 DEF_BENCH(return new BlurBench(SMALL, kSolid_SkBlurStyle);)
 DEF_BENCH(return new BlurBench(SMALL, kOuter_SkBlurStyle);)
@@ -99,6 +103,8 @@ DEF_BENCH(return new BlurBench(REALBIG, kSolid_SkBlurStyle);)
 DEF_BENCH(return new BlurBench(REALBIG, kOuter_SkBlurStyle);)
 DEF_BENCH(return new BlurBench(REALBIG, kInner_SkBlurStyle);)
 
+DEF_BENCH(return new BlurBench(GIANT, kNormal_SkBlurStyle);)
+
 DEF_BENCH(return new BlurBench(REAL, kNormal_SkBlurStyle);)
 DEF_BENCH(return new BlurBench(REAL, kSolid_SkBlurStyle);)
 DEF_BENCH(return new BlurBench(REAL, kOuter_SkBlurStyle);)
@@ -106,12 +112,16 @@ DEF_BENCH(return new BlurBench(REAL, kInner_SkBlurStyle);)
 
 DEF_BENCH(return new BlurBench(MINI, kNormal_SkBlurStyle, SkBlurMaskFilter::kHighQuality_BlurFlag);)
 
+DEF_BENCH(return new BlurBench(ONE, kNormal_SkBlurStyle, SkBlurMaskFilter::kHighQuality_BlurFlag);)
+
 DEF_BENCH(return new BlurBench(SMALL, kNormal_SkBlurStyle, SkBlurMaskFilter::kHighQuality_BlurFlag);)
 
 DEF_BENCH(return new BlurBench(BIG, kNormal_SkBlurStyle, SkBlurMaskFilter::kHighQuality_BlurFlag);)
 
 DEF_BENCH(return new BlurBench(REALBIG, kNormal_SkBlurStyle, SkBlurMaskFilter::kHighQuality_BlurFlag);)
 
+DEF_BENCH(return new BlurBench(GIANT, kNormal_SkBlurStyle, SkBlurMaskFilter::kHighQuality_BlurFlag);)
+
 DEF_BENCH(return new BlurBench(REAL, kNormal_SkBlurStyle, SkBlurMaskFilter::kHighQuality_BlurFlag);)
 
 DEF_BENCH(return new BlurBench(0, kNormal_SkBlurStyle);)
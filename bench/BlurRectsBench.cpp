@@ -72,9 +72,28 @@ private:
     typedef BlurRectsBench INHERITED;
 };
 
+// A frame big enough that the blur can't be nine-patched, over sigmas from tiny to huge.
+class BlurRectsBigBench: public BlurRectsBench {
+public:
+    BlurRectsBigBench(SkScalar sigma)
+        : INHERITED(SkRect::MakeXYWH(10, 10, 500, 400), SkRect::MakeXYWH(150, 120, 200, 100),
+                    sigma) {
+        SkString name;
+        name.printf("blurrectsbig_%g", SkScalarToFloat(sigma));
+        this->setName(name);
+    }
+private:
+    typedef BlurRectsBench INHERITED;
+};
+
 DEF_BENCH(return new BlurRectsNinePatchBench(SkRect::MakeXYWH(10, 10, 100, 100),
                                              SkRect::MakeXYWH(20, 20, 60, 60),
                                              2.3f);)
 DEF_BENCH(return new BlurRectsNonNinePatchBench(SkRect::MakeXYWH(10, 10, 100, 100),
                                                 SkRect::MakeXYWH(50, 50, 10, 10),
                                                 4.3f);)
+
+DEF_BENCH(return new BlurRectsBigBench(1);)
+DEF_BENCH(return new BlurRectsBigBench(10);)
+DEF_BENCH(return new BlurRectsBigBench(40);)
+DEF_BENCH(return new BlurRectsBigBench(120);)
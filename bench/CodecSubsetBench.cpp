@@ -0,0 +1,77 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "CodecSubsetBench.h"
+#include "SkCodec.h"
+#include "SkImageGenerator.h"
+
+CodecSubsetBench::CodecSubsetBench(SkString baseName, SkData* encoded, SkColorType colorType,
+                                   int divisor)
+    : fColorType(colorType)
+    , fDivisor(divisor)
+    , fData(SkRef(encoded))
+{
+    // Parse filename and the color type to give the benchmark a useful name
+    const char* colorName;
+    switch(colorType) {
+        case kN32_SkColorType:
+            colorName = "N32";
+            break;
+        case kRGB_565_SkColorType:
+            colorName = "565";
+            break;
+        default:
+            colorName = "Unknown";
+    }
+    fName.printf("CodecSubset_%dx%d_%s_%s", fDivisor, fDivisor, baseName.c_str(), colorName);
+}
+
+const char* CodecSubsetBench::onGetName() {
+    return fName.c_str();
+}
+
+bool CodecSubsetBench::isSuitableFor(Backend backend) {
+    return kNonRendering_Backend == backend;
+}
+
+void CodecSubsetBench::onPreDraw() {
+    SkAutoTDelete<SkCodec> codec(SkCodec::NewFromData(fData));
+    const SkISize size = codec->getInfo().dimensions();
+
+    fInfo = codec->getInfo().makeColorType(fColorType)
+                            .makeWH(size.width() / fDivisor, size.height() / fDivisor);
+    SkAlphaType alphaType;
+    // Caller should not have created this CodecSubsetBench if the alpha type was
+    // invalid.
+    SkAssertResult(SkColorTypeValidateAlphaType(fColorType, fInfo.alphaType(),
+                                                &alphaType));
+    if (alphaType != fInfo.alphaType()) {
+        fInfo = fInfo.makeAlphaType(alphaType);
+    }
+
+    fPixelStorage.reset(fInfo.getSafeSize(fInfo.minRowBytes()));
+}
+
+void CodecSubsetBench::onDraw(const int n, SkCanvas* canvas) {
+    for (int i = 0; i < n; i++) {
+        SkAutoTDelete<SkCodec> codec(SkCodec::NewFromData(fData));
+        const SkISize size = codec->getInfo().dimensions();
+        // Divide the image into subsets and decode each subset
+        for (int y = 0; y + fInfo.height() <= size.height(); y += fInfo.height()) {
+            for (int x = 0; x + fInfo.width() <= size.width(); x += fInfo.width()) {
+                const SkIRect subset = SkIRect::MakeXYWH(x, y, fInfo.width(), fInfo.height());
+#ifdef SK_DEBUG
+                const SkImageGenerator::Result result =
+#endif
+                codec->getSubsetPixels(size, subset, fInfo, fPixelStorage.get(),
+                                       fInfo.minRowBytes());
+                SkASSERT(result == SkImageGenerator::kSuccess
+                         || result == SkImageGenerator::kIncompleteInput);
+            }
+        }
+    }
+}
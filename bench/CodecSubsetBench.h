@@ -0,0 +1,41 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef CodecSubsetBench_DEFINED
+#define CodecSubsetBench_DEFINED
+
+#include "Benchmark.h"
+#include "SkData.h"
+#include "SkImageInfo.h"
+#include "SkRefCnt.h"
+#include "SkString.h"
+
+/**
+ *  Time SkCodec::getSubsetPixels(), decoding the whole image as a divisor x divisor grid of
+ *  subsets, like DecodingSubsetBench does with SkImageDecoder::decodeSubset().
+ */
+class CodecSubsetBench : public Benchmark {
+public:
+    // Calls encoded->ref()
+    CodecSubsetBench(SkString basename, SkData* encoded, SkColorType colorType, int divisor);
+
+protected:
+    const char* onGetName() override;
+    bool isSuitableFor(Backend backend) override;
+    void onDraw(const int n, SkCanvas* canvas) override;
+    void onPreDraw() override;
+
+private:
+    SkString                fName;
+    const SkColorType       fColorType;
+    const int               fDivisor;
+    SkAutoTUnref<SkData>    fData;
+    SkImageInfo             fInfo;          // Set in onPreDraw, the size of one subset.
+    SkAutoMalloc            fPixelStorage;
+    typedef Benchmark INHERITED;
+};
+#endif // CodecSubsetBench_DEFINED
@@ -9,6 +9,7 @@
 #include "SkCanvas.h"
 #include "SkColorFilterImageFilter.h"
 #include "SkColorMatrixFilter.h"
+#include "SkGradientShader.h"
 #include "SkLumaColorFilter.h"
 #include "SkTableColorFilter.h"
 
@@ -278,6 +279,44 @@ private:
     typedef ColorFilterBaseBench INHERITED;
 };
 
+// A gradient through a color matrix into an xfermode, which the raster blitter can keep in
+// floats from shader to xfermode.
+class ColorFilterPaintBench : public Benchmark {
+public:
+    ColorFilterPaintBench(SkXfermode::Mode mode) : fMode(mode) {
+        fName.printf("colorfilter_paint_%s", SkXfermode::ModeName(mode));
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDraw(const int loops, SkCanvas* canvas) override {
+        const SkRect r = SkRect::MakeWH(FILTER_WIDTH_LARGE, FILTER_HEIGHT_LARGE);
+        const SkPoint pts[] = { { 0, 0 }, { r.width(), r.height() } };
+        const SkColor colors[] = { SkColorSetARGB(0x80, 0xFF, 0, 0), SK_ColorGREEN };
+        SkColorMatrix matrix;
+        matrix.setSaturation(0.5f);
+        SkAutoTUnref<SkColorFilter> filter(SkColorMatrixFilter::Create(matrix));
+
+        SkPaint paint;
+        paint.setShader(SkGradientShader::CreateLinear(pts, colors, NULL, 2,
+                                                       SkShader::kClamp_TileMode))->unref();
+        paint.setColorFilter(filter);
+        paint.setXfermodeMode(fMode);
+        for (int i = 0; i < loops; i++) {
+            canvas->drawRect(r, paint);
+        }
+    }
+
+private:
+    SkString            fName;
+    SkXfermode::Mode    fMode;
+
+    typedef Benchmark INHERITED;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return new ColorFilterDimBrightBench(true); )
@@ -297,3 +336,9 @@ DEF_BENCH( return new ColorFilterBrightBlueBench(false); )
 DEF_BENCH( return new ColorFilterBrightBench(false); )
 DEF_BENCH( return new ColorFilterBlueBench(false); )
 DEF_BENCH( return new ColorFilterGrayBench(false); )
+
+DEF_BENCH( return new ColorFilterPaintBench(SkXfermode::kSrcOver_Mode); )
+DEF_BENCH( return new ColorFilterPaintBench(SkXfermode::kMultiply_Mode); )
+DEF_BENCH( return new ColorFilterPaintBench(SkXfermode::kScreen_Mode); )
+DEF_BENCH( return new ColorFilterPaintBench(SkXfermode::kSrcIn_Mode); )
+DEF_BENCH( return new ColorFilterPaintBench(SkXfermode::kDarken_Mode); )
@@ -10,6 +10,7 @@
 #include "SkChecksum.h"
 #include "SkPaint.h"
 #include "SkString.h"
+#include "SkTaskGroup.h"
 #include "SkTemplates.h"
 
 #include "gUniqueGlyphIDs.h"
@@ -51,6 +52,51 @@ private:
     typedef Benchmark INHERITED;
 };
 
+// Measures the same text from many threads at once, so the threads fight over the shared glyph
+// cache.  Each thread cycles through fSizes text sizes, i.e. that many distinct strikes.
+class FontCacheThreadedBench : public Benchmark {
+public:
+    FontCacheThreadedBench(int threads, int sizes) : fThreads(threads), fSizes(sizes) {
+        fName.printf("fontcache_mt_%d_%d", threads, sizes);
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void onDraw(const int loops, SkCanvas*) override {
+        SkPaint paint;
+        this->setupPaint(&paint);
+        paint.setTextEncoding(SkPaint::kGlyphID_TextEncoding);
+
+        const int sizes = fSizes;
+        sk_parallel_for(fThreads, 1, [&](int thread) {
+            SkPaint p(paint);
+            for (int i = 0; i < loops; ++i) {
+                p.setTextSize(SkIntToScalar(12 + (thread + i) % sizes));
+                const uint16_t* array = gUniqueGlyphIDs;
+                while (*array != gUniqueGlyphIDs_Sentinel) {
+                    int count = count_glyphs(array);
+                    p.measureText(array, count * sizeof(uint16_t));
+                    array += count + 1;    // skip the sentinel
+                }
+            }
+        });
+    }
+
+private:
+    SkString fName;
+    int      fThreads;
+    int      fSizes;
+
+    typedef Benchmark INHERITED;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 static uint32_t rotr(uint32_t value, unsigned bits) {
@@ -143,5 +189,12 @@ private:
 
 DEF_BENCH( return new FontCacheBench(); )
 
+DEF_BENCH( return new FontCacheThreadedBench(1,  1); )
+DEF_BENCH( return new FontCacheThreadedBench(4,  1); )
+DEF_BENCH( return new FontCacheThreadedBench(16, 1); )
+DEF_BENCH( return new FontCacheThreadedBench(1,  16); )
+DEF_BENCH( return new FontCacheThreadedBench(4,  16); )
+DEF_BENCH( return new FontCacheThreadedBench(16, 16); )
+
 // undefine this to run the efficiency test
 //DEF_BENCH( return new FontCacheEfficiency(); )
@@ -7,6 +7,8 @@
 
 #include "Benchmark.h"
 #include "SkResourceCache.h"
+#include "SkTaskGroup.h"
+#include "SkThread.h"
 
 namespace {
 static void* gGlobalAddress;
@@ -70,6 +72,68 @@ private:
     typedef Benchmark INHERITED;
 };
 
+/**
+ *  Threads looking up and adding entries all at once, either through the global cache, which
+ *  is sharded, or through one cache behind a single mutex, as the global cache used to be.
+ */
+class ImageCacheContendedBench : public Benchmark {
+    enum {
+        CACHE_COUNT = 500,
+        THREAD_COUNT = 8,
+    };
+
+public:
+    ImageCacheContendedBench(bool sharded) : fSharded(sharded), fCache(CACHE_COUNT * 100) {}
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fSharded ? "imagecache_contended_sharded" : "imagecache_contended_single_mutex";
+    }
+
+    bool find(const TestKey& key) {
+        if (fSharded) {
+            return SkResourceCache::Find(key, TestRec::Visitor, NULL);
+        }
+        SkAutoMutexAcquire am(fMutex);
+        return fCache.find(key, TestRec::Visitor, NULL);
+    }
+
+    void add(TestRec* rec) {
+        if (fSharded) {
+            SkResourceCache::Add(rec);
+        } else {
+            SkAutoMutexAcquire am(fMutex);
+            fCache.add(rec);
+        }
+    }
+
+    void onDraw(const int loops, SkCanvas*) override {
+        sk_parallel_for(THREAD_COUNT, 1, [&](int thread) {
+            for (int i = 0; i < loops; ++i) {
+                // Mostly hits, with a different stride per thread so they don't move in step.
+                const intptr_t value = (i * (2 * thread + 1)) % CACHE_COUNT;
+                const TestKey key(value);
+                if (!this->find(key)) {
+                    this->add(SkNEW_ARGS(TestRec, (key, value)));
+                }
+            }
+        });
+    }
+
+private:
+    bool            fSharded;
+    SkMutex         fMutex;
+    SkResourceCache fCache;
+
+    typedef Benchmark INHERITED;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return new ImageCacheBench(); )
+DEF_BENCH( return new ImageCacheContendedBench(true); )
+DEF_BENCH( return new ImageCacheContendedBench(false); )
@@ -8,6 +8,7 @@
 #include "Benchmark.h"
 #include "SkBlurImageFilter.h"
 #include "SkCanvas.h"
+#include "SkLightingImageFilter.h"
 #include "SkMergeImageFilter.h"
 
 enum { kNumInputs = 5 };
@@ -15,33 +16,62 @@ enum { kNumInputs = 5 };
 // Exercise a blur filter connected to 5 inputs of the same merge filter.
 // This bench shows an improvement in performance once cacheing of re-used
 // nodes is implemented, since the DAG is no longer flattened to a tree.
+//
+// The lighting variant lights the blur and merges it back over the blur, and
+// the clipped variants draw through a small clip, of which only the part of
+// the DAG that the clip depends on should be evaluated.
 
 class ImageFilterDAGBench : public Benchmark {
 public:
-    ImageFilterDAGBench() {}
+    ImageFilterDAGBench(bool lighting, bool clipped)
+        : fLighting(lighting)
+        , fClipped(clipped) {
+        fName.printf("image_filter_dag%s%s", lighting ? "_lighting" : "",
+                     clipped ? "_clipped" : "");
+    }
 
 protected:
     const char* onGetName() override {
-        return "image_filter_dag";
+        return fName.c_str();
     }
 
     void onDraw(const int loops, SkCanvas* canvas) override {
         for (int j = 0; j < loops; j++) {
             SkAutoTUnref<SkImageFilter> blur(SkBlurImageFilter::Create(20.0f, 20.0f));
-            SkImageFilter* inputs[kNumInputs];
-            for (int i = 0; i < kNumInputs; ++i) {
-                inputs[i] = blur.get();
+            SkAutoTUnref<SkImageFilter> merge;
+            if (fLighting) {
+                SkPoint3 direction(SK_Scalar1, SK_Scalar1, SK_Scalar1);
+                SkAutoTUnref<SkImageFilter> lighting(SkLightingImageFilter::CreateDistantLitDiffuse(
+                    direction, SK_ColorWHITE, SkIntToScalar(10), SK_ScalarHalf, blur));
+                merge.reset(SkMergeImageFilter::Create(blur, lighting));
+            } else {
+                SkImageFilter* inputs[kNumInputs];
+                for (int i = 0; i < kNumInputs; ++i) {
+                    inputs[i] = blur.get();
+                }
+                merge.reset(SkMergeImageFilter::Create(inputs, kNumInputs));
             }
-            SkAutoTUnref<SkImageFilter> merge(SkMergeImageFilter::Create(inputs, kNumInputs));
             SkPaint paint;
             paint.setImageFilter(merge);
             SkRect rect = SkRect::Make(SkIRect::MakeWH(400, 400));
+            canvas->save();
+            if (fClipped) {
+                canvas->clipRect(SkRect::MakeXYWH(100, 100, 32, 32));
+            }
             canvas->drawRect(rect, paint);
+            canvas->restore();
         }
     }
 
 private:
+    SkString fName;
+    bool     fLighting;
+    bool     fClipped;
+
     typedef Benchmark INHERITED;
 };
 
-DEF_BENCH(return new ImageFilterDAGBench;)
+DEF_BENCH(return new ImageFilterDAGBench(false, false);)
+DEF_BENCH(return new ImageFilterDAGBench(false, true);)
+DEF_BENCH(return new ImageFilterDAGBench(true, false);)
+DEF_BENCH(return new ImageFilterDAGBench(true, true);)
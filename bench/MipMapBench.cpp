@@ -8,28 +8,39 @@
 #include "Benchmark.h"
 #include "SkBitmap.h"
 #include "SkMipMap.h"
+#include "SkString.h"
 
 class MipMapBench: public Benchmark {
-    SkBitmap fBitmap;
+    SkBitmap    fBitmap;
+    SkString    fName;
+    const int   fW, fH;
+    const bool  fAllLevels;
 
 public:
-    MipMapBench() {}
+    // With allLevels, every level is built, not just the first one that Build() makes.
+    MipMapBench(int w, int h, bool allLevels) : fW(w), fH(h), fAllLevels(allLevels) {
+        fName.printf("mipmap_build_%dx%d%s", w, h, allLevels ? "_all" : "");
+    }
 
 protected:
     bool isSuitableFor(Backend backend) override {
         return kNonRendering_Backend == backend;
     }
 
-    const char* onGetName() override { return "mipmap_build"; }
+    const char* onGetName() override { return fName.c_str(); }
 
     void onPreDraw() override {
-        fBitmap.allocN32Pixels(1000, 1000, true);
+        fBitmap.allocN32Pixels(fW, fH, true);
         fBitmap.eraseColor(SK_ColorWHITE);  // so we don't read uninitialized memory
     }
 
     void onDraw(const int loops, SkCanvas*) override {
         for (int i = 0; i < loops; i++) {
-            SkMipMap::Build(fBitmap, NULL)->unref();
+            SkMipMap* mipmap = SkMipMap::Build(fBitmap, NULL);
+            if (fAllLevels) {
+                mipmap->extractLevel(SK_Scalar1 / fW, NULL);
+            }
+            mipmap->unref();
         }
     }
 
@@ -37,4 +48,8 @@ private:
     typedef Benchmark INHERITED;
 };
 
-DEF_BENCH( return new MipMapBench; )
+// Powers of two, and odd sizes that use the 3-tap filters at every level.
+DEF_BENCH( return new MipMapBench(1000, 1000, false); )
+DEF_BENCH( return new MipMapBench(1000, 1000, true); )
+DEF_BENCH( return new MipMapBench(1024, 1024, true); )
+DEF_BENCH( return new MipMapBench(1023, 1023, true); )
@@ -8,16 +8,19 @@
 #include "Benchmark.h"
 #include "SkBitmap.h"
 #include "SkCanvas.h"
+#include "SkCanvasPriv.h"
 #include "SkColorPriv.h"
 #include "SkPaint.h"
 #include "SkRandom.h"
+#include "SkScan.h"
 #include "SkShader.h"
 #include "SkString.h"
 #include "SkTArray.h"
 
 enum Flags {
-    kStroke_Flag = 1 << 0,
-    kBig_Flag    = 1 << 1
+    kStroke_Flag     = 1 << 0,
+    kBig_Flag        = 1 << 1,
+    kAnalyticAA_Flag = 1 << 2,
 };
 
 #define FLAGS00  Flags(0)
@@ -25,6 +28,12 @@ enum Flags {
 #define FLAGS10  Flags(kBig_Flag)
 #define FLAGS11  Flags(kStroke_Flag | kBig_Flag)
 
+// The same, drawn with analytic coverage AA instead of supersampling.
+#define AAFLAGS00  Flags(kAnalyticAA_Flag)
+#define AAFLAGS01  Flags(kAnalyticAA_Flag | kStroke_Flag)
+#define AAFLAGS10  Flags(kAnalyticAA_Flag | kBig_Flag)
+#define AAFLAGS11  Flags(kAnalyticAA_Flag | kStroke_Flag | kBig_Flag)
+
 class PathBench : public Benchmark {
     SkPaint     fPaint;
     SkString    fName;
@@ -47,6 +56,9 @@ protected:
                      fFlags & kStroke_Flag ? "stroke" : "fill",
                      fFlags & kBig_Flag ? "big" : "small");
         this->appendName(&fName);
+        if (fFlags & kAnalyticAA_Flag) {
+            fName.append("_analytic");
+        }
         return fName.c_str();
     }
 
@@ -67,9 +79,12 @@ protected:
         }
         count >>= (3 * complexity());
 
+        const uint32_t scanFlags = SkCanvasPriv::SetScanFlags(canvas,
+                (fFlags & kAnalyticAA_Flag) ? SkScan::kAnalyticAA_PathFlag : 0);
         for (int i = 0; i < count; i++) {
             canvas->drawPath(path, paint);
         }
+        SkCanvasPriv::SetScanFlags(canvas, scanFlags);
     }
 
 private:
@@ -996,6 +1011,10 @@ DEF_BENCH( return new TrianglePathBench(FLAGS00); )
 DEF_BENCH( return new TrianglePathBench(FLAGS01); )
 DEF_BENCH( return new TrianglePathBench(FLAGS10); )
 DEF_BENCH( return new TrianglePathBench(FLAGS11); )
+DEF_BENCH( return new TrianglePathBench(AAFLAGS00); )
+DEF_BENCH( return new TrianglePathBench(AAFLAGS01); )
+DEF_BENCH( return new TrianglePathBench(AAFLAGS10); )
+DEF_BENCH( return new TrianglePathBench(AAFLAGS11); )
 
 DEF_BENCH( return new RectPathBench(FLAGS00); )
 DEF_BENCH( return new RectPathBench(FLAGS01); )
@@ -1006,17 +1025,29 @@ DEF_BENCH( return new OvalPathBench(FLAGS00); )
 DEF_BENCH( return new OvalPathBench(FLAGS01); )
 DEF_BENCH( return new OvalPathBench(FLAGS10); )
 DEF_BENCH( return new OvalPathBench(FLAGS11); )
+DEF_BENCH( return new OvalPathBench(AAFLAGS00); )
+DEF_BENCH( return new OvalPathBench(AAFLAGS01); )
+DEF_BENCH( return new OvalPathBench(AAFLAGS10); )
+DEF_BENCH( return new OvalPathBench(AAFLAGS11); )
 
 DEF_BENCH( return new CirclePathBench(FLAGS00); )
 DEF_BENCH( return new CirclePathBench(FLAGS01); )
 DEF_BENCH( return new CirclePathBench(FLAGS10); )
 DEF_BENCH( return new CirclePathBench(FLAGS11); )
+DEF_BENCH( return new CirclePathBench(AAFLAGS00); )
+DEF_BENCH( return new CirclePathBench(AAFLAGS01); )
+DEF_BENCH( return new CirclePathBench(AAFLAGS10); )
+DEF_BENCH( return new CirclePathBench(AAFLAGS11); )
 
 DEF_BENCH( return new SawToothPathBench(FLAGS00); )
 DEF_BENCH( return new SawToothPathBench(FLAGS01); )
+DEF_BENCH( return new SawToothPathBench(AAFLAGS00); )
+DEF_BENCH( return new SawToothPathBench(AAFLAGS01); )
 
 DEF_BENCH( return new LongCurvedPathBench(FLAGS00); )
 DEF_BENCH( return new LongCurvedPathBench(FLAGS01); )
+DEF_BENCH( return new LongCurvedPathBench(AAFLAGS00); )
+DEF_BENCH( return new LongCurvedPathBench(AAFLAGS01); )
 DEF_BENCH( return new LongLinePathBench(FLAGS00); )
 DEF_BENCH( return new LongLinePathBench(FLAGS01); )
 
@@ -0,0 +1,97 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkBitmap.h"
+#include "SkColorPriv.h"
+#include "SkData.h"
+#include "SkForceLinking.h"
+#include "SkPNGImageEncoder.h"
+#include "SkRandom.h"
+#include "SkString.h"
+
+__SK_FORCE_IMAGE_DECODER_LINKING;
+
+// SkPNGImageEncoder is only built where Skia uses libpng.
+#if defined(SK_BUILD_FOR_ANDROID) || defined(SK_BUILD_FOR_UNIX)
+
+/**
+ *  Encodes a 512x512 N32 bitmap as PNG with the given options. Opaque bitmaps exercise the
+ *  N32 to RGB transform, the others the unpremultiplying N32 to RGBA one.
+ */
+class PngEncodeBench : public Benchmark {
+public:
+    typedef SkPNGImageEncoder::Options Options;
+
+    PngEncodeBench(bool opaque, const char* optionsName, const Options& options)
+        : fOpaque(opaque)
+        , fOptions(options) {
+        fName.printf("png_encode_%s_%s", opaque ? "opaque" : "alpha", optionsName);
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onPreDraw() override {
+        fBitmap.allocN32Pixels(512, 512, fOpaque);
+        SkRandom rand;
+        for (int y = 0; y < fBitmap.height(); y++) {
+            for (int x = 0; x < fBitmap.width(); x++) {
+                // Gradients with a little noise, something like a photo.
+                const U8CPU noise = rand.nextU() & 0x7;
+                const U8CPU a = fOpaque ? 0xFF : (x + y) / 4;
+                *fBitmap.getAddr32(x, y) = SkPreMultiplyARGB(a, x / 2 + noise, y / 2,
+                                                             (x ^ y) / 4 + noise);
+            }
+        }
+        fEncoder.setOptions(fOptions);
+    }
+
+    void onDraw(const int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; i++) {
+            SkAutoTUnref<SkData> data(fEncoder.encodeData(fBitmap, 100));
+        }
+    }
+
+private:
+    bool                            fOpaque;
+    Options                         fOptions;
+    SkString                        fName;
+    SkBitmap                        fBitmap;
+    SkPNGImageEncoder               fEncoder;
+
+    typedef Benchmark INHERITED;
+};
+
+static const unsigned kAll_FilterFlags = PngEncodeBench::Options::kAll_FilterFlags,
+                      kSub_FilterFlag  = PngEncodeBench::Options::kSub_FilterFlag,
+                      kNone_FilterFlag = PngEncodeBench::Options::kNone_FilterFlag;
+
+static PngEncodeBench::Options make_options(int level, unsigned filterFlags, int threads) {
+    PngEncodeBench::Options options;
+    options.fZLibLevel = level;
+    options.fFilterFlags = filterFlags;
+    options.fThreadCount = threads;
+    return options;
+}
+
+DEF_BENCH(return new PngEncodeBench(true, "default", make_options(6, kAll_FilterFlags, 1));)
+DEF_BENCH(return new PngEncodeBench(true, "fast", make_options(1, kSub_FilterFlag, 1));)
+DEF_BENCH(return new PngEncodeBench(true, "nofilter", make_options(6, kNone_FilterFlag, 1));)
+DEF_BENCH(return new PngEncodeBench(true, "threads4", make_options(6, kAll_FilterFlags, 4));)
+DEF_BENCH(return new PngEncodeBench(false, "default", make_options(6, kAll_FilterFlags, 1));)
+DEF_BENCH(return new PngEncodeBench(false, "fast", make_options(1, kSub_FilterFlag, 1));)
+DEF_BENCH(return new PngEncodeBench(false, "nofilter", make_options(6, kNone_FilterFlag, 1));)
+DEF_BENCH(return new PngEncodeBench(false, "threads4", make_options(6, kAll_FilterFlags, 4));)
+
+#endif  // SK_BUILD_FOR_ANDROID || SK_BUILD_FOR_UNIX
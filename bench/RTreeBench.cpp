@@ -7,6 +7,7 @@
 
 #include "Benchmark.h"
 #include "SkCanvas.h"
+#include "SkIncrementalRTree.h"
 #include "SkRTree.h"
 #include "SkRandom.h"
 #include "SkString.h"
@@ -19,11 +20,49 @@ static const int GRID_WIDTH = 100;
 
 typedef SkRect (*MakeRectProc)(SkRandom&, int, int);
 
+enum TreeType {
+    kSTR_TreeType,
+    kHilbert_TreeType,
+    kIncremental_TreeType,  // Built one rect at a time.
+};
+
+static const char* tree_prefix(TreeType type) {
+    switch (type) {
+        case kSTR_TreeType:         return "rtree";
+        case kHilbert_TreeType:     return "rtree_hilbert";
+        case kIncremental_TreeType: return "rtree_incremental";
+    }
+    SkFAIL("Unknown TreeType");
+    return NULL;
+}
+
+static SkBBoxHierarchy* build_tree(TreeType type, const SkRect rects[], int N) {
+    SkBBoxHierarchy* tree = NULL;
+    switch (type) {
+        case kSTR_TreeType:
+            tree = SkNEW(SkRTree);
+            tree->insert(rects, N);
+            break;
+        case kHilbert_TreeType:
+            tree = SkNEW_ARGS(SkRTree, (1, SkRTree::kHilbert_BulkLoad));
+            tree->insert(rects, N);
+            break;
+        case kIncremental_TreeType:
+            tree = SkNEW(SkIncrementalRTree);
+            for (int i = 0; i < N; i++) {
+                tree->insert(rects + i, 1);
+            }
+            break;
+    }
+    return tree;
+}
+
 // Time how long it takes to build an R-Tree.
 class RTreeBuildBench : public Benchmark {
 public:
-    RTreeBuildBench(const char* name, MakeRectProc proc) : fProc(proc) {
-        fName.printf("rtree_%s_build", name);
+    RTreeBuildBench(const char* name, MakeRectProc proc, TreeType type = kSTR_TreeType)
+        : fProc(proc), fType(type) {
+        fName.printf("%s_%s_build", tree_prefix(type), name);
     }
 
     bool isSuitableFor(Backend backend) override {
@@ -42,13 +81,13 @@ protected:
         }
 
         for (int i = 0; i < loops; ++i) {
-            SkRTree tree;
-            tree.insert(rects.get(), NUM_BUILD_RECTS);
+            SkAutoTUnref<SkBBoxHierarchy> tree(build_tree(fType, rects.get(), NUM_BUILD_RECTS));
             SkASSERT(rects != NULL);  // It'd break this bench if the tree took ownership of rects.
         }
     }
 private:
     MakeRectProc fProc;
+    TreeType fType;
     SkString fName;
     typedef Benchmark INHERITED;
 };
@@ -56,8 +95,9 @@ private:
 // Time how long it takes to perform queries on an R-Tree.
 class RTreeQueryBench : public Benchmark {
 public:
-    RTreeQueryBench(const char* name, MakeRectProc proc) : fProc(proc) {
-        fName.printf("rtree_%s_query", name);
+    RTreeQueryBench(const char* name, MakeRectProc proc, TreeType type = kSTR_TreeType)
+        : fProc(proc), fType(type) {
+        fName.printf("%s_%s_query", tree_prefix(type), name);
     }
 
     bool isSuitableFor(Backend backend) override {
@@ -73,7 +113,7 @@ protected:
         for (int i = 0; i < NUM_QUERY_RECTS; ++i) {
             rects[i] = fProc(rand, i, NUM_QUERY_RECTS);
         }
-        fTree.insert(rects.get(), NUM_QUERY_RECTS);
+        fTree.reset(build_tree(fType, rects.get(), NUM_QUERY_RECTS));
     }
 
     void onDraw(const int loops, SkCanvas* canvas) override {
@@ -85,12 +125,13 @@ protected:
             query.fTop    = rand.nextRangeF(0, GENERATE_EXTENTS);
             query.fRight  = query.fLeft + 1 + rand.nextRangeF(0, GENERATE_EXTENTS/2);
             query.fBottom = query.fTop  + 1 + rand.nextRangeF(0, GENERATE_EXTENTS/2);
-            fTree.search(query, &hits);
+            fTree->search(query, &hits);
         }
     }
 private:
-    SkRTree fTree;
+    SkAutoTUnref<SkBBoxHierarchy> fTree;
     MakeRectProc fProc;
+    TreeType fType;
     SkString fName;
     typedef Benchmark INHERITED;
 };
@@ -132,7 +173,43 @@ DEF_BENCH(return SkNEW_ARGS(RTreeBuildBench, ("YX",         &make_YXordered_rect
 DEF_BENCH(return SkNEW_ARGS(RTreeBuildBench, ("random",     &make_random_rects)));
 DEF_BENCH(return SkNEW_ARGS(RTreeBuildBench, ("concentric", &make_concentric_rects)));
 
+DEF_BENCH(return SkNEW_ARGS(RTreeBuildBench,
+                            ("XY",         &make_XYordered_rects,  kHilbert_TreeType)));
+DEF_BENCH(return SkNEW_ARGS(RTreeBuildBench,
+                            ("YX",         &make_YXordered_rects,  kHilbert_TreeType)));
+DEF_BENCH(return SkNEW_ARGS(RTreeBuildBench,
+                            ("random",     &make_random_rects,     kHilbert_TreeType)));
+DEF_BENCH(return SkNEW_ARGS(RTreeBuildBench,
+                            ("concentric", &make_concentric_rects, kHilbert_TreeType)));
+
+DEF_BENCH(return SkNEW_ARGS(RTreeBuildBench,
+                            ("XY",         &make_XYordered_rects,  kIncremental_TreeType)));
+DEF_BENCH(return SkNEW_ARGS(RTreeBuildBench,
+                            ("YX",         &make_YXordered_rects,  kIncremental_TreeType)));
+DEF_BENCH(return SkNEW_ARGS(RTreeBuildBench,
+                            ("random",     &make_random_rects,     kIncremental_TreeType)));
+DEF_BENCH(return SkNEW_ARGS(RTreeBuildBench,
+                            ("concentric", &make_concentric_rects, kIncremental_TreeType)));
+
 DEF_BENCH(return SkNEW_ARGS(RTreeQueryBench, ("XY",         &make_XYordered_rects)));
 DEF_BENCH(return SkNEW_ARGS(RTreeQueryBench, ("YX",         &make_YXordered_rects)));
 DEF_BENCH(return SkNEW_ARGS(RTreeQueryBench, ("random",     &make_random_rects)));
 DEF_BENCH(return SkNEW_ARGS(RTreeQueryBench, ("concentric", &make_concentric_rects)));
+
+DEF_BENCH(return SkNEW_ARGS(RTreeQueryBench,
+                            ("XY",         &make_XYordered_rects,  kHilbert_TreeType)));
+DEF_BENCH(return SkNEW_ARGS(RTreeQueryBench,
+                            ("YX",         &make_YXordered_rects,  kHilbert_TreeType)));
+DEF_BENCH(return SkNEW_ARGS(RTreeQueryBench,
+                            ("random",     &make_random_rects,     kHilbert_TreeType)));
+DEF_BENCH(return SkNEW_ARGS(RTreeQueryBench,
+                            ("concentric", &make_concentric_rects, kHilbert_TreeType)));
+
+DEF_BENCH(return SkNEW_ARGS(RTreeQueryBench,
+                            ("XY",         &make_XYordered_rects,  kIncremental_TreeType)));
+DEF_BENCH(return SkNEW_ARGS(RTreeQueryBench,
+                            ("YX",         &make_YXordered_rects,  kIncremental_TreeType)));
+DEF_BENCH(return SkNEW_ARGS(RTreeQueryBench,
+                            ("random",     &make_random_rects,     kIncremental_TreeType)));
+DEF_BENCH(return SkNEW_ARGS(RTreeQueryBench,
+                            ("concentric", &make_concentric_rects, kIncremental_TreeType)));
@@ -9,21 +9,25 @@
 #include "SkCommandLineFlags.h"
 #include "SkMultiPictureDraw.h"
 #include "SkSurface.h"
+#include "SkTiledPictureDraw.h"
 
 DEFINE_int32(benchTileW, 1600, "Tile width  used for SKP playback.");
 DEFINE_int32(benchTileH, 512, "Tile height used for SKP playback.");
 
 SKPBench::SKPBench(const char* name, const SkPicture* pic, const SkIRect& clip, SkScalar scale,
-                   bool useMultiPictureDraw)
+                   Mode mode)
     : fPic(SkRef(pic))
     , fClip(clip)
     , fScale(scale)
     , fName(name)
-    , fUseMultiPictureDraw(useMultiPictureDraw) {
+    , fMode(mode) {
     fUniqueName.printf("%s_%.2g", name, scale);  // Scale makes this unqiue for perf.skia.org traces.
-    if (useMultiPictureDraw) {
+    if (kMultiPictureDraw_Mode == mode) {
         fUniqueName.append("_mpd");
     }
+    if (kTiledRaster_Mode == mode) {
+        fUniqueName.append("_tiled");
+    }
 }
 
 SKPBench::~SKPBench() {
@@ -44,6 +48,22 @@ void SKPBench::onPerCanvasPreDraw(SkCanvas* canvas) {
     SkIRect bounds;
     SkAssertResult(canvas->getClipDeviceBounds(&bounds));
 
+    if (kTiledRaster_Mode == fMode) {
+        // Draw into the subset of the canvas' pixels inside the clip, lined up with its origin.
+        SkImageInfo info;
+        size_t rowBytes;
+        void* pixels = canvas->accessTopLayerPixels(&info, &rowBytes);
+        SkASSERT(pixels);
+        SkBitmap all;
+        all.installPixels(info, pixels, rowBytes);
+        SkAssertResult(all.extractSubset(&fPixels, bounds));
+
+        fMatrix = canvas->getTotalMatrix();
+        fMatrix.postTranslate(-SkIntToScalar(bounds.fLeft), -SkIntToScalar(bounds.fTop));
+        fMatrix.preScale(fScale, fScale);
+        return;
+    }
+
     int tileW = SkTMin(FLAGS_benchTileW, bounds.width());
     int tileH = SkTMin(FLAGS_benchTileH, bounds.height());
 
@@ -74,6 +94,9 @@ void SKPBench::onPerCanvasPreDraw(SkCanvas* canvas) {
 }
 
 void SKPBench::onPerCanvasPostDraw(SkCanvas* canvas) {
+    // In kTiledRaster_Mode we've drawn straight into canvas' pixels, and fTileRects is empty.
+    fPixels.reset();
+
     // Draw the last set of tiles into the master canvas in case we're
     // saving the images
     for (int i = 0; i < fTileRects.count(); ++i) {
@@ -88,6 +111,9 @@ void SKPBench::onPerCanvasPostDraw(SkCanvas* canvas) {
 }
 
 bool SKPBench::isSuitableFor(Backend backend) {
+    if (kTiledRaster_Mode == fMode) {
+        return backend == kRaster_Backend;
+    }
     return backend != kNonRendering_Backend;
 }
 
@@ -96,7 +122,11 @@ SkIPoint SKPBench::onGetSize() {
 }
 
 void SKPBench::onDraw(const int loops, SkCanvas* canvas) {
-    if (fUseMultiPictureDraw) {
+    if (kTiledRaster_Mode == fMode) {
+        for (int i = 0; i < loops; i++) {
+            SkTiledPictureDraw(fPic, fPixels, &fMatrix, FLAGS_benchTileW, FLAGS_benchTileH);
+        }
+    } else if (kMultiPictureDraw_Mode == fMode) {
         for (int i = 0; i < loops; i++) {
             SkMultiPictureDraw mpd;
 
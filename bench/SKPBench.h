@@ -17,8 +17,13 @@
  */
 class SKPBench : public Benchmark {
 public:
-    SKPBench(const char* name, const SkPicture*, const SkIRect& devClip, SkScalar scale,
-             bool useMultiPictureDraw);
+    enum Mode {
+        kSerial_Mode,            // Draw each tile's surface in turn.
+        kMultiPictureDraw_Mode,  // Draw all tiles' surfaces with one SkMultiPictureDraw.
+        kTiledRaster_Mode,       // Draw straight into the canvas' pixels with SkTiledPictureDraw.
+    };
+
+    SKPBench(const char* name, const SkPicture*, const SkIRect& devClip, SkScalar scale, Mode);
     ~SKPBench() override;
 
 protected:
@@ -37,9 +42,11 @@ private:
     SkString fName;
     SkString fUniqueName;
 
-    const bool fUseMultiPictureDraw;
-    SkTDArray<SkSurface*> fSurfaces;   // for MultiPictureDraw
-    SkTDArray<SkIRect> fTileRects;     // for MultiPictureDraw
+    const Mode fMode;
+    SkTDArray<SkSurface*> fSurfaces;   // for kSerial_Mode and kMultiPictureDraw_Mode
+    SkTDArray<SkIRect> fTileRects;     // for kSerial_Mode and kMultiPictureDraw_Mode
+    SkBitmap fPixels;                  // for kTiledRaster_Mode
+    SkMatrix fMatrix;                  // for kTiledRaster_Mode
 
     typedef Benchmark INHERITED;
 };
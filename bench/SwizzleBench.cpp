@@ -0,0 +1,72 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkRandom.h"
+#include "SkString.h"
+#include "SkSwizzler.h"
+#include "SkTemplates.h"
+
+// Times SkSwizzler converting rows of decoded bytes to N32, as the codecs use it.
+class SwizzleBench : public Benchmark {
+public:
+    SwizzleBench(const char* name, SkSwizzler::SrcConfig sc, SkAlphaType alphaType)
+        : fSrcConfig(sc)
+        , fAlphaType(alphaType) {
+        fName.printf("swizzle_%s_%s", name,
+                     kUnpremul_SkAlphaType == alphaType ? "unpremul" : "premul");
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onPreDraw() override {
+        const int bytes = kWidth * SkSwizzler::BytesPerPixel(fSrcConfig);
+        fSrc.reset(bytes);
+        SkRandom rand;
+        for (int i = 0; i < bytes; i++) {
+            fSrc[i] = rand.nextU() & 0xFF;
+        }
+        fDst.reset(kWidth);
+    }
+
+    void onDraw(const int loops, SkCanvas*) override {
+        const SkImageInfo info = SkImageInfo::MakeN32(kWidth, 1, fAlphaType);
+        for (int i = 0; i < loops; i++) {
+            SkAutoTDelete<SkSwizzler> swizzler(SkSwizzler::CreateSwizzler(fSrcConfig, NULL,
+                    info, fDst.get(), info.minRowBytes(),
+                    SkImageGenerator::kNo_ZeroInitialized));
+            swizzler->next(fSrc.get());
+        }
+    }
+
+private:
+    static const int kWidth = 4096;
+
+    SkString                 fName;
+    SkSwizzler::SrcConfig    fSrcConfig;
+    SkAlphaType              fAlphaType;
+    SkAutoTMalloc<uint8_t>   fSrc;
+    SkAutoTMalloc<SkPMColor> fDst;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return SkNEW_ARGS(SwizzleBench, ("rgba", SkSwizzler::kRGBA, kPremul_SkAlphaType)); )
+DEF_BENCH( return SkNEW_ARGS(SwizzleBench, ("rgba", SkSwizzler::kRGBA, kUnpremul_SkAlphaType)); )
+DEF_BENCH( return SkNEW_ARGS(SwizzleBench, ("bgra", SkSwizzler::kBGRA, kPremul_SkAlphaType)); )
+DEF_BENCH( return SkNEW_ARGS(SwizzleBench, ("bgra", SkSwizzler::kBGRA, kUnpremul_SkAlphaType)); )
+DEF_BENCH( return SkNEW_ARGS(SwizzleBench, ("rgbx", SkSwizzler::kRGBX, kPremul_SkAlphaType)); )
+DEF_BENCH( return SkNEW_ARGS(SwizzleBench, ("bgrx", SkSwizzler::kBGRX, kPremul_SkAlphaType)); )
+DEF_BENCH( return SkNEW_ARGS(SwizzleBench, ("rgb", SkSwizzler::kRGB, kPremul_SkAlphaType)); )
+DEF_BENCH( return SkNEW_ARGS(SwizzleBench, ("bgr", SkSwizzler::kBGR, kPremul_SkAlphaType)); )
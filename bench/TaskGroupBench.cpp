@@ -0,0 +1,78 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkString.h"
+#include "SkTaskGroup.h"
+
+// A fixed amount of busywork, small enough that scheduling overhead shows up at fine grains.
+static float busywork(int i) {
+    float x = (float)i;
+    for (int j = 0; j < 256; j++) {
+        x = x * 0.999f + 1.0f;
+    }
+    return x;
+}
+
+// Runs the same total work (kN calls to busywork) split into fWidth parallel chunks.  Width 1 is
+// serial, so comparing widths 1 through N shows how well the pool scales across threads.
+// Run nanobench with --threads to vary the pool size itself.
+class TaskGroupBench : public Benchmark {
+public:
+    TaskGroupBench(int width, bool nested) : fWidth(width), fNested(nested) {
+        fName.printf("taskgroup_%s_%d", nested ? "nested" : "flat", width);
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDraw(const int loops, SkCanvas*) override {
+        static const int kN = 1 << 14;
+        const int grain = kN / fWidth;
+        for (int i = 0; i < loops; i++) {
+            if (fNested) {
+                // fWidth tasks, each of which splits its share again 8 ways and waits on that.
+                sk_parallel_for(fWidth, 1, [&](int task) {
+                    sk_parallel_for(grain, SkTMax(1, grain / 8), [&](int j) {
+                        fResults[(task * grain + j) % kResults] = busywork(j);
+                    });
+                });
+            } else {
+                sk_parallel_for(kN, grain, [&](int j) {
+                    fResults[j % kResults] = busywork(j);
+                });
+            }
+        }
+    }
+
+private:
+    static const int kResults = 64;
+
+    const int fWidth;
+    const bool fNested;
+    SkString fName;
+    float fResults[kResults];
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new TaskGroupBench( 1, false); )
+DEF_BENCH( return new TaskGroupBench( 2, false); )
+DEF_BENCH( return new TaskGroupBench( 4, false); )
+DEF_BENCH( return new TaskGroupBench( 8, false); )
+DEF_BENCH( return new TaskGroupBench(16, false); )
+DEF_BENCH( return new TaskGroupBench(32, false); )
+DEF_BENCH( return new TaskGroupBench(64, false); )
+
+DEF_BENCH( return new TaskGroupBench( 1, true); )
+DEF_BENCH( return new TaskGroupBench( 4, true); )
+DEF_BENCH( return new TaskGroupBench(16, true); )
+DEF_BENCH( return new TaskGroupBench(64, true); )
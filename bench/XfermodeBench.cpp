@@ -8,18 +8,25 @@
 
 #include "Benchmark.h"
 #include "SkCanvas.h"
+#include "SkColorMatrixFilter.h"
 #include "SkPaint.h"
 #include "SkRandom.h"
 #include "SkString.h"
 #include "SkXfermode.h"
 
-// Benchmark that draws non-AA rects with an SkXfermode::Mode
+// Benchmark that draws non-AA rects with an SkXfermode::Mode, and optionally a color filter
 class XfermodeBench : public Benchmark {
 public:
-    XfermodeBench(SkXfermode::Mode mode) {
+    XfermodeBench(SkXfermode::Mode mode, bool colorFilter = false) {
         fXfermode.reset(SkXfermode::Create(mode));
         SkASSERT(fXfermode.get() || SkXfermode::kSrcOver_Mode == mode);
-        fName.printf("Xfermode_%s", SkXfermode::ModeName(mode));
+        fName.printf("Xfermode_%s%s", SkXfermode::ModeName(mode),
+                     colorFilter ? "_colorfilter" : "");
+        if (colorFilter) {
+            SkColorMatrix matrix;
+            matrix.setSaturation(0.5f);
+            fColorFilter.reset(SkColorMatrixFilter::Create(matrix));
+        }
     }
 
     XfermodeBench(SkXfermode* xferMode, const char* name) {
@@ -37,6 +44,7 @@ protected:
         for (int i = 0; i < loops; ++i) {
             SkPaint paint;
             paint.setXfermode(fXfermode.get());
+            paint.setColorFilter(fColorFilter.get());
             paint.setColor(random.nextU());
             SkScalar w = random.nextRangeScalar(SkIntToScalar(kMinSize), SkIntToScalar(kMaxSize));
             SkScalar h = random.nextRangeScalar(SkIntToScalar(kMinSize), SkIntToScalar(kMaxSize));
@@ -58,6 +66,7 @@ private:
         kMaxSize = 100,
     };
     SkAutoTUnref<SkXfermode> fXfermode;
+    SkAutoTUnref<SkColorFilter> fColorFilter;
     SkString fName;
 
     typedef Benchmark INHERITED;
@@ -126,4 +135,9 @@ BENCH(SkXfermode::kSaturation_Mode)
 BENCH(SkXfermode::kColor_Mode)
 BENCH(SkXfermode::kLuminosity_Mode)
 
+BENCH(SkXfermode::kSrcIn_Mode, true)
+BENCH(SkXfermode::kDstOut_Mode, true)
+BENCH(SkXfermode::kDarken_Mode, true)
+BENCH(SkXfermode::kMultiply_Mode, true)
+
 DEF_BENCH(return new XferCreateBench;)
@@ -9,8 +9,10 @@
 
 #include "nanobench.h"
 
+#include "BBHBench.h"
 #include "Benchmark.h"
 #include "CodecBench.h"
+#include "CodecSubsetBench.h"
 #include "CrashHandler.h"
 #include "DecodingBench.h"
 #include "DecodingSubsetBench.h"
@@ -83,7 +85,9 @@ DEFINE_int32(maxLoops, 1000000, "Never run a bench more times than this.");
 DEFINE_string(clip, "0,0,1000,1000", "Clip for SKPs.");
 DEFINE_string(scales, "1.0", "Space-separated scales for SKPs.");
 DEFINE_bool(bbh, true, "Build a BBH for SKPs?");
+DEFINE_bool(mmapSKPs, true, "Load SKPs in place from memory-mapped files?");
 DEFINE_bool(mpd, true, "Use MultiPictureDraw for the SKPs?");
+DEFINE_bool(tiledRaster, false, "Also rasterize SKPs in parallel with SkTiledPictureDraw?");
 DEFINE_int32(flushEvery, 10, "Flush --outResultsFile every Nth run.");
 DEFINE_bool(resetGpuContext, true, "Reset the GrContext before running each test.");
 DEFINE_bool(gpuStats, false, "Print GPU stats after each gpu benchmark?");
@@ -483,13 +487,19 @@ class BenchmarkStream {
 public:
     BenchmarkStream() : fBenches(BenchRegistry::Head())
                       , fGMs(skiagm::GMRegistry::Head())
+                      , fSKPLoadMs(0)
+                      , fSKPLoadRssMB(0)
                       , fCurrentRecording(0)
+                      , fCurrentBBH(0)
+                      , fCurrentBBHType(0)
+                      , fCurrentBBHMode(0)
                       , fCurrentScale(0)
                       , fCurrentSKP(0)
-                      , fCurrentUseMPD(0)
+                      , fCurrentSKPMode(0)
                       , fCurrentCodec(0)
                       , fCurrentImage(0)
                       , fCurrentSubsetImage(0)
+                      , fCurrentCodecSubsetImage(0)
                       , fCurrentColorType(0)
                       , fDivisor(2) {
         for (int i = 0; i < FLAGS_skps.count(); i++) {
@@ -517,9 +527,12 @@ public:
             }
         }
 
-        fUseMPDs.push_back() = false;
+        fSKPModes.push_back() = SKPBench::kSerial_Mode;
         if (FLAGS_mpd) {
-            fUseMPDs.push_back() = true;
+            fSKPModes.push_back() = SKPBench::kMultiPictureDraw_Mode;
+        }
+        if (FLAGS_tiledRaster) {
+            fSKPModes.push_back() = SKPBench::kTiledRaster_Mode;
         }
 
         // Prepare the images for decoding
@@ -544,24 +557,45 @@ public:
         fColorTypes.push_back_n(SK_ARRAY_COUNT(colorTypes), colorTypes);
     }
 
-    static bool ReadPicture(const char* path, SkAutoTUnref<SkPicture>* pic) {
+    // If loadMs or loadRssMB are given, report how long loading took and how much it grew RSS.
+    static bool ReadPicture(const char* path, SkAutoTUnref<SkPicture>* pic,
+                            double* loadMs = NULL, int* loadRssMB = NULL) {
         // Not strictly necessary, as it will be checked again later,
         // but helps to avoid a lot of pointless work if we're going to skip it.
         if (SkCommandLineFlags::ShouldSkip(FLAGS_match, path)) {
             return false;
         }
 
-        SkAutoTDelete<SkStream> stream(SkStream::NewFromFile(path));
-        if (stream.get() == NULL) {
-            SkDebugf("Could not read %s.\n", path);
-            return false;
+        const int rssMB = sk_tools::getCurrResidentSetSizeMB();
+        WallTimer timer;
+        timer.start();
+        if (FLAGS_mmapSKPs) {
+            SkAutoTUnref<SkData> data(SkData::NewFromFileName(path));
+            if (data.get() == NULL) {
+                SkDebugf("Could not read %s.\n", path);
+                return false;
+            }
+            pic->reset(SkPicture::CreateFromData(data));
+        } else {
+            SkAutoTDelete<SkStream> stream(SkStream::NewFromFile(path));
+            if (stream.get() == NULL) {
+                SkDebugf("Could not read %s.\n", path);
+                return false;
+            }
+            pic->reset(SkPicture::CreateFromStream(stream.get()));
         }
+        timer.end();
 
-        pic->reset(SkPicture::CreateFromStream(stream.get()));
         if (pic->get() == NULL) {
             SkDebugf("Could not read %s as an SkPicture.\n", path);
             return false;
         }
+        if (loadMs) {
+            *loadMs = timer.fWall;
+        }
+        if (loadRssMB) {
+            *loadRssMB = sk_tools::getCurrResidentSetSizeMB() - rssMB;
+        }
         return true;
     }
 
@@ -588,7 +622,7 @@ public:
         while (fCurrentRecording < fSKPs.count()) {
             const SkString& path = fSKPs[fCurrentRecording++];
             SkAutoTUnref<SkPicture> pic;
-            if (!ReadPicture(path.c_str(), &pic)) {
+            if (!ReadPicture(path.c_str(), &pic, &fSKPLoadMs, &fSKPLoadRssMB)) {
                 continue;
             }
             SkString name = SkOSPath::Basename(path.c_str());
@@ -599,6 +633,33 @@ public:
             return SkNEW_ARGS(RecordingBench, (name.c_str(), pic.get(), FLAGS_bbh));
         }
 
+        // Then build and query each kind of BBH over each .skp's op bounds.
+        while (FLAGS_bbh && fCurrentBBH < fSKPs.count()) {
+            const SkString& path = fSKPs[fCurrentBBH];
+            SkAutoTUnref<SkPicture> pic;
+            if (!ReadPicture(path.c_str(), &pic)) {
+                fCurrentBBH++;
+                continue;
+            }
+            while (fCurrentBBHType < BBHBench::kTypeCount) {
+                const BBHBench::Type type = (BBHBench::Type)fCurrentBBHType;
+                if (fCurrentBBHMode < BBHBench::kModeCount) {
+                    const BBHBench::Mode mode = (BBHBench::Mode)fCurrentBBHMode++;
+                    SkString name = SkOSPath::Basename(path.c_str());
+                    BBHBench* bench = SkNEW_ARGS(BBHBench, (name.c_str(), pic.get(), type, mode));
+                    fSourceType = "skp";
+                    fBenchType  = "bbh";
+                    fSKPBytes = static_cast<double>(bench->bytesUsed());
+                    fSKPOps   = pic->approximateOpCount();
+                    return bench;
+                }
+                fCurrentBBHMode = 0;
+                fCurrentBBHType++;
+            }
+            fCurrentBBHType = 0;
+            fCurrentBBH++;
+        }
+
         // Then once each for each scale as SKPBenches (playback).
         while (fCurrentScale < fScales.count()) {
             while (fCurrentSKP < fSKPs.count()) {
@@ -609,16 +670,18 @@ public:
                     continue;
                 }
 
-                while (fCurrentUseMPD < fUseMPDs.count()) {
+                while (fCurrentSKPMode < fSKPModes.count()) {
+                    const SKPBench::Mode mode = fSKPModes[fCurrentSKPMode++];
                     if (FLAGS_bbh) {
                         // The SKP we read off disk doesn't have a BBH.  Re-record so it grows one.
                         SkRTreeFactory factory;
                         SkPictureRecorder recorder;
                         static const int kFlags = SkPictureRecorder::kComputeSaveLayerInfo_RecordFlag;
+                        const bool mpd = SKPBench::kMultiPictureDraw_Mode == mode;
                         pic->playback(recorder.beginRecording(pic->cullRect().width(),
                                                               pic->cullRect().height(),
                                                               &factory,
-                                                              fUseMPDs[fCurrentUseMPD] ? kFlags : 0));
+                                                              mpd ? kFlags : 0));
                         pic.reset(recorder.endRecording());
                     }
                     SkString name = SkOSPath::Basename(path.c_str());
@@ -626,9 +689,9 @@ public:
                     fBenchType = "playback";
                     return SkNEW_ARGS(SKPBench,
                             (name.c_str(), pic.get(), fClip,
-                             fScales[fCurrentScale], fUseMPDs[fCurrentUseMPD++]));
+                             fScales[fCurrentScale], mode));
                 }
-                fCurrentUseMPD = 0;
+                fCurrentSKPMode = 0;
                 fCurrentSKP++;
             }
             fCurrentSKP = 0;
@@ -758,6 +821,42 @@ public:
             fCurrentSubsetImage++;
         }
 
+        // Run the CodecSubsetBenches
+        while (fCurrentCodecSubsetImage < fImages.count()) {
+            const SkString& path = fImages[fCurrentCodecSubsetImage];
+            SkAutoTUnref<SkData> encoded(SkData::NewFromFileName(path.c_str()));
+            SkAutoTDelete<SkCodec> codec(SkCodec::NewFromData(encoded));
+            while (codec && fCurrentColorType < fColorTypes.count()) {
+                const SkColorType colorType = fColorTypes[fCurrentColorType];
+                fCurrentColorType++;
+
+                const SkISize size = codec->getInfo().dimensions();
+                if (fDivisor > size.width() || fDivisor > size.height()) {
+                    continue;
+                }
+                // Check that this codec decodes subsets to this color type.
+                SkImageInfo info = codec->getInfo().makeColorType(colorType)
+                                                   .makeWH(size.width() / fDivisor,
+                                                           size.height() / fDivisor);
+                SkAlphaType alphaType;
+                if (!SkColorTypeValidateAlphaType(colorType, info.alphaType(), &alphaType)) {
+                    continue;
+                }
+                info = info.makeAlphaType(alphaType);
+                SkAutoMalloc storage(info.getSafeSize(info.minRowBytes()));
+                const SkImageGenerator::Result result = codec->getSubsetPixels(
+                        size, SkIRect::MakeSize(info.dimensions()), info, storage.get(),
+                        info.minRowBytes());
+                if (SkImageGenerator::kSuccess == result ||
+                    SkImageGenerator::kIncompleteInput == result) {
+                    return new CodecSubsetBench(SkOSPath::Basename(path.c_str()), encoded,
+                                                colorType, fDivisor);
+                }
+            }
+            fCurrentColorType = 0;
+            fCurrentCodecSubsetImage++;
+        }
+
         return NULL;
     }
 
@@ -769,15 +868,22 @@ public:
                     SkStringPrintf("%d %d %d %d", fClip.fLeft, fClip.fTop,
                                                   fClip.fRight, fClip.fBottom).c_str());
             log->configOption("scale", SkStringPrintf("%.2g", fScales[fCurrentScale]).c_str());
-            if (fCurrentUseMPD > 0) {
-                SkASSERT(1 == fCurrentUseMPD || 2 == fCurrentUseMPD);
-                log->configOption("multi_picture_draw", fUseMPDs[fCurrentUseMPD-1] ? "true" : "false");
+            if (fCurrentSKPMode > 0) {
+                const SKPBench::Mode mode = fSKPModes[fCurrentSKPMode-1];
+                log->configOption("multi_picture_draw",
+                                  mode == SKPBench::kMultiPictureDraw_Mode ? "true" : "false");
+                log->configOption("tiled_raster",
+                                  mode == SKPBench::kTiledRaster_Mode ? "true" : "false");
             }
         }
-        if (0 == strcmp(fBenchType, "recording")) {
+        if (0 == strcmp(fBenchType, "recording") || 0 == strcmp(fBenchType, "bbh")) {
             log->metric("bytes", fSKPBytes);
             log->metric("ops",   fSKPOps);
         }
+        if (0 == strcmp(fBenchType, "recording")) {
+            log->metric("load_ms",     fSKPLoadMs);
+            log->metric("load_rss_mb", fSKPLoadRssMB);
+        }
     }
 
 private:
@@ -786,21 +892,27 @@ private:
     SkIRect            fClip;
     SkTArray<SkScalar> fScales;
     SkTArray<SkString> fSKPs;
-    SkTArray<bool>     fUseMPDs;
+    SkTArray<SKPBench::Mode> fSKPModes;
     SkTArray<SkString> fImages;
     SkTArray<SkColorType> fColorTypes;
 
     double fSKPBytes, fSKPOps;
+    double fSKPLoadMs;
+    int    fSKPLoadRssMB;
 
     const char* fSourceType;  // What we're benching: bench, GM, SKP, ...
     const char* fBenchType;   // How we bench it: micro, recording, playback, ...
     int fCurrentRecording;
+    int fCurrentBBH;
+    int fCurrentBBHType;
+    int fCurrentBBHMode;
     int fCurrentScale;
     int fCurrentSKP;
-    int fCurrentUseMPD;
+    int fCurrentSKPMode;
     int fCurrentCodec;
     int fCurrentImage;
     int fCurrentSubsetImage;
+    int fCurrentCodecSubsetImage;
     int fCurrentColorType;
     const int fDivisor;
 };
@@ -809,7 +921,7 @@ int nanobench_main();
 int nanobench_main() {
     SetupCrashHandler();
     SkAutoGraphics ag;
-    SkTaskGroup::Enabler enabled;
+    SkTaskGroup::Enabler enabled(FLAGS_threads);
 
 #if SK_SUPPORT_GPU
     GrContext::Options grContextOpts;
@@ -306,6 +306,7 @@ static Sink* create_sink(const char* tag) {
     if (FLAGS_cpu) {
         SINK("565",  RasterSink, kRGB_565_SkColorType);
         SINK("8888", RasterSink, kN32_SkColorType);
+        SINK("mt8888", TiledRasterSink, kN32_SkColorType, 256, 256);
         SINK("pdf",  PDFSink);
         SINK("skp",  SKPSink);
         SINK("svg",  SVGSink);
@@ -7,6 +7,7 @@
 
 #include "DMSrcSink.h"
 #include "SamplePipeControllers.h"
+#include "SkCanvasPriv.h"
 #include "SkCommonFlags.h"
 #include "SkCodec.h"
 #include "SkData.h"
@@ -19,9 +20,11 @@
 #include "SkPictureData.h"
 #include "SkPictureRecorder.h"
 #include "SkRandom.h"
+#include "SkScan.h"
 #include "SkScanlineDecoder.h"
 #include "SkSVGCanvas.h"
 #include "SkStream.h"
+#include "SkTiledPictureDraw.h"
 #include "SkXMLWriter.h"
 
 static bool lazy_decode_bitmap(const void* src, size_t size, SkBitmap* dst) {
@@ -432,6 +435,8 @@ Error SVGSink::draw(const Src& src, SkBitmap*, SkWStream* dst, SkString*) const
 
 RasterSink::RasterSink(SkColorType colorType) : fColorType(colorType) {}
 
+DEFINE_bool(analyticAA, false, "Use analytic coverage instead of supersampling for AA paths?");
+
 Error RasterSink::draw(const Src& src, SkBitmap* dst, SkWStream*, SkString*) const {
     const SkISize size = src.size();
     // If there's an appropriate alpha type for this color type, use it, otherwise use premul.
@@ -441,11 +446,42 @@ Error RasterSink::draw(const Src& src, SkBitmap* dst, SkWStream*, SkString*) con
     dst->allocPixels(SkImageInfo::Make(size.width(), size.height(), fColorType, alphaType));
     dst->eraseColor(SK_ColorTRANSPARENT);
     SkCanvas canvas(*dst);
+    if (FLAGS_analyticAA) {
+        SkCanvasPriv::SetScanFlags(&canvas, SkScan::kAnalyticAA_PathFlag);
+    }
     return src.draw(&canvas);
 }
 
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
 
+TiledRasterSink::TiledRasterSink(SkColorType colorType, int tileW, int tileH)
+    : fColorType(colorType)
+    , fTileW(tileW)
+    , fTileH(tileH) {}
+
+Error TiledRasterSink::draw(const Src& src, SkBitmap* dst, SkWStream*, SkString*) const {
+    const SkISize size = src.size();
+    SkRTreeFactory factory;
+    SkPictureRecorder recorder;
+    Error err = src.draw(recorder.beginRecording(SkIntToScalar(size.width()),
+                                                 SkIntToScalar(size.height()),
+                                                 &factory));
+    if (!err.isEmpty()) {
+        return err;
+    }
+    SkAutoTUnref<SkPicture> pic(recorder.endRecordingAsPicture());
+
+    SkAlphaType alphaType = kPremul_SkAlphaType;
+    (void)SkColorTypeValidateAlphaType(fColorType, alphaType, &alphaType);
+
+    dst->allocPixels(SkImageInfo::Make(size.width(), size.height(), fColorType, alphaType));
+    dst->eraseColor(SK_ColorTRANSPARENT);
+    SkTiledPictureDraw(pic, *dst, NULL, fTileW, fTileH);
+    return "";
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
 static SkISize auto_compute_translate(SkMatrix* matrix, int srcW, int srcH) {
     SkRect bounds = SkRect::MakeIWH(srcW, srcH);
     matrix->mapRect(&bounds);
@@ -186,6 +186,19 @@ private:
     SkColorType    fColorType;
 };
 
+// Records the Src into a picture with an R-tree, then rasterizes it with SkTiledPictureDraw.
+class TiledRasterSink : public Sink {
+public:
+    TiledRasterSink(SkColorType, int tileW, int tileH);
+
+    Error draw(const Src&, SkBitmap*, SkWStream*, SkString*) const override;
+    int enclave() const override { return kAnyThread_Enclave; }
+    const char* fileExtension() const override { return "png"; }
+private:
+    SkColorType    fColorType;
+    const int      fTileW, fTileH;
+};
+
 class SKPSink : public Sink {
 public:
     SKPSink();
@@ -14,7 +14,9 @@
       'type': 'executable',
       'sources': [
         '../gm/gm.cpp',
+        '../bench/BBHBench.cpp',
         '../bench/CodecBench.cpp',
+        '../bench/CodecSubsetBench.cpp',
         '../bench/DecodingBench.cpp',
         '../bench/DecodingSubsetBench.cpp',
         '../bench/GMBench.cpp',
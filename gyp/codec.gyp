@@ -18,6 +18,8 @@
       'dependencies': [
         'core.gyp:*',
         'giflib.gyp:giflib',
+        'libjpeg.gyp:*',
+        'libwebp.gyp:libwebp',
       ],
       'cflags':[
         # FIXME: This gets around a longjmp warning. See
@@ -28,14 +30,18 @@
         '../include/codec',
         '../src/codec',
         '../src/core',
+        '../src/opts',
       ],
       'sources': [
         '../src/codec/SkCodec.cpp',
         '../src/codec/SkCodec_libbmp.cpp',
         '../src/codec/SkCodec_libgif.cpp',
         '../src/codec/SkCodec_libico.cpp',
+        '../src/codec/SkCodec_libjpeg.cpp',
         '../src/codec/SkCodec_libpng.cpp',
+        '../src/codec/SkCodec_libwebp.cpp',
         '../src/codec/SkCodec_wbmp.cpp',
+        '../src/codec/SkFrameHolder.cpp',
         '../src/codec/SkGifInterlaceIter.cpp',
         '../src/codec/SkMaskSwizzler.cpp',
         '../src/codec/SkMasks.cpp',
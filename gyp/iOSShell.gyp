@@ -22,7 +22,9 @@
             'xml.gyp:xml',
           ],
           'sources': [
+            '../bench/BBHBench.cpp',
             '../bench/CodecBench.cpp',
+            '../bench/CodecSubsetBench.cpp',
             '../bench/DecodingBench.cpp',
             '../bench/DecodingSubsetBench.cpp',
             '../bench/GMBench.cpp',
@@ -27,6 +27,8 @@
         '../src/core/',
         # for access to SkImagePriv.h
         '../src/image/',
+        # for access to SkTransformScanline_opts.h
+        '../src/opts/',
       ],
       'sources': [
         '../include/images/SkDecodingImageGenerator.h',
@@ -34,6 +36,7 @@
         '../src/images/SkJpegUtility.h',
         '../include/images/SkMovie.h',
         '../include/images/SkPageFlipper.h',
+        '../include/images/SkPNGImageEncoder.h',
 
         '../src/images/bmpdecoderhelper.cpp',
         '../src/images/bmpdecoderhelper.h',
@@ -261,7 +261,9 @@
       ],
       'dependencies': [
         'flags.gyp:flags',
+        'proc_stats',
         'skia_lib.gyp:skia_lib',
+        'timer',
       ],
     },
     {
@@ -484,6 +486,7 @@
         'skia_lib.gyp:skia_lib',
         'tools.gyp:picture_utils',
         'tools.gyp:proc_stats',
+        'tools.gyp:timer',
       ],
       'conditions': [
         ['skia_win_debuggers_path and skia_os == "win"',
@@ -11,6 +11,7 @@
 #include "SkEncodedFormat.h"
 #include "SkImageGenerator.h"
 #include "SkImageInfo.h"
+#include "SkRect.h"
 #include "SkScanlineDecoder.h"
 #include "SkSize.h"
 #include "SkStream.h"
@@ -52,6 +53,110 @@ public:
         return this->onGetScaledDimensions(desiredScale);
     }
 
+    /**
+     *  Decode only the part of the image inside subset into dst.
+     *
+     *  @param scaledSize The size to scale the whole image to first: either
+     *      the image's own size or one returned by getScaledDimensions().
+     *  @param subset The part of the scaled image to decode. Must lie inside
+     *      scaledSize, and match the dimensions of dstInfo.
+     *  @return kUnimplemented if this codec cannot decode subsets, otherwise
+     *      as getPixels(). kIndex_8_SkColorType is not supported.
+     */
+    Result getSubsetPixels(const SkISize& scaledSize, const SkIRect& subset,
+                           const SkImageInfo& dstInfo, void* dst, size_t rowBytes);
+
+    /**
+     *  How the area drawn by a frame of an animation is treated once the
+     *  frame has been shown, before the next frame is drawn.
+     */
+    enum DisposalMethod {
+        // Leave the frame on the canvas, for the next frame to draw over.
+        kKeep_DisposalMethod,
+        // Clear the frame's rect to transparent.
+        kRestoreBGColor_DisposalMethod,
+        // Put the canvas back the way it was before the frame was drawn.
+        kRestorePrevious_DisposalMethod,
+    };
+
+    /**
+     *  Value of FrameInfo::fRequiredFrame for a frame drawn onto a cleared canvas.
+     */
+    static const int kNone_RequiredFrame = -1;
+
+    /**
+     *  Information about one frame of an image, as returned by getFrameInfo().
+     */
+    struct FrameInfo {
+        // The part of the canvas the frame draws into.
+        SkIRect         fRect;
+        // How long to show the frame, in milliseconds.
+        int             fDuration;
+        DisposalMethod  fDisposalMethod;
+        // The frame whose result, after its disposal, this frame is drawn
+        // over, or kNone_RequiredFrame. Always less than this frame's index.
+        int             fRequiredFrame;
+    };
+
+    /**
+     *  Number of frames in the image. Still images have one.
+     *
+     *  This may read through the whole stream the first time it is called,
+     *  in order to find where each frame starts.
+     */
+    int getFrameCount() { return this->onGetFrameCount(); }
+
+    /**
+     *  Fill out info for the frame at index, returning false if there is no
+     *  such frame.
+     */
+    bool getFrameInfo(int index, FrameInfo* info);
+
+    /**
+     *  Decode frame index composited onto the canvas, i.e. the whole image as
+     *  it should be shown while that frame is current. dstInfo must be N32
+     *  with the dimensions of getInfo().
+     *
+     *  Frames may be requested in any order. Codecs for animated formats keep
+     *  some composited frames around, so that seeking only has to draw the
+     *  frames since the nearest one of those, and may decode the frames after
+     *  index in the background, expecting them to be asked for next.
+     */
+    Result getFrame(int index, const SkImageInfo& dstInfo, void* dst, size_t rowBytes);
+
+    /**
+     *  Begin decoding into dst while the encoded data is still arriving, e.g.
+     *  over the network. The codec decodes whatever its stream holds now, and
+     *  each call to incrementalDecode() hands it the next piece of the data,
+     *  so that the rows can be drawn as they come in. dst must stay valid
+     *  until the decode finishes or another incremental decode is started.
+     *
+     *  If NewFromData() returns NULL for the data so far, the header may not
+     *  have arrived yet: try again once there is more.
+     *
+     *  @param dstInfo Must have the dimensions of getInfo().
+     *  @param rowsDecoded If not NULL, set to the number of rows at the top of
+     *      dst which are finished. The rows below them are undefined. For an
+     *      interlaced PNG, those a pass has reached so far hold only that
+     *      pass's pixels, on a transparent black background; they are not
+     *      filled in, so they do not make a progressive preview.
+     *  @return kSuccess once the whole image is decoded, kIncompleteInput if
+     *      more data is needed, kUnimplemented if this codec cannot decode
+     *      incrementally, or another error as getPixels().
+     */
+    Result startIncrementalDecode(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
+                                  int* rowsDecoded = NULL);
+
+    /**
+     *  Continue the decode begun by startIncrementalDecode() with moreData,
+     *  the bytes following those given so far. moreData may be NULL, to ask
+     *  for the progress without adding any.
+     *
+     *  @return As startIncrementalDecode(), or kInvalidParameters if no
+     *      incremental decode has been started.
+     */
+    Result incrementalDecode(SkData* moreData, int* rowsDecoded = NULL);
+
     /**
      *  Format of the encoded data.
      */
@@ -118,6 +223,43 @@ protected:
 
     virtual SkEncodedFormat onGetEncodedFormat() const = 0;
 
+    /**
+     *  Override if your codec supports subset decoding. The parameters have
+     *  been checked by getSubsetPixels(). As in onGetPixels(), the
+     *  implementation must call rewindIfNeeded() and handle as appropriate.
+     */
+    virtual Result onGetSubsetPixels(const SkISize& scaledSize, const SkIRect& subset,
+                                     const SkImageInfo& dstInfo, void* dst, size_t rowBytes) {
+        return kUnimplemented;
+    }
+
+    /**
+     *  Override these if your codec supports animation. The default
+     *  implementations describe a single frame covering the whole image and
+     *  decode it with getPixels(). The index and dstInfo passed to
+     *  onGetFrame() have been checked by getFrame().
+     */
+    virtual int onGetFrameCount() { return 1; }
+    virtual bool onGetFrameInfo(int index, FrameInfo*);
+    virtual Result onGetFrame(int index, const SkImageInfo& dstInfo, void* dst,
+                              size_t rowBytes);
+
+    /**
+     *  Override these if your codec supports incremental decoding. The
+     *  parameters passed to onStartIncrementalDecode() have been checked by
+     *  startIncrementalDecode(). onIncrementalDecode() is then handed the
+     *  encoded data a piece at a time, in order, starting from the beginning
+     *  of the stream. Neither may read the stream itself, and neither may
+     *  disturb a decode made by any of the other methods in the meantime.
+     */
+    virtual Result onStartIncrementalDecode(const SkImageInfo& dstInfo, void* dst,
+                                            size_t rowBytes) {
+        return kUnimplemented;
+    }
+    virtual Result onIncrementalDecode(const void* data, size_t length, int* rowsDecoded) {
+        return kUnimplemented;
+    }
+
     /**
      *  Override if your codec supports scanline decoding.
      *
@@ -171,6 +313,7 @@ private:
 #endif  //  SK_SUPPORT_LEGACY_BOOL_ONGETINFO
     SkAutoTDelete<SkStream>             fStream;
     bool                                fNeedsRewind;
+    bool                                fIncrementalDecodeStarted;
     SkAutoTDelete<SkScanlineDecoder>    fScanlineDecoder;
 
     typedef SkImageGenerator INHERITED;
@@ -28,4 +28,26 @@ private:
     typedef SkBBHFactory INHERITED;
 };
 
+/**
+ *  Like SkRTreeFactory, but packs ops into nodes by their position along a Hilbert curve.
+ *  Slower to build, but usually tighter and faster to query when ops aren't in raster order.
+ */
+class SK_API SkHilbertRTreeFactory : public SkBBHFactory {
+public:
+    SkBBoxHierarchy* operator()(const SkRect& bounds) const override;
+private:
+    typedef SkBBHFactory INHERITED;
+};
+
+/**
+ *  Creates an R-Tree that may be added to and searched repeatedly, for recorders that keep
+ *  appending ops after the hierarchy is first filled.
+ */
+class SK_API SkIncrementalRTreeFactory : public SkBBHFactory {
+public:
+    SkBBoxHierarchy* operator()(const SkRect& bounds) const override;
+private:
+    typedef SkBBHFactory INHERITED;
+};
+
 #endif
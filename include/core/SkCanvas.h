@@ -1293,6 +1293,7 @@ private:
     friend class SkRecorder;        // InitFlags
     friend class SkNoSaveLayerCanvas;   // InitFlags
     friend class SkPictureImageFilter;  // SkCanvas(SkBaseDevice*, SkSurfaceProps*, InitFlags)
+    friend class SkCanvasPriv;      // needs fScanFlags, fTileBounds
 
     enum InitFlags {
         kDefault_InitFlags                  = 0,
@@ -1331,6 +1332,9 @@ private:
     void internalDrawPaint(const SkPaint& paint);
     void internalSaveLayer(const SkRect* bounds, const SkPaint*, SaveFlags, SaveLayerStrategy);
     void internalDrawDevice(SkBaseDevice*, int x, int y, const SkPaint*);
+    // Filters 'src' with the paint's image filter and draws the result into 'device' at 'pos'.
+    void internalDrawFilteredSprite(const SkDraw&, SkBaseDevice*, const SkBitmap& src,
+                                    const SkIPoint& pos, const SkPaint&);
 
     // shared by save() and saveLayer()
     void internalSave();
@@ -1352,6 +1356,9 @@ private:
     bool fAllowSoftClip;
     bool fAllowSimplifyClip;
     bool fConservativeRasterClip;
+    uint32_t fScanFlags;    // SkScan::PathFlags for raster path fills
+    bool     fTiled;        // only draw inside fTileBounds (see SkCanvasPriv::SetTileBounds)
+    SkIRect  fTileBounds;
 
     const SkRect& getLocalClipBounds() const {
         if (fCachedLocalClipBoundsDirty) {
@@ -20,6 +20,10 @@ class SkWStream;
 */
 #define SK_ScalarDefaultRasterDPI           72.0f
 
+/** SK_PDFDefaultDeflateLevel lets zlib pick its usual speed/size tradeoff.
+*/
+#define SK_PDFDefaultDeflateLevel           (-1)
+
 /**
  *  High-level API for creating a document-based canvas. To use..
  *
@@ -39,6 +43,10 @@ public:
      *
      *  PDF pages are sized in point units. 1 pt == 1/72 inch == 127/360 mm.
      *
+     *  Each page is recorded as it is drawn, then converted to PDF in the
+     *  background using SkTaskGroup, so pages convert in parallel when an
+     *  SkTaskGroup::Enabler is active.  The output is identical either way.
+     *
      *  @param SkWStream* A PDF document will be written to this
      *         stream.  The document may write to the stream at
      *         anytime during its lifetime, until either close() is
@@ -51,11 +59,17 @@ public:
      *         for larger PDF files too, which would use more memory
      *         while rendering, and it would be slower to be processed
      *         or sent online or to printer.
+     *  @param deflateLevel The zlib level, from 0 (no compression) through
+     *         1 (fastest) to 9 (smallest), used to compress streams and
+     *         images.  Compression is spread over SkTaskGroup threads.
+     *         Any level other than these or SK_PDFDefaultDeflateLevel
+     *         is an error.
      *  @returns NULL if there is an error, otherwise a newly created
      *           PDF-backed SkDocument.
      */
     static SkDocument* CreatePDF(SkWStream*,
-                                 SkScalar dpi = SK_ScalarDefaultRasterDPI);
+                                 SkScalar dpi = SK_ScalarDefaultRasterDPI,
+                                 int deflateLevel = SK_PDFDefaultDeflateLevel);
 
     /**
      *  Create a PDF-backed document, writing the results into a file.
@@ -63,6 +77,18 @@ public:
     static SkDocument* CreatePDF(const char outputFilePath[],
                                  SkScalar dpi = SK_ScalarDefaultRasterDPI);
 
+    /**
+     *  Create a PDF-backed document like CreatePDF(), except that each page
+     *  is written to the stream, and freed, as soon as it is finished.
+     *  Resources shared between pages are kept until close(), as are
+     *  fonts, which are only written once the whole document's glyph usage
+     *  is known.  Peak memory use then depends on the largest page rather
+     *  than the size of the document.
+     */
+    static SkDocument* CreateStreamingPDF(SkWStream*,
+                                          SkScalar dpi = SK_ScalarDefaultRasterDPI,
+                                          int deflateLevel = SK_PDFDefaultDeflateLevel);
+
     /**
      *  Create a XPS-backed document, writing the results into the stream.
      *  Returns NULL if XPS is not supported.
@@ -148,6 +148,9 @@ public:
     const SkClipStack* fClipStack;  // optional
     SkBaseDevice*   fDevice;        // optional
     SkDrawProcs*    fProcs;         // optional
+    uint32_t        fScanFlags;     // optional, SkScan::PathFlags for path fills
+    // optional, the clip of the whole draw when fRC is one tile of it (see SkCanvasPriv)
+    const SkRasterClip* fEdgeRC;
 
 #ifdef SK_DEBUG
     void validate() const;
@@ -17,6 +17,7 @@
 class SkBitmap;
 class SkColorFilter;
 class SkBaseDevice;
+class SkResourceCache;
 class SkSurfaceProps;
 struct SkIPoint;
 class GrFragmentProcessor;
@@ -58,9 +59,34 @@ public:
         struct Key;
         virtual ~Cache() {}
         static Cache* Create(size_t maxBytes);
+        /**
+         *  Like Create(), but raster results are also kept in resourceCache, within its byte
+         *  budget, keyed on a hash of the src pixels instead of their generation ID. A src
+         *  redrawn with the same content (e.g. a layer, every frame of an animation) can then
+         *  reuse earlier results. Each entry keeps a private copy of its src, and a hit is only
+         *  returned once those pixels are found to match. resourceCache is only used behind
+         *  this cache's lock, and must outlive it; if NULL, the global SkResourceCache is used.
+         */
+        static Cache* CreateKeyedOnContent(size_t maxBytes, SkResourceCache* resourceCache);
         static Cache* Get();
+        /**
+         *  Sets whether the cache returned by Get() also keys results on content, in the global
+         *  SkResourceCache, as CreateKeyedOnContent() does. The src is hashed once per
+         *  generation ID, so this is off by default. Returns the previous setting.
+         */
+        static bool SetKeyOnContent(bool);
         virtual bool get(const Key& key, SkBitmap* result, SkIPoint* offset) const = 0;
         virtual void set(const Key& key, const SkBitmap& result, const SkIPoint& offset) = 0;
+        /**
+         *  The content keyed get() and set() of CreateKeyedOnContent(); key's src generation ID
+         *  is ignored in favor of src's pixels. Caches that don't key on content never hit.
+         */
+        virtual bool getByContent(const Key& key, const SkBitmap& src,
+                                  SkBitmap* result, SkIPoint* offset) const {
+            return false;
+        }
+        virtual void setByContent(const Key& key, const SkBitmap& src,
+                                  const SkBitmap& result, const SkIPoint& offset) {}
     };
 
     class Context {
@@ -90,6 +116,10 @@ public:
                                  const Context&,
                                  SkBitmap* result, SkIPoint* offset) = 0;
         virtual const SkSurfaceProps* surfaceProps() const = 0;
+        // returns true if createDevice() and filterImage() may be called from
+        // several threads at once, letting independent parts of a filter DAG
+        // be evaluated in parallel.
+        virtual bool isThreadSafe() const { return false; }
     };
 
     /**
@@ -114,6 +144,14 @@ public:
      */
     bool filterBounds(const SkIRect& src, const SkMatrix& ctm, SkIRect* dst) const;
 
+    /**
+     *  Returns true if this filter and every filter in its DAG can be asked
+     *  for just part of their result (see onCanFilterPartially()). Only then
+     *  may a caller pass a clip smaller than the layer, or filter a layer in
+     *  bands.
+     */
+    bool canFilterPartially() const;
+
     /**
      *  Returns true if the filter can be processed on the GPU.  This is most
      *  often used for multi-pass effects, where intermediate results must be
@@ -295,6 +333,41 @@ protected:
     // no inputs.
     virtual bool onFilterBounds(const SkIRect&, const SkMatrix&, SkIRect*) const;
 
+    // Like onFilterBounds(), but for this node alone: given the rect of this
+    // filter's result that is needed, compute (conservatively) which rect of
+    // its inputs' results it reads. Does not recurse into the inputs. The
+    // default implementation returns the rect unchanged, which is right for
+    // filters whose result pixels only depend on the input pixels beneath them.
+    virtual void onFilterNodeBounds(const SkIRect&, const SkMatrix&, SkIRect*) const;
+
+    // Filters override this to return true once onFilterNodeBounds() covers
+    // every input pixel they read, and they compute their result correctly
+    // within any clip they are given. The default is false: such filters,
+    // and any DAG containing them, are always asked for the whole layer.
+    virtual bool onCanFilterPartially() const { return false; }
+
+    /**
+     *  Returns the context this filter's inputs should be evaluated with: the
+     *  same matrix and cache, with the clip bounds mapped through
+     *  onFilterNodeBounds(). Evaluating inputs this way pulls only the region
+     *  of the DAG that the requested clip depends on. Unless
+     *  canFilterPartially(), this is ctx itself.
+     */
+    Context mapContext(const Context& ctx) const;
+
+    /**
+     *  Evaluates the first 'count' inputs with mapContext(ctx), storing each
+     *  result and offset in results[i] and offsets[i]. A NULL input passes src
+     *  through at (0, 0). Independent inputs are evaluated in parallel when the
+     *  proxy is thread safe.
+     *
+     *  Returns false if an input failed. An input whose crop rect lies wholly
+     *  outside the clip it was asked for has nothing to contribute there; it
+     *  is left empty (isNull()) rather than counted as a failure.
+     */
+    bool filterInputs(int count, Proxy*, const SkBitmap& src, const Context& ctx,
+                      SkBitmap results[], SkIPoint offsets[]) const;
+
     /**
      *  Return true (and return a ref'd colorfilter) if this node in the DAG is just a
      *  colorfilter w/o CropRect constraints.
@@ -343,6 +416,8 @@ protected:
 
 private:
     bool usesSrcInput() const { return fUsesSrcInput; }
+    // Returns true if this filter's crop rect keeps its whole result outside the context's clip.
+    bool isCroppedOut(const Context&) const;
 
     typedef SkFlattenable INHERITED;
     int fInputCount;
@@ -89,6 +89,20 @@ public:
     static SkPicture* CreateFromStream(SkStream*,
                                        InstallPixelRefProc proc = &SkImageDecoder::DecodeMemory);
 
+    /**
+     *  Recreate a picture that was serialized into data, as CreateFromStream() would.  Rather than
+     *  copying them, the picture may keep references into data for its op stream, text, vertex
+     *  arrays and raw pixels, so this is cheapest with a memory-mapped file from
+     *  SkData::NewFromFileName().  Only SKPs written by version 41 or later are laid out so they
+     *  can be referenced in place; older ones are copied as usual.
+     *  @param SkData Serialized picture data. Ref'd by the picture if it keeps references into it.
+     *  @param proc Function pointer for installing pixelrefs on SkBitmaps representing the
+     *              encoded bitmap data.
+     *  @return A new SkPicture representing the serialized data, or NULL if the data is invalid.
+     */
+    static SkPicture* CreateFromData(SkData*,
+                                     InstallPixelRefProc proc = &SkImageDecoder::DecodeMemory);
+
     /**
      *  Recreate a picture that was serialized into a buffer. If the creation requires bitmap
      *  decoding, the decoder must be set on the SkReadBuffer parameter by calling
@@ -244,13 +258,14 @@ private:
     // V38: Added PictureResolution option to SkPictureImageFilter
     // V39: Added FilterLevel option to SkPictureImageFilter
     // V40: Remove UniqueID serialization from SkImageFilter.
+    // V41: Pad stream sections to 4-byte multiples so SKPs can be read in place from memory.
 
     // Note: If the picture version needs to be increased then please follow the
     // steps to generate new SKPs in (only accessible to Googlers): http://goo.gl/qATVcw
 
     // Only SKPs within the min/current picture version range (inclusive) can be read.
     static const uint32_t MIN_PICTURE_VERSION = 35;     // Produced by Chrome M39.
-    static const uint32_t CURRENT_PICTURE_VERSION = 40;
+    static const uint32_t CURRENT_PICTURE_VERSION = 41;
 
     void createHeader(SkPictInfo* info) const;
     static bool IsValidPictInfo(const SkPictInfo& info);
@@ -258,7 +273,9 @@ private:
     // Takes ownership of the SkRecord and (optional) SnapshotArray, refs the (optional) BBH.
     SkPicture(const SkRect& cullRect, SkRecord*, SnapshotArray*, SkBBoxHierarchy*);
 
-    static SkPicture* Forwardport(const SkPictInfo&, const SkPictureData*);
+    // If the stream reads from backing's memory, the picture may keep references into backing.
+    static SkPicture* CreateFromStream(SkStream*, InstallPixelRefProc, SkData* backing);
+    static SkPicture* Forwardport(const SkPictInfo&, const SkPictureData*, SkData* backing = NULL);
     static SkPictureData* Backport(const SkRecord&, const SkPictInfo&,
                                    SkPicture const* const drawablePics[], int drawableCount);
 
@@ -292,6 +309,7 @@ private:
         int         fNumAADFEligibleConcavePaths;
     } fAnalysis;
 
+    friend class SkPictureData;                // CreateFromStream() for nested pictures.
     friend class SkPictureRecorder;            // SkRecord-based constructor.
     friend class GrLayerHoister;               // access to fRecord
     friend class ReplaceDraw;
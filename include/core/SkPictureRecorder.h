@@ -94,6 +94,7 @@ private:
     friend class android::Picture;
 #endif
     friend class SkPictureRecorderReplayTester; // for unit testing
+    friend class SkPicture;                     // Forwardport() records by reference into SkData
     void partialReplay(SkCanvas* canvas) const;
 
     bool                          fActivelyRecording;
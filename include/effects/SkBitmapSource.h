@@ -35,6 +35,7 @@ protected:
 
     virtual bool onFilterImage(Proxy*, const SkBitmap& src, const Context&,
                                SkBitmap* result, SkIPoint* offset) const override;
+    bool onCanFilterPartially() const override { return true; }
 
 private:
     SkBitmap fBitmap;
@@ -36,6 +36,8 @@ protected:
                                SkBitmap* result, SkIPoint* offset) const override;
     virtual bool onFilterBounds(const SkIRect& src, const SkMatrix&,
                                 SkIRect* dst) const override;
+    void onFilterNodeBounds(const SkIRect& src, const SkMatrix&, SkIRect* dst) const override;
+    bool onCanFilterPartially() const override { return true; }
 
     bool canFilterImageGPU() const override { return true; }
     virtual bool filterImageGPU(Proxy* proxy, const SkBitmap& src, const Context& ctx,
@@ -27,6 +27,7 @@ protected:
 
     virtual bool onFilterImage(Proxy*, const SkBitmap& src, const Context&,
                                SkBitmap* result, SkIPoint* loc) const override;
+    bool onCanFilterPartially() const override { return true; }
 
     bool onIsColorFilterNode(SkColorFilter**) const override;
 
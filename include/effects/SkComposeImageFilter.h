@@ -36,6 +36,7 @@ protected:
     }
     virtual bool onFilterImage(Proxy*, const SkBitmap& src, const Context&,
                                SkBitmap* result, SkIPoint* loc) const override;
+    bool onCanFilterPartially() const override { return true; }
     bool onFilterBounds(const SkIRect&, const SkMatrix&, SkIRect*) const override;
 
 private:
@@ -40,6 +40,8 @@ public:
 
     virtual bool onFilterBounds(const SkIRect& src, const SkMatrix&,
                                 SkIRect* dst) const override;
+    void onFilterNodeBounds(const SkIRect& src, const SkMatrix&, SkIRect* dst) const override;
+    bool onCanFilterPartially() const override { return true; }
 
 #if SK_SUPPORT_GPU
     bool canFilterImageGPU() const override { return true; }
@@ -40,6 +40,8 @@ protected:
     bool onFilterImage(Proxy*, const SkBitmap& source, const Context&, SkBitmap* result, SkIPoint* loc) const override;
     virtual bool onFilterBounds(const SkIRect& src, const SkMatrix&,
                                 SkIRect* dst) const override;
+    void onFilterNodeBounds(const SkIRect& src, const SkMatrix&, SkIRect* dst) const override;
+    bool onCanFilterPartially() const override { return true; }
 
 private:
     SkScalar fDx, fDy, fSigmaX, fSigmaY;
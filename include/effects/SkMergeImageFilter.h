@@ -40,6 +40,7 @@ protected:
 
     virtual bool onFilterImage(Proxy*, const SkBitmap& src, const Context&,
                                SkBitmap* result, SkIPoint* loc) const override;
+    bool onCanFilterPartially() const override { return true; }
 
 private:
     uint8_t*            fModes; // SkXfermode::Mode
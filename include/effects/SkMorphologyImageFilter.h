@@ -17,6 +17,8 @@ class SK_API SkMorphologyImageFilter : public SkImageFilter {
 public:
     void computeFastBounds(const SkRect& src, SkRect* dst) const override;
     bool onFilterBounds(const SkIRect& src, const SkMatrix& ctm, SkIRect* dst) const override;
+    void onFilterNodeBounds(const SkIRect& src, const SkMatrix& ctm, SkIRect* dst) const override;
+    bool onCanFilterPartially() const override { return true; }
 
     /**
      * All morphology procs have the same signature: src is the source buffer, dst the
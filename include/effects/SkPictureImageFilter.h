@@ -72,6 +72,7 @@ protected:
     void flatten(SkWriteBuffer&) const override;
     virtual bool onFilterImage(Proxy*, const SkBitmap& src, const Context&,
                                SkBitmap* result, SkIPoint* offset) const override;
+    bool onCanFilterPartially() const override { return true; }
 
 private:
 
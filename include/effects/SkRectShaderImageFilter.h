@@ -39,6 +39,7 @@ protected:
 
     virtual bool onFilterImage(Proxy*, const SkBitmap& src, const Context&,
                                SkBitmap* result, SkIPoint* loc) const override;
+    bool onCanFilterPartially() const override { return true; }
 
 private:
     SkRectShaderImageFilter(SkShader* s, const CropRect* rect);
@@ -26,6 +26,8 @@ public:
                                SkBitmap* dst, SkIPoint* offset) const override;
     virtual bool onFilterBounds(const SkIRect& src, const SkMatrix&,
                                 SkIRect* dst) const override;
+    void onFilterNodeBounds(const SkIRect& src, const SkMatrix&, SkIRect* dst) const override;
+    bool onCanFilterPartially() const override { return true; }
 
     SK_TO_STRING_OVERRIDE()
     SK_DECLARE_PUBLIC_FLATTENABLE_DESERIALIZATION_PROCS(SkTileImageFilter)
@@ -38,6 +38,7 @@ public:
                                const Context& ctx,
                                SkBitmap* dst,
                                SkIPoint* offset) const override;
+    bool onCanFilterPartially() const override { return true; }
 #if SK_SUPPORT_GPU
     bool canFilterImageGPU() const override;
     virtual bool filterImageGPU(Proxy* proxy, const SkBitmap& src, const Context& ctx,
@@ -0,0 +1,80 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPNGImageEncoder_DEFINED
+#define SkPNGImageEncoder_DEFINED
+
+#include "SkImageEncoder.h"
+
+/**
+ *  The libpng encoder, which SkImageEncoder::Create(kPNG_Type) returns on platforms built with
+ *  libpng (not Mac, iOS or Windows). Constructing one directly allows setting Options.
+ */
+class SkPNGImageEncoder : public SkImageEncoder {
+public:
+    /**
+     *  PNG is lossless, so encodeStream()'s 'quality' is ignored; these trade encode time
+     *  against file size instead.
+     */
+    struct Options {
+        /** How zlib searches for matches. See deflateInit2() in zlib.h. */
+        enum Strategy {
+            kDefault_Strategy,
+            kFiltered_Strategy,
+            kHuffmanOnly_Strategy,
+            kRLE_Strategy,
+        };
+
+        /**
+         *  The PNG row filters the encoder may choose between. When more than one is allowed,
+         *  each row uses the one whose output has the smallest sum of absolute (signed byte)
+         *  values. The values match libpng's PNG_FILTER_* flags.
+         */
+        enum FilterFlags {
+            kNone_FilterFlag  = 0x08,
+            kSub_FilterFlag   = 0x10,
+            kUp_FilterFlag    = 0x20,
+            kAvg_FilterFlag   = 0x40,
+            kPaeth_FilterFlag = 0x80,
+            kAll_FilterFlags  = 0xF8,
+        };
+
+        Options()
+            : fZLibLevel(6)
+            , fStrategy(kFiltered_Strategy)
+            , fFilterFlags(kAll_FilterFlags)
+            , fThreadCount(1) {}
+
+        /** zlib compression level, 0 (store) to 9 (smallest). */
+        int         fZLibLevel;
+        Strategy    fStrategy;
+        /** A combination of FilterFlags. Palette images are always written unfiltered. */
+        unsigned    fFilterFlags;
+        /**
+         *  The image data is split into up to this many bands of rows, deflated independently
+         *  (on SkTaskGroup threads, when enabled) and joined into one zlib stream. Values above
+         *  1 make encoding faster on multicore machines, at a small cost in file size.
+         */
+        int         fThreadCount;
+    };
+
+    SkPNGImageEncoder() {}
+    explicit SkPNGImageEncoder(const Options& options) : fOptions(options) {}
+
+    void setOptions(const Options& options) { fOptions = options; }
+    const Options& getOptions() const { return fOptions; }
+
+protected:
+    bool onEncode(SkWStream* stream, const SkBitmap& bm, int quality) override;
+
+private:
+    Options fOptions;
+
+    typedef SkImageEncoder INHERITED;
+};
+
+#endif
@@ -10,10 +10,13 @@
 #include "SkCodec_libbmp.h"
 #include "SkCodec_libgif.h"
 #include "SkCodec_libico.h"
+#include "SkCodec_libjpeg.h"
 #include "SkCodec_libpng.h"
+#include "SkCodec_libwebp.h"
 #include "SkCodec_wbmp.h"
 #include "SkCodecPriv.h"
 #include "SkStream.h"
+#include "SkStreamPriv.h"
 
 struct DecoderProc {
     bool (*IsFormat)(SkStream*);
@@ -22,7 +25,9 @@ struct DecoderProc {
 
 static const DecoderProc gDecoderProcs[] = {
     { SkPngCodec::IsPng, SkPngCodec::NewFromStream },
+    { SkJpegCodec::IsJpeg, SkJpegCodec::NewFromStream },
     { SkGifCodec::IsGif, SkGifCodec::NewFromStream },
+    { SkWebpCodec::IsWebp, SkWebpCodec::NewFromStream },
     { SkIcoCodec::IsIco, SkIcoCodec::NewFromStream },
     { SkBmpCodec::IsBmp, SkBmpCodec::NewFromStream },
     { SkWbmpCodec::IsWbmp, SkWbmpCodec::NewFromStream }
@@ -74,6 +79,7 @@ SkCodec::SkCodec(const SkImageInfo& info, SkStream* stream)
 #endif
     , fStream(stream)
     , fNeedsRewind(false)
+    , fIncrementalDecodeStarted(false)
 {}
 
 SkCodec::RewindState SkCodec::rewindIfNeeded() {
@@ -88,6 +94,112 @@ SkCodec::RewindState SkCodec::rewindIfNeeded() {
                              : kCouldNotRewind_RewindState;
 }
 
+SkCodec::Result SkCodec::getSubsetPixels(const SkISize& scaledSize, const SkIRect& subset,
+                                         const SkImageInfo& dstInfo, void* dst,
+                                         size_t rowBytes) {
+    if (kUnknown_SkColorType == dstInfo.colorType() ||
+        kIndex_8_SkColorType == dstInfo.colorType()) {
+        return kInvalidConversion;
+    }
+    if (NULL == dst || rowBytes < dstInfo.minRowBytes()) {
+        return kInvalidParameters;
+    }
+    if (subset.isEmpty() || subset.size() != dstInfo.dimensions() ||
+        !SkIRect::MakeSize(scaledSize).contains(subset)) {
+        return kInvalidParameters;
+    }
+    return this->onGetSubsetPixels(scaledSize, subset, dstInfo, dst, rowBytes);
+}
+
+bool SkCodec::getFrameInfo(int index, FrameInfo* info) {
+    if (index < 0 || index >= this->getFrameCount()) {
+        return false;
+    }
+    return this->onGetFrameInfo(index, info);
+}
+
+SkCodec::Result SkCodec::getFrame(int index, const SkImageInfo& dstInfo, void* dst,
+                                  size_t rowBytes) {
+    if (kN32_SkColorType != dstInfo.colorType()) {
+        return kInvalidConversion;
+    }
+    if (dstInfo.dimensions() != this->getInfo().dimensions()) {
+        return kInvalidScale;
+    }
+    if (NULL == dst || rowBytes < dstInfo.minRowBytes() ||
+        index < 0 || index >= this->getFrameCount()) {
+        return kInvalidParameters;
+    }
+    return this->onGetFrame(index, dstInfo, dst, rowBytes);
+}
+
+bool SkCodec::onGetFrameInfo(int index, FrameInfo* info) {
+    SkASSERT(0 == index);
+    info->fRect = SkIRect::MakeSize(this->getInfo().dimensions());
+    info->fDuration = 0;
+    info->fDisposalMethod = kKeep_DisposalMethod;
+    info->fRequiredFrame = kNone_RequiredFrame;
+    return true;
+}
+
+SkCodec::Result SkCodec::onGetFrame(int index, const SkImageInfo& dstInfo, void* dst,
+                                    size_t rowBytes) {
+    SkASSERT(0 == index);
+    return this->getPixels(dstInfo, dst, rowBytes);
+}
+
+SkCodec::Result SkCodec::startIncrementalDecode(const SkImageInfo& dstInfo, void* dst,
+                                                size_t rowBytes, int* rowsDecoded) {
+    fIncrementalDecodeStarted = false;
+    if (kUnknown_SkColorType == dstInfo.colorType() ||
+        kIndex_8_SkColorType == dstInfo.colorType()) {
+        return kInvalidConversion;
+    }
+    if (dstInfo.dimensions() != this->getInfo().dimensions()) {
+        return kInvalidScale;
+    }
+    if (NULL == dst || rowBytes < dstInfo.minRowBytes()) {
+        return kInvalidParameters;
+    }
+
+    // The decoder is handed everything from the start of the stream, including the header the
+    // codec has already read. Whatever reads the stream next will need to rewind it.
+    fNeedsRewind = true;
+    if (!fStream->rewind()) {
+        return kCouldNotRewind;
+    }
+    SkAutoTUnref<SkData> data(SkCopyStreamToData(fStream.get()));
+    if (NULL == data.get()) {
+        return kInvalidInput;
+    }
+
+    const Result result = this->onStartIncrementalDecode(dstInfo, dst, rowBytes);
+    if (kSuccess != result) {
+        return result;
+    }
+    fIncrementalDecodeStarted = true;
+    int rows = 0;
+    const Result decodeResult = this->onIncrementalDecode(data->data(), data->size(), &rows);
+    if (rowsDecoded) {
+        *rowsDecoded = rows;
+    }
+    return decodeResult;
+}
+
+SkCodec::Result SkCodec::incrementalDecode(SkData* moreData, int* rowsDecoded) {
+    if (!fIncrementalDecodeStarted) {
+        return kInvalidParameters;
+    }
+    int rows = 0;
+    const Result result = moreData ? this->onIncrementalDecode(moreData->data(),
+                                                               moreData->size(), &rows)
+                                   : this->onIncrementalDecode(NULL, 0, &rows);
+    if (rowsDecoded) {
+        *rowsDecoded = rows;
+    }
+    return result;
+}
+
 SkScanlineDecoder* SkCodec::getScanlineDecoder(const SkImageInfo& dstInfo) {
     fScanlineDecoder.reset(this->onGetScanlineDecoder(dstInfo));
     return fScanlineDecoder.get();
@@ -9,9 +9,12 @@
 #include "SkCodecPriv.h"
 #include "SkColorPriv.h"
 #include "SkColorTable.h"
+#include "SkData.h"
 #include "SkGifInterlaceIter.h"
 #include "SkStream.h"
+#include "SkStreamPriv.h"
 #include "SkSwizzler.h"
+#include "SkTDArray.h"
 #include "SkUtils.h"
 
 /*
@@ -516,3 +519,230 @@ SkCodec::Result SkGifCodec::onGetPixels(const SkImageInfo& dstInfo,
     return gif_error("Could not find any images to decode in gif file.\n",
             kInvalidInput);
 }
+
+/*
+ * Decodes single frames from a copy of the whole gif. Each decode opens its
+ * own GifFileType, so that several frames can be decoded at once.
+ */
+class SkGifCodec::FrameDecoder : public SkFrameHolder::Decoder {
+public:
+    explicit FrameDecoder(SkData* data) : fData(SkRef(data)) {}
+
+    /*
+     * @param offset where the frame's image descriptor starts, just past the
+     *               image separator
+     * @param transIndex the transparent index from the frame's graphics
+     *                   control extension, or SK_MaxU32 if there is none
+     */
+    void appendFrame(size_t offset, uint32_t transIndex) {
+        Frame* frame = fFrames.append();
+        frame->fOffset = offset;
+        frame->fTransIndex = transIndex;
+    }
+
+    bool decodeFrame(int index, const SkIRect& rect, SkPMColor* dst,
+                     size_t rowBytes) const override {
+        SkMemoryStream stream(fData);
+        SkAutoTCallIProc<GifFileType, CloseGif> gif(open_gif(&stream));
+        // Skip straight to the frame's descriptor. Everything giflib needs
+        // from the gif before it was read with the header.
+        if (NULL == gif || !stream.seek(fFrames[index].fOffset) ||
+                GIF_ERROR == DGifGetImageDesc(gif)) {
+            gif_error("Could not find frame.\n");
+            return false;
+        }
+        const GifImageDesc& desc = gif->Image;
+
+        // Indices past the end of the color table are left transparent.
+        SkPMColor colorTable[256];
+        sk_bzero(colorTable, sizeof(colorTable));
+        const ColorMapObject* colorMap = desc.ColorMap ? desc.ColorMap : gif->SColorMap;
+        if (NULL != colorMap) {
+            const int colorCount = SkTMin(colorMap->ColorCount, 256);
+            for (int i = 0; i < colorCount; i++) {
+                colorTable[i] = SkPackARGB32(0xFF, colorMap->Colors[i].Red,
+                                             colorMap->Colors[i].Green,
+                                             colorMap->Colors[i].Blue);
+            }
+        }
+        if (fFrames[index].fTransIndex < 256) {
+            colorTable[fFrames[index].fTransIndex] = SK_ColorTRANSPARENT;
+        }
+
+        // rect is the descriptor's rect clipped to the canvas, so only some
+        // rows and columns of the frame are kept.
+        SkAutoTMalloc<uint8_t> row(desc.Width);
+        SkAutoTDelete<SkGifInterlaceIter> iter(desc.Interlace ?
+                SkNEW_ARGS(SkGifInterlaceIter, (desc.Height)) : NULL);
+        for (int32_t i = 0; i < desc.Height; i++) {
+            if (GIF_ERROR == DGifGetLine(gif, row.get(), desc.Width)) {
+                gif_error(SkStringPrintf("Could not decode line %d of frame %d.\n",
+                                         i, index).c_str());
+                return false;
+            }
+            const int32_t y = desc.Top + (iter.get() ? iter->nextY() : i);
+            if (y < rect.fTop || y >= rect.fBottom) {
+                continue;
+            }
+            SkPMColor* dstRow = SkTAddOffset<SkPMColor>(dst, (y - rect.fTop) * rowBytes);
+            const uint8_t* src = row.get() + rect.fLeft - desc.Left;
+            for (int32_t x = 0; x < rect.width(); x++) {
+                dstRow[x] = colorTable[src[x]];
+            }
+        }
+        return true;
+    }
+
+private:
+    struct Frame {
+        size_t   fOffset;
+        uint32_t fTransIndex;
+    };
+
+    SkAutoTUnref<SkData> fData;
+    SkTDArray<Frame>     fFrames;
+};
+
+bool SkGifCodec::buildFrames() {
+    if (fFrames) {
+        return true;
+    }
+
+    // Copy the whole stream, then put it back where onGetPixels() expects it.
+    SkStream* stream = this->stream();
+    if (!stream->hasPosition()) {
+        return false;
+    }
+    const size_t position = stream->getPosition();
+    if (!stream->rewind()) {
+        return false;
+    }
+    SkAutoTUnref<SkData> data(SkCopyStreamToData(stream));
+    if (!stream->rewind() || stream->skip(position) != position || NULL == data) {
+        return false;
+    }
+
+    SkMemoryStream dataStream(data);
+    SkAutoTCallIProc<GifFileType, CloseGif> gif(open_gif(&dataStream));
+    if (NULL == gif) {
+        return false;
+    }
+
+    FrameDecoder* decoder = SkNEW_ARGS(FrameDecoder, (data));
+    SkAutoTDelete<SkFrameHolder> frames(SkNEW_ARGS(SkFrameHolder,
+            (this->getInfo().dimensions(), decoder)));
+
+    // Taken from the graphics control extension before each image, if any.
+    int duration = 0;
+    DisposalMethod disposalMethod = kKeep_DisposalMethod;
+    uint32_t transIndex = SK_MaxU32;
+
+    // Walk the records, skipping over the image data without decompressing it.
+    // A truncated gif keeps the frames found before the data ran out.
+    bool keepGoing = true;
+    while (keepGoing) {
+        GifRecordType recordType;
+        if (GIF_ERROR == DGifGetRecordType(gif, &recordType)) {
+            break;
+        }
+        switch (recordType) {
+            case IMAGE_DESC_RECORD_TYPE: {
+                const size_t offset = dataStream.getPosition();
+                if (GIF_ERROR == DGifGetImageDesc(gif)) {
+                    keepGoing = false;
+                    break;
+                }
+                const GifImageDesc& desc = gif->Image;
+                const ColorMapObject* colorMap = desc.ColorMap ? desc.ColorMap : gif->SColorMap;
+                // Indices missing from the color table are transparent too.
+                const bool hasAlpha = transIndex < 256 || NULL == colorMap ||
+                                      colorMap->ColorCount < 256;
+                decoder->appendFrame(offset, transIndex);
+                frames->appendFrame(SkIRect::MakeXYWH(desc.Left, desc.Top,
+                                                      desc.Width, desc.Height),
+                                    duration, disposalMethod, hasAlpha);
+                duration = 0;
+                disposalMethod = kKeep_DisposalMethod;
+                transIndex = SK_MaxU32;
+
+                int32_t codeSize;
+                GifByteType* codeBlock;
+                if (GIF_ERROR == DGifGetCode(gif, &codeSize, &codeBlock)) {
+                    keepGoing = false;
+                    break;
+                }
+                while (keepGoing && NULL != codeBlock) {
+                    keepGoing = GIF_ERROR != DGifGetCodeNext(gif, &codeBlock);
+                }
+                break;
+            }
+            case EXTENSION_RECORD_TYPE: {
+                int32_t extFunction;
+                GifByteType* extData;
+                if (GIF_ERROR == DGifGetExtension(gif, &extFunction, &extData)) {
+                    keepGoing = false;
+                    break;
+                }
+                // The first byte is the block's length. Then come the flags,
+                // the delay in hundredths of a second, and the transparent index.
+                if (GRAPHICS_EXT_FUNC_CODE == extFunction && NULL != extData &&
+                        extData[0] >= 4) {
+                    const uint8_t flags = extData[1];
+                    duration = (extData[2] | (extData[3] << 8)) * 10;
+                    transIndex = (flags & 1) ? extData[4] : SK_MaxU32;
+                    switch ((flags >> 2) & 7) {
+                        case 2:
+                            disposalMethod = kRestoreBGColor_DisposalMethod;
+                            break;
+                        case 3:
+                            disposalMethod = kRestorePrevious_DisposalMethod;
+                            break;
+                        default:
+                            // Unspecified, keep, and undefined values.
+                            disposalMethod = kKeep_DisposalMethod;
+                            break;
+                    }
+                }
+                while (keepGoing && NULL != extData) {
+                    keepGoing = GIF_ERROR != DGifGetExtensionNext(gif, &extData);
+                }
+                break;
+            }
+            case TERMINATE_RECORD_TYPE:
+                keepGoing = false;
+                break;
+            default:
+                break;
+        }
+    }
+
+    if (0 == frames->count()) {
+        gif_error("Could not find any frames in gif file.\n");
+        return false;
+    }
+    fFrames.reset(frames.detach());
+    return true;
+}
+
+int SkGifCodec::onGetFrameCount() {
+    if (!this->buildFrames()) {
+        return INHERITED::onGetFrameCount();
+    }
+    return fFrames->count();
+}
+
+bool SkGifCodec::onGetFrameInfo(int index, FrameInfo* info) {
+    if (!this->buildFrames()) {
+        return INHERITED::onGetFrameInfo(index, info);
+    }
+    *info = fFrames->frameInfo(index);
+    return true;
+}
+
+SkCodec::Result SkGifCodec::onGetFrame(int index, const SkImageInfo& dstInfo, void* dst,
+                                       size_t rowBytes) {
+    if (!this->buildFrames()) {
+        return INHERITED::onGetFrame(index, dstInfo, dst, rowBytes);
+    }
+    return fFrames->getFrame(index, (SkPMColor*) dst, rowBytes);
+}
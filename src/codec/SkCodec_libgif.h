@@ -6,6 +6,7 @@
  */
 
 #include "SkCodec.h"
+#include "SkFrameHolder.h"
 #include "SkImageInfo.h"
 
 #include "gif_lib.h"
@@ -43,8 +44,26 @@ protected:
         return kGIF_SkEncodedFormat;
     }
 
+    /*
+     * Animation. The first call copies the whole stream, finds where each
+     * frame starts and reads its graphics control extension. Frames are then
+     * decoded from the copy by an SkFrameHolder.
+     */
+    int onGetFrameCount() override;
+    bool onGetFrameInfo(int index, FrameInfo*) override;
+    Result onGetFrame(int index, const SkImageInfo& dstInfo, void* dst,
+                      size_t rowBytes) override;
+
 private:
 
+    class FrameDecoder;
+
+    /*
+     * Builds fFrames if that has not been done yet, returning false if it
+     * could not be.
+     */
+    bool buildFrames();
+
     /*
      * This function cleans up the gif object after the decode completes
      * It is used in a SkAutoTCallIProc template
@@ -69,6 +88,7 @@ private:
     SkGifCodec(const SkImageInfo& srcInfo, SkStream* stream, GifFileType* gif);
 
     SkAutoTCallIProc<GifFileType, CloseGif> fGif; // owned
+    SkAutoTDelete<SkFrameHolder>            fFrames;
 
     typedef SkCodec INHERITED;
 };
@@ -0,0 +1,699 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCodec_libjpeg.h"
+#include "SkCodecPriv.h"
+#include "SkColorPriv.h"
+#include "SkScanlineDecoder.h"
+#include "SkStream.h"
+#include "SkSwizzler.h"
+#include "SkTDArray.h"
+
+#include <setjmp.h>
+#include <stdio.h>
+
+extern "C" {
+    #include "jpeglib.h"
+    #include "jerror.h"
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// libjpeg glue
+///////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+struct ErrorMgr : jpeg_error_mgr {
+    jmp_buf fJmpBuf;
+};
+
+static void error_exit(j_common_ptr cinfo) {
+    ErrorMgr* error = static_cast<ErrorMgr*>(cinfo->err);
+    (*error->output_message)(cinfo);
+    longjmp(error->fJmpBuf, 1);
+}
+
+static void output_message(j_common_ptr cinfo) {
+    char buffer[JMSG_LENGTH_MAX];
+    (*cinfo->err->format_message)(cinfo, buffer);
+    SkCodecPrintf("----- jpeg message %s\n", buffer);
+}
+
+// Feeds libjpeg from an SkStream. If the stream ends early, we hand libjpeg an
+// end of image marker, so it fills in the rest of the image and we can report
+// kIncompleteInput.
+struct SourceMgr : jpeg_source_mgr {
+    SkStream* fStream;  // Unowned.
+    bool      fTruncated;
+    JOCTET    fBuffer[4096];
+};
+
+static void init_source(j_decompress_ptr cinfo) {
+    SourceMgr* src = static_cast<SourceMgr*>(cinfo->src);
+    src->next_input_byte = src->fBuffer;
+    src->bytes_in_buffer = 0;
+}
+
+static boolean fill_input_buffer(j_decompress_ptr cinfo) {
+    SourceMgr* src = static_cast<SourceMgr*>(cinfo->src);
+    size_t bytes = src->fStream->read(src->fBuffer, sizeof(src->fBuffer));
+    if (0 == bytes) {
+        src->fTruncated = true;
+        src->fBuffer[0] = (JOCTET)0xFF;
+        src->fBuffer[1] = (JOCTET)JPEG_EOI;
+        bytes = 2;
+    }
+    src->next_input_byte = src->fBuffer;
+    src->bytes_in_buffer = bytes;
+    return TRUE;
+}
+
+static void skip_input_data(j_decompress_ptr cinfo, long numBytes) {
+    SourceMgr* src = static_cast<SourceMgr*>(cinfo->src);
+    if (numBytes <= 0) {
+        return;
+    }
+    if ((size_t)numBytes <= src->bytes_in_buffer) {
+        src->next_input_byte += numBytes;
+        src->bytes_in_buffer -= numBytes;
+        return;
+    }
+    const size_t bytesToSkip = numBytes - src->bytes_in_buffer;
+    src->next_input_byte = src->fBuffer;
+    src->bytes_in_buffer = 0;
+    if (src->fStream->skip(bytesToSkip) != bytesToSkip) {
+        // The next read will find the end of the stream.
+        src->fTruncated = true;
+    }
+}
+
+static void term_source(j_decompress_ptr) {}
+
+// Feeds libjpeg the data as it arrives. When it runs out, fill_input_buffer() has libjpeg
+// suspend, returning to its caller, and it tries again from its last safe point once there
+// is more. libjpeg never backs up past next_input_byte, so the bytes before it are dropped.
+struct SuspendingSourceMgr : jpeg_source_mgr {
+    SkTDArray<JOCTET> fData;
+    size_t            fSkip;    // bytes libjpeg has skipped past the end of fData
+};
+
+static void init_suspending_source(j_decompress_ptr) {}
+
+static boolean suspend(j_decompress_ptr) {
+    return FALSE;
+}
+
+static void skip_suspending_input_data(j_decompress_ptr cinfo, long numBytes) {
+    SuspendingSourceMgr* src = static_cast<SuspendingSourceMgr*>(cinfo->src);
+    if (numBytes <= 0) {
+        return;
+    }
+    if ((size_t)numBytes <= src->bytes_in_buffer) {
+        src->next_input_byte += numBytes;
+        src->bytes_in_buffer -= numBytes;
+        return;
+    }
+    src->fSkip += numBytes - src->bytes_in_buffer;
+    src->next_input_byte += src->bytes_in_buffer;
+    src->bytes_in_buffer = 0;
+}
+
+static void append_data(SuspendingSourceMgr* src, const void* data, size_t length) {
+    if (0 == length) {
+        return;
+    }
+    const int consumed = src->next_input_byte ?
+            SkToInt(src->next_input_byte - src->fData.begin()) : 0;
+    src->fData.remove(0, consumed);
+    src->fData.append(SkToInt(length), static_cast<const JOCTET*>(data));
+    const int skip = SkToInt(SkTMin<size_t>(src->fSkip, src->fData.count()));
+    src->fData.remove(0, skip);
+    src->fSkip -= skip;
+    src->next_input_byte = src->fData.begin();
+    src->bytes_in_buffer = src->fData.count();
+}
+
+static void create_decompress(jpeg_decompress_struct* cinfo, ErrorMgr* error) {
+    cinfo->err = jpeg_std_error(error);
+    error->error_exit = error_exit;
+    error->output_message = output_message;
+    jpeg_create_decompress(cinfo);
+}
+
+}  // namespace
+
+// Owns the libjpeg decompressor for one pass through the stream.
+struct JpegDecoderMgr : SkNoncopyable {
+    explicit JpegDecoderMgr(SkStream* stream) {
+        create_decompress(&fInfo, &fError);
+
+        fSource.fStream = stream;
+        fSource.fTruncated = false;
+        fSource.init_source = init_source;
+        fSource.fill_input_buffer = fill_input_buffer;
+        fSource.skip_input_data = skip_input_data;
+        fSource.resync_to_restart = jpeg_resync_to_restart;
+        fSource.term_source = term_source;
+        fInfo.src = &fSource;
+    }
+
+    ~JpegDecoderMgr() { jpeg_destroy_decompress(&fInfo); }
+
+    jpeg_decompress_struct fInfo;
+    ErrorMgr               fError;
+    SourceMgr              fSource;
+};
+
+// Makes a JpegDecoderMgr and reads the header. Returns NULL on failure.
+static JpegDecoderMgr* read_header(SkStream* stream) {
+    SkAutoTDelete<JpegDecoderMgr> mgr(SkNEW_ARGS(JpegDecoderMgr, (stream)));
+    if (setjmp(mgr->fError.fJmpBuf)) {
+        return NULL;
+    }
+    if (JPEG_HEADER_OK != jpeg_read_header(&mgr->fInfo, TRUE)) {
+        return NULL;
+    }
+    return mgr.detach();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Creation
+///////////////////////////////////////////////////////////////////////////////
+
+bool SkJpegCodec::IsJpeg(SkStream* stream) {
+    static const uint8_t kJpegSig[] = { 0xFF, 0xD8, 0xFF };
+    uint8_t buffer[sizeof(kJpegSig)];
+    return stream->read(buffer, sizeof(kJpegSig)) == sizeof(kJpegSig) &&
+           !memcmp(buffer, kJpegSig, sizeof(kJpegSig));
+}
+
+SkCodec* SkJpegCodec::NewFromStream(SkStream* stream) {
+    SkAutoTDelete<SkStream> streamDeleter(stream);
+    SkAutoTDelete<JpegDecoderMgr> mgr(read_header(stream));
+    if (!mgr) {
+        return NULL;
+    }
+    // JPEGs are always opaque; grayscale and CMYK images are converted to N32 too.
+    const SkImageInfo info = SkImageInfo::Make(mgr->fInfo.image_width, mgr->fInfo.image_height,
+                                               kN32_SkColorType, kOpaque_SkAlphaType);
+    return SkNEW_ARGS(SkJpegCodec, (info, streamDeleter.detach(), mgr.detach()));
+}
+
+SkJpegCodec::SkJpegCodec(const SkImageInfo& info, SkStream* stream, JpegDecoderMgr* mgr)
+    : INHERITED(info, stream)
+    , fDecoderMgr(mgr)
+    , fSrcConfig(SkSwizzler::kUnknown)
+    , fSrcRow(NULL)
+{}
+
+SkJpegCodec::~SkJpegCodec() {}
+
+///////////////////////////////////////////////////////////////////////////////
+// Scaling
+///////////////////////////////////////////////////////////////////////////////
+
+// The scales libjpeg can apply while decoding, as 1/denominator.
+static const unsigned kScaleDenominators[] = { 1, 2, 4, 8 };
+
+// libjpeg rounds scaled dimensions up.
+static SkISize scale_dimensions(const SkISize& size, unsigned denominator) {
+    return SkISize::Make((size.width()  + denominator - 1) / denominator,
+                         (size.height() + denominator - 1) / denominator);
+}
+
+// Returns the denominator that scales size to scaledSize, or 0 if there is none.
+static unsigned scale_denominator(const SkISize& size, const SkISize& scaledSize) {
+    for (size_t i = 0; i < SK_ARRAY_COUNT(kScaleDenominators); i++) {
+        if (scale_dimensions(size, kScaleDenominators[i]) == scaledSize) {
+            return kScaleDenominators[i];
+        }
+    }
+    return 0;
+}
+
+SkISize SkJpegCodec::onGetScaledDimensions(float desiredScale) const {
+    // Use the smallest scale that is no smaller than desired, so we never lose detail.
+    unsigned denominator = 1;
+    for (size_t i = 0; i < SK_ARRAY_COUNT(kScaleDenominators); i++) {
+        if (1.0f / kScaleDenominators[i] >= desiredScale) {
+            denominator = kScaleDenominators[i];
+        }
+    }
+    return scale_dimensions(this->getInfo().dimensions(), denominator);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Getting the pixels
+///////////////////////////////////////////////////////////////////////////////
+
+static bool conversion_possible(const SkImageInfo& dst) {
+    // The source is opaque, so any alpha type will do.
+    switch (dst.colorType()) {
+        case kN32_SkColorType:
+        case kRGB_565_SkColorType:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool SkJpegCodec::handleRewind() {
+    switch (this->rewindIfNeeded()) {
+        case kNoRewindNecessary_RewindState:
+            return true;
+        case kCouldNotRewind_RewindState:
+            return false;
+        case kRewound_RewindState:
+            // libjpeg can't start over, so we make a fresh decompressor.
+            fDecoderMgr.reset(read_header(this->stream()));
+            return fDecoderMgr.get() != NULL;
+        default:
+            SkASSERT(false);
+            return false;
+    }
+}
+
+// Picks the color space for libjpeg to decode to, returning the matching SrcConfig.
+static SkSwizzler::SrcConfig set_out_color_space(jpeg_decompress_struct* cinfo) {
+    switch (cinfo->jpeg_color_space) {
+        case JCS_GRAYSCALE:
+            cinfo->out_color_space = JCS_GRAYSCALE;
+            return SkSwizzler::kGray;
+        case JCS_CMYK:
+        case JCS_YCCK:
+            // We convert CMYK to RGBX ourselves, in convert_cmyk().
+            cinfo->out_color_space = JCS_CMYK;
+            return SkSwizzler::kRGBX;
+        default:
+            cinfo->out_color_space = JCS_RGB;
+            return SkSwizzler::kRGB;
+    }
+}
+
+// Converts a row decoded as CMYK to RGBX, in place. Other rows are left alone.
+static void convert_cmyk(const jpeg_decompress_struct& cinfo, uint8_t* row) {
+    if (JCS_CMYK != cinfo.out_color_space) {
+        return;
+    }
+    // We see inverted CMYK (as Adobe writes it), so R = 255 * (1 - C) * (1 - K)
+    // becomes C * K / 255.
+    uint8_t* pixel = row;
+    for (JDIMENSION x = 0; x < cinfo.output_width; x++, pixel += 4) {
+        pixel[0] = SkMulDiv255Round(pixel[0], pixel[3]);
+        pixel[1] = SkMulDiv255Round(pixel[1], pixel[3]);
+        pixel[2] = SkMulDiv255Round(pixel[2], pixel[3]);
+        pixel[3] = 0xFF;
+    }
+}
+
+SkCodec::Result SkJpegCodec::startDecompress(const SkISize& scaledSize,
+                                             const SkImageInfo& dstInfo,
+                                             void* dst, size_t rowBytes) {
+    jpeg_decompress_struct* cinfo = &fDecoderMgr->fInfo;
+
+    const unsigned denominator = scale_denominator(this->getInfo().dimensions(), scaledSize);
+    if (0 == denominator) {
+        return kInvalidScale;
+    }
+    cinfo->scale_num = 1;
+    cinfo->scale_denom = denominator;
+
+    fSrcConfig = set_out_color_space(cinfo);
+    fSwizzler.reset(SkSwizzler::CreateSwizzler(fSrcConfig, NULL, dstInfo, dst, rowBytes,
+                                               kNo_ZeroInitialized));
+    if (!fSwizzler) {
+        return kUnimplemented;
+    }
+
+    if (!jpeg_start_decompress(cinfo)) {
+        return kInvalidInput;
+    }
+    SkASSERT(scaledSize.width()  == (int)cinfo->output_width &&
+             scaledSize.height() == (int)cinfo->output_height);
+    SkASSERT(SkSwizzler::BytesPerPixel(fSrcConfig) == cinfo->output_components ||
+             SkSwizzler::kRGBX == fSrcConfig);
+
+    fStorage.reset(cinfo->output_width * SkSwizzler::BytesPerPixel(fSrcConfig));
+    fSrcRow = static_cast<uint8_t*>(fStorage.get());
+    return kSuccess;
+}
+
+void SkJpegCodec::readRow() {
+    JSAMPLE* row = fSrcRow;
+    jpeg_read_scanlines(&fDecoderMgr->fInfo, &row, 1);
+    convert_cmyk(fDecoderMgr->fInfo, fSrcRow);
+}
+
+SkCodec::Result SkJpegCodec::onGetPixels(const SkImageInfo& dstInfo, void* dst,
+                                         size_t rowBytes, const Options&,
+                                         SkPMColor*, int*) {
+    return this->onGetSubsetPixels(dstInfo.dimensions(), SkIRect::MakeSize(dstInfo.dimensions()),
+                                   dstInfo, dst, rowBytes);
+}
+
+SkCodec::Result SkJpegCodec::onGetSubsetPixels(const SkISize& scaledSize, const SkIRect& subset,
+                                               const SkImageInfo& dstInfo, void* dst,
+                                               size_t rowBytes) {
+    if (!this->handleRewind()) {
+        return kCouldNotRewind;
+    }
+    if (!conversion_possible(dstInfo)) {
+        return kInvalidConversion;
+    }
+
+    jpeg_decompress_struct* cinfo = &fDecoderMgr->fInfo;
+    if (setjmp(fDecoderMgr->fError.fJmpBuf)) {
+        SkCodecPrintf("setjmp long jump!\n");
+        return kInvalidInput;
+    }
+
+    const Result result = this->startDecompress(scaledSize, dstInfo, dst, rowBytes);
+    if (kSuccess != result) {
+        return result;
+    }
+
+    // Rows above the subset must still be decoded, but we needn't convert them.
+    const size_t srcOffset = subset.left() * SkSwizzler::BytesPerPixel(fSrcConfig);
+    for (int y = 0; y < subset.bottom(); y++) {
+        this->readRow();
+        if (y >= subset.top()) {
+            fSwizzler->next(fSrcRow + srcOffset);
+        }
+    }
+
+    // Stop early if we can; either way the next decode will rewind.
+    if (cinfo->output_scanline < cinfo->output_height) {
+        jpeg_abort_decompress(cinfo);
+    } else {
+        jpeg_finish_decompress(cinfo);
+    }
+    return fDecoderMgr->fSource.fTruncated ? kIncompleteInput : kSuccess;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Scanline decoding
+///////////////////////////////////////////////////////////////////////////////
+
+class SkJpegScanlineDecoder : public SkScanlineDecoder {
+public:
+    SkJpegScanlineDecoder(const SkImageInfo& dstInfo, SkJpegCodec* codec)
+        : INHERITED(dstInfo)
+        , fCodec(codec)
+    {}
+
+    SkImageGenerator::Result onGetScanlines(void* dst, int count, size_t rowBytes) override {
+        if (setjmp(fCodec->fDecoderMgr->fError.fJmpBuf)) {
+            SkCodecPrintf("setjmp long jump!\n");
+            return SkImageGenerator::kInvalidInput;
+        }
+
+        for (int i = 0; i < count; i++) {
+            fCodec->readRow();
+            fCodec->fSwizzler->setDstRow(dst);
+            fCodec->fSwizzler->next(fCodec->fSrcRow);
+            dst = SkTAddOffset<void>(dst, rowBytes);
+        }
+        return fCodec->fDecoderMgr->fSource.fTruncated ? SkImageGenerator::kIncompleteInput
+                                                       : SkImageGenerator::kSuccess;
+    }
+
+    SkImageGenerator::Result onSkipScanlines(int count) override {
+        if (setjmp(fCodec->fDecoderMgr->fError.fJmpBuf)) {
+            SkCodecPrintf("setjmp long jump!\n");
+            return SkImageGenerator::kInvalidInput;
+        }
+
+        // libjpeg must still decode the rows, but we skip converting them.
+        for (int i = 0; i < count; i++) {
+            fCodec->readRow();
+        }
+        return SkImageGenerator::kSuccess;
+    }
+
+    void onFinish() override {
+        if (setjmp(fCodec->fDecoderMgr->fError.fJmpBuf)) {
+            // We've already read all the scanlines. This is a success.
+            return;
+        }
+        jpeg_finish_decompress(&fCodec->fDecoderMgr->fInfo);
+    }
+
+private:
+    SkJpegCodec* fCodec;  // Unowned.
+
+    typedef SkScanlineDecoder INHERITED;
+};
+
+SkScanlineDecoder* SkJpegCodec::onGetScanlineDecoder(const SkImageInfo& dstInfo) {
+    if (!this->handleRewind()) {
+        return NULL;
+    }
+    if (!conversion_possible(dstInfo)) {
+        SkCodecPrintf("no conversion possible\n");
+        return NULL;
+    }
+
+    if (setjmp(fDecoderMgr->fError.fJmpBuf)) {
+        SkCodecPrintf("setjmp long jump!\n");
+        return NULL;
+    }
+    // Note: We set dst to NULL since we do not know it yet. The scanline
+    // decoder sets the row before each call to next().
+    if (this->startDecompress(dstInfo.dimensions(), dstInfo, NULL, dstInfo.minRowBytes())
+            != kSuccess) {
+        SkCodecPrintf("failed to start decompressing.\n");
+        return NULL;
+    }
+    return SkNEW_ARGS(SkJpegScanlineDecoder, (dstInfo, this));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Incremental decoding
+///////////////////////////////////////////////////////////////////////////////
+
+// Decodes with a decompressor of its own, reading from a SuspendingSourceMgr, and carries on
+// from wherever libjpeg last suspended each time more data arrives. Baseline images come a row
+// at a time, but libjpeg reads all of a progressive image before it returns any rows.
+class SkJpegIncrementalDecoder : SkNoncopyable {
+public:
+    SkJpegIncrementalDecoder(const SkImageInfo& dstInfo, void* dst, size_t rowBytes)
+        : fDstInfo(dstInfo)
+        , fDst(dst)
+        , fRowBytes(rowBytes)
+        , fState(kHeader_State)
+        , fRowsDecoded(0)
+        , fResult(SkCodec::kIncompleteInput)
+    {
+        create_decompress(&fInfo, &fError);
+        fSource.fSkip = 0;
+        fSource.next_input_byte = NULL;
+        fSource.bytes_in_buffer = 0;
+        fSource.init_source = init_suspending_source;
+        fSource.fill_input_buffer = suspend;
+        fSource.skip_input_data = skip_suspending_input_data;
+        fSource.resync_to_restart = jpeg_resync_to_restart;
+        fSource.term_source = term_source;
+        fInfo.src = &fSource;
+    }
+
+    ~SkJpegIncrementalDecoder() { jpeg_destroy_decompress(&fInfo); }
+
+    SkCodec::Result decode(const void* data, size_t length, int* rowsDecoded) {
+        if (SkCodec::kIncompleteInput == fResult) {
+            append_data(&fSource, data, length);
+            if (setjmp(fError.fJmpBuf)) {
+                SkCodecPrintf("setjmp long jump!\n");
+                fResult = SkCodec::kInvalidInput;
+            } else {
+                fResult = this->resume();
+            }
+        }
+        *rowsDecoded = fRowsDecoded;
+        return fResult;
+    }
+
+private:
+    enum State {
+        kHeader_State,
+        kStartDecompress_State,
+        kRows_State,
+        kDone_State,
+    };
+
+    // Returns kIncompleteInput if libjpeg suspends, to be called again with more data.
+    SkCodec::Result resume() {
+        switch (fState) {
+            case kHeader_State:
+                if (JPEG_SUSPENDED == jpeg_read_header(&fInfo, TRUE)) {
+                    return SkCodec::kIncompleteInput;
+                }
+                if ((int)fInfo.image_width != fDstInfo.width() ||
+                    (int)fInfo.image_height != fDstInfo.height()) {
+                    return SkCodec::kInvalidInput;
+                }
+                fSrcConfig = set_out_color_space(&fInfo);
+                fSwizzler.reset(SkSwizzler::CreateSwizzler(fSrcConfig, NULL, fDstInfo, fDst,
+                        fRowBytes, SkImageGenerator::kNo_ZeroInitialized));
+                if (!fSwizzler) {
+                    return SkCodec::kUnimplemented;
+                }
+                fState = kStartDecompress_State;
+                // fall through
+            case kStartDecompress_State:
+                if (!jpeg_start_decompress(&fInfo)) {
+                    return SkCodec::kIncompleteInput;
+                }
+                fStorage.reset(fInfo.output_width * SkSwizzler::BytesPerPixel(fSrcConfig));
+                fState = kRows_State;
+                // fall through
+            case kRows_State:
+                while (fInfo.output_scanline < fInfo.output_height) {
+                    JSAMPLE* row = fStorage.get();
+                    if (0 == jpeg_read_scanlines(&fInfo, &row, 1)) {
+                        return SkCodec::kIncompleteInput;
+                    }
+                    convert_cmyk(fInfo, fStorage.get());
+                    fSwizzler->next(fStorage.get());
+                    fRowsDecoded++;
+                }
+                // Every row is in; we needn't wait for the end of image marker.
+                jpeg_abort_decompress(&fInfo);
+                fState = kDone_State;
+                // fall through
+            case kDone_State:
+                return SkCodec::kSuccess;
+        }
+        SkASSERT(false);
+        return SkCodec::kInvalidInput;
+    }
+
+    jpeg_decompress_struct    fInfo;
+    ErrorMgr                  fError;
+    SuspendingSourceMgr       fSource;
+    const SkImageInfo         fDstInfo;
+    void*                     fDst;
+    const size_t              fRowBytes;
+    State                     fState;
+    SkSwizzler::SrcConfig     fSrcConfig;
+    SkAutoTDelete<SkSwizzler> fSwizzler;
+    SkAutoTMalloc<JSAMPLE>    fStorage;
+    int                       fRowsDecoded;
+    SkCodec::Result           fResult;
+};
+
+SkCodec::Result SkJpegCodec::onStartIncrementalDecode(const SkImageInfo& dstInfo, void* dst,
+                                                      size_t rowBytes) {
+    if (!conversion_possible(dstInfo)) {
+        return kInvalidConversion;
+    }
+    fIncrementalDecoder.reset(SkNEW_ARGS(SkJpegIncrementalDecoder, (dstInfo, dst, rowBytes)));
+    return kSuccess;
+}
+
+SkCodec::Result SkJpegCodec::onIncrementalDecode(const void* data, size_t length,
+                                                 int* rowsDecoded) {
+    SkASSERT(fIncrementalDecoder);
+    return fIncrementalDecoder->decode(data, length, rowsDecoded);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// YUV planes
+///////////////////////////////////////////////////////////////////////////////
+
+// Whether libjpeg can give us the image as Y, U and V planes, with U and V the same size.
+// Y may be subsampled by at most 2 vertically, so an MCU row is at most 2 * DCTSIZE rows.
+static bool is_yuv(const jpeg_decompress_struct& cinfo) {
+    return JCS_YCbCr == cinfo.jpeg_color_space
+        && 3 == cinfo.num_components
+        && cinfo.max_v_samp_factor <= 2
+        && 1 == cinfo.comp_info[1].h_samp_factor
+        && 1 == cinfo.comp_info[1].v_samp_factor
+        && 1 == cinfo.comp_info[2].h_samp_factor
+        && 1 == cinfo.comp_info[2].v_samp_factor;
+}
+
+// libjpeg writes whole blocks, so this is the size each plane's memory must cover.
+static SkISize block_size(const jpeg_component_info& component) {
+    return SkISize::Make(component.width_in_blocks  * DCTSIZE,
+                         component.height_in_blocks * DCTSIZE);
+}
+
+bool SkJpegCodec::onGetYUV8Planes(SkISize sizes[3], void* planes[3], size_t rowBytes[3],
+                                  SkYUVColorSpace* colorSpace) {
+    if (!this->handleRewind()) {
+        return false;
+    }
+    jpeg_decompress_struct* cinfo = &fDecoderMgr->fInfo;
+    if (setjmp(fDecoderMgr->fError.fJmpBuf)) {
+        SkCodecPrintf("setjmp long jump!\n");
+        return false;
+    }
+    if (!is_yuv(*cinfo)) {
+        // Not an error; the caller will ask for RGB instead.
+        return false;
+    }
+
+    if (!planes || !planes[0] || !rowBytes || !rowBytes[0]) {
+        // Just report how much memory each plane needs.
+        for (int i = 0; i < 3; i++) {
+            sizes[i] = block_size(cinfo->comp_info[i]);
+        }
+        return true;
+    }
+
+    // libjpeg writes whole blocks, so each row must have room for its padding.
+    for (int i = 0; i < 3; i++) {
+        if (rowBytes[i] < (size_t)block_size(cinfo->comp_info[i]).width()) {
+            return false;
+        }
+    }
+
+    cinfo->out_color_space = JCS_YCbCr;
+    cinfo->raw_data_out = TRUE;
+    cinfo->scale_num = 1;
+    cinfo->scale_denom = 1;
+    if (!jpeg_start_decompress(cinfo)) {
+        return false;
+    }
+
+    // Each call to jpeg_read_raw_data() returns one row of MCUs: maxRows rows of Y, and
+    // DCTSIZE rows of U and V. Rows past the bottom of a plane go to a dummy row.
+    const int maxRows = cinfo->max_v_samp_factor * DCTSIZE;
+    // This lives in fStorage, as a longjmp would skip a local's destructor.
+    fStorage.reset(block_size(cinfo->comp_info[0]).width());
+    const JSAMPROW dummyRow = static_cast<JSAMPROW>(fStorage.get());
+    JSAMPROW rows[3][2 * DCTSIZE];
+    JSAMPARRAY rowArrays[3] = { rows[0], rows[1], rows[2] };
+    while (cinfo->output_scanline < cinfo->output_height) {
+        for (int i = 0; i < 3; i++) {
+            const jpeg_component_info& component = cinfo->comp_info[i];
+            const int rowCount = component.v_samp_factor * DCTSIZE;
+            const int firstRow = cinfo->output_scanline * component.v_samp_factor /
+                                 cinfo->max_v_samp_factor;
+            for (int j = 0; j < rowCount; j++) {
+                const int row = firstRow + j;
+                rows[i][j] = row < (int)component.downsampled_height
+                           ? (JSAMPROW)planes[i] + row * rowBytes[i]
+                           : dummyRow;
+            }
+        }
+        if (0 == jpeg_read_raw_data(cinfo, rowArrays, maxRows)) {
+            return false;
+        }
+    }
+
+    for (int i = 0; i < 3; i++) {
+        sizes[i].set(cinfo->comp_info[i].downsampled_width,
+                     cinfo->comp_info[i].downsampled_height);
+    }
+    jpeg_finish_decompress(cinfo);
+
+    if (colorSpace) {
+        *colorSpace = kJPEG_SkYUVColorSpace;
+    }
+    return !fDecoderMgr->fSource.fTruncated;
+}
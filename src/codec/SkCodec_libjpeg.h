@@ -0,0 +1,104 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkCodec_libjpeg_DEFINED
+#define SkCodec_libjpeg_DEFINED
+
+#include "SkCodec.h"
+#include "SkImageInfo.h"
+#include "SkSwizzler.h"
+
+struct JpegDecoderMgr;
+class SkJpegIncrementalDecoder;
+
+/*
+ *
+ * This class implements the decoding for jpeg images
+ *
+ * libjpeg scales by 1/2, 1/4 or 1/8 as part of its inverse DCT, at no extra
+ * cost, so scaled decodes never produce full resolution pixels. Subsets are
+ * decoded by only converting the rows and columns inside them, and stopping
+ * once past the bottom of the subset.
+ *
+ */
+class SkJpegCodec : public SkCodec {
+public:
+
+    /*
+     * Checks the start of the stream to see if the image is a jpeg
+     */
+    static bool IsJpeg(SkStream*);
+
+    /*
+     * Assumes IsJpeg was called and returned true
+     * Creates a jpeg decoder
+     * Reads enough of the stream to determine the image format
+     */
+    static SkCodec* NewFromStream(SkStream*);
+
+protected:
+
+    Result onGetPixels(const SkImageInfo&, void*, size_t, const Options&, SkPMColor*, int*)
+            override;
+
+    SkISize onGetScaledDimensions(float desiredScale) const override;
+
+    SkEncodedFormat onGetEncodedFormat() const override {
+        return kJPEG_SkEncodedFormat;
+    }
+
+    Result onGetSubsetPixels(const SkISize& scaledSize, const SkIRect& subset,
+                             const SkImageInfo& dstInfo, void* dst, size_t rowBytes) override;
+
+    SkScanlineDecoder* onGetScanlineDecoder(const SkImageInfo& dstInfo) override;
+
+    Result onStartIncrementalDecode(const SkImageInfo& dstInfo, void* dst,
+                                    size_t rowBytes) override;
+    Result onIncrementalDecode(const void* data, size_t length, int* rowsDecoded) override;
+
+    /*
+     * Returns the Y, U and V planes straight from libjpeg's raw_data_out, skipping both
+     * upsampling and color conversion. Only 3 component YCbCr images at full scale are
+     * supported, with U and V subsampled alike.
+     */
+    bool onGetYUV8Planes(SkISize sizes[3], void* planes[3], size_t rowBytes[3],
+                         SkYUVColorSpace* colorSpace) override;
+
+private:
+
+    SkJpegCodec(const SkImageInfo&, SkStream*, JpegDecoderMgr*);
+    ~SkJpegCodec();
+
+    // Calls rewindIfNeeded, and returns true if the decoder can continue.
+    bool handleRewind();
+
+    /*
+     * Sets libjpeg up to decode at scaledSize and starts decompressing,
+     * choosing fSrcConfig and making an fSwizzler that writes rows of dstInfo.
+     */
+    Result startDecompress(const SkISize& scaledSize, const SkImageInfo& dstInfo,
+                           void* dst, size_t rowBytes);
+
+    /*
+     * Reads the next row from libjpeg into fSrcRow, in fSrcConfig.
+     */
+    void readRow();
+
+    SkAutoTDelete<JpegDecoderMgr> fDecoderMgr;
+    SkAutoTDelete<SkSwizzler>     fSwizzler;
+    SkSwizzler::SrcConfig         fSrcConfig;
+    SkAutoMalloc                  fStorage;
+    uint8_t*                      fSrcRow;
+
+    SkAutoTDelete<SkJpegIncrementalDecoder> fIncrementalDecoder;
+
+    friend class SkJpegScanlineDecoder;
+
+    typedef SkCodec INHERITED;
+};
+
+#endif  // SkCodec_libjpeg_DEFINED
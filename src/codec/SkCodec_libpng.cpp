@@ -15,6 +15,7 @@
 #include "SkSize.h"
 #include "SkStream.h"
 #include "SkSwizzler.h"
+#include "SkTDArray.h"
 
 ///////////////////////////////////////////////////////////////////////////////
 // Helper macros
@@ -118,14 +119,15 @@ static bool has_transparency_in_palette(png_structp png_ptr,
 typedef uint32_t (*PackColorProc)(U8CPU a, U8CPU r, U8CPU g, U8CPU b);
 
 // Note: SkColorTable claims to store SkPMColors, which is not necessarily
-// the case here.
-bool SkPngCodec::decodePalette(bool premultiply) {
+// the case here. Returns NULL if there is no palette.
+static SkColorTable* decode_palette(png_structp png_ptr, png_infop info_ptr, bool premultiply,
+                                    bool* reallyHasAlpha) {
     int numPalette;
     png_colorp palette;
     png_bytep trans;
 
-    if (!png_get_PLTE(fPng_ptr, fInfo_ptr, &palette, &numPalette)) {
-        return false;
+    if (!png_get_PLTE(png_ptr, info_ptr, &palette, &numPalette)) {
+        return NULL;
     }
 
     /*  BUGGY IMAGE WORKAROUND
@@ -140,8 +142,8 @@ bool SkPngCodec::decodePalette(bool premultiply) {
     SkPMColor* colorPtr = colorStorage;
 
     int numTrans;
-    if (png_get_valid(fPng_ptr, fInfo_ptr, PNG_INFO_tRNS)) {
-        png_get_tRNS(fPng_ptr, fInfo_ptr, &trans, &numTrans, NULL);
+    if (png_get_valid(png_ptr, info_ptr, PNG_INFO_tRNS)) {
+        png_get_tRNS(png_ptr, info_ptr, &trans, &numTrans, NULL);
     } else {
         numTrans = 0;
     }
@@ -168,7 +170,7 @@ bool SkPngCodec::decodePalette(bool premultiply) {
         palette++;
     }
 
-    fReallyHasAlpha = transLessThanFF < 0;
+    *reallyHasAlpha = transLessThanFF < 0;
 
     for (; index < numPalette; index++) {
         *colorPtr++ = SkPackARGB32(0xFF, palette->red, palette->green, palette->blue);
@@ -180,8 +182,28 @@ bool SkPngCodec::decodePalette(bool premultiply) {
         *colorPtr = colorPtr[-1];
     }
 
-    fColorTable.reset(SkNEW_ARGS(SkColorTable, (colorStorage, colorCount)));
-    return true;
+    return SkNEW_ARGS(SkColorTable, (colorStorage, colorCount));
+}
+
+bool SkPngCodec::decodePalette(bool premultiply) {
+    fColorTable.reset(decode_palette(fPng_ptr, fInfo_ptr, premultiply, &fReallyHasAlpha));
+    return fColorTable.get() != NULL;
+}
+
+// The SrcConfig of the rows libpng hands back, once the transforms set up by
+// set_up_transforms() are applied.
+static SkSwizzler::SrcConfig src_config(int pngColorType, const SkImageInfo& requestedInfo,
+                                        SkAlphaType srcAlphaType) {
+    if (PNG_COLOR_TYPE_PALETTE == pngColorType) {
+        return SkSwizzler::kIndex;
+    }
+    if (kAlpha_8_SkColorType == requestedInfo.colorType()) {
+        // Note: we check the destination, since otherwise we would have
+        // told png to upscale.
+        SkASSERT(PNG_COLOR_TYPE_GRAY == pngColorType);
+        return SkSwizzler::kGray;
+    }
+    return kOpaque_SkAlphaType == srcAlphaType ? SkSwizzler::kRGBX : SkSwizzler::kRGBA;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -201,45 +223,9 @@ bool SkPngCodec::IsPng(SkStream* stream) {
     return true;
 }
 
-// Reads the header, and initializes the passed in fields, if not NULL (except
-// stream, which is passed to the read function).
-// Returns true on success, in which case the caller is responsible for calling
-// png_destroy_read_struct. If it returns false, the passed in fields (except
-// stream) are unchanged.
-static bool read_header(SkStream* stream, png_structp* png_ptrp,
-                        png_infop* info_ptrp, SkImageInfo* imageInfo) {
-    // The image is known to be a PNG. Decode enough to know the SkImageInfo.
-    png_structp png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL,
-                                                 sk_error_fn, sk_warning_fn);
-    if (!png_ptr) {
-        return false;
-    }
-
-    AutoCleanPng autoClean(png_ptr);
-
-    png_infop info_ptr = png_create_info_struct(png_ptr);
-    if (info_ptr == NULL) {
-        return false;
-    }
-
-    autoClean.setInfoPtr(info_ptr);
-
-    // FIXME: Could we use the return value of setjmp to specify the type of
-    // error?
-    if (setjmp(png_jmpbuf(png_ptr))) {
-        return false;
-    }
-
-    png_set_read_fn(png_ptr, static_cast<void*>(stream), sk_read_fn);
-
-    // FIXME: This is where the old code hooks up the Peeker. Does it need to
-    // be set this early? (i.e. where are the user chunks? early in the stream,
-    // potentially?)
-    // If it does, we need to figure out a way to set it here.
-
-    // The call to png_read_info() gives us all of the information from the
-    // PNG file before the first IDAT (image data chunk).
-    png_read_info(png_ptr, info_ptr);
+// Tells libpng how to transform the rows, given the header read into info_ptr, and
+// initializes imageInfo, if not NULL. Returns false if the image is too big.
+static bool set_up_transforms(png_structp png_ptr, png_infop info_ptr, SkImageInfo* imageInfo) {
     png_uint_32 origWidth, origHeight;
     int bitDepth, colorType;
     png_get_IHDR(png_ptr, info_ptr, &origWidth, &origHeight, &bitDepth,
@@ -335,6 +321,52 @@ static bool read_header(SkStream* stream, png_structp* png_ptrp,
         *imageInfo = SkImageInfo::Make(origWidth, origHeight, skColorType,
                                        skAlphaType);
     }
+    return true;
+}
+
+// Reads the header, and initializes the passed in fields, if not NULL (except
+// stream, which is passed to the read function).
+// Returns true on success, in which case the caller is responsible for calling
+// png_destroy_read_struct. If it returns false, the passed in fields (except
+// stream) are unchanged.
+static bool read_header(SkStream* stream, png_structp* png_ptrp,
+                        png_infop* info_ptrp, SkImageInfo* imageInfo) {
+    // The image is known to be a PNG. Decode enough to know the SkImageInfo.
+    png_structp png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL,
+                                                 sk_error_fn, sk_warning_fn);
+    if (!png_ptr) {
+        return false;
+    }
+
+    AutoCleanPng autoClean(png_ptr);
+
+    png_infop info_ptr = png_create_info_struct(png_ptr);
+    if (info_ptr == NULL) {
+        return false;
+    }
+
+    autoClean.setInfoPtr(info_ptr);
+
+    // FIXME: Could we use the return value of setjmp to specify the type of
+    // error?
+    if (setjmp(png_jmpbuf(png_ptr))) {
+        return false;
+    }
+
+    png_set_read_fn(png_ptr, static_cast<void*>(stream), sk_read_fn);
+
+    // FIXME: This is where the old code hooks up the Peeker. Does it need to
+    // be set this early? (i.e. where are the user chunks? early in the stream,
+    // potentially?)
+    // If it does, we need to figure out a way to set it here.
+
+    // The call to png_read_info() gives us all of the information from the
+    // PNG file before the first IDAT (image data chunk).
+    png_read_info(png_ptr, info_ptr);
+    if (!set_up_transforms(png_ptr, info_ptr, imageInfo)) {
+        return false;
+    }
+
     autoClean.detach();
     if (png_ptrp) {
         *png_ptrp = png_ptr;
@@ -421,21 +453,11 @@ SkCodec::Result SkPngCodec::initializeSwizzler(const SkImageInfo& requestedInfo,
 
     // Set to the default before calling decodePalette, which may change it.
     fReallyHasAlpha = false;
-    if (PNG_COLOR_TYPE_PALETTE == pngColorType) {
-        fSrcConfig = SkSwizzler::kIndex;
-        if (!this->decodePalette(kPremul_SkAlphaType == requestedInfo.alphaType())) {
-            return kInvalidInput;
-        }
-    } else if (kAlpha_8_SkColorType == requestedInfo.colorType()) {
-        // Note: we check the destination, since otherwise we would have
-        // told png to upscale.
-        SkASSERT(PNG_COLOR_TYPE_GRAY == pngColorType);
-        fSrcConfig = SkSwizzler::kGray;
-    } else if (this->getInfo().alphaType() == kOpaque_SkAlphaType) {
-        fSrcConfig = SkSwizzler::kRGBX;
-    } else {
-        fSrcConfig = SkSwizzler::kRGBA;
+    if (PNG_COLOR_TYPE_PALETTE == pngColorType &&
+        !this->decodePalette(kPremul_SkAlphaType == requestedInfo.alphaType())) {
+        return kInvalidInput;
     }
+    fSrcConfig = src_config(pngColorType, requestedInfo, this->getInfo().alphaType());
     const SkPMColor* colors = fColorTable ? fColorTable->readColors() : NULL;
     fSwizzler.reset(SkSwizzler::CreateSwizzler(fSrcConfig, colors, requestedInfo,
             dst, rowBytes, options.fZeroInitialized));
@@ -645,3 +667,209 @@ SkScanlineDecoder* SkPngCodec::onGetScanlineDecoder(const SkImageInfo& dstInfo)
     return SkNEW_ARGS(SkPngScanlineDecoder, (dstInfo, this));
 }
 
+
+///////////////////////////////////////////////////////////////////////////////
+// Incremental decoding
+///////////////////////////////////////////////////////////////////////////////
+
+// The last Adam7 pass (0-6) with pixels in row y, after which the row is finished.
+static int last_pass_for_row(int y, int width) {
+    static const int kXStart[] = { 0, 4, 0, 2, 0, 1, 0 };
+    static const int kYStart[] = { 0, 0, 4, 0, 2, 0, 1 };
+    static const int kYStep[]  = { 8, 8, 8, 4, 4, 2, 2 };
+    for (int pass = 6; pass > 0; pass--) {
+        if (width > kXStart[pass] && y >= kYStart[pass] &&
+            0 == (y - kYStart[pass]) % kYStep[pass]) {
+            return pass;
+        }
+    }
+    return 0;
+}
+
+// Decodes with libpng's progressive reader, which is pushed the data as it arrives and calls
+// back once the header and then each row have been read. It has a png_struct of its own, so
+// that it leaves alone the one the codec's other decodes read the stream with.
+class SkPngIncrementalDecoder : SkNoncopyable {
+public:
+    SkPngIncrementalDecoder(SkPngCodec* codec, const SkImageInfo& dstInfo, void* dst,
+                            size_t rowBytes)
+        : fCodec(codec)
+        , fDstInfo(dstInfo)
+        , fDst(dst)
+        , fRowBytes(rowBytes)
+        , fPng_ptr(NULL)
+        , fInfo_ptr(NULL)
+        , fNumberPasses(INVALID_NUMBER_PASSES)
+        , fSrcRowBytes(0)
+        , fRowsDecoded(0)
+        , fReallyHasAlpha(false)
+        , fResult(SkCodec::kIncompleteInput)
+    {}
+
+    ~SkPngIncrementalDecoder() {
+        if (fPng_ptr) {
+            png_infopp info_pp = fInfo_ptr ? &fInfo_ptr : NULL;
+            png_destroy_read_struct(&fPng_ptr, info_pp, png_infopp_NULL);
+        }
+    }
+
+    bool init() {
+        fPng_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, sk_error_fn,
+                                          sk_warning_fn);
+        if (!fPng_ptr) {
+            return false;
+        }
+        fInfo_ptr = png_create_info_struct(fPng_ptr);
+        if (!fInfo_ptr) {
+            return false;
+        }
+        png_set_progressive_read_fn(fPng_ptr, this, info_callback, row_callback, end_callback);
+        return true;
+    }
+
+    SkCodec::Result decode(const void* data, size_t length, int* rowsDecoded) {
+        // After an error libpng's state is unknown, so nothing more is fed to it.
+        if (SkCodec::kIncompleteInput == fResult && length > 0) {
+            if (setjmp(png_jmpbuf(fPng_ptr))) {
+                SkCodecPrintf("setjmp long jump!\n");
+                if (SkCodec::kIncompleteInput == fResult) {
+                    fResult = SkCodec::kInvalidInput;
+                }
+            } else {
+                png_process_data(fPng_ptr, fInfo_ptr,
+                                 static_cast<png_bytep>(const_cast<void*>(data)), length);
+            }
+        }
+        *rowsDecoded = fRowsDecoded;
+        return fResult;
+    }
+
+private:
+    static SkPngIncrementalDecoder* Get(png_structp png_ptr) {
+        return static_cast<SkPngIncrementalDecoder*>(png_get_progressive_ptr(png_ptr));
+    }
+
+    static void info_callback(png_structp png_ptr, png_infop) {
+        Get(png_ptr)->onInfo();
+    }
+
+    static void row_callback(png_structp png_ptr, png_bytep row, png_uint_32 y, int pass) {
+        Get(png_ptr)->onRow(row, y, pass);
+    }
+
+    static void end_callback(png_structp png_ptr, png_infop) {
+        Get(png_ptr)->onEnd();
+    }
+
+    void onInfo() {
+        SkImageInfo srcInfo;
+        if (!set_up_transforms(fPng_ptr, fInfo_ptr, &srcInfo) ||
+            srcInfo != fCodec->getInfo()) {
+            png_error(fPng_ptr, "Header does not match the codec's");
+        }
+        int pngColorType, interlaceType;
+        png_get_IHDR(fPng_ptr, fInfo_ptr, NULL, NULL, NULL, &pngColorType, &interlaceType,
+                     int_p_NULL, int_p_NULL);
+        fNumberPasses = (interlaceType != PNG_INTERLACE_NONE) ?
+                png_set_interlace_handling(fPng_ptr) : 1;
+
+        if (PNG_COLOR_TYPE_PALETTE == pngColorType) {
+            fColorTable.reset(decode_palette(fPng_ptr, fInfo_ptr,
+                                             kPremul_SkAlphaType == fDstInfo.alphaType(),
+                                             &fReallyHasAlpha));
+            if (!fColorTable) {
+                png_error(fPng_ptr, "Missing palette");
+            }
+        }
+        const SkSwizzler::SrcConfig srcConfig = src_config(pngColorType, fDstInfo,
+                                                           srcInfo.alphaType());
+        const SkPMColor* colors = fColorTable ? fColorTable->readColors() : NULL;
+        fSwizzler.reset(SkSwizzler::CreateSwizzler(srcConfig, colors, fDstInfo, fDst, fRowBytes,
+                                                   SkImageGenerator::kNo_ZeroInitialized));
+        if (!fSwizzler) {
+            fResult = SkCodec::kUnimplemented;
+            png_error(fPng_ptr, "No swizzler for this conversion");
+        }
+
+        // An interlaced image's rows are put together a pass at a time, and the pixels not
+        // yet seen are left transparent.
+        if (fNumberPasses > 1) {
+            const int height = fDstInfo.height();
+            fSrcRowBytes = fDstInfo.width() * SkSwizzler::BytesPerPixel(srcConfig);
+            fStorage.reset(fSrcRowBytes * height);
+            sk_bzero(fStorage.get(), fSrcRowBytes * height);
+            fRowFinished.setCount(height);
+            sk_bzero(fRowFinished.begin(), height * sizeof(bool));
+        }
+        png_start_read_image(fPng_ptr);
+    }
+
+    void onRow(png_bytep row, png_uint_32 y, int pass) {
+        // libpng passes NULL for the rows a pass leaves as they were.
+        if (NULL == row) {
+            return;
+        }
+        uint8_t* srcRow = row;
+        if (fNumberPasses > 1) {
+            srcRow = fStorage.get() + y * fSrcRowBytes;
+            png_progressive_combine_row(fPng_ptr, srcRow, row);
+        }
+        // An interlaced image's rows are swizzled again with each pass.
+        const bool opaque = SkSwizzler::IsOpaque(fSwizzler->next(srcRow, y));
+
+        if (fNumberPasses > 1) {
+            if (pass != last_pass_for_row(y, fDstInfo.width())) {
+                return;
+            }
+            fRowFinished[y] = true;
+            while (fRowsDecoded < fDstInfo.height() && fRowFinished[fRowsDecoded]) {
+                fRowsDecoded++;
+            }
+        } else {
+            fRowsDecoded = y + 1;
+        }
+        fReallyHasAlpha |= !opaque;
+    }
+
+    void onEnd() {
+        fRowsDecoded = fDstInfo.height();
+        fResult = SkCodec::kSuccess;
+        fCodec->fReallyHasAlpha = fReallyHasAlpha;
+    }
+
+    SkPngCodec*                 fCodec;     // Unowned.
+    const SkImageInfo           fDstInfo;
+    void*                       fDst;
+    const size_t                fRowBytes;
+    png_structp                 fPng_ptr;
+    png_infop                   fInfo_ptr;
+    SkAutoTUnref<SkColorTable>  fColorTable;
+    SkAutoTDelete<SkSwizzler>   fSwizzler;
+    int                         fNumberPasses;
+    size_t                      fSrcRowBytes;
+    SkAutoTMalloc<uint8_t>      fStorage;       // the whole image, if interlaced
+    SkTDArray<bool>             fRowFinished;   // rows which have had their last pass
+    int                         fRowsDecoded;
+    bool                        fReallyHasAlpha;
+    SkCodec::Result             fResult;
+};
+
+SkCodec::Result SkPngCodec::onStartIncrementalDecode(const SkImageInfo& dstInfo, void* dst,
+                                                     size_t rowBytes) {
+    if (!conversion_possible(dstInfo, this->getInfo())) {
+        return kInvalidConversion;
+    }
+    fIncrementalDecoder.reset(SkNEW_ARGS(SkPngIncrementalDecoder,
+                                         (this, dstInfo, dst, rowBytes)));
+    if (!fIncrementalDecoder->init()) {
+        fIncrementalDecoder.free();
+        return kInvalidInput;
+    }
+    return kSuccess;
+}
+
+SkCodec::Result SkPngCodec::onIncrementalDecode(const void* data, size_t length,
+                                                int* rowsDecoded) {
+    SkASSERT(fIncrementalDecoder);
+    return fIncrementalDecoder->decode(data, length, rowsDecoded);
+}
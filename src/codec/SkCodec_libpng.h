@@ -18,6 +18,7 @@
 #endif
 #include "png.h"
 
+class SkPngIncrementalDecoder;
 class SkScanlineDecoder;
 class SkStream;
 
@@ -31,6 +32,9 @@ protected:
             override;
     SkEncodedFormat onGetEncodedFormat() const override { return kPNG_SkEncodedFormat; }
     SkScanlineDecoder* onGetScanlineDecoder(const SkImageInfo& dstInfo) override;
+    Result onStartIncrementalDecode(const SkImageInfo& dstInfo, void* dst,
+                                    size_t rowBytes) override;
+    Result onIncrementalDecode(const void* data, size_t length, int* rowsDecoded) override;
     bool onReallyHasAlpha() const override { return fReallyHasAlpha; }
 private:
     png_structp                 fPng_ptr;
@@ -44,6 +48,8 @@ private:
     int                         fNumberPasses;
     bool                        fReallyHasAlpha;
 
+    SkAutoTDelete<SkPngIncrementalDecoder> fIncrementalDecoder;
+
     SkPngCodec(const SkImageInfo&, SkStream*, png_structp, png_infop);
     ~SkPngCodec();
 
@@ -56,6 +62,7 @@ private:
     void finish();
     void destroyReadStruct();
 
+    friend class SkPngIncrementalDecoder;
     friend class SkPngScanlineDecoder;
 
     typedef SkCodec INHERITED;
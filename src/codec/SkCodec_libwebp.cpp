@@ -0,0 +1,259 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCodec_libwebp.h"
+#include "SkCodecPriv.h"
+#include "SkRect.h"
+#include "SkStream.h"
+#include "SkTemplates.h"
+
+// A WebP decoder on top of (subset of) libwebp
+// For more information on WebP image format, and libwebp library, see:
+//   https://code.google.com/speed/webp/
+//   http://www.webmproject.org/code/#libwebp-webp-image-library
+//   https://chromium.googlesource.com/webm/libwebp
+
+extern "C" {
+// If moving libwebp out of skia source tree, path for webp headers must be
+// updated accordingly. Here, we enforce using local copy in webp sub-directory.
+#include "webp/decode.h"
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Creation
+///////////////////////////////////////////////////////////////////////////////
+
+bool SkWebpCodec::IsWebp(SkStream* stream) {
+    // WEBP starts with the following:
+    // RIFFXXXXWEBPVP
+    // Where XXXX is unspecified.
+    static const size_t kLength = 14;
+    char bytes[kLength];
+    if (stream->read(bytes, kLength) != kLength) {
+        return false;
+    }
+    return !memcmp(bytes, "RIFF", 4) && !memcmp(&bytes[8], "WEBPVP", 6);
+}
+
+static const size_t WEBP_VP8_HEADER_SIZE = 64;
+
+// Parses the headers of the RIFF container, and checks for valid WebP (VP8) content.
+static bool webp_parse_header(SkStream* stream, SkImageInfo* info) {
+    unsigned char buffer[WEBP_VP8_HEADER_SIZE];
+    const size_t bytesRead = stream->read(buffer, WEBP_VP8_HEADER_SIZE);
+
+    WebPBitstreamFeatures features;
+    if (VP8_STATUS_OK != WebPGetFeatures(buffer, bytesRead, &features)) {
+        return false;  // Invalid or truncated WebP file.
+    }
+
+    // sanity check for image size that's about to be decoded.
+    {
+        const int64_t size = sk_64_mul(features.width, features.height);
+        // now check that if we are 4-bytes per pixel, we also don't overflow
+        if (!sk_64_isS32(size) || sk_64_asS32(size) > (0x7FFFFFFF >> 2)) {
+            return false;
+        }
+    }
+
+    // libwebp decodes to unpremultiplied colors, premultiplying them if asked.
+    *info = SkImageInfo::MakeN32(features.width, features.height,
+                                 features.has_alpha ? kUnpremul_SkAlphaType
+                                                    : kOpaque_SkAlphaType);
+    return true;
+}
+
+SkCodec* SkWebpCodec::NewFromStream(SkStream* stream) {
+    SkAutoTDelete<SkStream> streamDeleter(stream);
+    SkImageInfo info;
+    if (!webp_parse_header(stream, &info)) {
+        return NULL;
+    }
+    // libwebp reads the headers again, so decoding starts from the beginning.
+    if (!stream->rewind()) {
+        return NULL;
+    }
+    return SkNEW_ARGS(SkWebpCodec, (info, streamDeleter.detach()));
+}
+
+SkWebpCodec::SkWebpCodec(const SkImageInfo& info, SkStream* stream)
+    : INHERITED(info, stream)
+{}
+
+///////////////////////////////////////////////////////////////////////////////
+// Scaling
+///////////////////////////////////////////////////////////////////////////////
+
+SkISize SkWebpCodec::onGetScaledDimensions(float desiredScale) const {
+    // libwebp scales to any size while decoding, so we can give exactly what was asked for.
+    const SkISize dim = this->getInfo().dimensions();
+    return SkISize::Make(SkTMax(1, SkScalarRoundToInt(desiredScale * dim.width())),
+                         SkTMax(1, SkScalarRoundToInt(desiredScale * dim.height())));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Getting the pixels
+///////////////////////////////////////////////////////////////////////////////
+
+static bool conversion_possible(const SkImageInfo& dst, const SkImageInfo& src) {
+    if (dst.profileType() != src.profileType()) {
+        return false;
+    }
+    switch (dst.colorType()) {
+        // Both N32 orders are supported, so that either is fine.
+        case kBGRA_8888_SkColorType:
+        case kRGBA_8888_SkColorType:
+            return kOpaque_SkAlphaType == src.alphaType() ||
+                   kOpaque_SkAlphaType != dst.alphaType();
+        case kRGB_565_SkColorType:
+            return kOpaque_SkAlphaType == src.alphaType();
+        default:
+            return false;
+    }
+}
+
+static WEBP_CSP_MODE webp_decode_mode(SkColorType ct, bool premultiply) {
+    switch (ct) {
+        case kBGRA_8888_SkColorType:
+            return premultiply ? MODE_bgrA : MODE_BGRA;
+        case kRGBA_8888_SkColorType:
+            return premultiply ? MODE_rgbA : MODE_RGBA;
+        case kRGB_565_SkColorType:
+            return MODE_RGB_565;
+        default:
+            return MODE_LAST;
+    }
+}
+
+// The amount of data to pass to libwebp at a time.
+static const size_t BUFFER_SIZE = 4096;
+
+SkCodec::Result SkWebpCodec::decode(const SkIRect& crop, const SkImageInfo& dstInfo,
+                                    void* dst, size_t rowBytes) {
+    if (kCouldNotRewind_RewindState == this->rewindIfNeeded()) {
+        return kCouldNotRewind;
+    }
+    if (!conversion_possible(dstInfo, this->getInfo())) {
+        return kInvalidConversion;
+    }
+
+    WebPDecoderConfig config;
+    if (0 == WebPInitDecoderConfig(&config)) {
+        // ABI mismatch.
+        // FIXME: New enum for this?
+        return kInvalidInput;
+    }
+
+    // Free any memory associated with the buffer. Must be called last, so we declare it first.
+    SkAutoTCallVProc<WebPDecBuffer, WebPFreeDecBuffer> autoFree(&(config.output));
+
+    // libwebp crops first, then scales what is left.
+    if (crop != SkIRect::MakeSize(this->getInfo().dimensions())) {
+        config.options.use_cropping = 1;
+        config.options.crop_left = crop.left();
+        config.options.crop_top = crop.top();
+        config.options.crop_width = crop.width();
+        config.options.crop_height = crop.height();
+    }
+    if (crop.size() != dstInfo.dimensions()) {
+        config.options.use_scaling = 1;
+        config.options.scaled_width = dstInfo.width();
+        config.options.scaled_height = dstInfo.height();
+    }
+    // Filter and convert each row on a second thread while the next is decoded.
+    config.options.use_threads = 1;
+
+    config.output.colorspace = webp_decode_mode(dstInfo.colorType(),
+                                                kPremul_SkAlphaType == dstInfo.alphaType());
+    config.output.u.RGBA.rgba = static_cast<uint8_t*>(dst);
+    config.output.u.RGBA.stride = SkToInt(rowBytes);
+    config.output.u.RGBA.size = dstInfo.getSafeSize(rowBytes);
+    config.output.is_external_memory = 1;
+
+    SkAutoTCallVProc<WebPIDecoder, WebPIDelete> idec(WebPIDecode(NULL, 0, &config));
+    if (!idec) {
+        return kInvalidInput;
+    }
+
+    SkAutoMalloc storage(BUFFER_SIZE);
+    uint8_t* buffer = static_cast<uint8_t*>(storage.get());
+    for (;;) {
+        const size_t bytesRead = this->stream()->read(buffer, BUFFER_SIZE);
+        if (0 == bytesRead) {
+            // Clear the rows libwebp didn't get to, so they aren't left uninitialized.
+            int lastY = 0;
+            if (!WebPIDecGetRGB(idec, &lastY, NULL, NULL, NULL)) {
+                lastY = 0;
+            }
+            for (int y = lastY; y < dstInfo.height(); y++) {
+                sk_bzero(SkTAddOffset<void>(dst, y * rowBytes), dstInfo.minRowBytes());
+            }
+            return kIncompleteInput;
+        }
+
+        switch (WebPIAppend(idec, buffer, bytesRead)) {
+            case VP8_STATUS_OK:
+                return kSuccess;
+            case VP8_STATUS_SUSPENDED:
+                // More data is needed.
+                break;
+            default:
+                return kInvalidInput;
+        }
+    }
+}
+
+SkCodec::Result SkWebpCodec::onGetPixels(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
+                                         const Options&, SkPMColor*, int*) {
+    return this->decode(SkIRect::MakeSize(this->getInfo().dimensions()), dstInfo, dst,
+                        rowBytes);
+}
+
+SkCodec::Result SkWebpCodec::onGetSubsetPixels(const SkISize& scaledSize, const SkIRect& subset,
+                                               const SkImageInfo& dstInfo, void* dst,
+                                               size_t rowBytes) {
+    const SkISize size = this->getInfo().dimensions();
+    if (scaledSize == size) {
+        // libwebp rounds the crop origin down to even, so it can't start on an odd pixel.
+        // Decode from the even pixel before and copy the subset out.
+        if (0 == ((subset.left() | subset.top()) & 1)) {
+            return this->decode(subset, dstInfo, dst, rowBytes);
+        }
+        const SkIRect crop = SkIRect::MakeLTRB(subset.left() & ~1, subset.top() & ~1,
+                                               subset.right(), subset.bottom());
+        const SkImageInfo cropInfo = dstInfo.makeWH(crop.width(), crop.height());
+        const size_t cropRowBytes = cropInfo.minRowBytes();
+        SkAutoMalloc storage(cropInfo.getSafeSize(cropRowBytes));
+        const Result result = this->decode(crop, cropInfo, storage.get(), cropRowBytes);
+        if (kSuccess != result && kIncompleteInput != result) {
+            return result;
+        }
+        const int bpp = dstInfo.bytesPerPixel();
+        const uint8_t* src = SkTAddOffset<const uint8_t>(
+                storage.get(), (subset.top() - crop.top()) * cropRowBytes
+                               + (subset.left() - crop.left()) * bpp);
+        for (int y = 0; y < dstInfo.height(); y++) {
+            memcpy(SkTAddOffset<void>(dst, y * rowBytes), src + y * cropRowBytes,
+                   dstInfo.minRowBytes());
+        }
+        return result;
+    }
+
+    // Find the part of the unscaled image that scales to subset, widened to start on an even
+    // pixel for libwebp.
+    const float sx = (float)size.width()  / scaledSize.width();
+    const float sy = (float)size.height() / scaledSize.height();
+    SkIRect crop;
+    SkRect::MakeLTRB(subset.left() * sx, subset.top() * sy,
+                     subset.right() * sx, subset.bottom() * sy).roundOut(&crop);
+    crop.fLeft &= ~1;
+    crop.fTop &= ~1;
+    if (!crop.intersect(SkIRect::MakeSize(size))) {
+        return kInvalidParameters;
+    }
+    return this->decode(crop, dstInfo, dst, rowBytes);
+}
@@ -0,0 +1,59 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkCodec_libwebp_DEFINED
+#define SkCodec_libwebp_DEFINED
+
+#include "SkCodec.h"
+#include "SkEncodedFormat.h"
+#include "SkImageInfo.h"
+
+class SkStream;
+
+/*
+ *
+ * This class implements the decoding for WebP images
+ *
+ * libwebp scales to any size as part of decoding, and crops before it scales,
+ * so both are left to it. Its filtering runs on a second thread. libwebp only
+ * crops from even coordinates, so an unscaled subset starting on an odd pixel
+ * is decoded from the even pixel before it and copied out. A subset of a
+ * scaled image is the matching part of the unscaled image, widened to start
+ * on an even pixel, scaled to the size of the subset, so it may differ
+ * slightly from those pixels of the whole scaled image.
+ *
+ */
+class SkWebpCodec final : public SkCodec {
+public:
+    // Assumes IsWebp was called and returned true.
+    static SkCodec* NewFromStream(SkStream*);
+    static bool IsWebp(SkStream*);
+
+protected:
+    Result onGetPixels(const SkImageInfo&, void*, size_t, const Options&, SkPMColor*, int*)
+            override;
+
+    SkEncodedFormat onGetEncodedFormat() const override { return kWEBP_SkEncodedFormat; }
+
+    SkISize onGetScaledDimensions(float desiredScale) const override;
+
+    Result onGetSubsetPixels(const SkISize& scaledSize, const SkIRect& subset,
+                             const SkImageInfo& dstInfo, void* dst, size_t rowBytes) override;
+
+private:
+    SkWebpCodec(const SkImageInfo&, SkStream*);
+
+    /*
+     * Rewinds the stream and decodes the part of the image inside crop, scaled
+     * to the dimensions of dstInfo.
+     */
+    Result decode(const SkIRect& crop, const SkImageInfo& dstInfo, void* dst, size_t rowBytes);
+
+    typedef SkCodec INHERITED;
+};
+
+#endif  // SkCodec_libwebp_DEFINED
@@ -0,0 +1,262 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkColorPriv.h"
+#include "SkFrameHolder.h"
+#include "SkTDArray.h"
+
+// Composited frames, keyframes and the last frame asked for alike, stop being kept once they
+// take more memory than this.
+static const size_t kMaxKeptBytes = 32 * 1024 * 1024;
+
+SkFrameHolder::SkFrameHolder(const SkISize& canvasSize, Decoder* decoder)
+    : fCanvasSize(canvasSize)
+    , fDecoder(decoder)
+    , fLastIndex(SkCodec::kNone_RequiredFrame)
+    , fKeptBytes(0)
+{}
+
+/*
+ * Which frame's result the canvas must hold before a frame with this rect and alpha can be
+ * drawn, if it is added next.
+ */
+int SkFrameHolder::findRequiredFrame(const SkIRect& rect, bool hasAlpha) const {
+    const SkIRect canvasRect = SkIRect::MakeSize(fCanvasSize);
+    if (fFrames.empty() || (rect == canvasRect && !hasAlpha)) {
+        return SkCodec::kNone_RequiredFrame;
+    }
+
+    // A frame disposed of with kRestorePrevious leaves the canvas as the frame before it did.
+    int prev = fFrames.count() - 1;
+    while (SkCodec::kRestorePrevious_DisposalMethod == fFrames[prev].fInfo.fDisposalMethod) {
+        if (0 == prev) {
+            return SkCodec::kNone_RequiredFrame;
+        }
+        prev--;
+    }
+
+    const SkCodec::FrameInfo& prevInfo = fFrames[prev].fInfo;
+    if (SkCodec::kRestoreBGColor_DisposalMethod == prevInfo.fDisposalMethod) {
+        // Clearing the previous frame clears the whole canvas if it covered all of it, or if
+        // it was drawn onto a clear canvas in the first place.
+        if (prevInfo.fRect == canvasRect ||
+            SkCodec::kNone_RequiredFrame == prevInfo.fRequiredFrame) {
+            return SkCodec::kNone_RequiredFrame;
+        }
+    }
+    return prev;
+}
+
+void SkFrameHolder::appendFrame(const SkIRect& rect, int duration,
+                                SkCodec::DisposalMethod disposalMethod, bool hasAlpha) {
+    SkIRect clipped = rect;
+    if (!clipped.intersect(SkIRect::MakeSize(fCanvasSize))) {
+        clipped.setEmpty();
+    }
+    const int requiredFrame = this->findRequiredFrame(clipped, hasAlpha);
+
+    Frame& frame = fFrames.push_back();
+    frame.fInfo.fRect = clipped;
+    frame.fInfo.fDuration = duration;
+    frame.fInfo.fDisposalMethod = disposalMethod;
+    frame.fInfo.fRequiredFrame = requiredFrame;
+    frame.fHasAlpha = hasAlpha;
+    frame.fDecoded = false;
+    frame.fComplete = false;
+}
+
+void SkFrameHolder::DecodeAhead(AheadTask* task) {
+    task->fHolder->decode(task->fIndex);
+}
+
+void SkFrameHolder::decode(int index) {
+    Frame& frame = fFrames[index];
+    if (frame.fDecoded) {
+        return;
+    }
+    const SkIRect& rect = frame.fInfo.fRect;
+    frame.fComplete = true;
+    if (!rect.isEmpty()) {
+        const size_t count = rect.width() * rect.height();
+        frame.fPixels.reset(count);
+        sk_bzero(frame.fPixels.get(), count * sizeof(SkPMColor));
+        frame.fComplete = fDecoder->decodeFrame(index, rect, frame.fPixels.get(),
+                                                rect.width() * sizeof(SkPMColor));
+    }
+    frame.fDecoded = true;
+}
+
+void SkFrameHolder::freePixels(int index) {
+    Frame& frame = fFrames[index];
+    sk_free(frame.fPixels.detach());
+    frame.fDecoded = false;
+}
+
+void SkFrameHolder::draw(int index, SkPMColor* dst, size_t rowBytes) const {
+    const Frame& frame = fFrames[index];
+    SkASSERT(frame.fDecoded);
+    const SkIRect& rect = frame.fInfo.fRect;
+    const SkPMColor* src = frame.fPixels.get();
+    for (int y = rect.fTop; y < rect.fBottom; y++) {
+        SkPMColor* dstRow = SkTAddOffset<SkPMColor>(dst, y * rowBytes) + rect.fLeft;
+        if (!frame.fHasAlpha) {
+            memcpy(dstRow, src, rect.width() * sizeof(SkPMColor));
+        } else {
+            for (int x = 0; x < rect.width(); x++) {
+                const SkPMColor c = src[x];
+                if (0xFF == SkGetPackedA32(c)) {
+                    dstRow[x] = c;
+                } else if (0 != c) {
+                    dstRow[x] = SkPMSrcOver(c, dstRow[x]);
+                }
+            }
+        }
+        src += rect.width();
+    }
+}
+
+void SkFrameHolder::dispose(int index, SkPMColor* dst, size_t rowBytes) const {
+    const SkCodec::FrameInfo& info = fFrames[index].fInfo;
+    // Frames required by others are never disposed of with kRestorePrevious.
+    SkASSERT(SkCodec::kRestorePrevious_DisposalMethod != info.fDisposalMethod);
+    if (SkCodec::kRestoreBGColor_DisposalMethod == info.fDisposalMethod) {
+        // Like the browsers, the background color is treated as transparent.
+        for (int y = info.fRect.fTop; y < info.fRect.fBottom; y++) {
+            sk_bzero(SkTAddOffset<SkPMColor>(dst, y * rowBytes) + info.fRect.fLeft,
+                     info.fRect.width() * sizeof(SkPMColor));
+        }
+    }
+}
+
+void SkFrameHolder::keep(int index, const SkPMColor* src, size_t rowBytes) {
+    SkBitmap& bm = fFrames[index].fComposited;
+    if (!bm.isNull()) {
+        return;
+    }
+    bm.allocN32Pixels(fCanvasSize.width(), fCanvasSize.height());
+    for (int y = 0; y < fCanvasSize.height(); y++) {
+        memcpy(bm.getAddr32(0, y), SkTAddOffset<const SkPMColor>(src, y * rowBytes),
+               fCanvasSize.width() * sizeof(SkPMColor));
+    }
+    fKeptBytes += bm.getSize();
+}
+
+void SkFrameHolder::release(int index) {
+    SkBitmap& bm = fFrames[index].fComposited;
+    fKeptBytes -= bm.getSize();
+    bm.reset();
+}
+
+SkCodec::Result SkFrameHolder::getFrame(int index, SkPMColor* dst, size_t rowBytes) {
+    SkASSERT(index >= 0 && index < fFrames.count());
+
+    // Decodes still running ahead write into fFrames, so let them finish.
+    fDecodeAhead.wait();
+
+    // Walk back through the frames index depends on, to one that is kept or needs none.
+    SkTDArray<int> chain;
+    int start = index;
+    while (SkCodec::kNone_RequiredFrame != start && fFrames[start].fComposited.isNull()) {
+        chain.push(start);
+        start = fFrames[start].fInfo.fRequiredFrame;
+    }
+
+    // Their pixels don't depend on each other, so decode them all at once.
+    sk_parallel_for(chain.count(), 1, [&](int i) {
+        this->decode(chain[i]);
+    });
+
+    if (SkCodec::kNone_RequiredFrame == start) {
+        for (int y = 0; y < fCanvasSize.height(); y++) {
+            sk_bzero(SkTAddOffset<SkPMColor>(dst, y * rowBytes),
+                     fCanvasSize.width() * sizeof(SkPMColor));
+        }
+    } else {
+        const SkBitmap& kept = fFrames[start].fComposited;
+        for (int y = 0; y < fCanvasSize.height(); y++) {
+            memcpy(SkTAddOffset<SkPMColor>(dst, y * rowBytes), kept.getAddr32(0, y),
+                   fCanvasSize.width() * sizeof(SkPMColor));
+        }
+    }
+
+    // Now draw them from the earliest, each over the one it requires.
+    bool complete = true;
+    int prev = start;
+    for (int i = chain.count() - 1; i >= 0; i--) {
+        const int current = chain[i];
+        Frame& frame = fFrames[current];
+        if (SkCodec::kNone_RequiredFrame != prev) {
+            this->dispose(prev, dst, rowBytes);
+        }
+        this->draw(current, dst, rowBytes);
+        complete &= frame.fComplete;
+        this->freePixels(current);
+
+        // A truncated frame is not worth keeping, nor is anything drawn over it.
+        if (complete && current != index && 0 == current % kKeyframeInterval &&
+                fKeptBytes < kMaxKeptBytes) {
+            this->keep(current, dst, rowBytes);
+        }
+        prev = current;
+    }
+
+    // Keep this frame too, as the next one asked for most likely requires it. A keyframe stays
+    // kept; any other frame is only kept until the next is asked for, so fLastIndex is only set
+    // for those.
+    if (fLastIndex != index) {
+        if (SkCodec::kNone_RequiredFrame != fLastIndex) {
+            this->release(fLastIndex);
+            fLastIndex = SkCodec::kNone_RequiredFrame;
+        }
+        if (complete && fFrames[index].fComposited.isNull() && fKeptBytes < kMaxKeptBytes) {
+            this->keep(index, dst, rowBytes);
+            if (0 != index % kKeyframeInterval) {
+                fLastIndex = index;
+            }
+        }
+    }
+
+    // Start on the frames after this one. Any decoded ahead earlier that are not among them
+    // are dropped; those that are, and are decoded already, needn't be again.
+    const int aheadEnd = SkTMin(index + 1 + kDecodeAhead, fFrames.count());
+    SkTDArray<int> ahead;
+    for (int i = 0; i < fAhead.count(); i++) {
+        const int frame = fAhead[i];
+        if (!fFrames[frame].fDecoded) {
+            continue;   // drawn since, which freed its pixels
+        }
+        if (frame <= index || frame >= aheadEnd) {
+            this->freePixels(frame);
+        } else {
+            ahead.push(frame);
+        }
+    }
+    fAheadTasks.reset();
+    for (int i = index + 1; i < aheadEnd; i++) {
+        if (!fFrames[i].fDecoded && fFrames[i].fComposited.isNull()) {
+            AheadTask& task = fAheadTasks.push_back();
+            task.fHolder = this;
+            task.fIndex = i;
+            ahead.push(i);
+        }
+    }
+    fAhead.swap(ahead);
+    for (int i = 0; i < fAheadTasks.count(); i++) {
+        fDecodeAhead.add(DecodeAhead, &fAheadTasks[i]);
+    }
+
+    return complete ? SkCodec::kSuccess : SkCodec::kIncompleteInput;
+}
+
+int SkFrameHolder::decodedFrameCount() {
+    fDecodeAhead.wait();
+    int count = 0;
+    for (int i = 0; i < fFrames.count(); i++) {
+        count += fFrames[i].fDecoded;
+    }
+    return count;
+}
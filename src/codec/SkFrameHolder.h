@@ -0,0 +1,128 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkFrameHolder_DEFINED
+#define SkFrameHolder_DEFINED
+
+#include "SkBitmap.h"
+#include "SkCodec.h"
+#include "SkTArray.h"
+#include "SkTDArray.h"
+#include "SkTaskGroup.h"
+#include "SkTemplates.h"
+
+/**
+ *  Composites the frames of an animation for SkCodec::getFrame(), on behalf of a codec that can
+ *  decode any single frame's own pixels on its own.
+ *
+ *  The frames a requested frame depends on are found from their disposal methods. Every
+ *  kKeyframeInterval'th composited frame is kept, as is the last one asked for, all within a
+ *  memory budget, so reaching any frame only means drawing the frames since the nearest of those
+ *  rather than all of them from the start. The frames still to be drawn are decoded in
+ *  parallel, and after each request the next few frames are decoded ahead on an SkTaskGroup.
+ */
+class SkFrameHolder : SkNoncopyable {
+public:
+    /**
+     *  Decodes the pixels of a single frame, without regard to any other frame. decodeFrame()
+     *  is called from several threads at once, for different frames.
+     */
+    class Decoder : SkNoncopyable {
+    public:
+        virtual ~Decoder() {}
+
+        /**
+         *  Decode the pixels of frame index that lie inside rect (the frame's fRect) into dst,
+         *  as premultiplied N32, leaving any it has no data for transparent. dst has been
+         *  cleared to transparent. Returns false if the data ran out part way.
+         */
+        virtual bool decodeFrame(int index, const SkIRect& rect, SkPMColor* dst,
+                                 size_t rowBytes) const = 0;
+    };
+
+    // How often composited frames are kept, so seeking draws at most this many frames.
+    static const int kKeyframeInterval = 8;
+
+    // How many frames past the last one requested are decoded in the background.
+    static const int kDecodeAhead = 2;
+
+    /**
+     *  Takes ownership of decoder.
+     */
+    SkFrameHolder(const SkISize& canvasSize, Decoder* decoder);
+
+    /**
+     *  Add the next frame. rect is clipped to the canvas. hasAlpha says whether the frame can
+     *  have pixels that are not opaque. Works out the frame's fRequiredFrame.
+     */
+    void appendFrame(const SkIRect& rect, int duration, SkCodec::DisposalMethod,
+                     bool hasAlpha);
+
+    int count() const { return fFrames.count(); }
+
+    const SkCodec::FrameInfo& frameInfo(int index) const { return fFrames[index].fInfo; }
+
+    /**
+     *  Composite frame index into dst, which is the size of the canvas and premultiplied N32.
+     *  Returns kIncompleteInput if some frame it needed was truncated.
+     */
+    SkCodec::Result getFrame(int index, SkPMColor* dst, size_t rowBytes);
+
+    /** Bytes of composited frames being kept. */
+    size_t keptBytes() const { return fKeptBytes; }
+
+    /** How many frames hold their own decoded pixels, once the decodes ahead have finished. */
+    int decodedFrameCount();
+
+private:
+    struct Frame {
+        SkCodec::FrameInfo       fInfo;
+        bool                     fHasAlpha;
+        // The canvas with this frame drawn, if it is being kept.
+        SkBitmap                 fComposited;
+        // This frame's own pixels, fInfo.fRect sized, between decode() and draw().
+        SkAutoTMalloc<SkPMColor> fPixels;
+        bool                     fDecoded;
+        bool                     fComplete;
+    };
+
+    struct AheadTask {
+        SkFrameHolder* fHolder;
+        int            fIndex;
+    };
+
+    static void DecodeAhead(AheadTask*);
+
+    int findRequiredFrame(const SkIRect& rect, bool hasAlpha) const;
+
+    // Decodes frame index into its fPixels, unless that has been done already.
+    void decode(int index);
+    void freePixels(int index);
+
+    // Draws frame index, decoded, over the canvas in dst.
+    void draw(int index, SkPMColor* dst, size_t rowBytes) const;
+
+    // Applies the disposal of frame index, which was the last drawn, to the canvas in dst.
+    void dispose(int index, SkPMColor* dst, size_t rowBytes) const;
+
+    // Keeps a copy of the canvas in src, which has frame index drawn last.
+    void keep(int index, const SkPMColor* src, size_t rowBytes);
+    void release(int index);
+
+    const SkISize                 fCanvasSize;
+    SkAutoTDelete<Decoder>        fDecoder;
+    SkTArray<Frame, true>         fFrames;
+    int                           fLastIndex;
+    size_t                        fKeptBytes;
+    // Frames decoded, or being decoded, ahead of the last one asked for, and not drawn yet.
+    SkTDArray<int>                fAhead;
+    SkTArray<AheadTask, true>     fAheadTasks;
+    // Declared last, so it is destroyed first, waiting for the decodes it is running.
+    SkTaskGroup                   fDecodeAhead;
+};
+
+#endif  // SkFrameHolder_DEFINED
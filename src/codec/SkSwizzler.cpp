@@ -8,6 +8,7 @@
 #include "SkCodecPriv.h"
 #include "SkColorPriv.h"
 #include "SkSwizzler.h"
+#include "SkSwizzler_opts.h"
 #include "SkTemplates.h"
 
 SkSwizzler::ResultAlpha SkSwizzler::GetResult(uint8_t zeroAlpha,
@@ -115,6 +116,30 @@ static SkSwizzler::ResultAlpha swizzle_index_to_565(
 
 #undef A32_MASK_IN_PLACE
 
+// kGray
+
+static SkSwizzler::ResultAlpha swizzle_gray_to_n32(
+        void* SK_RESTRICT dstRow, const uint8_t* SK_RESTRICT src, int width,
+        int bytesPerPixel, int y, const SkPMColor ctable[]) {
+
+    SkPMColor* SK_RESTRICT dst = (SkPMColor*)dstRow;
+    for (int x = 0; x < width; x++) {
+        dst[x] = SkPackARGB32NoCheck(0xFF, src[x], src[x], src[x]);
+    }
+    return SkSwizzler::kOpaque_ResultAlpha;
+}
+
+static SkSwizzler::ResultAlpha swizzle_gray_to_565(
+        void* SK_RESTRICT dstRow, const uint8_t* SK_RESTRICT src, int width,
+        int bytesPerPixel, int y, const SkPMColor ctable[]) {
+
+    uint16_t* SK_RESTRICT dst = (uint16_t*)dstRow;
+    for (int x = 0; x < width; x++) {
+        dst[x] = SkPack888ToRGB16(src[x], src[x], src[x]);
+    }
+    return SkSwizzler::kOpaque_ResultAlpha;
+}
+
 static SkSwizzler::ResultAlpha swizzle_bgrx_to_n32(
         void* SK_RESTRICT dstRow, const uint8_t* SK_RESTRICT src, int width,
         int bytesPerPixel, int y, const SkPMColor ctable[]) {
@@ -171,6 +196,18 @@ static SkSwizzler::ResultAlpha swizzle_bgra_to_n32_premul(
     return COMPUTE_RESULT_ALPHA;
 }
 
+static SkSwizzler::ResultAlpha swizzle_rgbx_to_565(
+        void* SK_RESTRICT dstRow, const uint8_t* SK_RESTRICT src, int width,
+        int bytesPerPixel, int y, const SkPMColor ctable[]) {
+
+    uint16_t* SK_RESTRICT dst = (uint16_t*)dstRow;
+    for (int x = 0; x < width; x++) {
+        dst[x] = SkPack888ToRGB16(src[0], src[1], src[2]);
+        src += bytesPerPixel;
+    }
+    return SkSwizzler::kOpaque_ResultAlpha;
+}
+
 // n32
 static SkSwizzler::ResultAlpha swizzle_rgbx_to_n32(
         void* SK_RESTRICT dstRow, const uint8_t* SK_RESTRICT src, int width,
@@ -258,6 +295,48 @@ static bool swizzle_rgba_to_n32_unpremul_skipZ(void* SK_RESTRICT dstRow,
 }
 */
 
+/*
+ * Picks the SIMD swizzle that does the same job as the portable proc chosen for sc,
+ * returning false if there is none. Writing zeroes defeats kYes_ZeroInitialized, so the
+ * skipZ procs are left alone.
+ */
+static bool platform_proc_type(SkSwizzler::SrcConfig sc, const SkImageInfo& info,
+                               SkImageGenerator::ZeroInitialized zeroInit,
+                               SkSwizzleProcType* type) {
+    if (kN32_SkColorType != info.colorType()) {
+        return false;
+    }
+    // Matches the portable choices above: anything but kUnpremul is premultiplied.
+    const bool premul = kUnpremul_SkAlphaType != info.alphaType();
+    switch (sc) {
+        case SkSwizzler::kRGB:
+            *type = kRGB_To_N32_SkSwizzleProcType;
+            return true;
+        case SkSwizzler::kBGR:
+            *type = kBGR_To_N32_SkSwizzleProcType;
+            return true;
+        case SkSwizzler::kRGBX:
+            *type = kRGBX_To_N32_SkSwizzleProcType;
+            return true;
+        case SkSwizzler::kBGRX:
+            *type = kBGRX_To_N32_SkSwizzleProcType;
+            return true;
+        case SkSwizzler::kRGBA:
+            if (premul && SkImageGenerator::kYes_ZeroInitialized == zeroInit) {
+                return false;
+            }
+            *type = premul ? kRGBA_To_N32_Premul_SkSwizzleProcType
+                           : kRGBA_To_N32_Unpremul_SkSwizzleProcType;
+            return true;
+        case SkSwizzler::kBGRA:
+            *type = premul ? kBGRA_To_N32_Premul_SkSwizzleProcType
+                           : kBGRA_To_N32_Unpremul_SkSwizzleProcType;
+            return true;
+        default:
+            return false;
+    }
+}
+
 SkSwizzler* SkSwizzler::CreateSwizzler(SkSwizzler::SrcConfig sc,
                                        const SkPMColor* ctable,
                                        const SkImageInfo& info, void* dst,
@@ -275,6 +354,18 @@ SkSwizzler* SkSwizzler::CreateSwizzler(SkSwizzler::SrcConfig sc,
     }
     RowProc proc = NULL;
     switch (sc) {
+        case kGray:
+            switch (info.colorType()) {
+                case kN32_SkColorType:
+                    proc = &swizzle_gray_to_n32;
+                    break;
+                case kRGB_565_SkColorType:
+                    proc = &swizzle_gray_to_565;
+                    break;
+                default:
+                    break;
+            }
+            break;
         case kIndex1:
         case kIndex2:
         case kIndex4:
@@ -345,6 +436,9 @@ SkSwizzler* SkSwizzler::CreateSwizzler(SkSwizzler::SrcConfig sc,
                 case kN32_SkColorType:
                     proc = &swizzle_rgbx_to_n32;
                     break;
+                case kRGB_565_SkColorType:
+                    proc = &swizzle_rgbx_to_565;
+                    break;
                 default:
                     break;
             }
@@ -372,6 +466,9 @@ SkSwizzler* SkSwizzler::CreateSwizzler(SkSwizzler::SrcConfig sc,
                 case kN32_SkColorType:
                     proc = &swizzle_rgbx_to_n32;
                     break;
+                case kRGB_565_SkColorType:
+                    proc = &swizzle_rgbx_to_565;
+                    break;
                 default:
                     break;
             }
@@ -382,6 +479,12 @@ SkSwizzler* SkSwizzler::CreateSwizzler(SkSwizzler::SrcConfig sc,
     if (NULL == proc) {
         return NULL;
     }
+    SkSwizzleProcType type;
+    if (platform_proc_type(sc, info, zeroInit, &type)) {
+        if (SkSwizzleRowProc platformProc = SkSwizzleGetPlatformProc(type)) {
+            proc = platformProc;
+        }
+    }
 
     // Store deltaSrc in bytes if it is an even multiple, otherwise use bits
     int deltaSrc = SkIsAlign8(BitsPerPixel(sc)) ? BytesPerPixel(sc) :
@@ -6,9 +6,20 @@
  */
 
 #include "SkBBHFactory.h"
+#include "SkIncrementalRTree.h"
 #include "SkRTree.h"
 
 SkBBoxHierarchy* SkRTreeFactory::operator()(const SkRect& bounds) const {
     SkScalar aspectRatio = bounds.width() / bounds.height();
     return SkNEW_ARGS(SkRTree, (aspectRatio));
 }
+
+SkBBoxHierarchy* SkHilbertRTreeFactory::operator()(const SkRect& bounds) const {
+    SkScalar aspectRatio = bounds.width() / bounds.height();
+    return SkNEW_ARGS(SkRTree, (aspectRatio, SkRTree::kHilbert_BulkLoad));
+}
+
+SkBBoxHierarchy* SkIncrementalRTreeFactory::operator()(const SkRect& bounds) const {
+    SkScalar aspectRatio = bounds.width() / bounds.height();
+    return SkNEW_ARGS(SkIncrementalRTree, (aspectRatio));
+}
@@ -1240,11 +1240,18 @@ bool SkBitmap::ReadRawPixels(SkReadBuffer* buffer, SkBitmap* bitmap) {
         return false;
     }
 
-    SkAutoDataUnref data(SkData::NewUninitialized(SkToSizeT(ramSize)));
-    char* dst = (char*)data->writable_data();
-    buffer->readByteArray(dst, SkToSizeT(snugSize));
+    SkAutoDataUnref data;
+    if (snugSize == ramSize) {
+        // If the buffer is backed by an SkData, this can share its pixels instead of copying.
+        data.reset(buffer->readByteArrayAsData());
+        if (!buffer->validate(data->size() == ramSize)) {
+            return false;
+        }
+    } else {
+        data.reset(SkData::NewUninitialized(SkToSizeT(ramSize)));
+        char* dst = (char*)data->writable_data();
+        buffer->readByteArray(dst, SkToSizeT(snugSize));
 
-    if (snugSize != ramSize) {
         const char* srcRow = dst + snugRB * (height - 1);
         char* dstRow = dst + ramRB * (height - 1);
         for (int y = height - 1; y >= 1; --y) {
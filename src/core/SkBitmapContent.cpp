@@ -0,0 +1,91 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBitmapContent.h"
+#include "SkChecksum.h"
+#include "SkColorTable.h"
+
+bool SkBitmapContentHash::Compute(const SkBitmap& bitmap, SkBitmapContentHash* hash) {
+    if (bitmap.getTexture() || kUnknown_SkColorType == bitmap.colorType()) {
+        return false;
+    }
+    SkAutoLockPixels alp(bitmap);
+    if (NULL == bitmap.getPixels()) {
+        return false;
+    }
+    const uint32_t header[] = {
+        (uint32_t)bitmap.width(), (uint32_t)bitmap.height(),
+        (uint32_t)bitmap.colorType(), (uint32_t)bitmap.alphaType(),
+    };
+    // One hash runs through all the rows; the other mixes in a hash of each row on its own.
+    uint32_t murmur = SkChecksum::Murmur3(header, sizeof(header));
+    uint32_t mashed = SkChecksum::Mix(murmur);
+    const size_t rowBytes = bitmap.info().minRowBytes();
+    for (int y = 0; y < bitmap.height(); y++) {
+        const void* row = bitmap.getAddr(0, y);
+        murmur = SkChecksum::Murmur3(row, rowBytes, murmur);
+        mashed = SkChecksum::Mix(mashed ^ SkChecksum::Murmur3(row, rowBytes));
+    }
+    if (const SkColorTable* table = bitmap.getColorTable()) {
+        const size_t tableBytes = table->count() * sizeof(SkPMColor);
+        murmur = SkChecksum::Murmur3(table->readColors(), tableBytes, murmur);
+        mashed = SkChecksum::Mix(mashed ^ SkChecksum::Murmur3(table->readColors(), tableBytes));
+    }
+    hash->fHash[0] = murmur;
+    hash->fHash[1] = mashed;
+    return true;
+}
+
+static unsigned gBitmapContentKeyNamespaceLabel;
+
+SkBitmapContentKey::SkBitmapContentKey(const SkBitmapContentHash& hash) : fHash(hash) {
+    this->init(&gBitmapContentKeyNamespaceLabel, 0, sizeof(fHash));
+}
+
+SkBitmapContentRec::SkBitmapContentRec(const SkBitmapContentHash& hash, const SkBitmap& copy)
+    : fKey(hash)
+    , fCopy(copy) {
+    SkASSERT(copy.isImmutable());
+}
+
+bool SkBitmapContentRec::Finder(const SkResourceCache::Rec& baseRec, void* context) {
+    const SkBitmapContentRec& rec = static_cast<const SkBitmapContentRec&>(baseRec);
+    *(SkBitmap*)context = rec.fCopy;
+    return true;
+}
+
+bool SkBitmapContentRec::Copy(const SkBitmap& bitmap, SkBitmap* copy) {
+    if (!bitmap.copyTo(copy, bitmap.colorType())) {
+        return false;
+    }
+    copy->setImmutable();
+    return true;
+}
+
+bool SkBitmapContentRec::Matches(const SkBitmap& copy, const SkBitmap& bitmap) {
+    if (copy.info() != bitmap.info()) {
+        return false;
+    }
+    SkAutoLockPixels lockCopy(copy), lockBitmap(bitmap);
+    if (NULL == copy.getPixels() || NULL == bitmap.getPixels()) {
+        return false;
+    }
+    const size_t rowBytes = copy.info().minRowBytes();
+    for (int y = 0; y < copy.height(); y++) {
+        if (memcmp(copy.getAddr(0, y), bitmap.getAddr(0, y), rowBytes)) {
+            return false;
+        }
+    }
+    const SkColorTable* ctCopy = copy.getColorTable();
+    const SkColorTable* ctBitmap = bitmap.getColorTable();
+    if (NULL == ctCopy || NULL == ctBitmap) {
+        return ctCopy == ctBitmap;
+    }
+    return ctCopy->count() == ctBitmap->count() &&
+           0 == memcmp(ctCopy->readColors(), ctBitmap->readColors(),
+                       ctCopy->count() * sizeof(SkPMColor));
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkBitmapContent_DEFINED
+#define SkBitmapContent_DEFINED
+
+#include "SkBitmap.h"
+#include "SkResourceCache.h"
+
+/**
+ *  For SkResourceCache entries keyed on what a bitmap holds, rather than on its generation ID.
+ */
+
+/**
+ *  Two independent 32-bit hashes of a bitmap's pixels, seeded with its dimensions and types, and
+ *  including its color table, if any.
+ */
+struct SkBitmapContentHash {
+    uint32_t fHash[2];
+
+    /**
+     *  Returns false, leaving hash alone, if the pixels can't be read: a texture, an unknown color
+     *  type, or pixels that fail to lock.
+     */
+    static bool Compute(const SkBitmap&, SkBitmapContentHash* hash);
+
+    bool operator==(const SkBitmapContentHash& other) const {
+        return fHash[0] == other.fHash[0] && fHash[1] == other.fHash[1];
+    }
+};
+
+struct SkBitmapContentKey : public SkResourceCache::Key {
+public:
+    SkBitmapContentKey(const SkBitmapContentHash&);
+
+    SkBitmapContentHash fHash;
+};
+
+/**
+ *  A private, immutable copy of a bitmap, cached under its content hash. Entries keyed on that
+ *  hash check hits against it, so one copy serves them all rather than each keeping its own.
+ */
+class SkBitmapContentRec : public SkResourceCache::Rec {
+public:
+    /** copy must come from Copy(). */
+    SkBitmapContentRec(const SkBitmapContentHash&, const SkBitmap& copy);
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return sizeof(*this) + fCopy.getSize(); }
+
+    /**
+     *  A FindVisitor that sets the SkBitmap pointed to by context to the copy. It only copies the
+     *  entry out; checking it with Matches() is left until after the lookup, since locking pixels
+     *  under the cache's lock could re-enter it.
+     */
+    static bool Finder(const SkResourceCache::Rec&, void* context);
+
+    /**
+     *  Makes the immutable copy of bitmap to cache. Returns false if it can't be copied.
+     */
+    static bool Copy(const SkBitmap& bitmap, SkBitmap* copy);
+
+    /**
+     *  Whether bitmap holds the same pixels, and colors, as copy, found by Finder().
+     */
+    static bool Matches(const SkBitmap& copy, const SkBitmap& bitmap);
+
+private:
+    SkBitmapContentKey  fKey;
+    SkBitmap            fCopy;
+};
+
+#endif
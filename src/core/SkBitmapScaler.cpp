@@ -4,6 +4,8 @@
 #include "SkTArray.h"
 #include "SkErrorInternals.h"
 #include "SkConvolver.h"
+#include "SkScanlineDecoder.h"
+#include "SkTaskGroup.h"
 
 // SkResizeFilter ----------------------------------------------------------------
 
@@ -241,45 +243,55 @@ static SkBitmapScaler::ResizeMethod ResizeMethodToAlgorithmMethod(
     }
 }
 
-// static
-bool SkBitmapScaler::Resize(SkBitmap* resultPtr,
-                            const SkBitmap& source,
-                            ResizeMethod method,
-                            float destWidth, float destHeight,
-                            SkBitmap::Allocator* allocator) {
-
-  SkConvolutionProcs convolveProcs= { 0, NULL, NULL, NULL, NULL };
-  PlatformConvolutionProcs(&convolveProcs);
-
-  SkRect destSubset = { 0, 0, destWidth, destHeight };
-
+// Checks the arguments common to all the Resize() variants, picks the
+// algorithm, and allocates the result. Returns false if there's nothing to do.
+static bool prepare_resize(const SkImageInfo& sourceInfo,
+                           SkBitmapScaler::ResizeMethod* method,
+                           float destWidth, float destHeight,
+                           SkBitmap::Allocator* allocator,
+                           SkBitmap* result) {
   // Ensure that the ResizeMethod enumeration is sound.
-  SkASSERT(((RESIZE_FIRST_QUALITY_METHOD <= method) &&
-      (method <= RESIZE_LAST_QUALITY_METHOD)) ||
-      ((RESIZE_FIRST_ALGORITHM_METHOD <= method) &&
-      (method <= RESIZE_LAST_ALGORITHM_METHOD)));
+  SkASSERT(((SkBitmapScaler::RESIZE_FIRST_QUALITY_METHOD <= *method) &&
+      (*method <= SkBitmapScaler::RESIZE_LAST_QUALITY_METHOD)) ||
+      ((SkBitmapScaler::RESIZE_FIRST_ALGORITHM_METHOD <= *method) &&
+      (*method <= SkBitmapScaler::RESIZE_LAST_ALGORITHM_METHOD)));
 
   // If the size of source or destination is 0, i.e. 0x0, 0xN or Nx0, just
   // return empty.
-  if (source.width() < 1 || source.height() < 1 ||
+  if (sourceInfo.width() < 1 || sourceInfo.height() < 1 ||
       destWidth < 1 || destHeight < 1) {
       // todo: seems like we could handle negative dstWidth/Height, since that
       // is just a negative scale (flip)
       return false;
   }
 
-  method = ResizeMethodToAlgorithmMethod(method);
+  *method = ResizeMethodToAlgorithmMethod(*method);
 
   // Check that we deal with an "algorithm methods" from this point onward.
-  SkASSERT((SkBitmapScaler::RESIZE_FIRST_ALGORITHM_METHOD <= method) &&
-      (method <= SkBitmapScaler::RESIZE_LAST_ALGORITHM_METHOD));
+  SkASSERT((SkBitmapScaler::RESIZE_FIRST_ALGORITHM_METHOD <= *method) &&
+      (*method <= SkBitmapScaler::RESIZE_LAST_ALGORITHM_METHOD));
 
-  SkAutoLockPixels locker(source);
-  if (!source.readyToDraw() ||
-      source.colorType() != kN32_SkColorType) {
+  if (sourceInfo.colorType() != kN32_SkColorType) {
       return false;
   }
 
+  result->setInfo(SkImageInfo::MakeN32(SkScalarCeilToInt(destWidth),
+                                       SkScalarCeilToInt(destHeight),
+                                       sourceInfo.alphaType()));
+  result->allocPixels(allocator, NULL);
+  return result->readyToDraw();
+}
+
+// Resizes source into result, which prepare_resize() has set up.  If inParallel,
+// the output is split into bands of rows that are convolved on SkTaskGroup's
+// threads.  Each band re-convolves the few source rows it shares with its
+// neighbors, so bands should be much taller than the filter.
+static void resize_bitmap(SkBitmap* result, const SkBitmap& source,
+                          SkBitmapScaler::ResizeMethod method,
+                          float destWidth, float destHeight,
+                          const SkConvolutionProcs& convolveProcs,
+                          bool inParallel) {
+  SkRect destSubset = { 0, 0, destWidth, destHeight };
   SkResizeFilter filter(method, source.width(), source.height(),
                         destWidth, destHeight, destSubset, convolveProcs);
 
@@ -288,22 +300,167 @@ bool SkBitmapScaler::Resize(SkBitmap* resultPtr,
   // referring to the old data.
   const unsigned char* sourceSubset =
       reinterpret_cast<const unsigned char*>(source.getPixels());
+  const int sourceRowBytes = static_cast<int>(source.rowBytes());
+  const bool sourceHasAlpha = !source.isOpaque();
+
+  const int outputRowBytes = static_cast<int>(result->rowBytes());
+  unsigned char* output = static_cast<unsigned char*>(result->getPixels());
+
+  static const int kMinRowsPerBand = 32;
+  const int rows = result->height();
+  const int bands = inParallel ? SkTMax(1, rows / kMinRowsPerBand) : 1;
+  if (1 == bands) {
+      BGRAConvolve2D(sourceSubset, sourceRowBytes, sourceHasAlpha,
+          filter.xFilter(), filter.yFilter(), outputRowBytes, output,
+          convolveProcs, true);
+      return;
+  }
+
+  sk_parallel_for(bands, 1, [&](int band) {
+      // Spread the rows as evenly as we can.
+      const int startY = static_cast<int>((int64_t)rows * band / bands),
+                endY   = static_cast<int>((int64_t)rows * (band + 1) / bands);
+      SkConvolutionMemoryRowSource rowSource(sourceSubset, sourceRowBytes);
+      BGRAConvolve2DRows(&rowSource, sourceHasAlpha,
+          filter.xFilter(), filter.yFilter(), startY, endY,
+          outputRowBytes, output, convolveProcs, true);
+  });
+}
+
+// static
+bool SkBitmapScaler::Resize(SkBitmap* resultPtr,
+                            const SkBitmap& source,
+                            ResizeMethod method,
+                            float destWidth, float destHeight,
+                            SkBitmap::Allocator* allocator) {
+
+  SkConvolutionProcs convolveProcs= { 0, NULL, NULL, NULL, NULL };
+  PlatformConvolutionProcs(&convolveProcs);
+
+  SkAutoLockPixels locker(source);
+  if (!source.readyToDraw()) {
+      return false;
+  }
 
   // Convolve into the result.
   SkBitmap result;
-  result.setInfo(SkImageInfo::MakeN32(SkScalarCeilToInt(destSubset.width()),
-                                      SkScalarCeilToInt(destSubset.height()),
-                                      source.alphaType()));
-  result.allocPixels(allocator, NULL);
-  if (!result.readyToDraw()) {
+  if (!prepare_resize(source.info(), &method, destWidth, destHeight, allocator,
+                      &result)) {
       return false;
   }
+  resize_bitmap(&result, source, method, destWidth, destHeight, convolveProcs,
+                false);
+
+  *resultPtr = result;
+  resultPtr->lockPixels();
+  SkASSERT(resultPtr->getPixels());
+  return true;
+}
 
-  BGRAConvolve2D(sourceSubset, static_cast<int>(source.rowBytes()),
-      !source.isOpaque(), filter.xFilter(), filter.yFilter(),
-      static_cast<int>(result.rowBytes()),
-      static_cast<unsigned char*>(result.getPixels()),
-      convolveProcs, true);
+// static
+bool SkBitmapScaler::ResizeInParallel(SkBitmap* resultPtr,
+                                      const SkBitmap& source,
+                                      ResizeMethod method,
+                                      float destWidth, float destHeight,
+                                      SkBitmap::Allocator* allocator) {
+
+  SkConvolutionProcs convolveProcs= { 0, NULL, NULL, NULL, NULL };
+  PlatformConvolutionProcs(&convolveProcs);
+
+  SkAutoLockPixels locker(source);
+  if (!source.readyToDraw()) {
+      return false;
+  }
+
+  SkBitmap result;
+  if (!prepare_resize(source.info(), &method, destWidth, destHeight, allocator,
+                      &result)) {
+      return false;
+  }
+  resize_bitmap(&result, source, method, destWidth, destHeight, convolveProcs,
+                true);
+
+  *resultPtr = result;
+  resultPtr->lockPixels();
+  SkASSERT(resultPtr->getPixels());
+  return true;
+}
+
+namespace {
+
+// Reads the rows BGRAConvolve2DRows() asks for from a scanline decoder, keeping
+// only the last four around.
+class ScanlineRowSource : public SkConvolutionRowSource {
+public:
+    ScanlineRowSource(SkScanlineDecoder* decoder, int width, int extraReads)
+        // The SIMD convolvers may read a few pixels past the end of each row.
+        : fDecoder(decoder)
+        , fRowBytes((width + extraReads) * 4)
+        , fStorage(kRows * fRowBytes)
+        , fNextY(0) {
+        sk_bzero(fStorage.get(), kRows * fRowBytes);
+    }
+
+    const unsigned char* row(int y) override {
+        SkASSERT(y >= fNextY);
+        if (y > fNextY && !ok(fDecoder->skipScanlines(y - fNextY))) {
+            return NULL;
+        }
+        unsigned char* row = fStorage.get() + (y % kRows) * fRowBytes;
+        if (!ok(fDecoder->getScanlines(row, 1, fRowBytes))) {
+            return NULL;
+        }
+        fNextY = y + 1;
+        return row;
+    }
+
+private:
+    static const int kRows = 4;
+
+    static bool ok(SkImageGenerator::Result result) {
+        return SkImageGenerator::kSuccess == result ||
+               SkImageGenerator::kIncompleteInput == result;
+    }
+
+    SkScanlineDecoder*           fDecoder;
+    const size_t                 fRowBytes;
+    SkAutoTMalloc<unsigned char> fStorage;
+    int                          fNextY;
+};
+
+}  // namespace
+
+// static
+bool SkBitmapScaler::Resize(SkBitmap* resultPtr,
+                            SkScanlineDecoder* decoder,
+                            const SkImageInfo& sourceInfo,
+                            ResizeMethod method,
+                            float destWidth, float destHeight,
+                            SkBitmap::Allocator* allocator) {
+
+  SkConvolutionProcs convolveProcs= { 0, NULL, NULL, NULL, NULL };
+  PlatformConvolutionProcs(&convolveProcs);
+
+  SkBitmap result;
+  if (!decoder ||
+      !prepare_resize(sourceInfo, &method, destWidth, destHeight, allocator,
+                      &result)) {
+      return false;
+  }
+
+  SkRect destSubset = { 0, 0, destWidth, destHeight };
+  SkResizeFilter filter(method, sourceInfo.width(), sourceInfo.height(),
+                        destWidth, destHeight, destSubset, convolveProcs);
+
+  ScanlineRowSource source(decoder, sourceInfo.width(),
+                           convolveProcs.fExtraHorizontalReads);
+  if (!BGRAConvolve2DRows(&source, !sourceInfo.isOpaque(),
+          filter.xFilter(), filter.yFilter(), 0, result.height(),
+          static_cast<int>(result.rowBytes()),
+          static_cast<unsigned char*>(result.getPixels()),
+          convolveProcs, true)) {
+      return false;
+  }
 
   *resultPtr = result;
   resultPtr->lockPixels();
@@ -11,6 +11,8 @@
 #include "SkBitmap.h"
 #include "SkConvolver.h"
 
+class SkScanlineDecoder;
+
 /** \class SkBitmapScaler
 
     Provides the interface for high quality image resampling.
@@ -90,6 +92,28 @@ public:
                            float dest_width, float dest_height,
                            SkBitmap::Allocator* allocator = NULL);
 
+    /** Like Resize(), but splits the output into bands of rows that are
+        convolved in parallel on SkTaskGroup's threads.
+      */
+    static bool ResizeInParallel(SkBitmap* result,
+                                 const SkBitmap& source,
+                                 ResizeMethod method,
+                                 float dest_width, float dest_height,
+                                 SkBitmap::Allocator* allocator = NULL);
+
+    /** Resizes an image pulled one row at a time from decoder, which must
+        have been created to decode N32 pixels with sourceInfo's dimensions
+        and alpha type, and not yet read from. Only a few more source rows
+        than the filter is tall are ever held at once, so very large images
+        can be downscaled in little memory.
+      */
+    static bool Resize(SkBitmap* result,
+                       SkScanlineDecoder* decoder,
+                       const SkImageInfo& sourceInfo,
+                       ResizeMethod method,
+                       float dest_width, float dest_height,
+                       SkBitmap::Allocator* allocator = NULL);
+
      /** Platforms can also optionally overwrite the convolution functions
         if we have SIMD versions of them.
       */
@@ -834,6 +834,12 @@ static XferInterp interpret_xfermode(const SkPaint& paint, SkXfermode* xfer,
     return kNormal_XferInterp;
 }
 
+// The 8-bit procs for the Porter-Duff modes are faster than blending in floats, but those for
+// Darken and Lighten do a divide per channel, and lose to SkRasterPipeline.
+static bool prefers_raster_pipeline(SkXfermode::Mode mode) {
+    return SkXfermode::kDarken_Mode == mode || SkXfermode::kLighten_Mode == mode;
+}
+
 SkBlitter* SkBlitter::Choose(const SkBitmap& device,
                              const SkMatrix& matrix,
                              const SkPaint& origPaint,
@@ -906,7 +912,26 @@ SkBlitter* SkBlitter::Choose(const SkBitmap& device,
         }
     }
 
-    if (cf) {
+    // The shader's colors can stay in floats through the color filter and the xfermode, packing
+    // once at the end, when the xfermode has a native SkPMFloat version and the color filter (if
+    // any) is a color matrix. The float blitters then run the color matrix themselves.
+    // kSrcOver_Mode (no xfermode) is left to the 8-bit blit row procs, which are faster.
+    const bool canUseFloats = kN32_SkColorType == device.colorType() && shader && mode &&
+                              NULL == shader3D;
+    SkPMFloatColorMatrix colorMatrix;
+    const bool floatColorFilter = canUseFloats &&
+                                  (NULL == cf || SkPMFloatColorMatrix::Init(cf, &colorMatrix));
+    const SkPMFloatXferProc xferProc = floatColorFilter ? SkPMFloatXferProcFor(mode) : NULL;
+    const bool usePMFloat = SkToBool(xferProc);
+
+    // Otherwise, the modes that blend faster in floats get a pipeline of float stages built for
+    // them.
+    SkXfermode::Mode pipelineMode = SkXfermode::kSrcOver_Mode;
+    const bool usePipeline = !usePMFloat && floatColorFilter && mode->asMode(&pipelineMode) &&
+                             prefers_raster_pipeline(pipelineMode) &&
+                             SkRasterPipeline::CanBlend(pipelineMode);
+
+    if (cf && !usePMFloat && !usePipeline) {
         SkASSERT(shader);
         shader = SkNEW_ARGS(SkFilterShader, (shader, cf));
         paint.writable()->setShader(shader)->unref();
@@ -955,7 +980,13 @@ SkBlitter* SkBlitter::Choose(const SkBitmap& device,
             break;
 
         case kN32_SkColorType:
-            if (shader) {
+            if (usePMFloat) {
+                blitter = allocator->createT<SkARGB32_PMFloat_Shader_Blitter>(
+                        device, *paint, shaderContext, xferProc, cf ? &colorMatrix : NULL);
+            } else if (usePipeline) {
+                blitter = allocator->createT<SkARGB32_RasterPipeline_Blitter>(
+                        device, *paint, shaderContext, cf ? &colorMatrix : NULL, pipelineMode);
+            } else if (shader) {
                 blitter = allocator->createT<SkARGB32_Shader_Blitter>(
                         device, *paint, shaderContext);
             } else if (paint->getColor() == SK_ColorBLACK) {
@@ -7,6 +7,7 @@
 
 #include "SkCoreBlitters.h"
 #include "SkColorPriv.h"
+#include "SkPMFloat.h"
 #include "SkShader.h"
 #include "SkUtils.h"
 #include "SkXfermode.h"
@@ -633,3 +634,312 @@ void SkARGB32_Shader_Blitter::blitV(int x, int y, int height, SkAlpha alpha) {
         }
     }
 }
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Shades the span as SkPMColors, a chunk at a time, and unpacks them.
+static void shade_span_pmfloat(SkShader::Context* shaderContext, int x, int y, SkPMFloat dst[],
+                               int count) {
+    SkPMColor colors[64];
+    while (count > 0) {
+        const int n = SkTMin(count, (int)SK_ARRAY_COUNT(colors));
+        shaderContext->shadeSpan(x, y, colors, n);
+        SkPMFloat::FromPMColors(colors, dst, n);
+        x += n;
+        dst += n;
+        count -= n;
+    }
+}
+
+SkARGB32_PMFloat_Shader_Blitter::SkARGB32_PMFloat_Shader_Blitter(const SkBitmap& device,
+        const SkPaint& paint, SkShader::Context* shaderContext, SkPMFloatXferProc xferProc,
+        const SkPMFloatColorMatrix* colorMatrix)
+    : INHERITED(device, paint, shaderContext)
+    , fXferProc(xferProc)
+    , fHasColorMatrix(SkToBool(colorMatrix))
+{
+    SkASSERT(fXferProc);
+    if (colorMatrix) {
+        fColorMatrix = *colorMatrix;
+    }
+
+    // SkPMFloat wants 16 byte alignment, which malloc doesn't promise everywhere.
+    fStorage = sk_malloc_throw((device.width() + 1) * sizeof(SkPMFloat));
+    fBuffer = (SkPMFloat*)(((uintptr_t)fStorage + 15) & ~(uintptr_t)15);
+
+    fConstInY = SkToBool(shaderContext->getFlags() & SkShader::kConstInY32_Flag);
+}
+
+SkARGB32_PMFloat_Shader_Blitter::~SkARGB32_PMFloat_Shader_Blitter() {
+    sk_free(fStorage);
+}
+
+void SkARGB32_PMFloat_Shader_Blitter::shade(int x, int y, int width) {
+    shade_span_pmfloat(fShaderContext, x, y, fBuffer, width);
+    if (fHasColorMatrix) {
+        fColorMatrix.filterSpan(fBuffer, width, fBuffer);
+    }
+}
+
+void SkARGB32_PMFloat_Shader_Blitter::blitH(int x, int y, int width) {
+    SkASSERT(x >= 0 && y >= 0 && x + width <= fDevice.width());
+
+    this->shade(x, y, width);
+    fXferProc(fDevice.getAddr32(x, y), fBuffer, width, NULL);
+}
+
+void SkARGB32_PMFloat_Shader_Blitter::blitRect(int x, int y, int width, int height) {
+    SkASSERT(x >= 0 && y >= 0 &&
+             x + width <= fDevice.width() && y + height <= fDevice.height());
+
+    uint32_t*   device = fDevice.getAddr32(x, y);
+    size_t      deviceRB = fDevice.rowBytes();
+
+    if (fConstInY) {
+        this->shade(x, y, width);
+    }
+    do {
+        if (!fConstInY) {
+            this->shade(x, y, width);
+        }
+        fXferProc(device, fBuffer, width, NULL);
+        y += 1;
+        device = (uint32_t*)((char*)device + deviceRB);
+    } while (--height > 0);
+}
+
+void SkARGB32_PMFloat_Shader_Blitter::blitAntiH(int x, int y, const SkAlpha antialias[],
+                                                const int16_t runs[]) {
+    uint32_t*   device = fDevice.getAddr32(x, y);
+
+    for (;;) {
+        int count = *runs;
+        if (count <= 0) {
+            break;
+        }
+        int aa = *antialias;
+        if (aa) {
+            this->shade(x, y, count);
+            if (aa == 255) {
+                fXferProc(device, fBuffer, count, NULL);
+            } else {
+                // count is almost always 1
+                for (int i = count - 1; i >= 0; --i) {
+                    fXferProc(&device[i], &fBuffer[i], 1, antialias);
+                }
+            }
+        }
+        device += count;
+        runs += count;
+        antialias += count;
+        x += count;
+    }
+}
+
+void SkARGB32_PMFloat_Shader_Blitter::blitMask(const SkMask& mask, const SkIRect& clip) {
+    if (SkMask::kA8_Format != mask.fFormat) {
+        this->INHERITED::blitMask(mask, clip);
+        return;
+    }
+
+    SkASSERT(mask.fBounds.contains(clip));
+
+    const int x = clip.fLeft;
+    const int width = clip.width();
+    int y = clip.fTop;
+    int height = clip.height();
+
+    char* dstRow = (char*)fDevice.getAddr32(x, y);
+    const size_t dstRB = fDevice.rowBytes();
+    const uint8_t* maskRow = (const uint8_t*)mask.getAddr(x, y);
+    const size_t maskRB = mask.fRowBytes;
+
+    do {
+        this->shade(x, y, width);
+        fXferProc((SkPMColor*)dstRow, fBuffer, width, maskRow);
+        dstRow += dstRB;
+        maskRow += maskRB;
+        y += 1;
+    } while (--height > 0);
+}
+
+void SkARGB32_PMFloat_Shader_Blitter::blitV(int x, int y, int height, SkAlpha alpha) {
+    SkASSERT(x >= 0 && y >= 0 && y + height <= fDevice.height());
+
+    uint32_t*   device = fDevice.getAddr32(x, y);
+    size_t      deviceRB = fDevice.rowBytes();
+    const SkAlpha* aa = (255 == alpha) ? NULL : &alpha;
+
+    if (fConstInY) {
+        this->shade(x, y, 1);
+    }
+    do {
+        if (!fConstInY) {
+            this->shade(x, y, 1);
+        }
+        fXferProc(device, fBuffer, 1, aa);
+        y += 1;
+        device = (uint32_t*)((char*)device + deviceRB);
+    } while (--height > 0);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+SkARGB32_RasterPipeline_Blitter::SkARGB32_RasterPipeline_Blitter(const SkBitmap& device,
+        const SkPaint& paint, SkShader::Context* shaderContext,
+        const SkPMFloatColorMatrix* colorMatrix, SkXfermode::Mode mode)
+    : INHERITED(device, paint, shaderContext)
+    , fHasColorMatrix(SkToBool(colorMatrix))
+    , fDst(NULL)
+    , fCoverage(NULL)
+    , fConstantCoverage(0)
+{
+    if (colorMatrix) {
+        fColorMatrix = *colorMatrix;
+    }
+
+    // SkPMFloat wants 16 byte alignment, which malloc doesn't promise everywhere.
+    fStorage = sk_malloc_throw((device.width() + 1) * sizeof(SkPMFloat));
+    fBuffer = (SkPMFloat*)(((uintptr_t)fStorage + 15) & ~(uintptr_t)15);
+    fConstInY = SkToBool(shaderContext->getFlags() & SkShader::kConstInY32_Flag);
+
+    // A color shader (as for paints without a shader) is shaded and filtered once, here.
+    fConstantSrc = SkShader::kColor_GradientType == fShader->asAGradient(NULL);
+    SkRasterPipeline body;
+    if (fConstantSrc) {
+        shade_span_pmfloat(shaderContext, 0, 0, fBuffer, 1);
+        if (fHasColorMatrix) {
+            fColorMatrix.filterSpan(fBuffer, 1, fBuffer);
+        }
+        body.append(SkRasterPipeline::kConstantSrc_StockStage, fBuffer);
+    } else {
+        body.append(SkRasterPipeline::kLoadSrc_StockStage, fBuffer);
+        if (fHasColorMatrix) {
+            body.append(SkRasterPipeline::kColorMatrix_StockStage, &fColorMatrix);
+        }
+    }
+    body.append(SkRasterPipeline::kLoadDst_StockStage, &fDst);
+    SkAssertResult(body.appendBlend(mode));
+
+    fOpaque.extend(body);
+    fLerpU8.extend(body);
+    fLerpU8.append(SkRasterPipeline::kLerpU8_StockStage, &fCoverage);
+    fLerpConstant.extend(body);
+    fLerpConstant.append(SkRasterPipeline::kLerpConstant_StockStage, &fConstantCoverage);
+
+    fOpaque.append(SkRasterPipeline::kStore_StockStage, &fDst);
+    fLerpU8.append(SkRasterPipeline::kStore_StockStage, &fDst);
+    fLerpConstant.append(SkRasterPipeline::kStore_StockStage, &fDst);
+}
+
+SkARGB32_RasterPipeline_Blitter::~SkARGB32_RasterPipeline_Blitter() {
+    sk_free(fStorage);
+}
+
+void SkARGB32_RasterPipeline_Blitter::shade(int x, int y, int width) {
+    if (!fConstantSrc) {
+        shade_span_pmfloat(fShaderContext, x, y, fBuffer, width);
+    }
+}
+
+void SkARGB32_RasterPipeline_Blitter::blitH(int x, int y, int width) {
+    SkASSERT(x >= 0 && y >= 0 && x + width <= fDevice.width());
+
+    this->shade(x, y, width);
+    fDst = fDevice.getAddr32(x, y);
+    fOpaque.run(width);
+}
+
+void SkARGB32_RasterPipeline_Blitter::blitRect(int x, int y, int width, int height) {
+    SkASSERT(x >= 0 && y >= 0 &&
+             x + width <= fDevice.width() && y + height <= fDevice.height());
+
+    fDst = fDevice.getAddr32(x, y);
+    const size_t deviceRB = fDevice.rowBytes();
+
+    if (fConstInY) {
+        this->shade(x, y, width);
+    }
+    do {
+        if (!fConstInY) {
+            this->shade(x, y, width);
+        }
+        fOpaque.run(width);
+        y += 1;
+        fDst = (SkPMColor*)((char*)fDst + deviceRB);
+    } while (--height > 0);
+}
+
+void SkARGB32_RasterPipeline_Blitter::blitAntiH(int x, int y, const SkAlpha antialias[],
+                                                const int16_t runs[]) {
+    fDst = fDevice.getAddr32(x, y);
+
+    for (;;) {
+        int count = *runs;
+        if (count <= 0) {
+            break;
+        }
+        int aa = *antialias;
+        if (aa) {
+            this->shade(x, y, count);
+            if (aa == 255) {
+                fOpaque.run(count);
+            } else {
+                fConstantCoverage = aa * (1.0f / 255);
+                fLerpConstant.run(count);
+            }
+        }
+        fDst += count;
+        runs += count;
+        antialias += count;
+        x += count;
+    }
+}
+
+void SkARGB32_RasterPipeline_Blitter::blitMask(const SkMask& mask, const SkIRect& clip) {
+    if (SkMask::kA8_Format != mask.fFormat) {
+        this->INHERITED::blitMask(mask, clip);
+        return;
+    }
+
+    SkASSERT(mask.fBounds.contains(clip));
+
+    const int x = clip.fLeft;
+    const int width = clip.width();
+    int y = clip.fTop;
+    int height = clip.height();
+
+    fDst = fDevice.getAddr32(x, y);
+    const size_t deviceRB = fDevice.rowBytes();
+    fCoverage = (const uint8_t*)mask.getAddr(x, y);
+    const size_t maskRB = mask.fRowBytes;
+
+    do {
+        this->shade(x, y, width);
+        fLerpU8.run(width);
+        fDst = (SkPMColor*)((char*)fDst + deviceRB);
+        fCoverage += maskRB;
+        y += 1;
+    } while (--height > 0);
+}
+
+void SkARGB32_RasterPipeline_Blitter::blitV(int x, int y, int height, SkAlpha alpha) {
+    SkASSERT(x >= 0 && y >= 0 && y + height <= fDevice.height());
+
+    fDst = fDevice.getAddr32(x, y);
+    const size_t deviceRB = fDevice.rowBytes();
+    const SkRasterPipeline& pipeline = (255 == alpha) ? fOpaque : fLerpConstant;
+    fConstantCoverage = alpha * (1.0f / 255);
+
+    if (fConstInY) {
+        this->shade(x, y, 1);
+    }
+    do {
+        if (!fConstInY) {
+            this->shade(x, y, 1);
+        }
+        pipeline.run(1);
+        y += 1;
+        fDst = (SkPMColor*)((char*)fDst + deviceRB);
+    } while (--height > 0);
+}
@@ -15,6 +15,7 @@
 #include "SkDrawLooper.h"
 #include "SkErrorInternals.h"
 #include "SkImage.h"
+#include "SkImageFilterBands.h"
 #include "SkMetaData.h"
 #include "SkPathOps.h"
 #include "SkPatchUtils.h"
@@ -24,6 +25,7 @@
 #include "SkRRect.h"
 #include "SkSmallAllocator.h"
 #include "SkSurface_Base.h"
+#include "SkTaskGroup.h"
 #include "SkTemplates.h"
 #include "SkTextBlob.h"
 #include "SkTextFormatParams.h"
@@ -111,6 +113,9 @@ struct DeviceCM {
     DeviceCM*           fNext;
     SkBaseDevice*       fDevice;
     SkRasterClip        fClip;
+    // When fClip is limited to a tile, the clip it would have otherwise.
+    SkRasterClip        fEdgeClip;
+    bool                fTiled;
     const SkMatrix*     fMatrix;
     SkPaint*            fPaint; // may be null (in the future)
 
@@ -118,6 +123,8 @@ struct DeviceCM {
              bool conservativeRasterClip)
         : fNext(NULL)
         , fClip(conservativeRasterClip)
+        , fEdgeClip(conservativeRasterClip)
+        , fTiled(false)
     {
         if (NULL != device) {
             device->ref();
@@ -143,7 +150,8 @@ struct DeviceCM {
     }
 
     void updateMC(const SkMatrix& totalMatrix, const SkRasterClip& totalClip,
-                  const SkClipStack& clipStack, SkRasterClip* updateClip) {
+                  const SkClipStack& clipStack, SkRasterClip* updateClip,
+                  const SkIRect* tileBounds) {
         int x = fDevice->getOrigin().x();
         int y = fDevice->getOrigin().y();
         int width = fDevice->width();
@@ -163,6 +171,12 @@ struct DeviceCM {
 
         fClip.op(SkIRect::MakeWH(width, height), SkRegion::kIntersect_Op);
 
+        fTiled = SkToBool(tileBounds);
+        if (fTiled) {
+            fEdgeClip = fClip;
+            fClip.op(tileBounds->makeOffset(-x, -y), SkRegion::kIntersect_Op);
+        }
+
         // intersect clip, but don't translate it (yet)
 
         if (updateClip) {
@@ -250,6 +264,8 @@ public:
         canvas->updateDeviceCMCache();
 
         fClipStack = canvas->fClipStack;
+        fScanFlags = canvas->fScanFlags;
+        fEdgeRC    = NULL;
         fCurrLayer = canvas->fMCRec->fTopLayer;
         fSkipEmptyClips = skipEmptyClips;
     }
@@ -268,6 +284,7 @@ public:
             fMatrix = rec->fMatrix;
             fClip   = &((SkRasterClip*)&rec->fClip)->forceGetBW();
             fRC     = &rec->fClip;
+            fEdgeRC = rec->fTiled ? &rec->fEdgeClip : NULL;
             fDevice = rec->fDevice;
             fBitmap = &fDevice->accessBitmap(true);
             fPaint  = rec->fPaint;
@@ -459,6 +476,8 @@ SkBaseDevice* SkCanvas::init(SkBaseDevice* device, InitFlags flags) {
     fCachedLocalClipBoundsDirty = true;
     fAllowSoftClip = true;
     fAllowSimplifyClip = false;
+    fScanFlags = 0;
+    fTiled = false;
     fDeviceCMDirty = true;
     fSaveCount = 1;
     fMetaData = NULL;
@@ -768,12 +787,27 @@ void SkCanvas::updateDeviceCMCache() {
         const SkRasterClip& totalClip = fMCRec->fRasterClip;
         DeviceCM*       layer = fMCRec->fTopLayer;
 
+        const SkIRect* tileBounds = fTiled ? &fTileBounds : NULL;
         if (NULL == layer->fNext) {   // only one layer
-            layer->updateMC(totalMatrix, totalClip, *fClipStack, NULL);
+            layer->updateMC(totalMatrix, totalClip, *fClipStack, NULL, tileBounds);
         } else {
+            // A layer's pixels outside the tile are only needed if an image filter, on it or on
+            // a layer it is drawn into, reads them.
+            const DeviceCM* lastFiltered = NULL;
+            for (const DeviceCM* l = layer; fTiled && l; l = l->fNext) {
+                if (l->fPaint && l->fPaint->getImageFilter()) {
+                    lastFiltered = l;
+                }
+            }
+            bool filtered = SkToBool(lastFiltered);
             SkRasterClip clip(totalClip);
             do {
-                layer->updateMC(totalMatrix, clip, *fClipStack, &clip);
+                const bool wholeLayer = filtered && layer->fNext;
+                layer->updateMC(totalMatrix, clip, *fClipStack, &clip,
+                                wholeLayer ? NULL : tileBounds);
+                if (layer == lastFiltered) {
+                    filtered = false;
+                }
             } while ((layer = layer->fNext) != NULL);
         }
         fDeviceCMDirty = false;
@@ -1135,6 +1169,48 @@ void SkCanvas::internalDrawBitmap(const SkBitmap& bitmap,
     LOOPER_END
 }
 
+// Only the part of the result visible through the device's clip is computed, pulling through
+// the filter DAG just the regions that part depends on, when every filter in the DAG supports
+// that. Otherwise the whole layer is filtered, as some filter may read beyond what it declares.
+void SkCanvas::internalDrawFilteredSprite(const SkDraw& iter, SkBaseDevice* device,
+                                          const SkBitmap& src, const SkIPoint& pos,
+                                          const SkPaint& paint) {
+    const SkImageFilter* filter = paint.getImageFilter();
+    SkDeviceImageFilterProxy proxy(device, fProps);
+    SkMatrix matrix = *iter.fMatrix;
+    matrix.postTranslate(SkIntToScalar(-pos.x()), SkIntToScalar(-pos.y()));
+    SkIRect clipBounds = src.bounds();
+    if (filter->canFilterPartially()) {
+        clipBounds = iter.fRC->getBounds();
+        clipBounds.offset(-pos.x(), -pos.y());
+    }
+    SkAutoTUnref<SkImageFilter::Cache> cache(device->getImageFilterCache());
+    SkImageFilter::Context ctx(matrix, clipBounds, cache.get());
+    SkPaint tmpUnfiltered(paint);
+    tmpUnfiltered.setImageFilter(NULL);
+
+    const int bands = SkImageFilterBandCount(filter, &proxy, ctx, SkTaskGroup::ThreadCount());
+    if (1 == bands) {
+        SkBitmap dst;
+        SkIPoint offset = SkIPoint::Make(0, 0);
+        if (filter->filterImage(&proxy, src, ctx, &dst, &offset)) {
+            device->drawSprite(iter, dst, pos.x() + offset.x(), pos.y() + offset.y(),
+                               tmpUnfiltered);
+        }
+        return;
+    }
+
+    SkAutoTArray<SkBitmap> results(bands);
+    SkAutoTArray<SkIPoint> offsets(bands);
+    SkImageFilterBands(filter, &proxy, src, ctx, bands, results.get(), offsets.get());
+    for (int i = 0; i < bands; i++) {
+        if (!results[i].isNull()) {
+            device->drawSprite(iter, results[i], pos.x() + offsets[i].x(),
+                               pos.y() + offsets[i].y(), tmpUnfiltered);
+        }
+    }
+}
+
 void SkCanvas::internalDrawDevice(SkBaseDevice* srcDev, int x, int y,
                                   const SkPaint* paint) {
     SkPaint tmp;
@@ -1149,21 +1225,8 @@ void SkCanvas::internalDrawDevice(SkBaseDevice* srcDev, int x, int y,
         SkImageFilter* filter = paint->getImageFilter();
         SkIPoint pos = { x - iter.getX(), y - iter.getY() };
         if (filter && !dstDev->canHandleImageFilter(filter)) {
-            SkDeviceImageFilterProxy proxy(dstDev, fProps);
-            SkBitmap dst;
-            SkIPoint offset = SkIPoint::Make(0, 0);
-            const SkBitmap& src = srcDev->accessBitmap(false);
-            SkMatrix matrix = *iter.fMatrix;
-            matrix.postTranslate(SkIntToScalar(-pos.x()), SkIntToScalar(-pos.y()));
-            SkIRect clipBounds = SkIRect::MakeWH(srcDev->width(), srcDev->height());
-            SkAutoTUnref<SkImageFilter::Cache> cache(dstDev->getImageFilterCache());
-            SkImageFilter::Context ctx(matrix, clipBounds, cache.get());
-            if (filter->filterImage(&proxy, src, ctx, &dst, &offset)) {
-                SkPaint tmpUnfiltered(*paint);
-                tmpUnfiltered.setImageFilter(NULL);
-                dstDev->drawSprite(iter, dst, pos.x() + offset.x(), pos.y() + offset.y(),
-                                   tmpUnfiltered);
-            }
+            this->internalDrawFilteredSprite(iter, dstDev, srcDev->accessBitmap(false), pos,
+                                             *paint);
         } else {
             dstDev->drawDevice(iter, srcDev, pos.x(), pos.y(), *paint);
         }
@@ -1198,20 +1261,7 @@ void SkCanvas::onDrawSprite(const SkBitmap& bitmap, int x, int y, const SkPaint*
         SkImageFilter* filter = paint->getImageFilter();
         SkIPoint pos = { x - iter.getX(), y - iter.getY() };
         if (filter && !iter.fDevice->canHandleImageFilter(filter)) {
-            SkDeviceImageFilterProxy proxy(iter.fDevice, fProps);
-            SkBitmap dst;
-            SkIPoint offset = SkIPoint::Make(0, 0);
-            SkMatrix matrix = *iter.fMatrix;
-            matrix.postTranslate(SkIntToScalar(-pos.x()), SkIntToScalar(-pos.y()));
-            const SkIRect clipBounds = bitmap.bounds();
-            SkAutoTUnref<SkImageFilter::Cache> cache(iter.fDevice->getImageFilterCache());
-            SkImageFilter::Context ctx(matrix, clipBounds, cache.get());
-            if (filter->filterImage(&proxy, bitmap, ctx, &dst, &offset)) {
-                SkPaint tmpUnfiltered(*paint);
-                tmpUnfiltered.setImageFilter(NULL);
-                iter.fDevice->drawSprite(iter, dst, pos.x() + offset.x(), pos.y() + offset.y(),
-                                         tmpUnfiltered);
-            }
+            this->internalDrawFilteredSprite(iter, iter.fDevice, bitmap, pos, *paint);
         } else {
             iter.fDevice->drawSprite(iter, bitmap, pos.x(), pos.y(), *paint);
         }
@@ -2543,6 +2593,27 @@ SkCanvas* SkCanvas::NewRasterDirect(const SkImageInfo& info, void* pixels, size_
 
 ///////////////////////////////////////////////////////////////////////////////
 
+bool SkCanvasPriv::GetPlaybackBounds(const SkCanvas* canvas, SkRect* bounds) {
+    if (!canvas->getClipBounds(bounds)) {
+        return false;
+    }
+    if (canvas->fTiled) {
+        // getClipBounds() succeeded, so the matrix inverts.
+        SkMatrix inverse;
+        SkAssertResult(canvas->getTotalMatrix().invert(&inverse));
+        // Outset as getClipBounds() does, in case we are antialiasing.
+        const SkIRect& tile = canvas->fTileBounds;
+        SkRect r, tileBounds;
+        r.iset(tile.fLeft - 1, tile.fTop - 1, tile.fRight + 1, tile.fBottom + 1);
+        inverse.mapRect(&tileBounds, r);
+        if (!bounds->intersect(tileBounds)) {
+            bounds->setEmpty();
+            return false;
+        }
+    }
+    return true;
+}
+
 SkAutoCanvasMatrixPaint::SkAutoCanvasMatrixPaint(SkCanvas* canvas, const SkMatrix* matrix,
                                                  const SkPaint* paint, const SkRect& bounds)
     : fCanvas(canvas)
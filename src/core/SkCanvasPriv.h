@@ -20,4 +20,37 @@ private:
     int         fSaveCount;
 };
 
+class SkCanvasPriv {
+public:
+    /**
+     *  Sets the SkScan::PathFlags that raster devices fill paths with when drawn through canvas,
+     *  and returns the previous ones. Other devices ignore them.
+     */
+    static uint32_t SetScanFlags(SkCanvas* canvas, uint32_t scanFlags) {
+        const uint32_t prev = canvas->fScanFlags;
+        canvas->fScanFlags = scanFlags;
+        return prev;
+    }
+
+    /**
+     *  Limits raster drawing through canvas to bounds, in device space, while leaving its clip
+     *  as it is, so that paths are scan converted exactly as they would be without the limit.
+     *  Tiles of a larger draw set this, rather than clipping to themselves, to agree along
+     *  their seams. Layers are still made, and drawn into, as if there were no limit, so that
+     *  they line up with the device as they otherwise would; only those whose pixels outside
+     *  bounds no image filter reads are limited to it.
+     */
+    static void SetTileBounds(SkCanvas* canvas, const SkIRect& bounds) {
+        canvas->fTiled = true;
+        canvas->fTileBounds = bounds;
+        canvas->fDeviceCMDirty = true;
+    }
+
+    /**
+     *  Like canvas->getClipBounds(), but within the bounds set with SetTileBounds(), if any.
+     *  This is the area that recorded draws need to be played back for.
+     */
+    static bool GetPlaybackBounds(const SkCanvas* canvas, SkRect* bounds);
+};
+
 #endif
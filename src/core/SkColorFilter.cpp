@@ -6,6 +6,7 @@
  */
 
 #include "SkColorFilter.h"
+#include "SkPMFloatProcs.h"
 #include "SkReadBuffer.h"
 #include "SkString.h"
 #include "SkWriteBuffer.h"
@@ -134,3 +135,87 @@ SK_DEFINE_FLATTENABLE_REGISTRAR_GROUP_START(SkColorFilter)
 SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkComposeColorFilter)
 SK_DEFINE_FLATTENABLE_REGISTRAR_GROUP_END
 
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// The same math as SkColorMatrixFilter's float path, see there.
+
+static const float gInv255 = 0.0039215683f; //  (1.0f / 255) - ULP == SkBits2Float(0x3B808080)
+
+static Sk4f premul(const Sk4f& x) {
+    float scale = SkPMFloat(x).a() * gInv255;
+    return x * Sk4f(scale, scale, scale, 1);
+}
+
+static Sk4f unpremul(const SkPMFloat& pm) {
+    float scale = 255 / pm.a();
+    return pm * Sk4f(scale, scale, scale, 1);
+}
+
+static Sk4f clamp_0_255(const Sk4f& value) {
+    return Sk4f::Max(Sk4f::Min(value, Sk4f(255)), Sk4f(0));
+}
+
+bool SkPMFloatColorMatrix::Init(const SkColorFilter* filter, SkPMFloatColorMatrix* matrix) {
+#ifdef SK_SUPPORT_LEGACY_INT_COLORMATRIX
+    return false;
+#else
+    SkScalar src[20];
+    if (NULL == filter || !filter->asColorMatrix(src)) {
+        return false;
+    }
+
+    bool identity = true;
+    for (int i = 0; i < 20; i++) {
+        // The identity has ones every 6th entry, on the diagonal of the 4x4 part.
+        identity &= src[i] == (i % 6 ? 0 : 1);
+    }
+    matrix->fIdentity = identity;
+
+    const SkScalar* srcR = src + 0;
+    const SkScalar* srcG = src + 5;
+    const SkScalar* srcB = src + 10;
+    const SkScalar* srcA = src + 15;
+    for (int i = 0; i < 20; i += 4) {
+        matrix->fTranspose[i + SK_A32_SHIFT / 8] = *srcA++;
+        matrix->fTranspose[i + SK_R32_SHIFT / 8] = *srcR++;
+        matrix->fTranspose[i + SK_G32_SHIFT / 8] = *srcG++;
+        matrix->fTranspose[i + SK_B32_SHIFT / 8] = *srcB++;
+    }
+    return true;
+#endif
+}
+
+void SkPMFloatColorMatrix::filterSpan(const SkPMFloat src[], int count, SkPMFloat dst[]) const {
+    if (fIdentity) {
+        if (src != dst) {
+            memcpy(dst, src, count * sizeof(SkPMFloat));
+        }
+        return;
+    }
+
+    const Sk4f c0 = Sk4f::Load(fTranspose + 0);
+    const Sk4f c1 = Sk4f::Load(fTranspose + 4);
+    const Sk4f c2 = Sk4f::Load(fTranspose + 8);
+    const Sk4f c3 = Sk4f::Load(fTranspose + 12);
+    const Sk4f c4 = Sk4f::Load(fTranspose + 16);  // translates
+
+    const SkPMFloat matrix_translate_pmfloat = premul(clamp_0_255(c4));
+
+    for (int i = 0; i < count; i++) {
+        const float a = src[i].a();
+        if (a <= 0) {
+            dst[i] = matrix_translate_pmfloat;
+            continue;
+        }
+
+        const SkPMFloat srcf = a >= 255 ? src[i] : SkPMFloat(unpremul(src[i]));
+
+        Sk4f r4 = Sk4f(srcf.r());
+        Sk4f g4 = Sk4f(srcf.g());
+        Sk4f b4 = Sk4f(srcf.b());
+        Sk4f a4 = Sk4f(srcf.a());
+
+        dst[i] = premul(clamp_0_255(c0 * r4 + c1 * g4 + c2 * b4 + c3 * a4 + c4));
+    }
+}
@@ -367,17 +367,37 @@ void BGRAConvolve2D(const unsigned char* sourceData,
                     unsigned char* output,
                     const SkConvolutionProcs& convolveProcs,
                     bool useSimdIfPossible) {
+    SkConvolutionMemoryRowSource source(sourceData, sourceByteRowStride);
+    BGRAConvolve2DRows(&source, sourceHasAlpha, filterX, filterY,
+                       0, filterY.numValues(), outputByteRowStride, output,
+                       convolveProcs, useSimdIfPossible);
+}
+
+bool BGRAConvolve2DRows(SkConvolutionRowSource* source,
+                        bool sourceHasAlpha,
+                        const SkConvolutionFilter1D& filterX,
+                        const SkConvolutionFilter1D& filterY,
+                        int outStartY, int outEndY,
+                        int outputByteRowStride,
+                        unsigned char* output,
+                        const SkConvolutionProcs& convolveProcs,
+                        bool useSimdIfPossible) {
+    SkASSERT(0 <= outStartY && outStartY <= outEndY && outEndY <= filterY.numValues());
+    if (outStartY == outEndY) {
+        return true;
+    }
 
     int maxYFilterSize = filterY.maxFilter();
 
     // The next row in the input that we will generate a horizontally
     // convolved row for. If the filter doesn't start at the beginning of the
-    // image (this is the case when we are only resizing a subset), then we
-    // don't want to generate any output rows before that. Compute the starting
-    // row for convolution as the first pixel for the first vertical filter.
+    // image (this is the case when we are only resizing a subset, or only
+    // producing a band of the output), then we don't want to generate any
+    // output rows before that. Compute the starting row for convolution as the
+    // first pixel for the first vertical filter.
     int filterOffset, filterLength;
     const SkConvolutionFilter1D::ConvolutionFixed* filterValues =
-        filterY.FilterForValue(0, &filterOffset, &filterLength);
+        filterY.FilterForValue(outStartY, &filterOffset, &filterLength);
     int nextXRow = filterOffset;
 
     // We loop over each row in the input doing a horizontal convolution. This
@@ -420,41 +440,49 @@ void BGRAConvolve2D(const unsigned char* sourceData,
 
     filterY.FilterForValue(numOutputRows - 1, &lastFilterOffset,
                            &lastFilterLength);
+    const int simdRowsEnd = lastFilterOffset + lastFilterLength - avoidSimdRows;
 
-    for (int outY = 0; outY < numOutputRows; outY++) {
+    // We only do four rows at once if all of them are needed by this band.
+    int bandFilterOffset, bandFilterLength;
+    filterY.FilterForValue(outEndY - 1, &bandFilterOffset, &bandFilterLength);
+    const int bandRowsEnd = bandFilterOffset + bandFilterLength;
+
+    for (int outY = outStartY; outY < outEndY; outY++) {
         filterValues = filterY.FilterForValue(outY,
                                               &filterOffset, &filterLength);
 
         // Generate output rows until we have enough to run the current filter.
         while (nextXRow < filterOffset + filterLength) {
             if (convolveProcs.fConvolve4RowsHorizontally &&
-                nextXRow + 3 < lastFilterOffset + lastFilterLength -
-                avoidSimdRows) {
+                nextXRow + 3 < simdRowsEnd && nextXRow + 3 < bandRowsEnd) {
                 const unsigned char* src[4];
                 unsigned char* outRow[4];
                 for (int i = 0; i < 4; ++i) {
-                    src[i] = &sourceData[(uint64_t)(nextXRow + i) * sourceByteRowStride];
+                    src[i] = source->row(nextXRow + i);
+                    if (!src[i]) {
+                        return false;
+                    }
                     outRow[i] = rowBuffer.advanceRow();
                 }
                 convolveProcs.fConvolve4RowsHorizontally(src, filterX, outRow);
                 nextXRow += 4;
             } else {
+                const unsigned char* src = source->row(nextXRow);
+                if (!src) {
+                    return false;
+                }
                 // Check if we need to avoid SSE2 for this row.
                 if (convolveProcs.fConvolveHorizontally &&
-                    nextXRow < lastFilterOffset + lastFilterLength -
-                    avoidSimdRows) {
+                    nextXRow < simdRowsEnd) {
                     convolveProcs.fConvolveHorizontally(
-                        &sourceData[(uint64_t)nextXRow * sourceByteRowStride],
-                        filterX, rowBuffer.advanceRow(), sourceHasAlpha);
+                        src, filterX, rowBuffer.advanceRow(), sourceHasAlpha);
                 } else {
                     if (sourceHasAlpha) {
                         ConvolveHorizontallyAlpha(
-                            &sourceData[(uint64_t)nextXRow * sourceByteRowStride],
-                            filterX, rowBuffer.advanceRow());
+                            src, filterX, rowBuffer.advanceRow());
                     } else {
                         ConvolveHorizontallyNoAlpha(
-                            &sourceData[(uint64_t)nextXRow * sourceByteRowStride],
-                            filterX, rowBuffer.advanceRow());
+                            src, filterX, rowBuffer.advanceRow());
                     }
                 }
                 nextXRow++;
@@ -486,4 +514,5 @@ void BGRAConvolve2D(const unsigned char* sourceData,
                                sourceHasAlpha);
         }
     }
+    return true;
 }
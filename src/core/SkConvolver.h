@@ -202,4 +202,50 @@ SK_API void BGRAConvolve2D(const unsigned char* sourceData,
     const SkConvolutionProcs&,
     bool useSimdIfPossible);
 
+// Supplies source rows to BGRAConvolve2DRows(). Rows are requested in
+// increasing order, and each returned row must stay valid until four more rows
+// have been requested. Rows must be readable for
+// SkConvolutionProcs::fExtraHorizontalReads pixels past their end unless they
+// are among the last rows of the image (see BGRAConvolve2D).
+class SkConvolutionRowSource {
+public:
+    virtual ~SkConvolutionRowSource() {}
+
+    // Returns row |y| of the source image, or NULL if it can't be read.
+    virtual const unsigned char* row(int y) = 0;
+};
+
+// Serves rows straight out of an image in memory.
+class SkConvolutionMemoryRowSource : public SkConvolutionRowSource {
+public:
+    SkConvolutionMemoryRowSource(const unsigned char* data, int byteRowStride)
+        : fData(data), fByteRowStride(byteRowStride) {}
+
+    const unsigned char* row(int y) override {
+        return &fData[(uint64_t)y * fByteRowStride];
+    }
+
+private:
+    const unsigned char* fData;
+    int fByteRowStride;
+};
+
+// Like BGRAConvolve2D, but pulls source rows from |source|, and only computes
+// output rows [outStartY, outEndY). |output| still points at output row 0.
+//
+// Only about yfilter.maxFilter() horizontally convolved rows are held at once,
+// so this can be used to stream rows through without holding the whole source,
+// or to split an output image into bands that are convolved independently.
+//
+// Returns false if |source| failed to provide a row.
+SK_API bool BGRAConvolve2DRows(SkConvolutionRowSource* source,
+    bool sourceHasAlpha,
+    const SkConvolutionFilter1D& xfilter,
+    const SkConvolutionFilter1D& yfilter,
+    int outStartY, int outEndY,
+    int outputByteRowStride,
+    unsigned char* output,
+    const SkConvolutionProcs&,
+    bool useSimdIfPossible);
+
 #endif  // SK_CONVOLVER_H
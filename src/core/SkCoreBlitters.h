@@ -11,6 +11,8 @@
 #include "SkBitmapProcShader.h"
 #include "SkBlitter.h"
 #include "SkBlitRow.h"
+#include "SkPMFloatProcs.h"
+#include "SkRasterPipeline.h"
 #include "SkShader.h"
 #include "SkSmallAllocator.h"
 
@@ -180,6 +182,86 @@ private:
     typedef SkShaderBlitter INHERITED;
 };
 
+/**
+ *  Like SkARGB32_Shader_Blitter, but the shader's colors stay in floats (SkPMFloat) through the
+ *  color matrix and the xfermode, and are packed once as they are written. SkBlitter::Choose()
+ *  uses it when the paint's xfermode has an SkPMFloatXferProc, and its color filter, if any, is
+ *  an SkPMFloatColorMatrix. The paint's color filter is run here, not wrapped into the shader.
+ */
+class SkARGB32_PMFloat_Shader_Blitter : public SkShaderBlitter {
+public:
+    SkARGB32_PMFloat_Shader_Blitter(const SkBitmap& device, const SkPaint& paint,
+                                    SkShader::Context* shaderContext, SkPMFloatXferProc xferProc,
+                                    const SkPMFloatColorMatrix* colorMatrix);
+    virtual ~SkARGB32_PMFloat_Shader_Blitter();
+    void blitH(int x, int y, int width) override;
+    void blitV(int x, int y, int height, SkAlpha alpha) override;
+    void blitRect(int x, int y, int width, int height) override;
+    void blitAntiH(int x, int y, const SkAlpha[], const int16_t[]) override;
+    void blitMask(const SkMask&, const SkIRect&) override;
+
+private:
+    void shade(int x, int y, int width);
+
+    SkPMFloatXferProc       fXferProc;
+    SkPMFloatColorMatrix    fColorMatrix;
+    bool                    fHasColorMatrix;
+    void*                   fStorage;
+    SkPMFloat*              fBuffer;
+    bool                    fConstInY;
+
+    // illegal
+    SkARGB32_PMFloat_Shader_Blitter& operator=(const SkARGB32_PMFloat_Shader_Blitter&);
+
+    typedef SkShaderBlitter INHERITED;
+};
+
+/**
+ *  A shader blitter made of an SkRasterPipeline: the color matrix, the blend and the coverage
+ *  each run as a stage over four pixels at a time, in floats, packing only as the pixels are
+ *  stored. Any mode SkRasterPipeline can blend works, but SkBlitter::Choose() only uses it where
+ *  that beats the 8-bit procs, and when the color filter, if any, is an SkPMFloatColorMatrix.
+ *  The paint's color filter is run by the pipeline, not wrapped into the shader.
+ */
+class SkARGB32_RasterPipeline_Blitter : public SkShaderBlitter {
+public:
+    SkARGB32_RasterPipeline_Blitter(const SkBitmap& device, const SkPaint& paint,
+                                    SkShader::Context* shaderContext,
+                                    const SkPMFloatColorMatrix* colorMatrix,
+                                    SkXfermode::Mode mode);
+    virtual ~SkARGB32_RasterPipeline_Blitter();
+    void blitH(int x, int y, int width) override;
+    void blitV(int x, int y, int height, SkAlpha alpha) override;
+    void blitRect(int x, int y, int width, int height) override;
+    void blitAntiH(int x, int y, const SkAlpha[], const int16_t[]) override;
+    void blitMask(const SkMask&, const SkIRect&) override;
+
+private:
+    void shade(int x, int y, int width);
+
+    SkPMFloatColorMatrix fColorMatrix;
+    bool                fHasColorMatrix;
+    void*               fStorage;
+    SkPMFloat*          fBuffer;        // The shaded span, or the filtered color of a color shader.
+    bool                fConstantSrc;
+    bool                fConstInY;
+
+    // Per span state, read by the pipelines' stages.
+    SkPMColor*          fDst;
+    const SkAlpha*      fCoverage;
+    float               fConstantCoverage;
+
+    // Full coverage, coverage from fCoverage, and fConstantCoverage.
+    SkRasterPipeline    fOpaque;
+    SkRasterPipeline    fLerpU8;
+    SkRasterPipeline    fLerpConstant;
+
+    // illegal
+    SkARGB32_RasterPipeline_Blitter& operator=(const SkARGB32_RasterPipeline_Blitter&);
+
+    typedef SkShaderBlitter INHERITED;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 /*  These return the correct subclass of blitter for their device config.
@@ -38,6 +38,11 @@ public:
         return &fProps;
     }
 
+    // Raster devices only ever create more raster devices, which don't share any state.
+    bool isThreadSafe() const override {
+        return NULL != fDevice->accessPixels(NULL, NULL);
+    }
+
 private:
     SkBaseDevice*  fDevice;
     const SkSurfaceProps fProps;
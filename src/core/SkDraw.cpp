@@ -1088,10 +1088,14 @@ void SkDraw::drawPath(const SkPath& origSrcPath, const SkPaint& origPaint,
         pathPtr = &tmpPath;
     }
 
+    // Masks, and hairlines, depend on the clip they are made under, so a tile of a larger draw
+    // makes them under the whole draw's clip, and keeps only what falls in the tile.
+    const SkRasterClip* edgeRC = fEdgeRC ? fEdgeRC : fRC;
+
     if (paint->getRasterizer()) {
         SkMask  mask;
         if (paint->getRasterizer()->rasterize(*pathPtr, *matrix,
-                            &fRC->getBounds(), paint->getMaskFilter(), &mask,
+                            &edgeRC->getBounds(), paint->getMaskFilter(), &mask,
                             SkMask::kComputeBoundsAndRenderImage_CreateMode)) {
             this->drawDevMask(mask, *paint);
             SkMask::FreeImage(mask.fImage);
@@ -1114,29 +1118,38 @@ void SkDraw::drawPath(const SkPath& origSrcPath, const SkPaint& origPaint,
         blitter = customBlitter;
     }
 
+    // fRC is the whole draw's clip intersected with the tile, so clipping to its bounds is enough.
+    SkRectClipBlitter tileBlitter;
+    SkBlitter* edgeBlitter = blitter;
+    if (fEdgeRC) {
+        tileBlitter.init(blitter, fRC->getBounds());
+        edgeBlitter = &tileBlitter;
+    }
+
     if (paint->getMaskFilter()) {
         SkPaint::Style style = doFill ? SkPaint::kFill_Style :
             SkPaint::kStroke_Style;
-        if (paint->getMaskFilter()->filterPath(*devPathPtr, *fMatrix, *fRC, blitter, style)) {
+        if (paint->getMaskFilter()->filterPath(*devPathPtr, *fMatrix, *edgeRC, edgeBlitter,
+                                               style)) {
             return; // filterPath() called the blitter, so we're done
         }
     }
 
-    void (*proc)(const SkPath&, const SkRasterClip&, SkBlitter*);
     if (doFill) {
+        // Fills build their edges under the whole draw's clip themselves, and only walk them
+        // through the tile.
         if (paint->isAntiAlias()) {
-            proc = SkScan::AntiFillPath;
+            SkScan::AntiFillPath(*devPathPtr, *fRC, blitter, fScanFlags, fEdgeRC);
         } else {
-            proc = SkScan::FillPath;
+            SkScan::FillPath(*devPathPtr, *fRC, blitter, fEdgeRC);
         }
     } else {    // hairline
         if (paint->isAntiAlias()) {
-            proc = SkScan::AntiHairPath;
+            SkScan::AntiHairPath(*devPathPtr, *edgeRC, edgeBlitter);
         } else {
-            proc = SkScan::HairPath;
+            SkScan::HairPath(*devPathPtr, *edgeRC, edgeBlitter);
         }
     }
-    proc(*devPathPtr, *fRC, blitter);
 }
 
 /** For the purposes of drawing bitmaps, if a matrix is "almost" translate
@@ -19,6 +19,8 @@ namespace {
     #include "zlib.h"
 #endif
 
+SK_COMPILE_ASSERT(SkFlate::kDefaultLevel == Z_DEFAULT_COMPRESSION, default_level_mismatch);
+
 // static
 const size_t kBufferSize = 1024;
 
@@ -30,7 +32,7 @@ template <typename T> void* skia_alloc_func(void*, T items, T size) {
 
 static void skia_free_func(void*, void* address) { sk_free(address); }
 
-bool doFlate(bool compress, SkStream* src, SkWStream* dst) {
+bool doFlate(bool compress, int level, SkStream* src, SkWStream* dst) {
     uint8_t inputBuffer[kBufferSize];
     uint8_t outputBuffer[kBufferSize];
     z_stream flateData;
@@ -43,7 +45,7 @@ bool doFlate(bool compress, SkStream* src, SkWStream* dst) {
     flateData.avail_out = kBufferSize;
     int rc;
     if (compress)
-        rc = deflateInit(&flateData, Z_DEFAULT_COMPRESSION);
+        rc = deflateInit(&flateData, level);
     else
         rc = inflateInit(&flateData);
     if (rc != Z_OK)
@@ -111,26 +113,26 @@ bool doFlate(bool compress, SkStream* src, SkWStream* dst) {
 }
 
 // static
-bool SkFlate::Deflate(SkStream* src, SkWStream* dst) {
-    return doFlate(true, src, dst);
+bool SkFlate::Deflate(SkStream* src, SkWStream* dst, int level) {
+    return doFlate(true, level, src, dst);
 }
 
-bool SkFlate::Deflate(const void* ptr, size_t len, SkWStream* dst) {
+bool SkFlate::Deflate(const void* ptr, size_t len, SkWStream* dst, int level) {
     SkMemoryStream stream(ptr, len);
-    return doFlate(true, &stream, dst);
+    return doFlate(true, level, &stream, dst);
 }
 
-bool SkFlate::Deflate(const SkData* data, SkWStream* dst) {
+bool SkFlate::Deflate(const SkData* data, SkWStream* dst, int level) {
     if (data) {
         SkMemoryStream stream(data->data(), data->size());
-        return doFlate(true, &stream, dst);
+        return doFlate(true, level, &stream, dst);
     }
     return false;
 }
 
 // static
 bool SkFlate::Inflate(SkStream* src, SkWStream* dst) {
-    return doFlate(false, src, dst);
+    return doFlate(false, Z_DEFAULT_COMPRESSION, src, dst);
 }
 
 
@@ -170,7 +172,7 @@ struct SkDeflateWStream::Impl {
     z_stream fZStream;
 };
 
-SkDeflateWStream::SkDeflateWStream(SkWStream* out)
+SkDeflateWStream::SkDeflateWStream(SkWStream* out, int level)
     : fImpl(SkNEW(SkDeflateWStream::Impl)) {
     fImpl->fOut = out;
     fImpl->fInBufferIndex = 0;
@@ -180,7 +182,7 @@ SkDeflateWStream::SkDeflateWStream(SkWStream* out)
     fImpl->fZStream.zalloc = &skia_alloc_func;
     fImpl->fZStream.zfree = &skia_free_func;
     fImpl->fZStream.opaque = NULL;
-    SkDEBUGCODE(int r =) deflateInit(&fImpl->fZStream, Z_DEFAULT_COMPRESSION);
+    SkDEBUGCODE(int r =) deflateInit(&fImpl->fZStream, level);
     SkASSERT(Z_OK == r);
 }
 
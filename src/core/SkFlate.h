@@ -20,23 +20,31 @@ class SkData;
 */
 class SkFlate {
 public:
+    /**
+     *  Compression levels run from 0 (store only) through 1 (fastest) to
+     *  9 (smallest output), as in zlib.  kDefaultLevel is zlib's default
+     *  tradeoff, currently 6.
+     */
+    static const int kDefaultLevel = -1;
+
     /**
      *  Use the flate compression algorithm to compress the data in src,
      *  putting the result into dst.  Returns false if an error occurs.
      */
-    static bool Deflate(SkStream* src, SkWStream* dst);
+    static bool Deflate(SkStream* src, SkWStream* dst, int level = kDefaultLevel);
 
     /**
      *  Use the flate compression algorithm to compress the data in src,
      *  putting the result into dst.  Returns false if an error occurs.
      */
-    static bool Deflate(const void* src, size_t len, SkWStream* dst);
+    static bool Deflate(const void* src, size_t len, SkWStream* dst,
+                        int level = kDefaultLevel);
 
     /**
      *  Use the flate compression algorithm to compress the data,
      *  putting the result into dst.  Returns false if an error occurs.
      */
-    static bool Deflate(const SkData*, SkWStream* dst);
+    static bool Deflate(const SkData*, SkWStream* dst, int level = kDefaultLevel);
 
     /** Use the flate compression algorithm to decompress the data in src,
         putting the result into dst.  Returns false if an error occurs.
@@ -47,14 +55,14 @@ public:
 /**
   * Wrap a stream in this class to compress the information written to
   * this stream using the Deflate algorithm.  Uses Zlib's
-  * Z_DEFAULT_COMPRESSION level.
+  * Z_DEFAULT_COMPRESSION level unless told otherwise.
   *
   * See http://en.wikipedia.org/wiki/DEFLATE
   */
 class SkDeflateWStream : public SkWStream {
 public:
     /** Does not take ownership of the stream. */
-    SkDeflateWStream(SkWStream*);
+    SkDeflateWStream(SkWStream*, int level = SkFlate::kDefaultLevel);
 
     /** The destructor calls finalize(). */
     ~SkDeflateWStream();
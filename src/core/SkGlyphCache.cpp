@@ -7,6 +7,7 @@
 
 #include "SkGlyphCache.h"
 #include "SkGlyphCache_Globals.h"
+#include "SkChecksum.h"
 #include "SkGraphics.h"
 #include "SkLazyPtr.h"
 #include "SkPaint.h"
@@ -17,25 +18,38 @@
 
 //#define SPEW_PURGE_STATUS
 
+static const int kShardCount = SK_FONT_CACHE_SHARD_COUNT;
+
 namespace {
 
-SkGlyphCache_Globals* create_globals() {
-    return SkNEW_ARGS(SkGlyphCache_Globals, (SkGlyphCache_Globals::kYes_UseMutex));
+SkGlyphCache_Globals* create_shard(int shard) {
+    const size_t sizeLimit =
+            SkGlyphCache_Globals::ShardSlice<size_t>(SK_DEFAULT_FONT_CACHE_LIMIT, shard);
+    const int countLimit =
+            SkGlyphCache_Globals::ShardSlice<int>(SK_DEFAULT_FONT_CACHE_COUNT_LIMIT, shard);
+    return SkNEW_ARGS(SkGlyphCache_Globals,
+                      (SkGlyphCache_Globals::kYes_UseMutex, sizeLimit, countLimit));
 }
 
 }  // namespace
 
-SK_DECLARE_STATIC_LAZY_PTR(SkGlyphCache_Globals, globals, create_globals);
+SK_DECLARE_STATIC_LAZY_PTR_ARRAY(SkGlyphCache_Globals, shards, kShardCount, create_shard);
 
-// Returns the shared globals
-static SkGlyphCache_Globals& getSharedGlobals() {
-    return *globals.get();
+// Returns the shared globals shard responsible for desc
+static SkGlyphCache_Globals& getSharedGlobals(const SkDescriptor& desc) {
+    return *shards[SkGlyphCache::ShardIndex(desc)];
 }
 
-// Returns the TLS globals (if set), or the shared globals
-static SkGlyphCache_Globals& getGlobals() {
+// Returns the TLS globals (if set), or the shared globals shard for desc
+static SkGlyphCache_Globals& getGlobals(const SkDescriptor& desc) {
     SkGlyphCache_Globals* tls = SkGlyphCache_Globals::FindTLS();
-    return tls ? *tls : getSharedGlobals();
+    return tls ? *tls : getSharedGlobals(desc);
+}
+
+static void purge_all_shards() {
+    for (int i = 0; i < kShardCount; i++) {
+        shards[i]->purgeAll();
+    }
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -419,13 +433,10 @@ void SkGlyphCache::invokeAndRemoveAuxProcs() {
 
 #include "SkThread.h"
 
-size_t SkGlyphCache_Globals::setCacheSizeLimit(size_t newLimit) {
-    static const size_t minLimit = 256 * 1024;
-    if (newLimit < minLimit) {
-        newLimit = minLimit;
-    }
+static const size_t kMinCacheSizeLimit = 256 * 1024;
 
-    SkAutoMutexAcquire    ac(fMutex);
+size_t SkGlyphCache_Globals::setCacheSizeLimit(size_t newLimit) {
+    AutoAcquire ac(*this);
 
     size_t prevLimit = fCacheSizeLimit;
     fCacheSizeLimit = newLimit;
@@ -438,7 +449,7 @@ int SkGlyphCache_Globals::setCacheCountLimit(int newCount) {
         newCount = 0;
     }
 
-    SkAutoMutexAcquire    ac(fMutex);
+    AutoAcquire ac(*this);
 
     int prevCount = fCacheCountLimit;
     fCacheCountLimit = newCount;
@@ -447,10 +458,20 @@ int SkGlyphCache_Globals::setCacheCountLimit(int newCount) {
 }
 
 void SkGlyphCache_Globals::purgeAll() {
-    SkAutoMutexAcquire    ac(fMutex);
+    AutoAcquire ac(*this);
     this->internalPurge(fTotalMemoryUsed);
 }
 
+void SkGlyphCache_Globals::getStats(SkGlyphCache::ShardStats* stats) {
+    stats->fHits      = sk_atomic_load(&fHits);
+    stats->fMisses    = sk_atomic_load(&fMisses);
+    stats->fContended = sk_atomic_load(&fContended);
+
+    AutoAcquire ac(*this);
+    stats->fCacheCount = fCacheCount;
+    stats->fMemoryUsed = fTotalMemoryUsed;
+}
+
 /*  This guy calls the visitor from within the mutext lock, so the visitor
     cannot:
     - take too much time
@@ -466,19 +487,21 @@ SkGlyphCache* SkGlyphCache::VisitCache(SkTypeface* typeface,
     }
     SkASSERT(desc);
 
-    SkGlyphCache_Globals& globals = getGlobals();
-    SkAutoMutexAcquire    ac(globals.fMutex);
-    SkGlyphCache*         cache;
-    bool                  insideMutex = true;
+    SkGlyphCache_Globals&             globals = getGlobals(*desc);
+    SkGlyphCache_Globals::AutoAcquire ac(globals);
+    SkGlyphCache*                     cache;
+    bool                              insideMutex = true;
 
     globals.validate();
 
     for (cache = globals.internalGetHead(); cache != NULL; cache = cache->fNext) {
         if (cache->fDesc->equals(*desc)) {
             globals.internalDetachCache(cache);
+            globals.recordHit();
             goto FOUND_IT;
         }
     }
+    globals.recordMiss();
 
     /* Release the mutex now, before we create a new entry (which might have
         side-effects like trying to access the cache/mutex (yikes!)
@@ -494,7 +517,7 @@ SkGlyphCache* SkGlyphCache::VisitCache(SkTypeface* typeface,
         // so we can try the purge.
         SkScalerContext* ctx = typeface->createScalerContext(desc, true);
         if (!ctx) {
-            getSharedGlobals().purgeAll();
+            purge_all_shards();
             ctx = typeface->createScalerContext(desc, false);
             SkASSERT(ctx);
         }
@@ -520,25 +543,24 @@ void SkGlyphCache::AttachCache(SkGlyphCache* cache) {
     SkASSERT(cache);
     SkASSERT(cache->fNext == NULL);
 
-    getGlobals().attachCacheToHead(cache);
+    getGlobals(cache->getDescriptor()).attachCacheToHead(cache);
 }
 
-void SkGlyphCache::Dump() {
-    SkGlyphCache_Globals& globals = getGlobals();
-    SkAutoMutexAcquire    ac(globals.fMutex);
-    SkGlyphCache*         cache;
+void SkGlyphCache_Globals::dump() {
+    AutoAcquire   ac(*this);
+    SkGlyphCache* cache;
 
-    globals.validate();
+    this->validate();
 
     SkDebugf("SkGlyphCache strikes:%d memory:%d\n",
-             globals.getCacheCountUsed(), (int)globals.getTotalMemoryUsed());
+             this->getCacheCountUsed(), (int)this->getTotalMemoryUsed());
 
 #ifdef SK_GLYPHCACHE_TRACK_HASH_STATS
     int hitCount = 0;
     int missCount = 0;
 #endif
 
-    for (cache = globals.internalGetHead(); cache != NULL; cache = cache->fNext) {
+    for (cache = this->internalGetHead(); cache != NULL; cache = cache->fNext) {
 #ifdef SK_GLYPHCACHE_TRACK_HASH_STATS
         hitCount += cache->fHashHitCount;
         missCount += cache->fHashMissCount;
@@ -550,10 +572,37 @@ void SkGlyphCache::Dump() {
 #endif
 }
 
+void SkGlyphCache::Dump() {
+    if (SkGlyphCache_Globals* tls = SkGlyphCache_Globals::FindTLS()) {
+        tls->dump();
+        return;
+    }
+    for (int i = 0; i < kShardCount; i++) {
+        ShardStats stats;
+        GetShardStats(i, &stats);
+        SkDebugf("SkGlyphCache shard:%d hits:%d misses:%d contended:%d\n",
+                 i, stats.fHits, stats.fMisses, stats.fContended);
+        shards[i]->dump();
+    }
+}
+
+int SkGlyphCache::ShardCount() {
+    return kShardCount;
+}
+
+int SkGlyphCache::ShardIndex(const SkDescriptor& desc) {
+    return SkChecksum::Mix(desc.getChecksum()) % kShardCount;
+}
+
+void SkGlyphCache::GetShardStats(int i, ShardStats* stats) {
+    SkASSERT(i >= 0 && i < kShardCount);
+    shards[i]->getStats(stats);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 void SkGlyphCache_Globals::attachCacheToHead(SkGlyphCache* cache) {
-    SkAutoMutexAcquire    ac(fMutex);
+    AutoAcquire ac(*this);
 
     this->validate();
     cache->validate();
@@ -694,31 +743,57 @@ void SkGlyphCache_Globals::validate() const {
 #include "SkTypefaceCache.h"
 
 size_t SkGraphics::GetFontCacheLimit() {
-    return getSharedGlobals().getCacheSizeLimit();
+    size_t limit = 0;
+    for (int i = 0; i < kShardCount; i++) {
+        limit += shards[i]->getCacheSizeLimit();
+    }
+    return limit;
 }
 
 size_t SkGraphics::SetFontCacheLimit(size_t bytes) {
-    return getSharedGlobals().setCacheSizeLimit(bytes);
+    bytes = SkTMax(bytes, kMinCacheSizeLimit);
+    size_t prevLimit = 0;
+    for (int i = 0; i < kShardCount; i++) {
+        prevLimit += shards[i]->setCacheSizeLimit(SkGlyphCache_Globals::ShardSlice(bytes, i));
+    }
+    return prevLimit;
 }
 
 size_t SkGraphics::GetFontCacheUsed() {
-    return getSharedGlobals().getTotalMemoryUsed();
+    size_t used = 0;
+    for (int i = 0; i < kShardCount; i++) {
+        used += shards[i]->getTotalMemoryUsed();
+    }
+    return used;
 }
 
 int SkGraphics::GetFontCacheCountLimit() {
-    return getSharedGlobals().getCacheCountLimit();
+    int limit = 0;
+    for (int i = 0; i < kShardCount; i++) {
+        limit += shards[i]->getCacheCountLimit();
+    }
+    return limit;
 }
 
 int SkGraphics::SetFontCacheCountLimit(int count) {
-    return getSharedGlobals().setCacheCountLimit(count);
+    count = SkTMax(count, 0);
+    int prevCount = 0;
+    for (int i = 0; i < kShardCount; i++) {
+        prevCount += shards[i]->setCacheCountLimit(SkGlyphCache_Globals::ShardSlice(count, i));
+    }
+    return prevCount;
 }
 
 int SkGraphics::GetFontCacheCountUsed() {
-    return getSharedGlobals().getCacheCountUsed();
+    int used = 0;
+    for (int i = 0; i < kShardCount; i++) {
+        used += shards[i]->getCacheCountUsed();
+    }
+    return used;
 }
 
 void SkGraphics::PurgeFontCache() {
-    getSharedGlobals().purgeAll();
+    purge_all_shards();
     SkTypefaceCache::PurgeAll();
 }
 
@@ -731,6 +806,6 @@ void SkGraphics::SetTLSFontCacheLimit(size_t bytes) {
     if (0 == bytes) {
         SkGlyphCache_Globals::DeleteTLS();
     } else {
-        SkGlyphCache_Globals::GetTLS().setCacheSizeLimit(bytes);
+        SkGlyphCache_Globals::GetTLS().setCacheSizeLimit(SkTMax(bytes, kMinCacheSizeLimit));
     }
 }
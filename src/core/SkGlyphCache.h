@@ -152,6 +152,25 @@ public:
 
     static void Dump();
 
+    /** The shared cache is split into shards by descriptor, each with its own mutex, LRU list,
+        and slice of the budget, so threads using different strikes rarely wait on each other.
+    */
+    static int ShardCount();
+
+    /** The shard of the shared cache that strikes with this descriptor live in. */
+    static int ShardIndex(const SkDescriptor&);
+
+    struct ShardStats {
+        int32_t fHits;       // VisitCache() found a strike in this shard.
+        int32_t fMisses;     // VisitCache() had to create a strike.
+        int32_t fContended;  // Locking this shard found another thread there first.
+        int     fCacheCount;
+        size_t  fMemoryUsed;
+    };
+
+    /** Fills out stats for shard i of the shared cache, 0 <= i < ShardCount(). */
+    static void GetShardStats(int i, ShardStats*);
+
 #ifdef SK_DEBUG
     void validate() const;
 #else
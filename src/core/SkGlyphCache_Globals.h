@@ -8,7 +8,9 @@
 #ifndef SkGlyphCache_Globals_DEFINED
 #define SkGlyphCache_Globals_DEFINED
 
+#include "SkAtomics.h"
 #include "SkGlyphCache.h"
+#include "SkMutex.h"
 #include "SkTLS.h"
 
 #ifndef SK_DEFAULT_FONT_CACHE_COUNT_LIMIT
@@ -19,9 +21,12 @@
     #define SK_DEFAULT_FONT_CACHE_LIMIT     (2 * 1024 * 1024)
 #endif
 
-///////////////////////////////////////////////////////////////////////////////
+// The shared cache is split into this many SkGlyphCache_Globals, each with a slice of the limits.
+#ifndef SK_FONT_CACHE_SHARD_COUNT
+    #define SK_FONT_CACHE_SHARD_COUNT       4
+#endif
 
-class SkMutex;
+///////////////////////////////////////////////////////////////////////////////
 
 class SkGlyphCache_Globals {
 public:
@@ -30,12 +35,16 @@ public:
         kYes_UseMutex  // shared cache
     };
 
-    SkGlyphCache_Globals(UseMutex um) {
+    SkGlyphCache_Globals(UseMutex um,
+                         size_t sizeLimit = SK_DEFAULT_FONT_CACHE_LIMIT,
+                         int countLimit = SK_DEFAULT_FONT_CACHE_COUNT_LIMIT) {
         fHead = NULL;
         fTotalMemoryUsed = 0;
-        fCacheSizeLimit = SK_DEFAULT_FONT_CACHE_LIMIT;
+        fCacheSizeLimit = sizeLimit;
         fCacheCount = 0;
-        fCacheCountLimit = SK_DEFAULT_FONT_CACHE_COUNT_LIMIT;
+        fCacheCountLimit = countLimit;
+        fHits = fMisses = fContended = 0;
+        fLockers = 0;
 
         fMutex = (kYes_UseMutex == um) ? SkNEW(SkMutex) : NULL;
     }
@@ -53,6 +62,45 @@ public:
 
     SkMutex*        fMutex;
 
+    // Acquires fMutex (if any), counting the acquisition as contended if another thread
+    // already holds or is waiting for it.
+    class AutoAcquire : SkNoncopyable {
+    public:
+        explicit AutoAcquire(SkGlyphCache_Globals& globals) : fGlobals(&globals) {
+            if (fGlobals->fMutex) {
+                if (sk_atomic_inc(&fGlobals->fLockers) > 0) {
+                    sk_atomic_inc(&fGlobals->fContended);
+                }
+                fGlobals->fMutex->acquire();
+            }
+        }
+
+        ~AutoAcquire() { this->release(); }
+
+        void release() {
+            if (fGlobals && fGlobals->fMutex) {
+                fGlobals->fMutex->release();
+                sk_atomic_dec(&fGlobals->fLockers);
+            }
+            fGlobals = NULL;
+        }
+
+    private:
+        SkGlyphCache_Globals* fGlobals;
+    };
+
+    // Splits a limit of the shared cache into SK_FONT_CACHE_SHARD_COUNT slices, one per shard,
+    // that sum back to it.
+    template <typename T> static T ShardSlice(T total, int shard) {
+        return total / SK_FONT_CACHE_SHARD_COUNT +
+               (shard < (int)(total % SK_FONT_CACHE_SHARD_COUNT) ? 1 : 0);
+    }
+
+    void recordHit()  { sk_atomic_inc(&fHits); }
+    void recordMiss() { sk_atomic_inc(&fMisses); }
+    void getStats(SkGlyphCache::ShardStats*);
+    void dump();
+
     SkGlyphCache* internalGetHead() const { return fHead; }
     SkGlyphCache* internalGetTail() const;
 
@@ -105,6 +153,9 @@ private:
     int32_t fCacheCountLimit;
     int32_t fCacheCount;
 
+    int32_t fHits, fMisses, fContended;
+    int32_t fLockers;  // Threads holding or waiting for fMutex.
+
     // Checkout budgets, modulated by the specified min-bytes-needed-to-purge,
     // and attempt to purge caches to match.
     // Returns number of bytes freed.
@@ -8,13 +8,19 @@
 #include "SkImageFilter.h"
 
 #include "SkBitmap.h"
+#include "SkBitmapCache.h"
+#include "SkBitmapContent.h"
 #include "SkChecksum.h"
 #include "SkDevice.h"
+#include "SkImageFilterBands.h"
 #include "SkLazyPtr.h"
 #include "SkMatrixImageFilter.h"
+#include "SkPixelRef.h"
 #include "SkReadBuffer.h"
 #include "SkWriteBuffer.h"
 #include "SkRect.h"
+#include "SkResourceCache.h"
+#include "SkTaskGroup.h"
 #include "SkTDynamicHash.h"
 #include "SkTInternalLList.h"
 #include "SkValidationUtils.h"
@@ -61,6 +67,95 @@ struct SkImageFilter::Cache::Key {
     }
 };
 
+namespace {
+
+// The hash of a bitmap's pixels is remembered per generation ID, so that the nodes of a DAG
+// (and later draws of the same bitmap) only hash them once.
+static unsigned gSrcHashKeyNamespaceLabel;
+
+struct SrcHashKey : public SkResourceCache::Key {
+public:
+    SrcHashKey(uint32_t genID, const SkIRect& bounds) : fGenID(genID), fBounds(bounds) {
+        this->init(&gSrcHashKeyNamespaceLabel, SkMakeResourceCacheSharedIDForBitmap(genID),
+                   sizeof(fGenID) + sizeof(fBounds));
+    }
+
+    uint32_t    fGenID;
+    SkIRect     fBounds;
+};
+
+struct SrcHashRec : public SkResourceCache::Rec {
+    SrcHashRec(uint32_t genID, const SkIRect& bounds, const SkBitmapContentHash& hash)
+        : fKey(genID, bounds)
+        , fHash(hash) {}
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return sizeof(*this); }
+
+    static bool Finder(const SkResourceCache::Rec& baseRec, void* contextHash) {
+        const SrcHashRec& rec = static_cast<const SrcHashRec&>(baseRec);
+        *(SkBitmapContentHash*)contextHash = rec.fHash;
+        return true;
+    }
+
+private:
+    SrcHashKey          fKey;
+    SkBitmapContentHash fHash;
+};
+
+static unsigned gResultKeyNamespaceLabel;
+
+struct ResultKey : public SkResourceCache::Key {
+public:
+    ResultKey(uint32_t filterID, const SkMatrix& ctm, const SkIRect& clipBounds,
+              const SkBitmapContentHash& srcHash)
+        : fFilterID(filterID)
+        , fMatrix(ctm)
+        , fClipBounds(clipBounds)
+        , fSrcHash(srcHash) {
+        fMatrix.getType();  // force initialization of type, so keys match
+        this->init(&gResultKeyNamespaceLabel, 0, sizeof(fFilterID) + sizeof(fMatrix) +
+                   sizeof(fClipBounds) + sizeof(fSrcHash));
+    }
+
+    uint32_t            fFilterID;
+    SkMatrix            fMatrix;
+    SkIRect             fClipBounds;
+    SkBitmapContentHash fSrcHash;
+};
+
+// Hits are checked against the src's SkBitmapContentRec, which every node's result for that src
+// shares, rather than against a copy of their own.
+struct ResultRec : public SkResourceCache::Rec {
+    ResultRec(const ResultKey& key, const SkBitmap& result, const SkIPoint& offset)
+        : fKey(key)
+        , fBitmap(result)
+        , fOffset(offset) {}
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return sizeof(fKey) + fBitmap.getSize(); }
+
+    struct Context {
+        SkBitmap    fResult;
+        SkIPoint    fOffset;
+    };
+
+    static bool Finder(const SkResourceCache::Rec& baseRec, void* context) {
+        const ResultRec& rec = static_cast<const ResultRec&>(baseRec);
+        Context* ctx = (Context*)context;
+        ctx->fResult = rec.fBitmap;
+        ctx->fOffset = rec.fOffset;
+        return true;
+    }
+
+private:
+    ResultKey   fKey;
+    SkBitmap    fBitmap;
+    SkIPoint    fOffset;
+};
+
+} // namespace
+
 SkImageFilter::Common::~Common() {
     for (int i = 0; i < fInputs.count(); ++i) {
         SkSafeUnref(fInputs[i]);
@@ -180,6 +275,10 @@ bool SkImageFilter::filterImage(Proxy* proxy, const SkBitmap& src,
         if (context.cache()->get(key, result, offset)) {
             return true;
         }
+        if (fUsesSrcInput && context.cache()->getByContent(key, src, result, offset)) {
+            context.cache()->set(key, *result, *offset);
+            return true;
+        }
     }
     /*
      *  Give the proxy first shot at the filter. If it returns false, ask
@@ -189,6 +288,10 @@ bool SkImageFilter::filterImage(Proxy* proxy, const SkBitmap& src,
         this->onFilterImage(proxy, src, context, result, offset)) {
         if (context.cache()) {
             context.cache()->set(key, *result, *offset);
+            // Texture results stay with the device's own cache; they belong to one GrContext.
+            if (fUsesSrcInput && NULL == result->getTexture()) {
+                context.cache()->setByContent(key, src, *result, *offset);
+            }
         }
         return true;
     }
@@ -202,6 +305,18 @@ bool SkImageFilter::filterBounds(const SkIRect& src, const SkMatrix& ctm,
     return this->onFilterBounds(src, ctm, dst);
 }
 
+bool SkImageFilter::canFilterPartially() const {
+    if (!this->onCanFilterPartially()) {
+        return false;
+    }
+    for (int i = 0; i < fInputCount; i++) {
+        if (this->getInput(i) && !this->getInput(i)->canFilterPartially()) {
+            return false;
+        }
+    }
+    return true;
+}
+
 void SkImageFilter::computeFastBounds(const SkRect& src, SkRect* dst) const {
     if (0 == fInputCount) {
         *dst = src;
@@ -240,7 +355,8 @@ bool SkImageFilter::filterImageGPU(Proxy* proxy, const SkBitmap& src, const Cont
     SkASSERT(fInputCount == 1);
     SkIPoint srcOffset = SkIPoint::Make(0, 0);
     if (this->getInput(0) &&
-        !this->getInput(0)->getInputResultGPU(proxy, src, ctx, &input, &srcOffset)) {
+        !this->getInput(0)->getInputResultGPU(proxy, src, this->mapContext(ctx), &input,
+                                              &srcOffset)) {
         return false;
     }
     GrTexture* srcTexture = input.getTexture();
@@ -368,6 +484,125 @@ bool SkImageFilter::onFilterBounds(const SkIRect& src, const SkMatrix& ctm,
     return true;
 }
 
+void SkImageFilter::onFilterNodeBounds(const SkIRect& src, const SkMatrix&, SkIRect* dst) const {
+    *dst = src;
+}
+
+SkImageFilter::Context SkImageFilter::mapContext(const Context& ctx) const {
+    if (ctx.clipBounds() == SkIRect::MakeLargest()) {
+        // Everything was asked for, so everything is needed (and mapping could overflow).
+        return ctx;
+    }
+    if (!this->canFilterPartially()) {
+        // Some filter in the DAG may read beyond what it declares, so keep asking for it all.
+        return ctx;
+    }
+    SkIRect clipBounds;
+    this->onFilterNodeBounds(ctx.clipBounds(), ctx.ctm(), &clipBounds);
+    return Context(ctx.ctm(), clipBounds, ctx.cache());
+}
+
+bool SkImageFilter::isCroppedOut(const Context& ctx) const {
+    if (!this->cropRectIsSet()) {
+        return false;
+    }
+    SkRect cropRect;
+    ctx.ctm().mapRect(&cropRect, fCropRect.rect());
+    const SkIRect cropRectI = cropRect.roundOut();
+    // Edges the crop rect doesn't set come from the input, so could be anywhere.
+    SkIRect bounds = SkIRect::MakeLargest();
+    uint32_t flags = fCropRect.flags();
+    if (flags & CropRect::kHasLeft_CropEdge) bounds.fLeft = cropRectI.fLeft;
+    if (flags & CropRect::kHasTop_CropEdge) bounds.fTop = cropRectI.fTop;
+    if (flags & CropRect::kHasRight_CropEdge) bounds.fRight = cropRectI.fRight;
+    if (flags & CropRect::kHasBottom_CropEdge) bounds.fBottom = cropRectI.fBottom;
+    return !SkIRect::Intersects(bounds, ctx.clipBounds());
+}
+
+bool SkImageFilter::filterInputs(int count, Proxy* proxy, const SkBitmap& src,
+                                 const Context& ctx, SkBitmap results[],
+                                 SkIPoint offsets[]) const {
+    SkASSERT(count <= fInputCount);
+    const Context inputCtx = this->mapContext(ctx);
+    SkAutoSTArray<4, bool> failed(count);
+    auto filterInput = [&](int i) {
+        offsets[i] = SkIPoint::Make(0, 0);
+        failed[i] = false;
+        SkImageFilter* input = this->getInput(i);
+        if (NULL == input) {
+            results[i] = src;
+        } else if (!input->filterImage(proxy, src, inputCtx, &results[i], &offsets[i])) {
+            results[i].reset();
+            failed[i] = !input->isCroppedOut(inputCtx);
+        }
+    };
+    // Branches of the DAG share nothing but the (thread safe) cache and proxy.
+    if (count > 1 && proxy && proxy->isThreadSafe()) {
+        sk_parallel_for(count, 1, filterInput);
+    } else {
+        for (int i = 0; i < count; i++) {
+            filterInput(i);
+        }
+    }
+    for (int i = 0; i < count; i++) {
+        if (failed[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Below this many pixels, or this many rows, a band is not worth its own task.
+static const int kMinFilterBandPixels = 256 * 256;
+static const int kMinFilterBandHeight = 64;
+
+int SkImageFilterBandCount(const SkImageFilter* filter, SkImageFilter::Proxy* proxy,
+                           const SkImageFilter::Context& ctx, int threads) {
+    const SkIRect& clipBounds = ctx.clipBounds();
+    SkIRect demand;
+    if (threads < 2 || !proxy->isThreadSafe() || !filter->canFilterPartially() ||
+        !filter->filterBounds(clipBounds, ctx.ctm(), &demand)) {
+        return 1;
+    }
+    const int margin = SkTMax(0, SkTMax(clipBounds.fTop - demand.fTop,
+                                        demand.fBottom - clipBounds.fBottom));
+    const int minBandHeight = SkTMax(kMinFilterBandHeight, 4 * margin);
+    const int64_t pixels = sk_64_mul(clipBounds.width(), clipBounds.height());
+    const int maxBands = (int)SkTMin<int64_t>(pixels / kMinFilterBandPixels, threads);
+    return SkTMax(1, SkTMin(maxBands, clipBounds.height() / minBandHeight));
+}
+
+void SkImageFilterBands(const SkImageFilter* filter, SkImageFilter::Proxy* proxy,
+                        const SkBitmap& src, const SkImageFilter::Context& ctx, int bands,
+                        SkBitmap results[], SkIPoint offsets[]) {
+    SkASSERT(filter->canFilterPartially());
+    const SkIRect& clipBounds = ctx.clipBounds();
+    auto filterBand = [&](int i) {
+        SkIRect band = clipBounds;
+        band.fTop = clipBounds.fTop + (int)((int64_t)clipBounds.height() * i / bands);
+        band.fBottom = clipBounds.fTop + (int)((int64_t)clipBounds.height() * (i + 1) / bands);
+        SkImageFilter::Context bandCtx(ctx.ctm(), band, ctx.cache());
+        SkBitmap result;
+        SkIPoint offset = SkIPoint::Make(0, 0);
+        results[i].reset();
+        if (!filter->filterImage(proxy, src, bandCtx, &result, &offset)) {
+            return;
+        }
+        // Pixels outside the band may have been filtered without all of their neighbors.
+        band.offset(-offset.x(), -offset.y());
+        if (band.intersect(result.bounds()) && result.extractSubset(&results[i], band)) {
+            offsets[i] = offset + SkIPoint::Make(band.x(), band.y());
+        }
+    };
+    if (proxy->isThreadSafe()) {
+        sk_parallel_for(bands, 1, filterBand);
+    } else {
+        for (int i = 0; i < bands; i++) {
+            filterBand(i);
+        }
+    }
+}
+
 bool SkImageFilter::asFragmentProcessor(GrFragmentProcessor**, GrTexture*, const SkMatrix&,
                                         const SkIRect&) const {
     return false;
@@ -419,7 +654,11 @@ namespace {
 
 class CacheImpl : public SkImageFilter::Cache {
 public:
-    CacheImpl(size_t maxBytes) : fMaxBytes(maxBytes), fCurrentBytes(0) {
+    CacheImpl(size_t maxBytes, bool keyOnContent, SkResourceCache* contentCache)
+        : fMaxBytes(maxBytes)
+        , fCurrentBytes(0)
+        , fKeyOnContent(keyOnContent)
+        , fContentCache(contentCache) {
     }
     virtual ~CacheImpl() {
         SkTDynamicHash<Value, Key>::Iter iter(&fLookup);
@@ -475,7 +714,86 @@ public:
             removeInternal(tail);
         }
     }
+    bool getByContent(const Key& key, const SkBitmap& src,
+                      SkBitmap* result, SkIPoint* offset) const override {
+        SkBitmapContentHash srcHash;
+        if (!sk_atomic_load(&fKeyOnContent) || !this->findOrHashPixels(src, &srcHash)) {
+            return false;
+        }
+        ResultRec::Context found;
+        SkBitmap srcCopy;
+        if (!this->findContent(ResultKey(key.fUniqueID, key.fMatrix, key.fClipBounds, srcHash),
+                               ResultRec::Finder, &found) ||
+            !this->findContent(SkBitmapContentKey(srcHash), SkBitmapContentRec::Finder,
+                               &srcCopy) ||
+            !SkBitmapContentRec::Matches(srcCopy, src)) {
+            return false;
+        }
+        *result = found.fResult;
+        *offset = found.fOffset;
+        return true;
+    }
+    void setByContent(const Key& key, const SkBitmap& src,
+                      const SkBitmap& result, const SkIPoint& offset) override {
+        SkBitmapContentHash srcHash;
+        if (!sk_atomic_load(&fKeyOnContent) || !this->findOrHashPixels(src, &srcHash)) {
+            return;
+        }
+        // The first node to cache a result for this src copies it; the rest share that copy.
+        // A src that collides with another's hash caches nothing.
+        SkBitmap srcCopy;
+        if (this->findContent(SkBitmapContentKey(srcHash), SkBitmapContentRec::Finder,
+                              &srcCopy)) {
+            if (!SkBitmapContentRec::Matches(srcCopy, src)) {
+                return;
+            }
+        } else {
+            if (!SkBitmapContentRec::Copy(src, &srcCopy)) {
+                return;
+            }
+            this->addContent(SkNEW_ARGS(SkBitmapContentRec, (srcHash, srcCopy)));
+        }
+        ResultKey contentKey(key.fUniqueID, key.fMatrix, key.fClipBounds, srcHash);
+        this->addContent(SkNEW_ARGS(ResultRec, (contentKey, result, offset)));
+    }
+    bool setKeyOnContent(bool keyOnContent) {
+        return sk_atomic_exchange(&fKeyOnContent, keyOnContent);
+    }
 private:
+    // Content keyed entries live in fContentCache behind our lock, or else in the global cache.
+    bool findContent(const SkResourceCache::Key& key, SkResourceCache::FindVisitor visitor,
+                     void* context) const {
+        if (fContentCache) {
+            SkAutoMutexAcquire mutex(fMutex);
+            return fContentCache->find(key, visitor, context);
+        }
+        return SkResourceCache::Find(key, visitor, context);
+    }
+    void addContent(SkResourceCache::Rec* rec) const {
+        if (fContentCache) {
+            SkAutoMutexAcquire mutex(fMutex);
+            fContentCache->add(rec);
+        } else {
+            SkResourceCache::Add(rec);
+        }
+    }
+    bool findOrHashPixels(const SkBitmap& src, SkBitmapContentHash* hash) const {
+        if (NULL == src.pixelRef()) {
+            return false;
+        }
+        const SkIPoint origin = src.pixelRefOrigin();
+        const SkIRect bounds = SkIRect::MakeXYWH(origin.fX, origin.fY, src.width(), src.height());
+        const uint32_t genID = src.getGenerationID();
+        if (this->findContent(SrcHashKey(genID, bounds), SrcHashRec::Finder, hash)) {
+            return true;
+        }
+        if (!SkBitmapContentHash::Compute(src, hash)) {
+            return false;
+        }
+        this->addContent(SkNEW_ARGS(SrcHashRec, (genID, bounds, *hash)));
+        src.pixelRef()->notifyAddedToCache();
+        return true;
+    }
     void removeInternal(Value* v) {
         fCurrentBytes -= v->fBitmap.getSize();
         fLRU.remove(v);
@@ -488,16 +806,23 @@ private:
     size_t                             fMaxBytes;
     size_t                             fCurrentBytes;
     mutable SkMutex                    fMutex;
+    bool                               fKeyOnContent;
+    SkResourceCache*                   fContentCache;
 };
 
 SkImageFilter::Cache* CreateCache() {
-    return SkImageFilter::Cache::Create(kDefaultCacheSize);
+    return SkNEW_ARGS(CacheImpl, (kDefaultCacheSize, false, NULL));
 }
 
 } // namespace
 
 SkImageFilter::Cache* SkImageFilter::Cache::Create(size_t maxBytes) {
-    return SkNEW_ARGS(CacheImpl, (maxBytes));
+    return SkNEW_ARGS(CacheImpl, (maxBytes, false, NULL));
+}
+
+SkImageFilter::Cache* SkImageFilter::Cache::CreateKeyedOnContent(size_t maxBytes,
+                                                                 SkResourceCache* resourceCache) {
+    return SkNEW_ARGS(CacheImpl, (maxBytes, true, resourceCache));
 }
 
 SK_DECLARE_STATIC_LAZY_PTR(SkImageFilter::Cache, cache, CreateCache);
@@ -505,3 +830,7 @@ SK_DECLARE_STATIC_LAZY_PTR(SkImageFilter::Cache, cache, CreateCache);
 SkImageFilter::Cache* SkImageFilter::Cache::Get() {
     return cache.get();
 }
+
+bool SkImageFilter::Cache::SetKeyOnContent(bool keyOnContent) {
+    return static_cast<CacheImpl*>(cache.get())->setKeyOnContent(keyOnContent);
+}
@@ -0,0 +1,32 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkImageFilterBands_DEFINED
+#define SkImageFilterBands_DEFINED
+
+#include "SkImageFilter.h"
+
+/**
+ *  Returns how many full-width horizontal bands of ctx's clip are worth filtering in parallel
+ *  on 'threads' threads: 1 unless the proxy is thread safe, the filter canFilterPartially(), and
+ *  the clip is big enough that each band stays much taller than the margin its DAG reads from
+ *  beyond the band's edges.
+ */
+int SkImageFilterBandCount(const SkImageFilter*, SkImageFilter::Proxy*,
+                           const SkImageFilter::Context&, int threads);
+
+/**
+ *  Filters src one full-width horizontal band of ctx's clip at a time, in parallel when the
+ *  proxy is thread safe, storing in results[i] and offsets[i] the part of band i's result that
+ *  lies inside band i. A band that fails or has nothing inside it is left isNull(). The filter
+ *  must canFilterPartially().
+ */
+void SkImageFilterBands(const SkImageFilter*, SkImageFilter::Proxy*, const SkBitmap& src,
+                        const SkImageFilter::Context&, int bands,
+                        SkBitmap results[], SkIPoint offsets[]);
+
+#endif
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkIncrementalRTree.h"
+
+SkIncrementalRTree::SkIncrementalRTree(SkScalar aspectRatio)
+    : fAspectRatio(aspectRatio)
+    , fBufferStart(0)
+    , fRootBound(SkRect::MakeEmpty()) {}
+
+SkIncrementalRTree::~SkIncrementalRTree() {
+    for (int i = 0; i < fTrees.count(); i++) {
+        SkDELETE(fTrees[i].fTree);
+    }
+}
+
+SkRect SkIncrementalRTree::getRootBound() const {
+    return fRootBound;
+}
+
+void SkIncrementalRTree::insert(const SkRect boundsArray[], int N) {
+    fBounds.append(N, boundsArray);
+    for (int i = 0; i < N; i++) {
+        // SkRect::join() skips empty rects for us.
+        fRootBound.join(boundsArray[i]);
+    }
+    if (fBounds.count() - fBufferStart >= kBufferSize) {
+        this->flush();
+    }
+}
+
+void SkIncrementalRTree::flush() {
+    int start = fBufferStart,
+        count = fBounds.count() - fBufferStart;
+
+    // Fold in every tree that is no bigger than what we've got so far.  This keeps each tree
+    // at least twice the size of the next, so there are never more than log2(N) of them.
+    while (!fTrees.isEmpty() && fTrees.top().fCount <= count) {
+        const Tree& top = fTrees.top();
+        SkASSERT(top.fStart + top.fCount == start);
+        start  = top.fStart;
+        count += top.fCount;
+        SkDELETE(top.fTree);
+        fTrees.pop();
+    }
+
+    Tree* tree = fTrees.append();
+    tree->fTree = SkNEW_ARGS(SkRTree, (fAspectRatio, SkRTree::kHilbert_BulkLoad));
+    tree->fTree->insert(fBounds.begin() + start, count);
+    tree->fStart = start;
+    tree->fCount = count;
+    fBufferStart = fBounds.count();
+}
+
+void SkIncrementalRTree::search(const SkRect& query, SkTDArray<unsigned>* results) const {
+    if (!SkRect::Intersects(fRootBound, query)) {
+        return;
+    }
+
+    // Trees cover increasing, disjoint runs of ops and each returns its hits sorted, so
+    // searching them oldest first keeps the results in op order.
+    for (int i = 0; i < fTrees.count(); i++) {
+        const Tree& tree = fTrees[i];
+        const int first = results->count();
+        tree.fTree->search(query, results);
+        for (int j = first; j < results->count(); j++) {
+            (*results)[j] += tree.fStart;
+        }
+    }
+    for (int i = fBufferStart; i < fBounds.count(); i++) {
+        if (SkRect::Intersects(fBounds[i], query)) {
+            results->push(i);
+        }
+    }
+}
+
+size_t SkIncrementalRTree::bytesUsed() const {
+    size_t byteCount = sizeof(SkIncrementalRTree);
+
+    byteCount += fBounds.reserved() * sizeof(SkRect);
+    byteCount += fTrees.reserved() * sizeof(Tree);
+    for (int i = 0; i < fTrees.count(); i++) {
+        byteCount += fTrees[i].fTree->bytesUsed();
+    }
+
+    return byteCount;
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkIncrementalRTree_DEFINED
+#define SkIncrementalRTree_DEFINED
+
+#include "SkBBoxHierarchy.h"
+#include "SkRTree.h"
+
+/**
+ * A bounding box hierarchy that, unlike SkRTree, may have insert() called any number of times.
+ * Each call appends its rects after those already inserted: the i-th rect of a call is reported
+ * by search() as index i plus the number of rects passed to all earlier calls.  The hierarchy can
+ * be searched between calls, so a recorder can keep appending ops while it is being queried.
+ *
+ * Internally this is the logarithmic method: the most recent rects sit in a small buffer that's
+ * searched linearly, and older ones are covered by a stack of Hilbert-packed SkRTrees over
+ * contiguous runs of ops, each at most half the size of the one below it.  When the buffer
+ * fills it becomes a new tree, merging with (i.e. rebuilding together with) any trees no larger
+ * than itself.  Every rect is packed O(log N) times in total, and search() visits O(log N) trees.
+ */
+class SkIncrementalRTree : public SkBBoxHierarchy {
+public:
+    SK_DECLARE_INST_COUNT(SkIncrementalRTree)
+
+    explicit SkIncrementalRTree(SkScalar aspectRatio = 1);
+    virtual ~SkIncrementalRTree();
+
+    void insert(const SkRect[], int N) override;
+    void search(const SkRect& query, SkTDArray<unsigned>* results) const override;
+    size_t bytesUsed() const override;
+    SkRect getRootBound() const override;
+
+    // Methods and constants below here are only public for tests.
+
+    // Total number of rects inserted, including empty ones.
+    int getCount() const { return fBounds.count(); }
+    // Number of packed trees currently covering older rects.
+    int getTreeCount() const { return fTrees.count(); }
+
+    // Rects are buffered unpacked until there are this many of them.
+    static const int kBufferSize = 64;
+
+private:
+    struct Tree {
+        SkRTree* fTree;
+        int      fStart;  // Index of the first op covered by fTree.
+        int      fCount;  // Number of ops covered by fTree.
+    };
+
+    // Pack the buffered rects into a new tree, merging it with any smaller trees.
+    void flush();
+
+    SkScalar          fAspectRatio;
+    SkTDArray<SkRect> fBounds;       // Every rect inserted so far.
+    SkTDArray<Tree>   fTrees;        // From oldest (largest) to newest (smallest).
+    int               fBufferStart;  // fBounds[fBufferStart...] are not in any tree yet.
+    SkRect            fRootBound;
+
+    typedef SkBBoxHierarchy INHERITED;
+};
+
+#endif
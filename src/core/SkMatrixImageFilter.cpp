@@ -53,7 +53,8 @@ bool SkMatrixImageFilter::onFilterImage(Proxy* proxy,
                                         SkIPoint* offset) const {
     SkBitmap src = source;
     SkIPoint srcOffset = SkIPoint::Make(0, 0);
-    if (getInput(0) && !getInput(0)->filterImage(proxy, source, ctx, &src, &srcOffset)) {
+    if (getInput(0) &&
+        !getInput(0)->filterImage(proxy, source, this->mapContext(ctx), &src, &srcOffset)) {
         return false;
     }
 
@@ -100,18 +101,27 @@ void SkMatrixImageFilter::computeFastBounds(const SkRect& src, SkRect* dst) cons
     dst->join(bounds);   // Work around for skia:3194
 }
 
-bool SkMatrixImageFilter::onFilterBounds(const SkIRect& src, const SkMatrix& ctm,
-                                         SkIRect* dst) const {
+// Maps device space rects of this filter's result back to its input's.
+static bool invert_device_transform(const SkMatrix& transform, const SkMatrix& ctm,
+                                    SkMatrix* inverse) {
     SkMatrix transformInverse;
-    if (!fTransform.invert(&transformInverse)) {
+    if (!transform.invert(&transformInverse)) {
+        return false;
+    }
+    if (!ctm.invert(inverse)) {
         return false;
     }
+    inverse->postConcat(transformInverse);
+    inverse->postConcat(ctm);
+    return true;
+}
+
+bool SkMatrixImageFilter::onFilterBounds(const SkIRect& src, const SkMatrix& ctm,
+                                         SkIRect* dst) const {
     SkMatrix matrix;
-    if (!ctm.invert(&matrix)) {
+    if (!invert_device_transform(fTransform, ctm, &matrix)) {
         return false;
     }
-    matrix.postConcat(transformInverse);
-    matrix.postConcat(ctm);
     SkRect floatBounds;
     matrix.mapRect(&floatBounds, SkRect::Make(src));
     SkIRect bounds = floatBounds.roundOut();
@@ -123,6 +133,22 @@ bool SkMatrixImageFilter::onFilterBounds(const SkIRect& src, const SkMatrix& ctm
     return true;
 }
 
+void SkMatrixImageFilter::onFilterNodeBounds(const SkIRect& src, const SkMatrix& ctm,
+                                             SkIRect* dst) const {
+    SkMatrix matrix;
+    if (!invert_device_transform(fTransform, ctm, &matrix)) {
+        *dst = src;
+        return;
+    }
+    SkRect floatBounds;
+    matrix.mapRect(&floatBounds, SkRect::Make(src));
+    *dst = floatBounds.roundOut();
+    if (kNone_SkFilterQuality != fFilterQuality) {
+        // Bilinear and bicubic filtering read up to two texels beyond the mapped rect.
+        dst->outset(2, 2);
+    }
+}
+
 #ifndef SK_IGNORE_TO_STRING
 void SkMatrixImageFilter::toString(SkString* str) const {
     str->appendf("SkMatrixImageFilter: (");
@@ -55,6 +55,8 @@ protected:
                                SkBitmap* result, SkIPoint* loc) const override;
     virtual bool onFilterBounds(const SkIRect& src, const SkMatrix&,
                                 SkIRect* dst) const override;
+    void onFilterNodeBounds(const SkIRect& src, const SkMatrix&, SkIRect* dst) const override;
+    bool onCanFilterPartially() const override { return true; }
 
 private:
     SkMatrix              fTransform;
@@ -6,168 +6,157 @@
  */
 
 #include "SkMipMap.h"
+#include "SkAtomics.h"
 #include "SkBitmap.h"
 #include "SkColorPriv.h"
-
-static void downsample32_nocheck(void* dst, int, int, const void* srcPtr, const SkBitmap& srcBM) {
-    const uint32_t* p = static_cast<const uint32_t*>(srcPtr);
-    const uint32_t* baseP = p;
-    uint32_t c, ag, rb;
-
-    c = *p; ag = (c >> 8) & 0xFF00FF; rb = c & 0xFF00FF;
-    p += 1;
-
-    c = *p; ag += (c >> 8) & 0xFF00FF; rb += c & 0xFF00FF;
-
-    p = baseP;
-    p += srcBM.rowBytes() >> 2;
-
-    c = *p; ag += (c >> 8) & 0xFF00FF; rb += c & 0xFF00FF;
-    p += 1;
-
-    c = *p; ag += (c >> 8) & 0xFF00FF; rb += c & 0xFF00FF;
-
-    *(uint32_t*)dst = ((rb >> 2) & 0xFF00FF) | ((ag << 6) & 0xFF00FF00);
-}
-
-static void downsample32_check(void* dst, int x, int y, const void* srcPtr, const SkBitmap& srcBM) {
-    const uint32_t* p = static_cast<const uint32_t*>(srcPtr);
-    const uint32_t* baseP = p;
-
-    x <<= 1;
-    y <<= 1;
-    SkASSERT(srcBM.getAddr32(x, y) == p);
-
-    SkPMColor c, ag, rb;
-
-    c = *p; ag = (c >> 8) & 0xFF00FF; rb = c & 0xFF00FF;
-    if (x < srcBM.width() - 1) {
-        p += 1;
+#include "SkNx.h"
+
+//
+// ColorTypeFilter is the "Type" we pass to some downsample template functions.
+// It controls how we expand a pixel into a large type, with space between each component,
+// so we can then perform our simple filter (either box or triangle) and store the intermediates
+// in the expanded type. There is room in each component for the weighted sum of 16 pixels.
+//
+
+struct ColorTypeFilter_8888 {
+    typedef uint32_t Type;
+    static Sk4h Expand(uint32_t x) {
+        return Sk4h::FromBytes((const uint8_t*)&x);
     }
-    c = *p; ag += (c >> 8) & 0xFF00FF; rb += c & 0xFF00FF;
-
-    p = baseP;
-    if (y < srcBM.height() - 1) {
-        p += srcBM.rowBytes() >> 2;
-    }
-    c = *p; ag += (c >> 8) & 0xFF00FF; rb += c & 0xFF00FF;
-    if (x < srcBM.width() - 1) {
-        p += 1;
+    static uint32_t Compact(const Sk4h& x) {
+        uint32_t r;
+        x.toBytes((uint8_t*)&r);
+        return r;
     }
-    c = *p; ag += (c >> 8) & 0xFF00FF; rb += c & 0xFF00FF;
+};
 
-    *((uint32_t*)dst) = ((rb >> 2) & 0xFF00FF) | ((ag << 6) & 0xFF00FF00);
-}
-
-static inline uint32_t expand16(U16CPU c) {
-    return (c & ~SK_G16_MASK_IN_PLACE) | ((c & SK_G16_MASK_IN_PLACE) << 16);
-}
-
-// returns dirt in the top 16bits, but we don't care, since we only
-// store the low 16bits.
-static inline U16CPU pack16(uint32_t c) {
-    return (c & ~SK_G16_MASK_IN_PLACE) | ((c >> 16) & SK_G16_MASK_IN_PLACE);
-}
-
-static void downsample16(void* dst, int x, int y, const void* srcPtr, const SkBitmap& srcBM) {
-    const uint16_t* p = static_cast<const uint16_t*>(srcPtr);
-    const uint16_t* baseP = p;
-
-    x <<= 1;
-    y <<= 1;
-    SkASSERT(srcBM.getAddr16(x, y) == p);
-
-    SkPMColor c;
-
-    c = expand16(*p);
-    if (x < srcBM.width() - 1) {
-        p += 1;
+struct ColorTypeFilter_565 {
+    typedef uint16_t Type;
+    static uint32_t Expand(uint16_t x) {
+        return (x & ~SK_G16_MASK_IN_PLACE) | ((x & SK_G16_MASK_IN_PLACE) << 16);
+    }
+    static uint16_t Compact(uint32_t x) {
+        return (x & ~SK_G16_MASK_IN_PLACE) | ((x >> 16) & SK_G16_MASK_IN_PLACE);
     }
-    c += expand16(*p);
+};
 
-    p = baseP;
-    if (y < srcBM.height() - 1) {
-        p += srcBM.rowBytes() >> 1;
+struct ColorTypeFilter_4444 {
+    typedef uint16_t Type;
+    static uint32_t Expand(uint16_t x) {
+        return (x & 0xF0F) | ((x & ~0xF0F) << 12);
     }
-    c += expand16(*p);
-    if (x < srcBM.width() - 1) {
-        p += 1;
+    static uint16_t Compact(uint32_t x) {
+        return (x & 0xF0F) | ((x >> 12) & ~0xF0F);
     }
-    c += expand16(*p);
-
-    *((uint16_t*)dst) = (uint16_t)pack16(c >> 2);
-}
-
-static uint32_t expand4444(U16CPU c) {
-    return (c & 0xF0F) | ((c & ~0xF0F) << 12);
-}
-
-static U16CPU collaps4444(uint32_t c) {
-    return (c & 0xF0F) | ((c >> 12) & ~0xF0F);
-}
-
-static void downsample4444(void* dst, int x, int y, const void* srcPtr, const SkBitmap& srcBM) {
-    const uint16_t* p = static_cast<const uint16_t*>(srcPtr);
-    const uint16_t* baseP = p;
-
-    x <<= 1;
-    y <<= 1;
-    SkASSERT(srcBM.getAddr16(x, y) == p);
-
-    uint32_t c;
+};
 
-    c = expand4444(*p);
-    if (x < srcBM.width() - 1) {
-        p += 1;
+struct ColorTypeFilter_8 {
+    typedef uint8_t Type;
+    static unsigned Expand(unsigned x) {
+        return x;
     }
-    c += expand4444(*p);
-
-    p = baseP;
-    if (y < srcBM.height() - 1) {
-        p += srcBM.rowBytes() >> 1;
+    static uint8_t Compact(unsigned x) {
+        return (uint8_t)x;
     }
-    c += expand4444(*p);
-    if (x < srcBM.width() - 1) {
-        p += 1;
+};
+
+// Box filter over 2x2 source pixels.
+template <typename F> void downsample_2_2(void* dst, const void* src, size_t srcRB, int count) {
+    auto p0 = static_cast<const typename F::Type*>(src);
+    auto p1 = (const typename F::Type*)((const char*)p0 + srcRB);
+    auto d = static_cast<typename F::Type*>(dst);
+
+    for (int i = 0; i < count; ++i) {
+        auto c00 = F::Expand(p0[0]);
+        auto c01 = F::Expand(p0[1]);
+        auto c10 = F::Expand(p1[0]);
+        auto c11 = F::Expand(p1[1]);
+
+        auto c = c00 + c10 + c01 + c11;
+        d[i] = F::Compact(c >> 2);
+        p0 += 2;
+        p1 += 2;
     }
-    c += expand4444(*p);
-
-   *((uint16_t*)dst) = (uint16_t)collaps4444(c >> 2);
 }
 
-static void downsample8_nocheck(void* dst, int, int, const void* srcPtr, const SkBitmap& srcBM) {
-    const size_t rb = srcBM.rowBytes();
-    const uint8_t* p = static_cast<const uint8_t*>(srcPtr);
-    *(uint8_t*)dst = (p[0] + p[1] + p[rb] + p[rb + 1]) >> 2;
+// [1 2 1] across, box down: the last column of an odd-width source is not dropped.
+template <typename F> void downsample_3_2(void* dst, const void* src, size_t srcRB, int count) {
+    auto p0 = static_cast<const typename F::Type*>(src);
+    auto p1 = (const typename F::Type*)((const char*)p0 + srcRB);
+    auto d = static_cast<typename F::Type*>(dst);
+
+    auto c02 = F::Expand(p0[0]);
+    auto c12 = F::Expand(p1[0]);
+    for (int i = 0; i < count; ++i) {
+        auto c00 = c02;
+        auto c01 = F::Expand(p0[1]);
+             c02 = F::Expand(p0[2]);
+        auto c10 = c12;
+        auto c11 = F::Expand(p1[1]);
+             c12 = F::Expand(p1[2]);
+
+        auto c = c00 + c10 + ((c01 + c11) << 1) + c02 + c12;
+        d[i] = F::Compact(c >> 3);
+        p0 += 2;
+        p1 += 2;
+    }
 }
 
-static void downsample8_check(void* dst, int x, int y, const void* srcPtr, const SkBitmap& srcBM) {
-    const uint8_t* p = static_cast<const uint8_t*>(srcPtr);
-    const uint8_t* baseP = p;
-
-    x <<= 1;
-    y <<= 1;
-    SkASSERT(srcBM.getAddr8(x, y) == p);
-
-    unsigned c = *p;
-    if (x < srcBM.width() - 1) {
-        p += 1;
+// Box across, [1 2 1] down: the last row of an odd-height source is not dropped.
+template <typename F> void downsample_2_3(void* dst, const void* src, size_t srcRB, int count) {
+    auto p0 = static_cast<const typename F::Type*>(src);
+    auto p1 = (const typename F::Type*)((const char*)p0 + srcRB);
+    auto p2 = (const typename F::Type*)((const char*)p1 + srcRB);
+    auto d = static_cast<typename F::Type*>(dst);
+
+    for (int i = 0; i < count; ++i) {
+        auto c00 = F::Expand(p0[0]);
+        auto c01 = F::Expand(p0[1]);
+        auto c10 = F::Expand(p1[0]);
+        auto c11 = F::Expand(p1[1]);
+        auto c20 = F::Expand(p2[0]);
+        auto c21 = F::Expand(p2[1]);
+
+        auto c = c00 + c01 + ((c10 + c11) << 1) + c20 + c21;
+        d[i] = F::Compact(c >> 3);
+        p0 += 2;
+        p1 += 2;
+        p2 += 2;
     }
-    c += *p;
+}
 
-    p = baseP;
-    if (y < srcBM.height() - 1) {
-        p += srcBM.rowBytes();
+// [1 2 1] in both directions.
+template <typename F> void downsample_3_3(void* dst, const void* src, size_t srcRB, int count) {
+    auto p0 = static_cast<const typename F::Type*>(src);
+    auto p1 = (const typename F::Type*)((const char*)p0 + srcRB);
+    auto p2 = (const typename F::Type*)((const char*)p1 + srcRB);
+    auto d = static_cast<typename F::Type*>(dst);
+
+    // Each column is weighted [1 2 1] down, and the third column of one output pixel is the
+    // first column of the next.
+    auto col2 = F::Expand(p0[0]) + (F::Expand(p1[0]) << 1) + F::Expand(p2[0]);
+    for (int i = 0; i < count; ++i) {
+        auto col0 = col2;
+        auto col1 = F::Expand(p0[1]) + (F::Expand(p1[1]) << 1) + F::Expand(p2[1]);
+             col2 = F::Expand(p0[2]) + (F::Expand(p1[2]) << 1) + F::Expand(p2[2]);
+
+        auto c = col0 + (col1 << 1) + col2;
+        d[i] = F::Compact(c >> 4);
+        p0 += 2;
+        p1 += 2;
+        p2 += 2;
     }
-    c += *p;
-    if (x < srcBM.width() - 1) {
-        p += 1;
-    }
-    c += *p;
+}
 
-    *(uint8_t*)dst = c >> 2;
+template <typename F> static void set_procs(SkMipMap::DownsampleProc procs[2][2]) {
+    procs[0][0] = downsample_2_2<F>;
+    procs[0][1] = downsample_2_3<F>;
+    procs[1][0] = downsample_3_2<F>;
+    procs[1][1] = downsample_3_3<F>;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+
 size_t SkMipMap::AllocLevelsSize(int levelCount, size_t pixelSize) {
     if (levelCount < 0) {
         return 0;
@@ -179,31 +168,39 @@ size_t SkMipMap::AllocLevelsSize(int levelCount, size_t pixelSize) {
     return sk_64_asS32(size);
 }
 
-typedef void SkDownSampleProc(void*, int x, int y, const void* srcPtr, const SkBitmap& srcBM);
+void SkMipMap::buildLevel(int index, const void* srcPixels, size_t srcRB,
+                          int srcW, int srcH) const {
+    const Level& dst = fLevels[index];
+    SkASSERT(dst.fWidth == (uint32_t)srcW >> 1 && dst.fHeight == (uint32_t)srcH >> 1);
+
+    const DownsampleProc proc = fProcs[srcW & 1][srcH & 1];
+    const char* srcRow = static_cast<const char*>(srcPixels);
+    char* dstRow = static_cast<char*>(dst.fPixels);
+    for (uint32_t y = 0; y < dst.fHeight; y++) {
+        proc(dstRow, srcRow, srcRB, dst.fWidth);
+        srcRow += 2 * srcRB;
+        dstRow += dst.fRowBytes;
+    }
+}
 
 SkMipMap* SkMipMap::Build(const SkBitmap& src, SkDiscardableFactoryProc fact) {
-    SkDownSampleProc* proc_nocheck, *proc_check;
+    DownsampleProc procs[2][2];
 
     const SkColorType ct = src.colorType();
-    const SkAlphaType at = src.alphaType();
     switch (ct) {
         case kRGBA_8888_SkColorType:
         case kBGRA_8888_SkColorType:
-            proc_check = downsample32_check;
-            proc_nocheck = downsample32_nocheck;
+            set_procs<ColorTypeFilter_8888>(procs);
             break;
         case kRGB_565_SkColorType:
-            proc_check = downsample16;
-            proc_nocheck = proc_check;
+            set_procs<ColorTypeFilter_565>(procs);
             break;
         case kARGB_4444_SkColorType:
-            proc_check = downsample4444;
-            proc_nocheck = proc_check;
+            set_procs<ColorTypeFilter_4444>(procs);
             break;
         case kAlpha_8_SkColorType:
         case kGray_8_SkColorType:
-            proc_check = downsample8_check;
-            proc_nocheck = downsample8_nocheck;
+            set_procs<ColorTypeFilter_8>(procs);
             break;
         default:
             return NULL; // don't build mipmaps for any other colortypes (yet)
@@ -253,6 +250,7 @@ SkMipMap* SkMipMap::Build(const SkBitmap& src, SkDiscardableFactoryProc fact) {
     // init
     mipmap->fCount = countLevels;
     mipmap->fLevels = (Level*)mipmap->writable_data();
+    memcpy(mipmap->fProcs, procs, sizeof(procs));
 
     Level* levels = mipmap->fLevels;
     uint8_t*    baseAddr = (uint8_t*)&levels[countLevels];
@@ -260,7 +258,6 @@ SkMipMap* SkMipMap::Build(const SkBitmap& src, SkDiscardableFactoryProc fact) {
     int         width = src.width();
     int         height = src.height();
     uint32_t    rowBytes;
-    SkBitmap    srcBM(src);
 
     for (int i = 0; i < countLevels; ++i) {
         width >>= 1;
@@ -273,48 +270,14 @@ SkMipMap* SkMipMap::Build(const SkBitmap& src, SkDiscardableFactoryProc fact) {
         levels[i].fRowBytes = rowBytes;
         levels[i].fScale    = (float)width / src.width();
 
-        SkBitmap dstBM;
-        dstBM.installPixels(SkImageInfo::Make(width, height, ct, at), addr, rowBytes);
-
-        srcBM.lockPixels();
-        const int widthEven = width & ~1;
-        const int heightEven = height & ~1;
-        const size_t pixelSize = srcBM.info().bytesPerPixel();
-
-        const void* srcBasePtr = srcBM.getPixels();
-        void* dstBasePtr = dstBM.getPixels();
-        for (int y = 0; y < heightEven; y++) {
-            const void* srcPtr = srcBasePtr;
-            void* dstPtr = dstBasePtr;
-            for (int x = 0; x < widthEven; x++) {
-                proc_nocheck(dstPtr, x, y, srcPtr, srcBM);
-                srcPtr = (char*)srcPtr + pixelSize * 2;
-                dstPtr = (char*)dstPtr + pixelSize;
-            }
-            if (width & 1) {
-                proc_check(dstPtr, widthEven, y, srcPtr, srcBM);
-            }
-
-            srcBasePtr = (char*)srcBasePtr + srcBM.rowBytes() * 2;
-            dstBasePtr = (char*)dstBasePtr + dstBM.rowBytes();
-        }
-        if (height & 1) {
-            const void* srcPtr = srcBasePtr;
-            void* dstPtr = dstBasePtr;
-            for (int x = 0; x < width; x++) {
-                proc_check(dstPtr, x, heightEven, srcPtr, srcBM);
-                srcPtr = (char*)srcPtr + pixelSize * 2;
-                dstPtr = (char*)dstPtr + pixelSize;
-            }
-        }
-
-        srcBM.unlockPixels();
-
-        srcBM = dstBM;
         addr += height * rowBytes;
     }
     SkASSERT(addr == baseAddr + size);
 
+    // Only the first level reads src, so we build it now rather than hold on to src.
+    mipmap->buildLevel(0, src.getPixels(), src.rowBytes(), src.width(), src.height());
+    mipmap->fBuiltCount = 1;
+
     return mipmap;
 }
 
@@ -345,6 +308,17 @@ bool SkMipMap::extractLevel(SkScalar scale, Level* levelPtr) const {
     if (level > fCount) {
         level = fCount;
     }
+
+    // Pairs with the release store below, so the pixels of built levels are visible to us.
+    if (level > sk_acquire_load(&fBuiltCount)) {
+        SkAutoMutexAcquire lock(fBuildMutex);
+        for (int i = fBuiltCount; i < level; ++i) {
+            const Level& src = fLevels[i - 1];
+            this->buildLevel(i, src.fPixels, src.fRowBytes, src.fWidth, src.fHeight);
+            sk_release_store(&fBuiltCount, i + 1);
+        }
+    }
+
     if (levelPtr) {
         *levelPtr = fLevels[level - 1];
     }
@@ -9,6 +9,7 @@
 #define SkMipMap_DEFINED
 
 #include "SkCachedData.h"
+#include "SkMutex.h"
 #include "SkScalar.h"
 
 class SkBitmap;
@@ -18,6 +19,11 @@ typedef SkDiscardableMemory* (*SkDiscardableFactoryProc)(size_t bytes);
 
 class SkMipMap : public SkCachedData {
 public:
+    /**
+     *  Allocates storage for every level, but only downsamples the first one (the only one that
+     *  needs src). Deeper levels are built from the level above them the first time
+     *  extractLevel() asks for them.
+     */
     static SkMipMap* Build(const SkBitmap& src, SkDiscardableFactoryProc);
 
     struct Level {
@@ -29,6 +35,9 @@ public:
 
     bool extractLevel(SkScalar scale, Level*) const;
 
+    // Each proc writes one row of 'count' pixels, filtering the rows starting at 'src'.
+    typedef void (*DownsampleProc)(void* dst, const void* src, size_t srcRB, int count);
+
 protected:
     void onDataChange(void* oldData, void* newData) override {
         fLevels = (Level*)newData; // could be NULL
@@ -38,9 +47,18 @@ private:
     Level*  fLevels;
     int     fCount;
 
+    // Indexed by [srcWidthIsOdd][srcHeightIsOdd]. Odd dimensions use a 3-tap filter.
+    DownsampleProc  fProcs[2][2];
+
+    // Levels [0, fBuiltCount) hold pixels. fBuildMutex serializes building the rest.
+    mutable int32_t fBuiltCount;
+    mutable SkMutex fBuildMutex;
+
+    void buildLevel(int index, const void* srcPixels, size_t srcRB, int srcW, int srcH) const;
+
     // we take ownership of levels, and will free it with sk_free()
-    SkMipMap(void* malloc, size_t size) : INHERITED(malloc, size) {}
-    SkMipMap(size_t size, SkDiscardableMemory* dm) : INHERITED(size, dm) {}
+    SkMipMap(void* malloc, size_t size) : INHERITED(malloc, size), fBuiltCount(0) {}
+    SkMipMap(size_t size, SkDiscardableMemory* dm) : INHERITED(size, dm), fBuiltCount(0) {}
 
     static size_t AllocLevelsSize(int levelCount, size_t pixelSize);
 
@@ -21,12 +21,42 @@
 template <int N, typename T>
 class SkNi {
 public:
-    // For now SkNi is a _very_ minimal sketch just to support comparison operators on SkNf.
+    // SkNi supports comparison operators on SkNf, and simple integer math like summing pixels.
     SkNi() {}
     SkNi(const SkNi<N/2, T>& lo, const SkNi<N/2, T>& hi) : fLo(lo), fHi(hi) {}
+    explicit SkNi(T val) : fLo(val), fHi(val) {}
+    static SkNi Load(const T vals[N]) {
+        return SkNi(SkNi<N/2,T>::Load(vals), SkNi<N/2,T>::Load(vals+N/2));
+    }
+    // Widens N bytes, e.g. the channels of a pixel, to T.
+    static SkNi FromBytes(const uint8_t bytes[N]) {
+        return SkNi(SkNi<N/2,T>::FromBytes(bytes), SkNi<N/2,T>::FromBytes(bytes+N/2));
+    }
+
+    void store(T vals[N]) const {
+        fLo.store(vals);
+        fHi.store(vals+N/2);
+    }
+    // Narrows back to bytes.  Each value must already fit in a byte.
+    void toBytes(uint8_t bytes[N]) const {
+        fLo.toBytes(bytes);
+        fHi.toBytes(bytes+N/2);
+    }
+
+    SkNi operator + (const SkNi& o) const { return SkNi(fLo + o.fLo, fHi + o.fHi); }
+    SkNi operator - (const SkNi& o) const { return SkNi(fLo - o.fLo, fHi - o.fHi); }
+    SkNi operator * (const SkNi& o) const { return SkNi(fLo * o.fLo, fHi * o.fHi); }
+    SkNi operator << (int bits) const { return SkNi(fLo << bits, fHi << bits); }
+    SkNi operator >> (int bits) const { return SkNi(fLo >> bits, fHi >> bits); }
+
     bool allTrue() const { return fLo.allTrue() && fHi.allTrue(); }
     bool anyTrue() const { return fLo.anyTrue() || fHi.anyTrue(); }
 
+    template <int k> T kth() const {
+        SkASSERT(0 <= k && k < N);
+        return k < N/2 ? fLo.template kth<k>() : fHi.template kth<k-N/2>();
+    }
+
 private:
     REQUIRE(0 == (N & (N-1)));
     SkNi<N/2, T> fLo, fHi;
@@ -97,9 +127,26 @@ class SkNi<1,T> {
 public:
     SkNi() {}
     explicit SkNi(T val) : fVal(val) {}
+    static SkNi Load(const T vals[1]) { return SkNi(vals[0]); }
+    static SkNi FromBytes(const uint8_t bytes[1]) { return SkNi((T)bytes[0]); }
+
+    void store(T vals[1]) const { vals[0] = fVal; }
+    void toBytes(uint8_t bytes[1]) const { bytes[0] = (uint8_t)fVal; }
+
+    SkNi operator + (const SkNi& o) const { return SkNi(fVal + o.fVal); }
+    SkNi operator - (const SkNi& o) const { return SkNi(fVal - o.fVal); }
+    SkNi operator * (const SkNi& o) const { return SkNi(fVal * o.fVal); }
+    SkNi operator << (int bits) const { return SkNi(fVal << bits); }
+    SkNi operator >> (int bits) const { return SkNi(fVal >> bits); }
+
     bool allTrue() const { return (bool)fVal; }
     bool anyTrue() const { return (bool)fVal; }
 
+    template <int k> T kth() const {
+        SkASSERT(k == 0);
+        return fVal;
+    }
+
 private:
     T fVal;
 };
@@ -180,6 +227,9 @@ typedef SkNf<4,    float> Sk4f;
 typedef SkNf<4,   double> Sk4d;
 typedef SkNf<4, SkScalar> Sk4s;
 
+typedef SkNi<4, uint16_t> Sk4h;
+
 typedef SkNi<4, int32_t> Sk4i;
+typedef SkNi<4, uint32_t> Sk4u;
 
 #endif//SkNx_DEFINED
@@ -56,6 +56,9 @@ public:
     static void RoundClampTo4PMColors(
             const SkPMFloat&, const SkPMFloat&, const SkPMFloat&, const SkPMFloat&, SkPMColor[4]);
 
+    // Spans of any length, 4 at a time where possible.
+    static void FromPMColors(const SkPMColor[], SkPMFloat[], int count);
+
     bool isValid() const {
         return this->a() >= 0 && this->a() <= 255
             && this->r() >= 0 && this->r() <= this->a()
@@ -82,4 +85,13 @@ private:
     #endif
 #endif
 
+inline void SkPMFloat::FromPMColors(const SkPMColor src[], SkPMFloat dst[], int count) {
+    for (; count >= 4; count -= 4, src += 4, dst += 4) {
+        From4PMColors(src, dst + 0, dst + 1, dst + 2, dst + 3);
+    }
+    for (int i = 0; i < count; i++) {
+        dst[i] = SkPMFloat(src[i]);
+    }
+}
+
 #endif//SkPM_DEFINED
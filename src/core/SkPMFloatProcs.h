@@ -0,0 +1,56 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPMFloatProcs_DEFINED
+#define SkPMFloatProcs_DEFINED
+
+#include "SkPMFloat.h"
+#include "SkXfermode.h"
+
+class SkColorFilter;
+
+/**
+ *  SkPMFloat versions of the xfermode and color filter span calls, for the float blitters.
+ *  SkBlitter::Choose() looks them up through asMode() and asColorMatrix(), so SkPMFloat stays
+ *  out of the public SkXfermode and SkColorFilter APIs.
+ */
+
+/**
+ *  Like SkXfermode::xfer32(), but the src colors are SkPMFloats, which are packed only once the
+ *  result is blended.
+ */
+typedef void (*SkPMFloatXferProc)(SkPMColor dst[], const SkPMFloat src[], int count,
+                                  const SkAlpha aa[]);
+
+/**
+ *  Returns the native SkPMFloat xfer for the xfermode, or NULL if it only blends SkPMColors.
+ *  Implemented in SkXfermode.cpp.
+ */
+SkPMFloatXferProc SkPMFloatXferProcFor(const SkXfermode*);
+
+/**
+ *  A color matrix filter, filtering SkPMFloats. Its results match the color filter it was set up
+ *  from, give or take the rounding SkColorMatrixFilter does to pack its colors.
+ *  Implemented in SkColorFilter.cpp.
+ */
+class SkPMFloatColorMatrix {
+public:
+    /**
+     *  If filter is a color matrix whose filterSpan() already computes in floats, sets matrix up
+     *  to filter the same way and returns true. Otherwise returns false, leaving matrix alone.
+     */
+    static bool Init(const SkColorFilter* filter, SkPMFloatColorMatrix* matrix);
+
+    /** Note: src and dst may be the same buffer. */
+    void filterSpan(const SkPMFloat src[], int count, SkPMFloat dst[]) const;
+
+private:
+    float   fTranspose[20];     // The columns of the matrix, in SkPMColor order.
+    bool    fIdentity;
+};
+
+#endif
@@ -15,6 +15,7 @@
 #include "SkAtomics.h"
 #include "SkBitmapDevice.h"
 #include "SkCanvas.h"
+#include "SkCanvasPriv.h"
 #include "SkChunkAlloc.h"
 #include "SkMessageBus.h"
 #include "SkPaintPriv.h"
@@ -298,7 +299,7 @@ void SkPicture::playback(SkCanvas* canvas, AbortCallback* callback) const {
 
     // If the query contains the whole picture, don't bother with the BBH.
     SkRect clipBounds = { 0, 0, 0, 0 };
-    (void)canvas->getClipBounds(&clipBounds);
+    (void)SkCanvasPriv::GetPlaybackBounds(canvas, &clipBounds);
     const bool useBBH = !clipBounds.contains(this->cullRect());
 
     SkRecordDraw(*fRecord, canvas, this->drawablePicts(), NULL, this->drawableCount(),
@@ -311,6 +312,9 @@ void SkPicture::playback(SkCanvas* canvas, AbortCallback* callback) const {
 
 static const char kMagic[] = { 's', 'k', 'i', 'a', 'p', 'i', 'c', 't' };
 
+// Since V41, the bool following the SkPictInfo header is padded out to 4 bytes.
+static const size_t kBoolPadding = 3;
+
 bool SkPicture::IsValidPictInfo(const SkPictInfo& info) {
     if (0 != memcmp(info.fMagic, kMagic, sizeof(kMagic))) {
         return false;
@@ -378,25 +382,43 @@ bool SkPicture::InternalOnly_BufferIsSKP(SkReadBuffer* buffer, SkPictInfo* pInfo
     return true;
 }
 
-SkPicture* SkPicture::Forwardport(const SkPictInfo& info, const SkPictureData* data) {
+SkPicture* SkPicture::Forwardport(const SkPictInfo& info, const SkPictureData* data,
+                                  SkData* backing) {
     if (!data) {
         return NULL;
     }
     SkPicturePlayback playback(data);
     SkPictureRecorder r;
-    playback.draw(r.beginRecording(SkScalarCeilToInt(info.fCullRect.width()),
-                                   SkScalarCeilToInt(info.fCullRect.height())),
-                  NULL/*no callback*/);
+    SkCanvas* canvas = r.beginRecording(SkScalarCeilToInt(info.fCullRect.width()),
+                                        SkScalarCeilToInt(info.fCullRect.height()));
+    // Ops read out of backing can point straight into it instead of being copied.
+    r.fRecorder->setBackingData(backing);
+    playback.draw(canvas, NULL/*no callback*/);
     return r.endRecording();
 }
 
 SkPicture* SkPicture::CreateFromStream(SkStream* stream, InstallPixelRefProc proc) {
+    return CreateFromStream(stream, proc, NULL);
+}
+
+SkPicture* SkPicture::CreateFromStream(SkStream* stream, InstallPixelRefProc proc,
+                                       SkData* backing) {
     SkPictInfo info;
     if (!InternalOnly_StreamIsSKP(stream, &info) || !stream->readBool()) {
         return NULL;
     }
-    SkAutoTDelete<SkPictureData> data(SkPictureData::CreateFromStream(stream, info, proc));
-    return Forwardport(info, data);
+    if (info.fVersion >= SkReadBuffer::kAlignedStreamSections_Version &&
+        stream->skip(kBoolPadding) != kBoolPadding) {
+        return NULL;
+    }
+    SkAutoTDelete<SkPictureData> data(SkPictureData::CreateFromStream(stream, info, proc,
+                                                                      backing));
+    return Forwardport(info, data, backing);
+}
+
+SkPicture* SkPicture::CreateFromData(SkData* data, InstallPixelRefProc proc) {
+    SkMemoryStream stream(data);
+    return CreateFromStream(&stream, proc, data);
 }
 
 SkPicture* SkPicture::CreateFromBuffer(SkReadBuffer& buffer) {
@@ -443,11 +465,12 @@ void SkPicture::serialize(SkWStream* stream, SkPixelSerializer* pixelSerializer)
                                                this->drawableCount()));
 
     stream->write(&info, sizeof(info));
+    stream->writeBool(SkToBool(data));
+    // Keep everything after that bool 4-byte aligned, so it can be read in place.
+    static const uint8_t kZeroes[kBoolPadding] = { 0, 0, 0 };
+    stream->write(kZeroes, kBoolPadding);
     if (data) {
-        stream->writeBool(true);
         data->serialize(stream, pixelSerializer);
-    } else {
-        stream->writeBool(false);
     }
 }
 
@@ -139,6 +139,13 @@ static void write_tag_size(SkWStream* stream, uint32_t tag, size_t size) {
     stream->write32(SkToU32(size));
 }
 
+// Since V41 the factory and typeface sections, whose lengths are not naturally multiples of 4,
+// are zero-padded so that everything after them stays 4-byte aligned.
+static void write_padding(SkWStream* stream, size_t sectionSize) {
+    static const uint8_t kZeroes[3] = { 0, 0, 0 };
+    stream->write(kZeroes, SkAlign4(sectionSize) - sectionSize);
+}
+
 void SkPictureData::WriteFactories(SkWStream* stream, const SkFactorySet& rec) {
     int count = rec.count();
 
@@ -165,12 +172,14 @@ void SkPictureData::WriteFactories(SkWStream* stream, const SkFactorySet& rec) {
     }
 
     SkASSERT(size == (stream->bytesWritten() - start));
+    write_padding(stream, size);
 }
 
 void SkPictureData::WriteTypefaces(SkWStream* stream, const SkRefCntSet& rec) {
     int count = rec.count();
 
     write_tag_size(stream, SK_PICT_TYPEFACE_TAG, count);
+    const size_t start = stream->bytesWritten();
 
     SkAutoSTMalloc<16, SkTypeface*> storage(count);
     SkTypeface** array = (SkTypeface**)storage.get();
@@ -184,6 +193,7 @@ void SkPictureData::WriteTypefaces(SkWStream* stream, const SkRefCntSet& rec) {
         array[i]->serialize(stream);
 #endif
     }
+    write_padding(stream, stream->bytesWritten() - start);
 }
 
 void SkPictureData::flattenToBuffer(SkWriteBuffer& buffer) const {
@@ -298,10 +308,57 @@ static uint32_t pictInfoFlagsToReadBufferFlags(uint32_t pictInfoFlags) {
     return rbMask;
 }
 
+static bool skip_padding(SkStream* stream, const SkPictInfo& info, size_t sectionSize) {
+    if (info.fVersion < SkReadBuffer::kAlignedStreamSections_Version) {
+        return true;
+    }
+    const size_t padding = SkAlign4(sectionSize) - sectionSize;
+    return stream->skip(padding) == padding;
+}
+
+namespace {
+// Passes reads through to another stream, counting the bytes read.
+class CountingStream : public SkStream {
+public:
+    explicit CountingStream(SkStream* stream) : fStream(stream), fBytesRead(0) {}
+
+    size_t read(void* buffer, size_t size) override {
+        const size_t bytesRead = fStream->read(buffer, size);
+        fBytesRead += bytesRead;
+        return bytesRead;
+    }
+    bool isAtEnd() const override { return fStream->isAtEnd(); }
+
+    size_t bytesRead() const { return fBytesRead; }
+
+private:
+    SkStream* fStream;
+    size_t fBytesRead;
+};
+}  // namespace
+
+// If stream is reading straight out of backing's memory, and the next size bytes are 4-byte
+// aligned there, skip over them and return them as a reference into backing.  Otherwise NULL.
+static SkData* share_from_stream(SkStream* stream, SkData* backing, size_t size) {
+    if (NULL == backing || !stream->hasPosition() || stream->getMemoryBase() != backing->data()) {
+        return NULL;
+    }
+    const size_t offset = stream->getPosition();
+    if (!SkIsAlign4((uintptr_t)backing->bytes() + offset) ||
+        offset > backing->size() || size > backing->size() - offset) {
+        return NULL;
+    }
+    if (stream->skip(size) != size) {
+        return NULL;
+    }
+    return SkData::NewSubset(backing, offset, size);
+}
+
 bool SkPictureData::parseStreamTag(SkStream* stream,
                                    uint32_t tag,
                                    uint32_t size,
-                                   SkPicture::InstallPixelRefProc proc) {
+                                   SkPicture::InstallPixelRefProc proc,
+                                   SkData* backing) {
     /*
      *  By the time we encounter BUFFER_SIZE_TAG, we need to have already seen
      *  its dependents: FACTORY_TAG and TYPEFACE_TAG. These two are not required
@@ -316,13 +373,17 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
     switch (tag) {
         case SK_PICT_READER_TAG:
             SkASSERT(NULL == fOpData);
-            fOpData = SkData::NewFromStream(stream, size);
+            fOpData = share_from_stream(stream, backing, size);
+            if (!fOpData) {
+                fOpData = SkData::NewFromStream(stream, size);
+            }
             if (!fOpData) {
                 return false;
             }
             break;
         case SK_PICT_FACTORY_TAG: {
             SkASSERT(!haveBuffer);
+            const size_t chunkSize = size;
             size = stream->readU32();
             fFactoryPlayback = SkNEW_ARGS(SkFactoryPlayback, (size));
             for (size_t i = 0; i < size; i++) {
@@ -334,13 +395,17 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
                 }
                 fFactoryPlayback->base()[i] = SkFlattenable::NameToFactory(str.c_str());
             }
+            if (!skip_padding(stream, fInfo, chunkSize)) {
+                return false;
+            }
         } break;
         case SK_PICT_TYPEFACE_TAG: {
             SkASSERT(!haveBuffer);
             const int count = SkToInt(size);
             fTFPlayback.setCount(count);
+            CountingStream counter(stream);
             for (int i = 0; i < count; i++) {
-                SkAutoTUnref<SkTypeface> tf(SkTypeface::Deserialize(stream));
+                SkAutoTUnref<SkTypeface> tf(SkTypeface::Deserialize(&counter));
                 if (!tf.get()) {    // failed to deserialize
                     // fTFPlayback asserts it never has a null, so we plop in
                     // the default here.
@@ -348,6 +413,9 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
                 }
                 fTFPlayback.set(i, tf);
             }
+            if (!skip_padding(stream, fInfo, counter.bytesRead())) {
+                return false;
+            }
         } break;
         case SK_PICT_PICTURE_TAG: {
             fPictureCount = size;
@@ -355,7 +423,7 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
             bool success = true;
             int i = 0;
             for ( ; i < fPictureCount; i++) {
-                fPictureRefs[i] = SkPicture::CreateFromStream(stream, proc);
+                fPictureRefs[i] = SkPicture::CreateFromStream(stream, proc, backing);
                 if (NULL == fPictureRefs[i]) {
                     success = false;
                     break;
@@ -373,13 +441,15 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
             }
         } break;
         case SK_PICT_BUFFER_SIZE_TAG: {
-            SkAutoMalloc storage(size);
-            if (stream->read(storage.get(), size) != size) {
+            SkAutoDataUnref shared(share_from_stream(stream, backing, size));
+            SkAutoMalloc storage;
+            if (!shared && stream->read(storage.reset(size), size) != size) {
                 return false;
             }
 
             /* Should we use SkValidatingReadBuffer instead? */
-            SkReadBuffer buffer(storage.get(), size);
+            SkReadBuffer buffer(shared ? shared->data() : storage.get(), size);
+            buffer.setBackingData(shared);
             buffer.setFlags(pictInfoFlagsToReadBufferFlags(fInfo.fFlags));
             buffer.setVersion(fInfo.fVersion);
 
@@ -461,9 +531,13 @@ bool SkPictureData::parseBufferTag(SkReadBuffer& buffer,
             }
         } break;
         case SK_PICT_READER_TAG: {
-            SkAutoDataUnref data(SkData::NewUninitialized(size));
-            if (!buffer.readByteArray(data->writable_data(), size) ||
-                !buffer.validate(NULL == fOpData)) {
+            // If the buffer is backed by an SkData, this can share its ops instead of copying.
+            SkAutoDataUnref data(buffer.readByteArrayAsData());
+            if (data->size() != size) {
+                (void)buffer.validate(false);
+                return false;
+            }
+            if (!buffer.validate(NULL == fOpData)) {
                 return false;
             }
             SkASSERT(NULL == fOpData);
@@ -504,10 +578,11 @@ bool SkPictureData::parseBufferTag(SkReadBuffer& buffer,
 
 SkPictureData* SkPictureData::CreateFromStream(SkStream* stream,
                                                const SkPictInfo& info,
-                                               SkPicture::InstallPixelRefProc proc) {
+                                               SkPicture::InstallPixelRefProc proc,
+                                               SkData* backing) {
     SkAutoTDelete<SkPictureData> data(SkNEW_ARGS(SkPictureData, (info)));
 
-    if (!data->parseStream(stream, proc)) {
+    if (!data->parseStream(stream, proc, backing)) {
         return NULL;
     }
     return data.detach();
@@ -525,7 +600,8 @@ SkPictureData* SkPictureData::CreateFromBuffer(SkReadBuffer& buffer,
 }
 
 bool SkPictureData::parseStream(SkStream* stream,
-                                SkPicture::InstallPixelRefProc proc) {
+                                SkPicture::InstallPixelRefProc proc,
+                                SkData* backing) {
     for (;;) {
         uint32_t tag = stream->readU32();
         if (SK_PICT_EOF_TAG == tag) {
@@ -533,7 +609,7 @@ bool SkPictureData::parseStream(SkStream* stream,
         }
 
         uint32_t size = stream->readU32();
-        if (!this->parseStreamTag(stream, tag, size, proc)) {
+        if (!this->parseStreamTag(stream, tag, size, proc, backing)) {
             return false; // we're invalid
         }
     }
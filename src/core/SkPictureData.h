@@ -58,10 +58,12 @@ struct SkPictInfo {
 class SkPictureData {
 public:
     SkPictureData(const SkPictureRecord& record, const SkPictInfo&, bool deepCopyOps);
-    // Does not affect ownership of SkStream.
+    // Does not affect ownership of SkStream.  If the stream reads from backing's memory, the
+    // op data and raw bitmap pixels may be references into backing rather than copies.
     static SkPictureData* CreateFromStream(SkStream*,
                                            const SkPictInfo&,
-                                           SkPicture::InstallPixelRefProc);
+                                           SkPicture::InstallPixelRefProc,
+                                           SkData* backing = NULL);
     static SkPictureData* CreateFromBuffer(SkReadBuffer&, const SkPictInfo&);
 
     virtual ~SkPictureData();
@@ -81,7 +83,7 @@ protected:
     explicit SkPictureData(const SkPictInfo& info);
 
     // Does not affect ownership of SkStream.
-    bool parseStream(SkStream*, SkPicture::InstallPixelRefProc);
+    bool parseStream(SkStream*, SkPicture::InstallPixelRefProc, SkData* backing);
     bool parseBuffer(SkReadBuffer& buffer);
 
 public:
@@ -138,7 +140,8 @@ private:
 
     // these help us with reading/writing
     // Does not affect ownership of SkStream.
-    bool parseStreamTag(SkStream*, uint32_t tag, uint32_t size, SkPicture::InstallPixelRefProc);
+    bool parseStreamTag(SkStream*, uint32_t tag, uint32_t size, SkPicture::InstallPixelRefProc,
+                        SkData* backing);
     bool parseBufferTag(SkReadBuffer&, uint32_t tag, uint32_t size);
     void flattenToBuffer(SkWriteBuffer&) const;
 
@@ -6,8 +6,10 @@
  */
 
 #include "SkRTree.h"
+#include "SkTSort.h"
 
-SkRTree::SkRTree(SkScalar aspectRatio) : fCount(0), fAspectRatio(aspectRatio) {}
+SkRTree::SkRTree(SkScalar aspectRatio, BulkLoad bulkLoad)
+    : fCount(0), fAspectRatio(aspectRatio), fBulkLoad(bulkLoad) {}
 
 SkRect SkRTree::getRootBound() const {
     if (fCount) {
@@ -44,7 +46,10 @@ void SkRTree::insert(const SkRect boundsArray[], int N) {
             fRoot.fSubtree = n;
             fRoot.fBounds  = branches[0].fBounds;
         } else {
-            fNodes.setReserve(CountNodes(fCount, fAspectRatio));
+            if (kHilbert_BulkLoad == fBulkLoad) {
+                HilbertSort(&branches);
+            }
+            fNodes.setReserve(CountNodes(fCount, fAspectRatio, fBulkLoad));
             fRoot = this->bulkLoad(&branches);
         }
     }
@@ -59,8 +64,77 @@ SkRTree::Node* SkRTree::allocateNodeAtLevel(uint16_t level) {
     return out;
 }
 
+// Maps (x,y) in [0, 2^16)^2 to its distance along the Hilbert curve filling that square.
+static uint32_t hilbert_index(uint32_t x, uint32_t y) {
+    uint32_t d = 0;
+    for (uint32_t s = 1 << 15; s > 0; s >>= 1) {
+        const uint32_t rx = (x & s) ? 1 : 0,
+                       ry = (y & s) ? 1 : 0;
+        d += s * s * ((3 * rx) ^ ry);
+        // Rotate the quadrant so the curve inside it runs the right way.
+        if (0 == ry) {
+            if (1 == rx) {
+                x = 0xFFFF - x;
+                y = 0xFFFF - y;
+            }
+            SkTSwap(x, y);
+        }
+    }
+    return d;
+}
+
+namespace {
+struct HilbertKey {
+    uint32_t fKey;
+    int      fIndex;
+
+    bool operator<(const HilbertKey& that) const {
+        return fKey < that.fKey || (fKey == that.fKey && fIndex < that.fIndex);
+    }
+};
+}  // namespace
+
+void SkRTree::HilbertSort(SkTDArray<Branch>* branches) {
+    const int count = branches->count();
+    SkRect bounds = (*branches)[0].fBounds;
+    for (int i = 1; i < count; i++) {
+        bounds.join((*branches)[i].fBounds);
+    }
+
+    // Scale rect centers to fill the 16-bit grid the Hilbert curve is defined over.
+    const SkScalar kGrid = 0xFFFF;
+    const SkScalar sx = bounds.width()  > 0 ? kGrid / bounds.width()  : 0,
+                   sy = bounds.height() > 0 ? kGrid / bounds.height() : 0;
+
+    SkAutoTMalloc<HilbertKey> keys(count);
+    for (int i = 0; i < count; i++) {
+        const SkRect& r = (*branches)[i].fBounds;
+        const SkScalar x = (r.centerX() - bounds.fLeft) * sx,
+                       y = (r.centerY() - bounds.fTop)  * sy;
+        keys[i].fKey   = hilbert_index(SkPin32(SkScalarFloorToInt(x), 0, 0xFFFF),
+                                       SkPin32(SkScalarFloorToInt(y), 0, 0xFFFF));
+        keys[i].fIndex = i;
+    }
+    SkTQSort(keys.get(), keys.get() + count - 1);
+
+    SkTDArray<Branch> sorted;
+    sorted.setCount(count);
+    for (int i = 0; i < count; i++) {
+        sorted[i] = (*branches)[keys[i].fIndex];
+    }
+    branches->swap(sorted);
+}
+
+int SkRTree::CountStrips(int numBranches, SkScalar aspectRatio, BulkLoad bulkLoad) {
+    if (kHilbert_BulkLoad == bulkLoad) {
+        // Branches are already in Hilbert order, so we just pack them in one long run.
+        return 1;
+    }
+    return SkScalarCeilToInt(SkScalarSqrt(SkIntToScalar(numBranches) / aspectRatio));
+}
+
 // This function parallels bulkLoad, but just counts how many nodes bulkLoad would allocate.
-int SkRTree::CountNodes(int branches, SkScalar aspectRatio) {
+int SkRTree::CountNodes(int branches, SkScalar aspectRatio, BulkLoad bulkLoad) {
     if (branches == 1) {
         return 1;
     }
@@ -74,7 +148,7 @@ int SkRTree::CountNodes(int branches, SkScalar aspectRatio) {
             remainder = kMinChildren - remainder;
         }
     }
-    int numStrips = SkScalarCeilToInt(SkScalarSqrt(SkIntToScalar(numBranches) / aspectRatio));
+    int numStrips = CountStrips(numBranches, aspectRatio, bulkLoad);
     int numTiles  = SkScalarCeilToInt(SkIntToScalar(numBranches) / SkIntToScalar(numStrips));
     int currentBranch = 0;
     int nodes = 0;
@@ -97,7 +171,7 @@ int SkRTree::CountNodes(int branches, SkScalar aspectRatio) {
             }
         }
     }
-    return nodes + CountNodes(nodes, aspectRatio);
+    return nodes + CountNodes(nodes, aspectRatio, bulkLoad);
 }
 
 SkRTree::Branch SkRTree::bulkLoad(SkTDArray<Branch>* branches, int level) {
@@ -122,7 +196,7 @@ SkRTree::Branch SkRTree::bulkLoad(SkTDArray<Branch>* branches, int level) {
         }
     }
 
-    int numStrips = SkScalarCeilToInt(SkScalarSqrt(SkIntToScalar(numBranches) / fAspectRatio));
+    int numStrips = CountStrips(numBranches, fAspectRatio, fBulkLoad);
     int numTiles  = SkScalarCeilToInt(SkIntToScalar(numBranches) / SkIntToScalar(numStrips));
     int currentBranch = 0;
 
@@ -163,7 +237,13 @@ SkRTree::Branch SkRTree::bulkLoad(SkTDArray<Branch>* branches, int level) {
 
 void SkRTree::search(const SkRect& query, SkTDArray<unsigned>* results) const {
     if (fCount > 0 && SkRect::Intersects(fRoot.fBounds, query)) {
+        const int start = results->count();
         this->search(fRoot.fSubtree, query, results);
+        if (kHilbert_BulkLoad == fBulkLoad && results->count() - start > 1) {
+            // STR keeps rects in their original order, but Hilbert packing shuffles them.
+            // Callers expect ops back in the order they were inserted.
+            SkTQSort(results->begin() + start, results->end() - 1);
+        }
     }
 }
 
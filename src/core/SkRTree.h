@@ -18,27 +18,35 @@
  * bounding rectangles.
  *
  * It only supports bulk-loading, i.e. creation from a batch of bounding rectangles.
- * This performs a bottom-up bulk load using the STR (sort-tile-recursive) algorithm.
+ * This performs a bottom-up bulk load using either the STR (sort-tile-recursive) algorithm or
+ * Hilbert packing, which sorts rects by the position of their centers along a Hilbert curve and
+ * then fills each node with the next run of rects in that order.  SkIncrementalRTree builds on
+ * this to support appending rects after the first insert().
  *
- * TODO: Experiment with other bulk-load algorithms (in particular the Hilbert pack variant,
- * which groups rects by position on the Hilbert curve, is probably worth a look). There also
- * exist top-down bulk load variants (VAMSplit, TopDownGreedy, etc).
+ * TODO: There also exist top-down bulk load variants (VAMSplit, TopDownGreedy, etc).
  *
  * For more details see:
  *
  *  Beckmann, N.; Kriegel, H. P.; Schneider, R.; Seeger, B. (1990). "The R*-tree:
  *      an efficient and robust access method for points and rectangles"
+ *
+ *  Kamel, I.; Faloutsos, C. (1993). "On packing R-trees"
  */
 class SkRTree : public SkBBoxHierarchy {
 public:
     SK_DECLARE_INST_COUNT(SkRTree)
 
+    enum BulkLoad {
+        kSTR_BulkLoad,      // Tile rects in their given order.  Fastest to build.
+        kHilbert_BulkLoad,  // Sort rects along a Hilbert curve first.  Tighter nodes.
+    };
+
     /**
      * If you have some prior information about the distribution of bounds you're expecting, you
-     * can provide an optional aspect ratio parameter. This allows the bulk-load algorithm to
-     * create better proportioned tiles of rectangles.
+     * can provide an optional aspect ratio parameter. This allows the STR bulk-load algorithm to
+     * create better proportioned tiles of rectangles.  Hilbert packing ignores it.
      */
-    explicit SkRTree(SkScalar aspectRatio = 1);
+    explicit SkRTree(SkScalar aspectRatio = 1, BulkLoad = kSTR_BulkLoad);
     virtual ~SkRTree() {}
 
     void insert(const SkRect[], int N) override;
@@ -82,13 +90,20 @@ private:
     Branch bulkLoad(SkTDArray<Branch>* branches, int level = 0);
 
     // How many times will bulkLoad() call allocateNodeAtLevel()?
-    static int CountNodes(int branches, SkScalar aspectRatio);
+    static int CountNodes(int branches, SkScalar aspectRatio, BulkLoad);
+
+    // How many strips of tiles should bulkLoad() arrange numBranches nodes' worth of branches in?
+    static int CountStrips(int numBranches, SkScalar aspectRatio, BulkLoad);
+
+    // Reorder branches by the position of their centers along a Hilbert curve.
+    static void HilbertSort(SkTDArray<Branch>* branches);
 
     Node* allocateNodeAtLevel(uint16_t level);
 
     // This is the count of data elements (rather than total nodes in the tree)
     int fCount;
     SkScalar fAspectRatio;
+    BulkLoad fBulkLoad;
     Branch fRoot;
     SkTDArray<Node> fNodes;
 
@@ -0,0 +1,280 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkPMFloatProcs.h"
+#include "SkRasterPipeline.h"
+
+typedef SkRasterPipeline::Stage Stage;
+
+#define STAGE_PARAMS const Stage* st, int x, int n, Sk4f s0, Sk4f s1, Sk4f s2, Sk4f s3, \
+                                                    Sk4f d0, Sk4f d1, Sk4f d2, Sk4f d3
+
+static const float gInv255 = 0.0039215683f; //  (1.0f / 255) - ULP == SkBits2Float(0x3B808080)
+
+// Stages that touch memory come in two flavors: the body, for four pixels, and the tail, for the
+// last one to three pixels of a span. Colors past n are left zero in the tail, not uninitialized.
+
+template <bool kIsTail>
+static void load_src(STAGE_PARAMS) {
+    const SkPMFloat* src = st->ctx<const SkPMFloat*>() + x;
+    if (!kIsTail) {
+        st->next(x, n, src[0], src[1], src[2], src[3], d0, d1, d2, d3);
+        return;
+    }
+    SkPMFloat srcF[4] = { Sk4f(0), Sk4f(0), Sk4f(0), Sk4f(0) };
+    for (int i = 0; i < n; i++) {
+        srcF[i] = src[i];
+    }
+    st->next(x, n, srcF[0], srcF[1], srcF[2], srcF[3], d0, d1, d2, d3);
+}
+
+static void constant_src(STAGE_PARAMS) {
+    const SkPMFloat& src = *st->ctx<const SkPMFloat*>();
+    st->next(x, n, src, src, src, src, d0, d1, d2, d3);
+}
+
+static void color_matrix(STAGE_PARAMS) {
+    SkPMFloat src[4] = { s0, s1, s2, s3 };
+    st->ctx<const SkPMFloatColorMatrix*>()->filterSpan(src, n, src);
+    st->next(x, n, src[0], src[1], src[2], src[3], d0, d1, d2, d3);
+}
+
+template <bool kIsTail>
+static void load_dst(STAGE_PARAMS) {
+    const SkPMColor* dst = *st->ctx<SkPMColor* const*>() + x;
+    if (!kIsTail) {
+        // One at a time keeps the colors in registers; From4PMColors() writes them to memory.
+        st->next(x, n, s0, s1, s2, s3, SkPMFloat(dst[0]), SkPMFloat(dst[1]),
+                                       SkPMFloat(dst[2]), SkPMFloat(dst[3]));
+        return;
+    }
+    SkPMFloat dstF[4] = { Sk4f(0), Sk4f(0), Sk4f(0), Sk4f(0) };
+    for (int i = 0; i < n; i++) {
+        dstF[i] = SkPMFloat(dst[i]);
+    }
+    st->next(x, n, s0, s1, s2, s3, dstF[0], dstF[1], dstF[2], dstF[3]);
+}
+
+static Sk4f lerp(const Sk4f& d, const Sk4f& s, const Sk4f& coverage) {
+    return d + (s - d) * coverage;
+}
+
+template <bool kIsTail>
+static void lerp_u8(STAGE_PARAMS) {
+    const SkAlpha* aa = *st->ctx<const SkAlpha* const*>() + x;
+    float c[4] = { 0, 0, 0, 0 };
+    for (int i = 0; i < (kIsTail ? n : 4); i++) {
+        c[i] = aa[i] * gInv255;
+    }
+    st->next(x, n, lerp(d0, s0, Sk4f(c[0])), lerp(d1, s1, Sk4f(c[1])),
+                   lerp(d2, s2, Sk4f(c[2])), lerp(d3, s3, Sk4f(c[3])), d0, d1, d2, d3);
+}
+
+static void lerp_constant(STAGE_PARAMS) {
+    const Sk4f c(*st->ctx<const float*>());
+    st->next(x, n, lerp(d0, s0, c), lerp(d1, s1, c), lerp(d2, s2, c), lerp(d3, s3, c),
+             d0, d1, d2, d3);
+}
+
+template <bool kIsTail>
+static void store(STAGE_PARAMS) {
+    SkPMColor* dst = *st->ctx<SkPMColor* const*>() + x;
+    if (!kIsTail) {
+        SkPMFloat::RoundClampTo4PMColors(s0, s1, s2, s3, dst);
+        return;
+    }
+    const SkPMFloat src[4] = { s0, s1, s2, s3 };
+    for (int i = 0; i < n; i++) {
+        dst[i] = src[i].roundClamp();
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// The separable modes, on one premultiplied color. The alpha lane works out right from the same
+// expression as the color lanes wherever the comments don't say otherwise.
+
+static Sk4f sa(const SkPMFloat& s) { return Sk4f(s.a()); }
+static Sk4f inv(const Sk4f& a) { return Sk4f(255) - a; }
+
+struct Src      { static Sk4f Xfer(const SkPMFloat& s, const SkPMFloat&  ) { return s; } };
+struct SrcOver  {
+    static Sk4f Xfer(const SkPMFloat& s, const SkPMFloat& d) {
+        return s + d * inv(sa(s)) * Sk4f(gInv255);
+    }
+};
+struct DstOver  {
+    static Sk4f Xfer(const SkPMFloat& s, const SkPMFloat& d) {
+        return d + s * inv(sa(d)) * Sk4f(gInv255);
+    }
+};
+struct SrcIn    {
+    static Sk4f Xfer(const SkPMFloat& s, const SkPMFloat& d) {
+        return s * sa(d) * Sk4f(gInv255);
+    }
+};
+struct DstIn    {
+    static Sk4f Xfer(const SkPMFloat& s, const SkPMFloat& d) {
+        return d * sa(s) * Sk4f(gInv255);
+    }
+};
+struct SrcOut   {
+    static Sk4f Xfer(const SkPMFloat& s, const SkPMFloat& d) {
+        return s * inv(sa(d)) * Sk4f(gInv255);
+    }
+};
+struct DstOut   {
+    static Sk4f Xfer(const SkPMFloat& s, const SkPMFloat& d) {
+        return d * inv(sa(s)) * Sk4f(gInv255);
+    }
+};
+struct SrcATop  {
+    static Sk4f Xfer(const SkPMFloat& s, const SkPMFloat& d) {
+        return (s * sa(d) + d * inv(sa(s))) * Sk4f(gInv255);
+    }
+};
+struct DstATop  {
+    static Sk4f Xfer(const SkPMFloat& s, const SkPMFloat& d) {
+        return (d * sa(s) + s * inv(sa(d))) * Sk4f(gInv255);
+    }
+};
+struct Xor      {
+    static Sk4f Xfer(const SkPMFloat& s, const SkPMFloat& d) {
+        return (s * inv(sa(d)) + d * inv(sa(s))) * Sk4f(gInv255);
+    }
+};
+// Left for the store to clamp, so that coverage scales the source, as in SkXfermode's Plus.
+struct Plus     {
+    static Sk4f Xfer(const SkPMFloat& s, const SkPMFloat& d) {
+        return s + d;
+    }
+};
+struct Modulate {
+    static Sk4f Xfer(const SkPMFloat& s, const SkPMFloat& d) {
+        return s * d * Sk4f(gInv255);
+    }
+};
+struct Screen   {
+    static Sk4f Xfer(const SkPMFloat& s, const SkPMFloat& d) {
+        return s + d - s * d * Sk4f(gInv255);
+    }
+};
+// Alpha: sa + da - max(sa * da, da * sa), i.e. srcover.
+struct Darken   {
+    static Sk4f Xfer(const SkPMFloat& s, const SkPMFloat& d) {
+        return s + d - Sk4f::Max(s * sa(d), d * sa(s)) * Sk4f(gInv255);
+    }
+};
+struct Lighten  {
+    static Sk4f Xfer(const SkPMFloat& s, const SkPMFloat& d) {
+        return s + d - Sk4f::Min(s * sa(d), d * sa(s)) * Sk4f(gInv255);
+    }
+};
+struct Multiply {
+    static Sk4f Xfer(const SkPMFloat& s, const SkPMFloat& d) {
+        return s + d + (s * (d - sa(d)) - d * sa(s)) * Sk4f(gInv255);
+    }
+};
+// Colors subtract the min twice, alpha once (srcover).
+struct Difference {
+    static Sk4f Xfer(const SkPMFloat& s, const SkPMFloat& d) {
+        const Sk4f min = Sk4f::Min(s * sa(d), d * sa(s)) * Sk4f(gInv255);
+        return s + d - min - min * SkPMFloat(0, 1, 1, 1);
+    }
+};
+struct Exclusion {
+    static Sk4f Xfer(const SkPMFloat& s, const SkPMFloat& d) {
+        const Sk4f prod = s * d * Sk4f(gInv255);
+        return s + d - prod - prod * SkPMFloat(0, 1, 1, 1);
+    }
+};
+
+template <typename Mode>
+static void blend(STAGE_PARAMS) {
+    st->next(x, n, Mode::Xfer(s0, d0), Mode::Xfer(s1, d1), Mode::Xfer(s2, d2), Mode::Xfer(s3, d3),
+             d0, d1, d2, d3);
+}
+
+// Overlay, the dodges, burns and lights, and the non-separable modes have no stage.
+static SkRasterPipeline::Fn blend_fn(SkXfermode::Mode mode) {
+    switch (mode) {
+        case SkXfermode::kSrc_Mode:        return blend<Src>;
+        case SkXfermode::kSrcOver_Mode:    return blend<SrcOver>;
+        case SkXfermode::kDstOver_Mode:    return blend<DstOver>;
+        case SkXfermode::kSrcIn_Mode:      return blend<SrcIn>;
+        case SkXfermode::kDstIn_Mode:      return blend<DstIn>;
+        case SkXfermode::kSrcOut_Mode:     return blend<SrcOut>;
+        case SkXfermode::kDstOut_Mode:     return blend<DstOut>;
+        case SkXfermode::kSrcATop_Mode:    return blend<SrcATop>;
+        case SkXfermode::kDstATop_Mode:    return blend<DstATop>;
+        case SkXfermode::kXor_Mode:        return blend<Xor>;
+        case SkXfermode::kPlus_Mode:       return blend<Plus>;
+        case SkXfermode::kModulate_Mode:   return blend<Modulate>;
+        case SkXfermode::kScreen_Mode:     return blend<Screen>;
+        case SkXfermode::kDarken_Mode:     return blend<Darken>;
+        case SkXfermode::kLighten_Mode:    return blend<Lighten>;
+        case SkXfermode::kMultiply_Mode:   return blend<Multiply>;
+        case SkXfermode::kDifference_Mode: return blend<Difference>;
+        case SkXfermode::kExclusion_Mode:  return blend<Exclusion>;
+        default:                           return NULL;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void SkRasterPipeline::append(Fn body, Fn tail, const void* ctx) {
+    Stage* stage = &fBody.push_back();
+    stage->fFn = body;
+    stage->fCtx = ctx;
+    stage = &fTail.push_back();
+    stage->fFn = tail;
+    stage->fCtx = ctx;
+}
+
+void SkRasterPipeline::append(StockStage stage, const void* ctx) {
+    static const struct { Fn fBody, fTail; } kStock[] = {
+        { load_src<false>,  load_src<true>  },
+        { constant_src,     constant_src    },
+        { color_matrix,     color_matrix    },
+        { load_dst<false>,  load_dst<true>  },
+        { lerp_u8<false>,   lerp_u8<true>   },
+        { lerp_constant,    lerp_constant   },
+        { store<false>,     store<true>     },
+    };
+    SkASSERT((unsigned)stage < SK_ARRAY_COUNT(kStock));
+    this->append(kStock[stage].fBody, kStock[stage].fTail, ctx);
+}
+
+bool SkRasterPipeline::appendBlend(SkXfermode::Mode mode) {
+    Fn fn = blend_fn(mode);
+    if (NULL == fn) {
+        return false;
+    }
+    this->append(fn);
+    return true;
+}
+
+bool SkRasterPipeline::CanBlend(SkXfermode::Mode mode) {
+    return SkToBool(blend_fn(mode));
+}
+
+void SkRasterPipeline::extend(const SkRasterPipeline& src) {
+    fBody.push_back_n(src.fBody.count(), src.fBody.begin());
+    fTail.push_back_n(src.fTail.count(), src.fTail.begin());
+}
+
+void SkRasterPipeline::run(int count) const {
+    SkASSERT(!fBody.empty());
+    const Sk4f zero(0);
+    int x = 0;
+    for (const Stage* body = fBody.begin(); x + 4 <= count; x += 4) {
+        body->fFn(body, x, 4, zero, zero, zero, zero, zero, zero, zero, zero);
+    }
+    if (x < count) {
+        const Stage* tail = fTail.begin();
+        tail->fFn(tail, x, count - x, zero, zero, zero, zero, zero, zero, zero, zero);
+    }
+}
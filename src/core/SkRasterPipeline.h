@@ -0,0 +1,97 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkRasterPipeline_DEFINED
+#define SkRasterPipeline_DEFINED
+
+#include "SkNx.h"
+#include "SkPMFloat.h"
+#include "SkTArray.h"
+#include "SkXfermode.h"
+
+/**
+ *  SkRasterPipeline runs a span of pixels through a list of small stages, four pixels at a
+ *  time: load the source, color matrix, load the destination, blend, lerp by coverage, store.
+ *  Each stage is a function that does its part and calls the next, passing the four source and
+ *  four destination colors along as arguments, so they stay in SIMD registers from the first
+ *  stage to the last and only the load and store stages touch memory. Any combination of
+ *  stages is vectorized this way, without a blitter written for it.
+ *
+ *  Colors are premultiplied SkPMFloats, with components in [0, 255]. Shaders work a span at a
+ *  time, so the caller shades the span first and the pipeline loads from that.
+ *
+ *  A pipeline is built once, when the blitter is chosen. Stages read their state through the
+ *  ctx pointer they were appended with, so per-span state (the destination row, the coverage)
+ *  lives with the caller, which updates it before each run().
+ */
+class SkRasterPipeline {
+public:
+    struct Stage;
+
+    /**
+     *  x is the index of the first of the four pixels in the span, n how many of them are
+     *  live: 4, except at the end of a span. Every stage but the last ends with next(),
+     *  passing its results on.
+     */
+    typedef void (*Fn)(const Stage*, int x, int n, Sk4f s0, Sk4f s1, Sk4f s2, Sk4f s3,
+                                                   Sk4f d0, Sk4f d1, Sk4f d2, Sk4f d3);
+
+    struct Stage {
+        template <typename T>
+        T ctx() const { return static_cast<T>(fCtx); }
+
+        void next(int x, int n, Sk4f s0, Sk4f s1, Sk4f s2, Sk4f s3,
+                                Sk4f d0, Sk4f d1, Sk4f d2, Sk4f d3) const {
+            this[1].fFn(this + 1, x, n, s0, s1, s2, s3, d0, d1, d2, d3);
+        }
+
+        Fn          fFn;
+        const void* fCtx;
+    };
+
+    enum StockStage {
+        kLoadSrc_StockStage,       // ctx: const SkPMFloat*, the shaded span
+        kConstantSrc_StockStage,   // ctx: const SkPMFloat*, one color for every pixel
+        kColorMatrix_StockStage,   // ctx: const SkPMFloatColorMatrix*
+        kLoadDst_StockStage,       // ctx: SkPMColor* const*, the destination span
+        kLerpU8_StockStage,        // ctx: const SkAlpha* const*, per pixel coverage
+        kLerpConstant_StockStage,  // ctx: const float*, coverage in [0, 1]
+        kStore_StockStage,         // ctx: SkPMColor* const*, the destination span
+    };
+
+    /**
+     *  Appends a stage running body for four pixels at a time and tail for the last one to
+     *  three pixels of a span, if any. Stages that only compute can use the same function for
+     *  both. A tail must not touch memory past n pixels, and should leave the colors past n
+     *  zero when it loads.
+     */
+    void append(Fn body, Fn tail, const void* ctx);
+    void append(Fn fn, const void* ctx = NULL) { this->append(fn, fn, ctx); }
+    void append(StockStage, const void* ctx = NULL);
+
+    /**
+     *  Appends the stage blending the source over the destination with mode, leaving the result
+     *  as the source color, which only a lerp and the store should follow: Plus leaves it
+     *  unclamped. Returns false, appending nothing, if there is no stage for mode.
+     */
+    bool appendBlend(SkXfermode::Mode mode);
+
+    /** Returns true if appendBlend(mode) would succeed. */
+    static bool CanBlend(SkXfermode::Mode mode);
+
+    /** Appends all of src's stages. */
+    void extend(const SkRasterPipeline& src);
+
+    /** Runs the pixels [0, count) of the span through the stages. The last must store them. */
+    void run(int count) const;
+
+private:
+    SkTArray<Stage, true> fBody;
+    SkTArray<Stage, true> fTail;
+};
+
+#endif
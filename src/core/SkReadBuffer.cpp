@@ -165,6 +165,24 @@ bool SkReadBuffer::readArray(void* value, size_t size, size_t elementSize) {
     return false;
 }
 
+SkData* SkReadBuffer::shareByteArray(size_t len) {
+    SkASSERT(fBackingData);
+    // The count must match, and the bytes (padded to 4) must all be there, before we hand out a
+    // reference to them.
+    const size_t available = fReader.available();
+    const bool valid = available >= sizeof(uint32_t) && this->getArrayCount() == len &&
+                       len <= available - sizeof(uint32_t) &&
+                       SkAlign4(len) <= available - sizeof(uint32_t);
+    this->validate(valid);
+    if (!valid) {
+        fReader.skip(available);
+        return SkData::NewEmpty();
+    }
+    (void)fReader.skip(sizeof(uint32_t)); // Skip array count
+    const char* bytes = (const char*)fReader.skip(SkAlign4(len));
+    return SkData::NewSubset(fBackingData, bytes - (const char*)fBackingData->data(), len);
+}
+
 bool SkReadBuffer::readByteArray(void* value, size_t size) {
     return readArray(static_cast<unsigned char*>(value), size, sizeof(unsigned char));
 }
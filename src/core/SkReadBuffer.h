@@ -56,6 +56,7 @@ public:
         kPictureImageFilterResolution_Version = 38,
         kPictureImageFilterLevel_Version   = 39,
         kImageFilterNoUniqueID_Version     = 40,
+        kAlignedStreamSections_Version     = 41,
     };
 
     /**
@@ -152,6 +153,9 @@ public:
         if (!this->validateAvailable(len)) {
             return SkData::NewEmpty();
         }
+        if (fBackingData) {
+            return this->shareByteArray(len);
+        }
         void* buffer = sk_malloc_throw(len);
         this->readByteArray(buffer, len);
         return SkData::NewFromMalloc(buffer, len);
@@ -207,6 +211,16 @@ public:
         fBitmapDecoder = bitmapDecoder;
     }
 
+    /**
+     *  Tell the buffer that the memory it reads from is owned by data (which must start exactly
+     *  where the buffer does).  Byte arrays, including raw bitmap pixels, are then returned as
+     *  references into data rather than copied out of it.
+     */
+    void setBackingData(SkData* data) {
+        SkASSERT(NULL == data || data->data() == fReader.base());
+        fBackingData.reset(SkSafeRef(data));
+    }
+
     // Default impelementations don't check anything.
     virtual bool validate(bool isValid) { return true; }
     virtual bool isValid() const { return true; }
@@ -217,11 +231,13 @@ protected:
 
 private:
     bool readArray(void* value, size_t size, size_t elementSize);
+    SkData* shareByteArray(size_t len);
 
     uint32_t fFlags;
     int fVersion;
 
     void* fMemoryPtr;
+    SkAutoTUnref<SkData> fBackingData;
 
     SkBitmapHeapReader* fBitmapStorage;
     SkTypeface** fTFArray;
@@ -8,6 +8,7 @@
 #ifndef SkRecord_DEFINED
 #define SkRecord_DEFINED
 
+#include "SkData.h"
 #include "SkRecords.h"
 #include "SkTLogic.h"
 #include "SkTemplates.h"
@@ -111,6 +112,13 @@ public:
     // need to iterate with a visitor to measure those they care for.
     size_t bytesUsed() const;
 
+    // Keep data alive as long as this SkRecord, so commands may point into it rather than alloc().
+    // A record may only point into one SkData.
+    void keepAlive(SkData* data) {
+        SkASSERT(NULL == fKeepAlive.get() || data == fKeepAlive.get());
+        fKeepAlive.reset(SkRef(data));
+    }
+
 private:
     // An SkRecord is structured as an array of pointers into a big chunk of memory where
     // records representing each canvas draw call are stored:
@@ -193,6 +201,9 @@ private:
     // chunks, returning a stable handle to that data for later retrieval.
     SkVarAlloc fAlloc;
     char fInlineAlloc[1 << kInlineAllocLgBytes];
+
+    // Memory outside fAlloc that commands point into.  See keepAlive().
+    SkAutoTUnref<SkData> fKeepAlive;
 };
 
 #endif//SkRecord_DEFINED
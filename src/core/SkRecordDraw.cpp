@@ -5,6 +5,7 @@
  * found in the LICENSE file.
  */
 
+#include "SkCanvasPriv.h"
 #include "SkLayerInfo.h"
 #include "SkRecordDraw.h"
 #include "SkPatchUtils.h"
@@ -21,11 +22,11 @@ void SkRecordDraw(const SkRecord& record,
     if (bbh) {
         // Draw only ops that affect pixels in the canvas's current clip.
         // The SkRecord and BBH were recorded in identity space.  This canvas
-        // is not necessarily in that same space.  getClipBounds() returns us
-        // this canvas' clip bounds transformed back into identity space, which
-        // lets us query the BBH.
+        // is not necessarily in that same space.  GetPlaybackBounds() returns us
+        // this canvas' clip bounds (within its tile, if any) transformed back
+        // into identity space, which lets us query the BBH.
         SkRect query;
-        if (!canvas->getClipBounds(&query)) {
+        if (!SkCanvasPriv::GetPlaybackBounds(canvas, &query)) {
             query.setEmpty();
         }
 
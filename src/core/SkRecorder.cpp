@@ -33,11 +33,15 @@ void SkDrawableList::append(SkDrawable* drawable) {
 
 SkRecorder::SkRecorder(SkRecord* record, int width, int height)
     : SkCanvas(SkIRect::MakeWH(width, height), SkCanvas::kConservativeRasterClip_InitFlag)
-    , fRecord(record) {}
+    , fRecord(record)
+    , fBackingData(NULL)
+    , fBackingDataShared(false) {}
 
 SkRecorder::SkRecorder(SkRecord* record, const SkRect& bounds)
     : SkCanvas(bounds.roundOut(), SkCanvas::kConservativeRasterClip_InitFlag)
-    , fRecord(record) {}
+    , fRecord(record)
+    , fBackingData(NULL)
+    , fBackingDataShared(false) {}
 
 void SkRecorder::reset(SkRecord* record, const SkRect& bounds) {
     this->forgetRecord();
@@ -48,6 +52,30 @@ void SkRecorder::reset(SkRecord* record, const SkRect& bounds) {
 void SkRecorder::forgetRecord() {
     fDrawableList.reset(NULL);
     fRecord = NULL;
+    fBackingData = NULL;
+    fBackingDataShared = false;
+}
+
+void SkRecorder::setBackingData(SkData* data) {
+    fBackingData = data;
+    fBackingDataShared = false;
+}
+
+bool SkRecorder::shareBackingData(const void* ptr, size_t bytes) {
+    if (NULL == fBackingData || !SkIsAlign4((uintptr_t)ptr)) {
+        return false;
+    }
+    const char* base = (const char*)fBackingData->data();
+    const char* p    = (const char*)ptr;
+    if (p < base || bytes > fBackingData->size()
+                 || SkToSizeT(p - base) > fBackingData->size() - bytes) {
+        return false;
+    }
+    if (!fBackingDataShared) {
+        fRecord->keepAlive(fBackingData);
+        fBackingDataShared = true;
+    }
+    return true;
 }
 
 // To make appending to fRecord a little less verbose.
@@ -95,6 +123,9 @@ T* SkRecorder::copy(const T src[], size_t count) {
     if (NULL == src) {
         return NULL;
     }
+    if (this->shareBackingData(src, count * sizeof(T))) {
+        return const_cast<T*>(src);
+    }
     T* dst = fRecord->alloc<T>(count);
     for (size_t i = 0; i < count; i++) {
         SkNEW_PLACEMENT_ARGS(dst + i, T, (src[i]));
@@ -110,6 +141,9 @@ char* SkRecorder::copy(const char src[], size_t count) {
     if (NULL == src) {
         return NULL;
     }
+    if (this->shareBackingData(src, count)) {
+        return const_cast<char*>(src);
+    }
     char* dst = fRecord->alloc<char>(count);
     memcpy(dst, src, count);
     return dst;
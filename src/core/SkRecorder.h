@@ -47,6 +47,11 @@ public:
     // Make SkRecorder forget entirely about its SkRecord*; all calls to SkRecorder will fail.
     void forgetRecord();
 
+    // Arrays (text, points, vertices, ...) passed to draw calls that lie inside data are recorded
+    // by reference rather than copied, with the SkRecord keeping data alive if we do so.
+    // Cleared by reset().
+    void setBackingData(SkData*);
+
     void willSave() override;
     SaveLayerStrategy willSaveLayer(const SkRect*, const SkPaint*, SkCanvas::SaveFlags) override;
     void willRestore() override {}
@@ -125,6 +130,10 @@ private:
     template <typename T>
     T* copy(const T[], size_t count);
 
+    // Can we point at these bytes in fBackingData instead of copying them?
+    // If so, makes sure fRecord keeps fBackingData alive.
+    bool shareBackingData(const void*, size_t bytes);
+
     SkIRect devBounds() const {
         SkIRect devBounds;
         this->getClipDeviceBounds(&devBounds);
@@ -132,6 +141,8 @@ private:
     }
 
     SkRecord* fRecord;
+    SkData* fBackingData;
+    bool fBackingDataShared;
 
     SkAutoTDelete<SkDrawableList> fDrawableList;
 };
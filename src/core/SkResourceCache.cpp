@@ -10,6 +10,7 @@
 #include "SkMipMap.h"
 #include "SkPixelRef.h"
 #include "SkResourceCache.h"
+#include "SkThread.h"
 
 #include <stddef.h>
 
@@ -26,6 +27,10 @@ DECLARE_SKMESSAGEBUS_MESSAGE(SkResourceCache::PurgeSharedIDMessage)
     #define SK_DEFAULT_IMAGE_CACHE_LIMIT     (2 * 1024 * 1024)
 #endif
 
+#ifndef SK_RESOURCE_CACHE_SHARD_COUNT
+    #define SK_RESOURCE_CACHE_SHARD_COUNT    8
+#endif
+
 void SkResourceCache::Key::init(void* nameSpace, uint64_t sharedID, size_t length) {
     SkASSERT(SkAlign4(length) == length);
 
@@ -53,6 +58,114 @@ void SkResourceCache::Key::init(void* nameSpace, uint64_t sharedID, size_t lengt
 class SkResourceCache::Hash :
     public SkTDynamicHash<SkResourceCache::Rec, SkResourceCache::Key> {};
 
+/**
+ *  Estimates how often each key hash has been looked up lately: a count-min sketch of small
+ *  saturating counters, all halved every kSampleSize lookups so that old popularity fades.
+ */
+class SkResourceCache::FrequencySketch {
+public:
+    FrequencySketch() : fSamples(0) {
+        sk_bzero(fCounters, sizeof(fCounters));
+    }
+
+    void increment(uint32_t hash) {
+        for (int row = 0; row < kDepth; row++) {
+            uint8_t* counter = &fCounters[row][Index(hash, row)];
+            if (*counter < kMaxCount) {
+                *counter += 1;
+            }
+        }
+        if (++fSamples == kSampleSize) {
+            for (int row = 0; row < kDepth; row++) {
+                for (int i = 0; i < kWidth; i++) {
+                    fCounters[row][i] >>= 1;
+                }
+            }
+            fSamples /= 2;
+        }
+    }
+
+    int frequency(uint32_t hash) const {
+        int freq = kMaxCount;
+        for (int row = 0; row < kDepth; row++) {
+            freq = SkTMin<int>(freq, fCounters[row][Index(hash, row)]);
+        }
+        return freq;
+    }
+
+private:
+    static const int kDepth = 4;
+    static const int kWidth = 1024;     // must be a power of 2
+    static const int kMaxCount = 15;
+    static const int kSampleSize = 10 * kWidth;
+
+    static int Index(uint32_t hash, int row) {
+        return SkChecksum::Mix(hash + row * 0x9E3779B9) & (kWidth - 1);
+    }
+
+    uint8_t fCounters[kDepth][kWidth];
+    int     fSamples;
+};
+
+static const int kShardCount = SK_RESOURCE_CACHE_SHARD_COUNT;
+
+/**
+ *  The global cache: kShardCount caches, each behind its own mutex, picked between by key
+ *  hash. Their budget is shared, so a Rec too big for a slice of it can still be cached.
+ *  A shard that pushes the total over budget purges its own least recently used Recs first,
+ *  and then the others are asked to.
+ */
+class SkResourceCacheShards {
+public:
+    struct Shard {
+        SkMutex          fMutex;
+        SkResourceCache* fCache;
+    };
+
+    SkResourceCacheShards();
+    ~SkResourceCacheShards();
+
+    int indexFor(const SkResourceCache::Key& key) const {
+        return SkChecksum::Mix(key.hash()) % kShardCount;
+    }
+
+    Shard& operator[](int i) { return fShards[i]; }
+
+    size_t bytesUsed() const { return sk_atomic_load(&fBytesUsed); }
+    int count() const { return sk_atomic_load(&fCount); }
+
+    // Called by the shards, with their mutex held.
+    void changeUsage(size_t bytesDelta, int32_t countDelta) {
+        sk_atomic_fetch_add(&fBytesUsed, bytesDelta);
+        sk_atomic_add(&fCount, countDelta);
+    }
+
+    /**
+     *  Purges the shards until the total is back under budget, starting with the one after
+     *  first. Each is first only asked to purge down to an even slice of the budget, so that
+     *  no one shard loses everything for the others' sake.
+     */
+    void purgeAsNeeded(int first) {
+        for (int pass = 0; pass < 2; pass++) {
+            for (int i = 1; i <= kShardCount; i++) {
+                Shard& shard = fShards[(first + i) % kShardCount];
+                SkAutoMutexAcquire am(shard.fMutex);
+                if (!shard.fCache->overBudget()) {
+                    return;
+                }
+                const size_t slice = shard.fCache->fTotalByteLimit / kShardCount;
+                shard.fCache->purgeAsNeeded(false, 0 == pass ? slice : 0);
+            }
+        }
+    }
+
+private:
+    Shard   fShards[kShardCount];
+    // Summed over all the shards.
+    size_t  fBytesUsed;
+    int32_t fCount;
+};
+
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -64,6 +177,8 @@ void SkResourceCache::init() {
     fCount = 0;
     fSingleAllocationByteLimit = 0;
     fAllocator = NULL;
+    fSketch = NULL;
+    fShards = NULL;
 
     // One of these should be explicit set by the caller after we return.
     fTotalByteLimit = 0;
@@ -202,6 +317,7 @@ SkResourceCache::~SkResourceCache() {
         rec = next;
     }
     delete fHash;
+    SkDELETE(fSketch);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -209,16 +325,22 @@ SkResourceCache::~SkResourceCache() {
 bool SkResourceCache::find(const Key& key, FindVisitor visitor, void* context) {
     this->checkMessages();
 
+    if (fSketch) {
+        fSketch->increment(key.hash());
+    }
+    Stats* stats = this->statsFor(key.getNamespace());
+
     Rec* rec = fHash->find(key);
     if (rec) {
         if (visitor(*rec, context)) {
             this->moveToHead(rec);  // for our LRU
+            stats->fHits += 1;
             return true;
         } else {
             this->remove(rec);  // stale
-            return false;
         }
     }
+    stats->fMisses += 1;
     return false;
 }
 
@@ -244,7 +366,15 @@ void SkResourceCache::add(Rec* rec) {
         SkDELETE(rec);
         return;
     }
-    
+
+    // Only let the new rec push out the one we'd purge first if it's more in demand.
+    if (fSketch && fTail && this->overBudget(rec->bytesUsed(), 1) &&
+            fSketch->frequency(rec->getHash()) <= fSketch->frequency(fTail->getHash())) {
+        this->statsFor(rec->getKey().getNamespace())->fRejected += 1;
+        SkDELETE(rec);
+        return;
+    }
+
     this->addToHead(rec);
     fHash->add(rec);
 
@@ -256,8 +386,9 @@ void SkResourceCache::add(Rec* rec) {
                  bytesStr.c_str(), rec, rec->getHash(), totalStr.c_str(), fCount);
     }
 
-    // since the new rec may push us over-budget, we perform a purge check now
-    this->purgeAsNeeded();
+    // since the new rec may push us over-budget, we perform a purge check now. A shard leaves
+    // the new rec for last, as the other shards may have something older to purge.
+    this->purgeAsNeeded(false, fShards ? rec->bytesUsed() : 0);
 }
 
 void SkResourceCache::remove(Rec* rec) {
@@ -269,6 +400,12 @@ void SkResourceCache::remove(Rec* rec) {
 
     fTotalBytesUsed -= used;
     fCount -= 1;
+    if (fShards) {
+        fShards->changeUsage(0 - used, -1);
+    }
+    Stats* stats = this->statsFor(rec->getKey().getNamespace());
+    stats->fCount -= 1;
+    stats->fBytesUsed -= used;
 
     if (gDumpCacheTransactions) {
         SkString bytesStr, totalStr;
@@ -281,7 +418,7 @@ void SkResourceCache::remove(Rec* rec) {
     SkDELETE(rec);
 }
 
-void SkResourceCache::purgeAsNeeded(bool forcePurge) {
+bool SkResourceCache::overBudget(size_t extraBytes, int extraCount) const {
     size_t byteLimit;
     int    countLimit;
 
@@ -293,9 +430,16 @@ void SkResourceCache::purgeAsNeeded(bool forcePurge) {
         byteLimit = fTotalByteLimit;
     }
 
+    // Shards are held to the budget of the whole global cache.
+    const size_t bytesUsed = fShards ? fShards->bytesUsed() : fTotalBytesUsed;
+    const int    count = fShards ? fShards->count() : fCount;
+    return bytesUsed + extraBytes >= byteLimit || count + extraCount >= countLimit;
+}
+
+void SkResourceCache::purgeAsNeeded(bool forcePurge, size_t minBytes) {
     Rec* rec = fTail;
     while (rec) {
-        if (!forcePurge && fTotalBytesUsed < byteLimit && fCount < countLimit) {
+        if (!forcePurge && (!this->overBudget() || fTotalBytesUsed <= minBytes)) {
             break;
         }
 
@@ -346,6 +490,36 @@ void SkResourceCache::purgeSharedID(uint64_t sharedID) {
 #endif
 }
 
+bool SkResourceCache::setUseAdmissionPolicy(bool use) {
+    const bool prev = SkToBool(fSketch);
+    if (use && !fSketch) {
+        fSketch = SkNEW(FrequencySketch);
+    } else if (!use) {
+        SkDELETE(fSketch);
+        fSketch = NULL;
+    }
+    return prev;
+}
+
+SkResourceCache::Stats* SkResourceCache::statsFor(const void* nameSpace) {
+    // There are only ever a handful of namespaces.
+    for (int i = 0; i < fStats.count(); i++) {
+        if (fStats[i].fNamespace == nameSpace) {
+            return &fStats[i].fStats;
+        }
+    }
+    NamespaceStats* entry = fStats.append();
+    entry->fNamespace = nameSpace;
+    sk_bzero(&entry->fStats, sizeof(Stats));
+    return &entry->fStats;
+}
+
+void SkResourceCache::visitStats(StatsVisitor visitor, void* context) const {
+    for (int i = 0; i < fStats.count(); i++) {
+        visitor(fStats[i].fNamespace, fStats[i].fStats, context);
+    }
+}
+
 size_t SkResourceCache::setTotalByteLimit(size_t newLimit) {
     size_t prevLimit = fTotalByteLimit;
     fTotalByteLimit = newLimit;
@@ -419,8 +593,15 @@ void SkResourceCache::addToHead(Rec* rec) {
     if (!fTail) {
         fTail = rec;
     }
-    fTotalBytesUsed += rec->bytesUsed();
+    const size_t used = rec->bytesUsed();
+    fTotalBytesUsed += used;
     fCount += 1;
+    if (fShards) {
+        fShards->changeUsage(used, 1);
+    }
+    Stats* stats = this->statsFor(rec->getKey().getNamespace());
+    stats->fCount += 1;
+    stats->fBytesUsed += used;
 
     this->validate();
 }
@@ -515,10 +696,27 @@ void SkResourceCache::checkMessages() {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-#include "SkThread.h"
+SkResourceCacheShards::SkResourceCacheShards() : fBytesUsed(0), fCount(0) {
+    for (int i = 0; i < kShardCount; i++) {
+#ifdef SK_USE_DISCARDABLE_SCALEDIMAGECACHE
+        fShards[i].fCache = SkNEW_ARGS(SkResourceCache, (SkDiscardableMemory::Create));
+#else
+        fShards[i].fCache = SkNEW_ARGS(SkResourceCache, (SK_DEFAULT_IMAGE_CACHE_LIMIT));
+#endif
+        fShards[i].fCache->fShards = this;
+    }
+}
+
+SkResourceCacheShards::~SkResourceCacheShards() {
+    for (int i = 0; i < kShardCount; i++) {
+        SkDELETE(fShards[i].fCache);
+    }
+}
+
+#include "SkOnce.h"
 
-SK_DECLARE_STATIC_MUTEX(gMutex);
-static SkResourceCache* gResourceCache = NULL;
+SK_DECLARE_STATIC_ONCE(gResourceCacheOnce);
+static SkResourceCacheShards* gResourceCache = NULL;
 static void cleanup_gResourceCache() {
     // We'll clean this up in our own tests, but disable for clients.
     // Chrome seems to have funky multi-process things going on in unit tests that
@@ -529,84 +727,170 @@ static void cleanup_gResourceCache() {
 #endif
 }
 
-/** Must hold gMutex when calling. */
-static SkResourceCache* get_cache() {
-    // gMutex is always held when this is called, so we don't need to be fancy in here.
-    gMutex.assertHeld();
-    if (NULL == gResourceCache) {
-#ifdef SK_USE_DISCARDABLE_SCALEDIMAGECACHE
-        gResourceCache = SkNEW_ARGS(SkResourceCache, (SkDiscardableMemory::Create));
-#else
-        gResourceCache = SkNEW_ARGS(SkResourceCache, (SK_DEFAULT_IMAGE_CACHE_LIMIT));
-#endif
-        atexit(cleanup_gResourceCache);
-    }
-    return gResourceCache;
+static void create_cache() {
+    gResourceCache = SkNEW(SkResourceCacheShards);
+    atexit(cleanup_gResourceCache);
+}
+
+static SkResourceCacheShards& get_shards() {
+    SkOnce(&gResourceCacheOnce, create_cache);
+    return *gResourceCache;
+}
+
+// Settings that aren't tied to a key are the same in every shard, so are read from the first.
+static SkResourceCacheShards::Shard& first_shard() {
+    return get_shards()[0];
 }
 
 size_t SkResourceCache::GetTotalBytesUsed() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->getTotalBytesUsed();
+    return get_shards().bytesUsed();
 }
 
 size_t SkResourceCache::GetTotalByteLimit() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->getTotalByteLimit();
+    SkResourceCacheShards::Shard& shard = first_shard();
+    SkAutoMutexAcquire am(shard.fMutex);
+    return shard.fCache->getTotalByteLimit();
 }
 
 size_t SkResourceCache::SetTotalByteLimit(size_t newLimit) {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->setTotalByteLimit(newLimit);
+    SkResourceCacheShards& shards = get_shards();
+    size_t prevLimit = 0;
+    for (int i = 0; i < kShardCount; i++) {
+        SkAutoMutexAcquire am(shards[i].fMutex);
+        prevLimit = shards[i].fCache->fTotalByteLimit;
+        shards[i].fCache->fTotalByteLimit = newLimit;
+    }
+    if (newLimit < prevLimit) {
+        shards.purgeAsNeeded(0);
+    }
+    return prevLimit;
 }
 
 SkResourceCache::DiscardableFactory SkResourceCache::GetDiscardableFactory() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->discardableFactory();
+    SkResourceCacheShards::Shard& shard = first_shard();
+    SkAutoMutexAcquire am(shard.fMutex);
+    return shard.fCache->discardableFactory();
 }
 
 SkBitmap::Allocator* SkResourceCache::GetAllocator() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->allocator();
+    SkResourceCacheShards::Shard& shard = first_shard();
+    SkAutoMutexAcquire am(shard.fMutex);
+    return shard.fCache->allocator();
 }
 
 SkCachedData* SkResourceCache::NewCachedData(size_t bytes) {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->newCachedData(bytes);
+    SkResourceCacheShards::Shard& shard = first_shard();
+    SkAutoMutexAcquire am(shard.fMutex);
+    return shard.fCache->newCachedData(bytes);
+}
+
+namespace {
+struct StatsSum {
+    SkTDArray<const void*>             fNamespaces;
+    SkTDArray<SkResourceCache::Stats>  fStats;
+
+    static void Add(const void* nameSpace, const SkResourceCache::Stats& stats, void* ctx) {
+        StatsSum* sum = (StatsSum*)ctx;
+        int index = sum->fNamespaces.find(nameSpace);
+        if (index < 0) {
+            index = sum->fNamespaces.count();
+            *sum->fNamespaces.append() = nameSpace;
+            sk_bzero(sum->fStats.append(), sizeof(SkResourceCache::Stats));
+        }
+        SkResourceCache::Stats& total = sum->fStats[index];
+        total.fHits      += stats.fHits;
+        total.fMisses    += stats.fMisses;
+        total.fRejected  += stats.fRejected;
+        total.fCount     += stats.fCount;
+        total.fBytesUsed += stats.fBytesUsed;
+    }
+};
+
+void dump_stats(const void* nameSpace, const SkResourceCache::Stats& stats, void*) {
+    SkDebugf("    namespace %p: hits=%lld misses=%lld rejected=%lld count=%d bytes=%zu\n",
+             nameSpace, (long long)stats.fHits, (long long)stats.fMisses,
+             (long long)stats.fRejected, stats.fCount, stats.fBytesUsed);
+}
+}  // namespace
+
+void SkResourceCache::VisitStats(StatsVisitor visitor, void* context) {
+    SkResourceCacheShards& shards = get_shards();
+    StatsSum sum;
+    for (int i = 0; i < kShardCount; i++) {
+        SkAutoMutexAcquire am(shards[i].fMutex);
+        shards[i].fCache->visitStats(StatsSum::Add, &sum);
+    }
+    for (int i = 0; i < sum.fNamespaces.count(); i++) {
+        visitor(sum.fNamespaces[i], sum.fStats[i], context);
+    }
 }
 
 void SkResourceCache::Dump() {
-    SkAutoMutexAcquire am(gMutex);
-    get_cache()->dump();
+    SkResourceCacheShards& shards = get_shards();
+    SkDebugf("SkResourceCache: %d shards, count=%d bytes=%zu %s\n", kShardCount,
+             shards.count(), shards.bytesUsed(), GetDiscardableFactory() ? "discardable" : "malloc");
+    VisitStats(dump_stats, NULL);
 }
 
 size_t SkResourceCache::SetSingleAllocationByteLimit(size_t size) {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->setSingleAllocationByteLimit(size);
+    SkResourceCacheShards& shards = get_shards();
+    size_t prevLimit = 0;
+    for (int i = 0; i < kShardCount; i++) {
+        SkAutoMutexAcquire am(shards[i].fMutex);
+        prevLimit = shards[i].fCache->setSingleAllocationByteLimit(size);
+    }
+    return prevLimit;
 }
 
 size_t SkResourceCache::GetSingleAllocationByteLimit() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->getSingleAllocationByteLimit();
+    SkResourceCacheShards::Shard& shard = first_shard();
+    SkAutoMutexAcquire am(shard.fMutex);
+    return shard.fCache->getSingleAllocationByteLimit();
 }
 
 size_t SkResourceCache::GetEffectiveSingleAllocationByteLimit() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->getEffectiveSingleAllocationByteLimit();
+    SkResourceCacheShards::Shard& shard = first_shard();
+    SkAutoMutexAcquire am(shard.fMutex);
+    return shard.fCache->getEffectiveSingleAllocationByteLimit();
 }
 
 void SkResourceCache::PurgeAll() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->purgeAll();
+    SkResourceCacheShards& shards = get_shards();
+    for (int i = 0; i < kShardCount; i++) {
+        SkAutoMutexAcquire am(shards[i].fMutex);
+        shards[i].fCache->purgeAll();
+    }
+}
+
+bool SkResourceCache::SetUseAdmissionPolicy(bool use) {
+    SkResourceCacheShards& shards = get_shards();
+    bool prev = false;
+    for (int i = 0; i < kShardCount; i++) {
+        SkAutoMutexAcquire am(shards[i].fMutex);
+        prev = shards[i].fCache->setUseAdmissionPolicy(use);
+    }
+    return prev;
 }
 
 bool SkResourceCache::Find(const Key& key, FindVisitor visitor, void* context) {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->find(key, visitor, context);
+    SkResourceCacheShards& shards = get_shards();
+    SkResourceCacheShards::Shard& shard = shards[shards.indexFor(key)];
+    SkAutoMutexAcquire am(shard.fMutex);
+    return shard.fCache->find(key, visitor, context);
 }
 
 void SkResourceCache::Add(Rec* rec) {
-    SkAutoMutexAcquire am(gMutex);
-    get_cache()->add(rec);
+    SkResourceCacheShards& shards = get_shards();
+    const int index = shards.indexFor(rec->getKey());
+    bool overBudget;
+    {
+        SkAutoMutexAcquire am(shards[index].fMutex);
+        shards[index].fCache->add(rec);
+        overBudget = shards[index].fCache->overBudget();
+    }
+    if (overBudget) {
+        shards.purgeAsNeeded(index);
+    }
 }
 
 void SkResourceCache::PostPurgeSharedID(uint64_t sharedID) {
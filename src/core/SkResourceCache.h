@@ -15,6 +15,7 @@
 class SkCachedData;
 class SkDiscardableMemory;
 class SkMipMap;
+class SkResourceCacheShards;
 
 /**
  *  Cache object for bitmaps (with possible scale in X Y as part of the key).
@@ -25,6 +26,9 @@ class SkMipMap;
  *
  *  As a convenience, a global instance is also defined, which can be safely
  *  access across threads via the static methods (e.g. FindAndLock, etc.).
+ *  It is split into shards by key hash, each behind its own mutex, so threads
+ *  looking up different keys rarely wait on each other; the shards share one
+ *  budget.
  */
 class SkResourceCache {
 public:
@@ -116,6 +120,19 @@ public:
      */
     typedef SkDiscardableMemory* (*DiscardableFactory)(size_t bytes);
 
+    /**
+     *  Counts kept for each Key namespace, since the cache was created.
+     */
+    struct Stats {
+        int64_t fHits;      // find() calls whose visitor accepted a Rec
+        int64_t fMisses;    // find() calls that found nothing, or a stale Rec
+        int64_t fRejected;  // Recs the admission policy kept out of the cache
+        int     fCount;     // Recs currently in the cache
+        size_t  fBytesUsed; // bytes those Recs use
+    };
+
+    typedef void (*StatsVisitor)(const void* nameSpace, const Stats&, void* context);
+
     /*
      *  The following static methods are thread-safe wrappers around a global
      *  instance of this cache.
@@ -143,6 +160,14 @@ public:
 
     static void PurgeAll();
 
+    static bool SetUseAdmissionPolicy(bool);
+
+    /**
+     *  Calls the visitor once for each namespace the global cache has seen, with its Stats
+     *  summed over all the shards.
+     */
+    static void VisitStats(StatsVisitor, void* context);
+
     /**
      *  Returns the DiscardableFactory used by the global cache, or NULL.
      */
@@ -222,6 +247,16 @@ public:
         this->purgeAsNeeded(true);
     }
 
+    /**
+     *  When enabled, a Rec that would push the cache over its budget is only added if its Key
+     *  has been looked up more often lately than that of the least recently used Rec, which
+     *  would be purged to make room for it (TinyLFU). This keeps one-off entries from flushing
+     *  out ones in steady use. Off by default. Returns the previous setting.
+     */
+    bool setUseAdmissionPolicy(bool);
+
+    void visitStats(StatsVisitor, void* context) const;
+
     DiscardableFactory discardableFactory() const { return fDiscardableFactory; }
     SkBitmap::Allocator* allocator() const { return fAllocator; };
 
@@ -250,8 +285,24 @@ private:
 
     SkMessageBus<PurgeSharedIDMessage>::Inbox fPurgeSharedIDInbox;
 
+    class FrequencySketch;
+    FrequencySketch* fSketch;   // NULL unless the admission policy is in use
+
+    struct NamespaceStats {
+        const void* fNamespace;
+        Stats       fStats;
+    };
+    SkTDArray<NamespaceStats> fStats;
+
+    // Non-NULL if this is a shard of the global cache, with the budget shared among them.
+    SkResourceCacheShards* fShards;
+    friend class SkResourceCacheShards;
+
     void checkMessages();
-    void purgeAsNeeded(bool forcePurge = false);
+    bool overBudget(size_t extraBytes = 0, int extraCount = 0) const;
+    // Purges from the tail while over budget, stopping early if only minBytes are left.
+    void purgeAsNeeded(bool forcePurge = false, size_t minBytes = 0);
+    Stats* statsFor(const void* nameSpace);
 
     // linklist management
     void moveToHead(Rec*);
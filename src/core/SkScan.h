@@ -24,6 +24,14 @@ typedef SkIRect SkXRect;
 
 class SkScan {
 public:
+    /** Options for how path fills are scan converted, chosen by the canvas (see SkDraw). */
+    enum PathFlags {
+        /** Compute each pixel's exact coverage for anti-aliased fills, instead of supersampling.
+            Inverse fills are still supersampled.
+        */
+        kAnalyticAA_PathFlag     = 1 << 0,
+    };
+
     static void FillPath(const SkPath&, const SkIRect&, SkBlitter*);
 
     ///////////////////////////////////////////////////////////////////////////
@@ -34,8 +42,15 @@ public:
     static void FillRect(const SkRect&, const SkRasterClip&, SkBlitter*);
     static void AntiFillRect(const SkRect&, const SkRasterClip&, SkBlitter*);
     static void AntiFillXRect(const SkXRect&, const SkRasterClip&, SkBlitter*);
-    static void FillPath(const SkPath&, const SkRasterClip&, SkBlitter*);
-    static void AntiFillPath(const SkPath&, const SkRasterClip&, SkBlitter*);
+    /** If edgeClip is not null, the path's edges are built against it rather than clip, which
+        must lie inside it, so the path covers exactly the pixels it would if drawn with
+        edgeClip, where the two overlap. Tiles of a larger draw pass that draw's clip (see
+        SkCanvasPriv::SetTileBounds), so that they agree along their seams.
+    */
+    static void FillPath(const SkPath&, const SkRasterClip&, SkBlitter*,
+                         const SkRasterClip* edgeClip = NULL);
+    static void AntiFillPath(const SkPath&, const SkRasterClip&, SkBlitter*,
+                             uint32_t pathFlags = 0, const SkRasterClip* edgeClip = NULL);
     static void FrameRect(const SkRect&, const SkPoint& strokeSize,
                           const SkRasterClip&, SkBlitter*);
     static void AntiFrameRect(const SkRect&, const SkPoint& strokeSize,
@@ -59,9 +74,11 @@ private:
     static void FillRect(const SkRect&, const SkRegion* clip, SkBlitter*);
     static void AntiFillRect(const SkRect&, const SkRegion* clip, SkBlitter*);
     static void AntiFillXRect(const SkXRect&, const SkRegion*, SkBlitter*);
-    static void FillPath(const SkPath&, const SkRegion& clip, SkBlitter*);
+    static void FillPath(const SkPath&, const SkRegion& clip, SkBlitter*,
+                         const SkRegion* edgeClip = NULL);
     static void AntiFillPath(const SkPath&, const SkRegion& clip, SkBlitter*,
-                             bool forceRLE = false);
+                             bool forceRLE = false, uint32_t pathFlags = 0,
+                             const SkRegion* edgeClip = NULL);
     static void FillTriangle(const SkPoint pts[], const SkRegion*, SkBlitter*);
 
     static void AntiFrameRect(const SkRect&, const SkPoint& strokeSize,
@@ -29,10 +29,22 @@ private:
 };
 
 // clipRect == null means path is entirely inside the clip
-void sk_fill_path(const SkPath& path, const SkIRect* clipRect,
+// edgeClipRect is the clip the edges are built against: clipRect itself, or the rect
+// sk_edge_clip_rect() gives for the larger clip passed to SkScan as edgeClip.
+void sk_fill_path(const SkPath& path, const SkIRect* clipRect, const SkIRect* edgeClipRect,
                   SkBlitter* blitter, int start_y, int stop_y, int shiftEdgesUp,
                   const SkRegion& clipRgn);
 
+// The clipRect SkScanClipper would give for clip, i.e. null if it contains ir.
+static inline const SkIRect* sk_edge_clip_rect(const SkRegion& clip, const SkIRect& ir) {
+    const SkIRect& bounds = clip.getBounds();
+    return clip.isRect() && bounds.contains(ir) ? NULL : &bounds;
+}
+
+// Fills path with analytic (exact area) coverage, clipped to bounds, which must be no wider than
+// 32767. Inverse fill types are not supported.
+void sk_fill_path_analytic(const SkPath& path, const SkIRect& bounds, SkBlitter* blitter);
+
 // blit the rects above and below avoid, clipped to clip
 void sk_blit_above(SkBlitter*, const SkIRect& avoid, const SkRegion& clip);
 void sk_blit_below(SkBlitter*, const SkIRect& avoid, const SkRegion& clip);
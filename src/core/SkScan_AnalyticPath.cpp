@@ -0,0 +1,429 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBlitter.h"
+#include "SkGeometry.h"
+#include "SkPath.h"
+#include "SkScanPriv.h"
+#include "SkTDArray.h"
+#include "SkTSort.h"
+#include "SkTemplates.h"
+
+/*
+ *  Analytic coverage anti-aliasing.
+ *
+ *  Rather than supersampling, we compute how much of each pixel's area the path covers.  Curves
+ *  are flattened into lines, then every line deposits its signed contribution to the area of
+ *  each pixel it crosses into an accumulation buffer.  A running sum along each row then gives
+ *  the (signed, winding-weighted) area covered in each pixel.  This is exact for any polygon
+ *  whose edges don't cross inside the same pixel; where they do (e.g. overlapping contours) the
+ *  winding-to-coverage mapping is a close approximation.
+ *
+ *  The accumulation buffer only holds a band of rows at a time, so memory use is bounded no
+ *  matter how big the path is.
+ */
+
+// How far (in pixels) flattened curves may stray from the true curve.
+static const SkScalar kCurveTolerance = SK_Scalar1 / 16;
+static const int kMaxCurveLines = 1 << 10;
+
+// Upper bound on the floats in our accumulation buffer; sets how many rows we do at once.
+static const int kMaxAreaFloats = 1 << 14;
+
+namespace {
+
+struct Line {
+    SkPoint fTop, fBottom;  // fTop.fY < fBottom.fY
+    float   fWinding;       // +1 if the original line went down, -1 if up.
+};
+
+static bool line_top_lt(const Line& a, const Line& b) {
+    return a.fTop.fY < b.fTop.fY;
+}
+
+// Turns a path into Lines relative to the top-left of bounds, clipped horizontally to bounds.
+// SkEdgeBuilder isn't used: its edges are snapped to (super)sample rows and stepped in SkFixed,
+// and its curve edges are stepped forward a row at a time, while exact area needs each line's
+// float endpoints within the pixel.
+class LineBuilder : SkNoncopyable {
+public:
+    LineBuilder(const SkIRect& bounds)
+        : fLeft(SkIntToScalar(bounds.fLeft))
+        , fTop(SkIntToScalar(bounds.fTop))
+        , fWidth(SkIntToScalar(bounds.width())) {}
+
+    void build(const SkPath& path) {
+        SkPath::Iter iter(path, true);
+        SkPoint pts[4];
+        SkPath::Verb verb;
+        while ((verb = iter.next(pts, false)) != SkPath::kDone_Verb) {
+            switch (verb) {
+                case SkPath::kLine_Verb:  this->addLine(pts[0], pts[1]); break;
+                case SkPath::kQuad_Verb:  this->addQuad(pts);            break;
+                case SkPath::kCubic_Verb: this->addCubic(pts);           break;
+                case SkPath::kConic_Verb: {
+                    SkAutoConicToQuads converter;
+                    const SkPoint* quads = converter.computeQuads(pts, iter.conicWeight(),
+                                                                  kCurveTolerance);
+                    for (int i = 0; i < converter.countQuads(); i++) {
+                        this->addQuad(quads + 2*i);
+                    }
+                } break;
+                default:
+                    break;
+            }
+        }
+        if (fLines.count() > 1) {
+            SkTQSort(fLines.begin(), fLines.end() - 1, line_top_lt);
+        }
+    }
+
+    const SkTDArray<Line>& lines() const { return fLines; }
+
+private:
+    static int CountLines(SkScalar curvature, SkScalar scale) {
+        // A curve's distance from its chord shrinks with the square of the number of pieces.
+        const SkScalar n = SkScalarCeilToScalar(SkScalarSqrt(curvature * scale / kCurveTolerance));
+        return n < 1 ? 1 : n > kMaxCurveLines ? kMaxCurveLines : SkScalarFloorToInt(n);
+    }
+
+    void addQuad(const SkPoint pts[3]) {
+        const SkVector dd = pts[0] - pts[1] - pts[1] + pts[2];
+        const int n = CountLines(dd.length(), SK_Scalar1 / 4);
+        SkPoint prev = pts[0];
+        for (int i = 1; i < n; i++) {
+            const SkScalar t = SkIntToScalar(i) / n,
+                           s = SK_Scalar1 - t;
+            const SkPoint next = { s*s*pts[0].fX + 2*s*t*pts[1].fX + t*t*pts[2].fX,
+                                   s*s*pts[0].fY + 2*s*t*pts[1].fY + t*t*pts[2].fY };
+            this->addLine(prev, next);
+            prev = next;
+        }
+        this->addLine(prev, pts[2]);
+    }
+
+    void addCubic(const SkPoint pts[4]) {
+        const SkVector dd0 = pts[0] - pts[1] - pts[1] + pts[2],
+                       dd1 = pts[1] - pts[2] - pts[2] + pts[3];
+        const int n = CountLines(SkTMax(dd0.length(), dd1.length()), SkIntToScalar(3) / 4);
+        SkPoint prev = pts[0];
+        for (int i = 1; i < n; i++) {
+            const SkScalar t = SkIntToScalar(i) / n,
+                           s = SK_Scalar1 - t;
+            const SkScalar a = s*s*s, b = 3*s*s*t, c = 3*s*t*t, d = t*t*t;
+            const SkPoint next = { a*pts[0].fX + b*pts[1].fX + c*pts[2].fX + d*pts[3].fX,
+                                   a*pts[0].fY + b*pts[1].fY + c*pts[2].fY + d*pts[3].fY };
+            this->addLine(prev, next);
+            prev = next;
+        }
+        this->addLine(prev, pts[3]);
+    }
+
+    void addLine(SkPoint p0, SkPoint p1) {
+        p0.offset(-fLeft, -fTop);
+        p1.offset(-fLeft, -fTop);
+        if (p0.fY == p1.fY) {
+            return;  // Horizontal lines don't cover anything.
+        }
+
+        // Split at x == 0 and x == fWidth.  Anything left of 0 covers every pixel to its right,
+        // which is just what it would do if we moved it onto x == 0.  Anything right of fWidth
+        // covers nothing we draw, and moving it onto x == fWidth keeps it that way.
+        SkScalar splits[2];
+        int count = 0;
+        const SkScalar edges[] = { 0, fWidth };
+        for (int i = 0; i < 2; i++) {
+            const SkScalar e = edges[i];
+            if ((p0.fX < e && e < p1.fX) || (p1.fX < e && e < p0.fX)) {
+                splits[count++] = (e - p0.fX) / (p1.fX - p0.fX);
+            }
+        }
+        if (2 == count && splits[0] > splits[1]) {
+            SkTSwap(splits[0], splits[1]);
+        }
+
+        SkPoint prev = p0;
+        for (int i = 0; i <= count; i++) {
+            SkPoint next = p1;
+            if (i < count) {
+                next.set(p0.fX + (p1.fX - p0.fX) * splits[i],
+                         p0.fY + (p1.fY - p0.fY) * splits[i]);
+            }
+            this->addClippedLine(prev, next);
+            prev = next;
+        }
+    }
+
+    void addClippedLine(SkPoint p0, SkPoint p1) {
+        p0.fX = SkScalarPin(p0.fX, 0, fWidth);
+        p1.fX = SkScalarPin(p1.fX, 0, fWidth);
+        if (p0.fY == p1.fY) {
+            return;
+        }
+        Line* line = fLines.append();
+        if (p0.fY < p1.fY) {
+            line->fTop = p0; line->fBottom = p1; line->fWinding = +1;
+        } else {
+            line->fTop = p1; line->fBottom = p0; line->fWinding = -1;
+        }
+    }
+
+    const SkScalar  fLeft, fTop, fWidth;
+    SkTDArray<Line> fLines;
+};
+
+// Holds the area each Line contributes to each pixel in a band of rows.  Rows are split into
+// blocks of kBlockSize pixels, and we remember which blocks any line touched: coverage can only
+// change inside those, so the long spans inside and outside a path cost almost nothing to read.
+class AreaAccumulator : SkNoncopyable {
+public:
+    static const int kBlockShift = 5;
+    static const int kBlockSize  = 1 << kBlockShift;
+
+    AreaAccumulator(int width, int rows)
+        // Lines touch up to two floats past their rightmost x, which may be width.
+        : fStride(width + 2)
+        , fBlocks((fStride + kBlockSize - 1) >> kBlockShift)
+        , fArea(fStride * rows)
+        , fDirty(fBlocks * rows) {
+        sk_bzero(fArea.get(), fStride * rows * sizeof(float));
+        sk_bzero(fDirty.get(), fBlocks * rows * sizeof(bool));
+    }
+
+    // The caller must clear() each row of the previous band as it reads it.
+    void reset(int top, int rows) {
+        fBandTop = top;
+        fBandRows = rows;
+    }
+
+    int blocks() const { return fBlocks; }
+    float* row(int y) { return fArea.get() + (y - fBandTop) * fStride; }
+    bool* dirty(int y) { return fDirty.get() + (y - fBandTop) * fBlocks; }
+
+    void clear(int y, int block) {
+        const int x = block << kBlockShift;
+        sk_bzero(this->row(y) + x, SkTMin(kBlockSize, fStride - x) * sizeof(float));
+        this->dirty(y)[block] = false;
+    }
+
+    void accumulate(const Line& line) {
+        const float bandTop = (float)fBandTop,
+                    bandBot = (float)(fBandTop + fBandRows);
+        const float y0 = SkTMax(line.fTop.fY, bandTop),
+                    y1 = SkTMin(line.fBottom.fY, bandBot);
+        if (y0 >= y1) {
+            return;
+        }
+        const float dxdy = (line.fBottom.fX - line.fTop.fX) / (line.fBottom.fY - line.fTop.fY);
+        const float maxX = (float)(fStride - 2);
+
+        float x = line.fTop.fX + (y0 - line.fTop.fY) * dxdy;
+        const int stop = (int)ceilf(y1);
+        for (int y = (int)floorf(y0); y < stop; y++) {
+            const float dy = SkTMin((float)(y + 1), y1) - SkTMax((float)y, y0);
+            const float xnext = SkScalarPin(x + dxdy * dy, 0, maxX);
+            this->accumulateSpan(y, x, xnext, dy * line.fWinding);
+            x = xnext;
+        }
+    }
+
+private:
+    // Deposit the area to the right of the piece of a line crossing row y between xa and xb,
+    // with d the signed height of the piece.
+    void accumulateSpan(int y, float xa, float xb, float d) {
+        float* row = this->row(y);
+        const float x0 = SkTMin(xa, xb),
+                    x1 = SkTMax(xa, xb);
+        const float x0floor = floorf(x0),
+                    x1ceil  = ceilf(x1);
+        const int x0i = (int)x0floor,
+                  x1i = SkTMax((int)x1ceil, x0i + 1);
+
+        bool* dirty = this->dirty(y);
+        for (int b = x0i >> kBlockShift; b <= x1i >> kBlockShift; b++) {
+            dirty[b] = true;
+        }
+
+        if (x1i == x0i + 1) {
+            // The whole piece is within one pixel column: split d by the piece's mean x.
+            const float xmf = 0.5f * (xa + xb) - x0floor;
+            row[x0i    ] += d - d * xmf;
+            row[x0i + 1] += d * xmf;
+            return;
+        }
+
+        // The piece crosses several columns.  Its coverage ramps linearly from the first to the
+        // last, with triangular bits at each end.
+        const float s = 1.0f / (x1 - x0);
+        const float x0f = x0 - x0floor;
+        const float a0 = 0.5f * s * (1.0f - x0f) * (1.0f - x0f);
+        const float x1f = x1 - x1ceil + 1.0f;
+        const float am = 0.5f * s * x1f * x1f;
+
+        row[x0i] += d * a0;
+        if (x1i == x0i + 2) {
+            row[x0i + 1] += d * (1.0f - a0 - am);
+        } else {
+            const float a1 = s * (1.5f - x0f);
+            row[x0i + 1] += d * (a1 - a0);
+            for (int xi = x0i + 2; xi < x1i - 1; xi++) {
+                row[xi] += d * s;
+            }
+            const float a2 = a1 + (float)(x1i - x0i - 3) * s;
+            row[x1i - 1] += d * (1.0f - a2 - am);
+        }
+        row[x1i] += d * am;
+    }
+
+    const int              fStride, fBlocks;
+    SkAutoTMalloc<float>   fArea;
+    SkAutoTMalloc<bool>    fDirty;
+    int                    fBandTop, fBandRows;
+};
+
+// Builds the runs blitAntiH() wants from a row of alphas fed left to right, trimming zeros from
+// both ends.
+class RunBuilder : SkNoncopyable {
+public:
+    RunBuilder(int width) : fAlpha(width), fRuns(width + 1) {}
+
+    void reset() {
+        fCurrent  = 0;
+        fRunStart = 0;
+        fFirst    = -1;
+        fEnd      = 0;
+    }
+
+    // Coverage is alpha from x until the next call.
+    void set(int x, SkAlpha alpha) {
+        if (alpha != fCurrent) {
+            this->closeRun(x);
+            fCurrent  = alpha;
+            fRunStart = x;
+        }
+    }
+
+    // Returns false if the row is empty.  Otherwise fills *left with its first x.
+    bool finish(int width, int* left) {
+        this->closeRun(width);
+        if (fFirst < 0) {
+            return false;
+        }
+        fRuns[fEnd - fFirst] = 0;  // Drops any trailing run of zeros.
+        *left = fFirst;
+        return true;
+    }
+
+    const SkAlpha* alpha() const { return fAlpha.get(); }
+    const int16_t* runs()  const { return fRuns.get(); }
+
+private:
+    void closeRun(int x) {
+        if (fFirst < 0) {
+            if (0 == fCurrent) {
+                return;
+            }
+            fFirst = fRunStart;
+        }
+        fAlpha[fRunStart - fFirst] = fCurrent;
+        fRuns [fRunStart - fFirst] = SkToS16(x - fRunStart);
+        if (fCurrent) {
+            fEnd = x;
+        }
+    }
+
+    SkAutoSTMalloc<256, SkAlpha> fAlpha;
+    SkAutoSTMalloc<257, int16_t> fRuns;
+    SkAlpha                      fCurrent;
+    int                          fRunStart, fFirst, fEnd;
+};
+
+// Map accumulated winding to coverage, for nonzero and even-odd fills.
+static float nonzero_coverage(float winding) {
+    return SkTMin(fabsf(winding), 1.0f);
+}
+
+static float evenodd_coverage(float winding) {
+    float w = fabsf(winding);
+    w -= 2.0f * floorf(0.5f * w);  // Now in [0,2).
+    return w > 1.0f ? 2.0f - w : w;
+}
+
+}  // namespace
+
+void sk_fill_path_analytic(const SkPath& path, const SkIRect& bounds, SkBlitter* blitter) {
+    SkASSERT(!path.isInverseFillType());
+    SkASSERT(!bounds.isEmpty());
+    SkASSERT(bounds.width() <= SK_MaxS16);
+
+    LineBuilder builder(bounds);
+    builder.build(path);
+    const SkTDArray<Line>& lines = builder.lines();
+    if (lines.isEmpty()) {
+        return;
+    }
+
+    float (*coverage)(float) = SkPath::kEvenOdd_FillType == path.getFillType() ? evenodd_coverage
+                                                                              : nonzero_coverage;
+
+    const int width  = bounds.width(),
+              height = bounds.height(),
+              rows   = SkPin32(kMaxAreaFloats / (width + 2), 1, height);
+
+    AreaAccumulator area(width, rows);
+    RunBuilder runs(width);
+
+    // Lines are sorted by their tops, so each band picks up new lines in order, and drops lines
+    // once they end above it.
+    SkTDArray<const Line*> active;
+    int nextLine = 0;
+    for (int top = 0; top < height; top += rows) {
+        const int bandRows = SkTMin(rows, height - top),
+                  bandBot  = top + bandRows;
+        area.reset(top, bandRows);
+
+        for (; nextLine < lines.count() && lines[nextLine].fTop.fY < bandBot; nextLine++) {
+            *active.append() = &lines[nextLine];
+        }
+        for (int i = 0; i < active.count(); ) {
+            if (active[i]->fBottom.fY <= top) {
+                active.removeShuffle(i);
+                continue;
+            }
+            area.accumulate(*active[i]);
+            i++;
+        }
+
+        for (int y = top; y < bandBot; y++) {
+            const float* row = area.row(y);
+            const bool* dirty = area.dirty(y);
+
+            float winding = 0;
+            runs.reset();
+            for (int b = 0; b < area.blocks(); b++) {
+                if (!dirty[b]) {
+                    continue;  // Winding and so coverage are unchanged across this block.
+                }
+                const int x0 = b << AreaAccumulator::kBlockShift,
+                          x1 = SkTMin(x0 + AreaAccumulator::kBlockSize, width);
+                for (int x = x0; x < x1; x++) {
+                    if (row[x] != 0) {
+                        winding += row[x];
+                        runs.set(x, SkToU8((int)(coverage(winding) * 255 + 0.5f)));
+                    }
+                }
+                area.clear(y, b);
+            }
+
+            int left;
+            if (runs.finish(width, &left)) {
+                blitter->blitAntiH(bounds.fLeft + left, bounds.fTop + y,
+                                   runs.alpha(), runs.runs());
+            }
+        }
+    }
+}
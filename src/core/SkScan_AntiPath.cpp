@@ -204,11 +204,18 @@ void SuperBlitter::blitH(int x, int y, int width) {
     SkASSERT(iy >= fCurrIY);
 
     x -= fSuperLeft;
-    // hack, until I figure out why my cubics (I think) go beyond the bounds
+    // Edges may be built against a larger clip than ours (see sk_fill_path), so trim to our
+    // bounds.
     if (x < 0) {
         width += x;
         x = 0;
     }
+    if (x + width > (fWidth << SHIFT)) {
+        width = (fWidth << SHIFT) - x;
+    }
+    if (width <= 0) {
+        return;
+    }
 
 #ifdef SK_DEBUG
     SkASSERT(y != fCurrY || x >= fCurrX);
@@ -298,6 +305,18 @@ void SuperBlitter::blitRect(int x, int y, int width, int height) {
     SkASSERT(width > 0);
     SkASSERT(height > 0);
 
+    // As in blitH(), trim to our bounds.
+    if (x < fSuperLeft) {
+        width -= fSuperLeft - x;
+        x = fSuperLeft;
+    }
+    if (x + width > fSuperLeft + (fWidth << SHIFT)) {
+        width = fSuperLeft + (fWidth << SHIFT) - x;
+    }
+    if (width <= 0) {
+        return;
+    }
+
     // blit leading rows
     while ((y & MASK)) {
         this->blitH(x, y++, width);
@@ -623,8 +642,26 @@ static bool safeRoundOut(const SkRect& src, SkIRect* dst, int32_t maxInt) {
     return false;
 }
 
+// Our antialiasing can't handle a clip larger than 32767, so we restrict
+// the clip to that limit here. (the runs[] uses int16_t for its index).
+//
+// A more general solution (one that could also eliminate the need to
+// disable aa based on ir bounds (see overflows_short_shift) would be
+// to tile the clip/target...
+static const SkRegion* limit_clip(const SkRegion& clip, SkRegion* storage) {
+    static const int32_t kMaxClipCoord = 32767;
+    const SkIRect& bounds = clip.getBounds();
+    if (bounds.fRight > kMaxClipCoord || bounds.fBottom > kMaxClipCoord) {
+        SkIRect limit = { 0, 0, kMaxClipCoord, kMaxClipCoord };
+        storage->op(clip, limit, SkRegion::kIntersect_Op);
+        return storage;
+    }
+    return &clip;
+}
+
 void SkScan::AntiFillPath(const SkPath& path, const SkRegion& origClip,
-                          SkBlitter* blitter, bool forceRLE) {
+                          SkBlitter* blitter, bool forceRLE, uint32_t pathFlags,
+                          const SkRegion* edgeClip) {
     if (origClip.isEmpty()) {
         return;
     }
@@ -648,39 +685,27 @@ void SkScan::AntiFillPath(const SkPath& path, const SkRegion& origClip,
 
     // If the intersection of the path bounds and the clip bounds
     // will overflow 32767 when << by SHIFT, we can't supersample,
-    // so draw without antialiasing.
+    // so draw without antialiasing. We decide by the edge clip, if any, so that
+    // we decide the same as a draw under it would.
+    const SkRegion& decideClip = edgeClip ? *edgeClip : origClip;
     SkIRect clippedIR;
     if (isInverse) {
        // If the path is an inverse fill, it's going to fill the entire
        // clip, and we care whether the entire clip exceeds our limits.
-       clippedIR = origClip.getBounds();
+       clippedIR = decideClip.getBounds();
     } else {
-       if (!clippedIR.intersect(ir, origClip.getBounds())) {
+       if (!clippedIR.intersect(ir, decideClip.getBounds())) {
            return;
        }
     }
     if (rect_overflows_short_shift(clippedIR, SHIFT)) {
-        SkScan::FillPath(path, origClip, blitter);
+        SkScan::FillPath(path, origClip, blitter, edgeClip);
         return;
     }
 
-    // Our antialiasing can't handle a clip larger than 32767, so we restrict
-    // the clip to that limit here. (the runs[] uses int16_t for its index).
-    //
-    // A more general solution (one that could also eliminate the need to
-    // disable aa based on ir bounds (see overflows_short_shift) would be
-    // to tile the clip/target...
-    SkRegion tmpClipStorage;
-    const SkRegion* clipRgn = &origClip;
-    {
-        static const int32_t kMaxClipCoord = 32767;
-        const SkIRect& bounds = origClip.getBounds();
-        if (bounds.fRight > kMaxClipCoord || bounds.fBottom > kMaxClipCoord) {
-            SkIRect limit = { 0, 0, kMaxClipCoord, kMaxClipCoord };
-            tmpClipStorage.op(origClip, limit, SkRegion::kIntersect_Op);
-            clipRgn = &tmpClipStorage;
-        }
-    }
+    SkRegion tmpClipStorage, tmpEdgeClipStorage;
+    const SkRegion* clipRgn = limit_clip(origClip, &tmpClipStorage);
+    const SkRegion* edgeClipRgn = edgeClip ? limit_clip(*edgeClip, &tmpEdgeClipStorage) : NULL;
     // for here down, use clipRgn, not origClip
 
     SkScanClipper   clipper(blitter, clipRgn, ir);
@@ -696,6 +721,15 @@ void SkScan::AntiFillPath(const SkPath& path, const SkRegion& origClip,
     // now use the (possibly wrapped) blitter
     blitter = clipper.getBlitter();
 
+    if ((pathFlags & kAnalyticAA_PathFlag) && !isInverse) {
+        SkIRect bounds = ir;
+        if (clipRect && !bounds.intersect(*clipRect)) {
+            return;
+        }
+        sk_fill_path_analytic(path, bounds, blitter);
+        return;
+    }
+
     if (isInverse) {
         sk_blit_above(blitter, ir, *clipRgn);
     }
@@ -708,6 +742,16 @@ void SkScan::AntiFillPath(const SkPath& path, const SkRegion& origClip,
         superClipRect = &superRect;
     }
 
+    SkIRect superEdgeRect, *superEdgeClipRect = superClipRect;
+    if (edgeClipRgn) {
+        superEdgeClipRect = NULL;
+        if (const SkIRect* edgeClipRect = sk_edge_clip_rect(*edgeClipRgn, ir)) {
+            superEdgeRect.set(edgeClipRect->fLeft << SHIFT, edgeClipRect->fTop << SHIFT,
+                              edgeClipRect->fRight << SHIFT, edgeClipRect->fBottom << SHIFT);
+            superEdgeClipRect = &superEdgeRect;
+        }
+    }
+
     SkASSERT(SkIntToScalar(ir.fTop) <= path.getBounds().fTop);
 
     // MaskSuperBlitter can't handle drawing outside of ir, so we can't use it
@@ -715,10 +759,12 @@ void SkScan::AntiFillPath(const SkPath& path, const SkRegion& origClip,
     if (!isInverse && MaskSuperBlitter::CanHandleRect(ir) && !forceRLE) {
         MaskSuperBlitter    superBlit(blitter, ir, *clipRgn, isInverse);
         SkASSERT(SkIntToScalar(ir.fTop) <= path.getBounds().fTop);
-        sk_fill_path(path, superClipRect, &superBlit, ir.fTop, ir.fBottom, SHIFT, *clipRgn);
+        sk_fill_path(path, superClipRect, superEdgeClipRect, &superBlit, ir.fTop, ir.fBottom,
+                     SHIFT, *clipRgn);
     } else {
         SuperBlitter    superBlit(blitter, ir, *clipRgn, isInverse);
-        sk_fill_path(path, superClipRect, &superBlit, ir.fTop, ir.fBottom, SHIFT, *clipRgn);
+        sk_fill_path(path, superClipRect, superEdgeClipRect, &superBlit, ir.fTop, ir.fBottom,
+                     SHIFT, *clipRgn);
     }
 
     if (isInverse) {
@@ -730,38 +776,56 @@ void SkScan::AntiFillPath(const SkPath& path, const SkRegion& origClip,
 
 #include "SkRasterClip.h"
 
+// The region SkScan fills paths under for edgeClip: an anti-aliased clip is handled as its bounds,
+// with its coverage applied by the blitter.
+static const SkRegion* edge_clip_rgn(const SkRasterClip* edgeClip, SkRegion* storage) {
+    if (NULL == edgeClip) {
+        return NULL;
+    }
+    if (edgeClip->isBW()) {
+        return &edgeClip->bwRgn();
+    }
+    storage->setRect(edgeClip->getBounds());
+    return storage;
+}
+
 void SkScan::FillPath(const SkPath& path, const SkRasterClip& clip,
-                          SkBlitter* blitter) {
+                          SkBlitter* blitter, const SkRasterClip* edgeClip) {
     if (clip.isEmpty()) {
         return;
     }
 
+    SkRegion edgeStorage;
+    const SkRegion* edgeRgn = edge_clip_rgn(edgeClip, &edgeStorage);
     if (clip.isBW()) {
-        FillPath(path, clip.bwRgn(), blitter);
+        FillPath(path, clip.bwRgn(), blitter, edgeRgn);
     } else {
         SkRegion        tmp;
         SkAAClipBlitter aaBlitter;
 
         tmp.setRect(clip.getBounds());
         aaBlitter.init(blitter, &clip.aaRgn());
-        SkScan::FillPath(path, tmp, &aaBlitter);
+        SkScan::FillPath(path, tmp, &aaBlitter, edgeRgn);
     }
 }
 
 void SkScan::AntiFillPath(const SkPath& path, const SkRasterClip& clip,
-                          SkBlitter* blitter) {
+                          SkBlitter* blitter, uint32_t pathFlags,
+                          const SkRasterClip* edgeClip) {
     if (clip.isEmpty()) {
         return;
     }
 
+    SkRegion edgeStorage;
+    const SkRegion* edgeRgn = edge_clip_rgn(edgeClip, &edgeStorage);
     if (clip.isBW()) {
-        AntiFillPath(path, clip.bwRgn(), blitter);
+        AntiFillPath(path, clip.bwRgn(), blitter, false, pathFlags, edgeRgn);
     } else {
         SkRegion        tmp;
         SkAAClipBlitter aaBlitter;
 
         tmp.setRect(clip.getBounds());
         aaBlitter.init(blitter, &clip.aaRgn());
-        SkScan::AntiFillPath(path, tmp, &aaBlitter, true);
+        SkScan::AntiFillPath(path, tmp, &aaBlitter, true, pathFlags, edgeRgn);
     }
 }
@@ -389,13 +389,39 @@ static SkEdge* sort_edges(SkEdge* list[], int count, SkEdge** last) {
     return list[0];
 }
 
+// Steps edge down to row y, leaving it just as walking it row by row from its top would have.
+// Returns false if the edge ends above y.
+static bool advance_edge(SkEdge* edge, int y) {
+    while (edge->fLastY < y) {
+        if (edge->fCurveCount < 0) {
+            if (!((SkCubicEdge*)edge)->updateCubic()) {
+                return false;
+            }
+        } else if (edge->fCurveCount > 0) {
+            if (!((SkQuadraticEdge*)edge)->updateQuadratic()) {
+                return false;
+            }
+        } else {
+            return false;
+        }
+    }
+    if (edge->fFirstY < y) {
+        // Walking adds fDX once a row; unsigned math wraps around the same way if that overflows.
+        edge->fX = (SkFixed)((uint32_t)edge->fX +
+                             (uint32_t)edge->fDX * (uint32_t)(y - edge->fFirstY));
+        edge->fFirstY = y;
+    }
+    return true;
+}
+
 // clipRect may be null, even though we always have a clip. This indicates that
 // the path is contained in the clip, and so we can ignore it during the blit
 //
 // clipRect (if no null) has already been shifted up
 //
-void sk_fill_path(const SkPath& path, const SkIRect* clipRect, SkBlitter* blitter,
-                  int start_y, int stop_y, int shiftEdgesUp, const SkRegion& clipRgn) {
+void sk_fill_path(const SkPath& path, const SkIRect* clipRect, const SkIRect* edgeClipRect,
+                  SkBlitter* blitter, int start_y, int stop_y, int shiftEdgesUp,
+                  const SkRegion& clipRgn) {
     SkASSERT(blitter);
 
     SkEdgeBuilder   builder;
@@ -403,11 +429,28 @@ void sk_fill_path(const SkPath& path, const SkIRect* clipRect, SkBlitter* blitte
     // If we're convex, then we need both edges, even the right edge is past the clip
     const bool canCullToTheRight = !path.isConvex();
 
-    int count = builder.build(path, clipRect, shiftEdgesUp, canCullToTheRight);
+    int count = builder.build(path, edgeClipRect, shiftEdgesUp, canCullToTheRight);
     SkASSERT(count >= 0);
 
     SkEdge**    list = builder.edgeList();
 
+    // Chopping edges at the clip changes how they approximate the path, so edges built against
+    // a larger clip than ours are stepped down to our top instead, just as walking them from
+    // the larger clip's top would have left them.
+    if (clipRect && edgeClipRect != clipRect) {
+        const int top = SkTMax(start_y << shiftEdgesUp, clipRect->fTop);
+        int kept = 0;
+        for (int i = 0; i < count; i++) {
+            if (list[i]->fFirstY < clipRect->fBottom && advance_edge(list[i], top)) {
+                list[kept++] = list[i];
+            }
+        }
+        count = kept;
+        if (path.isConvex() && !path.isInverseFillType() && count < 2) {
+            return;
+        }
+    }
+
     if (0 == count) {
         if (path.isInverseFillType()) {
             /*
@@ -473,8 +516,8 @@ void sk_fill_path(const SkPath& path, const SkIRect* clipRect, SkBlitter* blitte
         walk_convex_edges(&headEdge, path.getFillType(), blitter, start_y, stop_y, NULL);
     } else {
         int rightEdge;
-        if (clipRect) {
-            rightEdge = clipRect->right();
+        if (edgeClipRect) {
+            rightEdge = edgeClipRect->right();
         } else {
             rightEdge = SkScalarRoundToInt(path.getBounds().right()) << shiftEdgesUp;
         }
@@ -560,7 +603,7 @@ static bool clip_to_limit(const SkRegion& orig, SkRegion* reduced) {
 }
 
 void SkScan::FillPath(const SkPath& path, const SkRegion& origClip,
-                      SkBlitter* blitter) {
+                      SkBlitter* blitter, const SkRegion* edgeClip) {
     if (origClip.isEmpty()) {
         return;
     }
@@ -577,6 +620,12 @@ void SkScan::FillPath(const SkPath& path, const SkRegion& origClip,
     }
         // don't reference "origClip" any more, just use clipPtr
 
+    const SkRegion* edgeClipPtr = edgeClip;
+    SkRegion finiteEdgeClip;
+    if (edgeClip && clip_to_limit(*edgeClip, &finiteEdgeClip)) {
+        edgeClipPtr = &finiteEdgeClip;
+    }
+
     SkIRect ir;
     // We deliberately call dround() instead of round(), since we can't afford to generate a
     // bounds that is tighter than the corresponding SkEdges. The edge code basically converts
@@ -599,7 +648,9 @@ void SkScan::FillPath(const SkPath& path, const SkRegion& origClip,
         if (path.isInverseFillType()) {
             sk_blit_above(blitter, ir, *clipPtr);
         }
-        sk_fill_path(path, clipper.getClipRect(), blitter, ir.fTop, ir.fBottom,
+        const SkIRect* edgeClipRect = edgeClipPtr ? sk_edge_clip_rect(*edgeClipPtr, ir)
+                                                  : clipper.getClipRect();
+        sk_fill_path(path, clipper.getClipRect(), edgeClipRect, blitter, ir.fTop, ir.fBottom,
                      0, *clipPtr);
         if (path.isInverseFillType()) {
             sk_blit_below(blitter, ir, *clipPtr);
@@ -3,6 +3,7 @@
 #include "SkCondVar.h"
 #include "SkRunnable.h"
 #include "SkTDArray.h"
+#include "SkTLS.h"
 #include "SkThread.h"
 #include "SkThreadUtils.h"
 
@@ -45,27 +46,30 @@ public:
         gGlobal->batch(fn, args, N, stride, pending);
     }
 
+    static int ThreadCount() {
+        return gGlobal ? gGlobal->fWorkers.count() : 0;
+    }
+
     static void Wait(int32_t* pending) {
         if (!gGlobal) {  // If we have no threads, the work must already be done.
             SkASSERT(*pending == 0);
             return;
         }
+        // If we're one of the pool's threads (i.e. wait() was called from inside a task), we look
+        // at our own deque first.  That's where any work our task added went, and it's what makes
+        // nested SkTaskGroups safe: we run queued work rather than block a thread.
+        const int me = CurrentThreadIndex();
         while (sk_acquire_load(pending) > 0) {  // Pairs with sk_atomic_dec here or in Loop.
             // Lend a hand until our SkTaskGroup of interest is done.
             Work work;
-            {
-                AutoLock lock(&gGlobal->fReady);
-                if (gGlobal->fWork.isEmpty()) {
-                    // Someone has picked up all the work (including ours).  How nice of them!
-                    // (They may still be working on it, so we can't assert *pending == 0 here.)
-                    continue;
-                }
-                gGlobal->fWork.pop(&work);
+            if (!gGlobal->take(me, &work)) {
+                // Someone has picked up all the work (including ours).  How nice of them!
+                // (They may still be working on it, so we can't assert *pending == 0 here.)
+                continue;
             }
             // This Work isn't necessarily part of our SkTaskGroup of interest, but that's fine.
             // We threads gotta stick together.  We're always making forward progress.
-            work.fn(work.arg);
-            sk_atomic_dec(work.pending);  // Release pairs with the sk_acquire_load() just above.
+            Run(work);
         }
     }
 
@@ -85,76 +89,225 @@ private:
         int32_t* pending;   // then sk_atomic_dec(pending) afterwards.
     };
 
-    explicit ThreadPool(int threads) : fDraining(false) {
+    static void Run(const Work& work) {
+        work.fn(work.arg);
+        sk_atomic_dec(work.pending);  // Release pairs with sk_acquire_load() in Wait().
+    }
+
+    // Each of our threads owns a Deque.  The owner adds and takes Work at the back, so it runs
+    // what it queued most recently next, while that's still warm in cache.  Other threads steal
+    // from the front, taking the oldest (and for divide-and-conquer work, biggest) Work.
+    class Deque : SkNoncopyable {
+    public:
+        Deque() : fFront(0), fCount(0) {}
+        ~Deque() { SkASSERT(0 == fCount); }
+
+        void push(void (*fn)(void*), void* args, int N, size_t stride, int32_t* pending) {
+            SkAutoMutexAcquire lock(fMutex);
+            Work* work = fWork.append(N);
+            for (int i = 0; i < N; i++) {
+                Work w = { fn, (char*)args + i*stride, pending };
+                work[i] = w;
+            }
+            this->updateCount();
+        }
+
+        bool popBack(Work* work) {
+            if (0 == sk_atomic_load(&fCount, sk_memory_order_relaxed)) {
+                return false;  // Don't bother locking if we're (probably) empty.
+            }
+            SkAutoMutexAcquire lock(fMutex);
+            if (fFront == fWork.count()) {
+                return false;
+            }
+            fWork.pop(work);
+            this->updateCount();
+            return true;
+        }
+
+        bool stealFront(Work* work) {
+            if (0 == sk_atomic_load(&fCount, sk_memory_order_relaxed)) {
+                return false;
+            }
+            SkAutoMutexAcquire lock(fMutex);
+            if (fFront == fWork.count()) {
+                return false;
+            }
+            *work = fWork[fFront++];
+            this->updateCount();
+            return true;
+        }
+
+    private:
+        void updateCount() {
+            if (fFront == fWork.count()) {
+                fWork.rewind();
+                fFront = 0;
+            }
+            sk_atomic_store(&fCount, fWork.count() - fFront, sk_memory_order_relaxed);
+        }
+
+        SkMutex         fMutex;
+        SkTDArray<Work> fWork;   // Work in [fFront, fWork.count()) is queued.
+        int             fFront;
+        int32_t         fCount;  // Atomic mirror of fWork.count() - fFront, read without fMutex.
+    };
+
+    struct Worker {
+        ThreadPool* fPool;
+        int         fIndex;
+        Deque       fDeque;
+        SkThread*   fThread;
+    };
+
+    // SkTLS keys a per-thread int holding the index of that thread in the pool.
+    static void* NewThreadIndex() { return SkNEW_ARGS(int, (-1)); }
+    static void DeleteThreadIndex(void* index) { SkDELETE((int*)index); }
+
+    // Returns the index of the calling thread's Worker, or -1 if it's not one of our threads.
+    static int CurrentThreadIndex() {
+        const int* index = (const int*)SkTLS::Find(NewThreadIndex);
+        return index ? *index : -1;
+    }
+
+    explicit ThreadPool(int threads) : fQueued(0), fSleeping(0), fNextDeque(0), fDraining(false) {
         if (threads == -1) {
             threads = num_cores();
         }
         for (int i = 0; i < threads; i++) {
-            fThreads.push(SkNEW_ARGS(SkThread, (&ThreadPool::Loop, this)));
-            fThreads.top()->start();
+            Worker* worker = SkNEW(Worker);
+            worker->fPool  = this;
+            worker->fIndex = i;
+            fWorkers.push(worker);
+        }
+        // Only start the threads once fWorkers is complete; they'll steal from each other.
+        for (int i = 0; i < fWorkers.count(); i++) {
+            fWorkers[i]->fThread = SkNEW_ARGS(SkThread, (&ThreadPool::Loop, fWorkers[i]));
+            fWorkers[i]->fThread->start();
         }
     }
 
     ~ThreadPool() {
-        SkASSERT(fWork.isEmpty());  // All SkTaskGroups should be destroyed by now.
+        SkASSERT(0 == fQueued);  // All SkTaskGroups should be destroyed by now.
         {
             AutoLock lock(&fReady);
             fDraining = true;
             fReady.broadcast();
         }
-        for (int i = 0; i < fThreads.count(); i++) {
-            fThreads[i]->join();
+        for (int i = 0; i < fWorkers.count(); i++) {
+            fWorkers[i]->fThread->join();
+        }
+        for (int i = 0; i < fWorkers.count(); i++) {
+            SkDELETE(fWorkers[i]->fThread);
+            SkDELETE(fWorkers[i]);
+        }
+    }
+
+    // Work added from one of our threads goes on its own deque.  Work added from any other
+    // thread is dealt out round-robin, so it starts out spread over all our threads.
+    Deque* dequeForAdd() {
+        const int me = CurrentThreadIndex();
+        if (me >= 0) {
+            return &fWorkers[me]->fDeque;
         }
-        SkASSERT(fWork.isEmpty());  // Can't hurt to double check.
-        fThreads.deleteAll();
+        const uint32_t next = (uint32_t)sk_atomic_inc(&fNextDeque);
+        return &fWorkers[next % fWorkers.count()]->fDeque;
     }
 
     void add(void (*fn)(void*), void* arg, int32_t* pending) {
-        Work work = { fn, arg, pending };
         sk_atomic_inc(pending);  // No barrier needed.
-        {
-            AutoLock lock(&fReady);
-            fWork.push(work);
-            fReady.signal();
-        }
+        this->dequeForAdd()->push(fn, arg, 1, 0, pending);
+        this->didQueue(1);
     }
 
     void batch(void (*fn)(void*), void* arg, int N, size_t stride, int32_t* pending) {
+        if (N <= 0) {
+            return;
+        }
         sk_atomic_add(pending, N);  // No barrier needed.
-        {
+        if (CurrentThreadIndex() >= 0) {
+            // Keep it all to ourselves; idle threads will steal what we can't get to.
+            this->dequeForAdd()->push(fn, arg, N, stride, pending);
+        } else {
+            // Split the batch into one contiguous run per thread.
+            const int threads = fWorkers.count();
+            for (int i = 0; i < threads; i++) {
+                const int start = (int)((int64_t)N *  i    / threads),
+                          stop  = (int)((int64_t)N * (i+1) / threads);
+                if (start < stop) {
+                    fWorkers[i]->fDeque.push(fn, (char*)arg + start*stride, stop - start, stride,
+                                             pending);
+                }
+            }
+        }
+        this->didQueue(N);
+    }
+
+    // Take Work from thread me's own deque if it has any, otherwise steal from someone else.
+    // me may be -1, meaning the caller isn't one of our threads and so has no deque of its own.
+    bool take(int me, Work* work) {
+        if (me >= 0 && fWorkers[me]->fDeque.popBack(work)) {
+            sk_atomic_dec(&fQueued);
+            return true;
+        }
+        // Start looking just past ourselves so we don't all pile onto the same victim.
+        const int threads = fWorkers.count();
+        for (int i = 1; i <= threads; i++) {
+            if (fWorkers[(me + i + threads) % threads]->fDeque.stealFront(work)) {
+                sk_atomic_dec(&fQueued);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Called after queueing N Work to wake up any sleeping threads to run it.
+    void didQueue(int N) {
+        // Both fQueued and fSleeping are updated and read sequentially consistently, so either we
+        // see a thread that's going to sleep, or it sees our Work and stays awake.
+        sk_atomic_add(&fQueued, N);
+        if (sk_atomic_load(&fSleeping) > 0) {
             AutoLock lock(&fReady);
-            Work* batch = fWork.append(N);
-            for (int i = 0; i < N; i++) {
-                Work work = { fn, (char*)arg + i*stride, pending };
-                batch[i] = work;
+            if (N == 1) {
+                fReady.signal();
+            } else {
+                fReady.broadcast();
             }
-            fReady.broadcast();
         }
     }
 
+    // Sleep until there might be Work to take.  Returns false if it's time to shut down.
+    bool sleepUntilWork() {
+        AutoLock lock(&fReady);
+        sk_atomic_inc(&fSleeping);
+        while (sk_atomic_load(&fQueued) <= 0 && !fDraining) {
+            fReady.wait();
+        }
+        sk_atomic_dec(&fSleeping);
+        return sk_atomic_load(&fQueued) > 0 || !fDraining;
+    }
+
     static void Loop(void* arg) {
-        ThreadPool* pool = (ThreadPool*)arg;
+        Worker* worker = (Worker*)arg;
+        ThreadPool* pool = worker->fPool;
+        *(int*)SkTLS::Get(NewThreadIndex, DeleteThreadIndex) = worker->fIndex;
+
         Work work;
         while (true) {
-            {
-                AutoLock lock(&pool->fReady);
-                while (pool->fWork.isEmpty()) {
-                    if (pool->fDraining) {
-                        return;
-                    }
-                    pool->fReady.wait();
-                }
-                pool->fWork.pop(&work);
+            if (pool->take(worker->fIndex, &work)) {
+                Run(work);
+            } else if (!pool->sleepUntilWork()) {
+                return;
             }
-            work.fn(work.arg);
-            sk_atomic_dec(work.pending);  // Release pairs with sk_acquire_load() in Wait().
         }
     }
 
-    SkTDArray<Work>      fWork;
-    SkTDArray<SkThread*> fThreads;
-    SkCondVar            fReady;
-    bool                 fDraining;
+    SkTDArray<Worker*> fWorkers;
+    int32_t            fQueued;     // Work queued across all deques.  Atomic.
+    int32_t            fSleeping;   // Threads sleeping (or about to) in sleepUntilWork().  Atomic.
+    int32_t            fNextDeque;  // Round-robin counter for dequeForAdd().  Atomic.
+    SkCondVar          fReady;      // Sleeping threads wait on this.
+    bool               fDraining;   // Protected by fReady.
 
     static ThreadPool* gGlobal;
     friend struct SkTaskGroup::Enabler;
@@ -172,10 +325,13 @@ SkTaskGroup::Enabler::Enabler(int threads) {
 
 SkTaskGroup::Enabler::~Enabler() {
     SkDELETE(ThreadPool::gGlobal);
+    ThreadPool::gGlobal = NULL;  // So another Enabler may follow this one.
 }
 
 SkTaskGroup::SkTaskGroup() : fPending(0) {}
 
+int SkTaskGroup::ThreadCount() { return ThreadPool::ThreadCount(); }
+
 void SkTaskGroup::wait()                            { ThreadPool::Wait(&fPending); }
 void SkTaskGroup::add(SkRunnable* task)             { ThreadPool::Add(task, &fPending); }
 void SkTaskGroup::add(void (*fn)(void*), void* arg) { ThreadPool::Add(fn, arg, &fPending); }
@@ -8,6 +8,7 @@
 #ifndef SkTaskGroup_DEFINED
 #define SkTaskGroup_DEFINED
 
+#include "SkTemplates.h"
 #include "SkTypes.h"
 
 struct SkRunnable;
@@ -20,6 +21,10 @@ public:
         ~Enabler();
     };
 
+    // How many threads an Enabler started, or 0 if SkTaskGroups are not enabled and all work
+    // runs on the calling thread.
+    static int ThreadCount();
+
     SkTaskGroup();
     ~SkTaskGroup() { this->wait(); }
 
@@ -37,6 +42,7 @@ public:
 
     // Block until all Tasks previously add()ed to this SkTaskGroup have run.
     // You may safely reuse this SkTaskGroup after wait() returns.
+    // It's safe to call wait() from inside a task: while waiting we run other queued tasks.
     void wait();
 
 private:
@@ -48,4 +54,32 @@ private:
     /*atomic*/ int32_t fPending;
 };
 
+// Call fn(i) for each i in [0, N), in parallel, handing out grain consecutive i at a time.
+// Returns when all calls have finished.  Like SkTaskGroup::wait(), safe to call from inside a task.
+template <typename Fn>
+void sk_parallel_for(int N, int grain, const Fn& fn) {
+    SkASSERT(grain > 0);
+    struct Chunk {
+        const Fn* fFn;
+        int       fStart, fStop;
+
+        static void Run(Chunk* chunk) {
+            for (int i = chunk->fStart; i < chunk->fStop; i++) {
+                (*chunk->fFn)(i);
+            }
+        }
+    };
+
+    const int count = (N + grain - 1) / grain;
+    SkAutoSTMalloc<32, Chunk> chunks(count);
+    for (int i = 0; i < count; i++) {
+        chunks[i].fFn    = &fn;
+        chunks[i].fStart = i * grain;
+        chunks[i].fStop  = SkTMin(N, (i+1) * grain);
+    }
+    SkTaskGroup tg;
+    tg.batch(Chunk::Run, chunks.get(), count);
+    tg.wait();
+}
+
 #endif//SkTaskGroup_DEFINED
@@ -0,0 +1,64 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCanvas.h"
+#include "SkCanvasPriv.h"
+#include "SkTDArray.h"
+#include "SkTaskGroup.h"
+#include "SkTiledPictureDraw.h"
+
+namespace {
+
+struct Tile {
+    const SkPicture* fPicture;
+    const SkBitmap*  fDst;
+    const SkMatrix*  fMatrix;
+    SkIRect          fBounds;
+
+    static void Draw(Tile* tile) {
+        // We draw through a device as big as dst, limited to our tile, rather than into a subset
+        // of dst.  That keeps device space exactly the same as a serial draw, so we don't pick up
+        // any rounding differences from translating everything by the tile's origin.  We don't
+        // clip to the tile either: paths crossing our seams would be chopped at them, and so
+        // scan converted differently on each side.
+        SkCanvas canvas(*tile->fDst);
+        SkCanvasPriv::SetTileBounds(&canvas, tile->fBounds);
+        if (tile->fMatrix) {
+            canvas.concat(*tile->fMatrix);
+        }
+        tile->fPicture->playback(&canvas);
+    }
+};
+
+}  // namespace
+
+void SkTiledPictureDraw(const SkPicture* picture, const SkBitmap& dst, const SkMatrix* matrix,
+                        int tileW, int tileH) {
+    SkASSERT(picture);
+    SkASSERT(tileW > 0 && tileH > 0);
+    if (dst.drawsNothing()) {
+        return;
+    }
+
+    SkTDArray<Tile> tiles;
+    tiles.setReserve(((dst.width()  + tileW - 1) / tileW) *
+                     ((dst.height() + tileH - 1) / tileH));
+    for (int y = 0; y < dst.height(); y += tileH) {
+        for (int x = 0; x < dst.width(); x += tileW) {
+            Tile* tile = tiles.append();
+            tile->fPicture = picture;
+            tile->fDst     = &dst;
+            tile->fMatrix  = matrix;
+            tile->fBounds  = SkIRect::MakeXYWH(x, y, tileW, tileH);
+            SkAssertResult(tile->fBounds.intersect(SkIRect::MakeWH(dst.width(), dst.height())));
+        }
+    }
+
+    SkTaskGroup tg;
+    tg.batch(Tile::Draw, tiles.begin(), tiles.count());
+    tg.wait();
+}
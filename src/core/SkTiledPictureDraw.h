@@ -0,0 +1,33 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkTiledPictureDraw_DEFINED
+#define SkTiledPictureDraw_DEFINED
+
+#include "SkBitmap.h"
+#include "SkMatrix.h"
+#include "SkPicture.h"
+
+/**
+ *  Rasterize picture into dst in parallel.  dst is split into tileW x tileH tiles, and each tile
+ *  is played back on an SkTaskGroup thread with its own canvas limited to that tile.  Tiles never
+ *  overlap, so threads share no mutable state.  If picture has a bounding box hierarchy (i.e. it
+ *  was recorded with an SkBBHFactory like SkRTreeFactory), each tile replays only the ops that
+ *  touch it.
+ *
+ *  Device space is the same as for picture->playback() into a canvas wrapping dst, and each tile
+ *  scan converts paths against the clip that playback would have (see
+ *  SkCanvasPriv::SetTileBounds), so tiles agree along their seams and the result is bit-identical
+ *  to a serial draw.  Layers are made as big as in a serial draw; each tile only draws into the
+ *  part of them inside it, unless an image filter reads the rest.
+ *
+ *  @param matrix if non-NULL, applied to the CTM before playing back picture.
+ */
+void SkTiledPictureDraw(const SkPicture* picture, const SkBitmap& dst, const SkMatrix* matrix,
+                        int tileW, int tileH);
+
+#endif//SkTiledPictureDraw_DEFINED
@@ -13,6 +13,7 @@
 #include "SkLazyPtr.h"
 #include "SkMathPriv.h"
 #include "SkPMFloat.h"
+#include "SkPMFloatProcs.h"
 #include "SkReadBuffer.h"
 #include "SkString.h"
 #include "SkUtilsArm.h"
@@ -1344,15 +1345,31 @@ public:
     }
 
     void xfer32(SkPMColor dst[], const SkPMColor src[], int n, const SkAlpha aa[]) const override {
+        xfer(dst, src, n, aa);
+    }
+
+    // An SkPMFloatXferProc, see SkPMFloatXferProcFor().
+    static void XferPMFloat(SkPMColor dst[], const SkPMFloat src[], int n, const SkAlpha aa[]) {
+        xfer(dst, src, n, aa);
+    }
+
+private:
+    SkT4fXfermode(const ProcCoeff& rec) : SkProcCoeffXfermode(rec, ProcType::kMode) {}
+
+    static SkPMFloat as_pmfloat(SkPMColor c) { return SkPMFloat(c); }
+    static const SkPMFloat& as_pmfloat(const SkPMFloat& c) { return c; }
+
+    template <typename Src>
+    static void xfer(SkPMColor dst[], const Src src[], int n, const SkAlpha aa[]) {
         if (NULL == aa) {
             for (int i = 0; i < n; ++i) {
-                dst[i] = ProcType::Xfer(SkPMFloat(src[i]), SkPMFloat(dst[i])).round();
+                dst[i] = ProcType::Xfer(as_pmfloat(src[i]), SkPMFloat(dst[i])).round();
             }
         } else {
             for (int i = 0; i < n; ++i) {
                 const Sk4f aa4 = Sk4f(aa[i] * gInv255);
                 SkPMFloat dstF(dst[i]);
-                SkPMFloat srcF(src[i]);
+                SkPMFloat srcF(as_pmfloat(src[i]));
                 Sk4f res;
                 if (ProcType::kFoldCoverageIntoSrcAlpha) {
                     Sk4f src4 = srcF;
@@ -1365,13 +1382,32 @@ public:
         }
     }
 
-private:
-    SkT4fXfermode(const ProcCoeff& rec) : SkProcCoeffXfermode(rec, ProcType::kMode) {}
-
     typedef SkProcCoeffXfermode INHERITED;
 };
 #endif
 
+// These are the modes create_mode() makes an SkT4fXfermode for.
+SkPMFloatXferProc SkPMFloatXferProcFor(const SkXfermode* xfermode) {
+#ifndef SK_SUPPORT_LEGACY_SCALAR_XFERMODES
+    SkXfermode::Mode mode;
+    if (xfermode && xfermode->asMode(&mode)) {
+        switch (mode) {
+            case SkXfermode::kSrcATop_Mode:     return SkT4fXfermode<SrcATop4f>::XferPMFloat;
+            case SkXfermode::kDstATop_Mode:     return SkT4fXfermode<DstATop4f>::XferPMFloat;
+            case SkXfermode::kXor_Mode:         return SkT4fXfermode<Xor4f>::XferPMFloat;
+            case SkXfermode::kPlus_Mode:        return SkT4fXfermode<Plus4f>::XferPMFloat;
+            case SkXfermode::kModulate_Mode:    return SkT4fXfermode<Modulate4f>::XferPMFloat;
+            case SkXfermode::kScreen_Mode:      return SkT4fXfermode<Screen4f>::XferPMFloat;
+            case SkXfermode::kMultiply_Mode:    return SkT4fXfermode<Multiply4f>::XferPMFloat;
+            case SkXfermode::kDifference_Mode:  return SkT4fXfermode<Difference4f>::XferPMFloat;
+            case SkXfermode::kExclusion_Mode:   return SkT4fXfermode<Exclusion4f>::XferPMFloat;
+            default:                            break;
+        }
+    }
+#endif
+    return NULL;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 class SkDstOutXfermode : public SkProcCoeffXfermode {
@@ -0,0 +1,125 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkPMFloat.h"
+#include "SkTemplates.h"
+#include "SkYUVToRGB.h"
+
+namespace {
+
+// Each component of an output pixel is fY*y + fU*u + fV*v + fBias, computed for all four
+// components at once. Alpha always comes out as 255.
+struct YUVCoeffs {
+    SkPMFloat fY, fU, fV, fBias;
+};
+
+static YUVCoeffs yuv_coeffs(SkYUVColorSpace colorSpace) {
+    // These match the matrices GrYUVtoRGBEffect uses, with U and V centered on 128.
+    YUVCoeffs c;
+    switch (colorSpace) {
+        case kRec601_SkYUVColorSpace:
+            // Y is in [16, 235].
+            c.fY    = SkPMFloat::FromARGB(0, 1.164f,  1.164f, 1.164f);
+            c.fU    = SkPMFloat::FromARGB(0, 0,      -0.391f, 2.018f);
+            c.fV    = SkPMFloat::FromARGB(0, 1.596f, -0.813f, 0);
+            c.fBias = SkPMFloat::FromARGB(255, -16 * 1.164f - 128 * 1.596f,
+                                               -16 * 1.164f + 128 * (0.391f + 0.813f),
+                                               -16 * 1.164f - 128 * 2.018f);
+            break;
+        case kJPEG_SkYUVColorSpace:
+        default:
+            c.fY    = SkPMFloat::FromARGB(0, 1,       1,        1);
+            c.fU    = SkPMFloat::FromARGB(0, 0,      -0.34414f, 1.772f);
+            c.fV    = SkPMFloat::FromARGB(0, 1.402f, -0.71414f, 0);
+            c.fBias = SkPMFloat::FromARGB(255, -128 * 1.402f,
+                                                128 * (0.34414f + 0.71414f),
+                                               -128 * 1.772f);
+            break;
+    }
+    return c;
+}
+
+static inline SkPMFloat yuv_to_pmfloat(const YUVCoeffs& c, float y, float u, float v) {
+    return c.fY * Sk4f(y) + c.fU * Sk4f(u) + c.fV * Sk4f(v) + c.fBias;
+}
+
+// A subsampled U or V sample sits at the center of the pixels it covers; the last one may cover
+// fewer than the subsampling factor. Each pixel blends the two samples to either side of its own
+// center, which for 2:1 subsampling weighs them 3:1 like libjpeg's fancy upsampling. Samples
+// past the edge of the plane repeat the edge sample.
+struct ChromaTap {
+    int   fLo, fHi;
+    float fHiWeight;
+};
+
+static void chroma_taps(int fullSize, int subSize, ChromaTap taps[]) {
+    const int factor = (fullSize + subSize - 1) / subSize;
+    for (int i = 0; i < fullSize; i++) {
+        const float center = (i + 0.5f) / factor - 0.5f;
+        const int lo = (int)floorf(center);
+        taps[i].fLo = SkPin32(lo, 0, subSize - 1);
+        taps[i].fHi = SkPin32(lo + 1, 0, subSize - 1);
+        taps[i].fHiWeight = center - lo;
+    }
+}
+
+static inline float lerp(float lo, float hi, float hiWeight) {
+    return lo + (hi - lo) * hiWeight;
+}
+
+}  // namespace
+
+void SkYUVToN32(const SkISize sizes[3], const void* const planes[3], const size_t rowBytes[3],
+                SkYUVColorSpace colorSpace, SkPMColor* dst, size_t dstRowBytes) {
+    SkASSERT(sizes[1] == sizes[2]);
+    const YUVCoeffs c = yuv_coeffs(colorSpace);
+    const int width    = sizes[0].width(),
+              height   = sizes[0].height(),
+              uvWidth  = sizes[1].width(),
+              uvHeight = sizes[1].height();
+
+    // Work out which U and V samples each column and row blends once, up front.
+    SkAutoSTMalloc<256, ChromaTap> columnTaps(width), rowTaps(height);
+    chroma_taps(width, uvWidth, columnTaps.get());
+    chroma_taps(height, uvHeight, rowTaps.get());
+
+    // Each output row first blends its two U and V rows, then each pixel its two samples.
+    SkAutoSTMalloc<512, float> uvRows(2 * uvWidth);
+    float* uRow = uvRows.get();
+    float* vRow = uvRows.get() + uvWidth;
+
+    for (int y = 0; y < height; y++) {
+        const ChromaTap& rowTap = rowTaps[y];
+        const uint8_t* yRow  = (const uint8_t*)planes[0] + y * rowBytes[0];
+        const uint8_t* uLo = (const uint8_t*)planes[1] + rowTap.fLo * rowBytes[1];
+        const uint8_t* uHi = (const uint8_t*)planes[1] + rowTap.fHi * rowBytes[1];
+        const uint8_t* vLo = (const uint8_t*)planes[2] + rowTap.fLo * rowBytes[2];
+        const uint8_t* vHi = (const uint8_t*)planes[2] + rowTap.fHi * rowBytes[2];
+        for (int x = 0; x < uvWidth; x++) {
+            uRow[x] = lerp(uLo[x], uHi[x], rowTap.fHiWeight);
+            vRow[x] = lerp(vLo[x], vHi[x], rowTap.fHiWeight);
+        }
+
+        int x = 0;
+        for (; x + 4 <= width; x += 4) {
+            SkPMFloat px[4];
+            for (int i = 0; i < 4; i++) {
+                const ChromaTap& t = columnTaps[x + i];
+                px[i] = yuv_to_pmfloat(c, yRow[x + i], lerp(uRow[t.fLo], uRow[t.fHi], t.fHiWeight),
+                                                       lerp(vRow[t.fLo], vRow[t.fHi], t.fHiWeight));
+            }
+            SkPMFloat::RoundClampTo4PMColors(px[0], px[1], px[2], px[3], dst + x);
+        }
+        for (; x < width; x++) {
+            const ChromaTap& t = columnTaps[x];
+            dst[x] = yuv_to_pmfloat(c, yRow[x], lerp(uRow[t.fLo], uRow[t.fHi], t.fHiWeight),
+                                                lerp(vRow[t.fLo], vRow[t.fHi], t.fHiWeight))
+                             .roundClamp();
+        }
+        dst = SkTAddOffset<SkPMColor>(dst, dstRowBytes);
+    }
+}
@@ -0,0 +1,23 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkYUVToRGB_DEFINED
+#define SkYUVToRGB_DEFINED
+
+#include "SkColor.h"
+#include "SkImageInfo.h"
+
+/**
+ *  Converts 8-bit Y, U and V planes, as returned by SkImageGenerator::getYUV8Planes(), to opaque
+ *  N32 pixels the size of the Y plane. The U and V planes must be the same size as each other,
+ *  but may be subsampled, in which case each pixel interpolates between the nearest U and V
+ *  samples, as libjpeg's fancy upsampling does.
+ */
+void SkYUVToN32(const SkISize sizes[3], const void* const planes[3], const size_t rowBytes[3],
+                SkYUVColorSpace, SkPMColor* dst, size_t dstRowBytes);
+
+#endif
@@ -5,6 +5,7 @@
  * found in the LICENSE file.
  */
 
+#include "SkAtomics.h"
 #include "SkDocument.h"
 #include "SkPDFCanon.h"
 #include "SkPDFDevice.h"
@@ -12,7 +13,9 @@
 #include "SkPDFResourceDict.h"
 #include "SkPDFStream.h"
 #include "SkPDFTypes.h"
+#include "SkPictureRecorder.h"
 #include "SkStream.h"
+#include "SkTaskGroup.h"
 
 static void emit_pdf_header(SkWStream* stream) {
     stream->writeText("%PDF-1.4\n%");
@@ -166,7 +169,17 @@ static void generate_page_tree(const SkTDArray<SkPDFDict*>& pages,
     }
 }
 
+// Compresses objects on SkTaskGroup threads, before they are written in order.
+static void compress_objects(const SkTDArray<SkPDFObject*>& objects, int level) {
+    sk_parallel_for(objects.count(), 1, [&](int i) {
+        if (SkPDFObject* object = objects[i]) {
+            object->compress(level);
+        }
+    });
+}
+
 static bool emit_pdf_document(const SkTDArray<const SkPDFDevice*>& pageDevices,
+                              int deflateLevel,
                               SkWStream* stream) {
     if (pageDevices.isEmpty()) {
         return false;
@@ -215,6 +228,7 @@ static bool emit_pdf_document(const SkTDArray<const SkPDFDevice*>& pageDevices,
     if (objNumMap.addObject(docCatalog.get())) {
         docCatalog->addResources(&objNumMap, substitutes);
     }
+    compress_objects(objNumMap.objects(), deflateLevel);
     size_t baseOffset = SkToOffT(stream->bytesWritten());
     emit_pdf_header(stream);
     SkTDArray<int32_t> offsets;
@@ -254,6 +268,220 @@ static bool emit_pdf_document(const SkTDArray<const SkPDFDevice*>& pageDevices,
     return true;
 }
 
+namespace {
+// Stands in for a font until the document is closed, when we know which of its
+// glyphs are used and so what to write: the font itself, or a subset of it.
+class PDFFontPlaceholder : public SkPDFObject {
+public:
+    explicit PDFFontPlaceholder(SkPDFFont* font) : fFont(SkRef(font)) {}
+
+    SkPDFFont* font() const { return fFont.get(); }
+    void setTarget(SkPDFObject* target) { fTarget.reset(SkRef(target)); }
+
+    void emitObject(SkWStream* stream,
+                    const SkPDFObjNumMap& objNumMap,
+                    const SkPDFSubstituteMap& substitutes) override {
+        SkASSERT(fTarget.get());
+        fTarget->emitObject(stream, objNumMap, substitutes);
+    }
+
+    void addResources(SkPDFObjNumMap* objNumMap,
+                      const SkPDFSubstituteMap& substitutes) const override {
+        // Until we have a target, there is nothing to add.
+        if (fTarget.get()) {
+            fTarget->addResources(objNumMap, substitutes);
+        }
+    }
+
+private:
+    SkAutoTUnref<SkPDFFont> fFont;
+    SkAutoTUnref<SkPDFObject> fTarget;
+};
+
+/**
+ *  Writes a PDF document a page at a time.  Each page, and every object it
+ *  refers to that has not been written yet, is written as soon as the page
+ *  is added; whatever only that page used can then be freed.  Objects that
+ *  are still referenced elsewhere (usually by the SkPDFCanon) stay alive,
+ *  keeping their object numbers, until the end, but are told to drop() any
+ *  data they only needed to be written.
+ *
+ *  Fonts are the exception: they're subset to the glyphs used by the whole
+ *  document, so pages refer to them through placeholders written by end().
+ *
+ *  All pages hang directly off one page tree node, whose object number must
+ *  be known before the first page is written.
+ */
+class PDFStreamer : SkNoncopyable {
+public:
+    PDFStreamer(SkWStream* stream, int deflateLevel)
+        : fCatalog(SkNEW_ARGS(SkPDFDict, ("Catalog")))
+        , fPageTreeRoot(SkNEW_ARGS(SkPDFDict, ("Pages")))
+        , fKids(SkNEW(SkPDFArray))
+        , fDests(SkNEW(SkPDFDict))
+        , fBaseOffset(stream->bytesWritten())
+        , fDeflateLevel(deflateLevel) {
+        emit_pdf_header(stream);
+        fCatalog->insert("Pages", new SkPDFObjRef(fPageTreeRoot.get()))->unref();
+        fPageTreeRoot->insert("Kids", fKids.get());
+        // The catalog and page tree root are written by end(), once they are complete.
+        fObjNumMap.addObject(fCatalog.get());
+        fObjNumMap.addObject(fPageTreeRoot.get());
+        fObjNumMap.trimObjects();
+        fOffsets.setCount(fObjNumMap.objectCount());
+        sk_bzero(fOffsets.begin(), fOffsets.count() * sizeof(int32_t));
+    }
+
+    ~PDFStreamer() {
+        fHeld.unrefAll();
+        fPlaceholders.unrefAll();
+    }
+
+    void addPage(const SkPDFDevice* pageDevice, SkWStream* stream) {
+        SkAutoTUnref<SkPDFDict> page(create_pdf_page(pageDevice));
+        page->insert("Parent", new SkPDFObjRef(fPageTreeRoot.get()))->unref();
+        pageDevice->appendDestinations(fDests, page.get());
+        fKids->append(new SkPDFObjRef(page.get()))->unref();
+
+        const SkPDFGlyphSetMap& usage = pageDevice->getFontGlyphUsage();
+        fGlyphUsage.merge(usage);
+        SkPDFGlyphSetMap::F2BIter iterator(usage);
+        while (const SkPDFGlyphSetMap::FontGlyphSetPair* entry = iterator.next()) {
+            if (fSubstitutes.getSubstitute(entry->fFont) == entry->fFont) {
+                PDFFontPlaceholder* placeholder =
+                        SkNEW_ARGS(PDFFontPlaceholder, (entry->fFont));
+                fSubstitutes.setSubstitute(entry->fFont, placeholder);
+                fPlaceholders.push(placeholder);
+            }
+        }
+
+        if (fObjNumMap.addObject(page.get())) {
+            page->addResources(&fObjNumMap, fSubstitutes);
+        }
+        this->writeNewObjects(stream);
+
+        // The page tree has both child and parent pointers, so it creates a
+        // reference cycle.  The page is written, so we can break it now.
+        page->clear();
+    }
+
+    // Frees everything written so far that nothing else holds on to.
+    void freeUnshared() {
+        for (int i = 0; i < fHeld.count(); ) {
+            if (fHeld[i]->unique()) {
+                fObjNumMap.forgetObject(fHeld[i]);
+                fHeld[i]->unref();
+                fHeld.removeShuffle(i);
+            } else {
+                i++;
+            }
+        }
+    }
+
+    void end(SkWStream* stream) {
+        SkPDFGlyphSetMap::F2BIter iterator(fGlyphUsage);
+        while (const SkPDFGlyphSetMap::FontGlyphSetPair* entry = iterator.next()) {
+            SkAutoTUnref<SkPDFFont> subsetFont(
+                    entry->fFont->getFontSubset(entry->fGlyphSet));
+            for (int i = 0; i < fPlaceholders.count(); i++) {
+                if (fPlaceholders[i]->font() == entry->fFont) {
+                    fPlaceholders[i]->setTarget(subsetFont ? subsetFont.get()
+                                                           : entry->fFont);
+                }
+            }
+        }
+        for (int i = 0; i < fPlaceholders.count(); i++) {
+            fPlaceholders[i]->addResources(&fObjNumMap, fSubstitutes);
+        }
+
+        fPageTreeRoot->insertInt("Count", fKids->size());
+        if (fDests->size() > 0) {
+            fCatalog->insert("Dests", SkNEW_ARGS(SkPDFObjRef, (fDests.get())))->unref();
+        }
+        fCatalog->addResources(&fObjNumMap, fSubstitutes);
+
+        // Write the catalog, page tree root and font placeholders we skipped, then the rest.
+        this->writeObject(fCatalog.get(), stream);
+        this->writeObject(fPageTreeRoot.get(), stream);
+        for (int i = 0; i < fSkipped.count(); i++) {
+            this->writeObject(fSkipped[i], stream);
+            fSkipped[i]->drop();
+        }
+        this->writeNewObjects(stream);
+
+        int32_t xRefFileOffset = SkToS32(stream->bytesWritten() - fBaseOffset);
+        // Include the zeroth object in the count.
+        int32_t objCount = SkToS32(fOffsets.count() + 1);
+
+        stream->writeText("xref\n0 ");
+        stream->writeDecAsText(objCount);
+        stream->writeText("\n0000000000 65535 f \n");
+        for (int i = 0; i < fOffsets.count(); i++) {
+            SkASSERT(fOffsets[i] > 0);
+            stream->writeBigDecAsText(fOffsets[i], 10);
+            stream->writeText(" 00000 n \n");
+        }
+        emit_pdf_footer(stream, fObjNumMap, fSubstitutes, fCatalog.get(), objCount,
+                        xRefFileOffset);
+
+        fPageTreeRoot->clear();
+    }
+
+private:
+    bool isPlaceholder(SkPDFObject* object) const {
+        return fPlaceholders.find(static_cast<PDFFontPlaceholder*>(object)) >= 0;
+    }
+
+    void writeObject(SkPDFObject* object, SkWStream* stream) {
+        SkASSERT(object == fSubstitutes.getSubstitute(object));
+        const int32_t number = fObjNumMap.getObjectNumber(object);
+        SkASSERT(0 == fOffsets[number - 1]);
+        fOffsets[number - 1] = SkToS32(stream->bytesWritten() - fBaseOffset);
+        stream->writeDecAsText(number);
+        stream->writeText(" 0 obj\n");  // Generation number is always 0.
+        object->emitObject(stream, fObjNumMap, fSubstitutes);
+        stream->writeText("\nendobj\n");
+    }
+
+    // Writes all the objects numbered since last time, except for those end() must write.
+    void writeNewObjects(SkWStream* stream) {
+        const SkTDArray<SkPDFObject*>& objects = fObjNumMap.objects();
+        while (fOffsets.count() < fObjNumMap.objectCount()) {
+            fOffsets.push(0);
+        }
+        compress_objects(objects, fDeflateLevel);
+        for (int i = 0; i < objects.count(); i++) {
+            SkPDFObject* object = objects[i];
+            if (this->isPlaceholder(object)) {
+                fSkipped.push(object);
+                continue;
+            }
+            this->writeObject(object, stream);
+            object->drop();
+            fHeld.push(SkRef(object));
+        }
+        fObjNumMap.trimObjects();
+    }
+
+    SkAutoTUnref<SkPDFDict> fCatalog;
+    SkAutoTUnref<SkPDFDict> fPageTreeRoot;
+    SkAutoTUnref<SkPDFArray> fKids;
+    SkAutoTUnref<SkPDFDict> fDests;
+
+    SkPDFSubstituteMap fSubstitutes;
+    SkPDFObjNumMap fObjNumMap;
+    SkPDFGlyphSetMap fGlyphUsage;
+    SkTDArray<PDFFontPlaceholder*> fPlaceholders;  // Refs held.
+    SkTDArray<SkPDFObject*> fSkipped;  // Placeholders numbered, but left for end().
+    SkTDArray<SkPDFObject*> fHeld;  // Written objects not yet freed.  Refs held.
+    // Indexed by object number - 1, 0 if not yet written.  The xref table written by end()
+    // needs every object's offset, so this is the one thing that grows with the document.
+    SkTDArray<int32_t> fOffsets;
+    size_t fBaseOffset;
+    int fDeflateLevel;
+};
+}  // namespace
+
 #if 0
 // TODO(halcanary): expose notEmbeddableCount in SkDocument
 void GetCountOfFontTypes(
@@ -296,13 +524,44 @@ void GetCountOfFontTypes(
 ////////////////////////////////////////////////////////////////////////////////
 
 namespace {
+// Pages are recorded into SkPictures, then each is played back into its SkPDFDevice as a
+// SkTaskGroup task, so with SkTaskGroup::Enabler on, pages convert to PDF in parallel with
+// each other and with the recording of later pages.  All page devices share the document's
+// thread-safe SkPDFCanon, and objects are numbered when the document is emitted, in page
+// order, so the output does not depend on which thread finished first.
+struct PDFPage {
+    SkPDFCanon*                fCanon;
+    SkScalar                   fRasterDpi;
+    SkISize                    fSize;
+    SkRect                     fTrimBox;
+    SkAutoTUnref<SkPicture>    fContent;
+    SkAutoTUnref<SkPDFDevice>  fDevice;
+    SkAtomic<bool>             fDone;
+
+    static void Draw(PDFPage* page) {
+        page->fDevice.reset(SkPDFDevice::Create(page->fSize, page->fRasterDpi, page->fCanon));
+        SkCanvas canvas(page->fDevice.get());
+        canvas.clipRect(page->fTrimBox);
+        canvas.translate(page->fTrimBox.x(), page->fTrimBox.y());
+        page->fContent->playback(&canvas);
+        canvas.flush();
+        page->fContent.reset(NULL);
+        page->fDone.store(true, sk_memory_order_release);
+    }
+};
+
 class SkDocument_PDF : public SkDocument {
 public:
     SkDocument_PDF(SkWStream* stream,
                    void (*doneProc)(SkWStream*, bool),
-                   SkScalar rasterDpi)
+                   SkScalar rasterDpi,
+                   int deflateLevel,
+                   bool streaming)
         : SkDocument(stream, doneProc)
-        , fRasterDpi(rasterDpi) {}
+        , fRasterDpi(rasterDpi)
+        , fDeflateLevel(deflateLevel)
+        , fStreaming(streaming)
+        , fFlushedPages(0) {}
 
     virtual ~SkDocument_PDF() {
         // subclasses must call close() in their destructors
@@ -312,50 +571,117 @@ public:
 protected:
     virtual SkCanvas* onBeginPage(SkScalar width, SkScalar height,
                                   const SkRect& trimBox) override {
-        SkASSERT(!fCanvas.get());
+        SkASSERT(!fRecorder.get());
 
-        SkISize pageSize = SkISize::Make(
+        PDFPage* page = SkNEW(PDFPage);
+        page->fCanon = &fCanon;
+        page->fRasterDpi = fRasterDpi;
+        page->fSize = SkISize::Make(
                 SkScalarRoundToInt(width), SkScalarRoundToInt(height));
-        SkAutoTUnref<SkPDFDevice> device(
-                SkPDFDevice::Create(pageSize, fRasterDpi, &fCanon));
-        fCanvas.reset(SkNEW_ARGS(SkCanvas, (device.get())));
-        fPageDevices.push(device.detach());
-        fCanvas->clipRect(trimBox);
-        fCanvas->translate(trimBox.x(), trimBox.y());
-        return fCanvas.get();
+        page->fTrimBox = trimBox;
+        page->fDone.store(false);
+        fPages.push(page);
+
+        fRecorder.reset(SkNEW(SkPictureRecorder));
+        return fRecorder->beginRecording(trimBox.width(), trimBox.height());
     }
 
     void onEndPage() override {
-        SkASSERT(fCanvas.get());
-        fCanvas->flush();
-        fCanvas.reset(NULL);
+        SkASSERT(fRecorder.get());
+        PDFPage* page = fPages.top();
+        page->fContent.reset(fRecorder->endRecording());
+        fRecorder.reset(NULL);
+        fTasks.add(PDFPage::Draw, page);
+        if (fStreaming) {
+            this->flushPages(this->getStream(), false);
+        }
     }
 
     bool onClose(SkWStream* stream) override {
-        SkASSERT(!fCanvas.get());
+        SkASSERT(!fRecorder.get());
+        if (fStreaming) {
+            this->flushPages(stream, true);
+            bool success = fStreamer.get() != NULL;
+            if (success) {
+                fStreamer->end(stream);
+            }
+            this->reset();
+            return success;
+        }
+        fTasks.wait();
 
-        bool success = emit_pdf_document(fPageDevices, stream);
-        fPageDevices.unrefAll();
-        fCanon.reset();
+        SkTDArray<const SkPDFDevice*> pageDevices;
+        for (int i = 0; i < fPages.count(); i++) {
+            pageDevices.push(fPages[i]->fDevice.get());
+        }
+        bool success = emit_pdf_document(pageDevices, fDeflateLevel, stream);
+        this->reset();
         return success;
     }
 
     void onAbort() override {
-        fPageDevices.unrefAll();
-        fCanon.reset();
+        fRecorder.reset(NULL);
+        fTasks.wait();
+        this->reset();
     }
 
 private:
+    // When streaming, we let at most this many pages wait to be converted before we block.
+    static const int kMaxUnflushedPages = 8;
+
+    // Writes out converted pages, in order, and frees them.  If all, waits for every page.
+    void flushPages(SkWStream* stream, bool all) {
+        if (all || fPages.count() - fFlushedPages > kMaxUnflushedPages) {
+            fTasks.wait();
+        }
+        while (fFlushedPages < fPages.count() &&
+               fPages[fFlushedPages]->fDone.load(sk_memory_order_acquire)) {
+            if (!fStreamer.get()) {
+                fStreamer.reset(SkNEW_ARGS(PDFStreamer, (stream, fDeflateLevel)));
+            }
+            fStreamer->addPage(fPages[fFlushedPages]->fDevice, stream);
+            SkDELETE(fPages[fFlushedPages]);
+            fPages[fFlushedPages++] = NULL;
+            fStreamer->freeUnshared();
+        }
+    }
+
+    void reset() {
+        fStreamer.reset(NULL);
+        fPages.deleteAll();
+        fFlushedPages = 0;
+        fCanon.reset();
+    }
+
     SkPDFCanon fCanon;
-    SkTDArray<const SkPDFDevice*> fPageDevices;
-    SkAutoTUnref<SkCanvas> fCanvas;
+    SkTDArray<PDFPage*> fPages;
+    SkAutoTDelete<SkPictureRecorder> fRecorder;
+    SkTaskGroup fTasks;
     SkScalar fRasterDpi;
+    int fDeflateLevel;
+    bool fStreaming;
+    int fFlushedPages;
+    SkAutoTDelete<PDFStreamer> fStreamer;
 };
 }  // namespace
 ///////////////////////////////////////////////////////////////////////////////
 
-SkDocument* SkDocument::CreatePDF(SkWStream* stream, SkScalar dpi) {
-    return stream ? SkNEW_ARGS(SkDocument_PDF, (stream, NULL, dpi)) : NULL;
+static bool valid_deflate_level(int level) {
+    return SK_PDFDefaultDeflateLevel == level || (0 <= level && level <= 9);
+}
+
+SkDocument* SkDocument::CreatePDF(SkWStream* stream, SkScalar dpi, int deflateLevel) {
+    if (!stream || !valid_deflate_level(deflateLevel)) {
+        return NULL;
+    }
+    return SkNEW_ARGS(SkDocument_PDF, (stream, NULL, dpi, deflateLevel, false));
+}
+
+SkDocument* SkDocument::CreateStreamingPDF(SkWStream* stream, SkScalar dpi, int deflateLevel) {
+    if (!stream || !valid_deflate_level(deflateLevel)) {
+        return NULL;
+    }
+    return SkNEW_ARGS(SkDocument_PDF, (stream, NULL, dpi, deflateLevel, true));
 }
 
 SkDocument* SkDocument::CreatePDF(const char path[], SkScalar dpi) {
@@ -365,5 +691,6 @@ SkDocument* SkDocument::CreatePDF(const char path[], SkScalar dpi) {
         return NULL;
     }
     auto delete_wstream = [](SkWStream* stream, bool) { SkDELETE(stream); };
-    return SkNEW_ARGS(SkDocument_PDF, (stream, delete_wstream, dpi));
+    return SkNEW_ARGS(SkDocument_PDF, (stream, delete_wstream, dpi, SK_PDFDefaultDeflateLevel,
+                                       false));
 }
@@ -149,7 +149,10 @@ bool SkBlurImageFilter::onFilterImage(Proxy* proxy,
                                       SkBitmap* dst, SkIPoint* offset) const {
     SkBitmap src = source;
     SkIPoint srcOffset = SkIPoint::Make(0, 0);
-    if (getInput(0) && !getInput(0)->filterImage(proxy, source, ctx, &src, &srcOffset)) {
+    // Blur the clip plus the margin it reads from, so pixels inside the clip come out the same
+    // however the clip is drawn.
+    const Context blurCtx = this->mapContext(ctx);
+    if (getInput(0) && !getInput(0)->filterImage(proxy, source, blurCtx, &src, &srcOffset)) {
         return false;
     }
 
@@ -158,7 +161,7 @@ bool SkBlurImageFilter::onFilterImage(Proxy* proxy,
     }
 
     SkIRect srcBounds, dstBounds;
-    if (!this->applyCropRect(ctx, proxy, src, &srcOffset, &srcBounds, &src)) {
+    if (!this->applyCropRect(blurCtx, proxy, src, &srcOffset, &srcBounds, &src)) {
         return false;
     }
 
@@ -242,12 +245,18 @@ void SkBlurImageFilter::computeFastBounds(const SkRect& src, SkRect* dst) const
                 SkScalarMul(fSigma.height(), SkIntToScalar(3)));
 }
 
+void SkBlurImageFilter::onFilterNodeBounds(const SkIRect& src, const SkMatrix& ctm,
+                                           SkIRect* dst) const {
+    *dst = src;
+    SkVector sigma = mapSigma(fSigma, ctm);
+    dst->outset(SkScalarCeilToInt(SkScalarMul(sigma.x(), SkIntToScalar(3))),
+                SkScalarCeilToInt(SkScalarMul(sigma.y(), SkIntToScalar(3))));
+}
+
 bool SkBlurImageFilter::onFilterBounds(const SkIRect& src, const SkMatrix& ctm,
                                        SkIRect* dst) const {
-    SkIRect bounds = src;
-    SkVector sigma = mapSigma(fSigma, ctm);
-    bounds.outset(SkScalarCeilToInt(SkScalarMul(sigma.x(), SkIntToScalar(3))),
-                  SkScalarCeilToInt(SkScalarMul(sigma.y(), SkIntToScalar(3))));
+    SkIRect bounds;
+    this->onFilterNodeBounds(src, ctm, &bounds);
     if (getInput(0) && !getInput(0)->filterBounds(bounds, ctm, &bounds)) {
         return false;
     }
@@ -260,11 +269,13 @@ bool SkBlurImageFilter::filterImageGPU(Proxy* proxy, const SkBitmap& src, const
 #if SK_SUPPORT_GPU
     SkBitmap input = src;
     SkIPoint srcOffset = SkIPoint::Make(0, 0);
-    if (getInput(0) && !getInput(0)->getInputResultGPU(proxy, src, ctx, &input, &srcOffset)) {
+    const Context blurCtx = this->mapContext(ctx);
+    if (getInput(0) &&
+        !getInput(0)->getInputResultGPU(proxy, src, blurCtx, &input, &srcOffset)) {
         return false;
     }
     SkIRect rect;
-    if (!this->applyCropRect(ctx, proxy, input, &srcOffset, &rect, &input)) {
+    if (!this->applyCropRect(blurCtx, proxy, input, &srcOffset, &rect, &input)) {
         return false;
     }
     GrTexture* source = input.getTexture();
@@ -9,6 +9,8 @@
 
 #include "SkBlurMask.h"
 #include "SkMath.h"
+#include "SkNx.h"
+#include "SkTaskGroup.h"
 #include "SkTemplates.h"
 #include "SkEndian.h"
 
@@ -33,11 +35,10 @@ SkScalar SkBlurMask::ConvertSigmaToRadius(SkScalar sigma) {
 #define UNROLL_SEPARABLE_LOOPS
 
 /**
- * This function performs a box blur in X, of the given radius.  If the
- * "transpose" parameter is true, it will transpose the pixels on write,
- * such that X and Y are swapped. Reads are always performed from contiguous
- * memory in X, for speed. The destination buffer (dst) must be at least
- * (width + leftRadius + rightRadius) * height bytes in size.
+ * This function performs a box blur in X, of the given radius, on rows
+ * [0, height). The destination buffer (dst) must be at least
+ * (width + 2 * max(leftRadius, rightRadius)) * height bytes in size, and its
+ * rows are that many bytes apart.
  *
  * This is what the inner loop looks like before unrolling, and with the two
  * cases broken out separately (width < diameter, width >= diameter):
@@ -46,47 +47,45 @@ SkScalar SkBlurMask::ConvertSigmaToRadius(SkScalar sigma) {
  *          for (int x = 0; x < width; ++x) {
  *              sum += *right++;
  *              *dptr = (sum * scale + half) >> 24;
- *              dptr += dst_x_stride;
+ *              dptr += 1;
  *          }
  *          for (int x = width; x < diameter; ++x) {
  *              *dptr = (sum * scale + half) >> 24;
- *              dptr += dst_x_stride;
+ *              dptr += 1;
  *          }
  *          for (int x = 0; x < width; ++x) {
  *              *dptr = (sum * scale + half) >> 24;
  *              sum -= *left++;
- *              dptr += dst_x_stride;
+ *              dptr += 1;
  *          }
  *      } else {
  *          for (int x = 0; x < diameter; ++x) {
  *              sum += *right++;
  *              *dptr = (sum * scale + half) >> 24;
- *              dptr += dst_x_stride;
+ *              dptr += 1;
  *          }
  *          for (int x = diameter; x < width; ++x) {
  *              sum += *right++;
  *              *dptr = (sum * scale + half) >> 24;
  *              sum -= *left++;
- *              dptr += dst_x_stride;
+ *              dptr += 1;
  *          }
  *          for (int x = 0; x < diameter; ++x) {
  *              *dptr = (sum * scale + half) >> 24;
  *              sum -= *left++;
- *              dptr += dst_x_stride;
+ *              dptr += 1;
  *          }
  *      }
  */
 static int boxBlur(const uint8_t* src, int src_y_stride, uint8_t* dst,
-                   int leftRadius, int rightRadius, int width, int height,
-                   bool transpose)
+                   int leftRadius, int rightRadius, int width, int height)
 {
     int diameter = leftRadius + rightRadius;
     int kernelSize = diameter + 1;
     int border = SkMin32(width, diameter);
     uint32_t scale = (1 << 24) / kernelSize;
     int new_width = width + SkMax32(leftRadius, rightRadius) * 2;
-    int dst_x_stride = transpose ? height : 1;
-    int dst_y_stride = transpose ? 1 : new_width;
+    int dst_y_stride = new_width;
     uint32_t half = 1 << 23;
     for (int y = 0; y < height; ++y) {
         uint32_t sum = 0;
@@ -95,12 +94,12 @@ static int boxBlur(const uint8_t* src, int src_y_stride, uint8_t* dst,
         const uint8_t* left = right;
         for (int x = 0; x < rightRadius - leftRadius; x++) {
             *dptr = 0;
-            dptr += dst_x_stride;
+            dptr += 1;
         }
 #define LEFT_BORDER_ITER \
             sum += *right++; \
             *dptr = (sum * scale + half) >> 24; \
-            dptr += dst_x_stride;
+            dptr += 1;
 
         int x = 0;
 #ifdef UNROLL_SEPARABLE_LOOPS
@@ -129,7 +128,7 @@ static int boxBlur(const uint8_t* src, int src_y_stride, uint8_t* dst,
 #undef LEFT_BORDER_ITER
 #define TRIVIAL_ITER \
             *dptr = (sum * scale + half) >> 24; \
-            dptr += dst_x_stride;
+            dptr += 1;
         x = width;
 #ifdef UNROLL_SEPARABLE_LOOPS
         for (; x < diameter - 16; x += 16) {
@@ -159,7 +158,7 @@ static int boxBlur(const uint8_t* src, int src_y_stride, uint8_t* dst,
             sum += *right++; \
             *dptr = (sum * scale + half) >> 24; \
             sum -= *left++; \
-            dptr += dst_x_stride;
+            dptr += 1;
 
         x = diameter;
 #ifdef UNROLL_SEPARABLE_LOOPS
@@ -189,7 +188,7 @@ static int boxBlur(const uint8_t* src, int src_y_stride, uint8_t* dst,
 #define RIGHT_BORDER_ITER \
             *dptr = (sum * scale + half) >> 24; \
             sum -= *left++; \
-            dptr += dst_x_stride;
+            dptr += 1;
 
         x = 0;
 #ifdef UNROLL_SEPARABLE_LOOPS
@@ -218,7 +217,7 @@ static int boxBlur(const uint8_t* src, int src_y_stride, uint8_t* dst,
 #undef RIGHT_BORDER_ITER
         for (int x = 0; x < leftRadius - rightRadius; ++x) {
             *dptr = 0;
-            dptr += dst_x_stride;
+            dptr += 1;
         }
         SkASSERT(sum == 0);
     }
@@ -241,16 +240,16 @@ static int boxBlur(const uint8_t* src, int src_y_stride, uint8_t* dst,
  *              inner_sum = outer_sum;
  *              outer_sum += *right++;
  *              *dptr = (outer_sum * outer_scale + inner_sum * inner_scale + half) >> 24;
- *              dptr += dst_x_stride;
+ *              dptr += 1;
  *          }
  *          for (int x = width; x < diameter; ++x) {
  *              *dptr = (outer_sum * outer_scale + inner_sum * inner_scale + half) >> 24;
- *              dptr += dst_x_stride;
+ *              dptr += 1;
  *          }
  *          for (int x = 0; x < width; x++) {
  *              inner_sum = outer_sum - *left++;
  *              *dptr = (outer_sum * outer_scale + inner_sum * inner_scale + half) >> 24;
- *              dptr += dst_x_stride;
+ *              dptr += 1;
  *              outer_sum = inner_sum;
  *          }
  *      } else {
@@ -258,19 +257,19 @@ static int boxBlur(const uint8_t* src, int src_y_stride, uint8_t* dst,
  *              inner_sum = outer_sum;
  *              outer_sum += *right++;
  *              *dptr = (outer_sum * outer_scale + inner_sum * inner_scale + half) >> 24;
- *              dptr += dst_x_stride;
+ *              dptr += 1;
  *          }
  *          for (int x = diameter; x < width; ++x) {
  *              inner_sum = outer_sum - *left;
  *              outer_sum += *right++;
  *              *dptr = (outer_sum * outer_scale + inner_sum * inner_scale + half) >> 24;
- *              dptr += dst_x_stride;
+ *              dptr += 1;
  *              outer_sum -= *left++;
  *          }
  *          for (int x = 0; x < diameter; x++) {
  *              inner_sum = outer_sum - *left++;
  *              *dptr = (outer_sum * outer_scale + inner_sum * inner_scale + half) >> 24;
- *              dptr += dst_x_stride;
+ *              dptr += 1;
  *              outer_sum = inner_sum;
  *          }
  *      }
@@ -279,8 +278,7 @@ static int boxBlur(const uint8_t* src, int src_y_stride, uint8_t* dst,
  */
 
 static int boxBlurInterp(const uint8_t* src, int src_y_stride, uint8_t* dst,
-                         int radius, int width, int height,
-                         bool transpose, uint8_t outer_weight)
+                         int radius, int width, int height, uint8_t outer_weight)
 {
     int diameter = radius * 2;
     int kernelSize = diameter + 1;
@@ -292,8 +290,7 @@ static int boxBlurInterp(const uint8_t* src, int src_y_stride, uint8_t* dst,
     uint32_t inner_scale = (inner_weight << 16) / (kernelSize - 2);
     uint32_t half = 1 << 23;
     int new_width = width + diameter;
-    int dst_x_stride = transpose ? height : 1;
-    int dst_y_stride = transpose ? 1 : new_width;
+    int dst_y_stride = new_width;
     for (int y = 0; y < height; ++y) {
         uint32_t outer_sum = 0, inner_sum = 0;
         uint8_t* dptr = dst + y * dst_y_stride;
@@ -305,7 +302,7 @@ static int boxBlurInterp(const uint8_t* src, int src_y_stride, uint8_t* dst,
             inner_sum = outer_sum; \
             outer_sum += *right++; \
             *dptr = (outer_sum * outer_scale + inner_sum * inner_scale + half) >> 24; \
-            dptr += dst_x_stride;
+            dptr += 1;
 
 #ifdef UNROLL_SEPARABLE_LOOPS
         for (;x < border - 16; x += 16) {
@@ -334,7 +331,7 @@ static int boxBlurInterp(const uint8_t* src, int src_y_stride, uint8_t* dst,
 #undef LEFT_BORDER_ITER
         for (int x = width; x < diameter; ++x) {
             *dptr = (outer_sum * outer_scale + inner_sum * inner_scale + half) >> 24;
-            dptr += dst_x_stride;
+            dptr += 1;
         }
         x = diameter;
 
@@ -342,7 +339,7 @@ static int boxBlurInterp(const uint8_t* src, int src_y_stride, uint8_t* dst,
             inner_sum = outer_sum - *left; \
             outer_sum += *right++; \
             *dptr = (outer_sum * outer_scale + inner_sum * inner_scale + half) >> 24; \
-            dptr += dst_x_stride; \
+            dptr += 1; \
             outer_sum -= *left++;
 
 #ifdef UNROLL_SEPARABLE_LOOPS
@@ -373,7 +370,7 @@ static int boxBlurInterp(const uint8_t* src, int src_y_stride, uint8_t* dst,
         #define RIGHT_BORDER_ITER \
             inner_sum = outer_sum - *left++; \
             *dptr = (outer_sum * outer_scale + inner_sum * inner_scale + half) >> 24; \
-            dptr += dst_x_stride; \
+            dptr += 1; \
             outer_sum = inner_sum;
 
         x = 0;
@@ -406,6 +403,191 @@ static int boxBlurInterp(const uint8_t* src, int src_y_stride, uint8_t* dst,
     return new_width;
 }
 
+/**
+ * The Y blurs work on rows rather than on a transposed copy: each output row is
+ * the previous row's running column sums, plus the row entering the kernel,
+ * minus the one leaving it.  That keeps every read and write contiguous, and
+ * lets us sum and scale many columns at once with SkNx.  The results match
+ * boxBlur() and boxBlurInterp() applied to the transposed image exactly.
+ *
+ * Rows outside the source read as zero.
+ */
+template <int N>
+static void box_step(const uint8_t* enter, const uint8_t* leave, uint32_t* sums, uint8_t* dst,
+                     uint32_t scale) {
+    typedef SkNi<N, uint32_t> SkNu;
+    SkNu sum = SkNu::Load(sums) + SkNu::FromBytes(enter) - SkNu::FromBytes(leave);
+    sum.store(sums);
+    ((sum * SkNu(scale) + SkNu(1 << 23)) >> 24).toBytes(dst);
+}
+
+template <int N>
+static void box_interp_step(const uint8_t* enter, const uint8_t* leave,
+                            const uint8_t* first, const uint8_t* last,
+                            uint32_t* sums, uint8_t* dst,
+                            uint32_t outer_scale, uint32_t inner_scale) {
+    typedef SkNi<N, uint32_t> SkNu;
+    const SkNu outer = SkNu::Load(sums) + SkNu::FromBytes(enter) - SkNu::FromBytes(leave);
+    const SkNu inner = outer - SkNu::FromBytes(first) - SkNu::FromBytes(last);
+    outer.store(sums);
+    ((outer * SkNu(outer_scale) + inner * SkNu(inner_scale) + SkNu(1 << 23)) >> 24).toBytes(dst);
+}
+
+// Returns row y of a 'height' tall image, or a row of zeros outside it.
+static const uint8_t* src_row(const uint8_t* src, int rowBytes, int y, int height,
+                              const uint8_t* zeros) {
+    return (y >= 0 && y < height) ? src + y * rowBytes : zeros;
+}
+
+/**
+ * Blurs columns [0, width) of src in Y, like boxBlur() does in X.  src and dst
+ * share rowBytes; dst must hold height + 2 * max(leftRadius, rightRadius) rows.
+ */
+static int boxBlurY(const uint8_t* src, int rowBytes, uint8_t* dst,
+                    int leftRadius, int rightRadius, int width, int height) {
+    const int diameter = leftRadius + rightRadius;
+    const uint32_t scale = (1 << 24) / (diameter + 1);
+    const int topPad = SkMax32(rightRadius - leftRadius, 0);
+    const int new_height = height + SkMax32(leftRadius, rightRadius) * 2;
+
+    SkAutoTMalloc<uint32_t> sums(width);
+    sk_bzero(sums.get(), width * sizeof(uint32_t));
+    SkAutoTMalloc<uint8_t> zeros(width);
+    sk_bzero(zeros.get(), width);
+
+    for (int y = 0; y < new_height; ++y) {
+        uint8_t* dptr = dst + y * rowBytes;
+        const int k = y - topPad;   // the last source row in the kernel
+        if (k < 0 || k >= height + diameter) {
+            sk_bzero(dptr, width);
+            continue;
+        }
+        const uint8_t* enter = src_row(src, rowBytes, k, height, zeros);
+        const uint8_t* leave = src_row(src, rowBytes, k - diameter - 1, height, zeros);
+        int x = 0;
+        for (; x + 4 <= width; x += 4) {
+            box_step<4>(enter + x, leave + x, sums + x, dptr + x, scale);
+        }
+        for (; x < width; ++x) {
+            box_step<1>(enter + x, leave + x, sums + x, dptr + x, scale);
+        }
+    }
+    return new_height;
+}
+
+/**
+ * Blurs columns [0, width) of src in Y, like boxBlurInterp() does in X.  src
+ * and dst share rowBytes; dst must hold height + 2 * radius rows.
+ */
+static int boxBlurInterpY(const uint8_t* src, int rowBytes, uint8_t* dst,
+                          int radius, int width, int height, uint8_t outer_weight) {
+    const int diameter = radius * 2;
+    const int kernelSize = diameter + 1;
+    int inner_weight = 255 - outer_weight;
+    outer_weight += outer_weight >> 7;
+    inner_weight += inner_weight >> 7;
+    const uint32_t outer_scale = (outer_weight << 16) / kernelSize;
+    const uint32_t inner_scale = (inner_weight << 16) / (kernelSize - 2);
+    const int new_height = height + diameter;
+
+    SkAutoTMalloc<uint32_t> sums(width);
+    sk_bzero(sums.get(), width * sizeof(uint32_t));
+    SkAutoTMalloc<uint8_t> zeros(width);
+    sk_bzero(zeros.get(), width);
+
+    for (int k = 0; k < new_height; ++k) {
+        uint8_t* dptr = dst + k * rowBytes;
+        // The outer sum covers rows [k - diameter, k], the inner one [k - diameter + 1, k - 1].
+        const uint8_t* enter = src_row(src, rowBytes, k, height, zeros);
+        const uint8_t* leave = src_row(src, rowBytes, k - diameter - 1, height, zeros);
+        const uint8_t* first = src_row(src, rowBytes, k - diameter, height, zeros);
+        const uint8_t* last = enter;
+        if (height < diameter && k >= height && k < diameter) {
+            // boxBlurInterp() leaves the last source pixel out of the inner sum while the
+            // kernel is wider than the whole image, so we do too.
+            last = src_row(src, rowBytes, height - 1, height, zeros);
+        }
+        int x = 0;
+        for (; x + 4 <= width; x += 4) {
+            box_interp_step<4>(enter + x, leave + x, first + x, last + x, sums + x, dptr + x,
+                               outer_scale, inner_scale);
+        }
+        for (; x < width; ++x) {
+            box_interp_step<1>(enter + x, leave + x, first + x, last + x, sums + x, dptr + x,
+                               outer_scale, inner_scale);
+        }
+    }
+    return new_height;
+}
+
+// Masks with fewer pixels than this are blurred as a single band.
+static const int kMinPixelsPerBand = 64 * 1024;
+// Bands narrower or shorter than this waste more time on setup than they save.
+static const int kMinBandSize = 32;
+static const int kMaxBands = 16;
+
+/**
+ * How many bands to split a width x height blur into, so they can run on
+ * SkTaskGroup threads.  Without an SkTaskGroup::Enabler the bands run one
+ * after another, which costs next to nothing for masks this big.
+ */
+static int band_count(int width, int height) {
+    int bands = (int)SkTMin<int64_t>(sk_64_mul(width, height) / kMinPixelsPerBand, kMaxBands);
+    bands = SkTMin(bands, SkTMin(width, height) / kMinBandSize);
+    return SkTMax(bands, 1);
+}
+
+// Calls fn(start, stop) for 'bands' slices of [0, count), in parallel.
+template <typename Fn>
+static void for_each_band(int count, int bands, const Fn& fn) {
+    if (bands <= 1) {
+        fn(0, count);
+        return;
+    }
+    sk_parallel_for(bands, 1, [&](int i) {
+        fn(count * i / bands, count * (i + 1) / bands);
+    });
+}
+
+// The X blurs: each band is a run of rows.
+static int box_blur_x(const uint8_t* src, int srcRB, uint8_t* dst,
+                      int leftRadius, int rightRadius, int width, int height, int bands) {
+    const int new_width = width + SkMax32(leftRadius, rightRadius) * 2;
+    for_each_band(height, bands, [&](int start, int stop) {
+        boxBlur(src + start * srcRB, srcRB, dst + start * new_width,
+                leftRadius, rightRadius, width, stop - start);
+    });
+    return new_width;
+}
+
+static int box_blur_interp_x(const uint8_t* src, int srcRB, uint8_t* dst,
+                             int radius, int width, int height, uint8_t outerWeight, int bands) {
+    const int new_width = width + radius * 2;
+    for_each_band(height, bands, [&](int start, int stop) {
+        boxBlurInterp(src + start * srcRB, srcRB, dst + start * new_width,
+                      radius, width, stop - start, outerWeight);
+    });
+    return new_width;
+}
+
+// The Y blurs: each band is a run of columns.
+static int box_blur_y(const uint8_t* src, uint8_t* dst, int leftRadius, int rightRadius,
+                      int width, int height, int bands) {
+    for_each_band(width, bands, [&](int start, int stop) {
+        boxBlurY(src + start, width, dst + start, leftRadius, rightRadius, stop - start, height);
+    });
+    return height + SkMax32(leftRadius, rightRadius) * 2;
+}
+
+static int box_blur_interp_y(const uint8_t* src, uint8_t* dst, int radius,
+                             int width, int height, uint8_t outerWeight, int bands) {
+    for_each_band(width, bands, [&](int start, int stop) {
+        boxBlurInterpY(src + start, width, dst + start, radius, stop - start, height,
+                       outerWeight);
+    });
+    return height + radius * 2;
+}
+
 static void get_adjusted_radii(SkScalar passRadius, int *loRadius, int *hiRadius)
 {
     *loRadius = *hiRadius = SkScalarCeilToInt(passRadius);
@@ -549,35 +731,37 @@ bool SkBlurMask::BoxBlur(SkMask* dst, const SkMask& src,
         uint8_t*                tp = tmpBuffer.get();
         int w = sw, h = sh;
 
+        // The final size decides the bands for every pass, so they line up.
+        const int bands = band_count(sw + 2 * padx, sh + 2 * pady);
         if (outerWeight == 255) {
             int loRadius, hiRadius;
             get_adjusted_radii(passRadius, &loRadius, &hiRadius);
             if (kHigh_SkBlurQuality == quality) {
-                // Do three X blurs, with a transpose on the final one.
-                w = boxBlur(sp, src.fRowBytes, tp, loRadius, hiRadius, w, h, false);
-                w = boxBlur(tp, w,             dp, hiRadius, loRadius, w, h, false);
-                w = boxBlur(dp, w,             tp, hiRadius, hiRadius, w, h, true);
-                // Do three Y blurs, with a transpose on the final one.
-                h = boxBlur(tp, h,             dp, loRadius, hiRadius, h, w, false);
-                h = boxBlur(dp, h,             tp, hiRadius, loRadius, h, w, false);
-                h = boxBlur(tp, h,             dp, hiRadius, hiRadius, h, w, true);
+                // Do three X blurs.
+                w = box_blur_x(sp, src.fRowBytes, tp, loRadius, hiRadius, w, h, bands);
+                w = box_blur_x(tp, w,             dp, hiRadius, loRadius, w, h, bands);
+                w = box_blur_x(dp, w,             tp, hiRadius, hiRadius, w, h, bands);
+                // Do three Y blurs.
+                h = box_blur_y(tp, dp, loRadius, hiRadius, w, h, bands);
+                h = box_blur_y(dp, tp, hiRadius, loRadius, w, h, bands);
+                h = box_blur_y(tp, dp, hiRadius, hiRadius, w, h, bands);
             } else {
-                w = boxBlur(sp, src.fRowBytes, tp, rx, rx, w, h, true);
-                h = boxBlur(tp, h,             dp, ry, ry, h, w, true);
+                w = box_blur_x(sp, src.fRowBytes, tp, rx, rx, w, h, bands);
+                h = box_blur_y(tp, dp, ry, ry, w, h, bands);
             }
         } else {
             if (kHigh_SkBlurQuality == quality) {
-                // Do three X blurs, with a transpose on the final one.
-                w = boxBlurInterp(sp, src.fRowBytes, tp, rx, w, h, false, outerWeight);
-                w = boxBlurInterp(tp, w,             dp, rx, w, h, false, outerWeight);
-                w = boxBlurInterp(dp, w,             tp, rx, w, h, true, outerWeight);
-                // Do three Y blurs, with a transpose on the final one.
-                h = boxBlurInterp(tp, h,             dp, ry, h, w, false, outerWeight);
-                h = boxBlurInterp(dp, h,             tp, ry, h, w, false, outerWeight);
-                h = boxBlurInterp(tp, h,             dp, ry, h, w, true, outerWeight);
+                // Do three X blurs.
+                w = box_blur_interp_x(sp, src.fRowBytes, tp, rx, w, h, outerWeight, bands);
+                w = box_blur_interp_x(tp, w,             dp, rx, w, h, outerWeight, bands);
+                w = box_blur_interp_x(dp, w,             tp, rx, w, h, outerWeight, bands);
+                // Do three Y blurs.
+                h = box_blur_interp_y(tp, dp, ry, w, h, outerWeight, bands);
+                h = box_blur_interp_y(dp, tp, ry, w, h, outerWeight, bands);
+                h = box_blur_interp_y(tp, dp, ry, w, h, outerWeight, bands);
             } else {
-                w = boxBlurInterp(sp, src.fRowBytes, tp, rx, w, h, true, outerWeight);
-                h = boxBlurInterp(tp, h,             dp, ry, h, w, true, outerWeight);
+                w = box_blur_interp_x(sp, src.fRowBytes, tp, rx, w, h, outerWeight, bands);
+                h = box_blur_interp_y(tp, dp, ry, w, h, outerWeight, bands);
             }
         }
 
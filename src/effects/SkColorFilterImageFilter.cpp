@@ -61,7 +61,8 @@ bool SkColorFilterImageFilter::onFilterImage(Proxy* proxy, const SkBitmap& sourc
                                              SkIPoint* offset) const {
     SkBitmap src = source;
     SkIPoint srcOffset = SkIPoint::Make(0, 0);
-    if (getInput(0) && !getInput(0)->filterImage(proxy, source, ctx, &src, &srcOffset)) {
+    if (getInput(0) &&
+        !getInput(0)->filterImage(proxy, source, this->mapContext(ctx), &src, &srcOffset)) {
         return false;
     }
 
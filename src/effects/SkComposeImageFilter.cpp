@@ -30,15 +30,29 @@ bool SkComposeImageFilter::onFilterImage(Proxy* proxy,
     SkImageFilter* outer = getInput(0);
     SkImageFilter* inner = getInput(1);
 
+    // When the DAG can be asked for part of its result, the inner filter only needs to produce
+    // what the outer one reads within the clip.
+    const bool unclipped = ctx.clipBounds() == SkIRect::MakeLargest() ||
+                           !this->canFilterPartially();
+    SkIRect innerClip = ctx.clipBounds();
+    if (!unclipped && !outer->filterBounds(ctx.clipBounds(), ctx.ctm(), &innerClip)) {
+        innerClip = ctx.clipBounds();
+    }
+    Context innerContext(ctx.ctm(), innerClip, ctx.cache());
+
     SkBitmap tmp;
     SkIPoint innerOffset = SkIPoint::Make(0, 0);
     SkIPoint outerOffset = SkIPoint::Make(0, 0);
-    if (!inner->filterImage(proxy, src, ctx, &tmp, &innerOffset))
+    if (!inner->filterImage(proxy, src, innerContext, &tmp, &innerOffset))
         return false;
 
     SkMatrix outerMatrix(ctx.ctm());
     outerMatrix.postTranslate(SkIntToScalar(-innerOffset.x()), SkIntToScalar(-innerOffset.y()));
-    Context outerContext(outerMatrix, ctx.clipBounds(), ctx.cache());
+    SkIRect outerClip = ctx.clipBounds();
+    if (!unclipped) {
+        outerClip.offset(-innerOffset);
+    }
+    Context outerContext(outerMatrix, outerClip, ctx.cache());
     if (!outer->filterImage(proxy, tmp, outerContext, result, &outerOffset)) {
         return false;
     }
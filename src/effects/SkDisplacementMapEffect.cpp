@@ -211,12 +211,18 @@ bool SkDisplacementMapEffect::onFilterImage(Proxy* proxy,
                                             const Context& ctx,
                                             SkBitmap* dst,
                                             SkIPoint* offset) const {
-    SkBitmap displ = src, color = src;
-    const SkImageFilter* colorInput = getColorInput();
-    const SkImageFilter* displInput = getDisplacementInput();
-    SkIPoint colorOffset = SkIPoint::Make(0, 0), displOffset = SkIPoint::Make(0, 0);
-    if ((colorInput && !colorInput->filterImage(proxy, src, ctx, &color, &colorOffset)) ||
-        (displInput && !displInput->filterImage(proxy, src, ctx, &displ, &displOffset))) {
+    // Color lookups are clipped to the bounds computed here, so they must cover every pixel a
+    // displacement inside the clip can reach.
+    const Context displCtx = this->mapContext(ctx);
+    SkBitmap inputs[2];
+    SkIPoint inputOffsets[2];
+    if (!this->filterInputs(2, proxy, src, ctx, inputs, inputOffsets)) {
+        return false;
+    }
+    SkBitmap& displ = inputs[0];
+    SkBitmap& color = inputs[1];
+    SkIPoint displOffset = inputOffsets[0], colorOffset = inputOffsets[1];
+    if (displ.isNull() || color.isNull()) {
         return false;
     }
     if ((displ.colorType() != kN32_SkColorType) ||
@@ -226,11 +232,11 @@ bool SkDisplacementMapEffect::onFilterImage(Proxy* proxy,
     SkIRect bounds;
     // Since computeDisplacement does bounds checking on color pixel access, we don't need to pad
     // the color bitmap to bounds here.
-    if (!this->applyCropRect(ctx, color, colorOffset, &bounds)) {
+    if (!this->applyCropRect(displCtx, color, colorOffset, &bounds)) {
         return false;
     }
     SkIRect displBounds;
-    if (!this->applyCropRect(ctx, proxy, displ, &displOffset, &displBounds, &displ)) {
+    if (!this->applyCropRect(displCtx, proxy, displ, &displOffset, &displBounds, &displ)) {
         return false;
     }
     if (!bounds.intersect(displBounds)) {
@@ -267,13 +273,19 @@ void SkDisplacementMapEffect::computeFastBounds(const SkRect& src, SkRect* dst)
     dst->outset(fScale * SK_ScalarHalf, fScale * SK_ScalarHalf);
 }
 
-bool SkDisplacementMapEffect::onFilterBounds(const SkIRect& src, const SkMatrix& ctm,
-                                   SkIRect* dst) const {
-    SkIRect bounds = src;
+void SkDisplacementMapEffect::onFilterNodeBounds(const SkIRect& src, const SkMatrix& ctm,
+                                                 SkIRect* dst) const {
+    *dst = src;
     SkVector scale = SkVector::Make(fScale, fScale);
     ctm.mapVectors(&scale, 1);
-    bounds.outset(SkScalarCeilToInt(scale.fX * SK_ScalarHalf),
-                  SkScalarCeilToInt(scale.fY * SK_ScalarHalf));
+    dst->outset(SkScalarCeilToInt(scale.fX * SK_ScalarHalf),
+                SkScalarCeilToInt(scale.fY * SK_ScalarHalf));
+}
+
+bool SkDisplacementMapEffect::onFilterBounds(const SkIRect& src, const SkMatrix& ctm,
+                                   SkIRect* dst) const {
+    SkIRect bounds;
+    this->onFilterNodeBounds(src, ctm, &bounds);
     if (getColorInput()) {
         return getColorInput()->filterBounds(bounds, ctm, dst);
     }
@@ -392,27 +404,28 @@ private:
 
 bool SkDisplacementMapEffect::filterImageGPU(Proxy* proxy, const SkBitmap& src, const Context& ctx,
                                              SkBitmap* result, SkIPoint* offset) const {
+    const Context displCtx = this->mapContext(ctx);
     SkBitmap colorBM = src;
     SkIPoint colorOffset = SkIPoint::Make(0, 0);
-    if (getColorInput() && !getColorInput()->getInputResultGPU(proxy, src, ctx, &colorBM,
+    if (getColorInput() && !getColorInput()->getInputResultGPU(proxy, src, displCtx, &colorBM,
                                                                &colorOffset)) {
         return false;
     }
     SkBitmap displacementBM = src;
     SkIPoint displacementOffset = SkIPoint::Make(0, 0);
     if (getDisplacementInput() &&
-        !getDisplacementInput()->getInputResultGPU(proxy, src, ctx, &displacementBM,
+        !getDisplacementInput()->getInputResultGPU(proxy, src, displCtx, &displacementBM,
                                                    &displacementOffset)) {
         return false;
     }
     SkIRect bounds;
     // Since GrDisplacementMapEffect does bounds checking on color pixel access, we don't need to
     // pad the color bitmap to bounds here.
-    if (!this->applyCropRect(ctx, colorBM, colorOffset, &bounds)) {
+    if (!this->applyCropRect(displCtx, colorBM, colorOffset, &bounds)) {
         return false;
     }
     SkIRect displBounds;
-    if (!this->applyCropRect(ctx, proxy, displacementBM,
+    if (!this->applyCropRect(displCtx, proxy, displacementBM,
                              &displacementOffset, &displBounds, &displacementBM)) {
         return false;
     }
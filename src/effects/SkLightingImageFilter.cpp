@@ -299,6 +299,14 @@ protected:
                                   const CropRect* cropRect)
       : INHERITED(light, surfaceScale, input, cropRect) {}
 
+    // The surface normal at each pixel comes from its 3x3 neighborhood, and pixels on the edge
+    // of the bounds use one-sided kernels, so light one pixel beyond the clip on every side.
+    void onFilterNodeBounds(const SkIRect& src, const SkMatrix&, SkIRect* dst) const override {
+        *dst = src;
+        dst->outset(1, 1);
+    }
+    bool onCanFilterPartially() const override { return true; }
+
 #if SK_SUPPORT_GPU
     bool canFilterImageGPU() const override { return true; }
     bool filterImageGPU(Proxy*, const SkBitmap& src, const Context&,
@@ -346,12 +354,13 @@ bool SkLightingImageFilterInternal::filterImageGPU(Proxy* proxy,
                                                    SkIPoint* offset) const {
     SkBitmap input = src;
     SkIPoint srcOffset = SkIPoint::Make(0, 0);
+    const Context lightingCtx = this->mapContext(ctx);
     if (this->getInput(0) &&
-        !this->getInput(0)->getInputResultGPU(proxy, src, ctx, &input, &srcOffset)) {
+        !this->getInput(0)->getInputResultGPU(proxy, src, lightingCtx, &input, &srcOffset)) {
         return false;
     }
     SkIRect bounds;
-    if (!this->applyCropRect(ctx, proxy, input, &srcOffset, &bounds, &input)) {
+    if (!this->applyCropRect(lightingCtx, proxy, input, &srcOffset, &bounds, &input)) {
         return false;
     }
     SkRect dstRect = SkRect::MakeWH(SkIntToScalar(bounds.width()),
@@ -1144,7 +1153,8 @@ bool SkDiffuseLightingImageFilter::onFilterImage(Proxy* proxy,
     SkImageFilter* input = getInput(0);
     SkBitmap src = source;
     SkIPoint srcOffset = SkIPoint::Make(0, 0);
-    if (input && !input->filterImage(proxy, source, ctx, &src, &srcOffset)) {
+    const Context lightingCtx = this->mapContext(ctx);
+    if (input && !input->filterImage(proxy, source, lightingCtx, &src, &srcOffset)) {
         return false;
     }
 
@@ -1152,7 +1162,7 @@ bool SkDiffuseLightingImageFilter::onFilterImage(Proxy* proxy,
         return false;
     }
     SkIRect bounds;
-    if (!this->applyCropRect(ctx, proxy, src, &srcOffset, &bounds, &src)) {
+    if (!this->applyCropRect(lightingCtx, proxy, src, &srcOffset, &bounds, &src)) {
         return false;
     }
 
@@ -1169,7 +1179,11 @@ bool SkDiffuseLightingImageFilter::onFilterImage(Proxy* proxy,
         return false;
     }
 
-    SkAutoTUnref<SkLight> transformedLight(light()->transform(ctx.ctm()));
+    // lightBitmap() works in the coordinates of src, which no longer starts at the origin once
+    // the input is only evaluated where it is needed.
+    SkMatrix lightMatrix(ctx.ctm());
+    lightMatrix.postTranslate(SkIntToScalar(-srcOffset.x()), SkIntToScalar(-srcOffset.y()));
+    SkAutoTUnref<SkLight> transformedLight(light()->transform(lightMatrix));
 
     DiffuseLightingType lightingType(fKD);
     offset->fX = bounds.left();
@@ -1279,7 +1293,8 @@ bool SkSpecularLightingImageFilter::onFilterImage(Proxy* proxy,
     SkImageFilter* input = getInput(0);
     SkBitmap src = source;
     SkIPoint srcOffset = SkIPoint::Make(0, 0);
-    if (input && !input->filterImage(proxy, source, ctx, &src, &srcOffset)) {
+    const Context lightingCtx = this->mapContext(ctx);
+    if (input && !input->filterImage(proxy, source, lightingCtx, &src, &srcOffset)) {
         return false;
     }
 
@@ -1288,7 +1303,7 @@ bool SkSpecularLightingImageFilter::onFilterImage(Proxy* proxy,
     }
 
     SkIRect bounds;
-    if (!this->applyCropRect(ctx, proxy, src, &srcOffset, &bounds, &src)) {
+    if (!this->applyCropRect(lightingCtx, proxy, src, &srcOffset, &bounds, &src)) {
         return false;
     }
 
@@ -1309,7 +1324,11 @@ bool SkSpecularLightingImageFilter::onFilterImage(Proxy* proxy,
     offset->fX = bounds.left();
     offset->fY = bounds.top();
     bounds.offset(-srcOffset);
-    SkAutoTUnref<SkLight> transformedLight(light()->transform(ctx.ctm()));
+    // lightBitmap() works in the coordinates of src, which no longer starts at the origin once
+    // the input is only evaluated where it is needed.
+    SkMatrix lightMatrix(ctx.ctm());
+    lightMatrix.postTranslate(SkIntToScalar(-srcOffset.x()), SkIntToScalar(-srcOffset.y()));
+    SkAutoTUnref<SkLight> transformedLight(light()->transform(lightMatrix));
     switch (transformedLight->type()) {
         case SkLight::kDistant_LightType:
             lightBitmap<SpecularLightingType, SkDistantLight>(lightingType,
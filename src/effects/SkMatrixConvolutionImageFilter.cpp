@@ -269,7 +269,9 @@ bool SkMatrixConvolutionImageFilter::onFilterImage(Proxy* proxy,
                                                    SkIPoint* offset) const {
     SkBitmap src = source;
     SkIPoint srcOffset = SkIPoint::Make(0, 0);
-    if (getInput(0) && !getInput(0)->filterImage(proxy, source, ctx, &src, &srcOffset)) {
+    // Border pixels are tiled relative to the bounds, so convolve the clip plus the kernel.
+    const Context convolveCtx = this->mapContext(ctx);
+    if (getInput(0) && !getInput(0)->filterImage(proxy, source, convolveCtx, &src, &srcOffset)) {
         return false;
     }
 
@@ -278,7 +280,7 @@ bool SkMatrixConvolutionImageFilter::onFilterImage(Proxy* proxy,
     }
 
     SkIRect bounds;
-    if (!this->applyCropRect(ctx, proxy, src, &srcOffset, &bounds, &src)) {
+    if (!this->applyCropRect(convolveCtx, proxy, src, &srcOffset, &bounds, &src)) {
         return false;
     }
 
@@ -330,6 +332,19 @@ bool SkMatrixConvolutionImageFilter::onFilterBounds(const SkIRect& src, const Sk
     return true;
 }
 
+void SkMatrixConvolutionImageFilter::onFilterNodeBounds(const SkIRect& src, const SkMatrix&,
+                                                        SkIRect* dst) const {
+    if (kRepeat_TileMode == fTileMode) {
+        // Border pixels wrap around to the far side of the input, wherever that is.
+        *dst = SkIRect::MakeLargest();
+        return;
+    }
+    *dst = src;
+    dst->fRight += fKernelSize.width() - 1;
+    dst->fBottom += fKernelSize.height() - 1;
+    dst->offset(-fKernelOffset);
+}
+
 #if SK_SUPPORT_GPU
 
 static GrTextureDomain::Mode convert_tilemodes(
@@ -78,18 +78,15 @@ bool SkMergeImageFilter::onFilterImage(Proxy* proxy, const SkBitmap& src,
     SkPaint paint;
 
     int inputCount = countInputs();
+    SkAutoSTArray<4, SkBitmap> inputs(inputCount);
+    SkAutoSTArray<4, SkIPoint> offsets(inputCount);
+    if (!this->filterInputs(inputCount, proxy, src, ctx, inputs.get(), offsets.get())) {
+        return false;
+    }
     for (int i = 0; i < inputCount; ++i) {
-        SkBitmap tmp;
-        const SkBitmap* srcPtr;
-        SkIPoint pos = SkIPoint::Make(0, 0);
-        SkImageFilter* filter = getInput(i);
-        if (filter) {
-            if (!filter->filterImage(proxy, src, ctx, &tmp, &pos)) {
-                return false;
-            }
-            srcPtr = &tmp;
-        } else {
-            srcPtr = &src;
+        // An input cropped out of the clip has nothing to contribute; it just drops out.
+        if (inputs[i].isNull()) {
+            continue;
         }
 
         if (fModes) {
@@ -97,7 +94,7 @@ bool SkMergeImageFilter::onFilterImage(Proxy* proxy, const SkBitmap& src,
         } else {
             paint.setXfermode(NULL);
         }
-        canvas.drawSprite(*srcPtr, pos.x() - x0, pos.y() - y0, &paint);
+        canvas.drawSprite(inputs[i], offsets[i].x() - x0, offsets[i].y() - y0, &paint);
     }
 
     offset->fX = bounds.left();
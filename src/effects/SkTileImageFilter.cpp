@@ -30,7 +30,7 @@ bool SkTileImageFilter::onFilterImage(Proxy* proxy, const SkBitmap& src,
     SkBitmap source = src;
     SkImageFilter* input = getInput(0);
     SkIPoint srcOffset = SkIPoint::Make(0, 0);
-    if (input && !input->filterImage(proxy, src, ctx, &source, &srcOffset)) {
+    if (input && !input->filterImage(proxy, src, this->mapContext(ctx), &source, &srcOffset)) {
         return false;
     }
 
@@ -93,6 +93,14 @@ bool SkTileImageFilter::onFilterBounds(const SkIRect& src, const SkMatrix& ctm,
     return true;
 }
 
+void SkTileImageFilter::onFilterNodeBounds(const SkIRect&, const SkMatrix& ctm,
+                                           SkIRect* dst) const {
+    // Every tile comes from the same source rect, wherever the clip is.
+    SkRect srcRect;
+    ctm.mapRect(&srcRect, fSrcRect);
+    srcRect.roundOut(dst);
+}
+
 SkFlattenable* SkTileImageFilter::CreateProc(SkReadBuffer& buffer) {
     SK_IMAGEFILTER_UNFLATTEN_COMMON(common, 1);
     SkRect src, dst;
@@ -47,19 +47,13 @@ bool SkXfermodeImageFilter::onFilterImage(Proxy* proxy,
                                             const Context& ctx,
                                             SkBitmap* dst,
                                             SkIPoint* offset) const {
-    SkBitmap background = src, foreground = src;
-    SkImageFilter* backgroundInput = getInput(0);
-    SkImageFilter* foregroundInput = getInput(1);
-    SkIPoint backgroundOffset = SkIPoint::Make(0, 0);
-    if (backgroundInput &&
-        !backgroundInput->filterImage(proxy, src, ctx, &background, &backgroundOffset)) {
-        background.reset();
-    }
-    SkIPoint foregroundOffset = SkIPoint::Make(0, 0);
-    if (foregroundInput &&
-        !foregroundInput->filterImage(proxy, src, ctx, &foreground, &foregroundOffset)) {
-        foreground.reset();
-    }
+    SkBitmap inputs[2];
+    SkIPoint offsets[2];
+    // An input that fails is drawn as transparent black, so failures are not fatal here.
+    (void)this->filterInputs(2, proxy, src, ctx, inputs, offsets);
+    SkBitmap& background = inputs[0];
+    SkBitmap& foreground = inputs[1];
+    SkIPoint backgroundOffset = offsets[0], foregroundOffset = offsets[1];
 
     SkIRect bounds, foregroundBounds;
     if (!applyCropRect(ctx, foreground, foregroundOffset, &foregroundBounds)) {
@@ -121,7 +115,8 @@ bool SkXfermodeImageFilter::filterImageGPU(Proxy* proxy,
                                            SkIPoint* offset) const {
     SkBitmap background = src;
     SkIPoint backgroundOffset = SkIPoint::Make(0, 0);
-    if (getInput(0) && !getInput(0)->getInputResultGPU(proxy, src, ctx, &background,
+    const Context inputCtx = this->mapContext(ctx);
+    if (getInput(0) && !getInput(0)->getInputResultGPU(proxy, src, inputCtx, &background,
                                                        &backgroundOffset)) {
         return onFilterImage(proxy, src, ctx, result, offset);
     }
@@ -134,7 +129,7 @@ bool SkXfermodeImageFilter::filterImageGPU(Proxy* proxy,
 
     SkBitmap foreground = src;
     SkIPoint foregroundOffset = SkIPoint::Make(0, 0);
-    if (getInput(1) && !getInput(1)->getInputResultGPU(proxy, src, ctx, &foreground,
+    if (getInput(1) && !getInput(1)->getInputResultGPU(proxy, src, inputCtx, &foreground,
                                                        &foregroundOffset)) {
         return onFilterImage(proxy, src, ctx, result, offset);
     }
@@ -9,12 +9,16 @@
 #include "SkImageEncoder.h"
 #include "SkColor.h"
 #include "SkColorPriv.h"
+#include "SkData.h"
 #include "SkDither.h"
 #include "SkMath.h"
+#include "SkPNGImageEncoder.h"
 #include "SkRTConf.h"
 #include "SkScaledBitmapSampler.h"
 #include "SkStream.h"
+#include "SkTaskGroup.h"
 #include "SkTemplates.h"
+#include "SkTransformScanline_opts.h"
 #include "SkUtils.h"
 #include "transform_scanline.h"
 
@@ -24,6 +28,12 @@
 #endif
 #include "png.h"
 
+#ifdef ZLIB_INCLUDE
+    #include ZLIB_INCLUDE
+#else
+    #include "zlib.h"
+#endif
+
 /* These were dropped in libpng >= 1.4 */
 #ifndef png_infopp_NULL
 #define png_infopp_NULL NULL
@@ -1001,6 +1011,19 @@ static void sk_write_fn(png_structp png_ptr, png_bytep data, png_size_t len) {
     }
 }
 
+// Swaps in a SIMD version of the transform, if this CPU has one.
+static transform_scanline_proc choose_platform_proc(transform_scanline_proc proc) {
+    SkTransformScanlineProc platformProc = NULL;
+    if (transform_scanline_888 == proc) {
+        platformProc = SkTransformScanlineGetPlatformProc(
+                kN32_To_RGB_SkTransformScanlineProcType);
+    } else if (transform_scanline_8888 == proc) {
+        platformProc = SkTransformScanlineGetPlatformProc(
+                kN32_To_RGBA_Unpremul_SkTransformScanlineProcType);
+    }
+    return platformProc ? platformProc : proc;
+}
+
 static transform_scanline_proc choose_proc(SkColorType ct, bool hasAlpha) {
     // we don't care about search on alpha if we're kIndex8, since only the
     // colortable packing cares about that distinction, not the pixels
@@ -1023,7 +1046,7 @@ static transform_scanline_proc choose_proc(SkColorType ct, bool hasAlpha) {
 
     for (int i = SK_ARRAY_COUNT(gMap) - 1; i >= 0; --i) {
         if (gMap[i].fColorType == ct && gMap[i].fHasAlpha == hasAlpha) {
-            return gMap[i].fProc;
+            return choose_platform_proc(gMap[i].fProc);
         }
     }
     sk_throw();
@@ -1102,18 +1125,260 @@ static inline int pack_palette(SkColorTable* ctable,
     return num_trans;
 }
 
-class SkPNGImageEncoder : public SkImageEncoder {
-protected:
-    bool onEncode(SkWStream* stream, const SkBitmap& bm, int quality) override;
-private:
-    bool doEncode(SkWStream* stream, const SkBitmap& bm,
-                  const bool& hasAlpha, int colorType,
-                  int bitDepth, SkColorType ct,
-                  png_color_8& sig_bit);
+///////////////////////////////////////////////////////////////////////////////
+
+/*  Rather than hand rows to png_write_rows(), the encoder filters and deflates
+    them itself. That lets it split the image into bands of rows that are
+    deflated independently, in parallel, and then joined into the single zlib
+    stream the IDAT chunks carry, the way pigz does for gzip: every band but
+    the last ends with a sync flush, so each starts on a byte boundary, and the
+    bands' adler32s are combined for the stream's trailer.
+*/
+
+// PNG row filter types, as written in the first byte of each filtered row.
+enum {
+    kNone_PngFilter,
+    kSub_PngFilter,
+    kUp_PngFilter,
+    kAvg_PngFilter,
+    kPaeth_PngFilter,
+
+    kPngFilterCount
+};
+
+static inline int paeth_predictor(int a, int b, int c) {
+    const int pa = SkAbs32(b - c),
+              pb = SkAbs32(a - c),
+              pc = SkAbs32(a + b - 2*c);
+    if (pa <= pb && pa <= pc) {
+        return a;
+    }
+    return pb <= pc ? b : c;
+}
+
+// Writes the filter type and then 'row' filtered against 'prior', the unfiltered row above
+// it (zeros for the first row), to 'dst'.
+static void filter_row(int filter, const uint8_t* SK_RESTRICT row,
+                       const uint8_t* SK_RESTRICT prior, size_t rowBytes, int bpp,
+                       uint8_t* SK_RESTRICT dst) {
+    *dst++ = filter;
+    size_t i = 0;
+    switch (filter) {
+        case kNone_PngFilter:
+            memcpy(dst, row, rowBytes);
+            break;
+        case kSub_PngFilter:
+            for (; i < (size_t)bpp; i++) {
+                dst[i] = row[i];
+            }
+            for (; i < rowBytes; i++) {
+                dst[i] = row[i] - row[i - bpp];
+            }
+            break;
+        case kUp_PngFilter:
+            for (; i < rowBytes; i++) {
+                dst[i] = row[i] - prior[i];
+            }
+            break;
+        case kAvg_PngFilter:
+            for (; i < (size_t)bpp; i++) {
+                dst[i] = row[i] - (prior[i] >> 1);
+            }
+            for (; i < rowBytes; i++) {
+                dst[i] = row[i] - ((row[i - bpp] + prior[i]) >> 1);
+            }
+            break;
+        case kPaeth_PngFilter:
+            for (; i < (size_t)bpp; i++) {
+                dst[i] = row[i] - prior[i];
+            }
+            for (; i < rowBytes; i++) {
+                dst[i] = row[i] - paeth_predictor(row[i - bpp], prior[i], prior[i - bpp]);
+            }
+            break;
+        default:
+            SkASSERT(false);
+    }
+}
+
+// libpng's heuristic for picking a filter: the sum of the filtered bytes as signed values.
+static uint32_t filtered_row_cost(const uint8_t* SK_RESTRICT filtered, size_t rowBytes) {
+    uint32_t sum = 0;
+    for (size_t i = 0; i < rowBytes; i++) {
+        const unsigned v = filtered[i];
+        sum += v < 128 ? v : 256 - v;
+    }
+    return sum;
+}
+
+static int zlib_strategy(SkPNGImageEncoder::Options::Strategy strategy) {
+    switch (strategy) {
+        case SkPNGImageEncoder::Options::kFiltered_Strategy:    return Z_FILTERED;
+        case SkPNGImageEncoder::Options::kHuffmanOnly_Strategy: return Z_HUFFMAN_ONLY;
+        case SkPNGImageEncoder::Options::kRLE_Strategy:         return Z_RLE;
+        default:                                                 return Z_DEFAULT_STRATEGY;
+    }
+}
+
+// Runs deflate() until it has nothing more to write for this flush mode.
+static bool deflate_to_stream(z_stream* zstream, int flush, SkWStream* dst) {
+    uint8_t buffer[4096];
+    do {
+        zstream->next_out = buffer;
+        zstream->avail_out = sizeof(buffer);
+        if (Z_STREAM_ERROR == deflate(zstream, flush)) {
+            return false;
+        }
+        if (!dst->write(buffer, sizeof(buffer) - zstream->avail_out)) {
+            return false;
+        }
+    } while (0 == zstream->avail_out);
+    return true;
+}
 
-    typedef SkImageEncoder INHERITED;
+struct PngBand {
+    int                     fStartY;
+    int                     fStopY;
+    SkDynamicMemoryWStream  fDeflated;
+    uLong                   fAdler;
+    uLong                   fLength;
+    bool                    fSuccess;
 };
 
+static bool encode_band(const SkBitmap& bitmap, transform_scanline_proc proc, int bpp,
+                        unsigned filterFlags, int zlibLevel, int strategy, bool isLastBand,
+                        PngBand* band) {
+    z_stream zstream;
+    memset(&zstream, 0, sizeof(zstream));
+    // Negative window bits make a raw deflate stream; write_image_data() adds the zlib header
+    // and trailer around the bands.
+    if (Z_OK != deflateInit2(&zstream, zlibLevel, Z_DEFLATED, -MAX_WBITS, 8, strategy)) {
+        return false;
+    }
+    SkAutoTCallIProc<z_stream, deflateEnd> autoEnd(&zstream);
+
+    const size_t rowBytes = bitmap.width() * bpp;
+    const size_t filteredBytes = rowBytes + 1;
+    SkAutoTMalloc<uint8_t> storage(2 * rowBytes + kPngFilterCount * filteredBytes);
+    uint8_t* prior = storage.get();
+    uint8_t* row = prior + rowBytes;
+    uint8_t* filtered = row + rowBytes;
+
+    if (band->fStartY > 0) {
+        proc((const char*)bitmap.getAddr(0, band->fStartY - 1), bitmap.width(), (char*)prior);
+    } else {
+        memset(prior, 0, rowBytes);
+    }
+
+    band->fAdler = adler32(0L, Z_NULL, 0);
+    band->fLength = 0;
+    for (int y = band->fStartY; y < band->fStopY; y++) {
+        proc((const char*)bitmap.getAddr(0, y), bitmap.width(), (char*)row);
+
+        uint8_t* best = NULL;
+        uint32_t bestCost = SK_MaxU32;
+        for (int filter = 0; filter < kPngFilterCount; filter++) {
+            if (0 == (filterFlags & (SkPNGImageEncoder::Options::kNone_FilterFlag << filter))) {
+                continue;
+            }
+            uint8_t* candidate = filtered + filter * filteredBytes;
+            filter_row(filter, row, prior, rowBytes, bpp, candidate);
+            if (NULL == best) {
+                best = candidate;
+                bestCost = filtered_row_cost(candidate + 1, rowBytes);
+            } else {
+                const uint32_t cost = filtered_row_cost(candidate + 1, rowBytes);
+                if (cost < bestCost) {
+                    best = candidate;
+                    bestCost = cost;
+                }
+            }
+        }
+        SkASSERT(best);
+
+        band->fAdler = adler32(band->fAdler, best, SkToUInt(filteredBytes));
+        band->fLength += filteredBytes;
+        zstream.next_in = best;
+        zstream.avail_in = SkToUInt(filteredBytes);
+        if (!deflate_to_stream(&zstream, Z_NO_FLUSH, &band->fDeflated)) {
+            return false;
+        }
+        SkTSwap(prior, row);
+    }
+    return deflate_to_stream(&zstream, isLastBand ? Z_FINISH : Z_SYNC_FLUSH, &band->fDeflated);
+}
+
+// Filters, deflates and writes the image data as IDAT chunks, then writes IEND.
+static bool write_image_data(png_structp png_ptr, const SkBitmap& bitmap,
+                             transform_scanline_proc proc, int bpp,
+                             const SkPNGImageEncoder::Options& options, bool isPalette) {
+    // Bands much smaller than this cost more in lost matches than they save in time.
+    static const int kMinRowsPerBand = 32;
+    const int bandCount = SkTMax(1, SkTMin(options.fThreadCount,
+                                           bitmap.height() / kMinRowsPerBand));
+    // Like libpng, don't filter palette indices.
+    const unsigned filterFlags = isPalette
+            ? (unsigned)SkPNGImageEncoder::Options::kNone_FilterFlag : options.fFilterFlags;
+    if (0 == (filterFlags & SkPNGImageEncoder::Options::kAll_FilterFlags)) {
+        return false;
+    }
+    const int zlibLevel = SkTMax(0, SkTMin(options.fZLibLevel, 9));
+    const int strategy = zlib_strategy(options.fStrategy);
+
+    SkAutoTArray<PngBand> bands(bandCount);
+    for (int i = 0; i < bandCount; i++) {
+        bands[i].fStartY = bitmap.height() * i / bandCount;
+        bands[i].fStopY = bitmap.height() * (i + 1) / bandCount;
+        bands[i].fSuccess = false;
+    }
+
+    // The zlib header, with the FLEVEL that deflate() itself would use.
+    const int levelFlags = (strategy >= Z_HUFFMAN_ONLY || zlibLevel < 2) ? 0 :
+                           zlibLevel < 6 ? 1 : 6 == zlibLevel ? 2 : 3;
+    unsigned header = (0x78 << 8) | (levelFlags << 6);
+    header += 31 - (header % 31);
+    const uint8_t headerBytes[2] = { SkToU8(header >> 8), SkToU8(header & 0xFF) };
+    bands[0].fDeflated.write(headerBytes, sizeof(headerBytes));
+
+    sk_parallel_for(bandCount, 1, [&](int i) {
+        bands[i].fSuccess = encode_band(bitmap, proc, bpp, filterFlags, zlibLevel, strategy,
+                                        bandCount - 1 == i, &bands[i]);
+    });
+
+    uLong adler = adler32(0L, Z_NULL, 0);
+    for (int i = 0; i < bandCount; i++) {
+        if (!bands[i].fSuccess) {
+            return false;
+        }
+        adler = adler32_combine(adler, bands[i].fAdler, bands[i].fLength);
+    }
+    const uint8_t trailer[4] = {
+        SkToU8((adler >> 24) & 0xFF), SkToU8((adler >> 16) & 0xFF),
+        SkToU8((adler >>  8) & 0xFF), SkToU8(adler & 0xFF),
+    };
+    bands[bandCount - 1].fDeflated.write(trailer, sizeof(trailer));
+
+    static const size_t kMaxIDATSize = 1 << 20;
+    for (int i = 0; i < bandCount; i++) {
+        SkAutoTUnref<SkData> data(bands[i].fDeflated.copyToData());
+        bands[i].fDeflated.reset();
+        const uint8_t* bytes = data->bytes();
+        size_t remaining = data->size();
+        while (remaining > 0) {
+            const size_t size = SkTMin(remaining, kMaxIDATSize);
+            png_write_chunk(png_ptr, (png_bytep)"IDAT", (png_bytep)bytes, size);
+            bytes += size;
+            remaining -= size;
+        }
+    }
+    png_write_chunk(png_ptr, (png_bytep)"IEND", NULL, 0);
+    return true;
+}
+
+static bool do_encode(SkWStream* stream, const SkBitmap& bitmap, const bool& hasAlpha,
+                      int colorType, int bitDepth, SkColorType ct, png_color_8& sig_bit,
+                      const SkPNGImageEncoder::Options& options);
+
 bool SkPNGImageEncoder::onEncode(SkWStream* stream, const SkBitmap& bitmap, int /*quality*/) {
     SkColorType ct = bitmap.colorType();
 
@@ -1173,13 +1438,12 @@ bool SkPNGImageEncoder::onEncode(SkWStream* stream, const SkBitmap& bitmap, int
         bitDepth = computeBitDepth(ctable->count());
     }
 
-    return doEncode(stream, bitmap, hasAlpha, colorType, bitDepth, ct, sig_bit);
+    return do_encode(stream, bitmap, hasAlpha, colorType, bitDepth, ct, sig_bit, fOptions);
 }
 
-bool SkPNGImageEncoder::doEncode(SkWStream* stream, const SkBitmap& bitmap,
-                  const bool& hasAlpha, int colorType,
-                  int bitDepth, SkColorType ct,
-                  png_color_8& sig_bit) {
+static bool do_encode(SkWStream* stream, const SkBitmap& bitmap, const bool& hasAlpha,
+                      int colorType, int bitDepth, SkColorType ct, png_color_8& sig_bit,
+                      const SkPNGImageEncoder::Options& options) {
 
     png_structp png_ptr;
     png_infop info_ptr;
@@ -1236,20 +1500,15 @@ bool SkPNGImageEncoder::doEncode(SkWStream* stream, const SkBitmap& bitmap,
 #endif
     png_write_info(png_ptr, info_ptr);
 
-    const char* srcImage = (const char*)bitmap.getPixels();
-    SkAutoSMalloc<1024> rowStorage(bitmap.width() << 2);
-    char* storage = (char*)rowStorage.get();
-    transform_scanline_proc proc = choose_proc(ct, hasAlpha);
-
-    for (int y = 0; y < bitmap.height(); y++) {
-        png_bytep row_ptr = (png_bytep)storage;
-        proc(srcImage, bitmap.width(), storage);
-        png_write_rows(png_ptr, &row_ptr, 1);
-        srcImage += bitmap.rowBytes();
+    const int channels = (colorType & PNG_COLOR_MASK_PALETTE) ? 1 :
+                         (colorType & PNG_COLOR_MASK_ALPHA) ? 4 : 3;
+    SkASSERT(8 == bitDepth);
+    if (!write_image_data(png_ptr, bitmap, choose_proc(ct, hasAlpha), channels,
+                          options, SkToBool(colorType & PNG_COLOR_MASK_PALETTE))) {
+        png_destroy_write_struct(&png_ptr, &info_ptr);
+        return false;
     }
 
-    png_write_end(png_ptr, info_ptr);
-
     /* clean up after the write, and free any memory allocated */
     png_destroy_write_struct(&png_ptr, &info_ptr);
     return true;
@@ -256,6 +256,9 @@ static bool webp_get_config_resize(WebPDecoderConfig* config,
     config->output.u.RGBA.size = decodedBitmap->getSize();
     config->output.is_external_memory = 1;
 
+    // Threaded like SkWebpCodec::decode(); this config serves both full decodes and subsets.
+    config->options.use_threads = 1;
+
     if (width != decodedBitmap->width() || height != decodedBitmap->height()) {
         config->options.use_scaling = 1;
         config->options.scaled_width = decodedBitmap->width();
@@ -610,6 +613,8 @@ bool SkWEBPImageEncoder::onEncode(SkWStream* stream, const SkBitmap& bm,
     if (!WebPConfigPreset(&webp_config, WEBP_PRESET_DEFAULT, (float) quality)) {
         return false;
     }
+    // Let libwebp split the work over more than one thread.
+    webp_config.thread_level = 1;
 
     WebPPicture pic;
     WebPPictureInit(&pic);
@@ -32,7 +32,10 @@ public:
     DiscardableMemoryPool(size_t budget, SkBaseMutex* mutex = NULL);
     virtual ~DiscardableMemoryPool();
 
-    SkDiscardableMemory* create(size_t bytes) override;
+    SkDiscardableMemory* create(size_t bytes) override {
+        return this->createWithPriority(bytes, kNormal_Priority);
+    }
+    SkDiscardableMemory* createWithPriority(size_t bytes, Priority) override;
 
     size_t getRAMUsed() override;
     void setRAMBudget(size_t budget) override;
@@ -41,6 +44,9 @@ public:
     /** purges all unlocked DMs */
     void dumpPool() override;
 
+    void getSizeClassStats(int sizeClass, SizeClassStats*) override;
+    size_t getCommittedBytes() override;
+
     #if SK_LAZY_CACHE_STATS  // Defined in SkDiscardableMemoryPool.h
     int getCacheHits() override { return fCacheHits; }
     int getCacheMisses() override { return fCacheMisses; }
@@ -55,10 +61,14 @@ private:
     SkBaseMutex* fMutex;
     size_t       fBudget;
     size_t       fUsed;
-    SkTInternalLList<PoolDiscardableMemory> fList;
+    SkSlabAllocator fAllocator;
+    // One LRU list for each priority.
+    SkTInternalLList<PoolDiscardableMemory> fLists[kLast_Priority + 1];
 
     /** Function called to free memory if needed */
     void dumpDownTo(size_t budget);
+    /** Gives back dm's memory, taking it out of its list */
+    void purge(PoolDiscardableMemory* dm);
     /** called by DiscardableMemoryPool upon destruction */
     void free(PoolDiscardableMemory* dm);
     /** called by DiscardableMemoryPool::lock() */
@@ -78,7 +88,8 @@ private:
 class PoolDiscardableMemory : public SkDiscardableMemory {
 public:
     PoolDiscardableMemory(DiscardableMemoryPool* pool,
-                            void* pointer, size_t bytes);
+                          const SkSlabAllocator::Block& block,
+                          SkDiscardableMemoryPool::Priority priority);
     virtual ~PoolDiscardableMemory();
     bool lock() override;
     void* data() override;
@@ -90,15 +101,19 @@ private:
     bool                         fLocked;
     void*                        fPointer;
     const size_t                 fBytes;
+    SkSlabAllocator::Block       fBlock;
+    const SkDiscardableMemoryPool::Priority fPriority;
 };
 
 PoolDiscardableMemory::PoolDiscardableMemory(DiscardableMemoryPool* pool,
-                                             void* pointer,
-                                             size_t bytes)
+                                             const SkSlabAllocator::Block& block,
+                                             SkDiscardableMemoryPool::Priority priority)
     : fPool(pool)
     , fLocked(true)
-    , fPointer(pointer)
-    , fBytes(bytes) {
+    , fPointer(block.fPtr)
+    , fBytes(block.fBytes)
+    , fBlock(block)
+    , fPriority(priority) {
     SkASSERT(fPool != NULL);
     SkASSERT(fPointer != NULL);
     SkASSERT(fBytes > 0);
@@ -142,7 +157,9 @@ DiscardableMemoryPool::~DiscardableMemoryPool() {
     // PoolDiscardableMemory objects that belong to this pool are
     // always deleted before deleting this pool since each one has a
     // ref to the pool.
-    SkASSERT(fList.isEmpty());
+    for (int i = 0; i <= kLast_Priority; i++) {
+        SkASSERT(fLists[i].isEmpty());
+    }
 }
 
 void DiscardableMemoryPool::dumpDownTo(size_t budget) {
@@ -153,35 +170,39 @@ void DiscardableMemoryPool::dumpDownTo(size_t budget) {
         return;
     }
     typedef SkTInternalLList<PoolDiscardableMemory>::Iter Iter;
-    Iter iter;
-    PoolDiscardableMemory* cur = iter.init(fList, Iter::kTail_IterStart);
-    while ((fUsed > budget) && (cur)) {
-        if (!cur->fLocked) {
+    for (int priority = 0; priority <= kLast_Priority && fUsed > budget; priority++) {
+        Iter iter;
+        PoolDiscardableMemory* cur = iter.init(fLists[priority], Iter::kTail_IterStart);
+        while ((fUsed > budget) && (cur)) {
             PoolDiscardableMemory* dm = cur;
-            SkASSERT(dm->fPointer != NULL);
-            sk_free(dm->fPointer);
-            dm->fPointer = NULL;
-            SkASSERT(fUsed >= dm->fBytes);
-            fUsed -= dm->fBytes;
-            cur = iter.prev();
-            // Purged DMs are taken out of the list.  This saves times
-            // looking them up.  Purged DMs are NOT deleted.
-            fList.remove(dm);
-        } else {
             cur = iter.prev();
+            if (!dm->fLocked) {
+                // Purged DMs are taken out of the list.  This saves times
+                // looking them up.  Purged DMs are NOT deleted.
+                this->purge(dm);
+            }
         }
     }
 }
 
-SkDiscardableMemory* DiscardableMemoryPool::create(size_t bytes) {
-    void* addr = sk_malloc_flags(bytes, 0);
-    if (NULL == addr) {
+void DiscardableMemoryPool::purge(PoolDiscardableMemory* dm) {
+    SkASSERT(dm->fPointer != NULL);
+    fAllocator.free(dm->fBlock);
+    dm->fPointer = NULL;
+    SkASSERT(fUsed >= dm->fBytes);
+    fUsed -= dm->fBytes;
+    fLists[dm->fPriority].remove(dm);
+}
+
+SkDiscardableMemory* DiscardableMemoryPool::createWithPriority(size_t bytes, Priority priority) {
+    SkAutoMutexAcquire autoMutexAcquire(fMutex);
+    SkSlabAllocator::Block block;
+    if (!fAllocator.alloc(bytes, &block)) {
         return NULL;
     }
     PoolDiscardableMemory* dm = SkNEW_ARGS(PoolDiscardableMemory,
-                                             (this, addr, bytes));
-    SkAutoMutexAcquire autoMutexAcquire(fMutex);
-    fList.addToHead(dm);
+                                           (this, block, priority));
+    fLists[priority].addToHead(dm);
     fUsed += bytes;
     this->dumpDownTo(fBudget);
     return dm;
@@ -191,13 +212,9 @@ void DiscardableMemoryPool::free(PoolDiscardableMemory* dm) {
     SkAutoMutexAcquire autoMutexAcquire(fMutex);
     // This is called by dm's destructor.
     if (dm->fPointer != NULL) {
-        sk_free(dm->fPointer);
-        dm->fPointer = NULL;
-        SkASSERT(fUsed >= dm->fBytes);
-        fUsed -= dm->fBytes;
-        fList.remove(dm);
+        this->purge(dm);
     } else {
-        SkASSERT(!fList.isInList(dm));
+        SkASSERT(!fLists[dm->fPriority].isInList(dm));
     }
 }
 
@@ -219,8 +236,8 @@ bool DiscardableMemoryPool::lock(PoolDiscardableMemory* dm) {
         return false;
     }
     dm->fLocked = true;
-    fList.remove(dm);
-    fList.addToHead(dm);
+    fLists[dm->fPriority].remove(dm);
+    fLists[dm->fPriority].addToHead(dm);
     #if SK_LAZY_CACHE_STATS
     ++fCacheHits;
     #endif  // SK_LAZY_CACHE_STATS
@@ -246,6 +263,15 @@ void DiscardableMemoryPool::dumpPool() {
     SkAutoMutexAcquire autoMutexAcquire(fMutex);
     this->dumpDownTo(0);
 }
+void DiscardableMemoryPool::getSizeClassStats(int sizeClass, SizeClassStats* stats) {
+    SkASSERT(sizeClass >= 0 && sizeClass < SkSlabAllocator::kSizeClassCount);
+    SkAutoMutexAcquire autoMutexAcquire(fMutex);
+    fAllocator.getSizeClassStats(sizeClass, stats);
+}
+size_t DiscardableMemoryPool::getCommittedBytes() {
+    SkAutoMutexAcquire autoMutexAcquire(fMutex);
+    return fAllocator.committedBytes();
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 SK_DECLARE_STATIC_MUTEX(gMutex);
@@ -10,6 +10,7 @@
 
 #include "SkDiscardableMemory.h"
 #include "SkMutex.h"
+#include "SkSlabAllocator.h"
 
 #ifndef SK_LAZY_CACHE_STATS
     #ifdef SK_DEBUG
@@ -24,11 +25,28 @@
  *  budget of memory.  When the allocated memory exceeds this size,
  *  unlocked blocks of memory are purged.  If all memory is locked, it
  *  can exceed the memory-use budget.
+ *
+ *  Memory comes from an SkSlabAllocator, so that what is purged goes back to the OS
+ *  rather than fragmenting the heap.
  */
 class SkDiscardableMemoryPool : public SkDiscardableMemory::Factory {
 public:
     virtual ~SkDiscardableMemoryPool() { }
 
+    /**
+     *  Unlocked blocks are purged lowest priority first, and least recently used first
+     *  within a priority. create() makes blocks of kNormal_Priority.
+     */
+    enum Priority {
+        kLow_Priority,
+        kNormal_Priority,
+        kHigh_Priority,
+
+        kLast_Priority = kHigh_Priority
+    };
+
+    virtual SkDiscardableMemory* createWithPriority(size_t bytes, Priority) = 0;
+
     virtual size_t getRAMUsed() = 0;
     virtual void setRAMBudget(size_t budget) = 0;
     virtual size_t getRAMBudget() = 0;
@@ -36,6 +54,17 @@ public:
     /** purges all unlocked DMs */
     virtual void dumpPool() = 0;
 
+    typedef SkSlabAllocator::SizeClassStats SizeClassStats;
+
+    /**
+     *  How full the slabs of each of the SkSlabAllocator::kSizeClassCount size classes are:
+     *  free blocks in slabs with pages in use are fragmentation.
+     */
+    virtual void getSizeClassStats(int sizeClass, SizeClassStats*) = 0;
+
+    /** Bytes of pages the pool holds, which can be more than getRAMUsed(). */
+    virtual size_t getCommittedBytes() = 0;
+
     #if SK_LAZY_CACHE_STATS
     /**
      * These two values are a count of the number of successful and
@@ -8,6 +8,8 @@
 #include "SkDiscardablePixelRef.h"
 #include "SkDiscardableMemory.h"
 #include "SkImageGenerator.h"
+#include "SkYUVPlanesCache.h"
+#include "SkYUVToRGB.h"
 
 SkDiscardablePixelRef::SkDiscardablePixelRef(const SkImageInfo& info,
                                              SkImageGenerator* generator,
@@ -71,8 +73,13 @@ bool SkDiscardablePixelRef::onNewLockPixels(LockRec* rec) {
     SkPMColor colors[256];
     int colorCount = 0;
 
-    const SkImageGenerator::Result result = fGenerator->getPixels(info, pixels, fRowBytes, NULL,
-                                                                  colors, &colorCount);
+    // Generators that can decode to YUV planes do, and the planes are converted with Sk4f,
+    // which is cheaper than the codec's own color conversion. Planes the GPU has already cached
+    // save decoding at all.
+    SkImageGenerator::Result result = SkImageGenerator::kSuccess;
+    if (!this->decodeFromYUVPlanes(pixels)) {
+        result = fGenerator->getPixels(info, pixels, fRowBytes, NULL, colors, &colorCount);
+    }
     switch (result) {
         case SkImageGenerator::kSuccess:
         case SkImageGenerator::kIncompleteInput:
@@ -102,6 +109,57 @@ bool SkDiscardablePixelRef::onNewLockPixels(LockRec* rec) {
     return true;
 }
 
+bool SkDiscardablePixelRef::decodeFromYUVPlanes(void* pixels) {
+    const SkImageInfo& info = this->info();
+    if (kN32_SkColorType != info.colorType() || kOpaque_SkAlphaType != info.alphaType()) {
+        return false;
+    }
+
+    // Planes cached for the GPU save decoding again. Otherwise decode them just for this
+    // conversion: the RGB pixels are what stay around, so caching the planes too would hold
+    // the image twice.
+    SkYUVPlanesCache::Info yuvInfo;
+    SkAutoTUnref<SkCachedData> cachedData(
+            SkYUVPlanesCache::FindAndRef(this->getGenerationID(), &yuvInfo));
+    SkAutoMalloc storage;
+    const void* data;
+    if (cachedData) {
+        data = cachedData->data();
+    } else {
+        // Fetch the memory each plane needs; this may be rounded up to the codec's block size.
+        if (!fGenerator->getYUV8Planes(yuvInfo.fSize, NULL, NULL, NULL)) {
+            return false;
+        }
+        size_t totalSize = 0;
+        for (int i = 0; i < 3; ++i) {
+            yuvInfo.fRowBytes[i] = yuvInfo.fSize[i].fWidth;
+            yuvInfo.fSizeInMemory[i] = yuvInfo.fRowBytes[i] * yuvInfo.fSize[i].fHeight;
+            totalSize += yuvInfo.fSizeInMemory[i];
+        }
+        void* planes[3];
+        planes[0] = storage.reset(totalSize);
+        planes[1] = (uint8_t*)planes[0] + yuvInfo.fSizeInMemory[0];
+        planes[2] = (uint8_t*)planes[1] + yuvInfo.fSizeInMemory[1];
+        // This updates the plane sizes to the image's.
+        if (!fGenerator->getYUV8Planes(yuvInfo.fSize, planes, yuvInfo.fRowBytes,
+                                       &yuvInfo.fColorSpace)) {
+            return false;
+        }
+        data = planes[0];
+    }
+
+    if (yuvInfo.fSize[0] != info.dimensions() || yuvInfo.fSize[1] != yuvInfo.fSize[2]) {
+        return false;
+    }
+    const void* planes[3];
+    planes[0] = data;
+    planes[1] = (const uint8_t*)planes[0] + yuvInfo.fSizeInMemory[0];
+    planes[2] = (const uint8_t*)planes[1] + yuvInfo.fSizeInMemory[1];
+    SkYUVToN32(yuvInfo.fSize, planes, yuvInfo.fRowBytes, yuvInfo.fColorSpace,
+               static_cast<SkPMColor*>(pixels), fRowBytes);
+    return true;
+}
+
 void SkDiscardablePixelRef::onUnlockPixels() {
     fDiscardableMemory->unlock();
     fDiscardableMemoryIsLocked = false;
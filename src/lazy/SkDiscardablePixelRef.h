@@ -44,6 +44,13 @@ private:
     bool                 fDiscardableMemoryIsLocked;
     SkAutoTUnref<SkColorTable> fCTable;
 
+    /*
+     *  Converts fGenerator's YUV planes into pixels, using those in SkYUVPlanesCache if the GPU
+     *  has already cached them, and otherwise decoding them into temporary storage. Returns
+     *  false if the planes are not available, or don't suit this pixelRef.
+     */
+    bool decodeFromYUVPlanes(void* pixels);
+
     /* Takes ownership of SkImageGenerator. */
     SkDiscardablePixelRef(const SkImageInfo&, SkImageGenerator*,
                           size_t rowBytes,
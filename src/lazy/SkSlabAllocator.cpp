@@ -0,0 +1,245 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkSlabAllocator.h"
+#include "SkMath.h"
+
+#if defined(SK_BUILD_FOR_UNIX) || defined(SK_BUILD_FOR_MAC) || \
+    defined(SK_BUILD_FOR_ANDROID) || defined(SK_BUILD_FOR_IOS)
+    #define SK_SLAB_USE_MMAP 1
+    #include <sys/mman.h>
+    #include <unistd.h>
+#else
+    #define SK_SLAB_USE_MMAP 0
+#endif
+
+// Small classes get slabs of at least this many bytes, large ones at least kMinSlabBlocks blocks.
+static const size_t kMinSlabBytes = 64 * 1024;
+static const int kMinSlabBlocks = 8;
+static const size_t kMinBlockBytes = 256;
+
+// Not always 4K: some ARM kernels use 16K or 64K pages, and madvise() works in whole pages.
+static size_t os_page_bytes() {
+#if SK_SLAB_USE_MMAP
+    const long bytes = sysconf(_SC_PAGESIZE);
+    if (bytes > 0 && SkIsPow2((int)bytes)) {
+        return (size_t)bytes;
+    }
+#endif
+    return 4096;
+}
+
+static size_t page_align(size_t bytes, size_t pageBytes) {
+    return (bytes + pageBytes - 1) & ~(pageBytes - 1);
+}
+
+// Pages come straight from the OS where we can, so that they can be handed back.
+static void* map_pages(size_t bytes) {
+#if SK_SLAB_USE_MMAP
+    void* addr = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+    return MAP_FAILED == addr ? NULL : addr;
+#else
+    return sk_malloc_flags(bytes, 0);
+#endif
+}
+
+static void unmap_pages(void* addr, size_t bytes) {
+#if SK_SLAB_USE_MMAP
+    munmap(addr, bytes);
+#else
+    sk_free(addr);
+#endif
+}
+
+// Drops the physical pages behind a range, keeping the addresses usable.
+static void decommit_pages(void* addr, size_t bytes) {
+#if SK_SLAB_USE_MMAP
+    madvise(addr, bytes, MADV_DONTNEED);
+#endif
+}
+
+struct SkSlabAllocator::Slab {
+    char*               fBase;
+    size_t              fBytes;
+    int                 fSizeClass;
+    int                 fBlockCount;
+    int                 fUsed;
+    SkTDArray<uint16_t> fFree;  // indices of the free blocks
+};
+
+SkSlabAllocator::SkSlabAllocator() : fPageBytes(os_page_bytes()), fLargeBytes(0) {
+    for (int i = 0; i < kSizeClassCount; i++) {
+        fClasses[i].fBytesRequested = 0;
+    }
+}
+
+SkSlabAllocator::~SkSlabAllocator() {
+    SkASSERT(0 == fLargeBytes);
+    for (int i = 0; i < kSizeClassCount; i++) {
+        for (int j = 0; j < fClasses[i].fSlabs.count(); j++) {
+            Slab* slab = fClasses[i].fSlabs[j];
+            SkASSERT(0 == slab->fUsed);
+            unmap_pages(slab->fBase, slab->fBytes);
+            SkDELETE(slab);
+        }
+    }
+}
+
+// Four classes to each doubling: 256, 320, 384, 448, 512, 640, ...
+size_t SkSlabAllocator::BlockBytes(int sizeClass) {
+    SkASSERT(sizeClass >= 0 && sizeClass < kSizeClassCount);
+    return (kMinBlockBytes << (sizeClass >> 2)) / 4 * (4 + (sizeClass & 3));
+}
+
+int SkSlabAllocator::SizeClassFor(size_t bytes) {
+    if (bytes > BlockBytes(kSizeClassCount - 1)) {
+        return -1;
+    }
+    int doubling = 0;
+    while ((kMinBlockBytes << (doubling + 1)) < bytes) {
+        doubling++;
+    }
+    int sizeClass = doubling << 2;
+    while (BlockBytes(sizeClass) < bytes) {
+        sizeClass++;
+    }
+    return sizeClass;
+}
+
+// The fullest slab of the class with a free block, so that the emptier ones can drain.
+SkSlabAllocator::Slab* SkSlabAllocator::findSlab(int sizeClass) {
+    const SkTDArray<Slab*>& slabs = fClasses[sizeClass].fSlabs;
+    Slab* best = NULL;
+    for (int i = 0; i < slabs.count(); i++) {
+        Slab* slab = slabs[i];
+        if (slab->fUsed < slab->fBlockCount && (!best || slab->fUsed > best->fUsed)) {
+            best = slab;
+        }
+    }
+    if (best) {
+        return best;
+    }
+
+    // Slabs are whole pages, so an empty one can be given back entirely. Blocks fill the slab up
+    // to its last page.
+    const size_t blockBytes = BlockBytes(sizeClass);
+    const size_t minBlocks = SkTMax<size_t>(kMinSlabBlocks, kMinSlabBytes / blockBytes);
+    const size_t slabBytes = page_align(minBlocks * blockBytes, fPageBytes);
+    const int blockCount = SkToInt(slabBytes / blockBytes);
+    char* base = (char*)map_pages(slabBytes);
+    if (NULL == base) {
+        return NULL;
+    }
+    Slab* slab = SkNEW(Slab);
+    slab->fBase = base;
+    slab->fBytes = slabBytes;
+    slab->fSizeClass = sizeClass;
+    slab->fBlockCount = blockCount;
+    slab->fUsed = 0;
+    // Hand out the blocks from the start of the slab, touching as few pages as we can.
+    for (int i = blockCount - 1; i >= 0; i--) {
+        *slab->fFree.append() = SkToU16(i);
+    }
+    *fClasses[sizeClass].fSlabs.append() = slab;
+    return slab;
+}
+
+bool SkSlabAllocator::alloc(size_t bytes, Block* block) {
+    const int sizeClass = SizeClassFor(bytes);
+    if (sizeClass < 0) {
+        const size_t mapBytes = page_align(bytes, fPageBytes);
+        void* addr = map_pages(mapBytes);
+        if (NULL == addr) {
+            return false;
+        }
+        fLargeBytes += mapBytes;
+        block->fPtr = addr;
+        block->fSlab = NULL;
+        block->fBytes = bytes;
+        return true;
+    }
+
+    Slab* slab = this->findSlab(sizeClass);
+    if (NULL == slab) {
+        return false;
+    }
+    uint16_t index;
+    slab->fFree.pop(&index);
+    slab->fUsed += 1;
+    fClasses[sizeClass].fBytesRequested += bytes;
+
+    block->fPtr = slab->fBase + index * BlockBytes(sizeClass);
+    block->fSlab = slab;
+    block->fBytes = bytes;
+    return true;
+}
+
+void SkSlabAllocator::free(const Block& block) {
+    Slab* slab = block.fSlab;
+    if (NULL == slab) {
+        const size_t mapBytes = page_align(block.fBytes, fPageBytes);
+        SkASSERT(fLargeBytes >= mapBytes);
+        fLargeBytes -= mapBytes;
+        unmap_pages(block.fPtr, mapBytes);
+        return;
+    }
+
+    const size_t blockBytes = BlockBytes(slab->fSizeClass);
+    const size_t offset = (char*)block.fPtr - slab->fBase;
+    SkASSERT(0 == offset % blockBytes && slab->fUsed > 0);
+    *slab->fFree.append() = SkToU16(offset / blockBytes);
+    slab->fUsed -= 1;
+    fClasses[slab->fSizeClass].fBytesRequested -= block.fBytes;
+    if (0 == slab->fUsed) {
+        this->slabEmptied(slab);
+    }
+}
+
+// An empty slab's pages go back to the OS. One is kept per class, as addresses alone, so the
+// next block of that class needn't map a new one.
+void SkSlabAllocator::slabEmptied(Slab* slab) {
+    SkTDArray<Slab*>& slabs = fClasses[slab->fSizeClass].fSlabs;
+    for (int i = 0; i < slabs.count(); i++) {
+        if (slabs[i] != slab && 0 == slabs[i]->fUsed) {
+            slabs.remove(slabs.find(slab));
+            unmap_pages(slab->fBase, slab->fBytes);
+            SkDELETE(slab);
+            return;
+        }
+    }
+    decommit_pages(slab->fBase, slab->fBytes);
+}
+
+void SkSlabAllocator::getSizeClassStats(int sizeClass, SizeClassStats* stats) const {
+    const SizeClass& sc = fClasses[sizeClass];
+    stats->fBlockBytes = BlockBytes(sizeClass);
+    stats->fSlabCount = 0;
+    stats->fBlocksTotal = 0;
+    stats->fBlocksUsed = 0;
+    stats->fBytesRequested = sc.fBytesRequested;
+    for (int i = 0; i < sc.fSlabs.count(); i++) {
+        const Slab* slab = sc.fSlabs[i];
+        if (slab->fUsed > 0) {
+            stats->fSlabCount += 1;
+            stats->fBlocksTotal += slab->fBlockCount;
+            stats->fBlocksUsed += slab->fUsed;
+        }
+    }
+}
+
+size_t SkSlabAllocator::committedBytes() const {
+    size_t bytes = fLargeBytes;
+    for (int i = 0; i < kSizeClassCount; i++) {
+        const SkTDArray<Slab*>& slabs = fClasses[i].fSlabs;
+        for (int j = 0; j < slabs.count(); j++) {
+            if (slabs[j]->fUsed > 0) {
+                bytes += slabs[j]->fBytes;
+            }
+        }
+    }
+    return bytes;
+}
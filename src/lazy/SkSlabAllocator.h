@@ -0,0 +1,80 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkSlabAllocator_DEFINED
+#define SkSlabAllocator_DEFINED
+
+#include "SkTDArray.h"
+#include "SkTypes.h"
+
+/**
+ *  Hands out blocks of memory carved from slabs, each slab holding blocks of a single size
+ *  class. Sizes are rounded up to a class wasting at most a quarter of the block, and blocks of
+ *  a class are packed into the fullest slabs first, so that churn leaves whole slabs empty. The
+ *  pages of an empty slab are given back to the OS (madvise(MADV_DONTNEED) where available),
+ *  instead of lingering as holes in the heap. Blocks too big for any class get pages of their
+ *  own, unmapped when freed.
+ *
+ *  Not thread safe.
+ */
+class SkSlabAllocator : SkNoncopyable {
+public:
+    SkSlabAllocator();
+    ~SkSlabAllocator();
+
+    struct Slab;
+
+    struct Block {
+        void*  fPtr;
+        Slab*  fSlab;   // NULL for a block with pages of its own
+        size_t fBytes;  // as asked for
+    };
+
+    /** Returns false if the memory could not be had. */
+    bool alloc(size_t bytes, Block*);
+    void free(const Block&);
+
+    static const int kSizeClassCount = 41;
+
+    /** The size of the blocks in sizeClass, 256 bytes up to 256K. */
+    static size_t BlockBytes(int sizeClass);
+
+    struct SizeClassStats {
+        size_t fBlockBytes;     // the size of each block in this class
+        int    fSlabCount;      // slabs with their pages in use
+        int    fBlocksTotal;    // blocks in those slabs
+        int    fBlocksUsed;
+        size_t fBytesRequested; // asked for by the blocks in use; the rest is rounding waste
+    };
+
+    void getSizeClassStats(int sizeClass, SizeClassStats*) const;
+
+    /** The OS page size, read at runtime. Slabs and large blocks are whole pages. */
+    size_t pageBytes() const { return fPageBytes; }
+
+    /** Bytes of pages held for blocks not in any class. */
+    size_t largeBytes() const { return fLargeBytes; }
+
+    /** Bytes of pages in use: those of slabs with any blocks in use, and large blocks. */
+    size_t committedBytes() const;
+
+private:
+    struct SizeClass {
+        SkTDArray<Slab*> fSlabs;
+        size_t           fBytesRequested;
+    };
+
+    SizeClass fClasses[kSizeClassCount];
+    size_t    fPageBytes;
+    size_t    fLargeBytes;
+
+    static int SizeClassFor(size_t bytes);
+    Slab* findSlab(int sizeClass);
+    void slabEmptied(Slab*);
+};
+
+#endif
@@ -36,6 +36,80 @@ private:
     int32x4_t fVec;
 };
 
+template <>
+class SkNi<4, uint32_t> {
+public:
+    SkNi(const uint32x4_t& vec) : fVec(vec) {}
+
+    SkNi() {}
+    explicit SkNi(uint32_t val) : fVec(vdupq_n_u32(val)) {}
+    static SkNi Load(const uint32_t vals[4]) { return vld1q_u32(vals); }
+    static SkNi FromBytes(const uint8_t bytes[4]) {
+        uint32_t packed;
+        memcpy(&packed, bytes, 4);
+        const uint16x8_t words = vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(packed)));
+        return vmovl_u16(vget_low_u16(words));
+    }
+
+    void store(uint32_t vals[4]) const { vst1q_u32(vals, fVec); }
+    void toBytes(uint8_t bytes[4]) const {
+        const uint16x4_t words = vmovn_u32(fVec);
+        const uint32_t packed =
+                vget_lane_u32(vreinterpret_u32_u8(vmovn_u16(vcombine_u16(words, words))), 0);
+        memcpy(bytes, &packed, 4);
+    }
+
+    SkNi operator + (const SkNi& o) const { return vaddq_u32(fVec, o.fVec); }
+    SkNi operator - (const SkNi& o) const { return vsubq_u32(fVec, o.fVec); }
+    SkNi operator * (const SkNi& o) const { return vmulq_u32(fVec, o.fVec); }
+    SkNi operator << (int bits) const { return vshlq_u32(fVec, vdupq_n_s32(bits)); }
+    SkNi operator >> (int bits) const { return vshlq_u32(fVec, vdupq_n_s32(-bits)); }
+
+    template <int k> uint32_t kth() const {
+        SkASSERT(0 <= k && k < 4);
+        return vgetq_lane_u32(fVec, k&3);
+    }
+
+private:
+    uint32x4_t fVec;
+};
+
+template <>
+class SkNi<4, uint16_t> {
+public:
+    SkNi(const uint16x4_t& vec) : fVec(vec) {}
+
+    SkNi() {}
+    explicit SkNi(uint16_t val) : fVec(vdup_n_u16(val)) {}
+    static SkNi Load(const uint16_t vals[4]) { return vld1_u16(vals); }
+    static SkNi FromBytes(const uint8_t bytes[4]) {
+        uint32_t packed;
+        memcpy(&packed, bytes, 4);
+        return vget_low_u16(vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(packed))));
+    }
+
+    void store(uint16_t vals[4]) const { vst1_u16(vals, fVec); }
+    void toBytes(uint8_t bytes[4]) const {
+        const uint32_t packed =
+                vget_lane_u32(vreinterpret_u32_u8(vmovn_u16(vcombine_u16(fVec, fVec))), 0);
+        memcpy(bytes, &packed, 4);
+    }
+
+    SkNi operator + (const SkNi& o) const { return vadd_u16(fVec, o.fVec); }
+    SkNi operator - (const SkNi& o) const { return vsub_u16(fVec, o.fVec); }
+    SkNi operator * (const SkNi& o) const { return vmul_u16(fVec, o.fVec); }
+    SkNi operator << (int bits) const { return vshl_u16(fVec, vdup_n_s16(bits)); }
+    SkNi operator >> (int bits) const { return vshl_u16(fVec, vdup_n_s16(-bits)); }
+
+    template <int k> uint16_t kth() const {
+        SkASSERT(0 <= k && k < 4);
+        return vget_lane_u16(fVec, k&3);
+    }
+
+private:
+    uint16x4_t fVec;
+};
+
 template <>
 class SkNf<2, float> {
     typedef SkNi<2, int32_t> Ni;
@@ -50,6 +50,90 @@ private:
     __m128i fVec;
 };
 
+template <>
+class SkNi<4, uint32_t> {
+public:
+    SkNi(const __m128i& vec) : fVec(vec) {}
+
+    SkNi() {}
+    explicit SkNi(uint32_t val) : fVec(_mm_set1_epi32(val)) {}
+    static SkNi Load(const uint32_t vals[4]) { return _mm_loadu_si128((const __m128i*)vals); }
+    static SkNi FromBytes(const uint8_t bytes[4]) {
+        int32_t packed;
+        memcpy(&packed, bytes, 4);
+        const __m128i zero = _mm_setzero_si128();
+        return _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(packed), zero), zero);
+    }
+
+    void store(uint32_t vals[4]) const { _mm_storeu_si128((__m128i*)vals, fVec); }
+    void toBytes(uint8_t bytes[4]) const {
+        const __m128i words = _mm_packs_epi32(fVec, fVec);
+        const int32_t packed = _mm_cvtsi128_si32(_mm_packus_epi16(words, words));
+        memcpy(bytes, &packed, 4);
+    }
+
+    SkNi operator + (const SkNi& o) const { return _mm_add_epi32(fVec, o.fVec); }
+    SkNi operator - (const SkNi& o) const { return _mm_sub_epi32(fVec, o.fVec); }
+    SkNi operator * (const SkNi& o) const {
+    #if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE41
+        return _mm_mullo_epi32(fVec, o.fVec);
+    #else
+        // SSE2 can only multiply the even lanes, so we do the odd ones shifted down.
+        __m128i mul20 = _mm_mul_epu32(fVec, o.fVec),
+                mul31 = _mm_mul_epu32(_mm_srli_si128(fVec, 4), _mm_srli_si128(o.fVec, 4));
+        return _mm_unpacklo_epi32(_mm_shuffle_epi32(mul20, _MM_SHUFFLE(0,0,2,0)),
+                                  _mm_shuffle_epi32(mul31, _MM_SHUFFLE(0,0,2,0)));
+    #endif
+    }
+    SkNi operator << (int bits) const { return _mm_slli_epi32(fVec, bits); }
+    SkNi operator >> (int bits) const { return _mm_srli_epi32(fVec, bits); }
+
+    template <int k> uint32_t kth() const {
+        SkASSERT(0 <= k && k < 4);
+        uint32_t vals[4];
+        this->store(vals);
+        return vals[k&3];
+    }
+
+private:
+    __m128i fVec;
+};
+
+template <>
+class SkNi<4, uint16_t> {
+public:
+    SkNi(const __m128i& vec) : fVec(vec) {}
+
+    SkNi() {}
+    explicit SkNi(uint16_t val) : fVec(_mm_set1_epi16(val)) {}
+    static SkNi Load(const uint16_t vals[4]) { return _mm_loadl_epi64((const __m128i*)vals); }
+    static SkNi FromBytes(const uint8_t bytes[4]) {
+        int32_t packed;
+        memcpy(&packed, bytes, 4);
+        return _mm_unpacklo_epi8(_mm_cvtsi32_si128(packed), _mm_setzero_si128());
+    }
+
+    void store(uint16_t vals[4]) const { _mm_storel_epi64((__m128i*)vals, fVec); }
+    void toBytes(uint8_t bytes[4]) const {
+        const int32_t packed = _mm_cvtsi128_si32(_mm_packus_epi16(fVec, fVec));
+        memcpy(bytes, &packed, 4);
+    }
+
+    SkNi operator + (const SkNi& o) const { return _mm_add_epi16(fVec, o.fVec); }
+    SkNi operator - (const SkNi& o) const { return _mm_sub_epi16(fVec, o.fVec); }
+    SkNi operator * (const SkNi& o) const { return _mm_mullo_epi16(fVec, o.fVec); }
+    SkNi operator << (int bits) const { return _mm_slli_epi16(fVec, bits); }
+    SkNi operator >> (int bits) const { return _mm_srli_epi16(fVec, bits); }
+
+    template <int k> uint16_t kth() const {
+        SkASSERT(0 <= k && k < 4);
+        return _mm_extract_epi16(fVec, k&3);
+    }
+
+private:
+    __m128i fVec;
+};
+
 
 template <>
 class SkNf<2, float> {
@@ -0,0 +1,41 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkSwizzler_opts_DEFINED
+#define SkSwizzler_opts_DEFINED
+
+#include "SkColor.h"
+
+/**
+ *  The byte-oriented conversions to N32 that SkSwizzler can hand off to SIMD code. The portable
+ *  versions are in src/codec/SkSwizzler.cpp.
+ */
+enum SkSwizzleProcType {
+    kRGBA_To_N32_Premul_SkSwizzleProcType,
+    kRGBA_To_N32_Unpremul_SkSwizzleProcType,
+    kBGRA_To_N32_Premul_SkSwizzleProcType,
+    kBGRA_To_N32_Unpremul_SkSwizzleProcType,
+    kRGBX_To_N32_SkSwizzleProcType,
+    kBGRX_To_N32_SkSwizzleProcType,
+    kRGB_To_N32_SkSwizzleProcType,
+    kBGR_To_N32_SkSwizzleProcType,
+};
+
+/**
+ *  Same signature as SkSwizzler::RowProc. Returns the bitwise AND of the row's alphas in the
+ *  high byte and their bitwise OR in the low byte.
+ */
+typedef uint16_t (*SkSwizzleRowProc)(void* SK_RESTRICT dstRow, const uint8_t* SK_RESTRICT src,
+                                     int width, int bytesPerPixel, int y,
+                                     const SkPMColor ctable[]);
+
+/**
+ *  Returns a faster version of the row proc for this CPU, or NULL to use the portable one.
+ */
+SkSwizzleRowProc SkSwizzleGetPlatformProc(SkSwizzleProcType);
+
+#endif
@@ -0,0 +1,151 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include <emmintrin.h>
+#include "SkColorPriv.h"
+#include "SkSwizzler_opts_SSE2.h"
+
+/* SSE2 versions of the 4 byte per pixel swizzles, 4 pixels at a time.
+ * Portable versions are in src/codec/SkSwizzler.cpp.
+ */
+
+namespace {
+
+// Whether a source in this order needs its R and B bytes swapped to make an SkPMColor.
+template <bool kSrcIsBGRA> struct NeedsSwapRB {
+    static const bool value = kSrcIsBGRA ? SK_PMCOLOR_BYTE_ORDER(R,G,B,A)
+                                         : SK_PMCOLOR_BYTE_ORDER(B,G,R,A);
+};
+
+// Swaps bytes 0 and 2 of each pixel.
+static inline __m128i swap_rb(__m128i px) {
+    const __m128i rbMask = _mm_set1_epi32(0x00FF00FF);
+    const __m128i rb = _mm_and_si128(rbMask, px),
+                  ga = _mm_andnot_si128(rbMask, px);
+    return _mm_or_si128(ga, _mm_or_si128(_mm_slli_epi32(rb, 16), _mm_srli_epi32(rb, 16)));
+}
+
+// Divides each 16 bit lane by 255, rounding exactly as SkMulDiv255Round() does.
+static inline __m128i div255_round(__m128i x) {
+    x = _mm_add_epi16(x, _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+
+// Multiplies two widened pixels' color bytes by their alpha, leaving alpha as it was.
+static inline __m128i premul_16(__m128i px) {
+    __m128i alpha = _mm_shufflelo_epi16(px,    _MM_SHUFFLE(3,3,3,3));
+    alpha         = _mm_shufflehi_epi16(alpha, _MM_SHUFFLE(3,3,3,3));
+    // Alpha itself is multiplied by 255, which div255_round() undoes.
+    alpha = _mm_or_si128(alpha, _mm_set_epi16(255,0,0,0, 255,0,0,0));
+    return div255_round(_mm_mullo_epi16(px, alpha));
+}
+
+static inline __m128i premul(__m128i px) {
+    const __m128i zero = _mm_setzero_si128();
+    return _mm_packus_epi16(premul_16(_mm_unpacklo_epi8(px, zero)),
+                            premul_16(_mm_unpackhi_epi8(px, zero)));
+}
+
+// Folds the alpha bytes of the pixels ANDed and ORed together into maxAlpha and zeroAlpha.
+static inline void fold_alpha(__m128i andAlpha, __m128i orAlpha,
+                              uint8_t* maxAlpha, uint8_t* zeroAlpha) {
+    uint32_t ands[4], ors[4];
+    _mm_storeu_si128((__m128i*)ands, andAlpha);
+    _mm_storeu_si128((__m128i*)ors,  orAlpha);
+    for (int i = 0; i < 4; i++) {
+        *maxAlpha  &= ands[i] >> 24;
+        *zeroAlpha |= ors[i]  >> 24;
+    }
+}
+
+template <bool kSrcIsBGRA, bool kPremul>
+static uint16_t swizzle_4byte_alpha_SSE2(void* SK_RESTRICT dstRow,
+                                         const uint8_t* SK_RESTRICT src,
+                                         int width, int bytesPerPixel, int y,
+                                         const SkPMColor ctable[]) {
+    SkASSERT(4 == bytesPerPixel);
+    SkPMColor* SK_RESTRICT dst = (SkPMColor*)dstRow;
+
+    __m128i andAlpha = _mm_set1_epi32(0xFFFFFFFF),
+            orAlpha  = _mm_setzero_si128();
+    int x = 0;
+    for (; x + 4 <= width; x += 4) {
+        __m128i px = _mm_loadu_si128((const __m128i*)(src + 4*x));
+        andAlpha = _mm_and_si128(andAlpha, px);
+        orAlpha  = _mm_or_si128(orAlpha, px);
+        if (kPremul) {
+            px = premul(px);
+        }
+        if (NeedsSwapRB<kSrcIsBGRA>::value) {
+            px = swap_rb(px);
+        }
+        _mm_storeu_si128((__m128i*)(dst + x), px);
+    }
+
+    uint8_t maxAlpha = 0xFF, zeroAlpha = 0;
+    fold_alpha(andAlpha, orAlpha, &maxAlpha, &zeroAlpha);
+    for (; x < width; x++) {
+        const uint8_t* p = src + 4*x;
+        const uint8_t r = p[kSrcIsBGRA ? 2 : 0],
+                      g = p[1],
+                      b = p[kSrcIsBGRA ? 0 : 2],
+                      a = p[3];
+        maxAlpha  &= a;
+        zeroAlpha |= a;
+        dst[x] = kPremul ? SkPreMultiplyARGB(a, r, g, b) : SkPackARGB32NoCheck(a, r, g, b);
+    }
+    return (((uint16_t) maxAlpha) << 8) | zeroAlpha;
+}
+
+template <bool kSrcIsBGRA>
+static uint16_t swizzle_4byte_opaque_SSE2(void* SK_RESTRICT dstRow,
+                                          const uint8_t* SK_RESTRICT src,
+                                          int width, int bytesPerPixel, int y,
+                                          const SkPMColor ctable[]) {
+    SkASSERT(4 == bytesPerPixel);
+    SkPMColor* SK_RESTRICT dst = (SkPMColor*)dstRow;
+
+    const __m128i opaque = _mm_set1_epi32(SkPackARGB32(0xFF, 0, 0, 0));
+    int x = 0;
+    for (; x + 4 <= width; x += 4) {
+        __m128i px = _mm_loadu_si128((const __m128i*)(src + 4*x));
+        if (NeedsSwapRB<kSrcIsBGRA>::value) {
+            px = swap_rb(px);
+        }
+        _mm_storeu_si128((__m128i*)(dst + x), _mm_or_si128(px, opaque));
+    }
+    for (; x < width; x++) {
+        const uint8_t* p = src + 4*x;
+        dst[x] = SkPackARGB32(0xFF, p[kSrcIsBGRA ? 2 : 0], p[1], p[kSrcIsBGRA ? 0 : 2]);
+    }
+    return 0xFFFF;
+}
+
+}  // namespace
+
+SkSwizzleRowProc SkSwizzleGetPlatformProc_SSE2(SkSwizzleProcType type) {
+    // The code above assumes alpha is the last byte, and R and B are on either side of G.
+    if (!SK_PMCOLOR_BYTE_ORDER(R,G,B,A) && !SK_PMCOLOR_BYTE_ORDER(B,G,R,A)) {
+        return NULL;
+    }
+    switch (type) {
+        case kRGBA_To_N32_Premul_SkSwizzleProcType:
+            return swizzle_4byte_alpha_SSE2<false, true>;
+        case kRGBA_To_N32_Unpremul_SkSwizzleProcType:
+            return swizzle_4byte_alpha_SSE2<false, false>;
+        case kBGRA_To_N32_Premul_SkSwizzleProcType:
+            return swizzle_4byte_alpha_SSE2<true, true>;
+        case kBGRA_To_N32_Unpremul_SkSwizzleProcType:
+            return swizzle_4byte_alpha_SSE2<true, false>;
+        case kRGBX_To_N32_SkSwizzleProcType:
+            return swizzle_4byte_opaque_SSE2<false>;
+        case kBGRX_To_N32_SkSwizzleProcType:
+            return swizzle_4byte_opaque_SSE2<true>;
+        default:
+            return NULL;
+    }
+}
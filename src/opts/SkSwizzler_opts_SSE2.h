@@ -0,0 +1,15 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkSwizzler_opts_SSE2_DEFINED
+#define SkSwizzler_opts_SSE2_DEFINED
+
+#include "SkSwizzler_opts.h"
+
+SkSwizzleRowProc SkSwizzleGetPlatformProc_SSE2(SkSwizzleProcType);
+
+#endif
@@ -0,0 +1,72 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkColorPriv.h"
+#include "SkSwizzler_opts_SSSE3.h"
+
+/* SSSE3 versions of the 3 byte per pixel swizzles, which need pshufb to spread pixels out.
+ * Portable versions are in src/codec/SkSwizzler.cpp.
+ */
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSSE3
+
+#include <tmmintrin.h>  // SSSE3
+
+namespace {
+
+template <bool kSrcIsBGR>
+static uint16_t swizzle_3byte_SSSE3(void* SK_RESTRICT dstRow,
+                                    const uint8_t* SK_RESTRICT src,
+                                    int width, int bytesPerPixel, int y,
+                                    const SkPMColor ctable[]) {
+    SkASSERT(3 == bytesPerPixel);
+    SkPMColor* SK_RESTRICT dst = (SkPMColor*)dstRow;
+
+    // Where each byte of 4 SkPMColors comes from in 12 source bytes; -1 makes a zero.
+    const int r = kSrcIsBGR ? 2 : 0,
+              b = kSrcIsBGR ? 0 : 2;
+    const __m128i shuffle = SK_PMCOLOR_BYTE_ORDER(B,G,R,A)
+        ? _mm_setr_epi8(b, 1, r, -1, b+3, 4, r+3, -1, b+6, 7, r+6, -1, b+9, 10, r+9, -1)
+        : _mm_setr_epi8(r, 1, b, -1, r+3, 4, b+3, -1, r+6, 7, b+6, -1, r+9, 10, b+9, -1);
+    const __m128i opaque = _mm_set1_epi32(SkPackARGB32(0xFF, 0, 0, 0));
+
+    int x = 0;
+    // Each load reads 16 bytes to use 12, so stop while that's still inside the row.
+    for (; x + 6 <= width; x += 4) {
+        const __m128i px = _mm_loadu_si128((const __m128i*)(src + 3*x));
+        _mm_storeu_si128((__m128i*)(dst + x),
+                         _mm_or_si128(_mm_shuffle_epi8(px, shuffle), opaque));
+    }
+    for (; x < width; x++) {
+        const uint8_t* p = src + 3*x;
+        dst[x] = SkPackARGB32(0xFF, p[r], p[1], p[b]);
+    }
+    return 0xFFFF;
+}
+
+}  // namespace
+
+SkSwizzleRowProc SkSwizzleGetPlatformProc_SSSE3(SkSwizzleProcType type) {
+    if (!SK_PMCOLOR_BYTE_ORDER(R,G,B,A) && !SK_PMCOLOR_BYTE_ORDER(B,G,R,A)) {
+        return NULL;
+    }
+    switch (type) {
+        case kRGB_To_N32_SkSwizzleProcType:
+            return swizzle_3byte_SSSE3<false>;
+        case kBGR_To_N32_SkSwizzleProcType:
+            return swizzle_3byte_SSSE3<true>;
+        default:
+            return NULL;
+    }
+}
+
+#else // SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSSE3
+
+SkSwizzleRowProc SkSwizzleGetPlatformProc_SSSE3(SkSwizzleProcType) {
+    return NULL;
+}
+
+#endif
@@ -0,0 +1,15 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkSwizzler_opts_SSSE3_DEFINED
+#define SkSwizzler_opts_SSSE3_DEFINED
+
+#include "SkSwizzler_opts.h"
+
+SkSwizzleRowProc SkSwizzleGetPlatformProc_SSSE3(SkSwizzleProcType);
+
+#endif
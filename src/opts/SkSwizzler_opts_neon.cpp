@@ -0,0 +1,108 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkColorPriv.h"
+#include "SkSwizzler_opts_neon.h"
+
+#include <arm_neon.h>
+
+/* neon versions of the swizzles to N32, 8 pixels at a time.
+ * Portable versions are in src/codec/SkSwizzler.cpp.
+ */
+
+namespace {
+
+// Computes SkMulDiv255Round(c, a) for 8 pairs at once.
+static inline uint8x8_t mul_div255_round(uint8x8_t c, uint8x8_t a) {
+    const uint16x8_t prod = vmull_u8(c, a);
+    return vraddhn_u16(prod, vrshrq_n_u16(prod, 8));
+}
+
+template <int kSrcBytes, bool kSrcIsBGR, bool kHasAlpha, bool kPremul>
+static uint16_t swizzle_neon(void* SK_RESTRICT dstRow, const uint8_t* SK_RESTRICT src,
+                             int width, int bytesPerPixel, int y, const SkPMColor ctable[]) {
+    SkASSERT(kSrcBytes == bytesPerPixel);
+    SkPMColor* SK_RESTRICT dst = (SkPMColor*)dstRow;
+    const int r = kSrcIsBGR ? 2 : 0,
+              b = kSrcIsBGR ? 0 : 2;
+
+    uint8x8_t andAlpha = vdup_n_u8(0xFF),
+              orAlpha  = vdup_n_u8(0);
+    int x = 0;
+    for (; x + 8 <= width; x += 8) {
+        uint8x8x4_t px;
+        if (4 == kSrcBytes) {
+            px = vld4_u8(src + 4*x);
+        } else {
+            const uint8x8x3_t rgb = vld3_u8(src + 3*x);
+            px.val[0] = rgb.val[0];
+            px.val[1] = rgb.val[1];
+            px.val[2] = rgb.val[2];
+        }
+        if (!kHasAlpha) {
+            px.val[3] = vdup_n_u8(0xFF);
+        }
+        const uint8x8_t alpha = px.val[3];
+        andAlpha = vand_u8(andAlpha, alpha);
+        orAlpha  = vorr_u8(orAlpha, alpha);
+
+        uint8x8x4_t pm;
+        pm.val[SK_R32_SHIFT/8] = px.val[r];
+        pm.val[SK_G32_SHIFT/8] = px.val[1];
+        pm.val[SK_B32_SHIFT/8] = px.val[b];
+        pm.val[SK_A32_SHIFT/8] = alpha;
+        if (kPremul) {
+            pm.val[SK_R32_SHIFT/8] = mul_div255_round(pm.val[SK_R32_SHIFT/8], alpha);
+            pm.val[SK_G32_SHIFT/8] = mul_div255_round(pm.val[SK_G32_SHIFT/8], alpha);
+            pm.val[SK_B32_SHIFT/8] = mul_div255_round(pm.val[SK_B32_SHIFT/8], alpha);
+        }
+        vst4_u8((uint8_t*)(dst + x), pm);
+    }
+
+    uint8_t ands[8], ors[8];
+    vst1_u8(ands, andAlpha);
+    vst1_u8(ors,  orAlpha);
+    uint8_t maxAlpha = 0xFF, zeroAlpha = 0;
+    for (int i = 0; i < 8; i++) {
+        maxAlpha  &= ands[i];
+        zeroAlpha |= ors[i];
+    }
+    for (; x < width; x++) {
+        const uint8_t* p = src + kSrcBytes*x;
+        const uint8_t a = kHasAlpha ? p[3] : 0xFF;
+        maxAlpha  &= a;
+        zeroAlpha |= a;
+        dst[x] = kPremul ? SkPreMultiplyARGB(a, p[r], p[1], p[b])
+                         : SkPackARGB32NoCheck(a, p[r], p[1], p[b]);
+    }
+    return (((uint16_t) maxAlpha) << 8) | zeroAlpha;
+}
+
+}  // namespace
+
+SkSwizzleRowProc SkSwizzleGetPlatformProc_neon(SkSwizzleProcType type) {
+    switch (type) {
+        case kRGBA_To_N32_Premul_SkSwizzleProcType:
+            return swizzle_neon<4, false, true, true>;
+        case kRGBA_To_N32_Unpremul_SkSwizzleProcType:
+            return swizzle_neon<4, false, true, false>;
+        case kBGRA_To_N32_Premul_SkSwizzleProcType:
+            return swizzle_neon<4, true, true, true>;
+        case kBGRA_To_N32_Unpremul_SkSwizzleProcType:
+            return swizzle_neon<4, true, true, false>;
+        case kRGBX_To_N32_SkSwizzleProcType:
+            return swizzle_neon<4, false, false, false>;
+        case kBGRX_To_N32_SkSwizzleProcType:
+            return swizzle_neon<4, true, false, false>;
+        case kRGB_To_N32_SkSwizzleProcType:
+            return swizzle_neon<3, false, false, false>;
+        case kBGR_To_N32_SkSwizzleProcType:
+            return swizzle_neon<3, true, false, false>;
+        default:
+            return NULL;
+    }
+}
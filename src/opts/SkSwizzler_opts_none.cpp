@@ -0,0 +1,12 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkSwizzler_opts.h"
+
+SkSwizzleRowProc SkSwizzleGetPlatformProc(SkSwizzleProcType) {
+    return NULL;
+}
@@ -0,0 +1,34 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkTransformScanline_opts_DEFINED
+#define SkTransformScanline_opts_DEFINED
+
+#include "SkTypes.h"
+
+/**
+ *  The scanline transforms from N32 that the PNG encoder can hand off to SIMD code. The portable
+ *  versions are in src/images/transform_scanline.h.
+ */
+enum SkTransformScanlineProcType {
+    kN32_To_RGB_SkTransformScanlineProcType,
+    kN32_To_RGBA_Unpremul_SkTransformScanlineProcType,
+};
+
+/**
+ *  Same signature as transform_scanline_proc. Must produce exactly the bytes the portable version
+ *  does, including for colors that are not validly premultiplied.
+ */
+typedef void (*SkTransformScanlineProc)(const char* SK_RESTRICT src, int width,
+                                        char* SK_RESTRICT dst);
+
+/**
+ *  Returns a faster version of the transform for this CPU, or NULL to use the portable one.
+ */
+SkTransformScanlineProc SkTransformScanlineGetPlatformProc(SkTransformScanlineProcType);
+
+#endif
@@ -0,0 +1,139 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include <emmintrin.h>
+#include "SkColorPriv.h"
+#include "SkTransformScanline_opts_SSE2.h"
+#include "SkUnPreMultiply.h"
+
+/* SSE2 versions of the N32 scanline transforms, 4 pixels at a time.
+ * Portable versions are in src/images/transform_scanline.h.
+ */
+
+namespace {
+
+// Reorders each SkPMColor so its bytes are R,G,B,A in memory.
+static inline __m128i to_rgba(__m128i px) {
+    if (SK_PMCOLOR_BYTE_ORDER(R,G,B,A)) {
+        return px;
+    }
+    const __m128i rbMask = _mm_set1_epi32(0x00FF00FF);
+    const __m128i rb = _mm_and_si128(rbMask, px),
+                  ga = _mm_andnot_si128(rbMask, px);
+    return _mm_or_si128(ga, _mm_or_si128(_mm_slli_epi32(rb, 16), _mm_srli_epi32(rb, 16)));
+}
+
+// Multiplies the 32 bit lanes of a and b, keeping the low 32 bits like _mm_mullo_epi32().
+static inline __m128i mullo_epi32(__m128i a, __m128i b) {
+    const __m128i even = _mm_mul_epu32(a, b),
+                  odd  = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0,0,2,0)),
+                              _mm_shuffle_epi32(odd,  _MM_SHUFFLE(0,0,2,0)));
+}
+
+// SkUnPreMultiply::ApplyScale() on the byte at kShift in each lane, 32 bit overflow included.
+template <int kShift>
+static inline __m128i apply_scale(__m128i rgba, __m128i scale) {
+    const __m128i c = _mm_and_si128(_mm_srli_epi32(rgba, kShift), _mm_set1_epi32(0xFF));
+    const __m128i prod = _mm_add_epi32(mullo_epi32(scale, c), _mm_set1_epi32(1 << 23));
+    return _mm_slli_epi32(_mm_srli_epi32(prod, 24), kShift);
+}
+
+static void transform_scanline_8888_SSE2(const char* SK_RESTRICT src, int width,
+                                         char* SK_RESTRICT dst) {
+    const SkPMColor* SK_RESTRICT srcP = (const SkPMColor*)src;
+    const SkUnPreMultiply::Scale* SK_RESTRICT table = SkUnPreMultiply::GetScaleTable();
+    const __m128i alphaMask = _mm_set1_epi32(0xFF000000);
+
+    int x = 0;
+    for (; x + 4 <= width; x += 4) {
+        const __m128i px = to_rgba(_mm_loadu_si128((const __m128i*)(srcP + x)));
+        const __m128i alpha = _mm_and_si128(px, alphaMask);
+        // Like the portable version, pixels with alpha of 0 or 255 pass through unscaled.
+        const __m128i keep = _mm_or_si128(_mm_cmpeq_epi32(alpha, alphaMask),
+                                          _mm_cmpeq_epi32(alpha, _mm_setzero_si128()));
+        __m128i out = px;
+        if (0xFFFF != _mm_movemask_epi8(keep)) {
+            const __m128i scale = _mm_setr_epi32(table[SkGetPackedA32(srcP[x + 0])],
+                                                 table[SkGetPackedA32(srcP[x + 1])],
+                                                 table[SkGetPackedA32(srcP[x + 2])],
+                                                 table[SkGetPackedA32(srcP[x + 3])]);
+            __m128i unpremul = _mm_or_si128(apply_scale<0>(px, scale), alpha);
+            unpremul = _mm_or_si128(unpremul, apply_scale<8>(px, scale));
+            unpremul = _mm_or_si128(unpremul, apply_scale<16>(px, scale));
+            out = _mm_or_si128(_mm_and_si128(keep, px), _mm_andnot_si128(keep, unpremul));
+        }
+        _mm_storeu_si128((__m128i*)(dst + 4*x), out);
+    }
+
+    dst += 4*x;
+    for (; x < width; x++) {
+        SkPMColor c = srcP[x];
+        unsigned a = SkGetPackedA32(c);
+        unsigned r = SkGetPackedR32(c);
+        unsigned g = SkGetPackedG32(c);
+        unsigned b = SkGetPackedB32(c);
+
+        if (0 != a && 255 != a) {
+            SkUnPreMultiply::Scale scale = table[a];
+            r = SkUnPreMultiply::ApplyScale(scale, r);
+            g = SkUnPreMultiply::ApplyScale(scale, g);
+            b = SkUnPreMultiply::ApplyScale(scale, b);
+        }
+        *dst++ = r;
+        *dst++ = g;
+        *dst++ = b;
+        *dst++ = a;
+    }
+}
+
+static void transform_scanline_888_SSE2(const char* SK_RESTRICT src, int width,
+                                        char* SK_RESTRICT dst) {
+    const SkPMColor* SK_RESTRICT srcP = (const SkPMColor*)src;
+    const __m128i lowRGB  = _mm_set_epi32(0, 0x00FFFFFF, 0, 0x00FFFFFF),
+                  highRGB = _mm_set_epi32(0x0000FFFF, 0xFF000000, 0x0000FFFF, 0xFF000000);
+
+    int x = 0;
+    for (; x + 4 <= width; x += 4) {
+        const __m128i px = to_rgba(_mm_loadu_si128((const __m128i*)(srcP + x)));
+        // Squeeze each pair of pixels into the low 6 bytes of its 64 bit half...
+        const __m128i pairs = _mm_or_si128(_mm_and_si128(px, lowRGB),
+                                           _mm_and_si128(_mm_srli_epi64(px, 8), highRGB));
+        // ... then slide the second pair down against the first.
+        const __m128i rgb = _mm_or_si128(_mm_move_epi64(pairs),
+                                         _mm_srli_si128(_mm_unpackhi_epi64(_mm_setzero_si128(),
+                                                                           pairs), 2));
+        _mm_storel_epi64((__m128i*)dst, rgb);
+        const uint32_t last = _mm_cvtsi128_si32(_mm_srli_si128(rgb, 8));
+        memcpy(dst + 8, &last, 4);
+        dst += 12;
+    }
+
+    for (; x < width; x++) {
+        SkPMColor c = srcP[x];
+        *dst++ = SkGetPackedR32(c);
+        *dst++ = SkGetPackedG32(c);
+        *dst++ = SkGetPackedB32(c);
+    }
+}
+
+}  // namespace
+
+SkTransformScanlineProc SkTransformScanlineGetPlatformProc_SSE2(SkTransformScanlineProcType type) {
+    // The code above assumes alpha is the last byte, and R and B are on either side of G.
+    if (!SK_PMCOLOR_BYTE_ORDER(R,G,B,A) && !SK_PMCOLOR_BYTE_ORDER(B,G,R,A)) {
+        return NULL;
+    }
+    switch (type) {
+        case kN32_To_RGB_SkTransformScanlineProcType:
+            return transform_scanline_888_SSE2;
+        case kN32_To_RGBA_Unpremul_SkTransformScanlineProcType:
+            return transform_scanline_8888_SSE2;
+        default:
+            return NULL;
+    }
+}
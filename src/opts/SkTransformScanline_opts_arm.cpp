@@ -0,0 +1,23 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkTransformScanline_opts.h"
+#include "SkTransformScanline_opts_neon.h"
+#include "SkUtilsArm.h"
+
+SkTransformScanlineProc SkTransformScanlineGetPlatformProc(SkTransformScanlineProcType type) {
+#if SK_ARM_NEON_IS_NONE
+    return NULL;
+#else
+#if SK_ARM_NEON_IS_DYNAMIC
+    if (!sk_cpu_arm_has_neon()) {
+        return NULL;
+    }
+#endif
+    return SkTransformScanlineGetPlatformProc_neon(type);
+#endif
+}
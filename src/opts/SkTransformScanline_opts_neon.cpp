@@ -0,0 +1,117 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkColorPriv.h"
+#include "SkTransformScanline_opts_neon.h"
+#include "SkUnPreMultiply.h"
+
+#include <arm_neon.h>
+
+/* neon versions of the N32 scanline transforms, 8 pixels at a time.
+ * Portable versions are in src/images/transform_scanline.h.
+ */
+
+namespace {
+
+// SkUnPreMultiply::ApplyScale() for 8 components, 32 bit overflow included.
+static inline uint8x8_t apply_scale(uint8x8_t c, uint32x4_t scaleLo, uint32x4_t scaleHi) {
+    const uint16x8_t c16 = vmovl_u8(c);
+    const uint32x4_t round = vdupq_n_u32(1 << 23);
+    const uint32x4_t lo = vaddq_u32(vmulq_u32(scaleLo, vmovl_u16(vget_low_u16(c16))), round),
+                     hi = vaddq_u32(vmulq_u32(scaleHi, vmovl_u16(vget_high_u16(c16))), round);
+    return vmovn_u16(vcombine_u16(vmovn_u32(vshrq_n_u32(lo, 24)),
+                                  vmovn_u32(vshrq_n_u32(hi, 24))));
+}
+
+static void transform_scanline_8888_neon(const char* SK_RESTRICT src, int width,
+                                         char* SK_RESTRICT dst) {
+    const SkPMColor* SK_RESTRICT srcP = (const SkPMColor*)src;
+    const SkUnPreMultiply::Scale* SK_RESTRICT table = SkUnPreMultiply::GetScaleTable();
+
+    int x = 0;
+    for (; x + 8 <= width; x += 8) {
+        const uint8x8x4_t px = vld4_u8((const uint8_t*)(srcP + x));
+        uint8x8x4_t rgba;
+        rgba.val[0] = px.val[SK_R32_SHIFT/8];
+        rgba.val[1] = px.val[SK_G32_SHIFT/8];
+        rgba.val[2] = px.val[SK_B32_SHIFT/8];
+        rgba.val[3] = px.val[SK_A32_SHIFT/8];
+
+        // Like the portable version, pixels with alpha of 0 or 255 pass through unscaled.
+        const uint8x8_t keep = vorr_u8(vceq_u8(rgba.val[3], vdup_n_u8(0)),
+                                       vceq_u8(rgba.val[3], vdup_n_u8(0xFF)));
+        if (vget_lane_u64(vreinterpret_u64_u8(keep), 0) != ~(uint64_t)0) {
+            uint32_t scales[8];
+            for (int i = 0; i < 8; i++) {
+                scales[i] = table[SkGetPackedA32(srcP[x + i])];
+            }
+            const uint32x4_t scaleLo = vld1q_u32(scales),
+                             scaleHi = vld1q_u32(scales + 4);
+            for (int i = 0; i < 3; i++) {
+                rgba.val[i] = vbsl_u8(keep, rgba.val[i],
+                                      apply_scale(rgba.val[i], scaleLo, scaleHi));
+            }
+        }
+        vst4_u8((uint8_t*)dst + 4*x, rgba);
+    }
+
+    dst += 4*x;
+    for (; x < width; x++) {
+        SkPMColor c = srcP[x];
+        unsigned a = SkGetPackedA32(c);
+        unsigned r = SkGetPackedR32(c);
+        unsigned g = SkGetPackedG32(c);
+        unsigned b = SkGetPackedB32(c);
+
+        if (0 != a && 255 != a) {
+            SkUnPreMultiply::Scale scale = table[a];
+            r = SkUnPreMultiply::ApplyScale(scale, r);
+            g = SkUnPreMultiply::ApplyScale(scale, g);
+            b = SkUnPreMultiply::ApplyScale(scale, b);
+        }
+        *dst++ = r;
+        *dst++ = g;
+        *dst++ = b;
+        *dst++ = a;
+    }
+}
+
+static void transform_scanline_888_neon(const char* SK_RESTRICT src, int width,
+                                        char* SK_RESTRICT dst) {
+    const SkPMColor* SK_RESTRICT srcP = (const SkPMColor*)src;
+
+    int x = 0;
+    for (; x + 8 <= width; x += 8) {
+        const uint8x8x4_t px = vld4_u8((const uint8_t*)(srcP + x));
+        uint8x8x3_t rgb;
+        rgb.val[0] = px.val[SK_R32_SHIFT/8];
+        rgb.val[1] = px.val[SK_G32_SHIFT/8];
+        rgb.val[2] = px.val[SK_B32_SHIFT/8];
+        vst3_u8((uint8_t*)dst + 3*x, rgb);
+    }
+
+    dst += 3*x;
+    for (; x < width; x++) {
+        SkPMColor c = srcP[x];
+        *dst++ = SkGetPackedR32(c);
+        *dst++ = SkGetPackedG32(c);
+        *dst++ = SkGetPackedB32(c);
+    }
+}
+
+}  // namespace
+
+SkTransformScanlineProc SkTransformScanlineGetPlatformProc_neon(SkTransformScanlineProcType type) {
+    switch (type) {
+        case kN32_To_RGB_SkTransformScanlineProcType:
+            return transform_scanline_888_neon;
+        case kN32_To_RGBA_Unpremul_SkTransformScanlineProcType:
+            return transform_scanline_8888_neon;
+        default:
+            return NULL;
+    }
+}
@@ -0,0 +1,15 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkTransformScanline_opts_neon_DEFINED
+#define SkTransformScanline_opts_neon_DEFINED
+
+#include "SkTransformScanline_opts.h"
+
+SkTransformScanlineProc SkTransformScanlineGetPlatformProc_neon(SkTransformScanlineProcType);
+
+#endif
@@ -19,6 +19,9 @@
 #include "SkMorphology_opts.h"
 #include "SkMorphology_opts_SSE2.h"
 #include "SkRTConf.h"
+#include "SkSwizzler_opts_SSE2.h"
+#include "SkSwizzler_opts_SSSE3.h"
+#include "SkTransformScanline_opts_SSE2.h"
 #include "SkUtils.h"
 #include "SkUtils_opts_SSE2.h"
 #include "SkXfermode.h"
@@ -357,6 +360,28 @@ SkMorphologyImageFilter::Proc SkMorphologyGetPlatformProc(SkMorphologyProcType t
 
 ////////////////////////////////////////////////////////////////////////////////
 
+SkSwizzleRowProc SkSwizzleGetPlatformProc(SkSwizzleProcType type) {
+    SkSwizzleRowProc proc = NULL;
+    if (supports_simd(SK_CPU_SSE_LEVEL_SSSE3)) {
+        proc = SkSwizzleGetPlatformProc_SSSE3(type);
+    }
+    if (NULL == proc && supports_simd(SK_CPU_SSE_LEVEL_SSE2)) {
+        proc = SkSwizzleGetPlatformProc_SSE2(type);
+    }
+    return proc;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+SkTransformScanlineProc SkTransformScanlineGetPlatformProc(SkTransformScanlineProcType type) {
+    if (supports_simd(SK_CPU_SSE_LEVEL_SSE2)) {
+        return SkTransformScanlineGetPlatformProc_SSE2(type);
+    }
+    return NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 bool SkBoxBlurGetPlatformProcs(SkBoxBlurProc* boxBlurX,
                                SkBoxBlurProc* boxBlurY,
                                SkBoxBlurProc* boxBlurXY,
@@ -5,10 +5,12 @@
  * found in the LICENSE file.
  */
 
+#include "SkBitmapContent.h"
 #include "SkColorPriv.h"
 #include "SkFlate.h"
 #include "SkPDFBitmap.h"
 #include "SkPDFCanon.h"
+#include "SkResourceCache.h"
 #include "SkStream.h"
 #include "SkUnPreMultiply.h"
 
@@ -237,6 +239,102 @@ static void bitmap_alpha_to_a8(const SkBitmap& bitmap, SkWStream* out) {
 
 ////////////////////////////////////////////////////////////////////////////////
 
+namespace {
+static unsigned gPDFDeflateKeyNamespaceLabel;
+
+// Identifies the deflated PDF pixels (or alpha) of a bitmap by one of its content hashes.
+// PDFDeflateRec keeps the other as a digest to check hits against, rather than the source
+// bitmap, whose pixels it would otherwise keep resident.
+struct PDFDeflateKey : public SkResourceCache::Key {
+    PDFDeflateKey(const SkBitmapContentHash& hash, bool alpha, int level)
+        : fHash(hash.fHash[0])
+        , fAlpha(alpha)
+        , fLevel(level) {
+        this->init(&gPDFDeflateKeyNamespaceLabel, 0,
+                   sizeof(*this) - sizeof(SkResourceCache::Key));
+    }
+
+    uint32_t fHash;
+    int32_t  fAlpha;
+    int32_t  fLevel;
+};
+
+struct PDFDeflateRec : public SkResourceCache::Rec {
+    PDFDeflateRec(const SkBitmapContentHash& hash, bool alpha, int level, SkData* data)
+        : fKey(hash, alpha, level), fDigest(hash.fHash[1]), fData(SkRef(data)) {}
+
+    PDFDeflateKey        fKey;
+    uint32_t             fDigest;
+    SkAutoTUnref<SkData> fData;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return sizeof(*this) + fData->size(); }
+
+    struct Context {
+        uint32_t fDigest;
+        SkData*  fData;  // Ref'd only if the digest matches.
+    };
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextPtr) {
+        const PDFDeflateRec& rec = static_cast<const PDFDeflateRec&>(baseRec);
+        Context* context = static_cast<Context*>(contextPtr);
+        if (rec.fDigest != context->fDigest) {
+            return false;
+        }
+        context->fData = SkRef(rec.fData.get());
+        return true;
+    }
+};
+}  // namespace
+
+// Returns the bitmap's pixels, or just its alpha, as PDF wants them, deflated.
+static SkData* deflate_pixels(const SkBitmap& bitmap, bool alpha, int level) {
+    SkDynamicMemoryWStream buffer;
+    SkDeflateWStream deflateWStream(&buffer, level);
+    if (alpha) {
+        bitmap_alpha_to_a8(bitmap, &deflateWStream);
+    } else {
+        bitmap_to_pdf_pixels(bitmap, &deflateWStream);
+    }
+    deflateWStream.finalize();  // call before copyToData().
+    return buffer.copyToData();
+}
+
+// Looks up a bitmap's deflated pixels in the process-wide cache; NULL on a miss, including a
+// collision with another image's hash, which its digest tells apart.
+static SkData* find_deflated(const SkBitmapContentHash& hash, bool alpha, int level) {
+    PDFDeflateRec::Context context;
+    context.fDigest = hash.fHash[1];
+    if (!SkResourceCache::Find(PDFDeflateKey(hash, alpha, level),
+                               PDFDeflateRec::Visitor, &context)) {
+        return NULL;
+    }
+    return context.fData;
+}
+
+// Like deflate_pixels(), but uses and fills the process-wide cache.
+static SkData* deflate_bitmap(const SkBitmap& bitmap, bool alpha, int level) {
+    SkAutoLockPixels autoLockPixels(bitmap);
+    SkBitmapContentHash hash;
+    if (!bitmap.isImmutable() || !SkBitmapContentHash::Compute(bitmap, &hash)) {
+        return deflate_pixels(bitmap, alpha, level);
+    }
+    if (SkData* data = find_deflated(hash, alpha, level)) {
+        return data;
+    }
+    SkData* data = deflate_pixels(bitmap, alpha, level);
+    SkResourceCache::Add(SkNEW_ARGS(PDFDeflateRec, (hash, alpha, level, data)));
+    return data;
+}
+
+SkData* SkPDFBitmap::FindDeflated(const SkBitmap& bitmap, int level) {
+    SkBitmapContentHash hash;
+    return SkBitmapContentHash::Compute(bitmap, &hash) ? find_deflated(hash, false, level)
+                                                       : NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 namespace {
 // This SkPDFObject only outputs the alpha layer of the given bitmap.
 class PDFAlphaBitmap : public SkPDFObject {
@@ -246,24 +344,27 @@ public:
     void emitObject(SkWStream*,
                     const SkPDFObjNumMap&,
                     const SkPDFSubstituteMap&) override;
+    void drop() override {
+        fBitmap.reset();
+        fDeflated.reset(NULL);
+    }
+    void compress(int level) override {
+        if (!fDeflated) {
+            fDeflated.reset(deflate_bitmap(fBitmap, true, level));
+        }
+    }
 
 private:
-    const SkBitmap fBitmap;
+    SkBitmap fBitmap;
+    SkAutoTUnref<SkData> fDeflated;
 };
 
 void PDFAlphaBitmap::emitObject(SkWStream* stream,
                                 const SkPDFObjNumMap& objNumMap,
                                 const SkPDFSubstituteMap& substitutes) {
-    SkAutoLockPixels autoLockPixels(fBitmap);
     SkASSERT(fBitmap.colorType() != kIndex_8_SkColorType ||
              fBitmap.getColorTable());
-
-    // Write to a temporary buffer to get the compressed length.
-    SkDynamicMemoryWStream buffer;
-    SkDeflateWStream deflateWStream(&buffer);
-    bitmap_alpha_to_a8(fBitmap, &deflateWStream);
-    deflateWStream.finalize();  // call before detachAsStream().
-    SkAutoTDelete<SkStreamAsset> asset(buffer.detachAsStream());
+    this->compress(SkFlate::kDefaultLevel);
 
     SkPDFDict pdfDict("XObject");
     pdfDict.insertName("Subtype", "Image");
@@ -272,11 +373,11 @@ void PDFAlphaBitmap::emitObject(SkWStream* stream,
     pdfDict.insertName("ColorSpace", "DeviceGray");
     pdfDict.insertInt("BitsPerComponent", 8);
     pdfDict.insertName("Filter", "FlateDecode");
-    pdfDict.insertInt("Length", asset->getLength());
+    pdfDict.insertInt("Length", fDeflated->size());
     pdfDict.emitObject(stream, objNumMap, substitutes);
 
     pdf_stream_begin(stream);
-    stream->writeStream(asset.get(), asset->getLength());
+    stream->write(fDeflated->data(), fDeflated->size());
     pdf_stream_end(stream);
 }
 }  // namespace
@@ -327,16 +428,9 @@ static SkPDFArray* make_indexed_color_space(const SkColorTable* table) {
 void SkPDFBitmap::emitObject(SkWStream* stream,
                              const SkPDFObjNumMap& objNumMap,
                              const SkPDFSubstituteMap& substitutes) {
-    SkAutoLockPixels autoLockPixels(fBitmap);
     SkASSERT(fBitmap.colorType() != kIndex_8_SkColorType ||
              fBitmap.getColorTable());
-
-    // Write to a temporary buffer to get the compressed length.
-    SkDynamicMemoryWStream buffer;
-    SkDeflateWStream deflateWStream(&buffer);
-    bitmap_to_pdf_pixels(fBitmap, &deflateWStream);
-    deflateWStream.finalize();  // call before detachAsStream().
-    SkAutoTDelete<SkStreamAsset> asset(buffer.detachAsStream());
+    this->compress(SkFlate::kDefaultLevel);
 
     SkPDFDict pdfDict("XObject");
     pdfDict.insertName("Subtype", "Image");
@@ -356,17 +450,27 @@ void SkPDFBitmap::emitObject(SkWStream* stream,
         pdfDict.insert("SMask", new SkPDFObjRef(fSMask))->unref();
     }
     pdfDict.insertName("Filter", "FlateDecode");
-    pdfDict.insertInt("Length", asset->getLength());
+    pdfDict.insertInt("Length", fDeflated->size());
     pdfDict.emitObject(stream, objNumMap,substitutes);
 
     pdf_stream_begin(stream);
-    stream->writeStream(asset.get(), asset->getLength());
+    stream->write(fDeflated->data(), fDeflated->size());
     pdf_stream_end(stream);
 }
 
+void SkPDFBitmap::compress(int level) {
+    if (!fDeflated) {
+        fDeflated.reset(deflate_bitmap(fBitmap, false, level));
+    }
+}
+
 SkPDFBitmap::SkPDFBitmap(const SkBitmap& bm,
                          SkPDFObject* smask)
-    : fBitmap(bm), fSMask(smask) {}
+    : fBitmap(bm)
+    , fSMask(smask)
+    , fGenerationID(bm.getGenerationID())
+    , fPixelRefOrigin(bm.pixelRefOrigin())
+    , fDimensions(bm.dimensions()) {}
 
 SkPDFBitmap::~SkPDFBitmap() {}
 
@@ -399,7 +503,7 @@ SkPDFBitmap* SkPDFBitmap::Create(SkPDFCanon* canon, const SkBitmap& bitmap) {
     if (!bm.isOpaque() && !SkBitmap::ComputeIsOpaque(bm)) {
         smask = SkNEW_ARGS(PDFAlphaBitmap, (bm));
     }
-    SkPDFBitmap* pdfBitmap = SkNEW_ARGS(SkPDFBitmap, (bm, smask));
-    canon->addBitmap(pdfBitmap);
-    return pdfBitmap;
+    SkAutoTUnref<SkPDFBitmap> pdfBitmap(SkNEW_ARGS(SkPDFBitmap, (bm, smask)));
+    // Another thread may have added an equal bitmap while we made this one.
+    return SkRef(canon->addBitmap(pdfBitmap));
 }
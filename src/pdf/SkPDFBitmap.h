@@ -9,6 +9,7 @@
 
 #include "SkPDFTypes.h"
 #include "SkBitmap.h"
+#include "SkData.h"
 
 class SkPDFCanon;
 
@@ -20,27 +21,48 @@ class SkPDFCanon;
  * If !bitmap.isImmutable(), then a copy of the bitmap must be made;
  * there is no way around this.
  *
+ * Compressed pixels are cached process-wide by their content, so an image
+ * drawn into many documents is only compressed once.  Cache entries keep a
+ * ref on their source pixels, which are compared before an entry is reused.
+ *
  * The SkPDFBitmap::Create function will check the canon for duplicates.
  */
 class SkPDFBitmap : public SkPDFObject {
 public:
     // Returns NULL on unsupported bitmap;
     static SkPDFBitmap* Create(SkPDFCanon*, const SkBitmap&);
+    // Returns the cached, deflated pixels of an immutable bitmap, or NULL.  For testing.
+    static SkData* FindDeflated(const SkBitmap&, int level);
     ~SkPDFBitmap();
     void emitObject(SkWStream*,
                     const SkPDFObjNumMap& objNumMap,
                     const SkPDFSubstituteMap& substitutes) override;
     void addResources(SkPDFObjNumMap*,
                       const SkPDFSubstituteMap&) const override;
+    void drop() override {
+        fBitmap.reset();
+        fDeflated.reset(NULL);
+    }
+    void compress(int level) override;
     bool equals(const SkBitmap& other) const {
-        return fBitmap.getGenerationID() == other.getGenerationID() &&
-               fBitmap.pixelRefOrigin() == other.pixelRefOrigin() &&
-               fBitmap.dimensions() == other.dimensions();
+        return fGenerationID == other.getGenerationID() &&
+               fPixelRefOrigin == other.pixelRefOrigin() &&
+               fDimensions == other.dimensions();
+    }
+    bool equals(const SkPDFBitmap& other) const {
+        return fGenerationID == other.fGenerationID &&
+               fPixelRefOrigin == other.fPixelRefOrigin &&
+               fDimensions == other.fDimensions;
     }
 
 private:
-    const SkBitmap fBitmap;
+    SkBitmap fBitmap;  // Empty once dropped.
     const SkAutoTUnref<SkPDFObject> fSMask;
+    SkAutoTUnref<SkData> fDeflated;  // Set by compress().
+    // Copied out of fBitmap, so we can still be found in the canon after drop().
+    const uint32_t fGenerationID;
+    const SkIPoint fPixelRefOrigin;
+    const SkISize fDimensions;
     SkPDFBitmap(const SkBitmap&, SkPDFObject*);
 };
 
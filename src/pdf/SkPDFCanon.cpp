@@ -13,6 +13,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 void SkPDFCanon::reset() {
+    SkAutoMutexAcquire lock(fMutex);
     for (int i = 0; i < fFontRecords.count(); ++i) {
         fFontRecords[i].fFont->unref();
     }
@@ -44,11 +45,29 @@ T* find_item(const SkTDArray<T*>& ptrArray, const U& object) {
     return NULL;
 }
 
+// requires `bool T::equals(const T&) const`
+// Refs and appends item unless an equal item is already there; returns the one kept.
+template <typename T>
+T* add_item(SkTDArray<T*>* ptrArray, T* item) {
+    if (T* canonItem = find_item(*ptrArray, *item)) {
+        return canonItem;
+    }
+    ptrArray->push(SkRef(item));
+    return item;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 SkPDFFont* SkPDFCanon::findFont(uint32_t fontID,
                                 uint16_t glyphID,
                                 SkPDFFont** relatedFontPtr) const {
+    SkAutoMutexAcquire lock(fMutex);
+    return this->findFontLocked(fontID, glyphID, relatedFontPtr);
+}
+
+SkPDFFont* SkPDFCanon::findFontLocked(uint32_t fontID,
+                                      uint16_t glyphID,
+                                      SkPDFFont** relatedFontPtr) const {
     SkASSERT(relatedFontPtr);
 
     SkPDFFont* relatedFont = NULL;
@@ -66,65 +85,83 @@ SkPDFFont* SkPDFCanon::findFont(uint32_t fontID,
     return NULL;
 }
 
-void SkPDFCanon::addFont(SkPDFFont* font, uint32_t fontID, uint16_t fGlyphID) {
+SkPDFFont* SkPDFCanon::addFont(SkPDFFont* font, uint32_t fontID, uint16_t fGlyphID) {
+    SkAutoMutexAcquire lock(fMutex);
+    SkPDFFont* relatedFont;
+    if (SkPDFFont* canonFont = this->findFontLocked(fontID, fGlyphID, &relatedFont)) {
+        return canonFont;
+    }
     SkPDFCanon::FontRec* rec = fFontRecords.push();
     rec->fFont = SkRef(font);
     rec->fFontID = fontID;
     rec->fGlyphID = fGlyphID;
+    return font;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 SkPDFFunctionShader* SkPDFCanon::findFunctionShader(
         const SkPDFShader::State& state) const {
+    SkAutoMutexAcquire lock(fMutex);
     return find_item(fFunctionShaderRecords, state);
 }
-void SkPDFCanon::addFunctionShader(SkPDFFunctionShader* pdfShader) {
-    fFunctionShaderRecords.push(SkRef(pdfShader));
+SkPDFFunctionShader* SkPDFCanon::addFunctionShader(SkPDFFunctionShader* pdfShader) {
+    SkAutoMutexAcquire lock(fMutex);
+    return add_item(&fFunctionShaderRecords, pdfShader);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 SkPDFAlphaFunctionShader* SkPDFCanon::findAlphaShader(
         const SkPDFShader::State& state) const {
+    SkAutoMutexAcquire lock(fMutex);
     return find_item(fAlphaShaderRecords, state);
 }
-void SkPDFCanon::addAlphaShader(SkPDFAlphaFunctionShader* pdfShader) {
-    fAlphaShaderRecords.push(SkRef(pdfShader));
+SkPDFAlphaFunctionShader* SkPDFCanon::addAlphaShader(SkPDFAlphaFunctionShader* pdfShader) {
+    SkAutoMutexAcquire lock(fMutex);
+    return add_item(&fAlphaShaderRecords, pdfShader);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 SkPDFImageShader* SkPDFCanon::findImageShader(
         const SkPDFShader::State& state) const {
+    SkAutoMutexAcquire lock(fMutex);
     return find_item(fImageShaderRecords, state);
 }
 
-void SkPDFCanon::addImageShader(SkPDFImageShader* pdfShader) {
-    fImageShaderRecords.push(SkRef(pdfShader));
+SkPDFImageShader* SkPDFCanon::addImageShader(SkPDFImageShader* pdfShader) {
+    SkAutoMutexAcquire lock(fMutex);
+    return add_item(&fImageShaderRecords, pdfShader);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 const SkPDFGraphicState* SkPDFCanon::findGraphicState(
         const SkPDFGraphicState& key) const {
+    SkAutoMutexAcquire lock(fMutex);
     const WrapGS* ptr = fGraphicStateRecords.find(WrapGS(&key));
     return ptr ? ptr->fPtr : NULL;
 }
 
-void SkPDFCanon::addGraphicState(const SkPDFGraphicState* state) {
+const SkPDFGraphicState* SkPDFCanon::addGraphicState(const SkPDFGraphicState* state) {
     SkASSERT(state);
-    WrapGS w(SkRef(state));
-    SkASSERT(!fGraphicStateRecords.contains(w));
-    fGraphicStateRecords.add(w);
+    SkAutoMutexAcquire lock(fMutex);
+    if (const WrapGS* ptr = fGraphicStateRecords.find(WrapGS(state))) {
+        return ptr->fPtr;
+    }
+    fGraphicStateRecords.add(WrapGS(SkRef(state)));
+    return state;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 SkPDFBitmap* SkPDFCanon::findBitmap(const SkBitmap& bm) const {
+    SkAutoMutexAcquire lock(fMutex);
     return find_item(fBitmapRecords, bm);
 }
 
-void SkPDFCanon::addBitmap(SkPDFBitmap* pdfBitmap) {
-    fBitmapRecords.push(SkRef(pdfBitmap));
+SkPDFBitmap* SkPDFCanon::addBitmap(SkPDFBitmap* pdfBitmap) {
+    SkAutoMutexAcquire lock(fMutex);
+    return add_item(&fBitmapRecords, pdfBitmap);
 }
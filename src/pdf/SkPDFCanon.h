@@ -7,6 +7,7 @@
 #ifndef SkPDFCanon_DEFINED
 #define SkPDFCanon_DEFINED
 
+#include "SkMutex.h"
 #include "SkPDFGraphicState.h"
 #include "SkPDFShader.h"
 #include "SkTDArray.h"
@@ -21,17 +22,22 @@ class SkPaint;
  *  The SkPDFCanon canonicalizes objects across PDF pages(SkPDFDevices).
  *
  *  The PDF backend works correctly if:
- *  -  There is no more than one SkPDFCanon for each thread.
  *  -  Every SkPDFDevice is given a pointer to a SkPDFCanon on creation.
  *  -  All SkPDFDevices in a document share the same SkPDFCanon.
  *  The SkDocument_PDF class makes this happen by owning a single
  *  SkPDFCanon.
  *
- *  The addFoo() methods will ref the Foo; the canon's destructor will
- *  call foo->unref() on all of these objects.
+ *  The canon is thread safe, so the pages of one document may be drawn
+ *  on different threads.  Two threads may race to create equal objects
+ *  after both failing to find them; the addFoo() methods then keep the
+ *  first one added and return it, and the loser should use that instead
+ *  of its own, so every document still shares a single copy.
  *
- *  The findFoo() methods do not change the ref count of the Foo
- *  objects.
+ *  The addFoo() methods will ref the Foo they keep; the canon's
+ *  destructor will call foo->unref() on all of these objects.
+ *
+ *  The findFoo() and addFoo() methods do not change the ref count of the
+ *  Foo objects they return.
  */
 class SkPDFCanon : SkNoncopyable {
 public:
@@ -46,24 +52,31 @@ public:
     SkPDFFont* findFont(uint32_t fontID,
                         uint16_t glyphID,
                         SkPDFFont** relatedFont) const;
-    void addFont(SkPDFFont* font, uint32_t fontID, uint16_t fGlyphID);
+    SkPDFFont* addFont(SkPDFFont* font, uint32_t fontID, uint16_t fGlyphID);
 
     SkPDFFunctionShader* findFunctionShader(const SkPDFShader::State&) const;
-    void addFunctionShader(SkPDFFunctionShader*);
+    SkPDFFunctionShader* addFunctionShader(SkPDFFunctionShader*);
 
     SkPDFAlphaFunctionShader* findAlphaShader(const SkPDFShader::State&) const;
-    void addAlphaShader(SkPDFAlphaFunctionShader*);
+    SkPDFAlphaFunctionShader* addAlphaShader(SkPDFAlphaFunctionShader*);
 
     SkPDFImageShader* findImageShader(const SkPDFShader::State&) const;
-    void addImageShader(SkPDFImageShader*);
+    SkPDFImageShader* addImageShader(SkPDFImageShader*);
 
     const SkPDFGraphicState* findGraphicState(const SkPDFGraphicState&) const;
-    void addGraphicState(const SkPDFGraphicState*);
+    const SkPDFGraphicState* addGraphicState(const SkPDFGraphicState*);
 
     SkPDFBitmap* findBitmap(const SkBitmap&) const;
-    void addBitmap(SkPDFBitmap*);
+    SkPDFBitmap* addBitmap(SkPDFBitmap*);
 
 private:
+    // Guards all the records below.
+    mutable SkMutex fMutex;
+
+    SkPDFFont* findFontLocked(uint32_t fontID,
+                              uint16_t glyphID,
+                              SkPDFFont** relatedFont) const;
+
     struct FontRec {
         SkPDFFont* fFont;
         uint32_t fFontID;
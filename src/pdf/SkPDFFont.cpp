@@ -851,10 +851,10 @@ SkPDFFont* SkPDFFont::GetFontResource(SkPDFCanon* canon,
 #endif
     }
 
-    SkPDFFont* font = SkPDFFont::Create(canon, fontMetrics.get(), typeface,
-                                        glyphID, relatedFontDescriptor);
-    canon->addFont(font, fontID, font->fFirstGlyphID);
-    return font;
+    SkAutoTUnref<SkPDFFont> font(SkPDFFont::Create(canon, fontMetrics.get(), typeface,
+                                                   glyphID, relatedFontDescriptor));
+    // Another thread may have added an equal font while we made this one.
+    return SkRef(canon->addFont(font, fontID, font->fFirstGlyphID));
 }
 
 SkPDFFont* SkPDFFont::getFontSubset(const SkPDFGlyphSet*) {
@@ -121,9 +121,10 @@ SkPDFGraphicState* SkPDFGraphicState::GetGraphicStateForPaint(
         // here on out.
         return SkRef(const_cast<SkPDFGraphicState*>(canonGS));
     }
-    SkPDFGraphicState* pdfGraphicState = new SkPDFGraphicState(paint);
-    canon->addGraphicState(pdfGraphicState);
-    return pdfGraphicState;
+    SkAutoTUnref<SkPDFGraphicState> pdfGraphicState(new SkPDFGraphicState(paint));
+    // Another thread may have added an equal state while we made this one.
+    const SkPDFGraphicState* canonGS = canon->addGraphicState(pdfGraphicState);
+    return SkRef(const_cast<SkPDFGraphicState*>(canonGS));
 }
 
 namespace {
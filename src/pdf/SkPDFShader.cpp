@@ -679,8 +679,8 @@ SkPDFAlphaFunctionShader* SkPDFAlphaFunctionShader::Create(
     SkAutoTUnref<SkPDFObject> alphaGs(
             create_smask_graphic_state(canon, dpi, state));
 
-    SkPDFAlphaFunctionShader* alphaFunctionShader =
-            SkNEW_ARGS(SkPDFAlphaFunctionShader, (autoState->detach()));
+    SkAutoTUnref<SkPDFAlphaFunctionShader> alphaFunctionShader(
+            SkNEW_ARGS(SkPDFAlphaFunctionShader, (autoState->detach())));
 
     SkAutoTUnref<SkPDFResourceDict> resourceDict(
             get_gradient_resource_dict(colorShader.get(), alphaGs.get()));
@@ -691,8 +691,8 @@ SkPDFAlphaFunctionShader* SkPDFAlphaFunctionShader::Create(
 
     populate_tiling_pattern_dict(alphaFunctionShader, bbox, resourceDict.get(),
                                  SkMatrix::I());
-    canon->addAlphaShader(alphaFunctionShader);
-    return alphaFunctionShader;
+    // Another thread may have added an equal shader while we made this one.
+    return SkRef(canon->addAlphaShader(alphaFunctionShader));
 }
 
 // Finds affine and persp such that in = affine * persp.
@@ -883,15 +883,15 @@ SkPDFFunctionShader* SkPDFFunctionShader::Create(
     SkAutoTUnref<SkPDFArray> matrixArray(
             SkPDFUtils::MatrixToArray(finalMatrix));
 
-    SkPDFFunctionShader* pdfFunctionShader =
-            SkNEW_ARGS(SkPDFFunctionShader, (autoState->detach()));
+    SkAutoTUnref<SkPDFFunctionShader> pdfFunctionShader(
+            SkNEW_ARGS(SkPDFFunctionShader, (autoState->detach())));
 
     pdfFunctionShader->insertInt("PatternType", 2);
     pdfFunctionShader->insert("Matrix", matrixArray.get());
     pdfFunctionShader->insert("Shading", pdfShader.get());
 
-    canon->addFunctionShader(pdfFunctionShader);
-    return pdfFunctionShader;
+    // Another thread may have added an equal shader while we made this one.
+    return SkRef(canon->addFunctionShader(pdfFunctionShader));
 }
 
 SkPDFImageShader* SkPDFImageShader::Create(
@@ -1096,8 +1096,8 @@ SkPDFImageShader* SkPDFImageShader::Create(
     // Put the canvas into the pattern stream (fContent).
     SkAutoTDelete<SkStreamAsset> content(patternDevice->content());
 
-    SkPDFImageShader* imageShader =
-            SkNEW_ARGS(SkPDFImageShader, (autoState->detach()));
+    SkAutoTUnref<SkPDFImageShader> imageShader(
+            SkNEW_ARGS(SkPDFImageShader, (autoState->detach())));
     imageShader->setData(content.get());
 
     SkAutoTUnref<SkPDFResourceDict> resourceDict(
@@ -1107,8 +1107,8 @@ SkPDFImageShader* SkPDFImageShader::Create(
 
     imageShader->fShaderState->fImage.unlockPixels();
 
-    canon->addImageShader(imageShader);
-    return imageShader;
+    // Another thread may have added an equal shader while we made this one.
+    return SkRef(canon->addImageShader(imageShader));
 }
 
 bool SkPDFShader::State::operator==(const SkPDFShader::State& b) const {
@@ -59,6 +59,7 @@ public:
                                        SkAutoTDelete<SkPDFShader::State>*);
     virtual ~SkPDFFunctionShader();
     bool equals(const SkPDFShader::State&) const;
+    bool equals(const SkPDFFunctionShader& other) const { return this->equals(*other.fShaderState); }
 
 private:
     SkAutoTDelete<const SkPDFShader::State> fShaderState;
@@ -78,6 +79,7 @@ public:
                                             SkAutoTDelete<SkPDFShader::State>*);
     virtual ~SkPDFAlphaFunctionShader();
     bool equals(const SkPDFShader::State&) const;
+    bool equals(const SkPDFAlphaFunctionShader& other) const { return this->equals(*other.fShaderState); }
 
 private:
     SkAutoTDelete<const SkPDFShader::State> fShaderState;
@@ -92,6 +94,7 @@ public:
                                     SkAutoTDelete<SkPDFShader::State>*);
     virtual ~SkPDFImageShader();
     bool equals(const SkPDFShader::State&) const;
+    bool equals(const SkPDFImageShader& other) const { return this->equals(*other.fShaderState); }
 
 private:
     SkAutoTDelete<const SkPDFShader::State> fShaderState;
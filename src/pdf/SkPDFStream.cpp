@@ -23,15 +23,13 @@ SkPDFStream::SkPDFStream(SkData* data) : fState(kUnused_State) {
 
 SkPDFStream::~SkPDFStream() {}
 
-void SkPDFStream::emitObject(SkWStream* stream,
-                             const SkPDFObjNumMap& objNumMap,
-                             const SkPDFSubstituteMap& substitutes) {
+void SkPDFStream::compress(int level) {
     if (fState == kUnused_State) {
         fState = kNoCompression_State;
         SkDynamicMemoryWStream compressedData;
 
         SkAssertResult(
-                SkFlate::Deflate(fDataStream.get(), &compressedData));
+                SkFlate::Deflate(fDataStream.get(), &compressedData, level));
         SkAssertResult(fDataStream->rewind());
         if (compressedData.getOffset() < this->dataSize()) {
             SkAutoTDelete<SkStream> compressed(
@@ -42,6 +40,12 @@ void SkPDFStream::emitObject(SkWStream* stream,
         fState = kCompressed_State;
         this->insertInt("Length", this->dataSize());
     }
+}
+
+void SkPDFStream::emitObject(SkWStream* stream,
+                             const SkPDFObjNumMap& objNumMap,
+                             const SkPDFSubstituteMap& substitutes) {
+    this->compress(SkFlate::kDefaultLevel);
     this->INHERITED::emitObject(stream, objNumMap, substitutes);
     stream->writeText(" stream\n");
     stream->writeStream(fDataStream.get(), fDataStream->getLength());
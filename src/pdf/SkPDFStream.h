@@ -43,6 +43,7 @@ public:
     virtual void emitObject(SkWStream* stream,
                             const SkPDFObjNumMap& objNumMap,
                             const SkPDFSubstituteMap& substitutes) override;
+    void compress(int level) override;
 
 protected:
     enum State {
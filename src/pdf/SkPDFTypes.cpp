@@ -404,17 +404,51 @@ SkPDFObject* SkPDFSubstituteMap::getSubstitute(SkPDFObject* object) const {
 ////////////////////////////////////////////////////////////////////////////////
 
 bool SkPDFObjNumMap::addObject(SkPDFObject* obj) {
-    if (fObjectNumbers.find(obj)) {
+    int32_t* objectNumberFound = fObjectNumbers.find(obj);
+    if (objectNumberFound && *objectNumberFound > 0) {
         return false;
     }
-    fObjectNumbers.set(obj, fObjectNumbers.count() + 1);
     fObjects.push(obj);
+    fObjectNumbers.set(obj, this->objectCount());
     return true;
 }
 
 int32_t SkPDFObjNumMap::getObjectNumber(SkPDFObject* obj) const {
     int32_t* objectNumberFound = fObjectNumbers.find(obj);
-    SkASSERT(objectNumberFound);
+    SkASSERT(objectNumberFound && *objectNumberFound > 0);
     return *objectNumberFound;
 }
 
+void SkPDFObjNumMap::forgetObject(SkPDFObject* obj) {
+    int32_t* objectNumberFound = fObjectNumbers.find(obj);
+    SkASSERT(objectNumberFound && *objectNumberFound > 0);
+    const int index = *objectNumberFound - this->firstObjectNumber();
+    if (index >= 0) {
+        fObjects[index] = NULL;
+    }
+    // SkTHashMap can't remove entries, so 0 marks an object as forgotten, and
+    // once those outnumber the rest, the map is rebuilt without them.
+    *objectNumberFound = 0;
+    fForgottenCount++;
+    if (fForgottenCount <= fObjectNumbers.count() - fForgottenCount) {
+        return;
+    }
+    SkTDArray<SkPDFObject*> objects;
+    SkTDArray<int32_t> numbers;
+    fObjectNumbers.foreach([&objects, &numbers](SkPDFObject* o, int32_t* n) {
+        if (*n > 0) {
+            objects.push(o);
+            numbers.push(*n);
+        }
+    });
+    fObjectNumbers.reset();
+    for (int i = 0; i < objects.count(); i++) {
+        fObjectNumbers.set(objects[i], numbers[i]);
+    }
+    fForgottenCount = 0;
+}
+
+void SkPDFObjNumMap::trimObjects() {
+    fTrimmedCount += fObjects.count();
+    fObjects.rewind();
+}
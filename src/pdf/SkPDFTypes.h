@@ -51,6 +51,21 @@ public:
     virtual void addResources(SkPDFObjNumMap* catalog,
                               const SkPDFSubstituteMap& substitutes) const {}
 
+    /**
+     *  Called by streaming output once this object has been written, as
+     *  it will not be written again.  Subclasses may free whatever they
+     *  only kept for emitObject(), but must keep comparing equal to the
+     *  same things, as the canon may still hand them out.
+     */
+    virtual void drop() {}
+
+    /**
+     *  Does ahead of time any compression emitObject() would otherwise do,
+     *  at the given SkFlate level.  The document calls this for many
+     *  objects at once on SkTaskGroup threads, then writes them in order.
+     */
+    virtual void compress(int level) {}
+
 private:
     typedef SkRefCnt INHERITED;
 };
@@ -418,6 +433,8 @@ private:
 */
 class SkPDFObjNumMap : SkNoncopyable {
 public:
+    SkPDFObjNumMap() : fTrimmedCount(0), fForgottenCount(0) {}
+
     /** Add the passed object to the catalog.
      *  @param obj         The object to add.
      *  @return True iff the object was not already added to the catalog.
@@ -429,11 +446,35 @@ public:
      */
     int32_t getObjectNumber(SkPDFObject* obj) const;
 
+    /** Forget the passed object, which has already been written out and is
+     *  about to be freed, so a new object at the same address is given a
+     *  new number.  The forgotten object's number is never reused, and its
+     *  slot in objects(), if it still has one, becomes NULL.
+     *  @param obj         The object to forget.
+     */
+    void forgetObject(SkPDFObject* obj);
+
+    /** Drop the objects numbered so far from objects(), which then starts
+     *  with the next object added.  Their numbers stay valid.  Streaming
+     *  output calls this once it has written them, so that the map only
+     *  grows with the objects still alive.
+     */
+    void trimObjects();
+
+    /** The objects numbered since the last trimObjects(), the first of
+     *  which has object number firstObjectNumber().
+     */
     const SkTDArray<SkPDFObject*>& objects() const { return fObjects; }
+    int32_t firstObjectNumber() const { return fTrimmedCount + 1; }
+
+    /** The number of object numbers handed out so far. */
+    int32_t objectCount() const { return fTrimmedCount + fObjects.count(); }
 
 private:
     SkTDArray<SkPDFObject*> fObjects;
-    SkTHashMap<SkPDFObject*, int32_t> fObjectNumbers;
+    SkTHashMap<SkPDFObject*, int32_t> fObjectNumbers;  // 0 for forgotten objects.
+    int32_t fTrimmedCount;
+    int fForgottenCount;
 };
 
 #endif
@@ -0,0 +1,241 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkCanvasPriv.h"
+#include "SkPath.h"
+#include "SkScan.h"
+#include "SkTDArray.h"
+#include "Test.h"
+
+static const int kW = 64, kH = 64;
+
+// Analytic coverage is exact but for float rounding, so it should be within this much of the
+// true coverage wherever that is known.
+static const int kTolerance = 2;
+
+// Draws path into a fresh A8 bitmap, with analytic AA or supersampling.
+static void draw(const SkPath& path, bool analytic, SkBitmap* bm,
+                 const SkRect* clip = NULL, int w = kW, int h = kH) {
+    bm->allocPixels(SkImageInfo::MakeA8(w, h));
+    bm->eraseColor(SK_ColorTRANSPARENT);
+
+    SkCanvas canvas(*bm);
+    SkCanvasPriv::SetScanFlags(&canvas, analytic ? SkScan::kAnalyticAA_PathFlag : 0);
+    if (clip) {
+        canvas.clipRect(*clip);
+    }
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    canvas.drawPath(path, paint);
+}
+
+static int total_alpha(const SkBitmap& bm) {
+    int sum = 0;
+    for (int y = 0; y < bm.height(); y++) {
+        for (int x = 0; x < bm.width(); x++) {
+            sum += *bm.getAddr8(x, y);
+        }
+    }
+    return sum;
+}
+
+static int max_diff(const SkBitmap& a, const SkBitmap& b) {
+    int diff = 0;
+    for (int y = 0; y < a.height(); y++) {
+        for (int x = 0; x < a.width(); x++) {
+            diff = SkTMax(diff, SkAbs32(*a.getAddr8(x, y) - *b.getAddr8(x, y)));
+        }
+    }
+    return diff;
+}
+
+// Supersampling only has 16 samples per pixel, so along edges it can be off by a few of them.
+// It's only exact well away from edges, where its 3x3 neighbourhood is all clear or all opaque.
+static int max_diff_away_from_edges(const SkBitmap& analytic, const SkBitmap& supersampled) {
+    int diff = 0;
+    for (int y = 1; y < supersampled.height() - 1; y++) {
+        for (int x = 1; x < supersampled.width() - 1; x++) {
+            const uint8_t center = *supersampled.getAddr8(x, y);
+            if (0x00 != center && 0xFF != center) {
+                continue;
+            }
+            bool uniform = true;
+            for (int dy = -1; dy <= 1; dy++) {
+                for (int dx = -1; dx <= 1; dx++) {
+                    uniform &= center == *supersampled.getAddr8(x + dx, y + dy);
+                }
+            }
+            if (uniform) {
+                diff = SkTMax(diff, SkAbs32(*analytic.getAddr8(x, y) - center));
+            }
+        }
+    }
+    return diff;
+}
+
+// The area of a convex polygon's overlap with the unit pixel at (x, y), found by clipping the
+// polygon to each of the pixel's sides in turn.
+static float pixel_coverage(const SkPoint poly[], int count, int x, int y) {
+    SkTDArray<SkPoint> in, out;
+    in.append(count, poly);
+    // Each side keeps the points p with dir * (p.x or p.y) <= dir * edge.
+    const struct { bool fVertical; float fEdge; float fDir; } sides[] = {
+        { true,  (float)x,     -1 },
+        { true,  (float)x + 1,  1 },
+        { false, (float)y,     -1 },
+        { false, (float)y + 1,  1 },
+    };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(sides); i++) {
+        out.rewind();
+        for (int j = 0; j < in.count(); j++) {
+            const SkPoint& a = in[j];
+            const SkPoint& b = in[(j + 1) % in.count()];
+            const float da = sides[i].fDir * ((sides[i].fVertical ? a.fX : a.fY) - sides[i].fEdge),
+                        db = sides[i].fDir * ((sides[i].fVertical ? b.fX : b.fY) - sides[i].fEdge);
+            if (da <= 0) {
+                *out.append() = a;
+            }
+            if ((da < 0 && db > 0) || (da > 0 && db < 0)) {
+                const float t = da / (da - db);
+                *out.append() = SkPoint::Make(a.fX + t * (b.fX - a.fX), a.fY + t * (b.fY - a.fY));
+            }
+        }
+        in.swap(out);
+    }
+    float area = 0;
+    for (int j = 0; j < in.count(); j++) {
+        const SkPoint& a = in[j];
+        const SkPoint& b = in[(j + 1) % in.count()];
+        area += a.fX * b.fY - b.fX * a.fY;
+    }
+    return SkScalarAbs(area) * 0.5f;
+}
+
+// A rect's coverage of each pixel is just the area of their overlap.
+DEF_TEST(AnalyticAA_Rect, r) {
+    const SkRect rect = SkRect::MakeLTRB(10.25f, 10.5f, 30.75f, 20.125f);
+    SkPath path;
+    path.addRect(rect);
+
+    SkBitmap bm;
+    draw(path, true, &bm);
+
+    for (int y = 0; y < kH; y++) {
+        for (int x = 0; x < kW; x++) {
+            SkRect pixel = SkRect::MakeXYWH(SkIntToScalar(x), SkIntToScalar(y), 1, 1);
+            float area = 0;
+            if (pixel.intersect(rect)) {
+                area = pixel.width() * pixel.height();
+            }
+            const int expected = (int)(area * 255 + 0.5f),
+                      actual   = *bm.getAddr8(x, y);
+            REPORTER_ASSERT(r, SkAbs32(expected - actual) <= 1);
+        }
+    }
+}
+
+// A triangle's coverage of each pixel is the area of their overlap too.
+DEF_TEST(AnalyticAA_Triangle, r) {
+    const SkPoint triangle[] = {
+        SkPoint::Make(3.3f, 5.1f), SkPoint::Make(60.2f, 17.7f), SkPoint::Make(21.9f, 58.4f),
+    };
+    SkPath path;
+    path.addPoly(triangle, SK_ARRAY_COUNT(triangle), true);
+
+    SkBitmap bm;
+    draw(path, true, &bm);
+
+    int diff = 0;
+    for (int y = 0; y < kH; y++) {
+        for (int x = 0; x < kW; x++) {
+            const float area = pixel_coverage(triangle, SK_ARRAY_COUNT(triangle), x, y);
+            const int expected = (int)(area * 255 + 0.5f);
+            diff = SkTMax(diff, SkAbs32(expected - *bm.getAddr8(x, y)));
+        }
+    }
+    REPORTER_ASSERT(r, diff <= kTolerance);
+}
+
+// Curves are flattened finely enough to match supersampling away from their edges, and to cover
+// about the same area.
+DEF_TEST(AnalyticAA_Curves, r) {
+    SkPath path;
+    path.addCircle(31.6f, 30.2f, 25.3f);
+    path.moveTo(12, 50);
+    path.cubicTo(0, 0, 64, 64, 50, 12);
+    path.conicTo(40, 40, 12, 50, 0.7f);
+
+    SkBitmap analytic, supersampled;
+    draw(path, true, &analytic);
+    draw(path, false, &supersampled);
+
+    REPORTER_ASSERT(r, max_diff_away_from_edges(analytic, supersampled) <= kTolerance);
+    const int a = total_alpha(analytic),
+              s = total_alpha(supersampled);
+    REPORTER_ASSERT(r, SkAbs32(a - s) < s / 100);
+}
+
+// Paths hanging off every side of the canvas and clip are clipped the same as supersampling.
+DEF_TEST(AnalyticAA_Clipped, r) {
+    SkPath path;
+    path.addOval(SkRect::MakeLTRB(-20.5f, -13.7f, 90.1f, 70.3f));
+    path.addRect(SkRect::MakeLTRB(-5, 30.5f, 80, 31.5f), SkPath::kCCW_Direction);
+
+    const SkRect clips[] = {
+        SkRect::MakeWH(SkIntToScalar(kW), SkIntToScalar(kH)),
+        SkRect::MakeLTRB(7, 9, 41, 50),
+    };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(clips); i++) {
+        SkBitmap analytic, supersampled;
+        draw(path, true, &analytic, &clips[i]);
+        draw(path, false, &supersampled, &clips[i]);
+        REPORTER_ASSERT(r, max_diff_away_from_edges(analytic, supersampled) <= kTolerance);
+    }
+}
+
+// Wide paths are accumulated a few rows at a time.
+DEF_TEST(AnalyticAA_Bands, r) {
+    SkPath path;
+    path.addOval(SkRect::MakeLTRB(3.5f, 2.25f, 1995.5f, 97.75f));
+    path.addCircle(500, 50, 40.5f, SkPath::kCCW_Direction);
+
+    SkBitmap analytic;
+    draw(path, true, &analytic, NULL, 2000, 100);
+
+    const float area = SK_ScalarPI * (996 * 47.75f - 40.5f * 40.5f);
+    const float sum = total_alpha(analytic) / 255.0f;
+    REPORTER_ASSERT(r, SkScalarAbs(sum - area) < area * 0.002f);
+    REPORTER_ASSERT(r, 0x00 == *analytic.getAddr8(500, 50));
+    REPORTER_ASSERT(r, 0xFF == *analytic.getAddr8(1000, 50));
+}
+
+// Overlapping contours fill or cancel depending on fill type.
+DEF_TEST(AnalyticAA_FillType, r) {
+    SkPath path;
+    path.addRect(SkRect::MakeLTRB(8, 8, 40, 40));
+    path.addRect(SkRect::MakeLTRB(24, 24, 56, 56));
+
+    SkBitmap bm;
+    path.setFillType(SkPath::kWinding_FillType);
+    draw(path, true, &bm);
+    REPORTER_ASSERT(r, 0xFF == *bm.getAddr8(32, 32));
+
+    path.setFillType(SkPath::kEvenOdd_FillType);
+    draw(path, true, &bm);
+    REPORTER_ASSERT(r, 0x00 == *bm.getAddr8(32, 32));
+    REPORTER_ASSERT(r, 0xFF == *bm.getAddr8(16, 16));
+    REPORTER_ASSERT(r, 0xFF == *bm.getAddr8(48, 48));
+
+    // Inverse fills fall back to supersampling, so they should match exactly.
+    path.setFillType(SkPath::kInverseEvenOdd_FillType);
+    SkBitmap supersampled;
+    draw(path, true, &bm);
+    draw(path, false, &supersampled);
+    REPORTER_ASSERT(r, 0 == max_diff(bm, supersampled));
+}
@@ -0,0 +1,132 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBitmapScaler.h"
+#include "SkColorPriv.h"
+#include "SkRandom.h"
+#include "SkScanlineDecoder.h"
+#include "Test.h"
+
+static void make_noise(SkBitmap* bm, int w, int h, bool opaque) {
+    bm->allocN32Pixels(w, h, opaque);
+    SkRandom rand;
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            SkPMColor c = rand.nextU();
+            if (opaque) {
+                c |= SK_A32_MASK << SK_A32_SHIFT;
+            } else {
+                const unsigned a = SkGetPackedA32(c);
+                c = SkPackARGB32(a, SkGetPackedR32(c) * a / 255, SkGetPackedG32(c) * a / 255,
+                                 SkGetPackedB32(c) * a / 255);
+            }
+            *bm->getAddr32(x, y) = c;
+        }
+    }
+}
+
+static bool equal(const SkBitmap& a, const SkBitmap& b) {
+    if (a.width() != b.width() || a.height() != b.height()) {
+        return false;
+    }
+    for (int y = 0; y < a.height(); y++) {
+        if (0 != memcmp(a.getAddr32(0, y), b.getAddr32(0, y), a.width() * sizeof(SkPMColor))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Hands out the rows of a bitmap one at a time, noting how they were asked for.
+class BitmapScanlineDecoder : public SkScanlineDecoder {
+public:
+    BitmapScanlineDecoder(const SkBitmap& bm)
+        : INHERITED(bm.info()), fRowsRead(0), fRowsSkipped(0), fBitmap(bm), fNextY(0) {}
+
+    int fRowsRead, fRowsSkipped;
+
+private:
+    SkImageGenerator::Result onGetScanlines(void* dst, int count, size_t rowBytes) override {
+        for (int i = 0; i < count; i++) {
+            memcpy((char*)dst + i * rowBytes, fBitmap.getAddr32(0, fNextY++),
+                   fBitmap.width() * sizeof(SkPMColor));
+        }
+        fRowsRead += count;
+        return SkImageGenerator::kSuccess;
+    }
+
+    SkImageGenerator::Result onSkipScanlines(int count) override {
+        fNextY += count;
+        fRowsSkipped += count;
+        return SkImageGenerator::kSuccess;
+    }
+
+    const SkBitmap& fBitmap;
+    int fNextY;
+
+    typedef SkScanlineDecoder INHERITED;
+};
+
+static const struct {
+    int fSrcW, fSrcH;
+    float fDstW, fDstH;
+} gSizes[] = {
+    { 300, 500,  37,  141.5f },  // downscale
+    { 120,  90, 250,  333    },  // upscale
+    { 257, 129, 257,   64    },  // one direction
+    {   3, 700,   1,   70    },  // skinny
+};
+
+static const SkBitmapScaler::ResizeMethod gMethods[] = {
+    SkBitmapScaler::RESIZE_BOX,
+    SkBitmapScaler::RESIZE_TRIANGLE,
+    SkBitmapScaler::RESIZE_LANCZOS3,
+    SkBitmapScaler::RESIZE_MITCHELL,
+};
+
+// Resizing in bands, or from a stream of rows, must match the plain resize exactly.
+DEF_TEST(BitmapScaler_Variants, r) {
+    for (size_t i = 0; i < SK_ARRAY_COUNT(gSizes); i++) {
+        for (int opaque = 0; opaque < 2; opaque++) {
+            SkBitmap src;
+            make_noise(&src, gSizes[i].fSrcW, gSizes[i].fSrcH, SkToBool(opaque));
+
+            for (size_t m = 0; m < SK_ARRAY_COUNT(gMethods); m++) {
+                SkBitmap expected, banded, streamed;
+                REPORTER_ASSERT(r, SkBitmapScaler::Resize(&expected, src, gMethods[m],
+                                                          gSizes[i].fDstW, gSizes[i].fDstH));
+                REPORTER_ASSERT(r, SkBitmapScaler::ResizeInParallel(&banded, src, gMethods[m],
+                                                                    gSizes[i].fDstW,
+                                                                    gSizes[i].fDstH));
+                REPORTER_ASSERT(r, equal(expected, banded));
+
+                BitmapScanlineDecoder decoder(src);
+                REPORTER_ASSERT(r, SkBitmapScaler::Resize(&streamed, &decoder, src.info(),
+                                                          gMethods[m],
+                                                          gSizes[i].fDstW, gSizes[i].fDstH));
+                REPORTER_ASSERT(r, equal(expected, streamed));
+
+                // No row was read (or skipped) more than once.
+                REPORTER_ASSERT(r, decoder.fRowsRead + decoder.fRowsSkipped <= src.height());
+            }
+        }
+    }
+}
+
+// Empty sizes and unsupported configs fail cleanly.
+DEF_TEST(BitmapScaler_Fail, r) {
+    SkBitmap src, dst;
+    make_noise(&src, 16, 16, true);
+    REPORTER_ASSERT(r, !SkBitmapScaler::ResizeInParallel(&dst, src, SkBitmapScaler::RESIZE_BOX,
+                                                         0, 10));
+
+    BitmapScanlineDecoder decoder(src);
+    REPORTER_ASSERT(r, !SkBitmapScaler::Resize(&dst, &decoder,
+                                               src.info().makeColorType(kAlpha_8_SkColorType),
+                                               SkBitmapScaler::RESIZE_BOX, 8, 8));
+    REPORTER_ASSERT(r, 0 == decoder.fRowsRead);
+}
@@ -13,6 +13,7 @@
 #include "SkCanvas.h"
 #include "SkMath.h"
 #include "SkPaint.h"
+#include "SkRandom.h"
 #include "Test.h"
 
 #if SK_SUPPORT_GPU
@@ -571,3 +572,151 @@ DEF_GPUTEST(Blur, reporter, factory) {
     test_sigma_range(reporter, factory);
     test_asABlur(reporter);
 }
+
+///////////////////////////////////////////////////////////////////////////////////////////
+
+// One box blur pass over 'count' pixels, a pixel at a time, with the arithmetic BoxBlur uses.
+// The kernel reaches loRadius pixels back and hiRadius forward; when hiRadius is the larger, the
+// output starts with hiRadius - loRadius zeros (boxBlurY's topPad), and otherwise it ends with
+// loRadius - hiRadius of them. Interpolated passes (outerWeight < 255) are always symmetric.
+static int ref_box_blur(const uint8_t* src, int srcStride, int count, uint8_t* dst, int dstStride,
+                        int loRadius, int hiRadius, int outerWeight) {
+    SkASSERT(255 == outerWeight || loRadius == hiRadius);
+    const int diameter = loRadius + hiRadius;
+    const int pad = SkTMax(hiRadius - loRadius, 0);
+    const int newCount = count + 2 * SkTMax(loRadius, hiRadius);
+    auto sum = [&](int first, int last) {
+        uint32_t s = 0;
+        for (int i = SkTMax(first, 0); i <= SkTMin(last, count - 1); ++i) {
+            s += src[i * srcStride];
+        }
+        return s;
+    };
+    for (int j = 0; j < newCount; ++j) {
+        const int k = j - pad;  // the last source pixel in the kernel
+        uint32_t value;
+        if (k < 0 || k >= count + diameter) {
+            value = 0;
+        } else if (255 == outerWeight) {
+            const uint32_t scale = (1 << 24) / (diameter + 1);
+            value = (sum(k - diameter, k) * scale + (1 << 23)) >> 24;
+        } else {
+            int innerWeight = 255 - outerWeight;
+            const int outer = outerWeight + (outerWeight >> 7);
+            innerWeight += innerWeight >> 7;
+            const uint32_t outerScale = (outer << 16) / (diameter + 1);
+            const uint32_t innerScale = (innerWeight << 16) / (diameter - 1);
+            uint32_t inner = sum(k - diameter + 1, k - 1);
+            if (count < diameter && k >= count && k < diameter) {
+                // While the kernel is wider than the image, the inner sum misses the last pixel.
+                inner = sum(0, count - 2);
+            }
+            value = (sum(k - diameter, k) * outerScale + inner * innerScale + (1 << 23)) >> 24;
+        }
+        dst[j * dstStride] = SkToU8(value);
+    }
+    return newCount;
+}
+
+// Matches get_adjusted_radii() in SkBlurMask.cpp: integer radii for the three high quality
+// passes, which between them make up a kernel of 2 * passRadius + 1.
+static void ref_adjusted_radii(SkScalar passRadius, int* loRadius, int* hiRadius) {
+    *loRadius = *hiRadius = SkScalarCeilToInt(passRadius);
+    if (SkIntToScalar(*hiRadius) - passRadius > 0.5f) {
+        *loRadius = *hiRadius - 1;
+    }
+}
+
+// BoxBlur blurs in X a row at a time, and in Y many columns at a time (and in bands, for big
+// masks). Both must match blurring one pixel at a time.
+static void test_box_blur(skiatest::Reporter* reporter, SkRandom* rand, int width, int height) {
+    SkMask src;
+    src.fFormat = SkMask::kA8_Format;
+    src.fBounds.set(0, 0, width, height);
+    src.fRowBytes = width;
+    SkAutoMaskFreeImage srcImage(src.fImage = SkMask::AllocImage(src.computeImageSize()));
+    for (int i = 0; i < width * height; ++i) {
+        src.fImage[i] = rand->nextU() & 0xFF;
+    }
+
+    // Low quality sigmas 1 and 3 and high quality 13/6 have integer pass radii, which take
+    // BoxBlur's non-interpolating path (outerWeight == 255).
+    static const SkScalar kSigmas[] = { 0.8f, 1, 2.5f, 3, 13 / 6.0f, 3.7f, 10, 33.3f };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(kSigmas); ++i) {
+        for (int high = 0; high < 2; ++high) {
+            const SkScalar sigma = kSigmas[i];
+            SkMask dst;
+            REPORTER_ASSERT(reporter, SkBlurMask::BoxBlur(&dst, src, sigma,
+                    kNormal_SkBlurStyle, high ? kHigh_SkBlurQuality : kLow_SkBlurQuality,
+                    NULL, true));
+            SkAutoMaskFreeImage dstImage(dst.fImage);
+
+            const SkScalar passRadius = high ? sigma - (1/6.0f) : 1.5f*sigma - 0.5f;
+            const int passCount = high ? 3 : 1;
+            const int radius = SkScalarCeilToInt(passRadius);
+            const int outerWeight = 255 -
+                    SkScalarRoundToInt((SkIntToScalar(radius) - passRadius) * 255);
+
+            // Each pass's (loRadius, hiRadius), the same in X and Y.
+            int passRadii[3][2] = {
+                { radius, radius }, { radius, radius }, { radius, radius },
+            };
+            if (255 == outerWeight && high) {
+                int loRadius, hiRadius;
+                ref_adjusted_radii(passRadius, &loRadius, &hiRadius);
+                const int adjusted[3][2] = {
+                    { loRadius, hiRadius }, { hiRadius, loRadius }, { hiRadius, hiRadius },
+                };
+                memcpy(passRadii, adjusted, sizeof(passRadii));
+            }
+
+            int w = width, h = height;
+            for (int pass = 0; pass < passCount; ++pass) {
+                const int pad = 2 * SkTMax(passRadii[pass][0], passRadii[pass][1]);
+                w += pad;
+                h += pad;
+            }
+            SkAutoTMalloc<uint8_t> storageA(w * h), storageB(w * h);
+            uint8_t* a = storageA.get();
+            uint8_t* b = storageB.get();
+            for (int y = 0; y < height; ++y) {
+                memcpy(a + y * w, src.fImage + y * width, width);
+            }
+            int count = width;
+            for (int pass = 0; pass < passCount; ++pass) {
+                for (int y = 0; y < height; ++y) {
+                    ref_box_blur(a + y * w, 1, count, b + y * w, 1,
+                                 passRadii[pass][0], passRadii[pass][1], outerWeight);
+                }
+                count += 2 * SkTMax(passRadii[pass][0], passRadii[pass][1]);
+                SkTSwap(a, b);
+            }
+            count = height;
+            for (int pass = 0; pass < passCount; ++pass) {
+                for (int x = 0; x < w; ++x) {
+                    ref_box_blur(a + x, w, count, b + x, w,
+                                 passRadii[pass][0], passRadii[pass][1], outerWeight);
+                }
+                count += 2 * SkTMax(passRadii[pass][0], passRadii[pass][1]);
+                SkTSwap(a, b);
+            }
+
+            REPORTER_ASSERT(reporter, dst.fBounds.width() == w && dst.fBounds.height() == h);
+            if (dst.fBounds.width() != w || dst.fBounds.height() != h ||
+                memcmp(dst.fImage, a, w * h)) {
+                ERRORF(reporter, "%dx%d mask, sigma %g, %s quality: wrong blur",
+                       width, height, sigma, high ? "high" : "low");
+            }
+        }
+    }
+}
+
+DEF_TEST(BlurMask_BoxBlur, reporter) {
+    SkRandom rand;
+    test_box_blur(reporter, &rand, 1, 1);
+    test_box_blur(reporter, &rand, 5, 37);
+    test_box_blur(reporter, &rand, 61, 30);
+    test_box_blur(reporter, &rand, 127, 129);
+    // Big enough to be blurred in bands.
+    test_box_blur(reporter, &rand, 700, 413);
+}
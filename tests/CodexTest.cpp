@@ -8,7 +8,11 @@
 #include "Resources.h"
 #include "SkBitmap.h"
 #include "SkCodec.h"
+#include "SkColorPriv.h"
+#include "SkData.h"
 #include "SkMD5.h"
+#include "SkRandom.h"
+#include "SkYUVToRGB.h"
 #include "Test.h"
 
 static SkStreamAsset* resource(const char path[]) {
@@ -94,8 +98,16 @@ DEF_TEST(Codec, r) {
     // Decodes an embedded PNG image
     check(r, "google_chrome.ico", SkISize::Make(256, 256), false);
 
+    // JPG
+    check(r, "CMYK.jpg", SkISize::Make(642, 516), true);
+    check(r, "color_wheel.jpg", SkISize::Make(128, 128), true);
+    check(r, "grayscale.jpg", SkISize::Make(128, 128), true);
+    check(r, "mandrill_512_q075.jpg", SkISize::Make(512, 512), true);
+    check(r, "randPixels.jpg", SkISize::Make(8, 8), true);
+
     // PNG
     check(r, "arrow.png", SkISize::Make(187, 312), true);
+    check(r, "arrow_interlaced.png", SkISize::Make(187, 312), false);
     check(r, "baby_tux.png", SkISize::Make(240, 246), true);
     check(r, "color_wheel.png", SkISize::Make(128, 128), true);
     check(r, "half-transparent-white-pixel.png", SkISize::Make(1, 1), true);
@@ -110,6 +122,437 @@ DEF_TEST(Codec, r) {
     check(r, "yellow_rose.png", SkISize::Make(400, 301), true);
 }
 
+static void check_subsets(skiatest::Reporter* r, const char path[], float scale) {
+    SkAutoTDelete<SkStream> stream(resource(path));
+    if (!stream) {
+        SkDebugf("Missing resource '%s'\n", path);
+        return;
+    }
+    SkAutoTDelete<SkCodec> codec(SkCodec::NewFromStream(stream.detach()));
+    if (!codec) {
+        ERRORF(r, "Unable to decode '%s'", path);
+        return;
+    }
+    const SkISize scaledSize = codec->getScaledDimensions(scale);
+    const SkImageInfo info = codec->getInfo().makeWH(scaledSize.width(), scaledSize.height());
+    SkBitmap full;
+    full.allocPixels(info);
+    SkImageGenerator::Result result =
+        codec->getPixels(info, full.getPixels(), full.rowBytes(), NULL, NULL, NULL);
+    REPORTER_ASSERT(r, result == SkImageGenerator::kSuccess);
+
+    // Each subset should match the same pixels of the whole image.
+    const SkIRect subsets[] = {
+        SkIRect::MakeSize(scaledSize),
+        SkIRect::MakeWH(1, 1),
+        SkIRect::MakeXYWH(scaledSize.width() / 3, scaledSize.height() / 4,
+                          scaledSize.width() / 2, scaledSize.height() / 2),
+        SkIRect::MakeLTRB(scaledSize.width() - 1, scaledSize.height() - 1,
+                          scaledSize.width(), scaledSize.height()),
+    };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(subsets); i++) {
+        const SkIRect& subset = subsets[i];
+        SkBitmap bm;
+        bm.allocPixels(info.makeWH(subset.width(), subset.height()));
+        bm.eraseColor(SK_ColorYELLOW);
+        result = codec->getSubsetPixels(scaledSize, subset, bm.info(),
+                                        bm.getPixels(), bm.rowBytes());
+        REPORTER_ASSERT(r, result == SkImageGenerator::kSuccess);
+        for (int y = 0; y < subset.height(); y++) {
+            REPORTER_ASSERT(r, !memcmp(bm.getAddr(0, y),
+                                       full.getAddr(subset.left(), subset.top() + y),
+                                       subset.width() * info.bytesPerPixel()));
+        }
+    }
+
+    // Subsets must lie inside the scaled image.
+    SkBitmap bm;
+    bm.allocPixels(info.makeWH(2, 2));
+    result = codec->getSubsetPixels(scaledSize,
+                                    SkIRect::MakeXYWH(scaledSize.width() - 1, 0, 2, 2),
+                                    bm.info(), bm.getPixels(), bm.rowBytes());
+    REPORTER_ASSERT(r, result == SkImageGenerator::kInvalidParameters);
+
+    // Skipping scanlines should leave the rest as they were in the whole image.
+    SkScanlineDecoder* scanlineDecoder = codec->getScanlineDecoder(info);
+    REPORTER_ASSERT(r, scanlineDecoder);
+    if (scanlineDecoder) {
+        const int skip = scaledSize.height() / 2;
+        result = scanlineDecoder->skipScanlines(skip);
+        REPORTER_ASSERT(r, result == SkImageGenerator::kSuccess);
+        SkBitmap row;
+        row.allocPixels(info.makeWH(scaledSize.width(), 1));
+        result = scanlineDecoder->getScanlines(row.getPixels(), 1, 0);
+        REPORTER_ASSERT(r, result == SkImageGenerator::kSuccess);
+        REPORTER_ASSERT(r, !memcmp(row.getPixels(), full.getAddr(0, skip), info.minRowBytes()));
+    }
+}
+
+DEF_TEST(Codec_jpegScaledSubsets, r) {
+    SkAutoTDelete<SkStream> stream(resource("mandrill_512_q075.jpg"));
+    if (stream) {
+        SkAutoTDelete<SkCodec> codec(SkCodec::NewFromStream(stream.detach()));
+        REPORTER_ASSERT(r, codec->getScaledDimensions(1.0f) == SkISize::Make(512, 512));
+        REPORTER_ASSERT(r, codec->getScaledDimensions(0.5f) == SkISize::Make(256, 256));
+        REPORTER_ASSERT(r, codec->getScaledDimensions(0.3f) == SkISize::Make(256, 256));
+        REPORTER_ASSERT(r, codec->getScaledDimensions(0.25f) == SkISize::Make(128, 128));
+        REPORTER_ASSERT(r, codec->getScaledDimensions(0.01f) == SkISize::Make(64, 64));
+    }
+
+    const char* paths[] = { "CMYK.jpg", "grayscale.jpg", "mandrill_512_q075.jpg" };
+    const float scales[] = { 1.0f, 0.5f, 0.25f, 0.125f };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(paths); i++) {
+        for (size_t j = 0; j < SK_ARRAY_COUNT(scales); j++) {
+            check_subsets(r, paths[i], scales[j]);
+        }
+    }
+}
+
+// libwebp scales to any size, and crops before it scales.
+DEF_TEST(Codec_webp, r) {
+    check(r, "baby_tux.webp", SkISize::Make(386, 395), false);
+    check(r, "color_wheel.webp", SkISize::Make(128, 128), false);
+    check(r, "yellow_rose.webp", SkISize::Make(400, 301), false);
+
+    SkAutoTDelete<SkCodec> codec(SkCodec::NewFromStream(resource("color_wheel.webp")));
+    if (!codec) {
+        SkDebugf("Missing resource 'color_wheel.webp'\n");
+        return;
+    }
+    REPORTER_ASSERT(r, codec->getScaledDimensions(1.0f) == SkISize::Make(128, 128));
+    REPORTER_ASSERT(r, codec->getScaledDimensions(0.3f) == SkISize::Make(38, 38));
+    REPORTER_ASSERT(r, codec->getScaledDimensions(0.001f) == SkISize::Make(1, 1));
+
+    const SkImageInfo info = codec->getInfo().makeAlphaType(kPremul_SkAlphaType);
+    SkBitmap full;
+    full.allocPixels(info);
+    REPORTER_ASSERT(r, SkImageGenerator::kSuccess ==
+            codec->getPixels(info, full.getPixels(), full.rowBytes()));
+
+    // Unscaled subsets are exactly those pixels of the whole image.
+    const SkIRect subset = SkIRect::MakeXYWH(37, 21, 50, 70);
+    SkBitmap bm;
+    bm.allocPixels(info.makeWH(subset.width(), subset.height()));
+    REPORTER_ASSERT(r, SkImageGenerator::kSuccess ==
+            codec->getSubsetPixels(info.dimensions(), subset, bm.info(), bm.getPixels(),
+                                   bm.rowBytes()));
+    for (int y = 0; y < subset.height(); y++) {
+        REPORTER_ASSERT(r, !memcmp(bm.getAddr(0, y), full.getAddr(subset.left(), subset.top() + y),
+                                   subset.width() * info.bytesPerPixel()));
+    }
+
+    // Scaled decodes, whole or in part, come out at the size asked for.
+    const SkISize scaledSize = codec->getScaledDimensions(0.3f);
+    bm.allocPixels(info.makeWH(scaledSize.width(), scaledSize.height()));
+    REPORTER_ASSERT(r, SkImageGenerator::kSuccess ==
+            codec->getPixels(bm.info(), bm.getPixels(), bm.rowBytes()));
+    bm.allocPixels(info.makeWH(10, 20));
+    REPORTER_ASSERT(r, SkImageGenerator::kSuccess ==
+            codec->getSubsetPixels(scaledSize, SkIRect::MakeXYWH(5, 5, 10, 20), bm.info(),
+                                   bm.getPixels(), bm.rowBytes()));
+}
+
+// The JPEG codec's YUV planes, converted to RGB, should be close to its RGB decode. Both upsample
+// U and V smoothly, but round differently, so they needn't match exactly.
+DEF_TEST(Codec_jpegYUV, r) {
+    SkAutoTDelete<SkStream> stream(resource("mandrill_512_q075.jpg"));
+    if (!stream) {
+        SkDebugf("Missing resource 'mandrill_512_q075.jpg'\n");
+        return;
+    }
+    SkAutoTDelete<SkCodec> codec(SkCodec::NewFromStream(stream.detach()));
+    SkISize sizes[3];
+    REPORTER_ASSERT(r, codec->getYUV8Planes(sizes, NULL, NULL, NULL));
+
+    size_t rowBytes[3];
+    SkAutoMalloc storage[3];
+    void* planes[3];
+    for (int i = 0; i < 3; i++) {
+        rowBytes[i] = sizes[i].width();
+        planes[i] = storage[i].reset(rowBytes[i] * sizes[i].height());
+    }
+    SkYUVColorSpace colorSpace;
+    REPORTER_ASSERT(r, codec->getYUV8Planes(sizes, planes, rowBytes, &colorSpace));
+    REPORTER_ASSERT(r, sizes[0] == SkISize::Make(512, 512));
+    REPORTER_ASSERT(r, sizes[1] == SkISize::Make(256, 256));
+    REPORTER_ASSERT(r, sizes[2] == SkISize::Make(256, 256));
+    REPORTER_ASSERT(r, kJPEG_SkYUVColorSpace == colorSpace);
+
+    SkBitmap fromYUV, fromRGB;
+    fromYUV.allocPixels(codec->getInfo());
+    fromRGB.allocPixels(codec->getInfo());
+    const void* constPlanes[3] = { planes[0], planes[1], planes[2] };
+    SkYUVToN32(sizes, constPlanes, rowBytes, colorSpace, fromYUV.getAddr32(0, 0),
+               fromYUV.rowBytes());
+    REPORTER_ASSERT(r, SkImageGenerator::kSuccess ==
+            codec->getPixels(fromRGB.info(), fromRGB.getPixels(), fromRGB.rowBytes(),
+                             NULL, NULL, NULL));
+
+    int64_t totalDiff = 0;
+    for (int y = 0; y < fromRGB.height(); y++) {
+        for (int x = 0; x < fromRGB.width(); x++) {
+            const SkColor a = fromYUV.getColor(x, y),
+                          b = fromRGB.getColor(x, y);
+            REPORTER_ASSERT(r, 0xFF == SkColorGetA(a));
+            totalDiff += SkTAbs((int)SkColorGetR(a) - (int)SkColorGetR(b))
+                       + SkTAbs((int)SkColorGetG(a) - (int)SkColorGetG(b))
+                       + SkTAbs((int)SkColorGetB(a) - (int)SkColorGetB(b));
+        }
+    }
+    const double meanDiff = (double)totalDiff / (3 * fromRGB.width() * fromRGB.height());
+    REPORTER_ASSERT(r, meanDiff < 4);
+}
+
+// Still images have a single frame, which is the image itself.
+DEF_TEST(Codec_stillFrame, r) {
+    SkAutoTDelete<SkStream> stream(resource("mandrill_128.png"));
+    if (!stream) {
+        SkDebugf("Missing resource 'mandrill_128.png'\n");
+        return;
+    }
+    SkAutoTDelete<SkCodec> codec(SkCodec::NewFromStream(stream.detach()));
+    REPORTER_ASSERT(r, 1 == codec->getFrameCount());
+    SkCodec::FrameInfo frameInfo;
+    REPORTER_ASSERT(r, codec->getFrameInfo(0, &frameInfo));
+    REPORTER_ASSERT(r, SkIRect::MakeWH(128, 128) == frameInfo.fRect);
+    REPORTER_ASSERT(r, SkCodec::kNone_RequiredFrame == frameInfo.fRequiredFrame);
+    REPORTER_ASSERT(r, !codec->getFrameInfo(1, &frameInfo));
+
+    const SkImageInfo info = codec->getInfo().makeColorType(kN32_SkColorType);
+    SkBitmap frame, pixels;
+    frame.allocPixels(info);
+    pixels.allocPixels(info);
+    REPORTER_ASSERT(r, SkImageGenerator::kInvalidParameters ==
+            codec->getFrame(1, info, frame.getPixels(), frame.rowBytes()));
+    REPORTER_ASSERT(r, SkImageGenerator::kSuccess ==
+            codec->getFrame(0, info, frame.getPixels(), frame.rowBytes()));
+    REPORTER_ASSERT(r, SkImageGenerator::kSuccess ==
+            codec->getPixels(info, pixels.getPixels(), pixels.rowBytes()));
+    REPORTER_ASSERT(r, !memcmp(frame.getPixels(), pixels.getPixels(), pixels.getSize()));
+}
+
+// A gif's frames can be asked for in any order, and the first still decodes with getPixels().
+DEF_TEST(Codec_gifFrames, r) {
+    SkAutoTDelete<SkStream> stream(resource("box.gif"));
+    if (!stream) {
+        SkDebugf("Missing resource 'box.gif'\n");
+        return;
+    }
+    SkAutoTDelete<SkCodec> codec(SkCodec::NewFromStream(stream.detach()));
+    if (!codec) {
+        ERRORF(r, "Unable to decode 'box.gif'");
+        return;
+    }
+    const int frameCount = codec->getFrameCount();
+    REPORTER_ASSERT(r, frameCount >= 1);
+
+    const SkImageInfo info = codec->getInfo().makeColorType(kN32_SkColorType);
+    SkBitmap forward, backward;
+    forward.allocPixels(info);
+    backward.allocPixels(info);
+    for (int i = frameCount - 1; i >= 0; i--) {
+        SkCodec::FrameInfo frameInfo;
+        REPORTER_ASSERT(r, codec->getFrameInfo(i, &frameInfo));
+        REPORTER_ASSERT(r, frameInfo.fRequiredFrame < i);
+        REPORTER_ASSERT(r, SkImageGenerator::kSuccess ==
+                codec->getFrame(i, info, backward.getPixels(), backward.rowBytes()));
+    }
+    for (int i = 0; i < frameCount; i++) {
+        REPORTER_ASSERT(r, SkImageGenerator::kSuccess ==
+                codec->getFrame(i, info, forward.getPixels(), forward.rowBytes()));
+    }
+    // The last frame asked for going backward was frame 0.
+    codec->getFrame(0, info, forward.getPixels(), forward.rowBytes());
+    REPORTER_ASSERT(r, !memcmp(forward.getPixels(), backward.getPixels(), forward.getSize()));
+
+    REPORTER_ASSERT(r, SkImageGenerator::kSuccess ==
+            codec->getPixels(info, forward.getPixels(), forward.rowBytes()));
+}
+
+// A 4x4 gif of four frames, with red, green, blue and white (made transparent by the third
+// frame) as its colors:
+//   0: red over the whole canvas, kept.
+//   1: green at (1, 1, 3, 3), then restored to the background.
+//   2: blue and transparent in a checkerboard at (0, 0, 2, 2), then restored to the previous.
+//   3: green at (2, 2, 4, 4), kept.
+static const uint8_t gAnimatedGif[] = {
+    0x47, 0x49, 0x46, 0x38, 0x39, 0x61, 0x04, 0x00, 0x04, 0x00, 0x81, 0x00,
+    0x00, 0xff, 0x00, 0x00, 0x00, 0xff, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff,
+    0xff, 0x21, 0xf9, 0x04, 0x04, 0x0a, 0x00, 0x00, 0x00, 0x2c, 0x00, 0x00,
+    0x00, 0x00, 0x04, 0x00, 0x04, 0x00, 0x00, 0x02, 0x04, 0x84, 0x8f, 0x09,
+    0x05, 0x00, 0x21, 0xf9, 0x04, 0x08, 0x0a, 0x00, 0x00, 0x00, 0x2c, 0x01,
+    0x00, 0x01, 0x00, 0x02, 0x00, 0x02, 0x00, 0x00, 0x02, 0x02, 0x8c, 0x53,
+    0x00, 0x21, 0xf9, 0x04, 0x0d, 0x0a, 0x00, 0x03, 0x00, 0x2c, 0x00, 0x00,
+    0x00, 0x00, 0x02, 0x00, 0x02, 0x00, 0x00, 0x02, 0x03, 0xd4, 0x26, 0x05,
+    0x00, 0x21, 0xf9, 0x04, 0x04, 0x0a, 0x00, 0x00, 0x00, 0x2c, 0x02, 0x00,
+    0x02, 0x00, 0x02, 0x00, 0x02, 0x00, 0x00, 0x02, 0x02, 0x8c, 0x53, 0x00,
+    0x3b,
+};
+
+// What each frame of gAnimatedGif composites to, a row per string. '.' is transparent.
+static const char* gAnimatedGifFrames[][4] = {
+    { "RRRR", "RRRR", "RRRR", "RRRR" },
+    { "RRRR", "RGGR", "RGGR", "RRRR" },
+    // Frame 1's rect is cleared first, and the transparent pixels show the red beneath.
+    { "BRRR", "RB.R", "R..R", "RRRR" },
+    // Frame 2 is undone, leaving frame 1's cleared rect.
+    { "RRRR", "R..R", "R.GG", "RRGG" },
+};
+
+static void check_animated_gif_frame(skiatest::Reporter* r, const SkBitmap& bm, int index) {
+    for (int y = 0; y < 4; y++) {
+        for (int x = 0; x < 4; x++) {
+            SkPMColor expected = 0;
+            switch (gAnimatedGifFrames[index][y][x]) {
+                case 'R': expected = SkPackARGB32(0xFF, 0xFF, 0x00, 0x00); break;
+                case 'G': expected = SkPackARGB32(0xFF, 0x00, 0xFF, 0x00); break;
+                case 'B': expected = SkPackARGB32(0xFF, 0x00, 0x00, 0xFF); break;
+                default:  break;
+            }
+            if (*bm.getAddr32(x, y) != expected) {
+                ERRORF(r, "Frame %d at (%d, %d): expected %08x, got %08x",
+                       index, x, y, expected, *bm.getAddr32(x, y));
+            }
+        }
+    }
+}
+
+DEF_TEST(Codec_gifAnimated, r) {
+    SkAutoTDelete<SkCodec> codec(SkCodec::NewFromStream(
+            new SkMemoryStream(gAnimatedGif, sizeof(gAnimatedGif), false)));
+    if (!codec) {
+        ERRORF(r, "Unable to decode gAnimatedGif");
+        return;
+    }
+    REPORTER_ASSERT(r, 4 == codec->getFrameCount());
+    if (4 != codec->getFrameCount()) {
+        return;
+    }
+
+    static const struct {
+        SkIRect                 fRect;
+        SkCodec::DisposalMethod fDisposalMethod;
+        int                     fRequiredFrame;
+    } gExpected[] = {
+        { SkIRect::MakeLTRB(0, 0, 4, 4), SkCodec::kKeep_DisposalMethod,
+          SkCodec::kNone_RequiredFrame },
+        { SkIRect::MakeLTRB(1, 1, 3, 3), SkCodec::kRestoreBGColor_DisposalMethod, 0 },
+        { SkIRect::MakeLTRB(0, 0, 2, 2), SkCodec::kRestorePrevious_DisposalMethod, 1 },
+        // Frame 2 is restored away, so this depends on frame 1 as well.
+        { SkIRect::MakeLTRB(2, 2, 4, 4), SkCodec::kKeep_DisposalMethod, 1 },
+    };
+    for (int i = 0; i < 4; i++) {
+        SkCodec::FrameInfo frameInfo;
+        REPORTER_ASSERT(r, codec->getFrameInfo(i, &frameInfo));
+        REPORTER_ASSERT(r, frameInfo.fRect == gExpected[i].fRect);
+        REPORTER_ASSERT(r, frameInfo.fDuration == 100);
+        REPORTER_ASSERT(r, frameInfo.fDisposalMethod == gExpected[i].fDisposalMethod);
+        REPORTER_ASSERT(r, frameInfo.fRequiredFrame == gExpected[i].fRequiredFrame);
+    }
+
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(4, 4);
+    SkBitmap bm;
+    bm.allocPixels(info);
+    // Backward first, so each frame is composited from scratch, then forward over kept frames.
+    for (int i = 3; i >= 0; i--) {
+        bm.eraseColor(SK_ColorBLACK);
+        REPORTER_ASSERT(r, SkImageGenerator::kSuccess ==
+                codec->getFrame(i, info, bm.getPixels(), bm.rowBytes()));
+        check_animated_gif_frame(r, bm, i);
+    }
+    for (int i = 0; i < 4; i++) {
+        bm.eraseColor(SK_ColorBLACK);
+        REPORTER_ASSERT(r, SkImageGenerator::kSuccess ==
+                codec->getFrame(i, info, bm.getPixels(), bm.rowBytes()));
+        check_animated_gif_frame(r, bm, i);
+    }
+}
+
+// Hands the encoded data to an incremental decode in small random pieces, expecting the rows to
+// be finished from the top down, and to end up just as getPixels() decodes them.
+static void check_incremental(skiatest::Reporter* r, const char path[]) {
+    SkAutoTUnref<SkData> data(SkData::NewFromFileName(GetResourcePath(path).c_str()));
+    if (!data) {
+        SkDebugf("Missing resource '%s'\n", path);
+        return;
+    }
+    SkAutoTDelete<SkCodec> fullCodec(SkCodec::NewFromData(data));
+    REPORTER_ASSERT(r, fullCodec);
+    if (!fullCodec) {
+        return;
+    }
+    const SkImageInfo info = fullCodec->getInfo();
+    SkBitmap expected;
+    expected.allocPixels(info);
+    REPORTER_ASSERT(r, SkImageGenerator::kSuccess ==
+            fullCodec->getPixels(info, expected.getPixels(), expected.rowBytes()));
+
+    // No codec can be made until the whole header has arrived.
+    SkRandom rand;
+    size_t received = 0;
+    SkAutoTDelete<SkCodec> codec;
+    while (!codec && received < data->size()) {
+        received = SkTMin(data->size(), received + 1 + rand.nextULessThan(64));
+        SkAutoTUnref<SkData> partial(SkData::NewSubset(data, 0, received));
+        codec.reset(SkCodec::NewFromData(partial));
+    }
+    REPORTER_ASSERT(r, codec);
+    if (!codec) {
+        return;
+    }
+    REPORTER_ASSERT(r, SkImageGenerator::kInvalidParameters == codec->incrementalDecode(NULL));
+
+    SkBitmap bm;
+    bm.allocPixels(info);
+    bm.eraseColor(SK_ColorYELLOW);
+    int rowsDecoded = 0;
+    SkImageGenerator::Result result =
+            codec->startIncrementalDecode(info, bm.getPixels(), bm.rowBytes(), &rowsDecoded);
+    const size_t rowLen = info.minRowBytes();
+    int checkedRows = 0;
+    for (;;) {
+        REPORTER_ASSERT(r, rowsDecoded >= checkedRows && rowsDecoded <= info.height());
+        for (; checkedRows < rowsDecoded; checkedRows++) {
+            if (memcmp(bm.getAddr(0, checkedRows), expected.getAddr(0, checkedRows), rowLen)) {
+                ERRORF(r, "'%s': row %d differs", path, checkedRows);
+                return;
+            }
+        }
+        if (SkImageGenerator::kIncompleteInput != result || received == data->size()) {
+            break;
+        }
+        const size_t length = SkTMin<size_t>(data->size() - received,
+                                             1 + rand.nextULessThan(512));
+        SkAutoTUnref<SkData> more(SkData::NewSubset(data, received, length));
+        received += length;
+        result = codec->incrementalDecode(more, &rowsDecoded);
+    }
+    REPORTER_ASSERT(r, SkImageGenerator::kSuccess == result);
+    REPORTER_ASSERT(r, info.height() == checkedRows);
+    REPORTER_ASSERT(r, SkImageGenerator::kSuccess == codec->incrementalDecode(NULL));
+}
+
+DEF_TEST(Codec_incremental, r) {
+    check_incremental(r, "CMYK.jpg");
+    check_incremental(r, "grayscale.jpg");  // progressive
+    check_incremental(r, "mandrill_512_q075.jpg");
+    check_incremental(r, "arrow.png");
+    check_incremental(r, "arrow_interlaced.png");
+    check_incremental(r, "plane.png");
+    check_incremental(r, "yellow_rose.png");
+
+    // Other formats don't decode incrementally.
+    SkAutoTDelete<SkCodec> codec(SkCodec::NewFromStream(resource("randPixels.bmp")));
+    if (codec) {
+        SkBitmap bm;
+        bm.allocPixels(codec->getInfo());
+        REPORTER_ASSERT(r, SkImageGenerator::kUnimplemented ==
+                codec->startIncrementalDecode(bm.info(), bm.getPixels(), bm.rowBytes()));
+        REPORTER_ASSERT(r, SkImageGenerator::kInvalidParameters ==
+                codec->incrementalDecode(NULL));
+    }
+}
+
 static void test_invalid_stream(skiatest::Reporter* r, const void* stream, size_t len) {
     SkCodec* codec = SkCodec::NewFromStream(new SkMemoryStream(stream, len, false));
     // We should not have gotten a codec. Bots should catch us if we leaked anything.
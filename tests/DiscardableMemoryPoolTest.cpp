@@ -33,3 +33,54 @@ DEF_TEST(DiscardableMemoryPool, reporter) {
     REPORTER_ASSERT(reporter, !dm2->lock());
     REPORTER_ASSERT(reporter, 0 == pool->getRAMUsed());
 }
+
+// Unlocked memory of lower priority is purged first, however recently it was used.
+DEF_TEST(DiscardableMemoryPool_priority, reporter) {
+    SkAutoTUnref<SkDiscardableMemoryPool> pool(
+        SkDiscardableMemoryPool::Create(2000, NULL));
+    SkAutoTDelete<SkDiscardableMemory> high(
+        pool->createWithPriority(400, SkDiscardableMemoryPool::kHigh_Priority));
+    SkAutoTDelete<SkDiscardableMemory> normal(pool->create(400));
+    SkAutoTDelete<SkDiscardableMemory> low(
+        pool->createWithPriority(400, SkDiscardableMemoryPool::kLow_Priority));
+    high->unlock();
+    normal->unlock();
+    low->unlock();
+    REPORTER_ASSERT(reporter, 1200 == pool->getRAMUsed());
+
+    pool->setRAMBudget(1000);
+    REPORTER_ASSERT(reporter, 800 == pool->getRAMUsed());
+    REPORTER_ASSERT(reporter, !low->lock());
+    REPORTER_ASSERT(reporter, normal->lock());
+    normal->unlock();
+
+    pool->setRAMBudget(500);
+    REPORTER_ASSERT(reporter, 400 == pool->getRAMUsed());
+    REPORTER_ASSERT(reporter, !normal->lock());
+    REPORTER_ASSERT(reporter, high->lock());
+    high->unlock();
+}
+
+// Purged memory goes back to the OS, not just to the pool.
+DEF_TEST(DiscardableMemoryPool_committed, reporter) {
+    SkAutoTUnref<SkDiscardableMemoryPool> pool(
+        SkDiscardableMemoryPool::Create(1024 * 1024, NULL));
+    SkAutoTDelete<SkDiscardableMemory> dms[32];
+    for (int i = 0; i < 32; i++) {
+        dms[i].reset(pool->create(5000 + 100 * i));
+        dms[i]->unlock();
+    }
+    REPORTER_ASSERT(reporter, pool->getCommittedBytes() >= pool->getRAMUsed());
+
+    int blocksUsed = 0;
+    for (int i = 0; i < SkSlabAllocator::kSizeClassCount; i++) {
+        SkDiscardableMemoryPool::SizeClassStats stats;
+        pool->getSizeClassStats(i, &stats);
+        blocksUsed += stats.fBlocksUsed;
+    }
+    REPORTER_ASSERT(reporter, 32 == blocksUsed);
+
+    pool->dumpPool();
+    REPORTER_ASSERT(reporter, 0 == pool->getRAMUsed());
+    REPORTER_ASSERT(reporter, 0 == pool->getCommittedBytes());
+}
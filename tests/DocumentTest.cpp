@@ -1,8 +1,12 @@
 #include "Test.h"
 
 #include "SkCanvas.h"
+#include "SkData.h"
 #include "SkDocument.h"
+#include "SkGradientShader.h"
 #include "SkOSFile.h"
+#include "SkPDFBitmap.h"
+#include "SkPixelRef.h"
 #include "SkStream.h"
 
 static void test_empty(skiatest::Reporter* reporter) {
@@ -96,10 +100,143 @@ static void test_close(skiatest::Reporter* reporter) {
     REPORTER_ASSERT(reporter, stream.bytesWritten() != 0);
 }
 
+static SkData* make_many_pages(const SkBitmap& bitmap, bool streaming) {
+    SkDynamicMemoryWStream stream;
+    SkAutoTUnref<SkDocument> doc(streaming ? SkDocument::CreateStreamingPDF(&stream)
+                                           : SkDocument::CreatePDF(&stream));
+
+    const SkPoint pts[] = { {0, 0}, {100, 100} };
+    const SkColor colors[] = { SK_ColorBLUE, 0x80FF0000 };
+    SkAutoTUnref<SkShader> shader(SkGradientShader::CreateLinear(
+            pts, colors, NULL, 2, SkShader::kClamp_TileMode));
+    for (int i = 0; i < 24; i++) {
+        SkCanvas* canvas = doc->beginPage(100, 100);
+        SkPaint paint;
+        paint.setAlpha(0x10 * (i % 4) + 0x40);
+        canvas->drawBitmap(bitmap, 10, 10, &paint);
+        paint.setShader(shader);
+        canvas->drawRect(SkRect::MakeXYWH(50, 50, 40, 40), paint);
+        SkString text;
+        text.printf("page %d", i);
+        canvas->drawText(text.c_str(), text.size(), 10, 90, SkPaint());
+        doc->endPage();
+    }
+    doc->close();
+    return stream.copyToData();
+}
+
+static int count_occurrences(const SkData* data, const char* needle) {
+    const size_t len = strlen(needle);
+    int count = 0;
+    for (size_t i = 0; i + len <= data->size(); i++) {
+        count += 0 == memcmp(data->bytes() + i, needle, len);
+    }
+    return count;
+}
+
+static bool contains(const SkData* data, const SkData* needle) {
+    for (size_t i = 0; i + needle->size() <= data->size(); i++) {
+        if (0 == memcmp(data->bytes() + i, needle->data(), needle->size())) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Pages may be converted on different threads, but the output must be the same every time,
+// and resources shared between pages must only be written once.
+static void test_many_pages(skiatest::Reporter* reporter) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(20, 20);
+    bitmap.eraseColor(SK_ColorGREEN);
+    bitmap.setImmutable();
+
+    for (int streaming = 0; streaming < 2; streaming++) {
+        SkAutoTUnref<SkData> first(make_many_pages(bitmap, SkToBool(streaming)));
+        for (int i = 0; i < 3; i++) {
+            SkAutoTUnref<SkData> again(make_many_pages(bitmap, SkToBool(streaming)));
+            REPORTER_ASSERT(reporter, first->equals(again));
+        }
+        REPORTER_ASSERT(reporter, 1 == count_occurrences(first, "/Subtype /Image"));
+        REPORTER_ASSERT(reporter, 24 == count_occurrences(first, "/Type /Page\n"));
+        REPORTER_ASSERT(reporter, 0 == memcmp(first->data(), "%PDF", 4));
+        REPORTER_ASSERT(reporter,
+                        0 == memcmp(first->bytes() + first->size() - 5, "%%EOF", 5));
+    }
+}
+
+static SkData* make_bitmap_pdf(const SkBitmap& bitmap, int deflateLevel) {
+    SkDynamicMemoryWStream stream;
+    SkAutoTUnref<SkDocument> doc(SkDocument::CreatePDF(&stream, SK_ScalarDefaultRasterDPI,
+                                                       deflateLevel));
+    doc->beginPage(100, 100)->drawBitmap(bitmap, 0, 0);
+    doc->close();
+    return stream.copyToData();
+}
+
+// Higher levels compress more, and identical images compress identically, however
+// they're cached.
+static void test_deflate_levels(skiatest::Reporter* reporter) {
+    SkBitmap bitmap, copy;
+    bitmap.allocN32Pixels(64, 64);
+    for (int y = 0; y < 64; y++) {
+        for (int x = 0; x < 64; x++) {
+            *bitmap.getAddr32(x, y) = SkPackARGB32(0xFF, x * 4, y * 4, (x * y) & 0xFF);
+        }
+    }
+    bitmap.setImmutable();
+    bitmap.copyTo(&copy);
+    copy.setImmutable();
+
+    SkAutoTUnref<SkData> stored(make_bitmap_pdf(bitmap, 0));
+    SkAutoTUnref<SkData> fast(make_bitmap_pdf(bitmap, 1));
+    SkAutoTUnref<SkData> best(make_bitmap_pdf(bitmap, 9));
+    SkAutoTUnref<SkData> bestCopy(make_bitmap_pdf(copy, 9));
+    REPORTER_ASSERT(reporter, stored->size() > fast->size());
+    REPORTER_ASSERT(reporter, fast->size() >= best->size());
+    REPORTER_ASSERT(reporter, best->equals(bestCopy));
+    REPORTER_ASSERT(reporter, stored->size() > 64 * 64 * 3);
+
+    // The cached entries don't keep the pixels they were made from.
+    REPORTER_ASSERT(reporter, bitmap.pixelRef()->unique());
+    REPORTER_ASSERT(reporter, copy.pixelRef()->unique());
+
+    // The copy has its own pixels, but finds the entry made for the original.
+    SkAutoTUnref<SkData> cached(SkPDFBitmap::FindDeflated(copy, 9));
+    REPORTER_ASSERT(reporter, cached);
+    if (cached) {
+        REPORTER_ASSERT(reporter, contains(bestCopy, cached));
+    }
+
+    // One pixel differs, so the cached entry must not be used.
+    SkBitmap other;
+    copy.copyTo(&other);
+    *other.getAddr32(63, 63) ^= 0x00010000;
+    other.setImmutable();
+    SkAutoTUnref<SkData> otherCached(SkPDFBitmap::FindDeflated(other, 9));
+    REPORTER_ASSERT(reporter, !otherCached);
+
+    SkDynamicMemoryWStream stream;
+    REPORTER_ASSERT(reporter, !SkDocument::CreatePDF(&stream, SK_ScalarDefaultRasterDPI, 10));
+    REPORTER_ASSERT(reporter,
+                    !SkDocument::CreateStreamingPDF(&stream, SK_ScalarDefaultRasterDPI, -2));
+}
+
+// A streaming document with no pages writes nothing, like a regular one.
+static void test_empty_streaming(skiatest::Reporter* reporter) {
+    SkDynamicMemoryWStream stream;
+    SkAutoTUnref<SkDocument> doc(SkDocument::CreateStreamingPDF(&stream));
+    doc->close();
+    REPORTER_ASSERT(reporter, stream.bytesWritten() == 0);
+}
+
 DEF_TEST(document_tests, reporter) {
     test_empty(reporter);
     test_abort(reporter);
     test_abortWithFile(reporter);
     test_file(reporter);
     test_close(reporter);
+    test_many_pages(reporter);
+    test_empty_streaming(reporter);
+    test_deflate_levels(reporter);
 }
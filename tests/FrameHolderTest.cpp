@@ -0,0 +1,201 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkColorPriv.h"
+#include "SkFrameHolder.h"
+#include "SkRandom.h"
+#include "SkTDArray.h"
+#include "Test.h"
+
+namespace {
+
+// Fills each frame's rect with a pattern made from its index, with some transparent pixels
+// in the frames that have alpha.
+class PatternDecoder : public SkFrameHolder::Decoder {
+public:
+    PatternDecoder(const SkTDArray<bool>& hasAlpha) : fHasAlpha(hasAlpha) {}
+
+    bool decodeFrame(int index, const SkIRect& rect, SkPMColor* dst,
+                     size_t rowBytes) const override {
+        Fill(index, fHasAlpha[index], rect, dst, rowBytes);
+        return true;
+    }
+
+    static void Fill(int index, bool hasAlpha, const SkIRect& rect, SkPMColor* dst,
+                     size_t rowBytes) {
+        for (int y = 0; y < rect.height(); y++) {
+            SkPMColor* row = SkTAddOffset<SkPMColor>(dst, y * rowBytes);
+            for (int x = 0; x < rect.width(); x++) {
+                const int cx = rect.fLeft + x,
+                          cy = rect.fTop + y;
+                row[x] = hasAlpha && 0 == (cx + cy + index) % 3 ? 0
+                       : SkPackARGB32(0xFF, (index * 7) & 0xFF, cx * 13, cy * 17);
+            }
+        }
+    }
+
+private:
+    SkTDArray<bool> fHasAlpha;
+};
+
+struct TestFrame {
+    SkIRect                 fRect;
+    SkCodec::DisposalMethod fDisposal;
+    bool                    fHasAlpha;
+};
+
+}  // namespace
+
+static const int kSize = 16;
+
+// Composites frame index the slow way: drawing every frame from the first.
+static void composite_all(const SkTDArray<TestFrame>& frames, int index, SkPMColor* canvas) {
+    SkPMColor saved[kSize * kSize], pixels[kSize * kSize];
+    sk_bzero(canvas, sizeof(saved));
+    for (int i = 0; i <= index; i++) {
+        const TestFrame& frame = frames[i];
+        memcpy(saved, canvas, sizeof(saved));
+        PatternDecoder::Fill(i, frame.fHasAlpha, frame.fRect, pixels,
+                             frame.fRect.width() * sizeof(SkPMColor));
+        for (int y = 0; y < frame.fRect.height(); y++) {
+            for (int x = 0; x < frame.fRect.width(); x++) {
+                const SkPMColor c = pixels[y * frame.fRect.width() + x];
+                if (c) {
+                    canvas[(frame.fRect.fTop + y) * kSize + frame.fRect.fLeft + x] = c;
+                }
+            }
+        }
+        if (i == index) {
+            return;
+        }
+        switch (frame.fDisposal) {
+            case SkCodec::kRestoreBGColor_DisposalMethod:
+                for (int y = frame.fRect.fTop; y < frame.fRect.fBottom; y++) {
+                    for (int x = frame.fRect.fLeft; x < frame.fRect.fRight; x++) {
+                        canvas[y * kSize + x] = 0;
+                    }
+                }
+                break;
+            case SkCodec::kRestorePrevious_DisposalMethod:
+                memcpy(canvas, saved, sizeof(saved));
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+static void check_frame(skiatest::Reporter* r, SkFrameHolder* holder,
+                        const SkTDArray<TestFrame>& frames, int index) {
+    SkPMColor expected[kSize * kSize], actual[kSize * kSize];
+    composite_all(frames, index, expected);
+    REPORTER_ASSERT(r, SkCodec::kSuccess ==
+            holder->getFrame(index, actual, kSize * sizeof(SkPMColor)));
+    REPORTER_ASSERT(r, !memcmp(expected, actual, sizeof(expected)));
+}
+
+// Random animations, with frames asked for both in order and in any order, should match
+// drawing every frame from the start.
+DEF_TEST(FrameHolder, r) {
+    SkRandom rand;
+    for (int test = 0; test < 20; test++) {
+        const int count = 1 + rand.nextULessThan(40);
+        SkTDArray<TestFrame> frames;
+        SkTDArray<bool> hasAlpha;
+        for (int i = 0; i < count; i++) {
+            TestFrame* frame = frames.append();
+            if (rand.nextBool()) {
+                frame->fRect = SkIRect::MakeWH(kSize, kSize);
+            } else {
+                const int left = rand.nextULessThan(kSize),
+                          top  = rand.nextULessThan(kSize);
+                frame->fRect = SkIRect::MakeLTRB(left, top,
+                                                 left + 1 + rand.nextULessThan(kSize - left),
+                                                 top  + 1 + rand.nextULessThan(kSize - top));
+            }
+            frame->fDisposal = (SkCodec::DisposalMethod) rand.nextULessThan(3);
+            frame->fHasAlpha = rand.nextBool();
+            *hasAlpha.append() = frame->fHasAlpha;
+        }
+
+        SkFrameHolder holder(SkISize::Make(kSize, kSize), SkNEW_ARGS(PatternDecoder, (hasAlpha)));
+        for (int i = 0; i < count; i++) {
+            holder.appendFrame(frames[i].fRect, 10 * i, frames[i].fDisposal,
+                               frames[i].fHasAlpha);
+            const int required = holder.frameInfo(i).fRequiredFrame;
+            REPORTER_ASSERT(r, required < i);
+            REPORTER_ASSERT(r, 0 != i || SkCodec::kNone_RequiredFrame == required);
+        }
+
+        for (int i = 0; i < count; i++) {
+            check_frame(r, &holder, frames, i);
+        }
+        for (int i = 0; i < count; i++) {
+            check_frame(r, &holder, frames, rand.nextULessThan(count));
+        }
+    }
+}
+
+// Frames covering the canvas with no transparency, or following one cleared from the whole
+// canvas, don't depend on earlier frames.
+DEF_TEST(FrameHolder_requiredFrame, r) {
+    SkTDArray<bool> hasAlpha;
+    SkFrameHolder holder(SkISize::Make(kSize, kSize), SkNEW_ARGS(PatternDecoder, (hasAlpha)));
+    const SkIRect full = SkIRect::MakeWH(kSize, kSize),
+                  part = SkIRect::MakeXYWH(2, 2, 4, 4);
+
+    holder.appendFrame(full, 0, SkCodec::kKeep_DisposalMethod, false);
+    holder.appendFrame(part, 0, SkCodec::kKeep_DisposalMethod, false);
+    holder.appendFrame(full, 0, SkCodec::kRestorePrevious_DisposalMethod, true);
+    holder.appendFrame(part, 0, SkCodec::kRestoreBGColor_DisposalMethod, true);
+    holder.appendFrame(part, 0, SkCodec::kKeep_DisposalMethod, true);
+    holder.appendFrame(full, 0, SkCodec::kRestoreBGColor_DisposalMethod, true);
+    holder.appendFrame(part, 0, SkCodec::kKeep_DisposalMethod, true);
+    holder.appendFrame(full, 0, SkCodec::kKeep_DisposalMethod, false);
+
+    REPORTER_ASSERT(r, SkCodec::kNone_RequiredFrame == holder.frameInfo(0).fRequiredFrame);
+    REPORTER_ASSERT(r, 0 == holder.frameInfo(1).fRequiredFrame);
+    REPORTER_ASSERT(r, 1 == holder.frameInfo(2).fRequiredFrame);
+    // Frame 2 restores to what frame 1 left.
+    REPORTER_ASSERT(r, 1 == holder.frameInfo(3).fRequiredFrame);
+    REPORTER_ASSERT(r, 3 == holder.frameInfo(4).fRequiredFrame);
+    REPORTER_ASSERT(r, 4 == holder.frameInfo(5).fRequiredFrame);
+    // Frame 5 clears the whole canvas.
+    REPORTER_ASSERT(r, SkCodec::kNone_RequiredFrame == holder.frameInfo(6).fRequiredFrame);
+    REPORTER_ASSERT(r, SkCodec::kNone_RequiredFrame == holder.frameInfo(7).fRequiredFrame);
+}
+
+// Seeking back and forth leaves no more than the frames just ahead decoded, and keeps no more
+// than the keyframes and the last frame asked for.
+DEF_TEST(FrameHolder_seek, r) {
+    const int count = 4 * SkFrameHolder::kKeyframeInterval + 3;
+    SkTDArray<TestFrame> frames;
+    SkTDArray<bool> hasAlpha;
+    for (int i = 0; i < count; i++) {
+        TestFrame* frame = frames.append();
+        frame->fRect = SkIRect::MakeXYWH(i % kSize, 0, 1, kSize);
+        frame->fDisposal = SkCodec::kKeep_DisposalMethod;
+        frame->fHasAlpha = true;
+        *hasAlpha.append() = true;
+    }
+    SkFrameHolder holder(SkISize::Make(kSize, kSize), SkNEW_ARGS(PatternDecoder, (hasAlpha)));
+    for (int i = 0; i < count; i++) {
+        holder.appendFrame(frames[i].fRect, 0, frames[i].fDisposal, frames[i].fHasAlpha);
+    }
+
+    const size_t frameBytes = kSize * kSize * sizeof(SkPMColor);
+    const size_t maxKeptBytes = (count / SkFrameHolder::kKeyframeInterval + 2) * frameBytes;
+    SkRandom rand;
+    int index = 0;
+    for (int i = 0; i < 100; i++) {
+        // Mostly step forward, like an animation playing, with the odd seek.
+        index = rand.nextULessThan(4) ? (index + 1) % count : rand.nextULessThan(count);
+        check_frame(r, &holder, frames, index);
+        REPORTER_ASSERT(r, holder.decodedFrameCount() <= SkFrameHolder::kDecodeAhead);
+        REPORTER_ASSERT(r, holder.keptBytes() <= maxKeptBytes);
+    }
+}
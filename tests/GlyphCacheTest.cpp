@@ -0,0 +1,93 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkGlyphCache.h"
+#include "SkGlyphCache_Globals.h"
+#include "SkPaint.h"
+#include "SkTaskGroup.h"
+#include "SkTDArray.h"
+#include "Test.h"
+
+// Limits are split across shards in slices that differ by at most one and sum back to the limit.
+// This works on the arithmetic, and on a private SkGlyphCache_Globals, rather than SkGraphics:
+// other tests use the shared cache at the same time.
+DEF_TEST(GlyphCache_Limits, r) {
+    const size_t kSizes[] = { 0, 1, 3, 256 * 1024, 3 * 1024 * 1024 + 3 };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(kSizes); i++) {
+        size_t sum = 0;
+        for (int shard = 0; shard < SK_FONT_CACHE_SHARD_COUNT; shard++) {
+            const size_t slice = SkGlyphCache_Globals::ShardSlice(kSizes[i], shard);
+            REPORTER_ASSERT(r, slice == kSizes[i] / SK_FONT_CACHE_SHARD_COUNT ||
+                               slice == kSizes[i] / SK_FONT_CACHE_SHARD_COUNT + 1);
+            sum += slice;
+        }
+        REPORTER_ASSERT(r, sum == kSizes[i]);
+    }
+
+    const int kCounts[] = { 0, 1, 1001, 2048 };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(kCounts); i++) {
+        int sum = 0;
+        for (int shard = 0; shard < SK_FONT_CACHE_SHARD_COUNT; shard++) {
+            sum += SkGlyphCache_Globals::ShardSlice(kCounts[i], shard);
+        }
+        REPORTER_ASSERT(r, sum == kCounts[i]);
+    }
+
+    SkGlyphCache_Globals globals(SkGlyphCache_Globals::kNo_UseMutex, 1024, 10);
+    REPORTER_ASSERT(r, globals.setCacheSizeLimit(3 * 1024 * 1024 + 3) == 1024);
+    REPORTER_ASSERT(r, globals.getCacheSizeLimit() == 3 * 1024 * 1024 + 3);
+    REPORTER_ASSERT(r, globals.setCacheCountLimit(1001) == 10);
+    REPORTER_ASSERT(r, globals.getCacheCountLimit() == 1001);
+}
+
+// Looks up the strike for size, returning the shard it lives in.
+static int find_strike(int size) {
+    SkPaint paint;
+    paint.setTextSize(SkIntToScalar(size));
+    SkAutoGlyphCache autoCache(paint, NULL, NULL);
+    return SkGlyphCache::ShardIndex(autoCache.getCache()->getDescriptor());
+}
+
+static int lookups(int shard) {
+    SkGlyphCache::ShardStats stats;
+    SkGlyphCache::GetShardStats(shard, &stats);
+    return stats.fHits + stats.fMisses;
+}
+
+// Each strike lands in the shard its descriptor picks, and every lookup is counted there as a hit
+// or a miss. Text sizes are chosen by the shard they land in, so every shard is checked whatever
+// the descriptor hash does.
+DEF_TEST(GlyphCache_Shards, r) {
+    const int shardCount = SkGlyphCache::ShardCount();
+    SkTDArray<int> sizes;
+    sizes.setCount(shardCount);
+    sk_bzero(sizes.begin(), shardCount * sizeof(int));
+    int found = 0;
+    for (int size = 8; size < 256 && found < shardCount; size++) {
+        const int shard = find_strike(size);
+        if (0 == sizes[shard]) {
+            sizes[shard] = size;
+            found++;
+        }
+    }
+    REPORTER_ASSERT(r, found == shardCount);
+    if (found != shardCount) {
+        return;
+    }
+
+    SkTDArray<int> before;
+    for (int i = 0; i < shardCount; i++) {
+        *before.append() = lookups(i);
+    }
+
+    // Other tests may be drawing text at the same time, which only adds to the counts.
+    static const int kFinds = 16;
+    sk_parallel_for(shardCount * kFinds, 1, [&](int i) { find_strike(sizes[i % shardCount]); });
+    for (int i = 0; i < shardCount; i++) {
+        REPORTER_ASSERT(r, lookups(i) - before[i] >= kFinds);
+    }
+}
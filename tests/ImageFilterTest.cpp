@@ -18,6 +18,7 @@
 #include "SkDropShadowImageFilter.h"
 #include "SkFlattenableSerialization.h"
 #include "SkGradientShader.h"
+#include "SkImageFilterBands.h"
 #include "SkLightingImageFilter.h"
 #include "SkMatrixConvolutionImageFilter.h"
 #include "SkMergeImageFilter.h"
@@ -30,6 +31,7 @@
 #include "SkReadBuffer.h"
 #include "SkRect.h"
 #include "SkRectShaderImageFilter.h"
+#include "SkResourceCache.h"
 #include "SkTileImageFilter.h"
 #include "SkXfermodeImageFilter.h"
 #include "Test.h"
@@ -524,6 +526,198 @@ DEF_TEST(ImageFilterDrawTiled, reporter) {
     }
 }
 
+DEF_TEST(ImageFilterDrawBanded, reporter) {
+    // Large filtered draws may be split into bands that are filtered in parallel, each pulling
+    // only what it needs through the DAG. They must match one evaluation of the whole DAG.
+    const int width = 512, height = 512;
+    SkBitmap src = make_gradient_circle(width, height);
+
+    SkPoint3 direction(SK_Scalar1, SK_Scalar1, SK_Scalar1);
+    SkAutoTUnref<SkImageFilter> blur(SkBlurImageFilter::Create(SkIntToScalar(3),
+                                                               SkIntToScalar(3)));
+    SkAutoTUnref<SkImageFilter> dilate(SkDilateImageFilter::Create(2, 2, blur));
+    SkAutoTUnref<SkImageFilter> offset(SkOffsetImageFilter::Create(SkIntToScalar(5),
+                                                                   SkIntToScalar(-7), blur));
+    SkAutoTUnref<SkImageFilter> lighting(SkLightingImageFilter::CreateDistantLitDiffuse(
+        direction, SK_ColorWHITE, SkIntToScalar(10), SK_ScalarHalf, blur));
+    SkImageFilter* inputs[] = { dilate.get(), offset.get(), lighting.get() };
+    SkAutoTUnref<SkImageFilter> merge(SkMergeImageFilter::Create(inputs, 3));
+
+    SkBitmap banded;
+    banded.allocN32Pixels(width, height);
+    banded.eraseColor(0);
+    SkCanvas bandedCanvas(banded);
+    SkPaint paint;
+    paint.setImageFilter(merge);
+    bandedCanvas.drawSprite(src, 0, 0, &paint);
+
+    SkBitmap expected;
+    expected.allocN32Pixels(width, height);
+    expected.eraseColor(0);
+    SkBitmapDevice device(expected);
+    SkDeviceImageFilterProxy proxy(&device,
+                                   SkSurfaceProps(SkSurfaceProps::kLegacyFontHost_InitType));
+    SkImageFilter::Context ctx(SkMatrix::I(), SkIRect::MakeWH(width, height), NULL);
+    SkBitmap result;
+    SkIPoint resultOffset = SkIPoint::Make(0, 0);
+    REPORTER_ASSERT(reporter, merge->filterImage(&proxy, src, ctx, &result, &resultOffset));
+    SkCanvas expectedCanvas(expected);
+    expectedCanvas.drawSprite(result, resultOffset.x(), resultOffset.y());
+
+    for (int y = 0; y < height; y++) {
+        if (memcmp(expected.getAddr32(0, y), banded.getAddr32(0, y), width * sizeof(SkPMColor))) {
+            ERRORF(reporter, "row %d differs", y);
+            break;
+        }
+    }
+
+    // Whether drawSprite() bands at all depends on the thread count, so also band explicitly.
+    REPORTER_ASSERT(reporter, merge->canFilterPartially());
+    const int bandCounts[] = { 2, 3, 7 };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(bandCounts); ++i) {
+        const int bands = bandCounts[i];
+        SkAutoTArray<SkBitmap> results(bands);
+        SkAutoTArray<SkIPoint> offsets(bands);
+        SkImageFilterBands(merge, &proxy, src, ctx, bands, results.get(), offsets.get());
+
+        banded.eraseColor(0);
+        for (int b = 0; b < bands; ++b) {
+            if (!results[b].isNull()) {
+                bandedCanvas.drawSprite(results[b], offsets[b].x(), offsets[b].y());
+            }
+        }
+        for (int y = 0; y < height; y++) {
+            if (memcmp(expected.getAddr32(0, y), banded.getAddr32(0, y),
+                       width * sizeof(SkPMColor))) {
+                ERRORF(reporter, "%d bands: row %d differs", bands, y);
+                break;
+            }
+        }
+    }
+}
+
+DEF_TEST(ImageFilterCanFilterPartially, reporter) {
+    // A DAG may only be narrowed to the clip if every node in it declares the bounds it reads.
+    SkAutoTUnref<SkImageFilter> blur(SkBlurImageFilter::Create(SK_Scalar1, SK_Scalar1));
+    SkAutoTUnref<SkImageFilter> custom(SkNEW_ARGS(MatrixTestImageFilter,
+                                                  (reporter, SkMatrix::I())));
+    SkAutoTUnref<SkImageFilter> customBlur(SkBlurImageFilter::Create(SK_Scalar1, SK_Scalar1,
+                                                                     custom));
+    SkImageFilter* inputs[] = { blur.get(), customBlur.get() };
+    SkAutoTUnref<SkImageFilter> allDeclared(SkMergeImageFilter::Create(inputs, 1));
+    SkAutoTUnref<SkImageFilter> someUndeclared(SkMergeImageFilter::Create(inputs, 2));
+
+    REPORTER_ASSERT(reporter, blur->canFilterPartially());
+    REPORTER_ASSERT(reporter, !custom->canFilterPartially());
+    REPORTER_ASSERT(reporter, !customBlur->canFilterPartially());
+    REPORTER_ASSERT(reporter, allDeclared->canFilterPartially());
+    REPORTER_ASSERT(reporter, !someUndeclared->canFilterPartially());
+}
+
+namespace {
+
+class FailImageFilter : public SkImageFilter {
+public:
+    FailImageFilter() : SkImageFilter(0, NULL) {}
+
+    bool onFilterImage(Proxy*, const SkBitmap&, const Context&,
+                       SkBitmap*, SkIPoint*) const override {
+        return false;
+    }
+
+    SK_TO_STRING_OVERRIDE()
+    SK_DECLARE_PUBLIC_FLATTENABLE_DESERIALIZATION_PROCS(FailImageFilter)
+
+private:
+    typedef SkImageFilter INHERITED;
+};
+
+}
+
+SkFlattenable* FailImageFilter::CreateProc(SkReadBuffer& buffer) {
+    SK_IMAGEFILTER_UNFLATTEN_COMMON(common, 0);
+    return SkNEW(FailImageFilter);
+}
+
+#ifndef SK_IGNORE_TO_STRING
+void FailImageFilter::toString(SkString* str) const {
+    str->append("FailImageFilter: ()");
+}
+#endif
+
+DEF_TEST(MergeImageFilterInputs, reporter) {
+    // An input cropped out of the clip drops out of a merge, but a failing input fails it.
+    SkBitmap src = make_gradient_circle(100, 100);
+    SkBitmap device;
+    device.allocN32Pixels(100, 100);
+    SkBitmapDevice bitmapDevice(device);
+    SkDeviceImageFilterProxy proxy(&bitmapDevice,
+                                   SkSurfaceProps(SkSurfaceProps::kLegacyFontHost_InitType));
+    SkImageFilter::Context ctx(SkMatrix::I(), SkIRect::MakeWH(50, 50), NULL);
+
+    SkImageFilter::CropRect outside(SkRect::MakeXYWH(60, 60, 20, 20));
+    SkAutoTUnref<SkImageFilter> croppedOut(SkOffsetImageFilter::Create(0, 0, NULL, &outside));
+    SkAutoTUnref<SkImageFilter> offset(SkOffsetImageFilter::Create(0, 0));
+    SkAutoTUnref<SkImageFilter> fail(SkNEW(FailImageFilter));
+
+    SkImageFilter* okInputs[] = { offset.get(), croppedOut.get() };
+    SkAutoTUnref<SkImageFilter> ok(SkMergeImageFilter::Create(okInputs, 2));
+    SkBitmap result;
+    SkIPoint resultOffset = SkIPoint::Make(0, 0);
+    REPORTER_ASSERT(reporter, ok->filterImage(&proxy, src, ctx, &result, &resultOffset));
+    REPORTER_ASSERT(reporter, !result.isNull());
+
+    SkImageFilter* failInputs[] = { offset.get(), fail.get() };
+    SkAutoTUnref<SkImageFilter> failing(SkMergeImageFilter::Create(failInputs, 2));
+    REPORTER_ASSERT(reporter, !failing->filterImage(&proxy, src, ctx, &result, &resultOffset));
+}
+
+DEF_TEST(LightingImageFilterInputOffset, reporter) {
+    // A lit surface whose input starts away from the origin must still be lit from the light's
+    // position in the filter's own space. Constant alpha keeps the surface flat, so only the
+    // distance to the point light varies across it.
+    const int size = 100;
+    SkBitmap src;
+    src.allocN32Pixels(size, size);
+    src.eraseColor(SK_ColorWHITE);
+    SkBitmap device;
+    device.allocN32Pixels(size, size);
+    SkBitmapDevice bitmapDevice(device);
+    SkDeviceImageFilterProxy proxy(&bitmapDevice,
+                                   SkSurfaceProps(SkSurfaceProps::kLegacyFontHost_InitType));
+    SkImageFilter::Context ctx(SkMatrix::I(), SkIRect::MakeWH(size, size), NULL);
+
+    SkPoint3 location(SkIntToScalar(45), SkIntToScalar(55), SkIntToScalar(20));
+    SkImageFilter::CropRect crop(SkRect::MakeXYWH(20, 30, 60, 50));
+    SkAutoTUnref<SkImageFilter> cropped(SkOffsetImageFilter::Create(0, 0, NULL, &crop));
+    SkAutoTUnref<SkImageFilter> offsetLit(SkLightingImageFilter::CreatePointLitDiffuse(
+        location, SK_ColorWHITE, SK_Scalar1, SK_Scalar1, cropped));
+    SkAutoTUnref<SkImageFilter> wholeLit(SkLightingImageFilter::CreatePointLitDiffuse(
+        location, SK_ColorWHITE, SK_Scalar1, SK_Scalar1));
+
+    SkBitmap offsetResult, wholeResult;
+    SkIPoint offsetOrigin = SkIPoint::Make(0, 0), wholeOrigin = SkIPoint::Make(0, 0);
+    REPORTER_ASSERT(reporter, offsetLit->filterImage(&proxy, src, ctx,
+                                                     &offsetResult, &offsetOrigin));
+    REPORTER_ASSERT(reporter, wholeLit->filterImage(&proxy, src, ctx,
+                                                    &wholeResult, &wholeOrigin));
+    REPORTER_ASSERT(reporter, offsetOrigin == SkIPoint::Make(20, 30));
+    REPORTER_ASSERT(reporter, offsetResult.width() == 60 && offsetResult.height() == 50);
+    REPORTER_ASSERT(reporter, wholeOrigin == SkIPoint::Make(0, 0));
+
+    SkAutoLockPixels offsetLock(offsetResult), wholeLock(wholeResult);
+    for (int y = 0; y < offsetResult.height(); ++y) {
+        for (int x = 0; x < offsetResult.width(); ++x) {
+            SkPMColor lit = *wholeResult.getAddr32(x + offsetOrigin.x(), y + offsetOrigin.y());
+            if (*offsetResult.getAddr32(x, y) != lit) {
+                ERRORF(reporter, "pixel (%d, %d) differs", x + offsetOrigin.x(),
+                       y + offsetOrigin.y());
+                return;
+            }
+        }
+    }
+}
+
 static void draw_saveLayer_picture(int width, int height, int tileSize,
                                    SkBBHFactory* factory, SkBitmap* result) {
 
@@ -1136,6 +1330,92 @@ DEF_TEST(ComposedImageFilterOffset, reporter) {
     REPORTER_ASSERT(reporter, offset.fX == 1 && offset.fY == 0);
 }
 
+static void draw_content_keyed_src(SkBitmap* bitmap) {
+    for (int y = 0; y < bitmap->height(); y++) {
+        for (int x = 0; x < bitmap->width(); x++) {
+            *bitmap->getAddr32(x, y) = SkPreMultiplyARGB(0xFF, x * 4, y * 4, (x ^ y) * 4);
+        }
+    }
+    bitmap->notifyPixelsChanged();
+}
+
+// Keyed on content, a src with a new generation ID but the same pixels reuses the result from
+// SkResourceCache, even when the filter's own cache has never seen it.
+DEF_TEST(ImageFilterCacheContentKeyed, reporter) {
+    // Results go to a private resource cache, so other tests can't evict or see them.
+    SkResourceCache resourceCache(16 * 1024 * 1024);
+    SkBitmap device;
+    device.allocN32Pixels(64, 64);
+    SkBitmapDevice bitmapDevice(device);
+    SkDeviceImageFilterProxy proxy(&bitmapDevice,
+                                   SkSurfaceProps(SkSurfaceProps::kLegacyFontHost_InitType));
+
+    SkBitmap src, sameContent;
+    src.allocN32Pixels(64, 64);
+    sameContent.allocN32Pixels(64, 64);
+    draw_content_keyed_src(&src);
+    draw_content_keyed_src(&sameContent);
+    REPORTER_ASSERT(reporter, src.getGenerationID() != sameContent.getGenerationID());
+
+    SkAutoTUnref<SkImageFilter> blur(SkBlurImageFilter::Create(3, 3));
+    SkBitmap first, second, third, fourth, fifth;
+    SkIPoint offset;
+    {
+        SkAutoTUnref<SkImageFilter::Cache> cache(
+                SkImageFilter::Cache::CreateKeyedOnContent(1024 * 1024, &resourceCache));
+        SkImageFilter::Context ctx(SkMatrix::I(), SkIRect::MakeWH(64, 64), cache);
+        REPORTER_ASSERT(reporter, blur->filterImage(&proxy, src, ctx, &first, &offset));
+    }
+    {
+        SkAutoTUnref<SkImageFilter::Cache> cache(
+                SkImageFilter::Cache::CreateKeyedOnContent(1024 * 1024, &resourceCache));
+        SkImageFilter::Context ctx(SkMatrix::I(), SkIRect::MakeWH(64, 64), cache);
+        REPORTER_ASSERT(reporter, blur->filterImage(&proxy, sameContent, ctx, &second, &offset));
+
+        // Changing one pixel must miss.
+        *sameContent.getAddr32(10, 20) ^= 0x00010101;
+        sameContent.notifyPixelsChanged();
+        REPORTER_ASSERT(reporter, blur->filterImage(&proxy, sameContent, ctx, &third, &offset));
+    }
+    {
+        // Caches that don't key on content never share results between generation IDs.
+        SkAutoTUnref<SkImageFilter::Cache> cache(SkImageFilter::Cache::Create(1024 * 1024));
+        SkImageFilter::Context ctx(SkMatrix::I(), SkIRect::MakeWH(64, 64), cache);
+        SkBitmap copy;
+        REPORTER_ASSERT(reporter, src.copyTo(&copy));
+        REPORTER_ASSERT(reporter, blur->filterImage(&proxy, copy, ctx, &fourth, &offset));
+    }
+    {
+        // Redrawing src in place with the same pixels moves its generation ID on, but still hits.
+        const uint32_t genID = src.getGenerationID();
+        draw_content_keyed_src(&src);
+        REPORTER_ASSERT(reporter, src.getGenerationID() != genID);
+        SkAutoTUnref<SkImageFilter::Cache> cache(
+                SkImageFilter::Cache::CreateKeyedOnContent(1024 * 1024, &resourceCache));
+        SkImageFilter::Context ctx(SkMatrix::I(), SkIRect::MakeWH(64, 64), cache);
+        REPORTER_ASSERT(reporter, blur->filterImage(&proxy, src, ctx, &fifth, &offset));
+    }
+    REPORTER_ASSERT(reporter, first.pixelRef() == second.pixelRef());
+    REPORTER_ASSERT(reporter, first.pixelRef() != third.pixelRef());
+    REPORTER_ASSERT(reporter, first.pixelRef() != fourth.pixelRef());
+    REPORTER_ASSERT(reporter, first.pixelRef() == fifth.pixelRef());
+
+    {
+        // Every node of a DAG filtering the same src shares one copy of it: both blurs' results
+        // and the copy, not a copy per result.
+        SkResourceCache dagCache(16 * 1024 * 1024);
+        SkAutoTUnref<SkImageFilter> blurX(SkBlurImageFilter::Create(3, 0));
+        SkAutoTUnref<SkImageFilter> blurY(SkBlurImageFilter::Create(0, 3));
+        SkAutoTUnref<SkImageFilter> merge(SkMergeImageFilter::Create(blurX, blurY));
+        SkAutoTUnref<SkImageFilter::Cache> cache(
+                SkImageFilter::Cache::CreateKeyedOnContent(1024 * 1024, &dagCache));
+        SkImageFilter::Context ctx(SkMatrix::I(), SkIRect::MakeWH(64, 64), cache);
+        SkBitmap merged;
+        REPORTER_ASSERT(reporter, merge->filterImage(&proxy, src, ctx, &merged, &offset));
+        REPORTER_ASSERT(reporter, dagCache.getTotalBytesUsed() < 4 * src.getSize());
+    }
+}
+
 #if SK_SUPPORT_GPU
 const SkSurfaceProps gProps = SkSurfaceProps(SkSurfaceProps::kLegacyFontHost_InitType);
 
@@ -53,3 +53,89 @@ DEF_TEST(MipMap, reporter) {
         }
     }
 }
+
+// The filter SkMipMap should use for each channel: [1 2 1] along odd source dimensions (so no
+// source pixel is dropped), a box along even ones.
+static unsigned expected_channel(const SkMipMap::Level& src, int bpp, int x, int y, int channel) {
+    static const unsigned kOddTaps[] = { 1, 2, 1 };
+    static const unsigned kEvenTaps[] = { 1, 1 };
+    const unsigned* tapsX = (src.fWidth & 1) ? kOddTaps : kEvenTaps;
+    const unsigned* tapsY = (src.fHeight & 1) ? kOddTaps : kEvenTaps;
+    const int countX = (src.fWidth & 1) ? 3 : 2;
+    const int countY = (src.fHeight & 1) ? 3 : 2;
+
+    unsigned sum = 0, weight = 0;
+    for (int j = 0; j < countY; j++) {
+        for (int i = 0; i < countX; i++) {
+            const uint8_t* p = (const uint8_t*)src.fPixels + (2 * y + j) * src.fRowBytes
+                                                           + (2 * x + i) * bpp;
+            sum += tapsX[i] * tapsY[j] * p[channel];
+            weight += tapsX[i] * tapsY[j];
+        }
+    }
+    return sum / weight;
+}
+
+static void check_levels(skiatest::Reporter* reporter, const SkBitmap& bm) {
+    SkAutoTUnref<SkMipMap> mm(SkMipMap::Build(bm, NULL));
+    REPORTER_ASSERT(reporter, mm);
+    if (!mm) {
+        return;
+    }
+
+    // Levels are built lazily, so ask for the smallest first: every level above it must be
+    // built along the way.
+    SkMipMap::Level smallest;
+    REPORTER_ASSERT(reporter, mm->extractLevel(SK_Scalar1 / (1 << 20), &smallest));
+    REPORTER_ASSERT(reporter, 1 == smallest.fWidth || 1 == smallest.fHeight);
+
+    SkAutoLockPixels alp(bm);
+    const int bpp = bm.bytesPerPixel();
+    SkMipMap::Level src;
+    src.fPixels = bm.getPixels();
+    src.fRowBytes = SkToU32(bm.rowBytes());
+    src.fWidth = bm.width();
+    src.fHeight = bm.height();
+    for (int i = 1; src.fWidth > 1 && src.fHeight > 1; i++) {
+        SkMipMap::Level dst;
+        REPORTER_ASSERT(reporter, mm->extractLevel(SK_Scalar1 / (1 << i), &dst));
+        REPORTER_ASSERT(reporter, dst.fWidth == src.fWidth / 2);
+        REPORTER_ASSERT(reporter, dst.fHeight == src.fHeight / 2);
+        for (uint32_t y = 0; y < dst.fHeight; y++) {
+            for (uint32_t x = 0; x < dst.fWidth; x++) {
+                const uint8_t* p = (const uint8_t*)dst.fPixels + y * dst.fRowBytes + x * bpp;
+                for (int c = 0; c < bpp; c++) {
+                    if (p[c] != expected_channel(src, bpp, x, y, c)) {
+                        ERRORF(reporter, "%dx%d level %d: pixel (%d, %d) channel %d is wrong",
+                               bm.width(), bm.height(), i, x, y, c);
+                        return;
+                    }
+                }
+            }
+        }
+        src = dst;
+    }
+}
+
+DEF_TEST(MipMap_oddSizes, reporter) {
+    static const SkColorType kColorTypes[] = { kN32_SkColorType, kAlpha_8_SkColorType };
+    static const int kSizes[] = { 2, 3, 7, 16, 33, 100, 255 };
+
+    SkRandom rand;
+    for (size_t t = 0; t < SK_ARRAY_COUNT(kColorTypes); t++) {
+        for (size_t w = 0; w < SK_ARRAY_COUNT(kSizes); w++) {
+            for (size_t h = 0; h < SK_ARRAY_COUNT(kSizes); h++) {
+                SkBitmap bm;
+                bm.allocPixels(SkImageInfo::Make(kSizes[w], kSizes[h], kColorTypes[t],
+                                                 kPremul_SkAlphaType));
+                for (int y = 0; y < bm.height(); y++) {
+                    uint8_t* row = (uint8_t*)bm.getAddr(0, y);
+                    for (int i = 0; i < bm.width() * bm.bytesPerPixel(); i++) {
+                        row[i] = rand.nextU() & 0xFF;
+                    }
+                }
+                check_levels(reporter, bm);
+            }
+        }
+    }
+}
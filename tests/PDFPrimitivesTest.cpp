@@ -160,6 +160,30 @@ static void TestCatalog(skiatest::Reporter* reporter) {
     REPORTER_ASSERT(reporter, catalog.getObjectNumber(int1Again.get()) == 1);
 }
 
+// Streaming output trims and forgets what it has written; numbers must never be reused.
+static void TestForgetAndTrim(skiatest::Reporter* reporter) {
+    SkPDFObjNumMap catalog;
+    SkAutoTUnref<SkPDFInt> kept(new SkPDFInt(0));
+    catalog.addObject(kept.get());
+    for (int i = 0; i < 100; i++) {
+        SkAutoTUnref<SkPDFInt> temp(new SkPDFInt(i));
+        REPORTER_ASSERT(reporter, catalog.addObject(temp.get()));
+        REPORTER_ASSERT(reporter, catalog.getObjectNumber(temp.get()) == i + 2);
+        catalog.trimObjects();
+        REPORTER_ASSERT(reporter, catalog.objects().isEmpty());
+        REPORTER_ASSERT(reporter, catalog.firstObjectNumber() == i + 3);
+        catalog.forgetObject(temp.get());
+    }
+    REPORTER_ASSERT(reporter, catalog.objectCount() == 101);
+    REPORTER_ASSERT(reporter, catalog.getObjectNumber(kept.get()) == 1);
+    REPORTER_ASSERT(reporter, !catalog.addObject(kept.get()));
+
+    SkAutoTUnref<SkPDFInt> last(new SkPDFInt(0));
+    REPORTER_ASSERT(reporter, catalog.addObject(last.get()));
+    REPORTER_ASSERT(reporter, catalog.objects().count() == 1);
+    REPORTER_ASSERT(reporter, catalog.getObjectNumber(last.get()) == 102);
+}
+
 static void TestObjectRef(skiatest::Reporter* reporter) {
     SkAutoTUnref<SkPDFInt> int1(new SkPDFInt(1));
     SkAutoTUnref<SkPDFInt> int2(new SkPDFInt(2));
@@ -286,6 +310,8 @@ DEF_TEST(PDFPrimitives, reporter) {
 
     TestCatalog(reporter);
 
+    TestForgetAndTrim(reporter);
+
     TestObjectRef(reporter);
 
     TestSubstitute(reporter);
@@ -34,6 +34,14 @@ public:
         // With an R-Tree
         SkRTreeFactory RTreeFactory;
         this->run(&RTreeFactory, reporter);
+
+        // With a Hilbert-packed R-Tree
+        SkHilbertRTreeFactory hilbertRTreeFactory;
+        this->run(&hilbertRTreeFactory, reporter);
+
+        // With an incrementally built R-Tree
+        SkIncrementalRTreeFactory incrementalRTreeFactory;
+        this->run(&incrementalRTreeFactory, reporter);
     }
 
 private:
@@ -25,9 +25,11 @@
 #include "SkPixelSerializer.h"
 #include "SkRRect.h"
 #include "SkRandom.h"
+#include "SkReadBuffer.h"
 #include "SkRecord.h"
 #include "SkShader.h"
 #include "SkStream.h"
+#include "SkWriteBuffer.h"
 #include "sk_tool_utils.h"
 
 #if SK_SUPPORT_GPU
@@ -1119,7 +1121,7 @@ static void test_bytes_used(skiatest::Reporter* reporter) {
 
     // Protect against any unintentional bloat.
     size_t approxUsed = SkPictureUtils::ApproximateBytesUsed(empty.get());
-    REPORTER_ASSERT(reporter, approxUsed <= 416);
+    REPORTER_ASSERT(reporter, approxUsed <= 424);
 
     // Sanity check of nested SkPictures.
     SkPictureRecorder r2;
@@ -1323,3 +1325,78 @@ DEF_TEST(Picture_getRecordingCanvas, r) {
         REPORTER_ASSERT(r, !rec.getRecordingCanvas());
     }
 }
+
+// Pictures loaded in place from an SkData should keep it alive and draw just like a copy.
+DEF_TEST(Picture_CreateFromData, r) {
+    SkBitmap bm;
+    make_bm(&bm, 10, 10, SK_ColorBLUE, true);
+
+    const SkPoint verts[] = { {5, 5}, {60, 10}, {30, 70} };
+    const SkColor colors[] = { SK_ColorRED, SK_ColorGREEN, SK_ColorBLUE };
+    const SkPoint pos[] = { {10, 80}, {20, 80}, {30, 80}, {40, 80} };
+
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(100, 100);
+    SkPaint paint;
+    canvas->drawBitmap(bm, 70, 70);
+    canvas->drawText("Hello", 5, 10, 90, paint);
+    canvas->drawPosText("skia", 4, pos, paint);
+    canvas->drawVertices(SkCanvas::kTriangles_VertexMode, 3, verts, NULL, colors,
+                         NULL, NULL, 0, paint);
+    SkAutoTUnref<SkPicture> picture(recorder.endRecording());
+
+    SkAutoTUnref<SkData> data;
+    {
+        SkDynamicMemoryWStream wStream;
+        picture->serialize(&wStream);
+        data.reset(wStream.copyToData());
+    }
+
+    SkMemoryStream stream(data);
+    SkAutoTUnref<SkPicture> copied(SkPicture::CreateFromStream(&stream));
+    SkAutoTUnref<SkPicture> shared(SkPicture::CreateFromData(data));
+    REPORTER_ASSERT(r, copied && shared);
+    if (!copied || !shared) {
+        return;
+    }
+    REPORTER_ASSERT(r, !data->unique());
+
+    SkBitmap expected, actual;
+    expected.allocN32Pixels(100, 100);
+    actual.allocN32Pixels(100, 100);
+    expected.eraseColor(SK_ColorWHITE);
+    actual.eraseColor(SK_ColorWHITE);
+    SkCanvas expectedCanvas(expected), actualCanvas(actual);
+    copied->playback(&expectedCanvas);
+    shared->playback(&actualCanvas);
+    REPORTER_ASSERT(r, 0 == memcmp(expected.getPixels(), actual.getPixels(), expected.getSize()));
+
+    copied.reset(NULL);
+    shared.reset(NULL);
+    stream.setMemory(NULL, 0);
+    REPORTER_ASSERT(r, data->unique());
+}
+
+// Byte arrays shared out of the backing data must be all there.
+DEF_TEST(Picture_CreateFromData_truncated, r) {
+    char bytes[100];
+    memset(bytes, 0x5A, sizeof(bytes));
+    SkWriteBuffer writer;
+    writer.writeByteArray(bytes, sizeof(bytes));
+    SkAutoTUnref<SkData> data(SkData::NewUninitialized(writer.bytesWritten()));
+    writer.writeToMemory(data->writable_data());
+
+    {
+        SkReadBuffer reader(data->data(), data->size());
+        reader.setBackingData(data);
+        SkAutoTUnref<SkData> shared(reader.readByteArrayAsData());
+        REPORTER_ASSERT(r, sizeof(bytes) == shared->size());
+        REPORTER_ASSERT(r, (const char*)shared->data() == (const char*)data->data() + 4);
+    }
+
+    SkAutoTUnref<SkData> truncated(SkData::NewSubset(data, 0, data->size() - 8));
+    SkReadBuffer reader(truncated->data(), truncated->size());
+    reader.setBackingData(truncated);
+    SkAutoTUnref<SkData> shared(reader.readByteArrayAsData());
+    REPORTER_ASSERT(r, 0 == shared->size());
+}
@@ -0,0 +1,208 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBitmap.h"
+#include "SkColorPriv.h"
+#include "SkData.h"
+#include "SkForceLinking.h"
+#include "SkImageDecoder.h"
+#include "SkImageEncoder.h"
+#include "SkPNGImageEncoder.h"
+#include "SkRandom.h"
+#include "SkTDArray.h"
+#include "SkTemplates.h"
+#include "SkTransformScanline_opts.h"
+#include "SkUnPreMultiply.h"
+#include "Test.h"
+
+__SK_FORCE_IMAGE_DECODER_LINKING;
+
+// The portable transforms from src/images/transform_scanline.h, one pixel at a time.
+static void expected_pixel(SkTransformScanlineProcType type, SkPMColor c, uint8_t* dst) {
+    unsigned a = SkGetPackedA32(c);
+    unsigned r = SkGetPackedR32(c);
+    unsigned g = SkGetPackedG32(c);
+    unsigned b = SkGetPackedB32(c);
+    if (kN32_To_RGB_SkTransformScanlineProcType == type) {
+        dst[0] = r;
+        dst[1] = g;
+        dst[2] = b;
+        return;
+    }
+    if (0 != a && 255 != a) {
+        SkUnPreMultiply::Scale scale = SkUnPreMultiply::GetScale(a);
+        r = SkUnPreMultiply::ApplyScale(scale, r);
+        g = SkUnPreMultiply::ApplyScale(scale, g);
+        b = SkUnPreMultiply::ApplyScale(scale, b);
+    }
+    dst[0] = r;
+    dst[1] = g;
+    dst[2] = b;
+    dst[3] = a;
+}
+
+// The platform transforms must match the portable ones exactly, even for colors that are not
+// validly premultiplied.
+DEF_TEST(PngEncoder_transforms, r) {
+    static const SkTransformScanlineProcType kTypes[] = {
+        kN32_To_RGB_SkTransformScanlineProcType,
+        kN32_To_RGBA_Unpremul_SkTransformScanlineProcType,
+    };
+    SkRandom rand;
+    for (size_t t = 0; t < SK_ARRAY_COUNT(kTypes); t++) {
+        SkTransformScanlineProc proc = SkTransformScanlineGetPlatformProc(kTypes[t]);
+        if (NULL == proc) {
+            continue;
+        }
+        const int bpp = kN32_To_RGB_SkTransformScanlineProcType == kTypes[t] ? 3 : 4;
+        for (int width = 1; width <= 37; width++) {
+            SkAutoTMalloc<SkPMColor> src(width);
+            for (int x = 0; x < width; x++) {
+                src[x] = rand.nextU();
+            }
+            // Rows of all opaque or transparent pixels take a shortcut.
+            if (width % 3 == 0) {
+                for (int x = 0; x < width; x++) {
+                    src[x] |= SkPackARGB32NoCheck(0xFF, 0, 0, 0);
+                }
+            }
+            if (width % 5 == 0) {
+                src[width / 2] &= ~SkPackARGB32NoCheck(0xFF, 0, 0, 0);
+            }
+
+            SkAutoTMalloc<uint8_t> dst(width * bpp);
+            proc((const char*)src.get(), width, (char*)dst.get());
+            for (int x = 0; x < width; x++) {
+                uint8_t expected[4];
+                expected_pixel(kTypes[t], src[x], expected);
+                if (memcmp(expected, dst.get() + x * bpp, bpp)) {
+                    ERRORF(r, "type %d width %d: pixel %d (%08x) transformed wrong",
+                           kTypes[t], width, x, src[x]);
+                    break;
+                }
+            }
+        }
+    }
+}
+
+// SkPNGImageEncoder is only built where Skia uses libpng.
+#if defined(SK_BUILD_FOR_ANDROID) || defined(SK_BUILD_FOR_UNIX)
+
+static SkData* encode(const SkBitmap& bm, const SkPNGImageEncoder::Options& options) {
+    SkPNGImageEncoder encoder(options);
+    return encoder.encodeData(bm, 100);
+}
+
+static bool pixels_equal(const SkBitmap& a, const SkBitmap& b) {
+    if (a.width() != b.width() || a.height() != b.height()) {
+        return false;
+    }
+    SkAutoLockPixels alpA(a), alpB(b);
+    for (int y = 0; y < a.height(); y++) {
+        if (memcmp(a.getAddr32(0, y), b.getAddr32(0, y), a.width() * sizeof(SkPMColor))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Every combination of options must decode to the same pixels.
+static void check_options(skiatest::Reporter* r, const SkBitmap& bm, const SkBitmap& expected) {
+    typedef SkPNGImageEncoder::Options Options;
+    SkTDArray<Options> variants;
+    variants.push(Options());
+    for (int threads = 2; threads <= 16; threads *= 2) {
+        variants.push(Options());
+        variants.top().fThreadCount = threads;
+    }
+    for (unsigned flag = Options::kNone_FilterFlag; flag <= Options::kPaeth_FilterFlag;
+         flag <<= 1) {
+        variants.push(Options());
+        variants.top().fFilterFlags = flag;
+    }
+    static const Options::Strategy kStrategies[] = {
+        Options::kDefault_Strategy, Options::kHuffmanOnly_Strategy, Options::kRLE_Strategy,
+    };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(kStrategies); i++) {
+        variants.push(Options());
+        variants.top().fStrategy = kStrategies[i];
+    }
+    for (int level = 0; level <= 9; level += 3) {
+        variants.push(Options());
+        variants.top().fZLibLevel = level;
+    }
+    variants.push(Options());
+    variants.top().fStrategy = Options::kRLE_Strategy;
+    variants.top().fThreadCount = 3;
+
+    for (int i = 0; i < variants.count(); i++) {
+        SkAutoTUnref<SkData> data(encode(bm, variants[i]));
+        REPORTER_ASSERT(r, data);
+        if (!data) {
+            continue;
+        }
+        SkBitmap decoded;
+        if (!SkImageDecoder::DecodeMemory(data->data(), data->size(), &decoded,
+                                          kN32_SkColorType, SkImageDecoder::kDecodePixels_Mode)) {
+            ERRORF(r, "options %d: could not decode", i);
+            continue;
+        }
+        if (!pixels_equal(decoded, expected)) {
+            ERRORF(r, "options %d: decoded pixels differ", i);
+        }
+    }
+}
+
+DEF_TEST(PngEncoder_options, r) {
+    SkRandom rand;
+    SkBitmap opaque;
+    opaque.allocN32Pixels(67, 129, true);
+    SkBitmap alpha;
+    alpha.allocN32Pixels(67, 129);
+    for (int y = 0; y < opaque.height(); y++) {
+        for (int x = 0; x < opaque.width(); x++) {
+            // Smooth gradients give the filters something to find, noise keeps zlib honest.
+            const U8CPU noise = rand.nextU() & 0xF;
+            *opaque.getAddr32(x, y) = SkPackARGB32(0xFF, 2 * x + noise, y, (x + y) & 0xFF);
+            *alpha.getAddr32(x, y) = SkPreMultiplyARGB(y % 3 ? y + 100 : 0, 3 * x, y + noise,
+                                                       rand.nextU() & 0xFF);
+        }
+    }
+
+    check_options(r, opaque, opaque);
+
+    SkAutoTUnref<SkData> data(encode(alpha, SkPNGImageEncoder::Options()));
+    SkBitmap reference;
+    REPORTER_ASSERT(r, data && SkImageDecoder::DecodeMemory(data->data(), data->size(),
+            &reference, kN32_SkColorType, SkImageDecoder::kDecodePixels_Mode));
+    check_options(r, alpha, reference);
+
+    // Palette images are never filtered, but can still be deflated in bands.
+    SkPMColor colors[4] = {
+        SkPackARGB32(0xFF, 0, 0, 0), SkPackARGB32(0xFF, 0xFF, 0xFF, 0xFF),
+        SkPackARGB32(0xFF, 0xFF, 0, 0), SkPackARGB32(0xFF, 0x12, 0x34, 0x56),
+    };
+    SkAutoTUnref<SkColorTable> ctable(SkNEW_ARGS(SkColorTable, (colors, 4)));
+    SkBitmap index8;
+    index8.allocPixels(SkImageInfo::Make(50, 90, kIndex_8_SkColorType, kOpaque_SkAlphaType),
+                       NULL, ctable);
+    for (int y = 0; y < index8.height(); y++) {
+        for (int x = 0; x < index8.width(); x++) {
+            *index8.getAddr8(x, y) = (x / 7 + y) & 3;
+        }
+    }
+    SkBitmap index8AsN32;
+    index8AsN32.allocN32Pixels(index8.width(), index8.height(), true);
+    for (int y = 0; y < index8.height(); y++) {
+        for (int x = 0; x < index8.width(); x++) {
+            *index8AsN32.getAddr32(x, y) = index8.getIndex8Color(x, y);
+        }
+    }
+    check_options(r, index8, index8AsN32);
+}
+
+#endif  // SK_BUILD_FOR_ANDROID || SK_BUILD_FOR_UNIX
@@ -5,6 +5,7 @@
  * found in the LICENSE file.
  */
 
+#include "SkIncrementalRTree.h"
 #include "SkRTree.h"
 #include "SkRandom.h"
 #include "Test.h"
@@ -25,10 +26,11 @@ static SkRect random_rect(SkRandom& rand) {
     return rect;
 }
 
-static bool verify_query(SkRect query, SkRect rects[], SkTDArray<unsigned>& found) {
+static bool verify_query(SkRect query, SkRect rects[], SkTDArray<unsigned>& found,
+                         int numRects = NUM_RECTS) {
     SkTDArray<unsigned> expected;
     // manually intersect with every rectangle
-    for (int i = 0; i < NUM_RECTS; ++i) {
+    for (int i = 0; i < numRects; ++i) {
         if (SkRect::Intersects(query, rects[i])) {
             expected.push(i);
         }
@@ -44,16 +46,16 @@ static bool verify_query(SkRect query, SkRect rects[], SkTDArray<unsigned>& foun
 }
 
 static void run_queries(skiatest::Reporter* reporter, SkRandom& rand, SkRect rects[],
-                        const SkRTree& tree) {
+                        const SkBBoxHierarchy& tree, int numRects = NUM_RECTS) {
     for (size_t i = 0; i < NUM_QUERIES; ++i) {
         SkTDArray<unsigned> hits;
         SkRect query = random_rect(rand);
         tree.search(query, &hits);
-        REPORTER_ASSERT(reporter, verify_query(query, rects, hits));
+        REPORTER_ASSERT(reporter, verify_query(query, rects, hits, numRects));
     }
 }
 
-DEF_TEST(RTree, reporter) {
+static void test_rtree(skiatest::Reporter* reporter, SkRTree::BulkLoad bulkLoad) {
     int expectedDepthMin = -1;
     int tmp = NUM_RECTS;
     while (tmp > 0) {
@@ -73,7 +75,7 @@ DEF_TEST(RTree, reporter) {
     SkRandom rand;
     SkAutoTMalloc<SkRect> rects(NUM_RECTS);
     for (size_t i = 0; i < NUM_ITERATIONS; ++i) {
-        SkRTree rtree;
+        SkRTree rtree(1, bulkLoad);
         REPORTER_ASSERT(reporter, 0 == rtree.getCount());
 
         for (int j = 0; j < NUM_RECTS; j++) {
@@ -89,3 +91,46 @@ DEF_TEST(RTree, reporter) {
                                   expectedDepthMax >= rtree.getDepth());
     }
 }
+
+DEF_TEST(RTree, reporter) {
+    test_rtree(reporter, SkRTree::kSTR_BulkLoad);
+}
+
+DEF_TEST(RTree_Hilbert, reporter) {
+    test_rtree(reporter, SkRTree::kHilbert_BulkLoad);
+}
+
+// Append rects a few at a time, checking every query against everything inserted so far.
+DEF_TEST(RTree_Incremental, reporter) {
+    static const int kNumRects = 1000;
+
+    SkRandom rand;
+    SkAutoTMalloc<SkRect> rects(kNumRects);
+    for (int j = 0; j < kNumRects; j++) {
+        rects[j] = random_rect(rand);
+    }
+
+    SkIncrementalRTree rtree;
+    REPORTER_ASSERT(reporter, 0 == rtree.getCount());
+    REPORTER_ASSERT(reporter, rtree.getRootBound().isEmpty());
+
+    int inserted = 0;
+    while (inserted < kNumRects) {
+        const int n = SkTMin(rand.nextRangeU(1, 2 * SkIncrementalRTree::kBufferSize),
+                             (uint32_t)(kNumRects - inserted));
+        rtree.insert(rects.get() + inserted, n);
+        inserted += n;
+
+        REPORTER_ASSERT(reporter, inserted == rtree.getCount());
+        run_queries(reporter, rand, rects, rtree, inserted);
+
+        // Trees at least double in size going down the stack, so there can't be many.
+        REPORTER_ASSERT(reporter, (1 << rtree.getTreeCount()) <= inserted + 1);
+    }
+
+    SkRect bounds = rects[0];
+    for (int j = 1; j < kNumRects; j++) {
+        bounds.join(rects[j]);
+    }
+    REPORTER_ASSERT(reporter, bounds == rtree.getRootBound());
+}
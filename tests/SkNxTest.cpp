@@ -77,3 +77,60 @@ DEF_TEST(SkNf, r) {
     test_Nf<4, float>(r);
     test_Nf<4, double>(r);
 }
+
+template <int N, typename T>
+static void test_Ni(skiatest::Reporter* r) {
+    auto assert_eq = [&](const SkNi<N,T>& v, const T* expected) {
+        T vals[N];
+        v.store(vals);
+        for (int i = 0; i < N; i++) {
+            REPORTER_ASSERT(r, vals[i] == expected[i]);
+        }
+        REPORTER_ASSERT(r, v.template kth<0>() == expected[0]);
+        REPORTER_ASSERT(r, v.template kth<N-1>() == expected[N-1]);
+    };
+
+    T vals[] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    SkNi<N,T> a = SkNi<N,T>::Load(vals),
+              b(a),
+              c = a;
+    SkNi<N,T> d;
+    d = a;
+
+    assert_eq(a, vals);
+    assert_eq(b, vals);
+    assert_eq(c, vals);
+    assert_eq(d, vals);
+
+    T sums[] = { 2, 4, 6, 8, 10, 12, 14, 16 };
+    assert_eq(a+b, sums);
+    assert_eq(a<<1, sums);
+    assert_eq((a+b)>>1, vals);
+    assert_eq(a+b-a, vals);
+
+    T squares[] = { 1, 4, 9, 16, 25, 36, 49, 64 };
+    assert_eq(a*b, squares);
+
+    T threes[] = { 3, 3, 3, 3, 3, 3, 3, 3 };
+    assert_eq(SkNi<N,T>(3), threes);
+
+    uint8_t bytes[] = { 0, 1, 127, 128, 254, 255, 42, 200 };
+    SkNi<N,T> widened = SkNi<N,T>::FromBytes(bytes);
+    T widenedVals[N];
+    widened.store(widenedVals);
+    uint8_t narrowed[N];
+    widened.toBytes(narrowed);
+    for (int i = 0; i < N; i++) {
+        REPORTER_ASSERT(r, widenedVals[i] == bytes[i]);
+        REPORTER_ASSERT(r, narrowed[i] == bytes[i]);
+    }
+}
+
+DEF_TEST(SkNi, r) {
+    test_Ni<2, uint16_t>(r);
+    test_Ni<4, uint16_t>(r);
+    test_Ni<8, uint16_t>(r);
+
+    test_Ni<2, uint32_t>(r);
+    test_Ni<4, uint32_t>(r);
+}
@@ -286,3 +286,149 @@ DEF_TEST(BitmapCache_discarded_bitmap, reporter) {
     test_bitmap_notify(reporter, cache);
     test_mipmap_notify(reporter, cache);
 }
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include "SkTaskGroup.h"
+
+namespace {
+static int gTestNamespaceA, gTestNamespaceB;
+
+struct TestKey : public SkResourceCache::Key {
+    int32_t fValue;
+
+    TestKey(void* nameSpace, int value) : fValue(value) {
+        this->init(nameSpace, 0, sizeof(fValue));
+    }
+};
+
+struct TestRec : public SkResourceCache::Rec {
+    TestKey fKey;
+    size_t  fBytes;
+
+    TestRec(const TestKey& key, size_t bytes) : fKey(key), fBytes(bytes) {}
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return fBytes; }
+
+    static bool Visitor(const SkResourceCache::Rec&, void*) { return true; }
+};
+
+// Looks the value up, adding it if it wasn't found, as the caches built on this one do.
+bool find_or_add(SkResourceCache* cache, void* nameSpace, int value, size_t bytes) {
+    const TestKey key(nameSpace, value);
+    if (cache->find(key, TestRec::Visitor, NULL)) {
+        return true;
+    }
+    cache->add(SkNEW_ARGS(TestRec, (key, bytes)));
+    return false;
+}
+
+struct StatsFinder {
+    const void*            fNamespace;
+    SkResourceCache::Stats fStats;
+
+    static void Visitor(const void* nameSpace, const SkResourceCache::Stats& stats, void* ctx) {
+        StatsFinder* finder = (StatsFinder*)ctx;
+        if (nameSpace == finder->fNamespace) {
+            finder->fStats = stats;
+        }
+    }
+};
+
+// The Stats kept for nameSpace by cache, or by the global cache if it is NULL.
+SkResourceCache::Stats get_stats(const SkResourceCache* cache, const void* nameSpace) {
+    StatsFinder finder;
+    finder.fNamespace = nameSpace;
+    sk_bzero(&finder.fStats, sizeof(finder.fStats));
+    if (cache) {
+        cache->visitStats(StatsFinder::Visitor, &finder);
+    } else {
+        SkResourceCache::VisitStats(StatsFinder::Visitor, &finder);
+    }
+    return finder.fStats;
+}
+}  // namespace
+
+DEF_TEST(ResourceCache_stats, reporter) {
+    SkResourceCache cache(1024);
+    for (int i = 0; i < 4; i++) {
+        find_or_add(&cache, &gTestNamespaceA, i, 100);
+    }
+    find_or_add(&cache, &gTestNamespaceA, 0, 100);
+    find_or_add(&cache, &gTestNamespaceB, 0, 50);
+    find_or_add(&cache, &gTestNamespaceB, 0, 50);
+
+    SkResourceCache::Stats a = get_stats(&cache, &gTestNamespaceA),
+                           b = get_stats(&cache, &gTestNamespaceB);
+    REPORTER_ASSERT(reporter, 1 == a.fHits && 4 == a.fMisses && 0 == a.fRejected);
+    REPORTER_ASSERT(reporter, 4 == a.fCount && 400 == a.fBytesUsed);
+    REPORTER_ASSERT(reporter, 1 == b.fHits && 1 == b.fMisses);
+    REPORTER_ASSERT(reporter, 1 == b.fCount && 50 == b.fBytesUsed);
+
+    cache.purgeAll();
+    a = get_stats(&cache, &gTestNamespaceA);
+    REPORTER_ASSERT(reporter, 1 == a.fHits && 0 == a.fCount && 0 == a.fBytesUsed);
+}
+
+// With the admission policy, a stream of one-off entries should not push out ones in steady use.
+static int count_hot_entries_kept(bool useAdmissionPolicy) {
+    const int kHot = 8;
+    SkResourceCache cache(16 * 100);
+    cache.setUseAdmissionPolicy(useAdmissionPolicy);
+    for (int round = 0; round < 4; round++) {
+        for (int i = 0; i < kHot; i++) {
+            find_or_add(&cache, &gTestNamespaceA, i, 100);
+        }
+    }
+    for (int i = 0; i < 100; i++) {
+        find_or_add(&cache, &gTestNamespaceB, i, 100);
+    }
+
+    int kept = 0;
+    for (int i = 0; i < kHot; i++) {
+        kept += find_or_add(&cache, &gTestNamespaceA, i, 100);
+    }
+    return kept;
+}
+
+DEF_TEST(ResourceCache_admissionPolicy, reporter) {
+    REPORTER_ASSERT(reporter, 0 == count_hot_entries_kept(false));
+    REPORTER_ASSERT(reporter, 8 == count_hot_entries_kept(true));
+
+    SkResourceCache cache(300);
+    cache.setUseAdmissionPolicy(true);
+    find_or_add(&cache, &gTestNamespaceA, 0, 100);
+    find_or_add(&cache, &gTestNamespaceA, 0, 100);
+    find_or_add(&cache, &gTestNamespaceA, 1, 100);
+    find_or_add(&cache, &gTestNamespaceA, 1, 100);
+    // Adding this would put us at the limit, and it's been asked for less than 0 or 1.
+    find_or_add(&cache, &gTestNamespaceA, 2, 100);
+    const SkResourceCache::Stats stats = get_stats(&cache, &gTestNamespaceA);
+    REPORTER_ASSERT(reporter, 1 == stats.fRejected && 2 == stats.fCount);
+}
+
+// Threads hammering the global cache, spread over its shards, keep its accounting straight.
+DEF_TEST(ResourceCache_sharded, reporter) {
+    static int gNamespace;
+    const int kValues = 64;
+    const size_t kBytes = 16;
+    const SkResourceCache::Stats before = get_stats(NULL, &gNamespace);
+
+    sk_parallel_for(8, 1, [&](int thread) {
+        for (int i = 0; i < 4 * kValues; i++) {
+            const int value = (i * (2 * thread + 1)) % kValues;
+            const TestKey key(&gNamespace, value);
+            if (!SkResourceCache::Find(key, TestRec::Visitor, NULL)) {
+                SkResourceCache::Add(SkNEW_ARGS(TestRec, (key, kBytes)));
+            }
+        }
+    });
+
+    const SkResourceCache::Stats after = get_stats(NULL, &gNamespace);
+    REPORTER_ASSERT(reporter, after.fHits + after.fMisses - before.fHits - before.fMisses ==
+                              8 * 4 * kValues);
+    REPORTER_ASSERT(reporter, after.fCount <= kValues);
+    REPORTER_ASSERT(reporter, after.fBytesUsed == after.fCount * kBytes);
+    REPORTER_ASSERT(reporter, after.fBytesUsed <= SkResourceCache::GetTotalBytesUsed());
+}
@@ -0,0 +1,124 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkRandom.h"
+#include "SkSlabAllocator.h"
+#include "SkTDArray.h"
+#include "Test.h"
+
+DEF_TEST(SlabAllocator_sizeClasses, reporter) {
+    size_t prev = 0;
+    for (int i = 0; i < SkSlabAllocator::kSizeClassCount; i++) {
+        const size_t bytes = SkSlabAllocator::BlockBytes(i);
+        REPORTER_ASSERT(reporter, bytes > prev);
+        // No block wastes more than a quarter of itself on rounding up.
+        REPORTER_ASSERT(reporter, 0 == prev || (bytes - prev) * 4 <= bytes);
+        prev = bytes;
+    }
+    REPORTER_ASSERT(reporter, 256 == SkSlabAllocator::BlockBytes(0));
+    REPORTER_ASSERT(reporter, 256 * 1024 ==
+                              SkSlabAllocator::BlockBytes(SkSlabAllocator::kSizeClassCount - 1));
+}
+
+static int total_slabs(const SkSlabAllocator& allocator) {
+    int slabs = 0;
+    for (int i = 0; i < SkSlabAllocator::kSizeClassCount; i++) {
+        SkSlabAllocator::SizeClassStats stats;
+        allocator.getSizeClassStats(i, &stats);
+        slabs += stats.fSlabCount;
+    }
+    return slabs;
+}
+
+// Blocks of all sizes keep their contents, and freeing them all gives every page back.
+DEF_TEST(SlabAllocator, reporter) {
+    SkSlabAllocator allocator;
+    SkRandom rand;
+    SkTDArray<SkSlabAllocator::Block> blocks;
+    for (int i = 0; i < 500; i++) {
+        const size_t bytes = 1 + rand.nextULessThan(i % 50 ? 20000 : 400000);
+        SkSlabAllocator::Block* block = blocks.append();
+        REPORTER_ASSERT(reporter, allocator.alloc(bytes, block));
+        REPORTER_ASSERT(reporter, bytes == block->fBytes);
+        memset(block->fPtr, i & 0xFF, bytes);
+    }
+    REPORTER_ASSERT(reporter, allocator.largeBytes() > 0);
+
+    size_t requested = 0;
+    for (int i = 0; i < SkSlabAllocator::kSizeClassCount; i++) {
+        SkSlabAllocator::SizeClassStats stats;
+        allocator.getSizeClassStats(i, &stats);
+        REPORTER_ASSERT(reporter, stats.fBlocksUsed <= stats.fBlocksTotal);
+        REPORTER_ASSERT(reporter, stats.fBytesRequested <= stats.fBlocksUsed * stats.fBlockBytes);
+        requested += stats.fBytesRequested;
+    }
+    REPORTER_ASSERT(reporter, requested + allocator.largeBytes() <= allocator.committedBytes());
+    // Slabs and large blocks are whole pages of whatever size the OS uses.
+    REPORTER_ASSERT(reporter, SkIsPow2((int)allocator.pageBytes()));
+    REPORTER_ASSERT(reporter, 0 == allocator.largeBytes() % allocator.pageBytes());
+    REPORTER_ASSERT(reporter, 0 == allocator.committedBytes() % allocator.pageBytes());
+
+    // Free every other block, checking nothing was overwritten.
+    for (int i = blocks.count() - 1; i >= 0; i -= 2) {
+        const uint8_t* p = (const uint8_t*)blocks[i].fPtr;
+        for (size_t j = 0; j < blocks[i].fBytes; j++) {
+            if (p[j] != (i & 0xFF)) {
+                ERRORF(reporter, "block %d byte %d overwritten", i, (int)j);
+                break;
+            }
+        }
+        allocator.free(blocks[i]);
+        blocks.remove(i);
+    }
+    for (int i = 0; i < blocks.count(); i++) {
+        allocator.free(blocks[i]);
+    }
+    REPORTER_ASSERT(reporter, 0 == allocator.committedBytes());
+    REPORTER_ASSERT(reporter, 0 == total_slabs(allocator));
+}
+
+// New blocks go into the fullest slab, so slabs drained by churn are given back.
+DEF_TEST(SlabAllocator_packing, reporter) {
+    SkSlabAllocator allocator;
+    const size_t kBytes = 4096;
+    SkTDArray<SkSlabAllocator::Block> blocks;
+    blocks.setCount(64);
+    for (int i = 0; i < blocks.count(); i++) {
+        allocator.alloc(kBytes, &blocks[i]);
+    }
+    SkSlabAllocator::SizeClassStats stats;
+    allocator.getSizeClassStats(16, &stats);
+    REPORTER_ASSERT(reporter, kBytes == stats.fBlockBytes);
+    REPORTER_ASSERT(reporter, 4 == stats.fSlabCount && 64 == stats.fBlocksUsed);
+    const size_t committed = allocator.committedBytes();
+
+    // Free three in four, then allocate as many again: they fill the holes in the first slabs.
+    SkTDArray<SkSlabAllocator::Block> kept;
+    for (int i = 0; i < blocks.count(); i++) {
+        if (i % 4) {
+            allocator.free(blocks[i]);
+        } else {
+            *kept.append() = blocks[i];
+        }
+    }
+    for (int i = 0; i < 16; i++) {
+        allocator.alloc(kBytes, kept.append());
+    }
+    allocator.getSizeClassStats(16, &stats);
+    REPORTER_ASSERT(reporter, 4 == stats.fSlabCount && 32 == stats.fBlocksUsed);
+
+    // Emptying the last slabs hands them back.
+    for (int i = 0; i < 16; i++) {
+        allocator.free(kept[i]);
+    }
+    allocator.getSizeClassStats(16, &stats);
+    REPORTER_ASSERT(reporter, stats.fSlabCount < 4 && 16 == stats.fBlocksUsed);
+    REPORTER_ASSERT(reporter, allocator.committedBytes() < committed);
+    for (int i = 16; i < kept.count(); i++) {
+        allocator.free(kept[i]);
+    }
+}
@@ -0,0 +1,83 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkColorPriv.h"
+#include "SkRandom.h"
+#include "SkSwizzler.h"
+#include "SkTemplates.h"
+#include "Test.h"
+
+// Expected results for a byte-per-channel source, computed one pixel at a time.
+static SkPMColor expected_pixel(SkSwizzler::SrcConfig sc, SkAlphaType alphaType,
+                                const uint8_t* p) {
+    const bool bgr = SkSwizzler::kBGR == sc || SkSwizzler::kBGRX == sc
+                  || SkSwizzler::kBGRA == sc;
+    const bool hasAlpha = SkSwizzler::kRGBA == sc || SkSwizzler::kBGRA == sc;
+    const uint8_t r = p[bgr ? 2 : 0],
+                  g = p[1],
+                  b = p[bgr ? 0 : 2],
+                  a = hasAlpha ? p[3] : 0xFF;
+    return kUnpremul_SkAlphaType == alphaType ? SkPackARGB32NoCheck(a, r, g, b)
+                                              : SkPreMultiplyARGB(a, r, g, b);
+}
+
+static void check_swizzle(skiatest::Reporter* r, SkRandom* rand, SkSwizzler::SrcConfig sc,
+                          SkAlphaType alphaType, int width, bool opaqueRow) {
+    const int bpp = SkSwizzler::BytesPerPixel(sc);
+    SkAutoTMalloc<uint8_t> src(width * bpp);
+    for (int i = 0; i < width * bpp; i++) {
+        src[i] = opaqueRow && 3 == i % 4 ? 0xFF : rand->nextU() & 0xFF;
+    }
+    // A zero alpha in the middle exercises the transparent pixel path.
+    if (!opaqueRow && width > 5 && 4 == bpp) {
+        src[4 * 5 + 3] = 0;
+    }
+
+    const SkImageInfo info = SkImageInfo::MakeN32(width, 1, alphaType);
+    SkAutoTMalloc<SkPMColor> dst(width);
+    SkAutoTDelete<SkSwizzler> swizzler(SkSwizzler::CreateSwizzler(sc, NULL, info, dst.get(),
+            info.minRowBytes(), SkImageGenerator::kNo_ZeroInitialized));
+    REPORTER_ASSERT(r, swizzler);
+    if (!swizzler) {
+        return;
+    }
+    const SkSwizzler::ResultAlpha result = swizzler->next(src.get());
+
+    uint8_t maxAlpha = 0xFF, zeroAlpha = 0;
+    for (int x = 0; x < width; x++) {
+        const SkPMColor expected = expected_pixel(sc, alphaType, src.get() + x * bpp);
+        if (expected != dst[x]) {
+            ERRORF(r, "config %d alpha %d width %d: pixel %d is %08x, expected %08x",
+                   sc, alphaType, width, x, dst[x], expected);
+            return;
+        }
+        maxAlpha  &= SkGetPackedA32(expected);
+        zeroAlpha |= SkGetPackedA32(expected);
+    }
+    REPORTER_ASSERT(r, SkSwizzler::GetResult(zeroAlpha, maxAlpha) == result);
+}
+
+// Whatever row proc SkSwizzler picks for this CPU must match the portable math exactly,
+// including the tails that don't fill a whole vector.
+DEF_TEST(Swizzler_N32, r) {
+    const SkSwizzler::SrcConfig configs[] = {
+        SkSwizzler::kRGB, SkSwizzler::kBGR, SkSwizzler::kRGBX, SkSwizzler::kBGRX,
+        SkSwizzler::kRGBA, SkSwizzler::kBGRA,
+    };
+    const SkAlphaType alphaTypes[] = { kPremul_SkAlphaType, kUnpremul_SkAlphaType };
+    const int widths[] = { 1, 3, 4, 5, 7, 8, 9, 15, 16, 17, 33, 100 };
+
+    SkRandom rand;
+    for (size_t i = 0; i < SK_ARRAY_COUNT(configs); i++) {
+        for (size_t j = 0; j < SK_ARRAY_COUNT(alphaTypes); j++) {
+            for (size_t k = 0; k < SK_ARRAY_COUNT(widths); k++) {
+                check_swizzle(r, &rand, configs[i], alphaTypes[j], widths[k], false);
+                check_swizzle(r, &rand, configs[i], alphaTypes[j], widths[k], true);
+            }
+        }
+    }
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkAtomics.h"
+#include "SkTaskGroup.h"
+#include "Test.h"
+
+static void increment(int32_t* counter) {
+    sk_atomic_inc(counter);
+}
+
+DEF_TEST(TaskGroup_AddAndBatch, r) {
+    int32_t counter = 0;
+    SkTaskGroup tg;
+    for (int i = 0; i < 100; i++) {
+        tg.add(increment, &counter);
+    }
+    tg.wait();
+    REPORTER_ASSERT(r, 100 == counter);
+
+    // Reusing tg after wait() is fine.
+    int32_t counters[50] = { 0 };
+    tg.batch(increment, counters, SK_ARRAY_COUNT(counters));
+    tg.wait();
+    for (size_t i = 0; i < SK_ARRAY_COUNT(counters); i++) {
+        REPORTER_ASSERT(r, 1 == counters[i]);
+    }
+}
+
+namespace {
+
+// Each Nested task adds fChildren tasks of its own and waits on them from inside the pool.
+struct Nested {
+    int      fDepth;
+    int32_t* fLeaves;
+
+    static void Run(Nested* task) {
+        if (0 == task->fDepth) {
+            sk_atomic_inc(task->fLeaves);
+            return;
+        }
+        Nested children[4];
+        for (int i = 0; i < 4; i++) {
+            children[i].fDepth  = task->fDepth - 1;
+            children[i].fLeaves = task->fLeaves;
+        }
+        SkTaskGroup tg;
+        tg.batch(Run, children, 4);
+        tg.wait();
+    }
+};
+
+}  // namespace
+
+DEF_TEST(TaskGroup_Nested, r) {
+    // 4^5 leaves, with many more waits in flight than there are threads.
+    int32_t leaves = 0;
+    Nested root = { 5, &leaves };
+    SkTaskGroup tg;
+    tg.add(Nested::Run, &root);
+    tg.wait();
+    REPORTER_ASSERT(r, 1024 == leaves);
+}
+
+DEF_TEST(TaskGroup_ParallelFor, r) {
+    static const int N = 1000;
+    int32_t hits[N] = { 0 };
+    const int grains[] = { 1, 7, 64, N, 2*N };
+    for (size_t g = 0; g < SK_ARRAY_COUNT(grains); g++) {
+        sk_parallel_for(N, grains[g], [&](int i) { sk_atomic_inc(&hits[i]); });
+    }
+    for (int i = 0; i < N; i++) {
+        REPORTER_ASSERT(r, (int32_t)SK_ARRAY_COUNT(grains) == hits[i]);
+    }
+
+    // Nothing to do is fine too.
+    sk_parallel_for(0, 16, [&](int) { REPORTER_ASSERT(r, false); });
+
+    // sk_parallel_for inside sk_parallel_for.
+    int32_t total = 0;
+    sk_parallel_for(32, 1, [&](int) {
+        sk_parallel_for(32, 4, [&](int) { sk_atomic_inc(&total); });
+    });
+    REPORTER_ASSERT(r, 32*32 == total);
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBBHFactory.h"
+#include "SkCanvas.h"
+#include "SkColorPriv.h"
+#include "SkPath.h"
+#include "SkPictureRecorder.h"
+#include "SkRandom.h"
+#include "SkTiledPictureDraw.h"
+#include "Test.h"
+
+static const int kWidth  = 300,
+                 kHeight = 200;
+
+// Pixel-aligned, non-AA content never has its edges clipped differently by tiling.
+static SkPicture* make_aligned_picture(SkBBHFactory* factory) {
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(SkIntToScalar(kWidth), SkIntToScalar(kHeight),
+                                               factory);
+    SkRandom rand;
+    SkPaint paint;
+    for (int i = 0; i < 50; i++) {
+        paint.setColor(rand.nextU() | 0x80000000);
+        canvas->drawRect(SkRect::MakeXYWH(SkIntToScalar(rand.nextRangeU(0, kWidth)  - 20),
+                                          SkIntToScalar(rand.nextRangeU(0, kHeight) - 20),
+                                          SkIntToScalar(rand.nextRangeU(1, 80)),
+                                          SkIntToScalar(rand.nextRangeU(1, 80))), paint);
+    }
+    canvas->saveLayerAlpha(NULL, 0x80);
+        paint.setColor(SK_ColorBLUE);
+        canvas->drawRect(SkRect::MakeLTRB(40, 30, 250, 170), paint);
+    canvas->restore();
+    return recorder.endRecording();
+}
+
+// Curves, scan converted with or without anti-aliasing, crossing tile seams and a clip.
+static SkPicture* make_path_picture(SkBBHFactory* factory, bool aa) {
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(SkIntToScalar(kWidth), SkIntToScalar(kHeight),
+                                               factory);
+    SkRandom rand;
+    SkPaint paint;
+    paint.setAntiAlias(aa);
+    for (int i = 0; i < 50; i++) {
+        paint.setColor(rand.nextU() | 0x80000000);
+        SkRect r = SkRect::MakeXYWH(rand.nextRangeScalar(-20, SkIntToScalar(kWidth)),
+                                    rand.nextRangeScalar(-20, SkIntToScalar(kHeight)),
+                                    rand.nextRangeScalar(1, 80),
+                                    rand.nextRangeScalar(1, 80));
+        switch (i % 4) {
+            case 0: canvas->drawRect(r, paint); break;
+            case 1: canvas->drawOval(r, paint); break;
+            case 2: canvas->drawRoundRect(r, 7, 5, paint); break;
+            case 3: {
+                SkPath path;
+                path.moveTo(r.fLeft, r.fBottom);
+                path.cubicTo(r.fLeft, r.fTop, r.fRight, r.fBottom, r.fRight, r.fTop);
+                path.quadTo(r.centerX(), r.fBottom, r.fLeft, r.centerY());
+                canvas->drawPath(path, paint);
+                // ...and as a hairline.
+                paint.setStyle(SkPaint::kStroke_Style);
+                canvas->drawPath(path, paint);
+                paint.setStyle(SkPaint::kFill_Style);
+                break;
+            }
+        }
+    }
+    canvas->save();
+        SkPath clip;
+        clip.addCircle(170, 110, 70);
+        canvas->clipPath(clip, SkRegion::kIntersect_Op, aa);
+        canvas->rotate(15);
+        canvas->saveLayerAlpha(NULL, 0x80);
+            paint.setColor(SK_ColorBLUE);
+            canvas->drawCircle(150.5f, 90.25f, 60, paint);
+            paint.setColor(SK_ColorGREEN);
+            canvas->drawRoundRect(SkRect::MakeLTRB(100.3f, 20.6f, 210.2f, 160.9f), 30, 20,
+                                  paint);
+        canvas->restore();
+    canvas->restore();
+    return recorder.endRecording();
+}
+
+static int count_different_pixels(const SkBitmap& a, const SkBitmap& b) {
+    SkAutoLockPixels lockA(a), lockB(b);
+    int count = 0;
+    for (int y = 0; y < a.height(); y++) {
+        for (int x = 0; x < a.width(); x++) {
+            count += *a.getAddr32(x, y) != *b.getAddr32(x, y);
+        }
+    }
+    return count;
+}
+
+// Returns how many pixels differ between serial and tiled playback.
+static int tiled_vs_serial(const SkPicture* pic, const SkMatrix* matrix, int tileW, int tileH) {
+    SkBitmap serial, tiled;
+    serial.allocN32Pixels(kWidth, kHeight);
+    tiled .allocN32Pixels(kWidth, kHeight);
+    serial.eraseColor(SK_ColorWHITE);
+    tiled .eraseColor(SK_ColorWHITE);
+
+    SkCanvas canvas(serial);
+    if (matrix) {
+        canvas.concat(*matrix);
+    }
+    pic->playback(&canvas);
+
+    SkTiledPictureDraw(pic, tiled, matrix, tileW, tileH);
+    return count_different_pixels(serial, tiled);
+}
+
+DEF_TEST(TiledPictureDraw, r) {
+    SkRTreeFactory rtree;
+    SkMatrix scale = SkMatrix::MakeScale(2, 3);
+    scale.postTranslate(-10, 3);
+
+    SkBBHFactory* factories[] = { NULL, &rtree };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(factories); i++) {
+        SkAutoTUnref<SkPicture> aligned(make_aligned_picture(factories[i]));
+        REPORTER_ASSERT(r, 0 == tiled_vs_serial(aligned, NULL,     64,   64));
+        REPORTER_ASSERT(r, 0 == tiled_vs_serial(aligned, NULL,     37,   23));  // Uneven tiles.
+        REPORTER_ASSERT(r, 0 == tiled_vs_serial(aligned, &scale,   50,   50));
+        REPORTER_ASSERT(r, 0 == tiled_vs_serial(aligned, NULL,   1000, 1000));  // Just one tile.
+
+        // Curves crossing tile seams must be scan converted just as they are without tiles.
+        for (int aa = 0; aa < 2; aa++) {
+            SkAutoTUnref<SkPicture> paths(make_path_picture(factories[i], SkToBool(aa)));
+            REPORTER_ASSERT(r, 0 == tiled_vs_serial(paths, NULL,     64,   64));
+            REPORTER_ASSERT(r, 0 == tiled_vs_serial(paths, NULL,     37,   23));
+            REPORTER_ASSERT(r, 0 == tiled_vs_serial(paths, &scale,   50,   50));
+            REPORTER_ASSERT(r, 0 == tiled_vs_serial(paths, NULL,   1000, 1000));
+        }
+    }
+}
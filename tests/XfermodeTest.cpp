@@ -5,7 +5,15 @@
  * found in the LICENSE file.
  */
 
+#include "SkBlurMaskFilter.h"
+#include "SkCanvas.h"
 #include "SkColor.h"
+#include "SkColorMatrixFilter.h"
+#include "SkGradientShader.h"
+#include "SkPMFloatProcs.h"
+#include "SkRandom.h"
+#include "SkRasterPipeline.h"
+#include "SkString.h"
 #include "SkXfermode.h"
 #include "Test.h"
 
@@ -55,3 +63,138 @@ DEF_TEST(Xfermode, reporter) {
     test_asMode(reporter);
     test_IsMode(reporter);
 }
+
+// Hides the color matrix of the filter it wraps, so the blitter packs between stages.
+class PMColorOnlyColorFilter : public SkColorFilter {
+public:
+    PMColorOnlyColorFilter(SkColorFilter* filter) : fFilter(SkRef(filter)) {}
+
+    void filterSpan(const SkPMColor src[], int count, SkPMColor result[]) const override {
+        fFilter->filterSpan(src, count, result);
+    }
+    uint32_t getFlags() const override {
+        return fFilter->getFlags();
+    }
+    Factory getFactory() const override { return NULL; }
+
+#ifndef SK_IGNORE_TO_STRING
+    void toString(SkString* str) const override {
+        str->append("PMColorOnlyColorFilter");
+    }
+#endif
+
+private:
+    SkAutoTUnref<SkColorFilter> fFilter;
+};
+
+static void draw(SkBitmap* bm, SkColorFilter* filter, SkXfermode::Mode mode) {
+    bm->allocN32Pixels(67, 67);
+    SkCanvas canvas(*bm);
+    canvas.drawColor(SkColorSetARGB(0xC0, 0x40, 0x80, 0xF0), SkXfermode::kSrc_Mode);
+
+    const SkPoint pts[] = { { 0, 0 }, { 67, 67 } };
+    const SkColor colors[] = { SkColorSetARGB(0x80, 0xFF, 0, 0), SK_ColorGREEN, 0x00000000 };
+    SkPaint paint;
+    paint.setShader(SkGradientShader::CreateLinear(pts, colors, NULL, 3,
+                                                   SkShader::kClamp_TileMode))->unref();
+    paint.setColorFilter(filter);
+    paint.setXfermodeMode(mode);
+    canvas.drawRect(SkRect::MakeXYWH(2, 2, 30, 60), paint);
+    paint.setAntiAlias(true);
+    canvas.drawCircle(45, 35, 20.5f, paint);
+    paint.setMaskFilter(SkBlurMaskFilter::Create(kNormal_SkBlurStyle, 3))->unref();
+    canvas.drawOval(SkRect::MakeXYWH(10, 40, 50, 20), paint);
+}
+
+// The float blitters must match the 8-bit one, give or take rounding.
+static void check_against_bytes(skiatest::Reporter* reporter, SkColorFilter* filter,
+                                SkXfermode::Mode mode, int tolerance) {
+    SkAutoTUnref<SkColorFilter> packed(SkNEW_ARGS(PMColorOnlyColorFilter, (filter)));
+    SkBitmap floats, bytes;
+    draw(&floats, filter, mode);
+    draw(&bytes, packed, mode);
+    for (int y = 0; y < floats.height(); y++) {
+        for (int x = 0; x < floats.width(); x++) {
+            const SkPMColor f = *floats.getAddr32(x, y);
+            const SkPMColor b = *bytes.getAddr32(x, y);
+            for (int shift = 0; shift < 32; shift += 8) {
+                const int diff = (int)((f >> shift) & 0xFF) - (int)((b >> shift) & 0xFF);
+                if (SkAbs32(diff) > tolerance) {
+                    ERRORF(reporter, "mode %d (%d, %d): %08x vs %08x", mode, x, y, f, b);
+                    return;
+                }
+            }
+        }
+    }
+}
+
+static SkColorFilter* make_filter() {
+    SkColorMatrix matrix;
+    matrix.setSaturation(0.4f);
+    matrix.postTranslate(10, -20, 30, 0);
+    return SkColorMatrixFilter::Create(matrix);
+}
+
+DEF_TEST(Xfermode_PMFloatBlitter, reporter) {
+    SkAutoTUnref<SkColorFilter> filter(make_filter());
+    for (int i = 0; i <= SkXfermode::kLastMode; i++) {
+        const SkXfermode::Mode mode = (SkXfermode::Mode)i;
+        SkAutoTUnref<SkXfermode> xfer(SkXfermode::Create(mode));
+        if (SkPMFloatXferProcFor(xfer)) {
+            check_against_bytes(reporter, filter, mode, 2);
+        }
+    }
+}
+
+// SkBlitter::Choose() only picks the raster pipeline blitter for Darken and Lighten.
+DEF_TEST(Xfermode_RasterPipelineBlitter, reporter) {
+    SkAutoTUnref<SkColorFilter> filter(make_filter());
+    check_against_bytes(reporter, filter, SkXfermode::kDarken_Mode, 2);
+    check_against_bytes(reporter, filter, SkXfermode::kLighten_Mode, 2);
+}
+
+// Every blend stage must match the mode's 8-bit proc, spans of any length, with coverage.
+DEF_TEST(Xfermode_RasterPipelineStages, reporter) {
+    SkRandom rand;
+    SkPMFloat srcF[9];
+    SkPMColor src[9], dst[9], expected[9];
+    SkAlpha coverage[9];
+    SkPMColor* dstPtr = dst;
+    const SkAlpha* coveragePtr = coverage;
+    for (int i = 0; i <= SkXfermode::kLastMode; i++) {
+        const SkXfermode::Mode mode = (SkXfermode::Mode)i;
+        SkAutoTUnref<SkXfermode> xfer(SkXfermode::Create(mode));
+        if (NULL == xfer || !SkRasterPipeline::CanBlend(mode)) {
+            continue;
+        }
+        SkRasterPipeline pipeline;
+        pipeline.append(SkRasterPipeline::kLoadSrc_StockStage, srcF);
+        pipeline.append(SkRasterPipeline::kLoadDst_StockStage, &dstPtr);
+        REPORTER_ASSERT(reporter, pipeline.appendBlend(mode));
+        pipeline.append(SkRasterPipeline::kLerpU8_StockStage, &coveragePtr);
+        pipeline.append(SkRasterPipeline::kStore_StockStage, &dstPtr);
+
+        for (int count = 1; count <= 9; count++) {
+            for (int x = 0; x < count; x++) {
+                const SkColor c = rand.nextU();
+                src[x] = SkPreMultiplyColor(x & 1 ? c : c | 0xFF000000);
+                srcF[x] = SkPMFloat(src[x]);
+                dst[x] = expected[x] = SkPreMultiplyColor(rand.nextU());
+                coverage[x] = x % 3 ? rand.nextU() & 0xFF : 0xFF;
+            }
+            xfer->xfer32(expected, src, count, coverage);
+            pipeline.run(count);
+            for (int x = 0; x < count; x++) {
+                for (int shift = 0; shift < 32; shift += 8) {
+                    const int diff = (int)((dst[x] >> shift) & 0xFF) -
+                                     (int)((expected[x] >> shift) & 0xFF);
+                    // The 8-bit Porter-Duff procs scale by 256ths rather than dividing by 255.
+                    if (SkAbs32(diff) > 4) {
+                        ERRORF(reporter, "mode %d: %08x vs %08x", i, dst[x], expected[x]);
+                        return;
+                    }
+                }
+            }
+        }
+    }
+}
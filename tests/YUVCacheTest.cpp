@@ -5,9 +5,12 @@
  * found in the LICENSE file.
  */
 
+#include "SkBitmap.h"
 #include "SkCachedData.h"
+#include "SkImageGenerator.h"
 #include "SkYUVPlanesCache.h"
 #include "SkResourceCache.h"
+#include "SkUtils.h"
 #include "Test.h"
 
 enum LockedState {
@@ -74,3 +77,189 @@ DEF_TEST(YUVPlanesCache, reporter) {
     check_data(reporter, data, 1, kNotInCache, kLocked);
     data->unref();
 }
+
+namespace {
+// Produces 4:2:0 YUV planes, but no RGB pixels, so it can only be drawn by way of its planes.
+class YUVOnlyGenerator : public SkImageGenerator {
+public:
+    static const int kWidth = 7, kHeight = 5;
+
+    YUVOnlyGenerator(int* decodeCount)
+        : INHERITED(SkImageInfo::MakeN32(kWidth, kHeight, kOpaque_SkAlphaType))
+        , fDecodeCount(decodeCount)
+    {}
+
+    static uint8_t Y(int x, int y) { return SkToU8(16 + 30 * x + 7 * y); }
+    static uint8_t U(int x, int y) { return SkToU8(64 + 40 * x); }
+    static uint8_t V(int x, int y) { return SkToU8(192 - 50 * y); }
+
+protected:
+    bool onGetYUV8Planes(SkISize sizes[3], void* planes[3], size_t rowBytes[3],
+                         SkYUVColorSpace* colorSpace) override {
+        sizes[0].set(kWidth, kHeight);
+        sizes[1].set((kWidth + 1) / 2, (kHeight + 1) / 2);
+        sizes[2] = sizes[1];
+        if (!planes || !planes[0]) {
+            return true;
+        }
+        for (int y = 0; y < kHeight; y++) {
+            for (int x = 0; x < kWidth; x++) {
+                ((uint8_t*)planes[0])[y * rowBytes[0] + x] = Y(x, y);
+            }
+        }
+        for (int y = 0; y < sizes[1].height(); y++) {
+            for (int x = 0; x < sizes[1].width(); x++) {
+                ((uint8_t*)planes[1])[y * rowBytes[1] + x] = U(x, y);
+                ((uint8_t*)planes[2])[y * rowBytes[2] + x] = V(x, y);
+            }
+        }
+        if (colorSpace) {
+            *colorSpace = kJPEG_SkYUVColorSpace;
+        }
+        (*fDecodeCount)++;
+        return true;
+    }
+
+private:
+    int* fDecodeCount;
+
+    typedef SkImageGenerator INHERITED;
+};
+
+// Like YUVOnlyGenerator, but also decodes straight to (solid blue) RGB pixels, which differ
+// from what its planes convert to.
+class RGBAndYUVGenerator : public YUVOnlyGenerator {
+public:
+    RGBAndYUVGenerator(int* yuvDecodeCount) : INHERITED(yuvDecodeCount) {}
+
+protected:
+    Result onGetPixels(const SkImageInfo& info, void* pixels, size_t rowBytes, const Options&,
+                       SkPMColor ctable[], int* ctableCount) override {
+        for (int y = 0; y < info.height(); y++) {
+            sk_memset32((SkPMColor*)((char*)pixels + y * rowBytes),
+                        SkPreMultiplyColor(SK_ColorBLUE), info.width());
+        }
+        return kSuccess;
+    }
+
+private:
+    typedef YUVOnlyGenerator INHERITED;
+};
+}  // namespace
+
+static int clamp_round(float c) {
+    return SkClampMax((int)floorf(c + 0.5f), 255);
+}
+
+// Blends the two subsampled U or V samples either side of pixel i's center, 3:1 toward the
+// nearer one, repeating the edge samples.
+static float upsample(uint8_t (*sample)(int, int), int x, int y, int uvWidth, int uvHeight) {
+    const int x0 = (x - 1) >> 1, y0 = (y - 1) >> 1;
+    const float wx = (x & 1) ? 0.25f : 0.75f,
+                wy = (y & 1) ? 0.25f : 0.75f;
+    const int xLo = SkPin32(x0, 0, uvWidth - 1), xHi = SkPin32(x0 + 1, 0, uvWidth - 1),
+              yLo = SkPin32(y0, 0, uvHeight - 1), yHi = SkPin32(y0 + 1, 0, uvHeight - 1);
+    const float lo = sample(xLo, yLo) + (sample(xLo, yHi) - sample(xLo, yLo)) * wy,
+                hi = sample(xHi, yLo) + (sample(xHi, yHi) - sample(xHi, yLo)) * wy;
+    return lo + (hi - lo) * wx;
+}
+
+static void check_yuv_only_pixels(skiatest::Reporter* reporter, const SkBitmap& bm) {
+    const int uvWidth = (YUVOnlyGenerator::kWidth + 1) / 2,
+              uvHeight = (YUVOnlyGenerator::kHeight + 1) / 2;
+    for (int y = 0; y < bm.height(); y++) {
+        for (int x = 0; x < bm.width(); x++) {
+            const float Y = YUVOnlyGenerator::Y(x, y),
+                        U = upsample(YUVOnlyGenerator::U, x, y, uvWidth, uvHeight) - 128.0f,
+                        V = upsample(YUVOnlyGenerator::V, x, y, uvWidth, uvHeight) - 128.0f;
+            const SkColor expected = SkColorSetRGB(
+                    clamp_round(Y + 1.402f * V),
+                    clamp_round(Y - 0.34414f * U - 0.71414f * V),
+                    clamp_round(Y + 1.772f * U));
+            const SkColor actual = bm.getColor(x, y);
+            // The float math may round the other way from the expectation's.
+            REPORTER_ASSERT(reporter, 0xFF == SkColorGetA(actual));
+            REPORTER_ASSERT(reporter,
+                            SkTAbs((int)SkColorGetR(expected) - (int)SkColorGetR(actual)) <= 1 &&
+                            SkTAbs((int)SkColorGetG(expected) - (int)SkColorGetG(actual)) <= 1 &&
+                            SkTAbs((int)SkColorGetB(expected) - (int)SkColorGetB(actual)) <= 1);
+        }
+    }
+}
+
+// A discardable pixelRef whose generator only has YUV planes should decode to RGB through them,
+// upsampling U and V smoothly, without leaving the planes in SkYUVPlanesCache beside the pixels.
+DEF_TEST(YUVPlanesCache_Raster, reporter) {
+    int decodeCount = 0;
+    SkBitmap bm;
+    REPORTER_ASSERT(reporter, SkInstallDiscardablePixelRef(
+                                      SkNEW_ARGS(YUVOnlyGenerator, (&decodeCount)), &bm));
+    {
+        SkAutoLockPixels autoLockPixels(bm);
+        REPORTER_ASSERT(reporter, bm.getPixels());
+        REPORTER_ASSERT(reporter, 1 == decodeCount);
+        if (bm.getPixels()) {
+            check_yuv_only_pixels(reporter, bm);
+        }
+    }
+
+    SkYUVPlanesCache::Info yuvInfo;
+    SkAutoTUnref<SkCachedData> data(
+            SkYUVPlanesCache::FindAndRef(bm.getGenerationID(), &yuvInfo));
+    REPORTER_ASSERT(reporter, !data);
+}
+
+// A generator that can decode both RGB and YUV planes should be decoded through its planes.
+DEF_TEST(YUVPlanesCache_RasterPrefersYUV, reporter) {
+    int decodeCount = 0;
+    SkBitmap bm;
+    REPORTER_ASSERT(reporter, SkInstallDiscardablePixelRef(
+                                      SkNEW_ARGS(RGBAndYUVGenerator, (&decodeCount)), &bm));
+    {
+        SkAutoLockPixels autoLockPixels(bm);
+        REPORTER_ASSERT(reporter, bm.getPixels());
+        REPORTER_ASSERT(reporter, 1 == decodeCount);
+        if (bm.getPixels()) {
+            check_yuv_only_pixels(reporter, bm);
+        }
+    }
+
+    SkYUVPlanesCache::Info yuvInfo;
+    SkAutoTUnref<SkCachedData> data(
+            SkYUVPlanesCache::FindAndRef(bm.getGenerationID(), &yuvInfo));
+    REPORTER_ASSERT(reporter, !data);
+}
+
+// Planes already cached, as the GPU upload path caches them, should be converted without
+// decoding again.
+DEF_TEST(YUVPlanesCache_RasterFromCache, reporter) {
+    int decodeCount = 0;
+    SkBitmap bm;
+    SkImageGenerator* generator = SkNEW_ARGS(YUVOnlyGenerator, (&decodeCount));
+    REPORTER_ASSERT(reporter, SkInstallDiscardablePixelRef(generator, &bm));
+
+    SkYUVPlanesCache::Info yuvInfo;
+    REPORTER_ASSERT(reporter, generator->getYUV8Planes(yuvInfo.fSize, NULL, NULL, NULL));
+    size_t totalSize = 0;
+    for (int i = 0; i < 3; ++i) {
+        yuvInfo.fRowBytes[i] = yuvInfo.fSize[i].fWidth;
+        yuvInfo.fSizeInMemory[i] = yuvInfo.fRowBytes[i] * yuvInfo.fSize[i].fHeight;
+        totalSize += yuvInfo.fSizeInMemory[i];
+    }
+    SkAutoTUnref<SkCachedData> data(SkResourceCache::NewCachedData(totalSize));
+    void* planes[3];
+    planes[0] = data->writable_data();
+    planes[1] = (uint8_t*)planes[0] + yuvInfo.fSizeInMemory[0];
+    planes[2] = (uint8_t*)planes[1] + yuvInfo.fSizeInMemory[1];
+    REPORTER_ASSERT(reporter, generator->getYUV8Planes(yuvInfo.fSize, planes, yuvInfo.fRowBytes,
+                                                       &yuvInfo.fColorSpace));
+    SkYUVPlanesCache::Add(bm.getGenerationID(), data, &yuvInfo);
+    REPORTER_ASSERT(reporter, 1 == decodeCount);
+
+    SkAutoLockPixels autoLockPixels(bm);
+    REPORTER_ASSERT(reporter, bm.getPixels());
+    REPORTER_ASSERT(reporter, 1 == decodeCount);
+    if (bm.getPixels()) {
+        check_yuv_only_pixels(reporter, bm);
+    }
+}
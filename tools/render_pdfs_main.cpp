@@ -16,7 +16,9 @@
 #include "SkStream.h"
 #include "SkTArray.h"
 #include "SkTSort.h"
+#include "SkTaskGroup.h"
 #include "ProcStats.h"
+#include "Timer.h"
 
 __SK_FORCE_IMAGE_DECODER_LINKING;
 
@@ -33,6 +35,13 @@ __SK_FORCE_IMAGE_DECODER_LINKING;
  *
  * Returns zero exit code if all .skp files were converted successfully,
  * otherwise returns error code 1.
+ *
+ * With --benchPages, nothing is written; instead each .skp is drawn onto
+ * that many pages of one document, once for each of --threads, and the
+ * pages per second are reported.
+ *
+ * With --stream, each page is written out as soon as it is finished, which
+ * bounds memory use by the largest page rather than the whole document.
  */
 
 static const char PDF_FILE_EXTENSION[] = "pdf";
@@ -56,6 +65,26 @@ DEFINE_string2(match, m, "",
                "If a file does not match any list entry,\n"
                "it is skipped unless some list entry starts with ~");
 
+DEFINE_int32(benchPages, 0,
+             "If positive, benchmark: draw each skp onto this many pages "
+             "and report pages per second for each of --threads.");
+
+DEFINE_string(threads, "0 1 2 4 8",
+              "Thread counts to benchmark with --benchPages. "
+              "0 converts each page on the thread that drew it.");
+
+DEFINE_bool(stream, false, "Write each page as soon as it is finished.");
+
+DEFINE_int32(deflateLevel, SK_PDFDefaultDeflateLevel,
+             "zlib level for streams and images: 0 stores, 1 is fastest, 9 is smallest.");
+
+static SkDocument* create_pdf(SkWStream* output) {
+    return FLAGS_stream
+            ? SkDocument::CreateStreamingPDF(output, SK_ScalarDefaultRasterDPI,
+                                             FLAGS_deflateLevel)
+            : SkDocument::CreatePDF(output, SK_ScalarDefaultRasterDPI, FLAGS_deflateLevel);
+}
+
 /** Replaces the extension of a file.
  * @param path File name whose extension will be changed.
  * @param old_extension The old extension.
@@ -139,8 +168,7 @@ static SkWStream* open_stream(const SkString& outputDir,
  */
 static bool pdf_to_stream(SkPicture* picture,
                           SkWStream* output) {
-    SkAutoTUnref<SkDocument> pdfDocument(
-            SkDocument::CreatePDF(output));
+    SkAutoTUnref<SkDocument> pdfDocument(create_pdf(output));
     SkCanvas* canvas = pdfDocument->beginPage(picture->cullRect().width(), 
                                               picture->cullRect().height());
     canvas->drawPicture(picture);
@@ -148,6 +176,26 @@ static bool pdf_to_stream(SkPicture* picture,
     return pdfDocument->close();
 }
 
+/**
+ *  Draw picture onto pages pages of one PDF document, which is thrown away.
+ *  @returns the pages per second.
+ */
+static double bench_pages(SkPicture* picture, int pages) {
+    NullWStream output;
+    WallTimer timer;
+    timer.start();
+    SkAutoTUnref<SkDocument> pdfDocument(create_pdf(&output));
+    for (int i = 0; i < pages; i++) {
+        SkCanvas* canvas = pdfDocument->beginPage(picture->cullRect().width(),
+                                                  picture->cullRect().height());
+        canvas->drawPicture(picture);
+        pdfDocument->endPage();
+    }
+    pdfDocument->close();
+    timer.end();
+    return pages * 1000.0 / timer.fWall;
+}
+
 static bool operator<(const SkString& a, const SkString& b) {
     return strcmp(a.c_str(), b.c_str()) < 0;
 }
@@ -234,6 +282,21 @@ int tool_main_core(int argc, char** argv) {
             picture->cullRect().fRight, picture->cullRect().fBottom,
             maximumPathLength, basename.c_str());
 
+        if (FLAGS_benchPages > 0) {
+            for (int j = 0; j < FLAGS_threads.count(); j++) {
+                const int threads = atoi(FLAGS_threads[j]);
+                SkTaskGroup::Enabler enabled(threads);
+                SkDebugf(" %2d threads: %8.1f pages/s", threads,
+                         bench_pages(picture, FLAGS_benchPages));
+            }
+            int max_rss_mb = sk_tools::getMaxResidentSetSizeMB();
+            if (max_rss_mb >= 0) {
+                SkDebugf(" %4dM peak rss", max_rss_mb);
+            }
+            SkDebugf("\n");
+            continue;
+        }
+
         SkAutoTDelete<SkWStream> stream(open_stream(outputDir, files[i]));
         if (!stream.get()) {
             ++failures;
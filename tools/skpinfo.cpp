@@ -5,10 +5,14 @@
  * found in the LICENSE file.
  */
 
+#include "ProcStats.h"
 #include "SkCommandLineFlags.h"
+#include "SkData.h"
 #include "SkPicture.h"
 #include "SkPictureData.h"
+#include "SkReadBuffer.h"
 #include "SkStream.h"
+#include "Timer.h"
 
 DEFINE_string2(input, i, "", "skp on which to report");
 DEFINE_bool2(version, v, true, "version");
@@ -16,6 +20,7 @@ DEFINE_bool2(cullRect, c, true, "cullRect");
 DEFINE_bool2(flags, f, true, "flags");
 DEFINE_bool2(tags, t, true, "tags");
 DEFINE_bool2(quiet, q, false, "quiet");
+DEFINE_bool2(load, l, false, "load the skp in place from a memory-mapped file and report the cost");
 
 // This tool can print simple information about an SKP but its main use
 // is just to check if an SKP has been truncated during the recording
@@ -67,12 +72,36 @@ int tool_main(int argc, char** argv) {
         SkDebugf("Flags: 0x%x\n", info.fFlags);
     }
 
+    if (FLAGS_load) {
+        const int rssMB = sk_tools::getCurrResidentSetSizeMB();
+        WallTimer timer;
+        timer.start();
+        SkAutoTUnref<SkData> data(SkData::NewFromFileName(FLAGS_input[0]));
+        SkAutoTUnref<SkPicture> picture(data ? SkPicture::CreateFromData(data) : NULL);
+        timer.end();
+        if (NULL == picture.get()) {
+            if (!FLAGS_quiet) {
+                SkDebugf("Couldn't load picture\n");
+            }
+            return kIOError;
+        }
+        if (!FLAGS_quiet) {
+            SkDebugf("Load: %.3f ms, %d MB resident\n",
+                     timer.fWall, sk_tools::getCurrResidentSetSizeMB() - rssMB);
+        }
+    }
+
     if (!stream.readBool()) {
         // If we read true there's a picture playback object flattened
         // in the file; if false, there isn't a playback, so we're done
         // reading the file.
         return kSuccess;
     }
+    if (info.fVersion >= SkReadBuffer::kAlignedStreamSections_Version &&
+        3 != stream.skip(3)) {
+        // The bool is padded out so the sections after it stay 4-byte aligned.
+        return kTruncatedFile;
+    }
 
     for (;;) {
         uint32_t tag = stream.readU32();
@@ -106,6 +135,9 @@ int tool_main(int argc, char** argv) {
             if (FLAGS_tags && !FLAGS_quiet) {
                 SkDebugf("SK_PICT_FACTORY_TAG %d\n", chunkSize);
             }
+            if (info.fVersion >= SkReadBuffer::kAlignedStreamSections_Version) {
+                chunkSize = SkAlign4(chunkSize);
+            }
             break;
         case SK_PICT_TYPEFACE_TAG:
             if (FLAGS_tags && !FLAGS_quiet) {